@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2016 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef IIRFILTERBANKBENCHMARK_H_INCLUDED
+#define IIRFILTERBANKBENCHMARK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*  Compares the time taken to run a multi-band EQ over a multi-channel signal using
+    a separate IIRFilter for each band of each channel, and using an IIRFilterBank,
+    both with fixed coefficients and with smoothed coefficient changes on every block.
+
+    Run the app with the --iir-benchmark command-line option to print a table of
+    results and quit.
+*/
+class IIRFilterBankBenchmark
+{
+public:
+    IIRFilterBankBenchmark (int bufferSize, double rate)
+        : blockSize (bufferSize), sampleRate (rate)
+    {
+    }
+
+    void run()
+    {
+        Logger::writeToLog ("IIR filtering: " + String (blockSize) + " sample blocks at "
+                              + String (sampleRate) + " Hz, time per block as % of real-time");
+
+        Logger::writeToLog (String ("bands x channels").paddedRight (' ', 18)
+                              + String ("IIRFilter").paddedRight (' ', 12)
+                              + String ("bank").paddedRight (' ', 12)
+                              + String ("smoothed").paddedRight (' ', 12)
+                              + "speed-up");
+
+        const int configurations[][2] = { { 4, 2 }, { 8, 2 }, { 8, 8 }, { 8, 16 }, { 16, 32 } };
+
+        for (int i = 0; i < numElementsInArray (configurations); ++i)
+        {
+            const int numBands = configurations[i][0];
+            const int numChannels = configurations[i][1];
+
+            const double filterTime = timeFilters (numBands, numChannels);
+            const double bankTime = timeBank (numBands, numChannels, false);
+            const double smoothedTime = timeBank (numBands, numChannels, true);
+
+            Logger::writeToLog ((String (numBands) + " x " + String (numChannels)).paddedRight (' ', 18)
+                                  + toPercentage (filterTime).paddedRight (' ', 12)
+                                  + toPercentage (bankTime).paddedRight (' ', 12)
+                                  + toPercentage (smoothedTime).paddedRight (' ', 12)
+                                  + "x" + String (filterTime / bankTime, 2));
+        }
+    }
+
+private:
+    //==============================================================================
+    IIRCoefficients getBandCoefficients (int band, int numBands, float gain) const
+    {
+        const double frequency = 40.0 * std::pow (400.0, band / (double) numBands);
+        return IIRCoefficients::makePeakFilter (sampleRate, frequency, 1.2, gain);
+    }
+
+    void fillWithNoise (AudioBuffer<float>& buffer)
+    {
+        Random r (1);
+
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (chan, i, r.nextFloat() - 0.5f);
+    }
+
+    int getNumBlocks() const                    { return jmax (20, (int) (sampleRate * 5.0 / blockSize)); }
+    double getBlockDurationMs() const           { return 1000.0 * blockSize / sampleRate; }
+    String toPercentage (double blockTimeMs)    { return String (100.0 * blockTimeMs / getBlockDurationMs(), 2) + "%"; }
+
+    double timeFilters (int numBands, int numChannels)
+    {
+        OwnedArray<IIRFilter> filters;
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            for (int band = 0; band < numBands; ++band)
+                filters.add (new IIRFilter())->setCoefficients (getBandCoefficients (band, numBands, 1.5f));
+
+        AudioBuffer<float> input (numChannels, blockSize), buffer (numChannels, blockSize);
+        fillWithNoise (input);
+
+        const int numBlocks = getNumBlocks();
+        const double startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            buffer.makeCopyOf (input);
+
+            for (int chan = 0; chan < numChannels; ++chan)
+                for (int band = 0; band < numBands; ++band)
+                    filters.getUnchecked (chan * numBands + band)->processSamples (buffer.getWritePointer (chan), blockSize);
+        }
+
+        return (Time::getMillisecondCounterHiRes() - startTime) / numBlocks;
+    }
+
+    double timeBank (int numBands, int numChannels, bool changeCoefficients)
+    {
+        IIRFilterBank bank (numChannels, numBands);
+        bank.setSmoothingTime (sampleRate, 0.02);
+
+        for (int band = 0; band < numBands; ++band)
+            bank.setCoefficients (band, getBandCoefficients (band, numBands, 1.5f));
+
+        AudioBuffer<float> input (numChannels, blockSize), buffer (numChannels, blockSize);
+        fillWithNoise (input);
+
+        const int numBlocks = getNumBlocks();
+        const double startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            buffer.makeCopyOf (input);
+
+            // keeps every band permanently in the middle of a ramp
+            if (changeCoefficients)
+                for (int band = 0; band < numBands; ++band)
+                    bank.setCoefficients (band, getBandCoefficients (band, numBands, (i & 1) != 0 ? 0.7f : 1.5f));
+
+            bank.processSamples (buffer, 0, blockSize);
+        }
+
+        return (Time::getMillisecondCounterHiRes() - startTime) / numBlocks;
+    }
+
+    const int blockSize;
+    const double sampleRate;
+};
+
+#endif   // IIRFILTERBANKBENCHMARK_H_INCLUDED
@@ -28,6 +28,9 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainComponent.h"
+#include "SynthesiserBenchmark.h"
+#include "SamplerStreamingBenchmark.h"
+#include "IIRFilterBankBenchmark.h"
 
 Component* createMainContentComponent();
 
@@ -43,8 +46,29 @@ public:
     bool moreThanOneInstanceAllowed() override       { return true; }
 
     //==============================================================================
-    void initialise (const String&) override
+    void initialise (const String& commandLine) override
     {
+        if (commandLine.contains ("--synth-benchmark"))
+        {
+            SynthesiserBenchmark (512, 44100.0).run();
+            quit();
+            return;
+        }
+
+        if (commandLine.contains ("--sampler-benchmark"))
+        {
+            SamplerStreamingBenchmark (512, 44100.0).run();
+            quit();
+            return;
+        }
+
+        if (commandLine.contains ("--iir-benchmark"))
+        {
+            IIRFilterBankBenchmark (512, 44100.0).run();
+            quit();
+            return;
+        }
+
         mainWindow = new MainWindow (getApplicationName());
     }
 
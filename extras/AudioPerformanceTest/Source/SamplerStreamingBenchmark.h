@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2016 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef SAMPLERSTREAMINGBENCHMARK_H_INCLUDED
+#define SAMPLERSTREAMINGBENCHMARK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*  Plays increasing numbers of simultaneous streaming SamplerVoices in real time,
+    and reports how much of each block's time the rendering took, and how well the
+    SamplerDiskStreamer kept up with them.
+
+    The voices all stream from a long temporary WAV file. Run the app with the
+    --sampler-benchmark command-line option to print a table of results and quit.
+*/
+class SamplerStreamingBenchmark
+{
+public:
+    SamplerStreamingBenchmark (int bufferSize, double rate)
+        : blockSize (bufferSize), sampleRate (rate), sampleFile (".wav")
+    {
+        formatManager.registerBasicFormats();
+        createSampleFile();
+    }
+
+    void run()
+    {
+        Logger::writeToLog ("Streaming sampler: " + String (blockSize) + " sample blocks at " + String (sampleRate)
+                              + " Hz, " + String (secondsPerTest) + " seconds per test");
+
+        Logger::writeToLog ("voices  render time  underruns  samples missed  disk reads  MB/sec");
+
+        for (int numVoices = 8; numVoices <= 256; numVoices *= 2)
+        {
+            SamplerDiskStreamer streamer (jmax (2, SystemStats::getNumCpus() / 2));
+            const double renderTime = playVoices (streamer, numVoices);
+            const SamplerDiskStreamer::Statistics stats (streamer.getStatistics());
+
+            Logger::writeToLog (String (numVoices).paddedRight (' ', 8)
+                                  + (String (renderTime, 1) + "%").paddedRight (' ', 13)
+                                  + String (stats.numUnderruns).paddedRight (' ', 11)
+                                  + String (stats.numSamplesMissed).paddedRight (' ', 16)
+                                  + String (stats.numReads).paddedRight (' ', 12)
+                                  + String (stats.numSamplesRead * 2 * sizeof (int16) / (secondsPerTest * 1024.0 * 1024.0), 1));
+        }
+    }
+
+private:
+    //==============================================================================
+    enum { secondsPerTest = 4 };
+
+    void createSampleFile()
+    {
+        const int length = (int) (sampleRate * 60.0);
+        AudioBuffer<float> block (2, 65536);
+        Random r (1);
+
+        ScopedPointer<AudioFormatWriter> writer (WavAudioFormat().createWriterFor (sampleFile.getFile().createOutputStream(),
+                                                                                   sampleRate, 2, 16, StringPairArray(), 0));
+
+        for (int pos = 0; pos < length; pos += block.getNumSamples())
+        {
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                float* const data = block.getWritePointer (chan);
+
+                for (int i = 0; i < block.getNumSamples(); ++i)
+                    data[i] = (float) (std::sin ((pos + i) * 0.03 * (chan + 1)) * 0.5 + (r.nextFloat() - 0.5f) * 0.1);
+            }
+
+            writer->writeFromAudioSampleBuffer (block, 0, jmin (block.getNumSamples(), length - pos));
+        }
+    }
+
+    double playVoices (SamplerDiskStreamer& streamer, int numVoices)
+    {
+        Synthesiser synth;
+
+        BigInteger notes;
+        notes.setRange (0, 128, true);
+
+        synth.addSound (new SamplerSound ("stream", SamplerSound::createStreamingReader (formatManager, sampleFile.getFile()),
+                                          notes, 64, 0.01, 0.1, 60.0, 0.25));
+
+        for (int i = 0; i < numVoices; ++i)
+            synth.addVoice (new SamplerVoice (streamer));
+
+        synth.setCurrentPlaybackSampleRate (sampleRate);
+
+        MidiBuffer midi;
+
+        // spread the notes across a couple of octaves, so the voices read at different speeds
+        for (int i = 0; i < numVoices; ++i)
+            midi.addEvent (MidiMessage::noteOn (1 + i / 24, 52 + i % 24, (uint8) 100), i % blockSize);
+
+        AudioBuffer<float> output (2, blockSize);
+        const int numBlocks = (int) (sampleRate * secondsPerTest / blockSize);
+        const double startTime = Time::getMillisecondCounterHiRes();
+        double renderTime = 0;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            const double blockStart = Time::getMillisecondCounterHiRes();
+
+            output.clear();
+            synth.renderNextBlock (output, midi, 0, blockSize);
+            midi.clear();
+
+            const double now = Time::getMillisecondCounterHiRes();
+            renderTime += now - blockStart;
+
+            // wait for the next block to be due, as a real audio callback would
+            const double nextBlockTime = startTime + (i + 1) * getBlockDurationMs();
+
+            if (nextBlockTime > now)
+                Thread::sleep ((int) (nextBlockTime - now));
+        }
+
+        return 100.0 * renderTime / (numBlocks * getBlockDurationMs());
+    }
+
+    double getBlockDurationMs() const noexcept      { return 1000.0 * blockSize / sampleRate; }
+
+    const int blockSize;
+    const double sampleRate;
+    AudioFormatManager formatManager;
+    TemporaryFile sampleFile;
+
+    JUCE_DECLARE_NON_COPYABLE (SamplerStreamingBenchmark)
+};
+
+
+#endif  // SAMPLERSTREAMINGBENCHMARK_H_INCLUDED
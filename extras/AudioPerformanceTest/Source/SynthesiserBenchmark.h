@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2016 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef SYNTHESISERBENCHMARK_H_INCLUDED
+#define SYNTHESISERBENCHMARK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/*  Measures how the time taken to render a Synthesiser scales with the number of
+    voices, using different numbers of rendering threads.
+
+    Each voice plays a looped sample with linear interpolation, like a simple sampler.
+    Run the app with the --synth-benchmark command-line option to print a table of
+    results and quit.
+*/
+class SynthesiserBenchmark
+{
+public:
+    SynthesiserBenchmark (int bufferSize, double rate)
+        : blockSize (bufferSize), sampleRate (rate)
+    {
+        createSample();
+    }
+
+    void run()
+    {
+        Array<int> threadCounts;
+
+        for (int n = 1; n < SystemStats::getNumCpus(); n *= 2)
+            threadCounts.add (n);
+
+        threadCounts.add (SystemStats::getNumCpus());
+
+        Logger::writeToLog ("Synthesiser voice scaling: " + String (blockSize) + " sample blocks at "
+                              + String (sampleRate) + " Hz, time per block as % of real-time");
+
+        String header ("voices  ");
+
+        for (auto numThreads : threadCounts)
+            header << (String (numThreads) + (numThreads == 1 ? " thread" : " threads")).paddedRight (' ', 12);
+
+        Logger::writeToLog (header + "speed-up");
+
+        for (int numVoices = 8; numVoices <= 128; numVoices *= 2)
+        {
+            String line (String (numVoices).paddedRight (' ', 8));
+            double singleThreadTime = 0, bestTime = 0;
+
+            for (auto numThreads : threadCounts)
+            {
+                const double blockTimeMs = timeSynth (numVoices, numThreads);
+
+                if (numThreads == 1)
+                    singleThreadTime = blockTimeMs;
+
+                bestTime = bestTime > 0 ? jmin (bestTime, blockTimeMs) : blockTimeMs;
+                line << (String (100.0 * blockTimeMs / getBlockDurationMs(), 1) + "%").paddedRight (' ', 12);
+            }
+
+            Logger::writeToLog (line + "x" + String (singleThreadTime / bestTime, 2));
+        }
+    }
+
+private:
+    //==============================================================================
+    struct SampleSound  : public SynthesiserSound
+    {
+        SampleSound (const AudioBuffer<float>& s) : sample (s) {}
+
+        bool appliesToNote (int) override       { return true; }
+        bool appliesToChannel (int) override    { return true; }
+
+        const AudioBuffer<float>& sample;
+    };
+
+    struct SampleVoice  : public SynthesiserVoice
+    {
+        bool canPlaySound (SynthesiserSound* s) override    { return dynamic_cast<SampleSound*> (s) != nullptr; }
+
+        void startNote (int midiNoteNumber, float velocity, SynthesiserSound* s, int) override
+        {
+            sample = &(static_cast<SampleSound*> (s)->sample);
+            position = 0;
+            pitchRatio = std::pow (2.0, (midiNoteNumber - 60) / 48.0);
+            gain = velocity / 32.0f;
+        }
+
+        void stopNote (float, bool) override        { clearCurrentNote(); }
+        void pitchWheelMoved (int) override         {}
+        void controllerMoved (int, int) override    {}
+
+        void renderNextBlock (AudioBuffer<float>& output, int startSample, int numSamples) override
+        {
+            if (sample == nullptr || ! isVoiceActive())
+                return;
+
+            const int length = sample->getNumSamples();
+
+            for (int chan = 0; chan < output.getNumChannels(); ++chan)
+            {
+                const float* const in = sample->getReadPointer (chan % sample->getNumChannels());
+                float* const out = output.getWritePointer (chan, startSample);
+                double pos = position;
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const int index = (int) pos;
+                    const float alpha = (float) (pos - index);
+                    out[i] += gain * (in[index] + alpha * (in[(index + 1) % length] - in[index]));
+
+                    pos += pitchRatio;
+
+                    if (pos >= length)
+                        pos -= length;
+                }
+
+                if (chan == output.getNumChannels() - 1)
+                    position = pos;
+            }
+        }
+
+        const AudioBuffer<float>* sample = nullptr;
+        double position = 0, pitchRatio = 1.0;
+        float gain = 0;
+    };
+
+    //==============================================================================
+    void createSample()
+    {
+        const int length = (int) (sampleRate * 2.0);
+        sample.setSize (2, length);
+
+        Random r (1);
+
+        for (int chan = 0; chan < 2; ++chan)
+        {
+            float* const data = sample.getWritePointer (chan);
+
+            for (int i = 0; i < length; ++i)
+                data[i] = (float) (std::sin (i * 0.03 * (chan + 1)) * 0.5 + (r.nextFloat() - 0.5f) * 0.1);
+        }
+    }
+
+    double timeSynth (int numVoices, int numThreads)
+    {
+        Synthesiser synth;
+        synth.addSound (new SampleSound (sample));
+
+        for (int i = 0; i < numVoices; ++i)
+            synth.addVoice (new SampleVoice());
+
+        synth.setCurrentPlaybackSampleRate (sampleRate);
+        synth.setNumRenderingThreads (numThreads);
+
+        MidiBuffer notes;
+
+        for (int i = 0; i < numVoices; ++i)
+            notes.addEvent (MidiMessage::noteOn (1 + i / 128, i % 128, (uint8) 100), 0);
+
+        AudioBuffer<float> output (2, blockSize);
+        MidiBuffer noMidi;
+
+        output.clear();
+        synth.renderNextBlock (output, notes, 0, blockSize);
+
+        const int numBlocks = jmax (20, (int) (sampleRate * 2.0 / blockSize));
+        const double startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            output.clear();
+            synth.renderNextBlock (output, noMidi, 0, blockSize);
+        }
+
+        return (Time::getMillisecondCounterHiRes() - startTime) / numBlocks;
+    }
+
+    double getBlockDurationMs() const noexcept      { return 1000.0 * blockSize / sampleRate; }
+
+    const int blockSize;
+    const double sampleRate;
+    AudioBuffer<float> sample;
+
+    JUCE_DECLARE_NON_COPYABLE (SynthesiserBenchmark)
+};
+
+
+#endif  // SYNTHESISERBENCHMARK_H_INCLUDED
@@ -471,6 +471,542 @@ void AudioDataConverters::deinterleaveSamples (const float* const source,
 }
 
 
+//==============================================================================
+namespace BlockConversionHelpers
+{
+    enum { minimumBlockSize = 8 };
+
+    static inline int getBytesPerSample (AudioData::BlockConversions::Format format) noexcept
+    {
+        switch (format)
+        {
+            case AudioData::BlockConversions::int16LE:
+            case AudioData::BlockConversions::int16BE:     return 2;
+            case AudioData::BlockConversions::int24LE:
+            case AudioData::BlockConversions::int24BE:     return 3;
+            case AudioData::BlockConversions::int32LE:
+            case AudioData::BlockConversions::int32BE:
+            case AudioData::BlockConversions::float32LE:
+            case AudioData::BlockConversions::float32BE:   return 4;
+            default:                                        return 0;
+        }
+    }
+
+    static inline bool blocksOverlap (const void* a, int strideA, int bytesPerSampleA,
+                                      const void* b, int strideB, int bytesPerSampleB, int numSamples) noexcept
+    {
+        const char* const startA = static_cast<const char*> (a);
+        const char* const startB = static_cast<const char*> (b);
+        const char* const endA = startA + (size_t) (numSamples - 1) * (size_t) strideA + (size_t) bytesPerSampleA;
+        const char* const endB = startB + (size_t) (numSamples - 1) * (size_t) strideB + (size_t) bytesPerSampleB;
+
+        return startA < endB && startB < endA;
+    }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    static forcedinline __m128i byteSwap16 (__m128i v) noexcept
+    {
+        return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+    }
+
+    static forcedinline __m128i byteSwap32 (__m128i v) noexcept
+    {
+        return byteSwap16 (_mm_shufflehi_epi16 (_mm_shufflelo_epi16 (v, _MM_SHUFFLE (2, 3, 0, 1)), _MM_SHUFFLE (2, 3, 0, 1)));
+    }
+
+    static forcedinline float intBitsToFloat (int32 i) noexcept   { union { int32 asInt; float asFloat; } n; n.asInt = i; return n.asFloat; }
+    static forcedinline int32 floatToIntBits (float f) noexcept   { union { int32 asInt; float asFloat; } n; n.asFloat = f; return n.asInt; }
+
+    //==============================================================================
+    /*  Each of these reads and writes its samples as 32-bit lanes: the integer formats are
+        shifted up to fill all 32 bits (like AudioData::Pointer::getAsInt32() does), and floats
+        are passed around as their raw bit-patterns. load4() and store4() handle four packed
+        samples at once, and load4() may read numExtraSamplesRead samples beyond those four.
+    */
+    template <bool bigEndian>
+    struct Int16Format
+    {
+        enum { bytesPerSample = 2, isFloat = 0, numExtraSamplesRead = 0 };
+
+        static forcedinline int32 read (const char* p) noexcept
+        {
+            return (int32) ((uint32) (bigEndian ? ByteOrder::bigEndianShort (p) : ByteOrder::littleEndianShort (p)) << 16);
+        }
+
+        static forcedinline void write (char* p, int32 v) noexcept
+        {
+            const uint16 s = (uint16) (v >> 16);
+            *(uint16*) p = bigEndian ? ByteOrder::swapIfLittleEndian (s) : ByteOrder::swapIfBigEndian (s);
+        }
+
+        static forcedinline __m128i load4 (const char* p) noexcept
+        {
+            __m128i v = _mm_loadl_epi64 ((const __m128i*) p);
+
+            if (bigEndian)
+                v = byteSwap16 (v);
+
+            return _mm_unpacklo_epi16 (_mm_setzero_si128(), v);
+        }
+
+        static forcedinline void store4 (char* p, __m128i v) noexcept
+        {
+            v = _mm_srai_epi32 (v, 16);
+            v = _mm_packs_epi32 (v, v);
+
+            if (bigEndian)
+                v = byteSwap16 (v);
+
+            _mm_storel_epi64 ((__m128i*) p, v);
+        }
+    };
+
+    template <bool bigEndian>
+    struct Int24Format
+    {
+        enum { bytesPerSample = 3, isFloat = 0, numExtraSamplesRead = 2 };
+
+        static forcedinline int32 read (const char* p) noexcept
+        {
+            return (int32) ((uint32) (bigEndian ? ByteOrder::bigEndian24Bit (p) : ByteOrder::littleEndian24Bit (p)) << 8);
+        }
+
+        static forcedinline void write (char* p, int32 v) noexcept
+        {
+            if (bigEndian)
+                ByteOrder::bigEndian24BitToChars (v >> 8, p);
+            else
+                ByteOrder::littleEndian24BitToChars (v >> 8, p);
+        }
+
+        static forcedinline __m128i load4 (const char* p) noexcept
+        {
+            // moves each 3-byte sample into the bottom of its own lane (the top byte is junk)..
+            const __m128i raw = _mm_loadu_si128 ((const __m128i*) p);
+            const __m128i v = _mm_unpacklo_epi64 (_mm_unpacklo_epi32 (raw, _mm_srli_si128 (raw, 3)),
+                                                  _mm_unpacklo_epi32 (_mm_srli_si128 (raw, 6), _mm_srli_si128 (raw, 9)));
+
+            // ..then shifts (or byte-swaps) it up to the top, which pushes the junk out
+            return bigEndian ? _mm_and_si128 (byteSwap32 (v), _mm_set1_epi32 ((int) 0xffffff00))
+                             : _mm_slli_epi32 (v, 8);
+        }
+
+        static forcedinline void store4 (char* p, __m128i v) noexcept
+        {
+            int32 s[4];
+            _mm_storeu_si128 ((__m128i*) s, v);
+
+            write (p,     s[0]);
+            write (p + 3, s[1]);
+            write (p + 6, s[2]);
+            write (p + 9, s[3]);
+        }
+    };
+
+    template <bool bigEndian>
+    struct Int32Format
+    {
+        enum { bytesPerSample = 4, isFloat = 0, numExtraSamplesRead = 0 };
+
+        static forcedinline int32 read (const char* p) noexcept
+        {
+            return (int32) (bigEndian ? ByteOrder::bigEndianInt (p) : ByteOrder::littleEndianInt (p));
+        }
+
+        static forcedinline void write (char* p, int32 v) noexcept
+        {
+            *(uint32*) p = bigEndian ? ByteOrder::swapIfLittleEndian ((uint32) v) : ByteOrder::swapIfBigEndian ((uint32) v);
+        }
+
+        static forcedinline __m128i load4 (const char* p) noexcept
+        {
+            const __m128i v = _mm_loadu_si128 ((const __m128i*) p);
+            return bigEndian ? byteSwap32 (v) : v;
+        }
+
+        static forcedinline void store4 (char* p, __m128i v) noexcept
+        {
+            _mm_storeu_si128 ((__m128i*) p, bigEndian ? byteSwap32 (v) : v);
+        }
+    };
+
+    template <bool bigEndian>
+    struct Float32Format  : public Int32Format<bigEndian>
+    {
+        enum { isFloat = 1 };
+    };
+
+    //==============================================================================
+    // These map between the integer and floating-point lane representations
+    struct CopyBits
+    {
+        static forcedinline int32 convert (int32 v) noexcept        { return v; }
+        static forcedinline __m128i convert (__m128i v) noexcept    { return v; }
+    };
+
+    struct IntToFloat
+    {
+        static forcedinline int32 convert (int32 v) noexcept
+        {
+            return floatToIntBits ((float) (v * (1.0 / (1.0 + AudioData::Int32::maxValue))));
+        }
+
+        // (the scale is a power of two, so this rounds exactly like the double-precision version)
+        static forcedinline __m128i convert (__m128i v) noexcept
+        {
+            return _mm_castps_si128 (_mm_mul_ps (_mm_cvtepi32_ps (v), _mm_set1_ps ((float) (1.0 / (1.0 + AudioData::Int32::maxValue)))));
+        }
+    };
+
+    struct FloatToInt
+    {
+        static forcedinline int32 convert (int32 v) noexcept
+        {
+            return (int32) roundToInt (jlimit (-1.0, 1.0, (double) intBitsToFloat (v)) * (double) AudioData::Int32::maxValue);
+        }
+
+        static forcedinline __m128i convert (__m128i v) noexcept
+        {
+            const __m128 f = _mm_castsi128_ps (v);
+
+            return _mm_unpacklo_epi64 (_mm_cvtpd_epi32 (clipAndScale (_mm_cvtps_pd (f))),
+                                       _mm_cvtpd_epi32 (clipAndScale (_mm_cvtps_pd (_mm_movehl_ps (f, f)))));
+        }
+
+        static forcedinline __m128d clipAndScale (__m128d v) noexcept
+        {
+            v = _mm_and_pd (v, _mm_cmpord_pd (v, v)); // (turns NaNs into zeros)
+            v = _mm_min_pd (_mm_max_pd (v, _mm_set1_pd (-1.0)), _mm_set1_pd (1.0));
+            return _mm_mul_pd (v, _mm_set1_pd ((double) AudioData::Int32::maxValue));
+        }
+    };
+
+    template <int sourceIsFloat, int destIsFloat> struct TransformFor    { typedef CopyBits Type; };
+    template <> struct TransformFor<0, 1>                                 { typedef IntToFloat Type; };
+    template <> struct TransformFor<1, 0>                                 { typedef FloatToInt Type; };
+
+    //==============================================================================
+    template <class SourceFormat>
+    static forcedinline __m128i gather4 (const char* source, int stride) noexcept
+    {
+        return _mm_set_epi32 (SourceFormat::read (source + 3 * stride), SourceFormat::read (source + 2 * stride),
+                              SourceFormat::read (source + stride),     SourceFormat::read (source));
+    }
+
+    template <class DestFormat>
+    static forcedinline void scatter4 (char* dest, int stride, __m128i v) noexcept
+    {
+        int32 s[4];
+        _mm_storeu_si128 ((__m128i*) s, v);
+
+        for (int i = 0; i < 4; ++i)
+            DestFormat::write (dest + i * stride, s[i]);
+    }
+
+    template <class SourceFormat>
+    static forcedinline __m128i load4 (const char* source, int stride, bool isPacked) noexcept
+    {
+        return isPacked ? SourceFormat::load4 (source) : gather4<SourceFormat> (source, stride);
+    }
+
+    template <class DestFormat, class SourceFormat>
+    static void convert (char* dest, int destStride, const char* source, int sourceStride, int numSamples) noexcept
+    {
+        typedef typename TransformFor<SourceFormat::isFloat, DestFormat::isFloat>::Type Transform;
+
+        const bool packedSource = (sourceStride == (int) SourceFormat::bytesPerSample);
+        const bool packedDest   = (destStride == (int) DestFormat::bytesPerSample);
+        const int numVectorised = packedSource ? numSamples - (int) SourceFormat::numExtraSamplesRead : numSamples;
+        int i = 0;
+
+        for (; i + 4 <= numVectorised; i += 4)
+        {
+            const __m128i v = Transform::convert (load4<SourceFormat> (source, sourceStride, packedSource));
+
+            if (packedDest)
+                DestFormat::store4 (dest, v);
+            else
+                scatter4<DestFormat> (dest, destStride, v);
+
+            source += 4 * sourceStride;
+            dest   += 4 * destStride;
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            DestFormat::write (dest, Transform::convert (SourceFormat::read (source)));
+            source += sourceStride;
+            dest   += destStride;
+        }
+    }
+
+    template <class DestFormat, class SourceFormat>
+    static void deinterleaveStereo (char* left, char* right, const char* source, int numSamples) noexcept
+    {
+        typedef typename TransformFor<SourceFormat::isFloat, DestFormat::isFloat>::Type Transform;
+
+        const int numVectorised = numSamples - ((int) SourceFormat::numExtraSamplesRead + 1) / 2;
+        int i = 0;
+
+        for (; i + 4 <= numVectorised; i += 4)
+        {
+            const __m128 a = _mm_castsi128_ps (Transform::convert (SourceFormat::load4 (source)));
+            const __m128 b = _mm_castsi128_ps (Transform::convert (SourceFormat::load4 (source + 4 * SourceFormat::bytesPerSample)));
+
+            DestFormat::store4 (left,  _mm_castps_si128 (_mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0))));
+            DestFormat::store4 (right, _mm_castps_si128 (_mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1))));
+
+            source += 8 * SourceFormat::bytesPerSample;
+            left   += 4 * DestFormat::bytesPerSample;
+            right  += 4 * DestFormat::bytesPerSample;
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            DestFormat::write (left,  Transform::convert (SourceFormat::read (source)));
+            DestFormat::write (right, Transform::convert (SourceFormat::read (source + SourceFormat::bytesPerSample)));
+
+            source += 2 * SourceFormat::bytesPerSample;
+            left   += DestFormat::bytesPerSample;
+            right  += DestFormat::bytesPerSample;
+        }
+    }
+
+    template <class DestFormat, class SourceFormat>
+    static void deinterleave (char* const* dest, const char* source, int numChannels, int numSamples) noexcept
+    {
+        if (numChannels == 2)
+        {
+            deinterleaveStereo<DestFormat, SourceFormat> (dest[0], dest[1], source, numSamples);
+        }
+        else
+        {
+            for (int i = 0; i < numChannels; ++i)
+                convert<DestFormat, SourceFormat> (dest[i], DestFormat::bytesPerSample,
+                                                   source + i * SourceFormat::bytesPerSample,
+                                                   numChannels * SourceFormat::bytesPerSample, numSamples);
+        }
+    }
+
+    //==============================================================================
+    template <class SourceFormat>
+    static forcedinline float toFloat (int32 v) noexcept      { return SourceFormat::isFloat ? intBitsToFloat (v) : (float) v; }
+
+    template <class SourceFormat>
+    static forcedinline __m128 toFloat (__m128i v) noexcept   { return SourceFormat::isFloat ? _mm_castsi128_ps (v) : _mm_cvtepi32_ps (v); }
+
+    // Because int -> float conversion is monotonic, comparing the converted integers gives
+    // exactly the same result as comparing the original ones.
+    template <class SourceFormat>
+    static Range<float> findMinAndMax (const char* source, int stride, size_t numSamples) noexcept
+    {
+        const bool packed = (stride == (int) SourceFormat::bytesPerSample);
+        const size_t numExtraSamples = packed ? (size_t) SourceFormat::numExtraSamplesRead : 0;
+        const size_t numVectorised = numSamples > numExtraSamples ? numSamples - numExtraSamples : 0;
+
+        __m128 mn = _mm_set1_ps (toFloat<SourceFormat> (SourceFormat::read (source)));
+        __m128 mx = mn;
+        size_t i = 0;
+
+        for (; i + 4 <= numVectorised; i += 4)
+        {
+            const __m128 v = toFloat<SourceFormat> (load4<SourceFormat> (source, stride, packed));
+            mn = _mm_min_ps (v, mn);
+            mx = _mm_max_ps (v, mx);
+            source += 4 * stride;
+        }
+
+        float mins[4], maxs[4];
+        _mm_storeu_ps (mins, mn);
+        _mm_storeu_ps (maxs, mx);
+
+        float lowest = mins[0], highest = maxs[0];
+
+        for (int j = 1; j < 4; ++j)
+        {
+            if (mins[j] < lowest)   lowest  = mins[j];
+            if (highest < maxs[j])  highest = maxs[j];
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            const float v = toFloat<SourceFormat> (SourceFormat::read (source));
+            source += stride;
+
+            if (highest < v)  highest = v;
+            if (v < lowest)   lowest = v;
+        }
+
+        if (! SourceFormat::isFloat)
+        {
+            lowest  *= (float) (1.0 / (1.0 + AudioData::Int32::maxValue));
+            highest *= (float) (1.0 / (1.0 + AudioData::Int32::maxValue));
+        }
+
+        return Range<float> (lowest, highest);
+    }
+
+    //==============================================================================
+    // Calls op.run<FormatType>() for the class that matches a format enum
+    template <class Operation>
+    static bool callWithFormat (AudioData::BlockConversions::Format format, const Operation& op)
+    {
+        switch (format)
+        {
+            case AudioData::BlockConversions::int16LE:     op.template run<Int16Format<false> >();   return true;
+            case AudioData::BlockConversions::int16BE:     op.template run<Int16Format<true> >();    return true;
+            case AudioData::BlockConversions::int24LE:     op.template run<Int24Format<false> >();   return true;
+            case AudioData::BlockConversions::int24BE:     op.template run<Int24Format<true> >();    return true;
+            case AudioData::BlockConversions::int32LE:     op.template run<Int32Format<false> >();   return true;
+            case AudioData::BlockConversions::int32BE:     op.template run<Int32Format<true> >();    return true;
+            case AudioData::BlockConversions::float32LE:   op.template run<Float32Format<false> >(); return true;
+            case AudioData::BlockConversions::float32BE:   op.template run<Float32Format<true> >();  return true;
+            default:                                        return false;
+        }
+    }
+
+    struct ConvertOperation
+    {
+        char* dest;
+        int destStride;
+        const char* source;
+        int sourceStride, numSamples;
+        AudioData::BlockConversions::Format sourceFormat;
+
+        template <class DestFormat>
+        struct WithDest
+        {
+            const ConvertOperation& owner;
+
+            template <class SourceFormat>
+            void run() const
+            {
+                convert<DestFormat, SourceFormat> (owner.dest, owner.destStride, owner.source, owner.sourceStride, owner.numSamples);
+            }
+        };
+
+        template <class DestFormat>
+        void run() const
+        {
+            const WithDest<DestFormat> op = { *this };
+            callWithFormat (sourceFormat, op);
+        }
+    };
+
+    struct DeinterleaveOperation
+    {
+        char* const* dest;
+        const char* source;
+        int numChannels, numSamples;
+        AudioData::BlockConversions::Format sourceFormat;
+
+        template <class DestFormat>
+        struct WithDest
+        {
+            const DeinterleaveOperation& owner;
+
+            template <class SourceFormat>
+            void run() const
+            {
+                deinterleave<DestFormat, SourceFormat> (owner.dest, owner.source, owner.numChannels, owner.numSamples);
+            }
+        };
+
+        template <class DestFormat>
+        void run() const
+        {
+            const WithDest<DestFormat> op = { *this };
+            callWithFormat (sourceFormat, op);
+        }
+    };
+
+    struct MinAndMaxOperation
+    {
+        const char* source;
+        int stride;
+        size_t numSamples;
+        Range<float>& result;
+
+        template <class SourceFormat>
+        void run() const
+        {
+            result = findMinAndMax<SourceFormat> (source, stride, numSamples);
+        }
+    };
+   #endif
+}
+
+bool AudioData::BlockConversions::convert (void* dest, Format destFormat, int destStride,
+                                           const void* source, Format sourceFormat, int sourceStride,
+                                           int numSamples) noexcept
+{
+    using namespace BlockConversionHelpers;
+
+    const int destBytesPerSample   = getBytesPerSample (destFormat);
+    const int sourceBytesPerSample = getBytesPerSample (sourceFormat);
+
+    if (numSamples < minimumBlockSize || destBytesPerSample == 0 || sourceBytesPerSample == 0
+         || blocksOverlap (dest, destStride, destBytesPerSample, source, sourceStride, sourceBytesPerSample, numSamples))
+        return false;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const ConvertOperation op = { static_cast<char*> (dest), destStride,
+                                  static_cast<const char*> (source), sourceStride, numSamples, sourceFormat };
+
+    return callWithFormat (destFormat, op);
+   #else
+    return false;
+   #endif
+}
+
+bool AudioData::BlockConversions::deinterleave (void* const* dest, Format destFormat,
+                                                const void* source, Format sourceFormat,
+                                                int numChannels, int numSamples) noexcept
+{
+    using namespace BlockConversionHelpers;
+
+    const int destBytesPerSample   = getBytesPerSample (destFormat);
+    const int sourceBytesPerSample = getBytesPerSample (sourceFormat);
+
+    if (numSamples < minimumBlockSize || numChannels <= 0 || destBytesPerSample == 0 || sourceBytesPerSample == 0)
+        return false;
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        jassert (dest[i] != nullptr);
+
+        if (blocksOverlap (dest[i], destBytesPerSample, destBytesPerSample,
+                           source, numChannels * sourceBytesPerSample, numChannels * sourceBytesPerSample, numSamples))
+            return false;
+    }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const DeinterleaveOperation op = { reinterpret_cast<char* const*> (dest), static_cast<const char*> (source),
+                                       numChannels, numSamples, sourceFormat };
+
+    return callWithFormat (destFormat, op);
+   #else
+    return false;
+   #endif
+}
+
+bool AudioData::BlockConversions::findMinAndMax (const void* source, Format sourceFormat, int stride,
+                                                 size_t numSamples, Range<float>& result) noexcept
+{
+    using namespace BlockConversionHelpers;
+
+    if (numSamples < (size_t) minimumBlockSize)
+        return false;
+
+   #if JUCE_USE_SSE_INTRINSICS
+    const MinAndMaxOperation op = { static_cast<const char*> (source), stride, numSamples, result };
+    return callWithFormat (sourceFormat, op);
+   #else
+    ignoreUnused (source, sourceFormat, stride, result);
+    return false;
+   #endif
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -579,6 +1115,198 @@ public:
         }
     };
 
+    //==============================================================================
+    template <class Format, class Endianness>
+    static void fillWithTestData (void* data, int numSamples, Random& r)
+    {
+        AudioData::Pointer<Format, Endianness, AudioData::NonInterleaved, AudioData::NonConst> d (data);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (d.isFloatingPoint())
+                d.setAsFloat (i % 17 == 0 ? (float) (i % 3) - 1.0f : r.nextFloat() * 2.4f - 1.2f);
+            else
+                d.setAsInt32 (r.nextInt());
+
+            ++d;
+        }
+    }
+
+    // A sample-by-sample version of what Pointer::convertSamples() does
+    template <class DestType, class SourceType>
+    static void convertOneByOne (DestType dest, SourceType source, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (dest.isFloatingPoint())
+                dest.setAsFloat (source.getAsFloat());
+            else
+                dest.setAsInt32 (source.getAsInt32());
+
+            ++dest;
+            ++source;
+        }
+    }
+
+    template <class SourceType>
+    static Range<float> findMinAndMaxOneByOne (SourceType source, int numSamples)
+    {
+        if (source.isFloatingPoint())
+        {
+            float mn = source.getAsFloat(), mx = mn;
+
+            while (--numSamples > 0)
+            {
+                ++source;
+                mn = jmin (mn, source.getAsFloat());
+                mx = jmax (mx, source.getAsFloat());
+            }
+
+            return Range<float> (mn, mx);
+        }
+
+        int32 mn = source.getAsInt32(), mx = mn;
+
+        while (--numSamples > 0)
+        {
+            ++source;
+            mn = jmin (mn, source.getAsInt32());
+            mx = jmax (mx, source.getAsInt32());
+        }
+
+        return Range<float> (mn * (float) (1.0 / (1.0 + AudioData::Int32::maxValue)),
+                             mx * (float) (1.0 / (1.0 + AudioData::Int32::maxValue)));
+    }
+
+    template <class F1, class E1, class F2, class E2>
+    struct BlockTest
+    {
+        typedef AudioData::Pointer<F1, E1, AudioData::Interleaved, AudioData::Const>    SourceType;
+        typedef AudioData::Pointer<F2, E2, AudioData::Interleaved, AudioData::NonConst> DestType;
+
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            for (int numChannels = 1; numChannels <= 3; ++numChannels)
+            {
+                const int numSamples = 100 + r.nextInt (100);
+                const size_t numBytes = (size_t) (numSamples * numChannels * 4);
+
+                // (the source is sized exactly, so that any reads past its end will show up)
+                HeapBlock<char> source ((size_t) (numSamples * numChannels * SourceType::getBytesPerSample()));
+                HeapBlock<char> expected (numBytes, true), actual (numBytes, true);
+                fillWithTestData<F1, E1> (source, numSamples * numChannels, r);
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                {
+                    const int sourceOffset = chan * SourceType::getBytesPerSample();
+                    const int destOffset = chan * DestType::getBytesPerSample();
+
+                    convertOneByOne (DestType (expected + destOffset, numChannels), SourceType (source + sourceOffset, numChannels), numSamples);
+                    DestType (actual + destOffset, numChannels).convertSamples (SourceType (source + sourceOffset, numChannels), numSamples);
+
+                    const Range<float> expectedRange (findMinAndMaxOneByOne (SourceType (source + sourceOffset, numChannels), numSamples));
+                    const Range<float> actualRange (SourceType (source + sourceOffset, numChannels).findMinAndMax ((size_t) numSamples));
+                    unitTest.expect (expectedRange == actualRange);
+                }
+
+                unitTest.expect (memcmp (expected, actual, numBytes) == 0);
+
+                // and split the whole block into separate channels in one go..
+                HeapBlock<char> channelData (numBytes, true);
+                void* channels[3];
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                    channels[chan] = channelData + chan * numSamples * DestType::getBytesPerSample();
+
+                if (AudioData::BlockConversions::deinterleave (channels, AudioData::BlockConversions::getFormat<DestType>(),
+                                                               source, AudioData::BlockConversions::getFormat<SourceType>(),
+                                                               numChannels, numSamples))
+                {
+                    for (int chan = 0; chan < numChannels; ++chan)
+                    {
+                        HeapBlock<char> oneChannel ((size_t) numSamples * 4, true);
+                        convertOneByOne (DestType (oneChannel, 1),
+                                         SourceType (source + chan * SourceType::getBytesPerSample(), numChannels), numSamples);
+
+                        unitTest.expect (memcmp (oneChannel, channels[chan], (size_t) (numSamples * DestType::getBytesPerSample())) == 0);
+                    }
+                }
+            }
+        }
+    };
+
+    template <class F1, class E1, class FormatType>
+    struct BlockTest3
+    {
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            BlockTest <F1, E1, FormatType, AudioData::BigEndian>::test (unitTest, r);
+            BlockTest <F1, E1, FormatType, AudioData::LittleEndian>::test (unitTest, r);
+        }
+    };
+
+    template <class FormatType, class Endianness>
+    struct BlockTest2
+    {
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            BlockTest3 <FormatType, Endianness, AudioData::Int16>::test (unitTest, r);
+            BlockTest3 <FormatType, Endianness, AudioData::Int24>::test (unitTest, r);
+            BlockTest3 <FormatType, Endianness, AudioData::Int32>::test (unitTest, r);
+            BlockTest3 <FormatType, Endianness, AudioData::Float32>::test (unitTest, r);
+        }
+    };
+
+    template <class FormatType>
+    struct BlockTest1
+    {
+        static void test (UnitTest& unitTest, Random& r)
+        {
+            BlockTest2 <FormatType, AudioData::BigEndian>::test (unitTest, r);
+            BlockTest2 <FormatType, AudioData::LittleEndian>::test (unitTest, r);
+        }
+    };
+
+    //==============================================================================
+    template <class DestFormat, class SourceFormat, class SourceEndianness>
+    void logConversionSpeed (const char* description, int numChannels)
+    {
+        typedef AudioData::Pointer<SourceFormat, SourceEndianness, AudioData::Interleaved, AudioData::Const> SourceType;
+        typedef AudioData::Pointer<DestFormat, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst> DestType;
+
+        const int numSamples = 65536, numRepeats = 20;
+        HeapBlock<char> source ((size_t) (numSamples * numChannels * SourceType::getBytesPerSample()), true);
+        HeapBlock<float> dest ((size_t) numSamples, true);
+
+        Random r (1234);
+        fillWithTestData<SourceFormat, SourceEndianness> (source, numSamples * numChannels, r);
+
+        double oneByOneTime = 0, blockTime = 0;
+
+        for (int i = 0; i < numRepeats; ++i)
+        {
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                const SourceType s (source + chan * SourceType::getBytesPerSample(), numChannels);
+
+                const double t1 = Time::getMillisecondCounterHiRes();
+                convertOneByOne (DestType (dest), s, numSamples);
+                const double t2 = Time::getMillisecondCounterHiRes();
+                DestType (dest).convertSamples (s, numSamples);
+                const double t3 = Time::getMillisecondCounterHiRes();
+
+                oneByOneTime += t2 - t1;
+                blockTime += t3 - t2;
+            }
+        }
+
+        const double megabytes = numRepeats * numChannels * numSamples * SourceType::getBytesPerSample() / (1024.0 * 1024.0);
+
+        logMessage (String (description) + ": " + String (roundToInt (megabytes * 1000.0 / jmax (0.001, oneByOneTime))) + " MB/s one sample at a time, "
+                      + String (roundToInt (megabytes * 1000.0 / jmax (0.001, blockTime))) + " MB/s in blocks (x"
+                      + String (oneByOneTime / jmax (0.001, blockTime), 2) + ")");
+    }
+
     void runTest() override
     {
         Random r = getRandom();
@@ -592,6 +1320,23 @@ public:
         Test1 <AudioData::Int32>::test (*this, r);
         beginTest ("Round-trip conversion: Float32");
         Test1 <AudioData::Float32>::test (*this, r);
+
+        beginTest ("Block conversions: Int16");
+        BlockTest1 <AudioData::Int16>::test (*this, r);
+        beginTest ("Block conversions: Int24");
+        BlockTest1 <AudioData::Int24>::test (*this, r);
+        beginTest ("Block conversions: Int32");
+        BlockTest1 <AudioData::Int32>::test (*this, r);
+        beginTest ("Block conversions: Float32");
+        BlockTest1 <AudioData::Float32>::test (*this, r);
+
+        beginTest ("Block conversion throughput");
+        logConversionSpeed<AudioData::Float32, AudioData::Int16,   AudioData::LittleEndian> ("Int16 LE stereo -> float", 2);
+        logConversionSpeed<AudioData::Float32, AudioData::Int24,   AudioData::LittleEndian> ("Int24 LE stereo -> float", 2);
+        logConversionSpeed<AudioData::Int32,   AudioData::Int24,   AudioData::BigEndian>    ("Int24 BE mono -> int", 1);
+        logConversionSpeed<AudioData::Float32, AudioData::Int32,   AudioData::BigEndian>    ("Int32 BE mono -> float", 1);
+        logConversionSpeed<AudioData::Float32, AudioData::Float32, AudioData::BigEndian>    ("Float32 BE stereo -> float", 2);
+        logConversionSpeed<AudioData::Int32,   AudioData::Float32, AudioData::LittleEndian> ("Float32 LE mono -> int", 1);
     }
 };
 
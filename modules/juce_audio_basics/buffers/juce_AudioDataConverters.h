@@ -323,6 +323,67 @@ public:
     };
   #endif
 
+    //==============================================================================
+    /**
+        Vectorised implementations of the most common block conversions.
+
+        Pointer::convertSamples() and Pointer::findMinAndMax() automatically hand over to
+        these whenever both formats are 16, 24 or 32-bit packed integers or 32-bit floats,
+        so you shouldn't normally need to call them directly.
+
+        Each function returns false if it can't handle the request (e.g. if the CPU has no
+        suitable SIMD instructions, or the source and destination blocks overlap), in which
+        case the caller should fall back to converting the samples one at a time.
+
+        The results are bit-for-bit identical to the ones that the Pointer class produces.
+    */
+    struct BlockConversions
+    {
+        /** The packed formats that these routines know about. */
+        enum Format
+        {
+            unsupported = 0,
+            int16LE, int16BE,
+            int24LE, int24BE,
+            int32LE, int32BE,
+            float32LE, float32BE
+        };
+
+        /** Returns the Format that corresponds to an AudioData::Pointer type. */
+        template <class PointerType>
+        static Format getFormat() noexcept
+        {
+            const bool bigEndian = PointerType::isBigEndian();
+
+            if (PointerType::isFloatingPoint())
+                return PointerType::getBytesPerSample() == 4 ? (bigEndian ? float32BE : float32LE) : unsupported;
+
+            switch (PointerType::getBytesPerSample())
+            {
+                case 2:     return bigEndian ? int16BE : int16LE;
+                case 3:     return bigEndian ? int24BE : int24LE;
+                case 4:     return PointerType::get32BitResolution() == 1 ? (bigEndian ? int32BE : int32LE) : unsupported;
+                default:    return unsupported;
+            }
+        }
+
+        /** Converts a run of samples, where each block may be strided (i.e. interleaved). */
+        static bool convert (void* dest, Format destFormat, int destBytesBetweenSamples,
+                             const void* source, Format sourceFormat, int sourceBytesBetweenSamples,
+                             int numSamples) noexcept;
+
+        /** Splits an interleaved block into a set of packed, non-interleaved channels.
+            The dest array must contain numChannels non-null pointers.
+        */
+        static bool deinterleave (void* const* dest, Format destFormat,
+                                  const void* source, Format sourceFormat,
+                                  int numChannels, int numSamples) noexcept;
+
+        /** Scans a (possibly strided) block, returning its lowest and highest levels as floats. */
+        static bool findMinAndMax (const void* source, Format sourceFormat, int bytesBetweenSamples,
+                                   size_t numSamples, Range<float>& result) noexcept;
+    };
+
     //==============================================================================
     /**
         A pointer to a block of audio data with a particular encoding.
@@ -458,6 +519,15 @@ public:
         {
             static_jassert (Constness::isConst == 0); // trying to write to a const pointer! For a writeable one, use AudioData::NonConst instead!
 
+            const BlockConversions::Format destFormat   = BlockConversions::getFormat<Pointer>();
+            const BlockConversions::Format sourceFormat = BlockConversions::getFormat<OtherPointerType>();
+
+            if (destFormat != BlockConversions::unsupported && sourceFormat != BlockConversions::unsupported
+                 && BlockConversions::convert (data.data, destFormat, getNumBytesBetweenSamples(),
+                                               source.getRawData(), sourceFormat, source.getNumBytesBetweenSamples(),
+                                               numSamples))
+                return;
+
             Pointer dest (*this);
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
@@ -492,6 +562,13 @@ public:
             if (numSamples == 0)
                 return Range<float>();
 
+            const BlockConversions::Format format = BlockConversions::getFormat<Pointer>();
+            Range<float> result;
+
+            if (format != BlockConversions::unsupported
+                 && BlockConversions::findMinAndMax (data.data, format, getNumBytesBetweenSamples(), numSamples, result))
+                return result;
+
             Pointer dest (*this);
 
             if (isFloatingPoint())
@@ -24,9 +24,9 @@
 
 namespace FloatVectorHelpers
 {
-    #define JUCE_INCREMENT_SRC_DEST         dest += (16 / sizeof (*dest)); src += (16 / sizeof (*dest));
-    #define JUCE_INCREMENT_SRC1_SRC2_DEST   dest += (16 / sizeof (*dest)); src1 += (16 / sizeof (*dest)); src2 += (16 / sizeof (*dest));
-    #define JUCE_INCREMENT_DEST             dest += (16 / sizeof (*dest));
+    #define JUCE_INCREMENT_SRC_DEST         dest += Mode::numParallel; src += Mode::numParallel;
+    #define JUCE_INCREMENT_SRC1_SRC2_DEST   dest += Mode::numParallel; src1 += Mode::numParallel; src2 += Mode::numParallel;
+    #define JUCE_INCREMENT_DEST             dest += Mode::numParallel;
 
    #if JUCE_USE_SSE_INTRINSICS
     inline static bool isAligned (const void* p) noexcept
@@ -484,6 +484,340 @@ namespace FloatVectorHelpers
         }
     };
    #endif
+
+    //==============================================================================
+   #if JUCE_USE_AVX_INTRINSICS
+    /*  256-bit versions of the operations, which are only called if the CPU turns out
+        to support AVX2 and FMA3. These are compiled with a per-function target attribute,
+        so the rest of the module can still run on machines that only have SSE2.
+
+        Since there's no penalty for using unaligned loads and stores on aligned addresses
+        on any AVX-capable CPU, these don't bother checking the alignment of their arguments.
+    */
+    namespace AVX
+    {
+        struct BasicOps32
+        {
+            typedef float Type;
+            typedef __m256 ParallelType;
+            enum { numParallel = 8 };
+
+            static forcedinline JUCE_AVX_FUNCTION ParallelType load1 (Type v) noexcept                        { return _mm256_set1_ps (v); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_ps (v); }
+            static forcedinline JUCE_AVX_FUNCTION void storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_ps (dest, a); }
+
+            static forcedinline JUCE_AVX_FUNCTION ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm256_add_ps (a, b); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm256_sub_ps (a, b); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm256_mul_ps (a, b); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_ps (a, b); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_ps (a, b); }
+
+            // returns (a * b) + c
+            static forcedinline JUCE_AVX_FUNCTION ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm256_fmadd_ps (a, b, c); }
+
+            static forcedinline JUCE_AVX_FUNCTION ParallelType bit_and (ParallelType a, ParallelType b) noexcept  { return _mm256_and_ps (a, b); }
+
+            static forcedinline JUCE_AVX_FUNCTION Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmax (jmax (v[0], v[1], v[2], v[3]), jmax (v[4], v[5], v[6], v[7])); }
+            static forcedinline JUCE_AVX_FUNCTION Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmin (jmin (v[0], v[1], v[2], v[3]), jmin (v[4], v[5], v[6], v[7])); }
+        };
+
+        struct BasicOps64
+        {
+            typedef double Type;
+            typedef __m256d ParallelType;
+            enum { numParallel = 4 };
+
+            static forcedinline JUCE_AVX_FUNCTION ParallelType load1 (Type v) noexcept                        { return _mm256_set1_pd (v); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_pd (v); }
+            static forcedinline JUCE_AVX_FUNCTION void storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_pd (dest, a); }
+
+            static forcedinline JUCE_AVX_FUNCTION ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm256_add_pd (a, b); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm256_sub_pd (a, b); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm256_mul_pd (a, b); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_pd (a, b); }
+            static forcedinline JUCE_AVX_FUNCTION ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_pd (a, b); }
+
+            // returns (a * b) + c
+            static forcedinline JUCE_AVX_FUNCTION ParallelType mulAdd (ParallelType a, ParallelType b, ParallelType c) noexcept  { return _mm256_fmadd_pd (a, b, c); }
+
+            static forcedinline JUCE_AVX_FUNCTION ParallelType bit_and (ParallelType a, ParallelType b) noexcept  { return _mm256_and_pd (a, b); }
+
+            static forcedinline JUCE_AVX_FUNCTION Type max (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmax (v[0], v[1], v[2], v[3]); }
+            static forcedinline JUCE_AVX_FUNCTION Type min (ParallelType a) noexcept { Type v[numParallel]; storeU (v, a); return jmin (v[0], v[1], v[2], v[3]); }
+        };
+
+        template<int typeSize> struct ModeType    { typedef BasicOps32 Mode; };
+        template<>             struct ModeType<8> { typedef BasicOps64 Mode; };
+
+        /** This is decided once when the module is loaded. */
+        static const bool isEnabled = SystemStats::hasAVX() && SystemStats::hasAVX2() && SystemStats::hasFMA3();
+
+        #define JUCE_BEGIN_AVX_OP \
+            typedef typename FloatVectorHelpers::AVX::ModeType<sizeof(*dest)>::Mode Mode; \
+            typedef typename Mode::ParallelType ParallelType; \
+            { \
+                const int numLongOps = num / Mode::numParallel;
+
+        // (these are the same as the JUCE_LOAD_xxx macros, but for use inside the templates below)
+        #define JUCE_LOAD_AVX_DEST(srcLoad, dstLoad)                        const ParallelType d = dstLoad (dest);
+        #define JUCE_LOAD_AVX_SRC(srcLoad, dstLoad)                         const ParallelType s = srcLoad (src);
+        #define JUCE_LOAD_AVX_SRC1_SRC2(src1Load, src2Load)                 const ParallelType s1 = src1Load (src1), s2 = src2Load (src2);
+        #define JUCE_LOAD_AVX_SRC1_SRC2_DEST(src1Load, src2Load, dstLoad)   const ParallelType d = dstLoad (dest), s1 = src1Load (src1), s2 = src2Load (src2);
+        #define JUCE_LOAD_AVX_SRC_DEST(srcLoad, dstLoad)                    const ParallelType d = dstLoad (dest), s = srcLoad (src);
+
+        #define JUCE_PERFORM_AVX_OP_DEST(normalOp, vecOp, locals, setupOp) \
+            JUCE_BEGIN_AVX_OP \
+            setupOp \
+            JUCE_VEC_LOOP (vecOp, dummy, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_DEST) \
+            JUCE_FINISH_VEC_OP (normalOp)
+
+        #define JUCE_PERFORM_AVX_OP_SRC_DEST(normalOp, vecOp, locals, setupOp) \
+            JUCE_BEGIN_AVX_OP \
+            setupOp \
+            JUCE_VEC_LOOP (vecOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_SRC_DEST) \
+            JUCE_FINISH_VEC_OP (normalOp)
+
+        #define JUCE_PERFORM_AVX_OP_SRC1_SRC2_DEST(normalOp, vecOp, locals, setupOp) \
+            JUCE_BEGIN_AVX_OP \
+            setupOp \
+            JUCE_VEC_LOOP_TWO_SOURCES (vecOp, Mode::loadU, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_SRC1_SRC2_DEST) \
+            JUCE_FINISH_VEC_OP (normalOp)
+
+        #define JUCE_PERFORM_AVX_OP_SRC1_SRC2_DEST_DEST(normalOp, vecOp, locals, setupOp) \
+            JUCE_BEGIN_AVX_OP \
+            setupOp \
+            JUCE_VEC_LOOP_TWO_SOURCES_WITH_DEST_LOAD (vecOp, Mode::loadU, Mode::loadU, Mode::loadU, Mode::storeU, locals, JUCE_INCREMENT_SRC1_SRC2_DEST) \
+            JUCE_FINISH_VEC_OP (normalOp)
+
+        //==============================================================================
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void fill (Type* dest, Type valueToFill, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_DEST (dest[i] = valueToFill, val, JUCE_LOAD_NONE,
+                                      const ParallelType val = Mode::load1 (valueToFill);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void copyWithMultiply (Type* dest, const Type* src, Type multiplier, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = src[i] * multiplier, Mode::mul (mult, s), JUCE_LOAD_AVX_SRC,
+                                          const ParallelType mult = Mode::load1 (multiplier);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void add (Type* dest, Type amount, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_DEST (dest[i] += amount, Mode::add (d, amountToAdd), JUCE_LOAD_AVX_DEST,
+                                      const ParallelType amountToAdd = Mode::load1 (amount);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void add (Type* dest, const Type* src, Type amount, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = src[i] + amount, Mode::add (am, s), JUCE_LOAD_AVX_SRC,
+                                          const ParallelType am = Mode::load1 (amount);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void add (Type* dest, const Type* src, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] += src[i], Mode::add (d, s), JUCE_LOAD_AVX_SRC_DEST, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void add (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC1_SRC2_DEST (dest[i] = src1[i] + src2[i], Mode::add (s1, s2), JUCE_LOAD_AVX_SRC1_SRC2, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void subtract (Type* dest, const Type* src, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] -= src[i], Mode::sub (d, s), JUCE_LOAD_AVX_SRC_DEST, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void subtract (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC1_SRC2_DEST (dest[i] = src1[i] - src2[i], Mode::sub (s1, s2), JUCE_LOAD_AVX_SRC1_SRC2, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void addWithMultiply (Type* dest, const Type* src, Type multiplier, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] += src[i] * multiplier, Mode::mulAdd (mult, s, d), JUCE_LOAD_AVX_SRC_DEST,
+                                          const ParallelType mult = Mode::load1 (multiplier);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void addWithMultiply (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i], Mode::mulAdd (s1, s2, d), JUCE_LOAD_AVX_SRC1_SRC2_DEST, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void multiply (Type* dest, const Type* src, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] *= src[i], Mode::mul (d, s), JUCE_LOAD_AVX_SRC_DEST, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void multiply (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC1_SRC2_DEST (dest[i] = src1[i] * src2[i], Mode::mul (s1, s2), JUCE_LOAD_AVX_SRC1_SRC2, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void multiply (Type* dest, Type multiplier, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_DEST (dest[i] *= multiplier, Mode::mul (d, mult), JUCE_LOAD_AVX_DEST,
+                                      const ParallelType mult = Mode::load1 (multiplier);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void multiply (Type* dest, const Type* src, Type multiplier, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = src[i] * multiplier, Mode::mul (mult, s), JUCE_LOAD_AVX_SRC,
+                                          const ParallelType mult = Mode::load1 (multiplier);)
+        }
+
+        static inline float  getAbsMask (float)  noexcept  { signMask32 m; m.i = 0x7fffffffUL; return m.f; }
+        static inline double getAbsMask (double) noexcept  { signMask64 m; m.i = 0x7fffffffffffffffULL; return m.d; }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void abs (Type* dest, const Type* src, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = std::abs (src[i]), Mode::bit_and (s, mask), JUCE_LOAD_AVX_SRC,
+                                          const ParallelType mask = Mode::load1 (getAbsMask (Type()));)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void convertFixedToFloat (Type* dest, const int* src, Type multiplier, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = src[i] * multiplier,
+                                          Mode::mul (mult, _mm256_cvtepi32_ps (_mm256_loadu_si256 ((const __m256i*) src))),
+                                          JUCE_LOAD_NONE,
+                                          const ParallelType mult = Mode::load1 (multiplier);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void min (Type* dest, const Type* src, Type comp, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = jmin (src[i], comp), Mode::min (s, cmp), JUCE_LOAD_AVX_SRC,
+                                          const ParallelType cmp = Mode::load1 (comp);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void min (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC1_SRC2_DEST (dest[i] = jmin (src1[i], src2[i]), Mode::min (s1, s2), JUCE_LOAD_AVX_SRC1_SRC2, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void max (Type* dest, const Type* src, Type comp, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = jmax (src[i], comp), Mode::max (s, cmp), JUCE_LOAD_AVX_SRC,
+                                          const ParallelType cmp = Mode::load1 (comp);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void max (Type* dest, const Type* src1, const Type* src2, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC1_SRC2_DEST (dest[i] = jmax (src1[i], src2[i]), Mode::max (s1, s2), JUCE_LOAD_AVX_SRC1_SRC2, )
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION void clip (Type* dest, const Type* src, Type low, Type high, int num) noexcept
+        {
+            JUCE_PERFORM_AVX_OP_SRC_DEST (dest[i] = jmax (jmin (src[i], high), low), Mode::max (Mode::min (s, hi), lo), JUCE_LOAD_AVX_SRC,
+                                          const ParallelType lo = Mode::load1 (low); const ParallelType hi = Mode::load1 (high);)
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION Type findMinOrMax (const Type* src, int num, const bool isMinimum) noexcept
+        {
+            typedef typename ModeType<sizeof (Type)>::Mode Mode;
+            int numLongOps = num / Mode::numParallel;
+
+            if (numLongOps > 1)
+            {
+                typename Mode::ParallelType val = Mode::loadU (src);
+
+                if (isMinimum)
+                {
+                    while (--numLongOps > 0)
+                    {
+                        src += Mode::numParallel;
+                        val = Mode::min (val, Mode::loadU (src));
+                    }
+                }
+                else
+                {
+                    while (--numLongOps > 0)
+                    {
+                        src += Mode::numParallel;
+                        val = Mode::max (val, Mode::loadU (src));
+                    }
+                }
+
+                Type result = isMinimum ? Mode::min (val)
+                                        : Mode::max (val);
+
+                num &= (Mode::numParallel - 1);
+                src += Mode::numParallel;
+
+                for (int i = 0; i < num; ++i)
+                    result = isMinimum ? jmin (result, src[i])
+                                       : jmax (result, src[i]);
+
+                return result;
+            }
+
+            return isMinimum ? juce::findMinimum (src, num)
+                             : juce::findMaximum (src, num);
+        }
+
+        template <typename Type>
+        static JUCE_AVX_FUNCTION Range<Type> findMinAndMax (const Type* src, int num) noexcept
+        {
+            typedef typename ModeType<sizeof (Type)>::Mode Mode;
+            int numLongOps = num / Mode::numParallel;
+
+            if (numLongOps > 1)
+            {
+                typename Mode::ParallelType mn = Mode::loadU (src);
+                typename Mode::ParallelType mx = mn;
+
+                while (--numLongOps > 0)
+                {
+                    src += Mode::numParallel;
+                    const typename Mode::ParallelType v = Mode::loadU (src);
+                    mn = Mode::min (mn, v);
+                    mx = Mode::max (mx, v);
+                }
+
+                Range<Type> result (Mode::min (mn),
+                                    Mode::max (mx));
+
+                num &= (Mode::numParallel - 1);
+                src += Mode::numParallel;
+
+                for (int i = 0; i < num; ++i)
+                    result = result.getUnionWith (src[i]);
+
+                return result;
+            }
+
+            return Range<Type>::findMinAndMax (src, num);
+        }
+    }
+
+    #define JUCE_DISPATCH_TO_AVX(functionCall) \
+        if (FloatVectorHelpers::AVX::isEnabled) \
+            return FloatVectorHelpers::AVX::functionCall;
+   #else
+    #define JUCE_DISPATCH_TO_AVX(functionCall)
+   #endif
 }
 
 //==============================================================================
@@ -521,6 +855,7 @@ void JUCE_CALLTYPE FloatVectorOperations::fill (float* dest, float valueToFill,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vfill (&valueToFill, dest, 1, (size_t) num);
    #else
+    JUCE_DISPATCH_TO_AVX (fill (dest, valueToFill, num))
     JUCE_PERFORM_VEC_OP_DEST (dest[i] = valueToFill, val, JUCE_LOAD_NONE,
                               const Mode::ParallelType val = Mode::load1 (valueToFill);)
    #endif
@@ -531,6 +866,7 @@ void JUCE_CALLTYPE FloatVectorOperations::fill (double* dest, double valueToFill
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vfillD (&valueToFill, dest, 1, (size_t) num);
    #else
+    JUCE_DISPATCH_TO_AVX (fill (dest, valueToFill, num))
     JUCE_PERFORM_VEC_OP_DEST (dest[i] = valueToFill, val, JUCE_LOAD_NONE,
                               const Mode::ParallelType val = Mode::load1 (valueToFill);)
    #endif
@@ -551,6 +887,7 @@ void JUCE_CALLTYPE FloatVectorOperations::copyWithMultiply (float* dest, const f
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul (src, 1, &multiplier, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (copyWithMultiply (dest, src, multiplier, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier, Mode::mul (mult, s),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -562,6 +899,7 @@ void JUCE_CALLTYPE FloatVectorOperations::copyWithMultiply (double* dest, const
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmulD (src, 1, &multiplier, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (copyWithMultiply (dest, src, multiplier, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier, Mode::mul (mult, s),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -573,6 +911,7 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, float amount, int nu
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsadd (dest, 1, &amount, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (add (dest, amount, num))
     JUCE_PERFORM_VEC_OP_DEST (dest[i] += amount, Mode::add (d, amountToAdd), JUCE_LOAD_DEST,
                               const Mode::ParallelType amountToAdd = Mode::load1 (amount);)
    #endif
@@ -580,6 +919,7 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, float amount, int nu
 
 void JUCE_CALLTYPE FloatVectorOperations::add (double* dest, double amount, int num) noexcept
 {
+    JUCE_DISPATCH_TO_AVX (add (dest, amount, num))
     JUCE_PERFORM_VEC_OP_DEST (dest[i] += amount, Mode::add (d, amountToAdd), JUCE_LOAD_DEST,
                               const Mode::ParallelType amountToAdd = Mode::load1 (amount);)
 }
@@ -589,6 +929,7 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, const float* src, fl
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsadd (osx108sdkCompatibilityCast (src), 1, &amount, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (add (dest, src, amount, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] + amount, Mode::add (am, s),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType am = Mode::load1 (amount);)
@@ -600,6 +941,7 @@ void JUCE_CALLTYPE FloatVectorOperations::add (double* dest, const double* src,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsaddD (osx108sdkCompatibilityCast (src), 1, &amount, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (add (dest, src, amount, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] + amount, Mode::add (am, s),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType am = Mode::load1 (amount);)
@@ -611,6 +953,7 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, const float* src, in
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vadd (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (add (dest, src, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i], Mode::add (d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
    #endif
 }
@@ -620,6 +963,7 @@ void JUCE_CALLTYPE FloatVectorOperations::add (double* dest, const double* src,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vaddD (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (add (dest, src, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i], Mode::add (d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
    #endif
 }
@@ -629,6 +973,7 @@ void JUCE_CALLTYPE FloatVectorOperations::add (float* dest, const float* src1, c
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vadd (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (add (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] + src2[i], Mode::add (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -638,6 +983,7 @@ void JUCE_CALLTYPE FloatVectorOperations::add (double* dest, const double* src1,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vaddD (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (add (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] + src2[i], Mode::add (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -647,6 +993,7 @@ void JUCE_CALLTYPE FloatVectorOperations::subtract (float* dest, const float* sr
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsub (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (subtract (dest, src, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i], Mode::sub (d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
    #endif
 }
@@ -656,6 +1003,7 @@ void JUCE_CALLTYPE FloatVectorOperations::subtract (double* dest, const double*
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsubD (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (subtract (dest, src, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] -= src[i], Mode::sub (d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
    #endif
 }
@@ -665,6 +1013,7 @@ void JUCE_CALLTYPE FloatVectorOperations::subtract (float* dest, const float* sr
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsub (src2, 1, src1, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (subtract (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] - src2[i], Mode::sub (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -674,6 +1023,7 @@ void JUCE_CALLTYPE FloatVectorOperations::subtract (double* dest, const double*
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsubD (src2, 1, src1, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (subtract (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] - src2[i], Mode::sub (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -683,6 +1033,7 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const fl
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsma (src, 1, &multiplier, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (addWithMultiply (dest, src, multiplier, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier, Mode::add (d, Mode::mul (mult, s)),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -691,6 +1042,7 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const fl
 
 void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (double* dest, const double* src, double multiplier, int num) noexcept
 {
+    JUCE_DISPATCH_TO_AVX (addWithMultiply (dest, src, multiplier, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] += src[i] * multiplier, Mode::add (d, Mode::mul (mult, s)),
                                   JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -701,6 +1053,7 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (float* dest, const fl
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vma ((float*) src1, 1, (float*) src2, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (addWithMultiply (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i], Mode::add (d, Mode::mul (s1, s2)),
                                              JUCE_LOAD_SRC1_SRC2_DEST,
                                              JUCE_INCREMENT_SRC1_SRC2_DEST, )
@@ -712,6 +1065,7 @@ void JUCE_CALLTYPE FloatVectorOperations::addWithMultiply (double* dest, const d
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmaD ((double*) src1, 1, (double*) src2, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (addWithMultiply (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST_DEST (dest[i] += src1[i] * src2[i], Mode::add (d, Mode::mul (s1, s2)),
                                              JUCE_LOAD_SRC1_SRC2_DEST,
                                              JUCE_INCREMENT_SRC1_SRC2_DEST, )
@@ -723,6 +1077,7 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, const float* sr
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmul (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (multiply (dest, src, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] *= src[i], Mode::mul (d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
    #endif
 }
@@ -732,6 +1087,7 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (double* dest, const double*
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmulD (src, 1, dest, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (multiply (dest, src, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] *= src[i], Mode::mul (d, s), JUCE_LOAD_SRC_DEST, JUCE_INCREMENT_SRC_DEST, )
    #endif
 }
@@ -741,6 +1097,7 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, const float* sr
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmul (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (multiply (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] * src2[i], Mode::mul (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -750,6 +1107,7 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (double* dest, const double*
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmulD (src1, 1, src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (multiply (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = src1[i] * src2[i], Mode::mul (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -759,6 +1117,7 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, float multiplie
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmul (dest, 1, &multiplier, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (multiply (dest, multiplier, num))
     JUCE_PERFORM_VEC_OP_DEST (dest[i] *= multiplier, Mode::mul (d, mult), JUCE_LOAD_DEST,
                               const Mode::ParallelType mult = Mode::load1 (multiplier);)
    #endif
@@ -769,6 +1128,7 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (double* dest, double multipl
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vsmulD (dest, 1, &multiplier, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (multiply (dest, multiplier, num))
     JUCE_PERFORM_VEC_OP_DEST (dest[i] *= multiplier, Mode::mul (d, mult), JUCE_LOAD_DEST,
                               const Mode::ParallelType mult = Mode::load1 (multiplier);)
    #endif
@@ -776,6 +1136,7 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (double* dest, double multipl
 
 void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, const float* src, float multiplier, int num) noexcept
 {
+    JUCE_DISPATCH_TO_AVX (multiply (dest, src, multiplier, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier, Mode::mul (mult, s),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -783,6 +1144,7 @@ void JUCE_CALLTYPE FloatVectorOperations::multiply (float* dest, const float* sr
 
 void JUCE_CALLTYPE FloatVectorOperations::multiply (double* dest, const double* src, double multiplier, int num) noexcept
 {
+    JUCE_DISPATCH_TO_AVX (multiply (dest, src, multiplier, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier, Mode::mul (mult, s),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType mult = Mode::load1 (multiplier);)
@@ -811,6 +1173,8 @@ void FloatVectorOperations::abs (float* dest, const float* src, int num) noexcep
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vabs ((float*) src, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (abs (dest, src, num))
+
     FloatVectorHelpers::signMask32 signMask;
     signMask.i = 0x7fffffffUL;
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = fabsf (src[i]), Mode::bit_and (s, mask),
@@ -826,6 +1190,8 @@ void FloatVectorOperations::abs (double* dest, const double* src, int num) noexc
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vabsD ((double*) src, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (abs (dest, src, num))
+
     FloatVectorHelpers::signMask64 signMask;
     signMask.i = 0x7fffffffffffffffULL;
 
@@ -844,6 +1210,7 @@ void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, cons
                                   vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 (src)), multiplier),
                                   JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST, )
    #else
+    JUCE_DISPATCH_TO_AVX (convertFixedToFloat (dest, src, multiplier, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = src[i] * multiplier,
                                   Mode::mul (mult, _mm_cvtepi32_ps (_mm_loadu_si128 ((const __m128i*) src))),
                                   JUCE_LOAD_NONE, JUCE_INCREMENT_SRC_DEST,
@@ -853,6 +1220,7 @@ void JUCE_CALLTYPE FloatVectorOperations::convertFixedToFloat (float* dest, cons
 
 void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src, float comp, int num) noexcept
 {
+    JUCE_DISPATCH_TO_AVX (min (dest, src, comp, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmin (src[i], comp), Mode::min (s, cmp),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType cmp = Mode::load1 (comp);)
@@ -860,6 +1228,7 @@ void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src, fl
 
 void JUCE_CALLTYPE FloatVectorOperations::min (double* dest, const double* src, double comp, int num) noexcept
 {
+    JUCE_DISPATCH_TO_AVX (min (dest, src, comp, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmin (src[i], comp), Mode::min (s, cmp),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType cmp = Mode::load1 (comp);)
@@ -870,6 +1239,7 @@ void JUCE_CALLTYPE FloatVectorOperations::min (float* dest, const float* src1, c
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmin ((float*) src1, 1, (float*) src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (min (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = jmin (src1[i], src2[i]), Mode::min (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -879,12 +1249,14 @@ void JUCE_CALLTYPE FloatVectorOperations::min (double* dest, const double* src1,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vminD ((double*) src1, 1, (double*) src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (min (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = jmin (src1[i], src2[i]), Mode::min (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
 
 void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src, float comp, int num) noexcept
 {
+    JUCE_DISPATCH_TO_AVX (max (dest, src, comp, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmax (src[i], comp), Mode::max (s, cmp),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType cmp = Mode::load1 (comp);)
@@ -892,6 +1264,7 @@ void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src, fl
 
 void JUCE_CALLTYPE FloatVectorOperations::max (double* dest, const double* src, double comp, int num) noexcept
 {
+    JUCE_DISPATCH_TO_AVX (max (dest, src, comp, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmax (src[i], comp), Mode::max (s, cmp),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType cmp = Mode::load1 (comp);)
@@ -902,6 +1275,7 @@ void JUCE_CALLTYPE FloatVectorOperations::max (float* dest, const float* src1, c
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmax ((float*) src1, 1, (float*) src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (max (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = jmax (src1[i], src2[i]), Mode::max (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -911,6 +1285,7 @@ void JUCE_CALLTYPE FloatVectorOperations::max (double* dest, const double* src1,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vmaxD ((double*) src1, 1, (double*) src2, 1, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (max (dest, src1, src2, num))
     JUCE_PERFORM_VEC_OP_SRC1_SRC2_DEST (dest[i] = jmax (src1[i], src2[i]), Mode::max (s1, s2), JUCE_LOAD_SRC1_SRC2, JUCE_INCREMENT_SRC1_SRC2_DEST, )
    #endif
 }
@@ -922,6 +1297,7 @@ void JUCE_CALLTYPE FloatVectorOperations::clip (float* dest, const float* src, f
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vclip ((float*) src, 1, &low, &high, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (clip (dest, src, low, high, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmax (jmin (src[i], high), low), Mode::max (Mode::min (s, hi), lo),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType lo = Mode::load1 (low); const Mode::ParallelType hi = Mode::load1 (high);)
@@ -935,6 +1311,7 @@ void JUCE_CALLTYPE FloatVectorOperations::clip (double* dest, const double* src,
    #if JUCE_USE_VDSP_FRAMEWORK
     vDSP_vclipD ((double*) src, 1, &low, &high, dest, 1, (vDSP_Length) num);
    #else
+    JUCE_DISPATCH_TO_AVX (clip (dest, src, low, high, num))
     JUCE_PERFORM_VEC_OP_SRC_DEST (dest[i] = jmax (jmin (src[i], high), low), Mode::max (Mode::min (s, hi), lo),
                                   JUCE_LOAD_SRC, JUCE_INCREMENT_SRC_DEST,
                                   const Mode::ParallelType lo = Mode::load1 (low); const Mode::ParallelType hi = Mode::load1 (high);)
@@ -944,6 +1321,7 @@ void JUCE_CALLTYPE FloatVectorOperations::clip (double* dest, const double* src,
 Range<float> JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* src, int num) noexcept
 {
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    JUCE_DISPATCH_TO_AVX (findMinAndMax (src, num))
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinAndMax (src, num);
    #else
     return Range<float>::findMinAndMax (src, num);
@@ -953,6 +1331,7 @@ Range<float> JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const float* sr
 Range<double> JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const double* src, int num) noexcept
 {
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    JUCE_DISPATCH_TO_AVX (findMinAndMax (src, num))
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinAndMax (src, num);
    #else
     return Range<double>::findMinAndMax (src, num);
@@ -962,6 +1341,7 @@ Range<double> JUCE_CALLTYPE FloatVectorOperations::findMinAndMax (const double*
 float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int num) noexcept
 {
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    JUCE_DISPATCH_TO_AVX (findMinOrMax (src, num, true))
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinOrMax (src, num, true);
    #else
     return juce::findMinimum (src, num);
@@ -971,6 +1351,7 @@ float JUCE_CALLTYPE FloatVectorOperations::findMinimum (const float* src, int nu
 double JUCE_CALLTYPE FloatVectorOperations::findMinimum (const double* src, int num) noexcept
 {
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    JUCE_DISPATCH_TO_AVX (findMinOrMax (src, num, true))
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinOrMax (src, num, true);
    #else
     return juce::findMinimum (src, num);
@@ -980,6 +1361,7 @@ double JUCE_CALLTYPE FloatVectorOperations::findMinimum (const double* src, int
 float JUCE_CALLTYPE FloatVectorOperations::findMaximum (const float* src, int num) noexcept
 {
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    JUCE_DISPATCH_TO_AVX (findMinOrMax (src, num, false))
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps32>::findMinOrMax (src, num, false);
    #else
     return juce::findMaximum (src, num);
@@ -989,6 +1371,7 @@ float JUCE_CALLTYPE FloatVectorOperations::findMaximum (const float* src, int nu
 double JUCE_CALLTYPE FloatVectorOperations::findMaximum (const double* src, int num) noexcept
 {
    #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+    JUCE_DISPATCH_TO_AVX (findMinOrMax (src, num, false))
     return FloatVectorHelpers::MinMax<FloatVectorHelpers::BasicOps64>::findMinOrMax (src, num, false);
    #else
     return juce::findMaximum (src, num);
@@ -1153,6 +1536,243 @@ public:
         }
     };
 
+   #if JUCE_USE_AVX_INTRINSICS
+    template <typename ValueType>
+    struct ReferenceComparison
+    {
+        static void runTest (UnitTest& u, Random random)
+        {
+            const int num = random.nextInt (600) + 1;
+
+            HeapBlock<ValueType> buffer1 ((size_t) num + 16), buffer2 ((size_t) num + 16), buffer3 ((size_t) num + 16);
+            HeapBlock<int> intBuffer ((size_t) num + 16);
+
+            ValueType* const src1 = addBytesToPointer (buffer1.getData(), random.nextInt (16));
+            ValueType* const src2 = addBytesToPointer (buffer2.getData(), random.nextInt (16));
+            ValueType* const dest = addBytesToPointer (buffer3.getData(), random.nextInt (16));
+            int* const ints = addBytesToPointer (intBuffer.getData(), random.nextInt (16));
+
+            for (int i = 0; i < num; ++i)
+            {
+                src1[i] = (ValueType) (random.nextDouble() * 2000.0 - 1000.0);
+                src2[i] = (ValueType) (random.nextDouble() * 2000.0 - 1000.0);
+                ints[i] = random.nextInt();
+            }
+
+            Array<ValueType> results, expected;
+            runAllOperations (results, dest, src1, src2, ints, num);
+            runReferenceOperations (expected, dest, src1, src2, ints, num);
+
+            u.expectEquals (results.size(), expected.size());
+
+            ValueType scale = 1;
+
+            for (int i = 0; i < results.size(); ++i)
+            {
+                const ValueType a = results.getUnchecked (i), b = expected.getUnchecked (i);
+
+                // FMA rounds once rather than twice, so allow a tiny error relative to the size of the
+                // values that each operation produced - if a multiply-add cancels out, the result can be
+                // tiny while still carrying the rounding error of the much larger product.
+                if (i % num == 0)
+                {
+                    scale = 1;
+
+                    for (int j = i; j < jmin (i + num, expected.size()); ++j)
+                        scale = jmax (scale, std::abs (expected.getUnchecked (j)));
+                }
+
+                if (std::abs (a - b) > scale * std::numeric_limits<ValueType>::epsilon() * 4)
+                {
+                    u.expect (false, "Result mismatch at index " + String (i) + " with length " + String (num));
+                    break;
+                }
+            }
+        }
+
+        static void append (Array<ValueType>& results, const ValueType* d, int num)
+        {
+            results.addArray (d, num);
+        }
+
+        static void runAllOperations (Array<ValueType>& results, ValueType* dest,
+                                      const ValueType* src1, const ValueType* src2, const int* ints, int num)
+        {
+            typedef FloatVectorOperations FVO;
+
+            FVO::fill (dest, (ValueType) 3, num);                           append (results, dest, num);
+            FVO::copyWithMultiply (dest, src1, (ValueType) 1.5, num);       append (results, dest, num);
+            FVO::add (dest, (ValueType) 7, num);                            append (results, dest, num);
+            FVO::add (dest, src1, (ValueType) 3, num);                      append (results, dest, num);
+            FVO::add (dest, src2, num);                                     append (results, dest, num);
+            FVO::add (dest, src1, src2, num);                               append (results, dest, num);
+            FVO::subtract (dest, src1, num);                                append (results, dest, num);
+            FVO::subtract (dest, src1, src2, num);                          append (results, dest, num);
+            FVO::addWithMultiply (dest, src1, (ValueType) 0.25, num);       append (results, dest, num);
+            FVO::addWithMultiply (dest, src1, src2, num);                   append (results, dest, num);
+            FVO::multiply (dest, (ValueType) 0.5, num);                     append (results, dest, num);
+            FVO::multiply (dest, src1, num);                                append (results, dest, num);
+            FVO::multiply (dest, src1, src2, num);                          append (results, dest, num);
+            FVO::multiply (dest, src2, (ValueType) -2, num);                append (results, dest, num);
+            FVO::negate (dest, src1, num);                                  append (results, dest, num);
+            FVO::abs (dest, src2, num);                                     append (results, dest, num);
+            FVO::min (dest, src1, (ValueType) 10, num);                     append (results, dest, num);
+            FVO::min (dest, src1, src2, num);                               append (results, dest, num);
+            FVO::max (dest, src2, (ValueType) -10, num);                    append (results, dest, num);
+            FVO::max (dest, src1, src2, num);                               append (results, dest, num);
+            FVO::clip (dest, src1, (ValueType) -100, (ValueType) 250, num); append (results, dest, num);
+
+            const Range<ValueType> range (FVO::findMinAndMax (src1, num));
+            results.add (range.getStart());
+            results.add (range.getEnd());
+            results.add (FVO::findMinimum (src2, num));
+            results.add (FVO::findMaximum (src2, num));
+
+            convertFixed (results, dest, ints, num);
+        }
+
+        static void convertFixed (Array<float>& results, float* dest, const int* ints, int num)
+        {
+            FloatVectorOperations::convertFixedToFloat (dest, ints, 1.0f / 0x7fffffff, num);
+            append (results, dest, num);
+        }
+
+        static void convertFixed (Array<double>&, double*, const int*, int) {}
+
+        // Plain loops which perform the same sequence of operations as runAllOperations()
+        static void runReferenceOperations (Array<ValueType>& results, ValueType* dest,
+                                            const ValueType* src1, const ValueType* src2, const int* ints, int num)
+        {
+            for (int i = 0; i < num; ++i)  dest[i] = (ValueType) 3;
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = src1[i] * (ValueType) 1.5;
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] += (ValueType) 7;
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = src1[i] + (ValueType) 3;
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] += src2[i];
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = src1[i] + src2[i];
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] -= src1[i];
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = src1[i] - src2[i];
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] += src1[i] * (ValueType) 0.25;
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] += src1[i] * src2[i];
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] *= (ValueType) 0.5;
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] *= src1[i];
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = src1[i] * src2[i];
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = src2[i] * (ValueType) -2;
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = -src1[i];
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = std::abs (src2[i]);
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = jmin (src1[i], (ValueType) 10);
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = jmin (src1[i], src2[i]);
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = jmax (src2[i], (ValueType) -10);
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = jmax (src1[i], src2[i]);
+            append (results, dest, num);
+
+            for (int i = 0; i < num; ++i)  dest[i] = jlimit ((ValueType) -100, (ValueType) 250, src1[i]);
+            append (results, dest, num);
+
+            ValueType lowest = src1[0], highest = src1[0], lowest2 = src2[0], highest2 = src2[0];
+
+            for (int i = 1; i < num; ++i)
+            {
+                lowest   = jmin (lowest, src1[i]);
+                highest  = jmax (highest, src1[i]);
+                lowest2  = jmin (lowest2, src2[i]);
+                highest2 = jmax (highest2, src2[i]);
+            }
+
+            results.add (lowest);
+            results.add (highest);
+            results.add (lowest2);
+            results.add (highest2);
+
+            convertFixedReference (results, dest, ints, num);
+        }
+
+        static void convertFixedReference (Array<float>& results, float* dest, const int* ints, int num)
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i] = ints[i] * (1.0f / 0x7fffffff);
+
+            append (results, dest, num);
+        }
+
+        static void convertFixedReference (Array<double>&, double*, const int*, int) {}
+    };
+
+    template <typename ValueType>
+    static double timeMixingLoop (ValueType* dest, const ValueType* src, int num, bool useScalarLoops)
+    {
+        const double startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            if (useScalarLoops)
+            {
+                for (int j = 0; j < num; ++j)   dest[j] *= (ValueType) 0.999;
+                for (int j = 0; j < num; ++j)   dest[j] += src[j] * (ValueType) 0.001;
+            }
+            else
+            {
+                FloatVectorOperations::multiply (dest, (ValueType) 0.999, num);
+                FloatVectorOperations::addWithMultiply (dest, src, (ValueType) 0.001, num);
+            }
+        }
+
+        return Time::getMillisecondCounterHiRes() - startTime;
+    }
+
+    template <typename ValueType>
+    void logMixingSpeedUp (const char* typeName)
+    {
+        const int num = 4096;
+        HeapBlock<ValueType> dest ((size_t) num, true), src ((size_t) num, true);
+        FloatVectorOperations::fill (src.getData(), (ValueType) 0.5, num);
+
+        const double scalarTime = timeMixingLoop (dest.getData(), src.getData(), num, true);
+        const double vectorTime = timeMixingLoop (dest.getData(), src.getData(), num, false);
+
+        logMessage (String (typeName) + " gain + mix: " + String (scalarTime, 2) + "ms with plain loops, "
+                      + String (vectorTime, 2) + "ms with FloatVectorOperations" + (FloatVectorHelpers::AVX::isEnabled ? " (AVX)" : "")
+                      + " (x" + String (scalarTime / jmax (0.001, vectorTime), 2) + ")");
+    }
+   #endif
+
     void runTest() override
     {
         beginTest ("FloatVectorOperations");
@@ -1162,6 +1782,20 @@ public:
             TestRunner<float>::runTest (*this, getRandom());
             TestRunner<double>::runTest (*this, getRandom());
         }
+
+       #if JUCE_USE_AVX_INTRINSICS
+        beginTest (FloatVectorHelpers::AVX::isEnabled ? "AVX against a scalar reference" : "SSE against a scalar reference");
+
+        for (int i = 200; --i >= 0;)
+        {
+            ReferenceComparison<float>::runTest (*this, getRandom());
+            ReferenceComparison<double>::runTest (*this, getRandom());
+        }
+
+        beginTest ("Performance");
+        logMixingSpeedUp<float> ("float");
+        logMixingSpeedUp<double> ("double");
+       #endif
     }
 };
 
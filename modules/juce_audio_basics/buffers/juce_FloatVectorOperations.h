@@ -30,6 +30,9 @@
 /**
     A collection of simple vector operations on arrays of floats, accelerated with
     SIMD instructions where possible.
+
+    On Intel CPUs which support AVX2 and FMA3, 256-bit versions of the operations
+    are selected automatically at runtime; otherwise SSE2, NEON or plain C++ is used.
 */
 class JUCE_API  FloatVectorOperations
 {
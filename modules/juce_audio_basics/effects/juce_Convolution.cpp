@@ -0,0 +1,760 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace ConvolutionHelpers
+{
+    // Adds the product of two sets of complex bins (stored as interleaved real/imag pairs) to a third
+    static void multiplyAccumulate (float* dest, const float* a, const float* b, int numBins) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        const __m128 signs = _mm_setr_ps (-1.0f, 1.0f, -1.0f, 1.0f);
+
+        for (; numBins >= 2; numBins -= 2)
+        {
+            const __m128 x = _mm_loadu_ps (a);
+            const __m128 y = _mm_loadu_ps (b);
+
+            const __m128 re = _mm_mul_ps (x, _mm_shuffle_ps (y, y, _MM_SHUFFLE (2, 2, 0, 0)));
+            const __m128 im = _mm_mul_ps (_mm_mul_ps (_mm_shuffle_ps (x, x, _MM_SHUFFLE (2, 3, 0, 1)),
+                                                      _mm_shuffle_ps (y, y, _MM_SHUFFLE (3, 3, 1, 1))), signs);
+
+            _mm_storeu_ps (dest, _mm_add_ps (_mm_loadu_ps (dest), _mm_add_ps (re, im)));
+            dest += 4;
+            a += 4;
+            b += 4;
+        }
+       #endif
+
+        for (; numBins > 0; --numBins)
+        {
+            dest[0] += a[0] * b[0] - a[1] * b[1];
+            dest[1] += a[0] * b[1] + a[1] * b[0];
+            dest += 2;
+            a += 2;
+            b += 2;
+        }
+    }
+
+    //==============================================================================
+    /*  The frequency-domain partitions of one section of one channel of an impulse response.
+
+        A section with a given blockSize and delayBlocks covers the taps from
+        (blockSize * delayBlocks) onwards, in partitions of blockSize taps. Each one is
+        zero-padded to 2 * blockSize and transformed, and only the non-redundant half of
+        its spectrum (blockSize + 1 bins) is kept.
+    */
+    struct PartitionedSection
+    {
+        PartitionedSection (const FFT& forwardFFT, const float* taps, int numTaps,
+                            int sectionBlockSize, int sectionDelayBlocks, int maxNumTaps)
+            : blockSize (sectionBlockSize), delayBlocks (sectionDelayBlocks),
+              numBinFloats ((sectionBlockSize + 1) * 2)
+        {
+            const int start = blockSize * delayBlocks;
+            numPartitions = (maxNumTaps - start + blockSize - 1) / blockSize;
+            jassert (numPartitions > 0);
+
+            spectra.calloc ((size_t) (numPartitions * numBinFloats));
+            HeapBlock<float> scratch ((size_t) blockSize * 4);
+
+            for (int i = 0; i < numPartitions; ++i)
+            {
+                const int first = start + i * blockSize;
+                const int num = jlimit (0, blockSize, numTaps - first);
+
+                FloatVectorOperations::clear (scratch, blockSize * 4);
+
+                if (num > 0)
+                    FloatVectorOperations::copy (scratch, taps + first, num);
+
+                forwardFFT.performRealOnlyForwardTransform (scratch);
+                FloatVectorOperations::copy (spectra + i * numBinFloats, scratch, numBinFloats);
+            }
+        }
+
+        const int blockSize, delayBlocks, numBinFloats;
+        int numPartitions;
+        HeapBlock<float> spectra;
+
+        JUCE_DECLARE_NON_COPYABLE (PartitionedSection)
+    };
+
+    //==============================================================================
+    /*  Convolves one channel of audio with a PartitionedSection, using uniformly
+        partitioned overlap-save.
+
+        Input arrives in blocks of blockSize samples. When a block is complete, the spectrum
+        of the last two blocks goes into a frequency-domain delay line, and the output for
+        block (k + delayBlocks) is the inverse transform of the sum of each partition's
+        spectrum multiplied by the spectrum from that many blocks earlier.
+
+        tick() must be called every time numSlices sub-blocks have gone past, i.e. every
+        (blockSize / numSlices) samples. If delayBlocks is 1, all the work is done at the
+        end of each block; if it's 2, the output isn't needed until a block later, so the
+        work is spread across the numSlices ticks of the following block.
+    */
+    struct SectionConvolver
+    {
+        SectionConvolver (const PartitionedSection& s, const FFT& forward, const FFT& inverse, int slices)
+            : section (s), forwardFFT (forward), inverseFFT (inverse),
+              blockSize (s.blockSize), numSlices (s.delayBlocks > 1 ? slices : 1),
+              window ((size_t) blockSize * 2),
+              delayLine ((size_t) (s.numPartitions * s.numBinFloats)),
+              accumulator ((size_t) s.numBinFloats),
+              outputs ((size_t) blockSize * 2)
+        {
+            jassert (s.delayBlocks == 1 || s.delayBlocks == 2);
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            FloatVectorOperations::clear (window, blockSize * 2);
+            FloatVectorOperations::clear (delayLine, section.numPartitions * section.numBinFloats);
+            FloatVectorOperations::clear (accumulator, section.numBinFloats);
+            FloatVectorOperations::clear (outputs, blockSize * 2);
+
+            currentOutput = outputs;
+            nextOutput = outputs + blockSize;
+            position = 0;
+            delayLineIndex = 0;
+            sliceIndex = numSlices;
+        }
+
+        // Takes some input, and adds the corresponding output to the destination
+        void process (const float* input, float* output, int num) noexcept
+        {
+            jassert (position + num <= blockSize);
+
+            FloatVectorOperations::copy (window + blockSize + position, input, num);
+            FloatVectorOperations::add (output, currentOutput + position, num);
+            position += num;
+        }
+
+        void tick (float* scratch) noexcept
+        {
+            if (position == blockSize)
+                startNextBlock (scratch);
+
+            if (sliceIndex < numSlices)
+                performSlice (scratch);
+        }
+
+    private:
+        const PartitionedSection& section;
+        const FFT& forwardFFT;
+        const FFT& inverseFFT;
+        const int blockSize, numSlices;
+
+        HeapBlock<float> window, delayLine, accumulator, outputs;
+        float* currentOutput;
+        float* nextOutput;
+        int position, delayLineIndex, sliceIndex;
+
+        void startNextBlock (float* scratch) noexcept
+        {
+            if (section.delayBlocks > 1)
+                std::swap (currentOutput, nextOutput);
+
+            delayLineIndex = (delayLineIndex + 1) % section.numPartitions;
+
+            FloatVectorOperations::copy (scratch, window, blockSize * 2);
+            FloatVectorOperations::clear (scratch + blockSize * 2, blockSize * 2);
+            forwardFFT.performRealOnlyForwardTransform (scratch);
+
+            FloatVectorOperations::copy (delayLine + delayLineIndex * section.numBinFloats, scratch, section.numBinFloats);
+            FloatVectorOperations::copy (window, window + blockSize, blockSize);
+            FloatVectorOperations::clear (accumulator, section.numBinFloats);
+
+            position = 0;
+            sliceIndex = 0;
+        }
+
+        void performSlice (float* scratch) noexcept
+        {
+            const int numPartitions = section.numPartitions;
+            const int numBinFloats = section.numBinFloats;
+            const int first = (sliceIndex * numPartitions) / numSlices;
+            const int last = ((sliceIndex + 1) * numPartitions) / numSlices;
+
+            for (int i = first; i < last; ++i)
+            {
+                const int index = (delayLineIndex - i + numPartitions) % numPartitions;
+
+                multiplyAccumulate (accumulator, delayLine + index * numBinFloats,
+                                    section.spectra + i * numBinFloats, blockSize + 1);
+            }
+
+            if (++sliceIndex == numSlices)
+            {
+                // (only the lower half of the spectrum is accumulated, which is all the symmetric inverse needs)
+                FloatVectorOperations::copy (scratch, accumulator, numBinFloats);
+                inverseFFT.performSymmetricInverseTransform (scratch);
+                FloatVectorOperations::copy (nextOutput, scratch + blockSize, blockSize);
+
+                if (section.delayBlocks == 1)
+                    std::swap (currentOutput, nextOutput);
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (SectionConvolver)
+    };
+
+    static int getOrder (int powerOfTwo) noexcept
+    {
+        int order = 0;
+
+        while ((1 << order) < powerOfTwo)
+            ++order;
+
+        return order;
+    }
+}
+
+//==============================================================================
+struct Convolution::Engine
+{
+    Engine (const AudioBuffer<float>& ir, int numChannelsToProcess, int head, int tailBlock)
+        : headSize (head),
+          headFFT (ConvolutionHelpers::getOrder (head * 2), false),
+          headInverseFFT (ConvolutionHelpers::getOrder (head * 2), true),
+          tailFFT (ConvolutionHelpers::getOrder (tailBlock * 2), false),
+          tailInverseFFT (ConvolutionHelpers::getOrder (tailBlock * 2), true),
+          scratch ((size_t) jmax (head, tailBlock) * 4)
+    {
+        using namespace ConvolutionHelpers;
+
+        const int irLength = ir.getNumSamples();
+        const int numIRChannels = jmax (1, ir.getNumChannels());
+        const bool usesTailSections = tailBlock > head;
+        const int headSectionEnd = usesTailSections ? jmin (irLength, tailBlock * 2) : irLength;
+
+        for (int i = 0; i < numIRChannels; ++i)
+        {
+            const float* const taps = ir.getNumChannels() > 0 ? ir.getReadPointer (i) : nullptr;
+            IRChannel* const irChannel = irChannels.add (new IRChannel());
+
+            irChannel->numHeadTaps = jmin (irLength, head);
+            irChannel->headTaps.calloc ((size_t) head);
+
+            if (irChannel->numHeadTaps > 0)
+                FloatVectorOperations::copy (irChannel->headTaps, taps, irChannel->numHeadTaps);
+
+            if (headSectionEnd > head)
+                irChannel->sections.add (new PartitionedSection (headFFT, taps, headSectionEnd, head, 1, headSectionEnd));
+
+            if (usesTailSections && irLength > tailBlock * 2)
+                irChannel->sections.add (new PartitionedSection (tailFFT, taps, irLength, tailBlock, 2, irLength));
+        }
+
+        for (int i = 0; i < numChannelsToProcess; ++i)
+        {
+            const IRChannel& irChannel = *irChannels.getUnchecked (i % numIRChannels);
+            ChannelProcessor* const processor = channels.add (new ChannelProcessor (irChannel, head));
+
+            for (int j = 0; j < irChannel.sections.size(); ++j)
+            {
+                const PartitionedSection& section = *irChannel.sections.getUnchecked (j);
+                const bool isHead = section.blockSize == head;
+
+                processor->sectionConvolvers.add (new SectionConvolver (section,
+                                                                        isHead ? headFFT : tailFFT,
+                                                                        isHead ? headInverseFFT : tailInverseFFT,
+                                                                        section.blockSize / head));
+            }
+        }
+    }
+
+    void reset() noexcept
+    {
+        for (int i = channels.size(); --i >= 0;)
+            channels.getUnchecked (i)->reset();
+    }
+
+    void process (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+    {
+        const int num = jmin (channels.size(), buffer.getNumChannels());
+
+        for (int i = 0; i < num; ++i)
+            channels.getUnchecked (i)->process (buffer.getWritePointer (i, startSample), numSamples, scratch);
+    }
+
+private:
+    struct IRChannel
+    {
+        HeapBlock<float> headTaps;
+        int numHeadTaps;
+        OwnedArray<ConvolutionHelpers::PartitionedSection> sections;
+    };
+
+    // Applies the head taps directly, and runs the sections' convolvers in step with it
+    struct ChannelProcessor
+    {
+        ChannelProcessor (const IRChannel& ir, int head)
+            : irChannel (ir), headSize (head), history ((size_t) head * 2)
+        {
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            FloatVectorOperations::clear (history, headSize * 2);
+            position = 0;
+
+            for (int i = sectionConvolvers.size(); --i >= 0;)
+                sectionConvolvers.getUnchecked (i)->reset();
+        }
+
+        void process (float* samples, int numSamples, float* scratch) noexcept
+        {
+            while (numSamples > 0)
+            {
+                const int num = jmin (numSamples, headSize - position);
+
+                // history holds the previous (headSize - 1) samples, followed by the current block
+                float* const input = history + headSize - 1 + position;
+                FloatVectorOperations::copy (input, samples, num);
+                FloatVectorOperations::clear (samples, num);
+
+                for (int i = 0; i < sectionConvolvers.size(); ++i)
+                    sectionConvolvers.getUnchecked (i)->process (input, samples, num);
+
+                for (int i = 0; i < irChannel.numHeadTaps; ++i)
+                    FloatVectorOperations::addWithMultiply (samples, input - i, irChannel.headTaps[i], num);
+
+                samples += num;
+                numSamples -= num;
+                position += num;
+
+                if (position == headSize)
+                {
+                    for (int i = 0; i < sectionConvolvers.size(); ++i)
+                        sectionConvolvers.getUnchecked (i)->tick (scratch);
+
+                    memmove (history, history + headSize, sizeof (float) * (size_t) (headSize - 1));
+                    position = 0;
+                }
+            }
+        }
+
+        const IRChannel& irChannel;
+        const int headSize;
+        HeapBlock<float> history;
+        int position;
+        OwnedArray<ConvolutionHelpers::SectionConvolver> sectionConvolvers;
+
+        JUCE_DECLARE_NON_COPYABLE (ChannelProcessor)
+    };
+
+    const int headSize;
+    FFT headFFT, headInverseFFT, tailFFT, tailInverseFFT;
+    HeapBlock<float> scratch;
+    OwnedArray<IRChannel> irChannels;
+    OwnedArray<ChannelProcessor> channels;
+
+    JUCE_DECLARE_NON_COPYABLE (Engine)
+};
+
+//==============================================================================
+struct Convolution::LoaderThread  : public Thread
+{
+    LoaderThread (Convolution& c)  : Thread ("Convolution loader"), owner (c)
+    {
+        startThread (4);
+    }
+
+    ~LoaderThread()
+    {
+        stopThread (10000);
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            owner.buildPendingEngine();
+            owner.deleteRetiredEngine();
+            wait (500);
+        }
+    }
+
+    Convolution& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (LoaderThread)
+};
+
+//==============================================================================
+Convolution::Convolution()
+    : numChannels (2), headSize (64), tailBlockSize (1024),
+      hasImpulseResponse (false), needsRebuild (false), rebuildInBackground (false),
+      isLoading (false)
+{
+}
+
+Convolution::~Convolution()
+{
+    loaderThread = nullptr;
+}
+
+void Convolution::setPartitionSizes (int newHeadSize, int newTailBlockSize)
+{
+    // The sizes must be powers of two, and the tail can't use smaller blocks than the head
+    jassert (isPowerOfTwo (newHeadSize) && isPowerOfTwo (newTailBlockSize));
+    jassert (newTailBlockSize >= newHeadSize && newHeadSize > 1);
+
+    bool mustBuildNow = false;
+
+    {
+        const ScopedLock sl (requestLock);
+
+        if (headSize != newHeadSize || tailBlockSize != newTailBlockSize)
+        {
+            headSize = newHeadSize;
+            tailBlockSize = jmax (newHeadSize, newTailBlockSize);
+
+            if (hasImpulseResponse)
+            {
+                requestRebuild (rebuildInBackground);
+                mustBuildNow = ! rebuildInBackground;
+            }
+        }
+    }
+
+    if (mustBuildNow)
+        buildPendingEngine();
+}
+
+void Convolution::setNumChannels (int newNumChannels)
+{
+    jassert (newNumChannels > 0);
+
+    bool mustBuildNow = false;
+
+    {
+        const ScopedLock sl (requestLock);
+
+        if (numChannels != newNumChannels)
+        {
+            numChannels = newNumChannels;
+
+            if (hasImpulseResponse)
+            {
+                requestRebuild (rebuildInBackground);
+                mustBuildNow = ! rebuildInBackground;
+            }
+        }
+    }
+
+    if (mustBuildNow)
+        buildPendingEngine();
+}
+
+void Convolution::loadImpulseResponse (const AudioBuffer<float>& newImpulseResponse, bool loadInBackground)
+{
+    {
+        const ScopedLock sl (requestLock);
+        impulseResponse.makeCopyOf (newImpulseResponse);
+        hasImpulseResponse = true;
+        requestRebuild (loadInBackground);
+    }
+
+    if (! loadInBackground)
+        buildPendingEngine();
+}
+
+bool Convolution::isLoadingImpulseResponse() const noexcept
+{
+    return isLoading;
+}
+
+int Convolution::getImpulseResponseLength() const noexcept
+{
+    const ScopedLock sl (requestLock);
+    return impulseResponse.getNumSamples();
+}
+
+void Convolution::requestRebuild (bool inBackground)
+{
+    needsRebuild = true;
+    rebuildInBackground = inBackground;
+
+    if (inBackground)
+    {
+        isLoading = true;
+
+        if (loaderThread == nullptr)
+            loaderThread = new LoaderThread (*this);
+
+        loaderThread->notify();
+    }
+}
+
+void Convolution::buildPendingEngine()
+{
+    const ScopedLock buildScope (buildLock);
+    deleteRetiredEngine();
+
+    ScopedPointer<Engine> engine;
+
+    {
+        AudioBuffer<float> ir;
+        int channels, head, tail;
+
+        {
+            const ScopedLock sl (requestLock);
+
+            if (! needsRebuild)
+                return;
+
+            needsRebuild = false;
+            ir.makeCopyOf (impulseResponse);
+            channels = numChannels;
+            head = headSize;
+            tail = tailBlockSize;
+        }
+
+        engine = new Engine (ir, channels, head, tail);
+    }
+
+    ScopedPointer<Engine> staleEngine;
+
+    {
+        const SpinLock::ScopedLockType sl (engineLock);
+        staleEngine = newEngine.release();
+        newEngine = engine.release();
+    }
+
+    const ScopedLock sl (requestLock);
+
+    if (! needsRebuild)
+        isLoading = false;
+}
+
+void Convolution::deleteRetiredEngine()
+{
+    ScopedPointer<Engine> engineToDelete;
+
+    const SpinLock::ScopedLockType sl (engineLock);
+    engineToDelete = retiredEngine.release();
+}
+
+void Convolution::reset() noexcept
+{
+    if (activeEngine != nullptr)
+        activeEngine->reset();
+}
+
+void Convolution::process (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    {
+        // If the loader is busy handing over an engine, we'll just pick it up next time
+        const GenericScopedTryLock<SpinLock> sl (engineLock);
+
+        if (sl.isLocked() && newEngine != nullptr && retiredEngine == nullptr)
+        {
+            retiredEngine = activeEngine.release();
+            activeEngine = newEngine.release();
+        }
+    }
+
+    if (activeEngine != nullptr)
+        activeEngine->process (buffer, startSample, numSamples);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ConvolutionTests  : public UnitTest
+{
+public:
+    ConvolutionTests() : UnitTest ("Convolution") {}
+
+    static void fillRandomly (Random& r, AudioBuffer<float>& buffer)
+    {
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+            for (int j = 0; j < buffer.getNumSamples(); ++j)
+                buffer.setSample (i, j, r.nextFloat() * 2.0f - 1.0f);
+    }
+
+    static AudioBuffer<float> createImpulseResponse (Random& r, int numChannels, int length)
+    {
+        AudioBuffer<float> ir (numChannels, length);
+        fillRandomly (r, ir);
+
+        for (int i = 0; i < numChannels; ++i)
+            ir.applyGainRamp (i, 0, length, 1.0f, 0.1f);
+
+        return ir;
+    }
+
+    // Processes the input in randomly-sized blocks, and compares it with a direct convolution
+    void checkAgainstDirectConvolution (Convolution& convolution, const AudioBuffer<float>& ir,
+                                        int numChannels, int numSamples, int maxBlockSize)
+    {
+        Random r (getRandom());
+        AudioBuffer<float> input (numChannels, numSamples);
+        fillRandomly (r, input);
+
+        AudioBuffer<float> output;
+        output.makeCopyOf (input);
+
+        for (int pos = 0; pos < numSamples;)
+        {
+            const int num = jmin (numSamples - pos, 1 + r.nextInt (maxBlockSize));
+            convolution.process (output, pos, num);
+            pos += num;
+        }
+
+        double maxError = 0, maxLevel = 0;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const float* const taps = ir.getReadPointer (channel % ir.getNumChannels());
+            const float* const in = input.getReadPointer (channel);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                double expected = 0;
+
+                for (int j = jmin (i, ir.getNumSamples() - 1); j >= 0; --j)
+                    expected += (double) taps[j] * in[i - j];
+
+                maxError = jmax (maxError, std::abs (expected - output.getSample (channel, i)));
+                maxLevel = jmax (maxLevel, std::abs (expected));
+            }
+        }
+
+        expect (maxError < 1.0e-5 * jmax (1.0, maxLevel), "IR length " + String (ir.getNumSamples())
+                  + ": error " + String (maxError) + " at level " + String (maxLevel));
+    }
+
+    void runTest() override
+    {
+        Random r (getRandom());
+
+        beginTest ("Uniform partitions");
+
+        for (int i = 0; i < 10; ++i)
+        {
+            const int headSize = 1 << (2 + r.nextInt (5));
+            const AudioBuffer<float> ir (createImpulseResponse (r, 1 + r.nextInt (2), 1 + r.nextInt (2000)));
+
+            Convolution convolution;
+            convolution.setPartitionSizes (headSize, headSize);
+            convolution.setNumChannels (2);
+            convolution.loadImpulseResponse (ir, false);
+
+            checkAgainstDirectConvolution (convolution, ir, 2, 5000, 300);
+        }
+
+        beginTest ("Non-uniform partitions");
+
+        for (int i = 0; i < 10; ++i)
+        {
+            const int headSize = 1 << (2 + r.nextInt (4));
+            const int tailBlockSize = headSize << (1 + r.nextInt (4));
+            const AudioBuffer<float> ir (createImpulseResponse (r, 1, 1 + r.nextInt (4000)));
+
+            Convolution convolution;
+            convolution.setPartitionSizes (headSize, tailBlockSize);
+            convolution.setNumChannels (1);
+            convolution.loadImpulseResponse (ir, false);
+
+            checkAgainstDirectConvolution (convolution, ir, 1, 8000, 1000);
+        }
+
+        beginTest ("Zero latency");
+        {
+            const AudioBuffer<float> ir (createImpulseResponse (r, 1, 3000));
+
+            Convolution convolution;
+            convolution.setNumChannels (1);
+            convolution.loadImpulseResponse (ir, false);
+
+            AudioBuffer<float> buffer (1, 4096);
+            buffer.clear();
+            buffer.setSample (0, 0, 1.0f);
+            convolution.process (buffer, 0, 4096);
+
+            float maxError = 0;
+
+            for (int i = 0; i < 4096; ++i)
+                maxError = jmax (maxError, std::abs (buffer.getSample (0, i) - (i < 3000 ? ir.getSample (0, i) : 0.0f)));
+
+            expect (maxError < 1.0e-5f);
+        }
+
+        beginTest ("Changing the layout after a synchronous load");
+        {
+            const AudioBuffer<float> ir (createImpulseResponse (r, 2, 3000));
+
+            Convolution convolution;
+            convolution.setNumChannels (1);
+            convolution.loadImpulseResponse (ir, false);
+
+            convolution.setPartitionSizes (16, 128);
+            expect (! convolution.isLoadingImpulseResponse());
+            checkAgainstDirectConvolution (convolution, ir, 1, 5000, 300);
+
+            // the second channel is only convolved if the engine has been rebuilt for it
+            convolution.setNumChannels (2);
+            expect (! convolution.isLoadingImpulseResponse());
+            checkAgainstDirectConvolution (convolution, ir, 2, 5000, 300);
+        }
+
+        beginTest ("Background loading");
+        {
+            Convolution convolution;
+            convolution.setNumChannels (1);
+
+            AudioBuffer<float> buffer (1, 256);
+            const AudioBuffer<float> firstIR (createImpulseResponse (r, 1, 500));
+            const AudioBuffer<float> secondIR (createImpulseResponse (r, 1, 20000));
+
+            convolution.loadImpulseResponse (firstIR, false);
+            convolution.loadImpulseResponse (secondIR, true);
+
+            for (int i = 0; i < 1000 && convolution.isLoadingImpulseResponse(); ++i)
+            {
+                fillRandomly (r, buffer);
+                convolution.process (buffer, 0, buffer.getNumSamples());
+                Thread::sleep (10);
+            }
+
+            expect (! convolution.isLoadingImpulseResponse());
+            expectEquals (convolution.getImpulseResponseLength(), 20000);
+
+            // the next block picks up the new engine, so its output starts from silence
+            convolution.process (buffer, 0, buffer.getNumSamples());
+            convolution.reset();
+            checkAgainstDirectConvolution (convolution, secondIR, 1, 30000, 512);
+        }
+    }
+};
+
+static ConvolutionTests convolutionUnitTests;
+
+#endif
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_CONVOLUTION_H_INCLUDED
+#define JUCE_CONVOLUTION_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Convolves a stream of audio with an impulse response, using partitioned FFTs.
+
+    The first few taps of the impulse response are applied directly in the time domain,
+    so the result has no latency, and the rest is done by overlap-save convolution with
+    uniformly-sized partitions. For long impulse responses, the later part can use a
+    second, larger partition size, whose work is spread out over several blocks, so the
+    amount of CPU needed per block of audio stays roughly constant.
+
+    Once an impulse response has been loaded, process() doesn't allocate any memory or
+    take any locks that could block, so it can be called from the audio thread. Loading
+    an impulse response involves transforming all of its partitions, which can take a
+    while for long ones, so this can be done on a background thread, and the new impulse
+    response will be swapped in by the next call to process() after it's ready.
+
+    @see ConvolutionAudioSource, FFT
+*/
+class JUCE_API  Convolution
+{
+public:
+    //==============================================================================
+    /** Creates a Convolution with no impulse response. */
+    Convolution();
+
+    /** Destructor. */
+    ~Convolution();
+
+    //==============================================================================
+    /** Sets the sizes of the partitions that the impulse response is split into.
+
+        The first headSize taps are applied directly, and the remainder is convolved in
+        blocks of headSize samples. If tailBlockSize is larger than headSize, then any
+        taps beyond 2 * tailBlockSize are convolved in blocks of that size instead, which
+        is cheaper for long impulse responses.
+
+        Both sizes must be powers of two, and tailBlockSize must be at least as big as
+        headSize. If an impulse response has already been loaded, it'll be re-loaded
+        with the new sizes.
+    */
+    void setPartitionSizes (int headSize, int tailBlockSize);
+
+    /** Sets the number of channels that process() should expect.
+        If the impulse response has fewer channels than this, its channels will be re-used
+        cyclically, so a mono impulse response is applied to every channel. If an impulse
+        response has already been loaded, it'll be re-loaded with the new layout.
+    */
+    void setNumChannels (int numChannels);
+
+    /** Replaces the impulse response.
+
+        The buffer is copied, so the caller can delete it after this returns. If
+        loadInBackground is true, the impulse response will be prepared on a background
+        thread and this method returns immediately, otherwise it's prepared before the
+        method returns. In both cases, the previous impulse response carries on being
+        used until the next call to process() that happens after the new one is ready.
+    */
+    void loadImpulseResponse (const AudioBuffer<float>& impulseResponse, bool loadInBackground);
+
+    /** Returns true if a background load has been started and isn't yet ready. */
+    bool isLoadingImpulseResponse() const noexcept;
+
+    /** Returns the length of the impulse response that was most recently loaded. */
+    int getImpulseResponseLength() const noexcept;
+
+    //==============================================================================
+    /** Clears the internal state, so that any tails from previous input are discarded.
+        This mustn't be called at the same time as process().
+    */
+    void reset() noexcept;
+
+    /** Replaces the contents of a section of a buffer with its convolution.
+
+        Any channels beyond the number set with setNumChannels() are left unchanged,
+        as is the whole buffer if no impulse response has been loaded yet.
+    */
+    void process (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    struct Engine;
+    struct LoaderThread;
+    friend struct LoaderThread;
+
+    CriticalSection requestLock, buildLock;
+    AudioBuffer<float> impulseResponse;
+    int numChannels, headSize, tailBlockSize;
+    bool hasImpulseResponse, needsRebuild, rebuildInBackground;
+    volatile bool isLoading;
+
+    SpinLock engineLock;
+    ScopedPointer<Engine> activeEngine, newEngine, retiredEngine;
+    ScopedPointer<LoaderThread> loaderThread;
+
+    void requestRebuild (bool inBackground);
+    void buildPendingEngine();
+    void deleteRetiredEngine();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Convolution)
+};
+
+
+#endif   // JUCE_CONVOLUTION_H_INCLUDED
@@ -27,188 +27,245 @@
 static FFT::Complex operator+ (FFT::Complex a, FFT::Complex b) noexcept     { FFT::Complex c = { a.r + b.r, a.i + b.i }; return c; }
 static FFT::Complex operator- (FFT::Complex a, FFT::Complex b) noexcept     { FFT::Complex c = { a.r - b.r, a.i - b.i }; return c; }
 static FFT::Complex operator* (FFT::Complex a, FFT::Complex b) noexcept     { FFT::Complex c = { a.r * b.r - a.i * b.i, a.r * b.i + a.i * b.r }; return c; }
-static FFT::Complex& operator+= (FFT::Complex& a, FFT::Complex b) noexcept  { a.r += b.r; a.i += b.i; return a; }
 
 //==============================================================================
+/*  The plan for an iterative radix-2 transform of a given size.
+
+    All the tables are built up-front: the bit-reversal permutation, and for each stage
+    the twiddle factors it needs, stored pre-duplicated as (re, re) and (-im, im) pairs so
+    that a pair of complex multiplies can be done with a handful of vector ops.
+
+    If requested, it also holds a half-size plan plus the extra twiddles needed to do an
+    N-point transform of real data with an N/2-point complex one.
+*/
 struct FFT::FFTConfig
 {
-    FFTConfig (int sizeOfFFT, bool isInverse)
-        : fftSize (sizeOfFFT), inverse (isInverse), twiddleTable ((size_t) sizeOfFFT)
+    FFTConfig (int sizeOfFFT, bool isInverse, bool needsRealTransformPlan)
+        : fftSize (sizeOfFFT), inverse (isInverse),
+          bitReversedIndexes ((size_t) sizeOfFFT),
+          twiddlesRe ((size_t) sizeOfFFT * 2),
+          twiddlesIm ((size_t) sizeOfFFT * 2)
     {
+        const double sign = isInverse ? 1.0 : -1.0;
+
+        int numBits = 0;
+        while ((1 << numBits) < fftSize)
+            ++numBits;
+
         for (int i = 0; i < fftSize; ++i)
         {
-            const double phase = (isInverse ? 2.0 : -2.0) * double_Pi * i / fftSize;
-            twiddleTable[i].r = (float) cos (phase);
-            twiddleTable[i].i = (float) sin (phase);
-        }
+            int reversed = 0;
+
+            for (int bit = 0; bit < numBits; ++bit)
+                if ((i & (1 << bit)) != 0)
+                    reversed |= 1 << (numBits - 1 - bit);
 
-        const int root = (int) std::sqrt ((double) fftSize);
-        int divisor = 4, n = fftSize;
+            bitReversedIndexes[i] = reversed;
+        }
 
-        for (int i = 0; i < numElementsInArray (factors); ++i)
+        for (int halfLength = 1; halfLength < fftSize; halfLength *= 2)
         {
-            while ((n % divisor) != 0)
-            {
-                if (divisor == 2)       divisor = 3;
-                else if (divisor == 4)  divisor = 2;
-                else                    divisor += 2;
+            float* const re = twiddlesRe + getTwiddleOffset (halfLength);
+            float* const im = twiddlesIm + getTwiddleOffset (halfLength);
 
-                if (divisor > root)
-                    divisor = n;
+            for (int j = 0; j < halfLength; ++j)
+            {
+                const double phase = sign * double_Pi * j / halfLength;
+                re[2 * j]     = re[2 * j + 1] = (float) std::cos (phase);
+                im[2 * j + 1] = (float) std::sin (phase);
+                im[2 * j]     = -im[2 * j + 1];
             }
+        }
+
+        if (needsRealTransformPlan && fftSize >= 4)
+        {
+            const int halfSize = fftSize / 2;
 
-            n /= divisor;
+            halfSizeConfig = new FFTConfig (halfSize, isInverse, false);
+            realTwiddles.malloc ((size_t) halfSize + 1);
 
-            jassert (divisor == 1 || divisor == 2 || divisor == 4);
-            factors[i].radix = divisor;
-            factors[i].length = n;
+            for (int k = 0; k <= halfSize; ++k)
+            {
+                const double phase = sign * 2.0 * double_Pi * k / fftSize;
+                realTwiddles[k].r = (float) std::cos (phase);
+                realTwiddles[k].i = (float) std::sin (phase);
+            }
         }
     }
 
+    //==============================================================================
     void perform (const Complex* input, Complex* output) const noexcept
     {
-        perform (input, output, 1, 1, factors);
-    }
-
-    const int fftSize;
-    const bool inverse;
-
-    struct Factor { int radix, length; };
-    Factor factors[32];
-    HeapBlock<Complex> twiddleTable;
-
-    void perform (const Complex* input, Complex* output, const int stride, const int strideIn, const Factor* facs) const noexcept
-    {
-        const Factor factor (*facs++);
-        Complex* const originalOutput = output;
-        const Complex* const outputEnd = output + factor.radix * factor.length;
-
-        if (stride == 1 && factor.radix <= 5)
-        {
-            for (int i = 0; i < factor.radix; ++i)
-                perform (input + stride * strideIn * i, output + i * factor.length, stride * factor.radix, strideIn, facs);
-
-            butterfly (factor, output, stride);
-            return;
-        }
-
-        if (factor.length == 1)
+        if (input == output)
         {
-            do
+            for (int i = 0; i < fftSize; ++i)
             {
-                *output++ = *input;
-                input += stride * strideIn;
+                const int j = bitReversedIndexes[i];
+
+                if (i < j)
+                    std::swap (output[i], output[j]);
             }
-            while (output < outputEnd);
         }
         else
         {
-            do
-            {
-                perform (input, output, stride * factor.radix, strideIn, facs);
-                input += stride * strideIn;
-                output += factor.length;
-            }
-            while (output < outputEnd);
+            for (int i = 0; i < fftSize; ++i)
+                output[i] = input[bitReversedIndexes[i]];
         }
 
-        butterfly (factor, originalOutput, stride);
+        performFirstStages (output);
+
+        for (int halfLength = 4; halfLength < fftSize; halfLength *= 2)
+            performStage (output, halfLength);
     }
 
-    void butterfly (const Factor factor, Complex* data, const int stride) const noexcept
+    bool canDoRealTransforms() const noexcept   { return halfSizeConfig != nullptr; }
+
+    /*  Transforms fftSize reals (in d[0..fftSize)) to the complex bins 0..fftSize/2 using the
+        half-size plan. If fillUpperHalf is true, the remaining bins are filled in with the
+        conjugates of the lower ones, so the output matches that of a full complex transform.
+        The scratch space needs room for fftSize / 2 Complex values.
+    */
+    void performRealForward (float* d, Complex* scratch, bool fillUpperHalf) const noexcept
     {
-        switch (factor.radix)
-        {
-            case 1:   break;
-            case 2:   butterfly2 (data, stride, factor.length); return;
-            case 4:   butterfly4 (data, stride, factor.length); return;
-            default:  jassertfalse; break;
-        }
+        jassert (canDoRealTransforms());
 
-        Complex* scratch = static_cast<Complex*> (alloca (sizeof (Complex) * (size_t) factor.radix));
+        const int halfSize = fftSize / 2;
+        halfSizeConfig->perform (reinterpret_cast<const Complex*> (d), scratch);
 
-        for (int i = 0; i < factor.length; ++i)
+        // The half-size transform holds the spectra of the even and odd samples interleaved
+        // as real + imaginary parts, which we now untangle and combine.
+        Complex* const out = reinterpret_cast<Complex*> (d);
+
+        for (int k = 0; k <= halfSize; ++k)
         {
-            for (int k = i, q1 = 0; q1 < factor.radix; ++q1)
+            const Complex z1 = scratch[k == halfSize ? 0 : k];
+            const Complex z2 = scratch[k == 0 ? 0 : halfSize - k];
+
+            const Complex even = { 0.5f * (z1.r + z2.r), 0.5f * (z1.i - z2.i) };
+            const Complex odd  = { 0.5f * (z1.i + z2.i), 0.5f * (z2.r - z1.r) };
+            const Complex bin  = even + realTwiddles[k] * odd;
+
+            out[k] = bin;
+
+            if (fillUpperHalf && k > 0 && k < halfSize)
             {
-                scratch[q1] = data[k];
-                k += factor.length;
+                out[fftSize - k].r = bin.r;
+                out[fftSize - k].i = -bin.i;
             }
+        }
+    }
 
-            for (int k = i, q1 = 0; q1 < factor.radix; ++q1)
-            {
-                int twiddleIndex = 0;
-                data[k] = scratch[0];
+    /*  The reverse of performRealForward(): takes the complex bins 0..fftSize/2 of a
+        conjugate-symmetric spectrum and writes the inverse transform to d[0..fftSize), unscaled.
+        The scratch space needs room for fftSize / 2 Complex values.
+    */
+    void performRealInverse (float* d, Complex* scratch) const noexcept
+    {
+        jassert (canDoRealTransforms());
 
-                for (int q = 1; q < factor.radix; ++q)
-                {
-                    twiddleIndex += stride * k;
+        const int halfSize = fftSize / 2;
+        const Complex* const in = reinterpret_cast<const Complex*> (d);
 
-                    if (twiddleIndex >= fftSize)
-                        twiddleIndex -= fftSize;
+        for (int k = 0; k < halfSize; ++k)
+        {
+            // bin k + halfSize is the conjugate of bin halfSize - k
+            const Complex x1 = in[k];
+            const Complex x2 = { in[halfSize - k].r, -in[halfSize - k].i };
 
-                    data[k] += scratch[q] * twiddleTable[twiddleIndex];
-                }
+            const Complex even = { 0.5f * (x1.r + x2.r), 0.5f * (x1.i + x2.i) };
+            const Complex diff = { 0.5f * (x1.r - x2.r), 0.5f * (x1.i - x2.i) };
+            const Complex odd  = diff * realTwiddles[k];
 
-                k += factor.length;
-            }
+            scratch[k].r = even.r - odd.i;
+            scratch[k].i = even.i + odd.r;
         }
+
+        halfSizeConfig->perform (scratch, reinterpret_cast<Complex*> (d));
     }
 
-    void butterfly2 (Complex* data, const int stride, const int length) const noexcept
+    const int fftSize;
+    const bool inverse;
+
+private:
+    HeapBlock<int> bitReversedIndexes;
+    HeapBlock<float> twiddlesRe, twiddlesIm;
+    ScopedPointer<FFTConfig> halfSizeConfig;
+    HeapBlock<Complex> realTwiddles;
+
+    static int getTwiddleOffset (int halfLength) noexcept   { return 2 * (halfLength - 1); }
+
+    // Does the first two radix-2 passes in one go, as their twiddles are all 1 or +/-i
+    void performFirstStages (Complex* data) const noexcept
     {
-        Complex* dataEnd = data + length;
-        const Complex* tw = twiddleTable;
+        if (fftSize < 4)
+        {
+            if (fftSize == 2)
+            {
+                const Complex a (data[0]), b (data[1]);
+                data[0] = a + b;
+                data[1] = a - b;
+            }
 
-        for (int i = length; --i >= 0;)
+            return;
+        }
+
+        for (int i = 0; i < fftSize; i += 4)
         {
-            const Complex s (*dataEnd * *tw);
-            tw += stride;
-            *dataEnd++ = *data - s;
-            *data++ += s;
+            Complex* const x = data + i;
+
+            const Complex s0 = x[0] + x[1];
+            const Complex s1 = x[0] - x[1];
+            const Complex s2 = x[2] + x[3];
+            const Complex d  = x[2] - x[3];
+
+            // s3 = d * (inverse ? i : -i)
+            Complex s3;
+
+            if (inverse)  { s3.r = -d.i; s3.i =  d.r; }
+            else          { s3.r =  d.i; s3.i = -d.r; }
+
+            x[0] = s0 + s2;
+            x[1] = s1 + s3;
+            x[2] = s0 - s2;
+            x[3] = s1 - s3;
         }
     }
 
-    void butterfly4 (Complex* data, const int stride, const int length) const noexcept
+    void performStage (Complex* data, const int halfLength) const noexcept
     {
-        const int lengthX2 = length * 2;
-        const int lengthX3 = length * 3;
+        const float* const re = twiddlesRe + getTwiddleOffset (halfLength);
+        const float* const im = twiddlesIm + getTwiddleOffset (halfLength);
+        const int numFloats = halfLength * 2;
 
-        const Complex* twiddle1 = twiddleTable;
-        const Complex* twiddle2 = twiddle1;
-        const Complex* twiddle3 = twiddle1;
-
-        for (int i = length; --i >= 0;)
+        for (int start = 0; start < fftSize; start += halfLength * 2)
         {
-            const Complex s0 = data[length]   * *twiddle1;
-            const Complex s1 = data[lengthX2] * *twiddle2;
-            const Complex s2 = data[lengthX3] * *twiddle3;
-            const Complex s3 = s0 + s2;
-            const Complex s4 = s0 - s2;
-            const Complex s5 = *data - s1;
-            *data += s1;
-            data[lengthX2] = *data - s3;
-            twiddle1 += stride;
-            twiddle2 += stride * 2;
-            twiddle3 += stride * 3;
-            *data += s3;
-
-            if (inverse)
+            float* const a = reinterpret_cast<float*> (data + start);
+            float* const b = a + numFloats;
+
+           #if JUCE_USE_SSE_INTRINSICS
+            for (int j = 0; j < numFloats; j += 4)
             {
-                data[length].r   = s5.r - s4.i;
-                data[length].i   = s5.i + s4.r;
-                data[lengthX3].r = s5.r + s4.i;
-                data[lengthX3].i = s5.i - s4.r;
+                const __m128 x = _mm_loadu_ps (b + j);
+                const __m128 t = _mm_add_ps (_mm_mul_ps (x, _mm_loadu_ps (re + j)),
+                                             _mm_mul_ps (_mm_shuffle_ps (x, x, _MM_SHUFFLE (2, 3, 0, 1)),
+                                                         _mm_loadu_ps (im + j)));
+                const __m128 u = _mm_loadu_ps (a + j);
+
+                _mm_storeu_ps (a + j, _mm_add_ps (u, t));
+                _mm_storeu_ps (b + j, _mm_sub_ps (u, t));
             }
-            else
+           #else
+            for (int j = 0; j < numFloats; j += 2)
             {
-                data[length].r   = s5.r + s4.i;
-                data[length].i   = s5.i - s4.r;
-                data[lengthX3].r = s5.r - s4.i;
-                data[lengthX3].i = s5.i + s4.r;
-            }
+                const float tr = b[j]     * re[j]     + b[j + 1] * im[j];
+                const float ti = b[j + 1] * re[j + 1] + b[j]     * im[j + 1];
 
-            ++data;
+                b[j]     = a[j]     - tr;
+                b[j + 1] = a[j + 1] - ti;
+                a[j]     += tr;
+                a[j + 1] += ti;
+            }
+           #endif
         }
     }
 
@@ -217,7 +274,7 @@ struct FFT::FFTConfig
 
 
 //==============================================================================
-FFT::FFT (int order, bool inverse)  : config (new FFTConfig (1 << order, inverse)), size (1 << order) {}
+FFT::FFT (int order, bool inverse)  : config (new FFTConfig (1 << order, inverse, true)), size (1 << order) {}
 FFT::~FFT() {}
 
 void FFT::perform (const Complex* const input, Complex* const output) const noexcept
@@ -228,32 +285,69 @@ void FFT::perform (const Complex* const input, Complex* const output) const noex
 const size_t maxFFTScratchSpaceToAlloca = 256 * 1024;
 
 void FFT::performRealOnlyForwardTransform (float* d) const noexcept
+{
+    performTransforms (&d, 1, realForwardTransform);
+}
+
+void FFT::performRealOnlyInverseTransform (float* d) const noexcept
+{
+    performTransforms (&d, 1, realInverseTransform);
+}
+
+void FFT::performSymmetricInverseTransform (float* d) const noexcept
+{
+    performTransforms (&d, 1, symmetricInverseTransform);
+}
+
+void FFT::performFrequencyOnlyForwardTransform (float* d) const noexcept
+{
+    performTransforms (&d, 1, frequencyOnlyTransform);
+}
+
+void FFT::performRealOnlyForwardTransforms (float* const* blocks, int numBlocks) const noexcept
+{
+    performTransforms (blocks, numBlocks, realForwardTransform);
+}
+
+void FFT::performRealOnlyInverseTransforms (float* const* blocks, int numBlocks) const noexcept
+{
+    performTransforms (blocks, numBlocks, realInverseTransform);
+}
+
+void FFT::performFrequencyOnlyForwardTransforms (float* const* blocks, int numBlocks) const noexcept
+{
+    performTransforms (blocks, numBlocks, frequencyOnlyTransform);
+}
+
+void FFT::performTransforms (float* const* blocks, int numBlocks, TransformType type) const noexcept
 {
     const size_t scratchSize = 16 + sizeof (FFT::Complex) * (size_t) size;
 
     if (scratchSize < maxFFTScratchSpaceToAlloca)
     {
-        performRealOnlyForwardTransform (static_cast<Complex*> (alloca (scratchSize)), d);
+        performTransforms (static_cast<Complex*> (alloca (scratchSize)), blocks, numBlocks, type);
     }
     else
     {
         HeapBlock<char> heapSpace (scratchSize);
-        performRealOnlyForwardTransform (reinterpret_cast<Complex*> (heapSpace.getData()), d);
+        performTransforms (reinterpret_cast<Complex*> (heapSpace.getData()), blocks, numBlocks, type);
     }
 }
 
-void FFT::performRealOnlyInverseTransform (float* d) const noexcept
+void FFT::performTransforms (Complex* scratch, float* const* blocks, int numBlocks, TransformType type) const noexcept
 {
-    const size_t scratchSize = 16 + sizeof (FFT::Complex) * (size_t) size;
-
-    if (scratchSize < maxFFTScratchSpaceToAlloca)
-    {
-        performRealOnlyInverseTransform (static_cast<Complex*> (alloca (scratchSize)), d);
-    }
-    else
+    for (int i = 0; i < numBlocks; ++i)
     {
-        HeapBlock<char> heapSpace (scratchSize);
-        performRealOnlyInverseTransform (reinterpret_cast<Complex*> (heapSpace.getData()), d);
+        float* const d = blocks[i];
+
+        switch (type)
+        {
+            case realForwardTransform:       performRealOnlyForwardTransform (scratch, d); break;
+            case realInverseTransform:       performRealOnlyInverseTransform (scratch, d); break;
+            case symmetricInverseTransform:  performSymmetricInverseTransform (scratch, d); break;
+            case frequencyOnlyTransform:     performFrequencyOnlyForwardTransform (scratch, d); break;
+            default:                         jassertfalse; break;
+        }
     }
 }
 
@@ -262,6 +356,12 @@ void FFT::performRealOnlyForwardTransform (Complex* scratch, float* d) const noe
     // This can only be called on an FFT object that was created to do forward transforms.
     jassert (! config->inverse);
 
+    if (config->canDoRealTransforms())
+    {
+        config->performRealForward (d, scratch, true);
+        return;
+    }
+
     for (int i = 0; i < size; ++i)
     {
         scratch[i].r = d[i];
@@ -287,9 +387,58 @@ void FFT::performRealOnlyInverseTransform (Complex* scratch, float* d) const noe
     }
 }
 
-void FFT::performFrequencyOnlyForwardTransform (float* d) const noexcept
+void FFT::performSymmetricInverseTransform (Complex* scratch, float* d) const noexcept
+{
+    // This can only be called on an FFT object that was created to do inverse transforms.
+    jassert (config->inverse);
+
+    if (config->canDoRealTransforms())
+    {
+        // (the half-size transform leaves the samples scaled by size / 2)
+        config->performRealInverse (d, scratch);
+        FloatVectorOperations::multiply (d, 2.0f / size, size);
+    }
+    else
+    {
+        // Too small for a half-size plan, so fill in the upper bins and do a full transform
+        Complex* const bins = reinterpret_cast<Complex*> (d);
+
+        for (int i = size / 2 + 1; i < size; ++i)
+        {
+            bins[i].r = bins[size - i].r;
+            bins[i].i = -bins[size - i].i;
+        }
+
+        perform (bins, scratch);
+
+        for (int i = 0; i < size; ++i)
+            d[i] = scratch[i].r / size;
+    }
+
+    FloatVectorOperations::clear (d + size, size);
+}
+
+void FFT::performFrequencyOnlyForwardTransform (Complex* scratch, float* d) const noexcept
 {
-    performRealOnlyForwardTransform (d);
+    if (config->canDoRealTransforms())
+    {
+        // Only the lower half of the spectrum needs computing, as the magnitudes are symmetrical
+        jassert (! config->inverse);
+        config->performRealForward (d, scratch, false);
+
+        const int halfSize = size / 2;
+
+        for (int i = 0; i <= halfSize; ++i)
+            d[i] = juce_hypot (d[2 * i], d[2 * i + 1]);
+
+        for (int i = halfSize + 1; i < size; ++i)
+            d[i] = d[size - i];
+
+        FloatVectorOperations::clear (d + size, size);
+        return;
+    }
+
+    performRealOnlyForwardTransform (scratch, d);
     const int twiceSize = size * 2;
 
     for (int i = 0; i < twiceSize; i += 2)
@@ -303,3 +452,423 @@ void FFT::performFrequencyOnlyForwardTransform (float* d) const noexcept
         }
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FFTTests  : public UnitTest
+{
+public:
+    FFTTests() : UnitTest ("FFT") {}
+
+    // The recursive radix-4/2 engine that FFT used before it had precomputed plans, kept
+    // here so that the current implementation's results and speed can be compared with it.
+    struct ReferenceFFT
+    {
+        ReferenceFFT (int order, bool isInverse)
+            : fftSize (1 << order), inverse (isInverse), twiddleTable ((size_t) fftSize), scratch ((size_t) fftSize)
+        {
+            for (int i = 0; i < fftSize; ++i)
+            {
+                const double phase = (isInverse ? 2.0 : -2.0) * double_Pi * i / fftSize;
+                twiddleTable[i].r = (float) cos (phase);
+                twiddleTable[i].i = (float) sin (phase);
+            }
+
+            int n = fftSize;
+
+            for (int i = 0; i < numElementsInArray (factors); ++i)
+            {
+                const int radix = (n % 4) == 0 ? 4 : ((n % 2) == 0 ? 2 : 1);
+                n /= radix;
+                factors[i].radix = radix;
+                factors[i].length = n;
+            }
+        }
+
+        void performRealOnlyForwardTransform (float* d)
+        {
+            for (int i = 0; i < fftSize; ++i)
+            {
+                scratch[i].r = d[i];
+                scratch[i].i = 0;
+            }
+
+            perform (scratch, reinterpret_cast<FFT::Complex*> (d), 1, factors);
+        }
+
+        void performFrequencyOnlyForwardTransform (float* d)
+        {
+            performRealOnlyForwardTransform (d);
+
+            for (int i = 0; i < fftSize * 2; i += 2)
+            {
+                d[i / 2] = juce_hypot (d[i], d[i + 1]);
+
+                if (i >= fftSize)
+                    d[i] = d[i + 1] = 0;
+            }
+        }
+
+    private:
+        struct Factor { int radix, length; };
+
+        const int fftSize;
+        const bool inverse;
+        Factor factors[32];
+        HeapBlock<FFT::Complex> twiddleTable, scratch;
+
+        void perform (const FFT::Complex* input, FFT::Complex* output, const int stride, const Factor* facs) const noexcept
+        {
+            const Factor factor (*facs++);
+
+            if (factor.length == 1)
+            {
+                for (int i = 0; i < factor.radix; ++i)
+                    output[i] = input[stride * i];
+            }
+            else
+            {
+                for (int i = 0; i < factor.radix; ++i)
+                    perform (input + stride * i, output + i * factor.length, stride * factor.radix, facs);
+            }
+
+            if (factor.radix == 2)
+            {
+                for (int i = 0; i < factor.length; ++i)
+                {
+                    const FFT::Complex s (output[i + factor.length] * twiddleTable[i * stride]);
+                    output[i + factor.length] = output[i] - s;
+                    output[i] = output[i] + s;
+                }
+            }
+            else if (factor.radix == 4)
+            {
+                const int length = factor.length;
+
+                for (int i = 0; i < length; ++i)
+                {
+                    FFT::Complex* const data = output + i;
+                    const FFT::Complex s0 = data[length]     * twiddleTable[i * stride];
+                    const FFT::Complex s1 = data[length * 2] * twiddleTable[i * stride * 2];
+                    const FFT::Complex s2 = data[length * 3] * twiddleTable[i * stride * 3];
+                    const FFT::Complex s3 = s0 + s2;
+                    const FFT::Complex s4 = s0 - s2;
+                    const FFT::Complex s5 = data[0] - s1;
+                    data[0] = data[0] + s1;
+                    data[length * 2] = data[0] - s3;
+                    data[0] = data[0] + s3;
+
+                    const float sign = inverse ? 1.0f : -1.0f;
+                    data[length].r     = s5.r - sign * s4.i;
+                    data[length].i     = s5.i + sign * s4.r;
+                    data[length * 3].r = s5.r + sign * s4.i;
+                    data[length * 3].i = s5.i - sign * s4.r;
+                }
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (ReferenceFFT)
+    };
+
+    //==============================================================================
+    // A direct O(n^2) DFT in double precision, to check the results against
+    static void performDFT (const FFT::Complex* input, double* outputRe, double* outputIm, int size, bool inverse)
+    {
+        HeapBlock<double> cosTable ((size_t) size), sinTable ((size_t) size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            const double phase = (inverse ? 2.0 : -2.0) * double_Pi * i / size;
+            cosTable[i] = std::cos (phase);
+            sinTable[i] = std::sin (phase);
+        }
+
+        for (int k = 0; k < size; ++k)
+        {
+            double re = 0, im = 0;
+
+            for (int n = 0; n < size; ++n)
+            {
+                const int index = (int) (((int64) n * k) % size);
+                re += input[n].r * cosTable[index] - input[n].i * sinTable[index];
+                im += input[n].r * sinTable[index] + input[n].i * cosTable[index];
+            }
+
+            outputRe[k] = re;
+            outputIm[k] = im;
+        }
+    }
+
+    static float getTolerance (int order)   { return 1.0e-6f * (float) (1 << order) * (float) (order + 1) + 1.0e-5f; }
+
+    void checkComplexTransforms (int order, bool inverse)
+    {
+        const int size = 1 << order;
+        Random r (getRandom());
+        HeapBlock<FFT::Complex> input ((size_t) size), output ((size_t) size);
+        HeapBlock<double> expectedRe ((size_t) size), expectedIm ((size_t) size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            input[i].r = r.nextFloat() * 2.0f - 1.0f;
+            input[i].i = r.nextFloat() * 2.0f - 1.0f;
+        }
+
+        FFT fft (order, inverse);
+        fft.perform (input, output);
+        performDFT (input, expectedRe, expectedIm, size, inverse);
+
+        double maxError = 0;
+
+        for (int i = 0; i < size; ++i)
+            maxError = jmax (maxError, std::abs (output[i].r - expectedRe[i]), std::abs (output[i].i - expectedIm[i]));
+
+        expect (maxError < getTolerance (order), "order " + String (order) + ": error " + String (maxError));
+
+        // in-place use must give the same results
+        fft.perform (input, input);
+        expect (memcmp (input.getData(), output.getData(), sizeof (FFT::Complex) * (size_t) size) == 0);
+    }
+
+    void checkRealTransforms (int order)
+    {
+        const int size = 1 << order;
+        Random r (getRandom());
+        HeapBlock<float> samples ((size_t) size), data ((size_t) size * 2), magnitudes ((size_t) size * 2);
+        HeapBlock<FFT::Complex> complexInput ((size_t) size);
+        HeapBlock<double> expectedRe ((size_t) size), expectedIm ((size_t) size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            samples[i] = data[i] = magnitudes[i] = r.nextFloat() * 2.0f - 1.0f;
+            complexInput[i].r = samples[i];
+            complexInput[i].i = 0;
+        }
+
+        const FFT forward (order, false), inverse (order, true);
+        forward.performRealOnlyForwardTransform (data);
+        forward.performFrequencyOnlyForwardTransform (magnitudes);
+        performDFT (complexInput, expectedRe, expectedIm, size, false);
+
+        const float tolerance = getTolerance (order);
+        double maxError = 0, maxMagnitudeError = 0, maxUpperHalf = 0;
+
+        for (int i = 0; i < size; ++i)
+        {
+            maxError = jmax (maxError, std::abs (data[2 * i] - expectedRe[i]), std::abs (data[2 * i + 1] - expectedIm[i]));
+            maxMagnitudeError = jmax (maxMagnitudeError, std::abs (magnitudes[i] - std::sqrt (expectedRe[i] * expectedRe[i]
+                                                                                               + expectedIm[i] * expectedIm[i])));
+            maxUpperHalf = jmax (maxUpperHalf, (double) std::abs (magnitudes[size + i]));
+        }
+
+        expect (maxError < tolerance, "order " + String (order) + ": forward error " + String (maxError));
+        expect (maxMagnitudeError < tolerance, "order " + String (order) + ": magnitude error " + String (maxMagnitudeError));
+        expect (maxUpperHalf == 0);
+
+        inverse.performRealOnlyInverseTransform (data);
+        double maxRoundTripError = 0;
+
+        for (int i = 0; i < size; ++i)
+            maxRoundTripError = jmax (maxRoundTripError, (double) std::abs (data[i] - samples[i]), (double) std::abs (data[size + i]));
+
+        expect (maxRoundTripError < 1.0e-5 * (order + 1), "order " + String (order) + ": round-trip error " + String (maxRoundTripError));
+
+        FloatVectorOperations::copy (data, samples, size);
+        forward.performRealOnlyForwardTransform (data);
+        inverse.performSymmetricInverseTransform (data);
+        maxRoundTripError = 0;
+
+        for (int i = 0; i < size; ++i)
+            maxRoundTripError = jmax (maxRoundTripError, (double) std::abs (data[i] - samples[i]), (double) std::abs (data[size + i]));
+
+        expect (maxRoundTripError < 1.0e-5 * (order + 1), "order " + String (order) + ": symmetric round-trip error " + String (maxRoundTripError));
+    }
+
+    // performRealOnlyInverseTransform() must do a full complex inverse of whatever it's given,
+    // whereas performSymmetricInverseTransform() only looks at the lower half of the spectrum.
+    void checkNonSymmetricInverse (int order)
+    {
+        const int size = 1 << order, halfSize = size / 2;
+        Random r (getRandom());
+        HeapBlock<FFT::Complex> spectrum ((size_t) size), symmetricSpectrum ((size_t) size);
+        HeapBlock<float> full ((size_t) size * 2), symmetric ((size_t) size * 2);
+        HeapBlock<double> expectedRe ((size_t) size), expectedIm ((size_t) size);
+        HeapBlock<double> symmetricRe ((size_t) size), symmetricIm ((size_t) size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            spectrum[i].r = r.nextFloat() * 2.0f - 1.0f;
+            spectrum[i].i = (i == 0 || i == halfSize) ? 0.0f : r.nextFloat() * 2.0f - 1.0f;
+        }
+
+        for (int i = 0; i < size; ++i)
+        {
+            symmetricSpectrum[i] = spectrum[i <= halfSize ? i : size - i];
+
+            if (i > halfSize)
+                symmetricSpectrum[i].i = -symmetricSpectrum[i].i;
+        }
+
+        memcpy (full, spectrum, sizeof (FFT::Complex) * (size_t) size);
+        memcpy (symmetric, spectrum, sizeof (FFT::Complex) * (size_t) size);
+
+        const FFT inverse (order, true);
+        inverse.performRealOnlyInverseTransform (full);
+        inverse.performSymmetricInverseTransform (symmetric);
+
+        performDFT (spectrum, expectedRe, expectedIm, size, true);
+        performDFT (symmetricSpectrum, symmetricRe, symmetricIm, size, true);
+
+        const float tolerance = getTolerance (order);
+        double maxFullError = 0, maxSymmetricError = 0, maxDifference = 0;
+
+        for (int i = 0; i < size; ++i)
+        {
+            maxFullError = jmax (maxFullError, std::abs (full[i] - expectedRe[i] / size), std::abs (full[size + i] - expectedIm[i] / size));
+            maxSymmetricError = jmax (maxSymmetricError, std::abs (symmetric[i] - symmetricRe[i] / size), (double) std::abs (symmetric[size + i]));
+            maxDifference = jmax (maxDifference, (double) std::abs (full[i] - symmetric[i]));
+        }
+
+        expect (maxFullError < tolerance, "order " + String (order) + ": full inverse error " + String (maxFullError));
+        expect (maxSymmetricError < tolerance, "order " + String (order) + ": symmetric inverse error " + String (maxSymmetricError));
+
+        // with an upper half that doesn't mirror the lower one, the two results should differ
+        if (order >= 2)
+            expect (maxDifference > 0.01, "order " + String (order) + ": the two inverses match");
+    }
+
+    void checkBatchTransforms (int order)
+    {
+        const int size = 1 << order, numBlocks = 5;
+        Random r (getRandom());
+        HeapBlock<float> batchData ((size_t) (size * 2 * numBlocks)), singleData ((size_t) (size * 2 * numBlocks));
+        HeapBlock<float*> blocks ((size_t) numBlocks);
+
+        for (int i = 0; i < size * 2 * numBlocks; ++i)
+            batchData[i] = singleData[i] = r.nextFloat() * 2.0f - 1.0f;
+
+        for (int i = 0; i < numBlocks; ++i)
+            blocks[i] = batchData + i * size * 2;
+
+        const FFT forward (order, false), inverse (order, true);
+        const size_t numBytes = sizeof (float) * (size_t) (size * 2 * numBlocks);
+
+        forward.performRealOnlyForwardTransforms (blocks, numBlocks);
+
+        for (int i = 0; i < numBlocks; ++i)
+            forward.performRealOnlyForwardTransform (singleData + i * size * 2);
+
+        expect (memcmp (batchData.getData(), singleData.getData(), numBytes) == 0);
+
+        inverse.performRealOnlyInverseTransforms (blocks, numBlocks);
+
+        for (int i = 0; i < numBlocks; ++i)
+            inverse.performRealOnlyInverseTransform (singleData + i * size * 2);
+
+        expect (memcmp (batchData.getData(), singleData.getData(), numBytes) == 0);
+
+        forward.performFrequencyOnlyForwardTransforms (blocks, numBlocks);
+
+        for (int i = 0; i < numBlocks; ++i)
+            forward.performFrequencyOnlyForwardTransform (singleData + i * size * 2);
+
+        expect (memcmp (batchData.getData(), singleData.getData(), numBytes) == 0);
+    }
+
+    void logPerformance (int order, int numFrames)
+    {
+        const int size = 1 << order;
+        HeapBlock<float> input ((size_t) (size * numFrames)), frames ((size_t) (size * 2 * numFrames));
+        HeapBlock<float> work ((size_t) size * 2), referenceResult ((size_t) size * 2);
+        HeapBlock<float*> blocks ((size_t) numFrames);
+        Random r (getRandom());
+
+        for (int i = 0; i < numFrames; ++i)
+            blocks[i] = frames + i * size * 2;
+
+        const FFT fft (order, false);
+        ReferenceFFT reference (order, false);
+        double referenceTime = 0, singleTime = 0, batchTime = 0;
+
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            for (int i = 0; i < size * numFrames; ++i)
+                input[i] = r.nextFloat() * 2.0f - 1.0f;
+
+            double startTime = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                FloatVectorOperations::copy (work, input + i * size, size);
+                reference.performFrequencyOnlyForwardTransform (work);
+
+                if (i == 0)
+                    FloatVectorOperations::copy (referenceResult, work, size);
+            }
+
+            referenceTime += Time::getMillisecondCounterHiRes() - startTime;
+            startTime = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                FloatVectorOperations::copy (work, input + i * size, size);
+                fft.performFrequencyOnlyForwardTransform (work);
+            }
+
+            singleTime += Time::getMillisecondCounterHiRes() - startTime;
+            startTime = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < numFrames; ++i)
+                FloatVectorOperations::copy (blocks[i], input + i * size, size);
+
+            fft.performFrequencyOnlyForwardTransforms (blocks, numFrames);
+            batchTime += Time::getMillisecondCounterHiRes() - startTime;
+
+            double maxDifference = 0;
+
+            for (int i = 0; i < size; ++i)
+                maxDifference = jmax (maxDifference, (double) std::abs (referenceResult[i] - blocks[0][i]));
+
+            expect (maxDifference < getTolerance (order));
+        }
+
+        logMessage (String (size) + "-point magnitude spectra, " + String (numFrames * 3) + " frames: previous engine "
+                      + String (referenceTime, 1) + "ms, now " + String (singleTime, 1) + "ms (x"
+                      + String (referenceTime / jmax (0.001, singleTime), 2) + "), batched "
+                      + String (batchTime, 1) + "ms (x" + String (referenceTime / jmax (0.001, batchTime), 2) + ")");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Complex transforms");
+
+        for (int order = 0; order <= 10; ++order)
+        {
+            checkComplexTransforms (order, false);
+            checkComplexTransforms (order, true);
+        }
+
+        beginTest ("Real-only transforms");
+
+        for (int order = 0; order <= 10; ++order)
+            checkRealTransforms (order);
+
+        beginTest ("Inverse of a non-symmetric spectrum");
+
+        for (int order = 0; order <= 10; ++order)
+            checkNonSymmetricInverse (order);
+
+        beginTest ("Batch transforms");
+
+        for (int order = 0; order <= 12; order += 3)
+            checkBatchTransforms (order);
+
+        beginTest ("Performance");
+        logPerformance (12, 64);
+    }
+};
+
+static FFTTests fftUnitTests;
+
+#endif
@@ -23,15 +23,17 @@
 */
 
 /**
-    A very minimal FFT class.
+    A simple, fairly lightweight FFT class.
 
-    This is only a simple low-footprint implementation and isn't tuned for speed - it may
-    be useful for simple applications where one of the more complex FFT libraries would be
-    overkill. (But in the future it may end up becoming optimised of course...)
+    This is a power-of-two radix-2 implementation which uses SSE for its butterflies where
+    available, and does its real-only transforms with a complex transform of half the size.
+    It's a good deal faster than a naive implementation, but for really heavy lifting one of
+    the dedicated FFT libraries may still be worth the extra dependency.
 
-    The FFT class itself contains lookup tables, so there's some overhead in creating
-    one, you should create and cache an FFT object for each size/direction of transform
-    that you need, and re-use them to perform the actual operation.
+    The FFT class itself contains the bit-reversal and twiddle tables for its size, so there's
+    some overhead in creating one - you should create and cache an FFT object for each
+    size/direction of transform that you need, and re-use them to perform the actual operation.
+    Once created, an FFT object can be used by multiple threads at the same time.
 */
 class JUCE_API  FFT
 {
@@ -54,7 +56,8 @@ public:
     /** Performs an out-of-place FFT, either forward or inverse depending on the mode
         that was passed to this object's constructor.
 
-        The arrays must contain at least getSize() elements.
+        The arrays must contain at least getSize() elements. The input and output may also
+        be the same array, in which case the transform is done in-place.
     */
     void perform (const Complex* input, Complex* output) const noexcept;
 
@@ -75,11 +78,44 @@ public:
     */
     void performRealOnlyInverseTransform (float* inputOutputData) const noexcept;
 
+    /** A faster version of performRealOnlyInverseTransform() for the spectrum of a real signal.
+
+        The spectrum is assumed to be conjugate-symmetric, so only bins 0 to getSize() / 2 are
+        read, and the bins above those are taken to be their mirror-image conjugates. On return,
+        the first half of the array will contain the reconstituted samples, and the second half
+        will be cleared. For a spectrum that isn't conjugate-symmetric, the results will differ
+        from those of performRealOnlyInverseTransform().
+    */
+    void performSymmetricInverseTransform (float* inputOutputData) const noexcept;
+
     /** Takes an array and simply transforms it to the frequency spectrum.
         This may be handy for things like frequency displays or analysis.
+
+        The size of the array passed in must be 2 * getSize(), and the first half should
+        contain your raw input sample data. On return, the first half will contain the
+        magnitude of each frequency bin, and the second half will be cleared.
     */
     void performFrequencyOnlyForwardTransform (float* inputOutputData) const noexcept;
 
+    //==============================================================================
+    /** Performs performRealOnlyForwardTransform() on a set of separate blocks of data.
+
+        Each pointer in the array must point to 2 * getSize() floats. This is cheaper
+        than transforming the blocks one at a time, as the scratch space that's needed
+        is only set up once for the whole batch.
+    */
+    void performRealOnlyForwardTransforms (float* const* blocks, int numBlocks) const noexcept;
+
+    /** Performs performRealOnlyInverseTransform() on a set of separate blocks of data.
+        @see performRealOnlyForwardTransforms
+    */
+    void performRealOnlyInverseTransforms (float* const* blocks, int numBlocks) const noexcept;
+
+    /** Performs performFrequencyOnlyForwardTransform() on a set of separate blocks of data.
+        @see performRealOnlyForwardTransforms
+    */
+    void performFrequencyOnlyForwardTransforms (float* const* blocks, int numBlocks) const noexcept;
+
     /** Returns the number of data points that this FFT was created to work with. */
     int getSize() const noexcept            { return size; }
 
@@ -88,8 +124,20 @@ private:
     ScopedPointer<FFTConfig> config;
     const int size;
 
+    enum TransformType
+    {
+        realForwardTransform,
+        realInverseTransform,
+        symmetricInverseTransform,
+        frequencyOnlyTransform
+    };
+
+    void performTransforms (float* const*, int, TransformType) const noexcept;
+    void performTransforms (Complex*, float* const*, int, TransformType) const noexcept;
     void performRealOnlyForwardTransform (Complex*, float*) const noexcept;
     void performRealOnlyInverseTransform (Complex*, float*) const noexcept;
+    void performSymmetricInverseTransform (Complex*, float*) const noexcept;
+    void performFrequencyOnlyForwardTransform (Complex*, float*) const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FFT)
 };
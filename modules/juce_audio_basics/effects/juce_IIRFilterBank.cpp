@@ -0,0 +1,536 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace IIRFilterBankHelpers
+{
+    // The channels are processed in groups of eight, as two vectors of four. The filters
+    // are limited by the latency of each step rather than by throughput, so keeping two
+    // independent vectors in flight is almost twice as fast as working on one.
+    enum { numParallel = 8, chunkSize = 64 };
+
+   #if JUCE_USE_SSE_INTRINSICS
+    struct VectorOps
+    {
+        struct ParallelType  { __m128 a, b; };
+
+        static forcedinline ParallelType make (__m128 a, __m128 b) noexcept              { ParallelType r = { a, b }; return r; }
+        static forcedinline ParallelType loadU (const float* v) noexcept                 { return make (_mm_loadu_ps (v), _mm_loadu_ps (v + 4)); }
+        static forcedinline void storeU (float* dest, ParallelType v) noexcept           { _mm_storeu_ps (dest, v.a); _mm_storeu_ps (dest + 4, v.b); }
+        static forcedinline ParallelType add (ParallelType x, ParallelType y) noexcept  { return make (_mm_add_ps (x.a, y.a), _mm_add_ps (x.b, y.b)); }
+        static forcedinline ParallelType sub (ParallelType x, ParallelType y) noexcept  { return make (_mm_sub_ps (x.a, y.a), _mm_sub_ps (x.b, y.b)); }
+        static forcedinline ParallelType mul (ParallelType x, ParallelType y) noexcept  { return make (_mm_mul_ps (x.a, y.a), _mm_mul_ps (x.b, y.b)); }
+    };
+   #elif JUCE_USE_ARM_NEON
+    struct VectorOps
+    {
+        struct ParallelType  { float32x4_t a, b; };
+
+        static forcedinline ParallelType make (float32x4_t a, float32x4_t b) noexcept    { ParallelType r = { a, b }; return r; }
+        static forcedinline ParallelType loadU (const float* v) noexcept                 { return make (vld1q_f32 (v), vld1q_f32 (v + 4)); }
+        static forcedinline void storeU (float* dest, ParallelType v) noexcept           { vst1q_f32 (dest, v.a); vst1q_f32 (dest + 4, v.b); }
+        static forcedinline ParallelType add (ParallelType x, ParallelType y) noexcept  { return make (vaddq_f32 (x.a, y.a), vaddq_f32 (x.b, y.b)); }
+        static forcedinline ParallelType sub (ParallelType x, ParallelType y) noexcept  { return make (vsubq_f32 (x.a, y.a), vsubq_f32 (x.b, y.b)); }
+        static forcedinline ParallelType mul (ParallelType x, ParallelType y) noexcept  { return make (vmulq_f32 (x.a, y.a), vmulq_f32 (x.b, y.b)); }
+    };
+   #else
+    struct VectorOps
+    {
+        struct ParallelType  { float v[numParallel]; };
+
+        static forcedinline ParallelType loadU (const float* v) noexcept                 { ParallelType r; memcpy (r.v, v, sizeof (r.v)); return r; }
+        static forcedinline void storeU (float* dest, ParallelType a) noexcept           { memcpy (dest, a.v, sizeof (a.v)); }
+
+        static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { for (int i = 0; i < numParallel; ++i) a.v[i] += b.v[i]; return a; }
+        static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { for (int i = 0; i < numParallel; ++i) a.v[i] -= b.v[i]; return a; }
+        static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { for (int i = 0; i < numParallel; ++i) a.v[i] *= b.v[i]; return a; }
+    };
+   #endif
+
+    typedef VectorOps::ParallelType ParallelType;
+
+    // Runs one biquad over a chunk of interleaved samples, moving its coefficients by
+    // the given steps for the first numToRamp samples. The p array points to the section's
+    // five coefficients, then their five steps and five targets, then its two state variables.
+    static forcedinline void processSection (float* const* p, float* data, int numSamples, int numToRamp) noexcept
+    {
+        ParallelType b0 = VectorOps::loadU (p[0]), b1 = VectorOps::loadU (p[1]), b2 = VectorOps::loadU (p[2]);
+        ParallelType a1 = VectorOps::loadU (p[3]), a2 = VectorOps::loadU (p[4]);
+        ParallelType v1 = VectorOps::loadU (p[15]), v2 = VectorOps::loadU (p[16]);
+
+        int i = 0;
+
+        if (numToRamp > 0)
+        {
+            const ParallelType db0 = VectorOps::loadU (p[5]), db1 = VectorOps::loadU (p[6]), db2 = VectorOps::loadU (p[7]);
+            const ParallelType da1 = VectorOps::loadU (p[8]), da2 = VectorOps::loadU (p[9]);
+
+            for (; i < numToRamp; ++i)
+            {
+                b0 = VectorOps::add (b0, db0);  b1 = VectorOps::add (b1, db1);  b2 = VectorOps::add (b2, db2);
+                a1 = VectorOps::add (a1, da1);  a2 = VectorOps::add (a2, da2);
+
+                const ParallelType in = VectorOps::loadU (data + i * numParallel);
+                const ParallelType out = VectorOps::add (VectorOps::mul (b0, in), v1);
+                VectorOps::storeU (data + i * numParallel, out);
+
+                v1 = VectorOps::add (VectorOps::sub (VectorOps::mul (b1, in), VectorOps::mul (a1, out)), v2);
+                v2 = VectorOps::sub (VectorOps::mul (b2, in), VectorOps::mul (a2, out));
+            }
+
+            VectorOps::storeU (p[0], b0);  VectorOps::storeU (p[1], b1);  VectorOps::storeU (p[2], b2);
+            VectorOps::storeU (p[3], a1);  VectorOps::storeU (p[4], a2);
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            const ParallelType in = VectorOps::loadU (data + i * numParallel);
+            const ParallelType out = VectorOps::add (VectorOps::mul (b0, in), v1);
+            VectorOps::storeU (data + i * numParallel, out);
+
+            v1 = VectorOps::add (VectorOps::sub (VectorOps::mul (b1, in), VectorOps::mul (a1, out)), v2);
+            v2 = VectorOps::sub (VectorOps::mul (b2, in), VectorOps::mul (a2, out));
+        }
+
+        VectorOps::storeU (p[15], v1);
+        VectorOps::storeU (p[16], v2);
+    }
+
+    static void snapToZero (float* values, int num) noexcept
+    {
+        for (int i = 0; i < num; ++i)
+            if (! (values[i] < -1.0e-8f || values[i] > 1.0e-8f))
+                values[i] = 0;
+    }
+}
+
+//==============================================================================
+IIRFilterBank::IIRFilterBank (const int channels, const int sections)
+    : numChannels (jmax (1, channels)),
+      numSections (jmax (1, sections)),
+      numLanes ((numChannels + IIRFilterBankHelpers::numParallel - 1) & ~(IIRFilterBankHelpers::numParallel - 1)),
+      params ((size_t) (numSections * numFields * numLanes), true),
+      rampRemaining ((size_t) numSections, true),
+      receivedCoefficients ((size_t) (numSections * numChannels)),
+      receivedVersion (0),
+      channelPointers ((size_t) numChannels),
+      pendingCoefficients ((size_t) (numSections * numChannels))
+{
+    for (int i = 0; i < numSections; ++i)
+        makeInactive (i);
+
+    receiveCoefficients();
+    clearState (true);
+}
+
+IIRFilterBank::~IIRFilterBank()
+{
+}
+
+//==============================================================================
+void IIRFilterBank::writeCoefficients (int startChannel, int endChannel, int sectionIndex,
+                                       const IIRCoefficients& newCoefficients) noexcept
+{
+    jassert (isPositiveAndBelow (sectionIndex, numSections));
+
+    if (isPositiveAndBelow (sectionIndex, numSections))
+    {
+        const SpinLock::ScopedLockType sl (writeLock);
+
+        // An odd version number tells the audio thread that the coefficients are being
+        // changed, and a change in the number while it's reading them means it has to try again.
+        ++pendingVersion;
+
+        for (int i = startChannel; i < endChannel; ++i)
+            pendingCoefficients[sectionIndex * numChannels + i] = newCoefficients;
+
+        ++pendingVersion;
+    }
+}
+
+void IIRFilterBank::setCoefficients (int sectionIndex, const IIRCoefficients& newCoefficients) noexcept
+{
+    writeCoefficients (0, numChannels, sectionIndex, newCoefficients);
+}
+
+void IIRFilterBank::setCoefficients (int channel, int sectionIndex, const IIRCoefficients& newCoefficients) noexcept
+{
+    jassert (isPositiveAndBelow (channel, numChannels));
+
+    if (isPositiveAndBelow (channel, numChannels))
+        writeCoefficients (channel, channel + 1, sectionIndex, newCoefficients);
+}
+
+void IIRFilterBank::makeInactive (int sectionIndex) noexcept
+{
+    setCoefficients (sectionIndex, IIRCoefficients (1.0, 0.0, 0.0, 1.0, 0.0, 0.0));
+}
+
+IIRCoefficients IIRFilterBank::getCoefficients (int channel, int sectionIndex) const noexcept
+{
+    jassert (isPositiveAndBelow (channel, numChannels) && isPositiveAndBelow (sectionIndex, numSections));
+
+    const SpinLock::ScopedLockType sl (writeLock);
+    return pendingCoefficients[jlimit (0, numSections - 1, sectionIndex) * numChannels + jlimit (0, numChannels - 1, channel)];
+}
+
+void IIRFilterBank::setSmoothingTime (double sampleRate, double rampLengthInSeconds) noexcept
+{
+    jassert (sampleRate > 0 && rampLengthInSeconds >= 0);
+    rampLength = jmax (0, (int) std::floor (rampLengthInSeconds * sampleRate));
+}
+
+void IIRFilterBank::reset() noexcept
+{
+    resetPending = 1;
+}
+
+//==============================================================================
+void IIRFilterBank::receiveCoefficients() noexcept
+{
+    const int version = pendingVersion.get();
+
+    if (version == receivedVersion || (version & 1) != 0)
+        return;
+
+    memcpy (receivedCoefficients, pendingCoefficients, sizeof (IIRCoefficients) * (size_t) (numSections * numChannels));
+
+    // if they were changed while we were copying them, leave it until the next block
+    if (pendingVersion.get() == version)
+    {
+        receivedVersion = version;
+        startRamps();
+    }
+}
+
+void IIRFilterBank::startRamps() noexcept
+{
+    const int numRampSamples = rampLength.get();
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        bool changed = false;
+
+        for (int c = 0; c < numCoefficients; ++c)
+        {
+            float* const current = getParams (section, c);
+            float* const step = getParams (section, stepsOffset + c);
+            float* const target = getParams (section, targetsOffset + c);
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                target[chan] = receivedCoefficients[section * numChannels + chan].coefficients[c];
+
+                if (target[chan] != current[chan])
+                {
+                    changed = true;
+
+                    if (numRampSamples > 0)
+                        step[chan] = (target[chan] - current[chan]) / numRampSamples;
+                    else
+                        current[chan] = target[chan];
+                }
+                else
+                {
+                    step[chan] = 0;
+                }
+            }
+        }
+
+        if (changed)
+            rampRemaining[section] = numRampSamples;
+    }
+}
+
+void IIRFilterBank::clearState (bool jumpToTargets) noexcept
+{
+    for (int section = 0; section < numSections; ++section)
+    {
+        zeromem (getParams (section, state1), sizeof (float) * (size_t) numLanes);
+        zeromem (getParams (section, state2), sizeof (float) * (size_t) numLanes);
+
+        if (jumpToTargets)
+        {
+            for (int c = 0; c < numCoefficients; ++c)
+                memcpy (getParams (section, c), getParams (section, targetsOffset + c), sizeof (float) * (size_t) numLanes);
+
+            rampRemaining[section] = 0;
+        }
+    }
+}
+
+//==============================================================================
+void IIRFilterBank::processSamples (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept
+{
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    // any channels that the buffer doesn't have are processed as silence
+    for (int i = 0; i < numChannels; ++i)
+        channelPointers[i] = i < buffer.getNumChannels() ? buffer.getWritePointer (i, startSample) : nullptr;
+
+    processSamples (channelPointers, numSamples);
+}
+
+void IIRFilterBank::processSamples (float* const* channels, const int numSamples) noexcept
+{
+    using namespace IIRFilterBankHelpers;
+
+    receiveCoefficients();
+
+    if (resetPending.compareAndSetBool (0, 1))
+        clearState (true);
+
+    float interleaved[numParallel * chunkSize];
+    float* sectionParams[numFields];
+
+    for (int group = 0; group < numLanes; group += numParallel)
+    {
+        const int numInGroup = jmin ((int) numParallel, numChannels - group);
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int num = jmin ((int) chunkSize, numSamples - start);
+
+            for (int lane = 0; lane < numParallel; ++lane)
+            {
+                const float* const src = lane < numInGroup ? channels[group + lane] : nullptr;
+
+                if (src != nullptr)
+                    for (int i = 0; i < num; ++i)
+                        interleaved[i * numParallel + lane] = src[start + i];
+                else
+                    for (int i = 0; i < num; ++i)
+                        interleaved[i * numParallel + lane] = 0;
+            }
+
+            for (int section = 0; section < numSections; ++section)
+            {
+                for (int field = 0; field < numFields; ++field)
+                    sectionParams[field] = getParams (section, field) + group;
+
+                const int numToRamp = jlimit (0, num, rampRemaining[section] - start);
+                processSection (sectionParams, interleaved, num, numToRamp);
+
+                // at the end of a ramp, make sure it lands exactly on the target
+                if (numToRamp > 0 && rampRemaining[section] - start <= num)
+                    for (int c = 0; c < numCoefficients; ++c)
+                        memcpy (sectionParams[c], sectionParams[targetsOffset + c], sizeof (float) * numParallel);
+            }
+
+            for (int lane = 0; lane < numInGroup; ++lane)
+            {
+                if (float* const dest = channels[group + lane])
+                    for (int i = 0; i < num; ++i)
+                        dest[start + i] = interleaved[i * numParallel + lane];
+            }
+        }
+    }
+
+    for (int section = 0; section < numSections; ++section)
+    {
+        rampRemaining[section] = jmax (0, rampRemaining[section] - numSamples);
+
+        snapToZero (getParams (section, state1), numLanes);
+        snapToZero (getParams (section, state2), numLanes);
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class IIRFilterBankTests  : public UnitTest
+{
+public:
+    IIRFilterBankTests() : UnitTest ("IIRFilterBank") {}
+
+    static void fillRandomly (Random& r, AudioBuffer<float>& buffer)
+    {
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+            for (int j = 0; j < buffer.getNumSamples(); ++j)
+                buffer.setSample (i, j, r.nextFloat() * 2.0f - 1.0f);
+    }
+
+    static IIRCoefficients createRandomCoefficients (Random& r)
+    {
+        const double sampleRate = 44100.0;
+        const double frequency = 40.0 + r.nextDouble() * 15000.0;
+        const double q = 0.3 + r.nextDouble() * 4.0;
+        const float gain = 0.1f + r.nextFloat() * 4.0f;
+
+        switch (r.nextInt (5))
+        {
+            case 0:  return IIRCoefficients::makeLowPass (sampleRate, frequency);
+            case 1:  return IIRCoefficients::makeHighPass (sampleRate, frequency);
+            case 2:  return IIRCoefficients::makeLowShelf (sampleRate, frequency, q, gain);
+            case 3:  return IIRCoefficients::makeHighShelf (sampleRate, frequency, q, gain);
+            default: return IIRCoefficients::makePeakFilter (sampleRate, frequency, q, gain);
+        }
+    }
+
+    void runTest() override
+    {
+        Random r (getRandom());
+
+        beginTest ("Matches IIRFilter");
+
+        for (int numChannels = 1; numChannels <= 9; numChannels += 4)
+        {
+            const int numSections = 1 + r.nextInt (8);
+            IIRFilterBank bank (numChannels, numSections);
+            OwnedArray<IIRFilter> filters;
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                for (int section = 0; section < numSections; ++section)
+                {
+                    const IIRCoefficients c (createRandomCoefficients (r));
+                    IIRFilter* const filter = filters.add (new IIRFilter());
+                    filter->setCoefficients (c);
+                    bank.setCoefficients (chan, section, c);
+                }
+            }
+
+            AudioBuffer<float> buffer (numChannels, 1000), expected (numChannels, 1000);
+            float maxError = 0;
+
+            for (int block = 0; block < 10; ++block)
+            {
+                const int numSamples = 1 + r.nextInt (1000);
+                fillRandomly (r, buffer);
+                expected.makeCopyOf (buffer);
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                    for (int section = 0; section < numSections; ++section)
+                        filters.getUnchecked (chan * numSections + section)->processSamples (expected.getWritePointer (chan), numSamples);
+
+                bank.processSamples (buffer, 0, numSamples);
+
+                for (int chan = 0; chan < numChannels; ++chan)
+                    for (int i = 0; i < numSamples; ++i)
+                        maxError = jmax (maxError, std::abs (buffer.getSample (chan, i) - expected.getSample (chan, i))
+                                                     / jmax (1.0f, std::abs (expected.getSample (chan, i))));
+            }
+
+            expect (maxError < 1.0e-4f, "Error " + String (maxError));
+        }
+
+        beginTest ("Smoothing");
+        {
+            IIRFilterBank bank (3, 2);
+            bank.setSmoothingTime (1000.0, 0.1);
+            bank.setCoefficients (1, IIRCoefficients (2.0, 0.0, 0.0, 1.0, 0.0, 0.0));
+
+            AudioBuffer<float> buffer (3, 70);
+            bool allCorrect = true;
+
+            // a change of gain from 1 to 2 should be spread evenly over 100 samples
+            for (int block = 0; block < 3; ++block)
+            {
+                for (int chan = 0; chan < 3; ++chan)
+                    FloatVectorOperations::fill (buffer.getWritePointer (chan), 1.0f, 70);
+
+                bank.processSamples (buffer, 0, 70);
+
+                for (int chan = 0; chan < 3; ++chan)
+                {
+                    for (int i = 0; i < 70; ++i)
+                    {
+                        const int pos = block * 70 + i;
+                        const float expected = pos < 100 ? 1.0f + (pos + 1) / 100.0f : 2.0f;
+                        allCorrect = allCorrect && std::abs (buffer.getSample (chan, i) - expected) < 1.0e-4f;
+                    }
+                }
+            }
+
+            expect (allCorrect);
+            expect (bank.getCoefficients (2, 1).coefficients[0] == 2.0f);
+        }
+
+        beginTest ("Denormals");
+        {
+            IIRFilterBank bank (2, 4);
+
+            for (int section = 0; section < 4; ++section)
+                bank.setCoefficients (section, IIRCoefficients::makeLowPass (44100.0, 100.0));
+
+            AudioBuffer<float> buffer (2, 512);
+            buffer.clear();
+            buffer.setSample (0, 0, 1.0f);
+            buffer.setSample (1, 0, -1.0f);
+
+            for (int block = 0; block < 200; ++block)
+            {
+                bank.processSamples (buffer, 0, 512);
+                buffer.clear();
+            }
+
+            // once it has decayed, the output should be exactly zero rather than denormal
+            bank.processSamples (buffer, 0, 512);
+            expect (buffer.getMagnitude (0, 512) == 0.0f);
+        }
+
+        beginTest ("Changing coefficients while processing");
+        {
+            IIRFilterBank bank (4, 8);
+            bank.setSmoothingTime (44100.0, 0.001);
+
+            struct CoefficientChanger  : public Thread
+            {
+                CoefficientChanger (IIRFilterBank& b) : Thread ("IIRFilterBank test"), bank (b) {}
+
+                void run() override
+                {
+                    Random random;
+
+                    while (! threadShouldExit())
+                        bank.setCoefficients (random.nextInt (8), createRandomCoefficients (random));
+                }
+
+                IIRFilterBank& bank;
+            };
+
+            CoefficientChanger changer (bank);
+            changer.startThread();
+
+            AudioBuffer<float> buffer (4, 256);
+            bool allFinite = true;
+
+            for (int block = 0; block < 2000; ++block)
+            {
+                fillRandomly (r, buffer);
+                bank.processSamples (buffer, 0, 256);
+
+                for (int chan = 0; chan < 4; ++chan)
+                    for (int i = 0; i < 256; ++i)
+                        allFinite = allFinite && std::abs (buffer.getSample (chan, i)) < 1.0e6f;
+            }
+
+            changer.stopThread (1000);
+            expect (allFinite);
+        }
+    }
+};
+
+static IIRFilterBankTests iirFilterBankTests;
+
+#endif
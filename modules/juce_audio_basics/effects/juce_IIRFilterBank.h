@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_IIRFILTERBANK_H_INCLUDED
+#define JUCE_IIRFILTERBANK_H_INCLUDED
+
+
+//==============================================================================
+/**
+    A cascade of biquad IIR filters that's applied to a number of channels at once.
+
+    This is equivalent to having a chain of IIRFilter objects for each channel, but
+    the channels are processed in parallel using SIMD instructions, so it's a lot
+    faster for something like a multi-band EQ on a multi-channel signal.
+
+    The filters use the same transposed direct form II structure as IIRFilter, and
+    their state is snapped to zero when it decays into the denormal range.
+
+    The coefficients can be changed from any thread while the audio is being processed.
+    The audio thread never waits for a lock - it picks up the new coefficients at the
+    start of its next block, and if setSmoothingTime() has been used, moves towards them
+    gradually, a little on every sample, to avoid clicks.
+
+    @see IIRFilter, IIRCoefficients
+*/
+class JUCE_API  IIRFilterBank
+{
+public:
+    //==============================================================================
+    /** Creates a filter bank.
+
+        Initially all the sections are inactive, so will pass the signal through
+        unchanged until you give them some coefficients.
+
+        @param numChannels  the number of channels that will be processed
+        @param numSections  the number of biquads that each channel is passed through
+    */
+    IIRFilterBank (int numChannels, int numSections);
+
+    /** Destructor. */
+    ~IIRFilterBank();
+
+    //==============================================================================
+    /** Returns the number of channels that this bank was created for. */
+    int getNumChannels() const noexcept             { return numChannels; }
+
+    /** Returns the number of cascaded sections that this bank was created with. */
+    int getNumSections() const noexcept             { return numSections; }
+
+    //==============================================================================
+    /** Sets the coefficients for one of the sections on all channels.
+        This can be called from any thread.
+    */
+    void setCoefficients (int sectionIndex, const IIRCoefficients& newCoefficients) noexcept;
+
+    /** Sets the coefficients for one of the sections on a single channel.
+        This can be called from any thread.
+    */
+    void setCoefficients (int channel, int sectionIndex, const IIRCoefficients& newCoefficients) noexcept;
+
+    /** Makes one of the sections pass its input through unchanged on all channels. */
+    void makeInactive (int sectionIndex) noexcept;
+
+    /** Returns the coefficients that were most recently set for a section.
+        If smoothing is turned on, the filter may still be moving towards these.
+    */
+    IIRCoefficients getCoefficients (int channel, int sectionIndex) const noexcept;
+
+    /** Sets how long a change of coefficients takes to be fully applied.
+
+        The coefficients move linearly from their old values to the new ones over this
+        time. A length of zero, which is the default, makes changes happen immediately.
+    */
+    void setSmoothingTime (double sampleRate, double rampLengthInSeconds) noexcept;
+
+    //==============================================================================
+    /** Clears the filters' processing pipelines, ready to start a new stream of data.
+        The coefficients aren't changed, and any smoothing that's in progress jumps to
+        its destination. If this is called while audio is being processed, it happens
+        at the start of the next block.
+    */
+    void reset() noexcept;
+
+    /** Filters a set of channels in-place.
+        There must be at least getNumChannels() channels in the array, but any of them
+        can be null, in which case that channel is treated as silent.
+    */
+    void processSamples (float* const* channels, int numSamples) noexcept;
+
+    /** Filters a section of an AudioBuffer in-place.
+        If the buffer has fewer channels than this bank, only those channels are used.
+    */
+    void processSamples (AudioBuffer<float>& buffer, int startSample, int numSamples) noexcept;
+
+private:
+    //==============================================================================
+    // each section has its current coefficients, the per-sample steps and targets for
+    // smoothing them, and its two state variables, each stored for all the channels
+    enum { numCoefficients = 5, stepsOffset = 5, targetsOffset = 10, state1 = 15, state2 = 16, numFields = 17 };
+
+    const int numChannels, numSections, numLanes;
+
+    // These are only touched by the audio thread
+    HeapBlock<float> params;
+    HeapBlock<int> rampRemaining;
+    HeapBlock<IIRCoefficients> receivedCoefficients;
+    int receivedVersion;
+    HeapBlock<float*> channelPointers;
+
+    // These are written by setCoefficients(), which may be on another thread
+    HeapBlock<IIRCoefficients> pendingCoefficients;
+    Atomic<int> pendingVersion, resetPending, rampLength;
+    SpinLock writeLock;
+
+    void receiveCoefficients() noexcept;
+    void startRamps() noexcept;
+    void clearState (bool jumpToTargets) noexcept;
+    void writeCoefficients (int startChannel, int endChannel, int sectionIndex, const IIRCoefficients&) noexcept;
+    float* getParams (int sectionIndex, int field) const noexcept    { return params + (sectionIndex * numFields + field) * numLanes; }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (IIRFilterBank)
+};
+
+
+#endif   // JUCE_IIRFILTERBANK_H_INCLUDED
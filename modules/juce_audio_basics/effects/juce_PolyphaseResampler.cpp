@@ -0,0 +1,631 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace PolyphaseResamplerHelpers
+{
+    struct QualitySettings
+    {
+        int numTaps;            // the filter length when the ratio is 1.0 or less
+        double attenuation;     // the stop-band attenuation in dB, which sets the window shape
+        int numPhases;          // the number of precomputed phases between input samples
+    };
+
+    static QualitySettings getSettings (PolyphaseResampler::Quality quality) noexcept
+    {
+        switch (quality)
+        {
+            case PolyphaseResampler::draftQuality:  { QualitySettings s = { 16,  60.0,  64 };  return s; }
+            case PolyphaseResampler::highQuality:   { QualitySettings s = { 96,  115.0, 1024 }; return s; }
+            case PolyphaseResampler::bestQuality:   { QualitySettings s = { 192, 140.0, 2048 }; return s; }
+            default:                                { QualitySettings s = { 48,  90.0,  256 };  return s; }
+        }
+    }
+
+    // Filters are built for a set of ratios spaced at 1/16th of an octave, and a ratio
+    // uses the next one up, which puts the cut-off a little lower than it strictly needs to be.
+    static int getFilterScaleStep (double ratio) noexcept
+    {
+        return ratio <= 1.0 ? 0 : (int) std::ceil (std::log (ratio) / std::log (2.0) * 16.0 - 1.0e-9);
+    }
+
+    static double getFilterScale (double ratio) noexcept
+    {
+        return std::pow (2.0, getFilterScaleStep (ratio) / 16.0);
+    }
+
+    static int getNumTaps (PolyphaseResampler::Quality quality, double scale) noexcept
+    {
+        return 2 * (int) std::ceil (getSettings (quality).numTaps * 0.5 * scale);
+    }
+
+    // the zeroth-order modified Bessel function of the first kind, for the Kaiser window
+    static double besselI0 (double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        const double halfX = x * 0.5;
+
+        for (int k = 1; k < 100 && term > sum * 1.0e-16; ++k)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    static double sinc (double x) noexcept
+    {
+        if (std::abs (x) < 1.0e-12)
+            return 1.0;
+
+        return std::sin (double_Pi * x) / (double_Pi * x);
+    }
+
+    //==============================================================================
+   #if JUCE_USE_AVX_INTRINSICS
+    static const bool useAVX = SystemStats::hasAVX() && SystemStats::hasAVX2() && SystemStats::hasFMA3();
+
+    static JUCE_AVX_FUNCTION void dotProductsAVX (const float* x, const float* c0, const float* c1, int num,
+                                                  float& result0, float& result1) noexcept
+    {
+        __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+
+        for (int i = 0; i < num; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps (x + i);
+            sum0 = _mm256_fmadd_ps (v, _mm256_loadu_ps (c0 + i), sum0);
+            sum1 = _mm256_fmadd_ps (v, _mm256_loadu_ps (c1 + i), sum1);
+        }
+
+        const __m128 s0 = _mm_add_ps (_mm256_castps256_ps128 (sum0), _mm256_extractf128_ps (sum0, 1));
+        const __m128 s1 = _mm_add_ps (_mm256_castps256_ps128 (sum1), _mm256_extractf128_ps (sum1, 1));
+
+        float totals[8];
+        _mm_storeu_ps (totals, s0);
+        _mm_storeu_ps (totals + 4, s1);
+
+        result0 = (totals[0] + totals[1]) + (totals[2] + totals[3]);
+        result1 = (totals[4] + totals[5]) + (totals[6] + totals[7]);
+    }
+   #endif
+
+    // Finds the dot-products of some input samples with two neighbouring phases of
+    // the filter. num must be a multiple of 8.
+    static void dotProducts (const float* x, const float* c0, const float* c1, int num,
+                             float& result0, float& result1) noexcept
+    {
+       #if JUCE_USE_AVX_INTRINSICS
+        if (useAVX)
+        {
+            dotProductsAVX (x, c0, c1, num, result0, result1);
+            return;
+        }
+       #endif
+
+       #if JUCE_USE_SSE_INTRINSICS
+        __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+
+        for (int i = 0; i < num; i += 4)
+        {
+            const __m128 v = _mm_loadu_ps (x + i);
+            sum0 = _mm_add_ps (sum0, _mm_mul_ps (v, _mm_loadu_ps (c0 + i)));
+            sum1 = _mm_add_ps (sum1, _mm_mul_ps (v, _mm_loadu_ps (c1 + i)));
+        }
+
+        float totals[8];
+        _mm_storeu_ps (totals, sum0);
+        _mm_storeu_ps (totals + 4, sum1);
+
+        result0 = (totals[0] + totals[1]) + (totals[2] + totals[3]);
+        result1 = (totals[4] + totals[5]) + (totals[6] + totals[7]);
+       #else
+        float sum0[4] = { 0 }, sum1[4] = { 0 };
+
+        for (int i = 0; i < num; i += 4)
+        {
+            for (int j = 0; j < 4; ++j)
+            {
+                sum0[j] += x[i + j] * c0[i + j];
+                sum1[j] += x[i + j] * c1[i + j];
+            }
+        }
+
+        result0 = (sum0[0] + sum0[1]) + (sum0[2] + sum0[3]);
+        result1 = (sum1[0] + sum1[1]) + (sum1[2] + sum1[3]);
+       #endif
+    }
+}
+
+//==============================================================================
+/*  The precomputed phases of the filter for one quality setting and cut-off.
+
+    Phase p holds the taps for an output position that lies p / numPhases of the way
+    between two input samples, and there's one extra phase at the end so that positions
+    between the last phase and the next input sample can be interpolated. Each phase
+    is padded with zeros to a multiple of 8 taps for the vector loops.
+*/
+struct PolyphaseResampler::FilterBank  : public ReferenceCountedObject
+{
+    FilterBank (Quality q, double filterScale)
+        : quality (q), scale (filterScale)
+    {
+        using namespace PolyphaseResamplerHelpers;
+        const QualitySettings settings (getSettings (quality));
+
+        numTaps = getNumTaps (quality, scale);
+        numPhases = jmax (16, (int) std::ceil (settings.numPhases / scale));
+        stride = (numTaps + 7) & ~7;
+        coefficients.calloc ((size_t) (stride * (numPhases + 1)));
+
+        // Kaiser's formulae for the transition width and window shape that will give
+        // the attenuation we want with this number of taps
+        const double transitionWidth = (settings.attenuation - 7.95) / (14.36 * settings.numTaps);
+        const double cutoff = (1.0 - transitionWidth) / scale;
+        const double beta = 0.1102 * (settings.attenuation - 8.7);
+        const double windowScale = 1.0 / besselI0 (beta);
+        const double halfLength = numTaps / 2;
+
+        for (int p = 0; p <= numPhases; ++p)
+        {
+            float* const phase = coefficients + p * stride;
+            double total = 0;
+
+            for (int k = 0; k < numTaps; ++k)
+            {
+                const double x = halfLength - 1.0 + p / (double) numPhases - k;
+                const double t = x / halfLength;
+                const double window = std::abs (t) < 1.0 ? besselI0 (beta * std::sqrt (1.0 - t * t)) * windowScale : 0.0;
+                const double value = cutoff * sinc (cutoff * x) * window;
+
+                phase[k] = (float) value;
+                total += value;
+            }
+
+            // normalising each phase keeps the gain at DC exactly 1
+            FloatVectorOperations::multiply (phase, (float) (1.0 / total), numTaps);
+        }
+    }
+
+    const float* getPhase (int index) const noexcept    { return coefficients + index * stride; }
+
+    typedef ReferenceCountedObjectPtr<FilterBank> Ptr;
+
+    static Ptr getShared (Quality quality, double scale)
+    {
+        static CriticalSection lock;
+        static ReferenceCountedArray<FilterBank> cache;
+
+        const ScopedLock sl (lock);
+
+        for (int i = cache.size(); --i >= 0;)
+        {
+            FilterBank* const bank = cache.getObjectPointerUnchecked (i);
+
+            if (bank->quality == quality && bank->scale == scale)
+                return bank;
+
+            // this one isn't being used by any resamplers any more
+            if (bank->getReferenceCount() == 1)
+                cache.remove (i);
+        }
+
+        return cache.add (new FilterBank (quality, scale));
+    }
+
+    const Quality quality;
+    const double scale;
+    int numTaps, numPhases, stride;
+    HeapBlock<float> coefficients;
+
+    JUCE_DECLARE_NON_COPYABLE (FilterBank)
+};
+
+//==============================================================================
+PolyphaseResampler::PolyphaseResampler (const int channels, const Quality q, const double maxRatio)
+    : numChannels (jmax (1, channels)),
+      quality (q),
+      maximumRatio (jmax (1.0, maxRatio)),
+      historySize (PolyphaseResamplerHelpers::getNumTaps (q, PolyphaseResamplerHelpers::getFilterScale (maximumRatio))),
+      subSamplePos (0)
+{
+    currentBank = FilterBank::getShared (quality, 1.0);
+    preparedBanks.add (currentBank);
+
+    workBuffer.setSize (numChannels, historySize + 8);
+    reset();
+}
+
+PolyphaseResampler::~PolyphaseResampler()
+{
+}
+
+double PolyphaseResampler::getStopBandAttenuation (Quality q) noexcept
+{
+    return PolyphaseResamplerHelpers::getSettings (q).attenuation;
+}
+
+int PolyphaseResampler::getLatencyInInputSamples() const noexcept
+{
+    return historySize / 2 + 1;
+}
+
+void PolyphaseResampler::reset() noexcept
+{
+    workBuffer.clear();
+    subSamplePos = 0;
+}
+
+void PolyphaseResampler::prepare (int maximumInputSamples)
+{
+    const int numNeeded = historySize + jmax (0, maximumInputSamples) + 8;
+
+    if (workBuffer.getNumSamples() < numNeeded)
+        workBuffer.setSize (numChannels, numNeeded, true, true);
+}
+
+void PolyphaseResampler::prepareForRatio (double ratio)
+{
+    getBankForRatio (ratio);
+}
+
+void PolyphaseResampler::prepareForRatioRange (double lowestRatio, double highestRatio)
+{
+    using namespace PolyphaseResamplerHelpers;
+
+    const int lastStep = getFilterScaleStep (jmin (highestRatio, maximumRatio));
+
+    for (int step = getFilterScaleStep (lowestRatio); step <= lastStep; ++step)
+        getBankForRatio (std::pow (2.0, step / 16.0));
+}
+
+const PolyphaseResampler::FilterBank& PolyphaseResampler::getBankForRatio (double ratio)
+{
+    jassert (ratio <= maximumRatio); // the resampler wasn't created to handle ratios this high!
+
+    const double scale = PolyphaseResamplerHelpers::getFilterScale (jmin (ratio, maximumRatio));
+
+    if (currentBank->scale != scale)
+    {
+        for (int i = 0; i < preparedBanks.size(); ++i)
+        {
+            if (preparedBanks.getObjectPointerUnchecked (i)->scale == scale)
+            {
+                currentBank = preparedBanks.getObjectPointerUnchecked (i);
+                return *currentBank;
+            }
+        }
+
+        currentBank = FilterBank::getShared (quality, scale);
+        preparedBanks.add (currentBank);
+    }
+
+    return *currentBank;
+}
+
+int PolyphaseResampler::getNumInputSamplesNeeded (double startRatio, double endRatio, int numOutputSamples) const noexcept
+{
+    const double delta = (endRatio - startRatio) / jmax (1, numOutputSamples);
+    double pos = subSamplePos;
+    int numUsed = 0;
+
+    for (int i = 0; i < numOutputSamples; ++i)
+    {
+        pos += startRatio + delta * i;
+        const int wholeSamples = (int) pos;
+        numUsed += wholeSamples;
+        pos -= wholeSamples;
+    }
+
+    return numUsed;
+}
+
+float** PolyphaseResampler::prepareWorkBuffer (const float* const* inputs, int numSamples)
+{
+    // the history is at the start of the work buffer, the new input follows it, and there
+    // are a few zeros after that which the padding on the filter phases can safely overrun into.
+    // The buffer only ever grows, because resizing it while keeping the history would reallocate.
+    prepare (numSamples);
+
+    for (int i = 0; i < numChannels; ++i)
+    {
+        workBuffer.copyFrom (i, historySize, inputs[i], numSamples);
+        workBuffer.clear (i, historySize + numSamples, 8);
+    }
+
+    return workBuffer.getArrayOfWritePointers();
+}
+
+void PolyphaseResampler::keepHistory (int numSamplesUsed) noexcept
+{
+    for (int i = 0; i < numChannels; ++i)
+    {
+        float* const data = workBuffer.getWritePointer (i);
+        memmove (data, data + numSamplesUsed, sizeof (float) * (size_t) historySize);
+    }
+}
+
+void PolyphaseResampler::skipInput (const float* const* inputs, int numSamples)
+{
+    if (numSamples > 0)
+    {
+        prepareWorkBuffer (inputs, numSamples);
+        keepHistory (numSamples);
+    }
+}
+
+int PolyphaseResampler::process (double ratio, const float* const* inputs, float* const* outputs, int numOutputSamples)
+{
+    return process (ratio, ratio, inputs, outputs, numOutputSamples);
+}
+
+int PolyphaseResampler::process (double startRatio, double endRatio,
+                                 const float* const* inputs, float* const* outputs,
+                                 int numOutputSamples)
+{
+    jassert (startRatio > 0 && endRatio > 0);
+
+    if (numOutputSamples <= 0)
+        return 0;
+
+    const int numInputSamples = getNumInputSamplesNeeded (startRatio, endRatio, numOutputSamples);
+    const FilterBank& bank = getBankForRatio (jmax (startRatio, endRatio));
+    float* const* const work = prepareWorkBuffer (inputs, numInputSamples);
+
+    // shorter filters are centred within the history, so the latency is always the same
+    const int tapOffset = (historySize - bank.numTaps) / 2;
+    const double delta = (endRatio - startRatio) / numOutputSamples;
+    double pos = subSamplePos;
+    int index = 0;
+
+    for (int i = 0; i < numOutputSamples; ++i)
+    {
+        const double phasePosition = pos * bank.numPhases;
+        const int phase = jmin ((int) phasePosition, bank.numPhases - 1);
+        const float alpha = (float) (phasePosition - phase);
+        const float* const c0 = bank.getPhase (phase);
+        const float* const c1 = bank.getPhase (phase + 1);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            float y0, y1;
+            PolyphaseResamplerHelpers::dotProducts (work[chan] + index + tapOffset, c0, c1, bank.stride, y0, y1);
+            outputs[chan][i] = y0 + alpha * (y1 - y0);
+        }
+
+        pos += startRatio + delta * i;
+        const int wholeSamples = (int) pos;
+        index += wholeSamples;
+        pos -= wholeSamples;
+    }
+
+    jassert (index == numInputSamples);
+
+    subSamplePos = pos;
+    keepHistory (numInputSamples);
+    return numInputSamples;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PolyphaseResamplerTests  : public UnitTest
+{
+public:
+    PolyphaseResamplerTests() : UnitTest ("PolyphaseResampler") {}
+
+    static double sineAt (double frequency, double inputPosition) noexcept
+    {
+        return std::sin (2.0 * double_Pi * frequency * inputPosition);
+    }
+
+    // Resamples a sine wave in randomly-sized blocks, with the ratio moving between the values in
+    // the ratios array, and returns the level of the difference from an ideal resampled sine, in dB.
+    double resampleSine (PolyphaseResampler& resampler, const Array<double>& ratios,
+                         double frequency, int blocksPerRatio, AudioBuffer<float>& output)
+    {
+        Random r (getRandom());
+        const int numChannels = resampler.getNumChannels();
+        const int latency = resampler.getLatencyInInputSamples();
+
+        HeapBlock<const float*> inputs ((size_t) numChannels);
+        HeapBlock<float*> outputs ((size_t) numChannels);
+        AudioBuffer<float> inputBuffer (numChannels, 1024);
+        output.setSize (numChannels, 1024 * blocksPerRatio * ratios.size());
+        output.clear();
+
+        resampler.reset();
+
+        int inputPos = 0, outputPos = 0;
+        double expectedPos = 0, errorSquared = 0;
+        int numCompared = 0;
+
+        for (int i = 0; i < ratios.size() * blocksPerRatio; ++i)
+        {
+            const double startRatio = ratios [i / blocksPerRatio];
+            const double endRatio = ratios [jmin (ratios.size() - 1, (i + 1) / blocksPerRatio)];
+            const int numOut = 1 + r.nextInt (jmin (200, output.getNumSamples() - outputPos - 1));
+            const int numIn = resampler.getNumInputSamplesNeeded (startRatio, endRatio, numOut);
+
+            inputBuffer.setSize (numChannels, numIn + 1, false, false, true);
+
+            for (int chan = 0; chan < numChannels; ++chan)
+            {
+                for (int j = 0; j < numIn; ++j)
+                    inputBuffer.setSample (chan, j, (float) sineAt (frequency * (chan + 1), inputPos + j));
+
+                inputs[chan] = inputBuffer.getReadPointer (chan);
+                outputs[chan] = output.getWritePointer (chan, outputPos);
+            }
+
+            const int numUsed = resampler.process (startRatio, endRatio, inputs, outputs, numOut);
+            expect (numUsed == numIn);
+
+            for (int j = 0; j < numOut; ++j)
+            {
+                // the first few samples are still affected by the silent history
+                if (expectedPos > 3 * latency)
+                {
+                    for (int chan = 0; chan < numChannels; ++chan)
+                    {
+                        const double error = output.getSample (chan, outputPos + j)
+                                              - sineAt (frequency * (chan + 1), expectedPos - latency);
+                        errorSquared += error * error;
+                        ++numCompared;
+                    }
+                }
+
+                expectedPos += startRatio + (endRatio - startRatio) * j / numOut;
+            }
+
+            inputPos += numIn;
+            outputPos += numOut;
+        }
+
+        expect (numCompared > 0);
+        output.setSize (numChannels, outputPos, true);
+        return Decibels::gainToDecibels (std::sqrt (errorSquared / jmax (1, numCompared)), -300.0);
+    }
+
+    static double getLevel (const AudioBuffer<float>& buffer, int startSample)
+    {
+        double total = 0;
+
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            for (int i = startSample; i < buffer.getNumSamples(); ++i)
+                total += buffer.getSample (chan, i) * buffer.getSample (chan, i);
+
+        return Decibels::gainToDecibels (std::sqrt (total / ((buffer.getNumSamples() - startSample) * buffer.getNumChannels())), -300.0);
+    }
+
+    void runTest() override
+    {
+        const PolyphaseResampler::Quality qualities[] = { PolyphaseResampler::draftQuality, PolyphaseResampler::normalQuality,
+                                                          PolyphaseResampler::highQuality, PolyphaseResampler::bestQuality };
+
+        beginTest ("Stop-band attenuation");
+
+        for (int i = 0; i < numElementsInArray (qualities); ++i)
+        {
+            // a tone which lies above the Nyquist frequency of the output shouldn't alias
+            PolyphaseResampler resampler (1, qualities[i], 2.0);
+            Array<double> ratios;
+            ratios.add (2.0);
+
+            AudioBuffer<float> output;
+            resampleSine (resampler, ratios, 0.4, 20, output);
+
+            const double level = getLevel (output, 500);
+            expect (level < 6.0 - PolyphaseResampler::getStopBandAttenuation (qualities[i]),
+                    "Aliasing level " + String (level) + "dB");
+        }
+
+        beginTest ("Pass-band accuracy");
+
+        for (int i = 0; i < numElementsInArray (qualities); ++i)
+        {
+            const double testRatios[] = { 0.5, 44100.0 / 48000.0, 1.0, 48000.0 / 44100.0, 1.7, 3.3 };
+
+            for (int j = 0; j < numElementsInArray (testRatios); ++j)
+            {
+                PolyphaseResampler resampler (2, qualities[i], 4.0);
+                Array<double> ratios;
+                ratios.add (testRatios[j]);
+
+                AudioBuffer<float> output;
+                const double error = resampleSine (resampler, ratios, 0.02, 30, output);
+
+                expect (error < 6.0 - PolyphaseResampler::getStopBandAttenuation (qualities[i]),
+                        "Error " + String (error) + "dB at ratio " + String (testRatios[j]));
+            }
+        }
+
+        beginTest ("Time-varying ratio");
+
+        for (int i = 0; i < numElementsInArray (qualities); ++i)
+        {
+            PolyphaseResampler resampler (2, qualities[i], 3.0);
+            Array<double> ratios;
+            ratios.add (0.6);
+            ratios.add (2.9);
+            ratios.add (1.0);
+            ratios.add (1.3);
+
+            AudioBuffer<float> output;
+            const double error = resampleSine (resampler, ratios, 0.015, 8, output);
+
+            expect (error < 6.0 - PolyphaseResampler::getStopBandAttenuation (qualities[i]),
+                    "Error " + String (error) + "dB");
+        }
+
+        beginTest ("Removing the latency");
+        {
+            PolyphaseResampler resampler (1, PolyphaseResampler::normalQuality);
+            const int latency = resampler.getLatencyInInputSamples();
+
+            HeapBlock<float> input ((size_t) (latency + 400)), output (400);
+
+            for (int i = 0; i < latency + 400; ++i)
+                input[i] = (float) sineAt (0.01, i);
+
+            const float* inputs[] = { input.getData() };
+            float* outputs[] = { output.getData() };
+
+            resampler.skipInput (inputs, latency);
+            inputs[0] += latency;
+            expect (resampler.process (1.0, inputs, outputs, 400) == 400);
+
+            // once the silence before the start has passed through the filter, the output should match the input
+            for (int i = latency; i < 400; ++i)
+                expect (std::abs (output[i] - input[i]) < 0.001f);
+        }
+
+        beginTest ("Preparing in advance");
+        {
+            Array<double> ratios;
+            ratios.add (0.7);
+            ratios.add (2.4);
+            ratios.add (1.1);
+
+            PolyphaseResampler unprepared (2, PolyphaseResampler::normalQuality, 3.0);
+            PolyphaseResampler prepared (2, PolyphaseResampler::normalQuality, 3.0);
+            prepared.prepare (1024);
+            prepared.prepareForRatioRange (0.5, prepared.getMaximumRatio());
+
+            // the work buffer keeps its size from one block to the next, which mustn't change the results
+            AudioBuffer<float> expected, actual;
+            resampleSine (unprepared, ratios, 0.03, 10, expected);
+            resampleSine (prepared, ratios, 0.03, 10, actual);
+
+            expect (actual.getNumSamples() == expected.getNumSamples());
+
+            for (int chan = 0; chan < 2; ++chan)
+                expect (memcmp (actual.getReadPointer (chan), expected.getReadPointer (chan),
+                                sizeof (float) * (size_t) expected.getNumSamples()) == 0);
+        }
+    }
+};
+
+static PolyphaseResamplerTests polyphaseResamplerTests;
+
+#endif
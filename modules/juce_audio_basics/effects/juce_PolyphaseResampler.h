@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_POLYPHASERESAMPLER_H_INCLUDED
+#define JUCE_POLYPHASERESAMPLER_H_INCLUDED
+
+
+//==============================================================================
+/**
+    A band-limited sample-rate converter which uses a bank of windowed-sinc filters.
+
+    Unlike the LagrangeInterpolator and CatmullRomInterpolator, this filters out
+    everything above the new Nyquist frequency when it's reducing the sample rate,
+    so it's suitable for high quality conversions between arbitrary rates. The
+    resampling ratio can be changed from one block to the next, and can also be made
+    to glide smoothly from one value to another across a block.
+
+    The filters are built from a Kaiser-windowed sinc prototype, and are precomputed as
+    a polyphase bank, with the coefficients for positions in between the phases
+    being interpolated. Banks are shared between all the resamplers that use the
+    same settings, and the inner loops use SSE or AVX where they're available.
+
+    The filter is centred on the output position, so the output is delayed by
+    getLatencyInInputSamples() compared to the input. If this matters, you can feed
+    that many samples to skipInput() before you start, which will line up the first
+    output sample with the first input sample.
+
+    When the ratio is greater than 1.0, the filter has to be made longer to lower its
+    cut-off frequency. Filters for ratios that haven't been used before are built on
+    demand, and the space for the input grows to fit the largest block so far, both of
+    which allocate memory. If you're using this on the audio thread, call prepare() and
+    prepareForRatio() or prepareForRatioRange() beforehand.
+
+    @see PolyphaseResamplingAudioSource, LagrangeInterpolator
+*/
+class JUCE_API  PolyphaseResampler
+{
+public:
+    //==============================================================================
+    /** The available trade-offs between CPU and quality. */
+    enum Quality
+    {
+        draftQuality = 0,   /**< 16 taps, about 60dB of stop-band attenuation */
+        normalQuality,      /**< 48 taps, about 90dB of stop-band attenuation */
+        highQuality,        /**< 96 taps, about 115dB of stop-band attenuation */
+        bestQuality         /**< 192 taps, about 140dB of stop-band attenuation */
+    };
+
+    /** Creates a resampler.
+
+        @param numChannels      the number of channels that will be processed
+        @param quality          the type of filter to use
+        @param maximumRatio     the largest ratio of input to output samples that will
+                                be used. This determines the length of the filter history
+                                and so the latency, so don't make it bigger than you need
+    */
+    PolyphaseResampler (int numChannels, Quality quality = normalQuality, double maximumRatio = 4.0);
+
+    /** Destructor. */
+    ~PolyphaseResampler();
+
+    //==============================================================================
+    /** Returns the number of channels that this resampler was created for. */
+    int getNumChannels() const noexcept                     { return numChannels; }
+
+    /** Returns the quality setting that this resampler was created with. */
+    Quality getQuality() const noexcept                     { return quality; }
+
+    /** Returns the largest ratio that this resampler can handle. */
+    double getMaximumRatio() const noexcept                 { return maximumRatio; }
+
+    /** Returns the stop-band attenuation, in decibels, that a quality setting is designed for. */
+    static double getStopBandAttenuation (Quality) noexcept;
+
+    /** Returns the delay between the input and output, measured in input samples. */
+    int getLatencyInInputSamples() const noexcept;
+
+    //==============================================================================
+    /** Clears the filter history.
+        Call this when there's a break in the continuity of the input.
+    */
+    void reset() noexcept;
+
+    /** Allocates enough space for blocks that use up to the given number of input samples.
+        After this, process() and skipInput() won't need to allocate any memory for blocks
+        of that size, as long as the filters they need have also been prepared.
+        @see getNumInputSamplesNeeded, prepareForRatio
+    */
+    void prepare (int maximumInputSamples);
+
+    /** Makes sure that the filter needed for a particular ratio has been built, so that
+        process() won't need to build it. This doesn't make room for the input, which
+        is done by prepare().
+    */
+    void prepareForRatio (double ratio);
+
+    /** Builds all of the filters that could be needed for ratios between these two values.
+
+        Each filter takes about the same amount of memory, and there's one for every
+        1/16th of an octave above a ratio of 1.0, so preparing a wide range of ratios
+        at the higher qualities can use quite a lot of memory.
+    */
+    void prepareForRatioRange (double lowestRatio, double highestRatio);
+
+    /** Returns the number of input samples that process() will use to produce a block
+        of output, if the ratio moves from startRatio to endRatio across the block.
+    */
+    int getNumInputSamplesNeeded (double startRatio, double endRatio, int numOutputSamples) const noexcept;
+
+    /** Resamples a block of audio.
+
+        The ratio is the number of input samples for each output sample, so values above
+        1.0 will lower the sample rate. It moves linearly from startRatio for the first
+        output sample towards endRatio, which will be reached at the start of the next
+        block, so if you keep passing the previous block's endRatio as the next block's
+        startRatio, the ratio changes smoothly.
+
+        @param startRatio           the ratio at the start of the block
+        @param endRatio             the ratio at the end of the block
+        @param inputs               one array of input samples for each channel. Each must
+                                    contain the number of samples returned by
+                                    getNumInputSamplesNeeded() for the same arguments
+        @param outputs              one array for each channel to write the results into
+        @param numOutputSamples     the number of output samples to produce
+
+        @returns the number of input samples that were used
+    */
+    int process (double startRatio, double endRatio,
+                 const float* const* inputs,
+                 float* const* outputs,
+                 int numOutputSamples);
+
+    /** Resamples a block of audio with a fixed ratio.
+        @see process
+    */
+    int process (double ratio,
+                 const float* const* inputs,
+                 float* const* outputs,
+                 int numOutputSamples);
+
+    /** Feeds some input into the filter's history without producing any output.
+        Passing the first getLatencyInInputSamples() samples of a stream to this will
+        remove the delay between the input and output.
+    */
+    void skipInput (const float* const* inputs, int numSamples);
+
+private:
+    //==============================================================================
+    struct FilterBank;
+
+    const int numChannels;
+    const Quality quality;
+    const double maximumRatio;
+    const int historySize;
+    ReferenceCountedObjectPtr<FilterBank> currentBank;
+    ReferenceCountedArray<FilterBank> preparedBanks;
+    AudioBuffer<float> workBuffer;
+    double subSamplePos;
+
+    const FilterBank& getBankForRatio (double ratio);
+    float** prepareWorkBuffer (const float* const* inputs, int numSamples);
+    void keepHistory (int numSamplesUsed) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResampler)
+};
+
+
+#endif   // JUCE_POLYPHASERESAMPLER_H_INCLUDED
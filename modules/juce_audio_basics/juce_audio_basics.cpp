@@ -31,28 +31,14 @@
  #error "Incorrect use of JUCE cpp file"
 #endif
 
-#include "juce_audio_basics.h"
+#define JUCE_CORE_INCLUDE_SIMD_HEADERS 1
 
-#if JUCE_MINGW && ! defined (__SSE2__)
- #define JUCE_USE_SSE_INTRINSICS 0
-#endif
+#include "juce_audio_basics.h"
 
 #if JUCE_MINGW && ! defined (alloca)
  #define alloca __builtin_alloca
 #endif
 
-#ifndef JUCE_USE_SSE_INTRINSICS
- #define JUCE_USE_SSE_INTRINSICS 1
-#endif
-
-#if ! JUCE_INTEL
- #undef JUCE_USE_SSE_INTRINSICS
-#endif
-
-#if JUCE_USE_SSE_INTRINSICS
- #include <emmintrin.h>
-#endif
-
 #ifndef JUCE_USE_VDSP_FRAMEWORK
  #define JUCE_USE_VDSP_FRAMEWORK 1
 #endif
@@ -84,9 +70,12 @@ namespace juce
 #include "buffers/juce_AudioDataConverters.cpp"
 #include "buffers/juce_FloatVectorOperations.cpp"
 #include "effects/juce_IIRFilter.cpp"
+#include "effects/juce_IIRFilterBank.cpp"
 #include "effects/juce_LagrangeInterpolator.cpp"
 #include "effects/juce_CatmullRomInterpolator.cpp"
 #include "effects/juce_FFT.cpp"
+#include "effects/juce_Convolution.cpp"
+#include "effects/juce_PolyphaseResampler.cpp"
 #include "midi/juce_MidiBuffer.cpp"
 #include "midi/juce_MidiFile.cpp"
 #include "midi/juce_MidiKeyboardState.cpp"
@@ -104,11 +93,15 @@ namespace juce
 #include "mpe/juce_MPESynthesiser.cpp"
 #include "sources/juce_BufferingAudioSource.cpp"
 #include "sources/juce_ChannelRemappingAudioSource.cpp"
+#include "sources/juce_ConvolutionAudioSource.cpp"
 #include "sources/juce_IIRFilterAudioSource.cpp"
 #include "sources/juce_MixerAudioSource.cpp"
+#include "sources/juce_PolyphaseResamplingAudioSource.cpp"
+#include "sources/juce_ReadAheadScheduler.cpp"
 #include "sources/juce_ResamplingAudioSource.cpp"
 #include "sources/juce_ReverbAudioSource.cpp"
 #include "sources/juce_ToneGeneratorAudioSource.cpp"
+#include "synthesisers/juce_ParallelVoiceRenderer.cpp"
 #include "synthesisers/juce_Synthesiser.cpp"
 
 }
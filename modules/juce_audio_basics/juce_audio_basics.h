@@ -64,9 +64,12 @@ namespace juce
 #include "buffers/juce_AudioSampleBuffer.h"
 #include "effects/juce_Decibels.h"
 #include "effects/juce_IIRFilter.h"
+#include "effects/juce_IIRFilterBank.h"
 #include "effects/juce_LagrangeInterpolator.h"
 #include "effects/juce_CatmullRomInterpolator.h"
 #include "effects/juce_FFT.h"
+#include "effects/juce_Convolution.h"
+#include "effects/juce_PolyphaseResampler.h"
 #include "effects/juce_LinearSmoothedValue.h"
 #include "effects/juce_Reverb.h"
 #include "midi/juce_MidiMessage.h"
@@ -81,15 +84,19 @@ namespace juce
 #include "mpe/juce_MPEZoneLayout.h"
 #include "mpe/juce_MPEInstrument.h"
 #include "mpe/juce_MPEMessages.h"
+#include "synthesisers/juce_ParallelVoiceRenderer.h"
 #include "mpe/juce_MPESynthesiserBase.h"
 #include "mpe/juce_MPESynthesiserVoice.h"
 #include "mpe/juce_MPESynthesiser.h"
 #include "sources/juce_AudioSource.h"
 #include "sources/juce_PositionableAudioSource.h"
+#include "sources/juce_ReadAheadScheduler.h"
 #include "sources/juce_BufferingAudioSource.h"
 #include "sources/juce_ChannelRemappingAudioSource.h"
+#include "sources/juce_ConvolutionAudioSource.h"
 #include "sources/juce_IIRFilterAudioSource.h"
 #include "sources/juce_MixerAudioSource.h"
+#include "sources/juce_PolyphaseResamplingAudioSource.h"
 #include "sources/juce_ResamplingAudioSource.h"
 #include "sources/juce_ReverbAudioSource.h"
 #include "sources/juce_ToneGeneratorAudioSource.h"
@@ -333,8 +333,45 @@ void MPESynthesiser::turnOffAllVoices (bool allowTailOff)
 }
 
 //==============================================================================
+struct MPESynthesiserVoiceRenderList  : public ParallelVoiceRenderer::VoiceList
+{
+    MPESynthesiserVoiceRenderList (const OwnedArray<MPESynthesiserVoice>& v) noexcept  : voices (v) {}
+
+    int getNumVoices() const override                   { return voices.size(); }
+    bool isVoiceActive (int index) const override       { return voices.getUnchecked (index)->isActive(); }
+
+    void renderVoice (int index, AudioBuffer<float>& buffer, int startSample, int numSamples) override
+    {
+        MPESynthesiserVoice* voice = voices.getUnchecked (index);
+
+        if (voice->isActive())
+            voice->renderNextBlock (buffer, startSample, numSamples);
+    }
+
+    void renderVoice (int index, AudioBuffer<double>& buffer, int startSample, int numSamples) override
+    {
+        MPESynthesiserVoice* voice = voices.getUnchecked (index);
+
+        if (voice->isActive())
+            voice->renderNextBlock (buffer, startSample, numSamples);
+    }
+
+    const OwnedArray<MPESynthesiserVoice>& voices;
+
+    JUCE_DECLARE_NON_COPYABLE (MPESynthesiserVoiceRenderList)
+};
+
 void MPESynthesiser::renderNextSubBlock (AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
+    const ScopedLock sl (voicesLock);
+
+    if (parallelRenderer != nullptr)
+    {
+        MPESynthesiserVoiceRenderList voiceList (voices);
+        parallelRenderer->render (voiceList, buffer, startSample, numSamples);
+        return;
+    }
+
     for (int i = voices.size(); --i >= 0;)
     {
         MPESynthesiserVoice* voice = voices.getUnchecked (i);
@@ -346,6 +383,15 @@ void MPESynthesiser::renderNextSubBlock (AudioBuffer<float>& buffer, int startSa
 
 void MPESynthesiser::renderNextSubBlock (AudioBuffer<double>& buffer, int startSample, int numSamples)
 {
+    const ScopedLock sl (voicesLock);
+
+    if (parallelRenderer != nullptr)
+    {
+        MPESynthesiserVoiceRenderList voiceList (voices);
+        parallelRenderer->render (voiceList, buffer, startSample, numSamples);
+        return;
+    }
+
     for (int i = voices.size(); --i >= 0;)
     {
         MPESynthesiserVoice* voice = voices.getUnchecked (i);
@@ -354,3 +400,25 @@ void MPESynthesiser::renderNextSubBlock (AudioBuffer<double>& buffer, int startS
             voice->renderNextBlock (buffer, startSample, numSamples);
     }
 }
+
+//==============================================================================
+void MPESynthesiser::setNumRenderingThreads (int numThreads)
+{
+    numThreads = jmax (1, numThreads);
+
+    if (numThreads != getNumRenderingThreads())
+    {
+        ScopedPointer<ParallelVoiceRenderer> newRenderer (numThreads > 1 ? new ParallelVoiceRenderer (numThreads)
+                                                                         : nullptr);
+
+        {
+            const ScopedLock sl (voicesLock);
+            parallelRenderer.swapWith (newRenderer);
+        }
+    }
+}
+
+int MPESynthesiser::getNumRenderingThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 1;
+}
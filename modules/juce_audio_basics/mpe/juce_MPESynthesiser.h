@@ -175,6 +175,26 @@ public:
     virtual void handleProgramChange (int /*midiChannel*/,
                                       int /*programNumber*/) {}
 
+    //==============================================================================
+    /** Lets the synthesiser render its voices on several threads at once.
+
+        If you set this to a value greater than 1, the synth will start (numThreads - 1)
+        realtime-priority worker threads, and renderNextSubBlock() will share out the active
+        voices between these and the thread that's calling renderNextBlock(). The MPE messages
+        are still handled between the sub-blocks in the same way, so the timing is unaffected.
+
+        Your voices' renderNextBlock() methods must be safe to call at the same time as
+        each other for this to work.
+
+        @see getNumRenderingThreads, ParallelVoiceRenderer
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    /** Returns the number of threads that the synth is using to render its voices.
+        @see setNumRenderingThreads
+    */
+    int getNumRenderingThreads() const noexcept;
+
 protected:
     //==============================================================================
     /** Attempts to start playing a new note.
@@ -240,7 +260,9 @@ protected:
 
     //==============================================================================
     /** This will simply call renderNextBlock for each currently active
-        voice and fill the buffer with the sum.
+        voice and fill the buffer with the sum. If more than one rendering thread
+        has been set with setNumRenderingThreads(), the voices are shared out
+        between the threads.
         Override this method if you need to do more work to render your audio.
     */
     virtual void renderNextSubBlock (AudioBuffer<float>& outputAudio,
@@ -248,7 +270,7 @@ protected:
                                      int numSamples) override;
 
     /** This will simply call renderNextBlock for each currently active
-        voice and fill the buffer with the sum. (souble-precision version)
+        voice and fill the buffer with the sum. (double-precision version)
         Override this method if you need to do more work to render your audio.
     */
     virtual void renderNextSubBlock (AudioBuffer<double>& outputAudio,
@@ -305,6 +327,7 @@ private:
     //==============================================================================
     bool shouldStealVoices;
     CriticalSection voicesLock;
+    ScopedPointer<ParallelVoiceRenderer> parallelRenderer;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MPESynthesiser)
 };
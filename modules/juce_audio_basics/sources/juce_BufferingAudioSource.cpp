@@ -28,12 +28,10 @@ BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
                                             const int bufferSizeSamples,
                                             const int numChannels)
     : source (s, deleteSourceWhenDeleted),
-      backgroundThread (thread),
+      backgroundThread (&thread),
+      scheduler (nullptr),
       numberOfSamplesToBuffer (jmax (1024, bufferSizeSamples)),
       numberOfChannels (numChannels),
-      bufferValidStart (0),
-      bufferValidEnd (0),
-      nextPlayPos (0),
       sampleRate (0),
       wasSourceLooping (false),
       isPrepared (false)
@@ -42,6 +40,28 @@ BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
 
     jassert (numberOfSamplesToBuffer > 1024); // not much point using this class if you're
                                               //  not using a larger buffer..
+    resetStatistics();
+}
+
+BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
+                                            ReadAheadScheduler& sched,
+                                            const bool deleteSourceWhenDeleted,
+                                            const int bufferSizeSamples,
+                                            const int numChannels)
+    : source (s, deleteSourceWhenDeleted),
+      backgroundThread (nullptr),
+      scheduler (&sched),
+      numberOfSamplesToBuffer (jmax (1024, bufferSizeSamples)),
+      numberOfChannels (numChannels),
+      sampleRate (0),
+      wasSourceLooping (false),
+      isPrepared (false)
+{
+    jassert (source != nullptr);
+
+    jassert (numberOfSamplesToBuffer > 1024); // not much point using this class if you're
+                                              //  not using a larger buffer..
+    resetStatistics();
 }
 
 BufferingAudioSource::~BufferingAudioSource()
@@ -58,7 +78,7 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
          || bufferSizeNeeded != buffer.getNumSamples()
          || ! isPrepared)
     {
-        backgroundThread.removeTimeSliceClient (this);
+        stopReadAhead();
 
         isPrepared = true;
         sampleRate = newSampleRate;
@@ -71,12 +91,16 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
         bufferValidStart = 0;
         bufferValidEnd = 0;
 
-        backgroundThread.addTimeSliceClient (this);
+        startReadAhead();
 
-        while (bufferValidEnd - bufferValidStart < jmin (((int) newSampleRate) / 4,
-                                                         buffer.getNumSamples() / 2))
+        while (bufferValidEnd.get() - bufferValidStart.get() < jmin (((int) newSampleRate) / 4,
+                                                                     buffer.getNumSamples() / 2))
         {
-            backgroundThread.moveToFrontOfQueue (this);
+            if (backgroundThread != nullptr)
+                backgroundThread->moveToFrontOfQueue (this);
+            else
+                scheduler->wakeUp();
+
             Thread::sleep (5);
         }
     }
@@ -85,18 +109,40 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
 void BufferingAudioSource::releaseResources()
 {
     isPrepared = false;
-    backgroundThread.removeTimeSliceClient (this);
+    stopReadAhead();
 
     buffer.setSize (numberOfChannels, 0);
     source->releaseResources();
 }
 
+void BufferingAudioSource::startReadAhead()
+{
+    if (backgroundThread != nullptr)
+        backgroundThread->addTimeSliceClient (this);
+    else
+        scheduler->addSource (this);
+}
+
+void BufferingAudioSource::stopReadAhead()
+{
+    if (backgroundThread != nullptr)
+        backgroundThread->removeTimeSliceClient (this);
+    else
+        scheduler->removeSource (this);
+}
+
 void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
-    const ScopedLock sl (bufferStartPosLock);
+    // The background thread publishes a new valid start before it overwrites anything, and
+    // only overwrites the parts of the buffer that lie before it, so the data can be copied
+    // without taking a lock and then checked afterwards, in the same way as a seqlock.
+    const int rangeResetsBeforeCopy = numRangeResets.get();
+    const int64 playPos = nextPlayPos.get();
+    const int64 validStartPos = bufferValidStart.get();
+    const int64 validEndPos = bufferValidEnd.get();
 
-    const int validStart = (int) (jlimit (bufferValidStart, bufferValidEnd, nextPlayPos) - nextPlayPos);
-    const int validEnd   = (int) (jlimit (bufferValidStart, bufferValidEnd, nextPlayPos + info.numSamples) - nextPlayPos);
+    const int validStart = (int) (jlimit (validStartPos, validEndPos, playPos) - playPos);
+    int validEnd         = (int) (jlimit (validStartPos, validEndPos, playPos + info.numSamples) - playPos);
 
     if (validStart == validEnd)
     {
@@ -117,8 +163,8 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
             for (int chan = jmin (numberOfChannels, info.buffer->getNumChannels()); --chan >= 0;)
             {
                 jassert (buffer.getNumSamples() > 0);
-                const int startBufferIndex = (int) ((validStart + nextPlayPos) % buffer.getNumSamples());
-                const int endBufferIndex   = (int) ((validEnd + nextPlayPos)   % buffer.getNumSamples());
+                const int startBufferIndex = (int) ((validStart + playPos) % buffer.getNumSamples());
+                const int endBufferIndex   = (int) ((validEnd + playPos)   % buffer.getNumSamples());
 
                 if (startBufferIndex < endBufferIndex)
                 {
@@ -144,76 +190,105 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
             }
         }
 
-        nextPlayPos += info.numSamples;
+        // If the range has been reset since the copy began (e.g. after a seek), or its start has
+        // moved past the data that was copied, that data may have been overwritten part-way through.
+        if (numRangeResets.get() != rangeResetsBeforeCopy
+             || bufferValidStart.get() > playPos + validStart)
+        {
+            info.clearActiveBufferRegion();
+            validEnd = validStart;
+        }
+
+        // if setNextReadPosition() was called while we were busy, that position wins
+        nextPlayPos.compareAndSetBool (playPos + info.numSamples, playPos);
+    }
+
+    if (isPrepared && validEnd - validStart < info.numSamples)
+    {
+        ++numUnderruns;
+        numSamplesMissed += info.numSamples - (validEnd - validStart);
     }
 }
 
 int64 BufferingAudioSource::getNextReadPosition() const
 {
     jassert (source->getTotalLength() > 0);
-    return (source->isLooping() && nextPlayPos > 0)
-                    ? nextPlayPos % source->getTotalLength()
-                    : nextPlayPos;
+    const int64 playPos = nextPlayPos.get();
+
+    return (source->isLooping() && playPos > 0)
+                    ? playPos % source->getTotalLength()
+                    : playPos;
 }
 
 void BufferingAudioSource::setNextReadPosition (int64 newPosition)
 {
-    const ScopedLock sl (bufferStartPosLock);
-
     nextPlayPos = newPosition;
-    backgroundThread.moveToFrontOfQueue (this);
+
+    if (backgroundThread != nullptr)
+        backgroundThread->moveToFrontOfQueue (this);
+    else
+        scheduler->wakeUp();
 }
 
-bool BufferingAudioSource::readNextBufferChunk()
+int64 BufferingAudioSource::getNumSamplesBuffered() const noexcept
 {
-    int64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
+    return bufferValidEnd.get() - jmax ((int64) 0, nextPlayPos.get());
+}
 
-    {
-        const ScopedLock sl (bufferStartPosLock);
+bool BufferingAudioSource::readNextBufferChunk (const int minimumChunkSize, const int maximumChunkSize)
+{
+    const int bufferSize = buffer.getNumSamples();
 
-        if (wasSourceLooping != isLooping())
-        {
-            wasSourceLooping = isLooping();
-            bufferValidStart = 0;
-            bufferValidEnd = 0;
-        }
+    if (bufferSize <= 0)
+        return false;
 
-        newBVS = jmax ((int64) 0, nextPlayPos);
-        newBVE = newBVS + buffer.getNumSamples() - 4;
-        sectionToReadStart = 0;
-        sectionToReadEnd = 0;
+    const int64 playPos = jmax ((int64) 0, nextPlayPos.get());
+    int64 newBVS = bufferValidStart.get();
+    int64 newBVE = bufferValidEnd.get();
+    const int64 headroom = newBVE - playPos;
+    bool mustRead = (newBVS == newBVE);
+    bool isReset = false;
 
-        const int maxChunkSize = 2048;
+    if (wasSourceLooping != isLooping())
+    {
+        wasSourceLooping = isLooping();
+        newBVS = newBVE = playPos;
+        mustRead = isReset = true;
+    }
 
-        if (newBVS < bufferValidStart || newBVS >= bufferValidEnd)
-        {
-            newBVE = jmin (newBVE, newBVS + maxChunkSize);
+    if (playPos < newBVS || playPos >= newBVE)
+    {
+        newBVS = newBVE = playPos;
+        mustRead = isReset = true;
+    }
+    else
+    {
+        newBVS = playPos;
+    }
 
-            sectionToReadStart = newBVS;
-            sectionToReadEnd = newBVE;
+    const int64 sectionToReadStart = newBVE;
+    const int64 sectionToReadEnd = jmin (newBVS + bufferSize - 4, newBVE + maximumChunkSize);
 
-            bufferValidStart = 0;
-            bufferValidEnd = 0;
-        }
-        else if (std::abs ((int) (newBVS - bufferValidStart)) > 512
-                  || std::abs ((int) (newBVE - bufferValidEnd)) > 512)
-        {
-            newBVE = jmin (newBVE, bufferValidEnd + maxChunkSize);
+    if (sectionToReadEnd <= sectionToReadStart
+         || (sectionToReadEnd - sectionToReadStart < minimumChunkSize && ! mustRead))
+        return false;
 
-            sectionToReadStart = bufferValidEnd;
-            sectionToReadEnd = newBVE;
+    // Moving the valid start forward first means the audio thread will ignore the part of the
+    // buffer that's about to be overwritten. A reset can move it backwards, so that's counted
+    // too, after the new range has been published, to make any copy in progress discard its data.
+    bufferValidStart = newBVS;
+    bufferValidEnd = newBVE;
 
-            bufferValidStart = newBVS;
-            bufferValidEnd = jmin (bufferValidEnd, newBVE);
-        }
-    }
+    if (isReset)
+        ++numRangeResets;
 
-    if (sectionToReadStart == sectionToReadEnd)
-        return false;
+    if (! mustRead)
+        minimumHeadroom = jmin (minimumHeadroom.get(), headroom);
 
-    jassert (buffer.getNumSamples() > 0);
-    const int bufferIndexStart = (int) (sectionToReadStart % buffer.getNumSamples());
-    const int bufferIndexEnd   = (int) (sectionToReadEnd   % buffer.getNumSamples());
+    const int64 readStartTicks = Time::getHighResolutionTicks();
+
+    const int bufferIndexStart = (int) (sectionToReadStart % bufferSize);
+    const int bufferIndexEnd   = (int) (sectionToReadEnd   % bufferSize);
 
     if (bufferIndexStart < bufferIndexEnd)
     {
@@ -223,7 +298,7 @@ bool BufferingAudioSource::readNextBufferChunk()
     }
     else
     {
-        const int initialSize = buffer.getNumSamples() - bufferIndexStart;
+        const int initialSize = bufferSize - bufferIndexStart;
 
         readBufferSection (sectionToReadStart,
                            initialSize,
@@ -234,12 +309,13 @@ bool BufferingAudioSource::readNextBufferChunk()
                            0);
     }
 
-    {
-        const ScopedLock sl2 (bufferStartPosLock);
+    bufferValidEnd = sectionToReadEnd;
 
-        bufferValidStart = newBVS;
-        bufferValidEnd = newBVE;
-    }
+    const int64 readTimeMicroseconds = (int64) (1.0e6 * Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks()
+                                                                                             - readStartTicks));
+    maximumReadTime = jmax (maximumReadTime.get(), readTimeMicroseconds);
+    ++numReads;
+    numSamplesRead += sectionToReadEnd - sectionToReadStart;
 
     return true;
 }
@@ -255,5 +331,32 @@ void BufferingAudioSource::readBufferSection (const int64 start, const int lengt
 
 int BufferingAudioSource::useTimeSlice()
 {
-    return readNextBufferChunk() ? 1 : 100;
+    return readNextBufferChunk (512, 2048) ? 1 : 100;
+}
+
+//==============================================================================
+BufferingAudioSource::Statistics BufferingAudioSource::getStatistics() const noexcept
+{
+    Statistics stats;
+    stats.numUnderruns     = numUnderruns.get();
+    stats.numSamplesMissed = numSamplesMissed.get();
+    stats.numReads         = numReads.get();
+    stats.numSamplesRead   = numSamplesRead.get();
+
+    const int64 headroom = minimumHeadroom.get();
+    stats.minimumHeadroomSeconds = (headroom == std::numeric_limits<int64>::max() || sampleRate <= 0)
+                                     ? 0.0 : headroom / sampleRate;
+
+    stats.maximumReadTimeMs = maximumReadTime.get() / 1000.0;
+    return stats;
+}
+
+void BufferingAudioSource::resetStatistics() noexcept
+{
+    numUnderruns = 0;
+    numSamplesMissed = 0;
+    numReads = 0;
+    numSamplesRead = 0;
+    minimumHeadroom = std::numeric_limits<int64>::max();
+    maximumReadTime = 0;
 }
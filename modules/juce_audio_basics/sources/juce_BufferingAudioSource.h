@@ -34,7 +34,16 @@
     a background thread to smooth out playback. You can either create one of these
     directly, or use it indirectly using an AudioTransportSource.
 
-    @see PositionableAudioSource, AudioTransportSource
+    The read-ahead can be done either by a TimeSliceThread, which serves its clients
+    in turn, or by a ReadAheadScheduler, which always refills whichever of its sources
+    is closest to running out of data. If you're playing a lot of sources at once,
+    the scheduler will cope much better.
+
+    The audio thread never has to wait for the background thread: if the data it
+    needs hasn't been read yet, it plays silence, and the problem is recorded in the
+    source's statistics.
+
+    @see PositionableAudioSource, AudioTransportSource, ReadAheadScheduler
 */
 class JUCE_API  BufferingAudioSource  : public PositionableAudioSource,
                                         private TimeSliceClient
@@ -59,6 +68,23 @@ public:
                           int numberOfSamplesToBuffer,
                           int numberOfChannels = 2);
 
+    /** Creates a BufferingAudioSource which is refilled by a ReadAheadScheduler.
+
+        @param source                   the input source to read from
+        @param scheduler                the scheduler that will do the background read-ahead.
+                                        This object must not be deleted until after any
+                                        BufferingAudioSources that are using it have been deleted!
+        @param deleteSourceWhenDeleted  if true, then the input source object will
+                                        be deleted when this object is deleted
+        @param numberOfSamplesToBuffer  the size of buffer to use for reading ahead
+        @param numberOfChannels         the number of channels that will be played
+    */
+    BufferingAudioSource (PositionableAudioSource* source,
+                          ReadAheadScheduler& scheduler,
+                          bool deleteSourceWhenDeleted,
+                          int numberOfSamplesToBuffer,
+                          int numberOfChannels = 2);
+
     /** Destructor.
 
         The input source may be deleted depending on whether the deleteSourceWhenDeleted
@@ -89,19 +115,59 @@ public:
     /** Implements the PositionableAudioSource method. */
     bool isLooping() const override             { return source->isLooping(); }
 
+    //==============================================================================
+    /** Some counters that show how well the read-ahead is keeping up with playback. */
+    struct Statistics
+    {
+        /** The number of blocks which couldn't be fully played because the data wasn't ready. */
+        int numUnderruns;
+
+        /** The number of samples that had to be replaced with silence. */
+        int64 numSamplesMissed;
+
+        /** The number of times the buffer has been refilled. */
+        int numReads;
+
+        /** The total number of samples read from the input source. */
+        int64 numSamplesRead;
+
+        /** The smallest amount of buffered audio that was left when a refill began, in seconds.
+            This shows how close the source has come to running dry.
+        */
+        double minimumHeadroomSeconds;
+
+        /** The longest time that a single refill has taken, in milliseconds. */
+        double maximumReadTimeMs;
+    };
+
+    /** Returns the current statistics. This can be called from any thread. */
+    Statistics getStatistics() const noexcept;
+
+    /** Sets all the statistics back to their initial state. */
+    void resetStatistics() noexcept;
+
 private:
     //==============================================================================
+    friend class ReadAheadScheduler;
+
     OptionalScopedPointer<PositionableAudioSource> source;
-    TimeSliceThread& backgroundThread;
+    TimeSliceThread* backgroundThread;
+    ReadAheadScheduler* scheduler;
     int numberOfSamplesToBuffer, numberOfChannels;
     AudioSampleBuffer buffer;
-    CriticalSection bufferStartPosLock;
-    int64 volatile bufferValidStart, bufferValidEnd, nextPlayPos;
+    Atomic<int64> bufferValidStart, bufferValidEnd, nextPlayPos;
     double volatile sampleRate;
     bool wasSourceLooping, isPrepared;
+    Atomic<int> isBeingRead, numRangeResets;
+
+    Atomic<int> numUnderruns, numReads;
+    Atomic<int64> numSamplesMissed, numSamplesRead, minimumHeadroom, maximumReadTime;
 
-    bool readNextBufferChunk();
+    void startReadAhead();
+    void stopReadAhead();
+    bool readNextBufferChunk (int minimumChunkSize, int maximumChunkSize);
     void readBufferSection (int64 start, int length, int bufferOffset);
+    int64 getNumSamplesBuffered() const noexcept;
     int useTimeSlice() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioSource)
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+ConvolutionAudioSource::ConvolutionAudioSource (AudioSource* const inputSource, const bool deleteInputWhenDeleted,
+                                                const int numChannelsToProcess)
+   : input (inputSource, deleteInputWhenDeleted),
+     numChannels (numChannelsToProcess),
+     wetLevel (1.0f),
+     dryLevel (0.0f),
+     bypass (false)
+{
+    jassert (inputSource != nullptr);
+    convolution.setNumChannels (numChannels);
+}
+
+ConvolutionAudioSource::~ConvolutionAudioSource() {}
+
+void ConvolutionAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const ScopedLock sl (lock);
+    input->prepareToPlay (samplesPerBlockExpected, sampleRate);
+    dryBuffer.setSize (numChannels, jmax (1, samplesPerBlockExpected));
+    convolution.reset();
+}
+
+void ConvolutionAudioSource::releaseResources()
+{
+    const ScopedLock sl (lock);
+    input->releaseResources();
+    dryBuffer.setSize (numChannels, 0);
+}
+
+void ConvolutionAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
+{
+    const ScopedLock sl (lock);
+
+    input->getNextAudioBlock (bufferToFill);
+
+    if (bypass)
+        return;
+
+    AudioBuffer<float>& buffer = *bufferToFill.buffer;
+    const int numToProcess = jmin (numChannels, buffer.getNumChannels());
+    const int maxChunkSize = dryBuffer.getNumSamples();
+
+    // the dry signal is kept in a buffer that's allocated in prepareToPlay, so larger
+    // blocks than expected get done in chunks rather than re-allocating it here
+    for (int pos = 0; pos < bufferToFill.numSamples && maxChunkSize > 0;)
+    {
+        const int startSample = bufferToFill.startSample + pos;
+        const int num = jmin (maxChunkSize, bufferToFill.numSamples - pos);
+
+        if (dryLevel != 0)
+            for (int i = 0; i < numToProcess; ++i)
+                dryBuffer.copyFrom (i, 0, buffer, i, startSample, num);
+
+        convolution.process (buffer, startSample, num);
+
+        for (int i = 0; i < numToProcess; ++i)
+        {
+            buffer.applyGain (i, startSample, num, wetLevel);
+
+            if (dryLevel != 0)
+                buffer.addFrom (i, startSample, dryBuffer, i, 0, num, dryLevel);
+        }
+
+        pos += num;
+    }
+}
+
+void ConvolutionAudioSource::loadImpulseResponse (const AudioBuffer<float>& impulseResponse, bool loadInBackground)
+{
+    convolution.loadImpulseResponse (impulseResponse, loadInBackground);
+}
+
+void ConvolutionAudioSource::setLevels (float newWetLevel, float newDryLevel)
+{
+    const ScopedLock sl (lock);
+    wetLevel = newWetLevel;
+    dryLevel = newDryLevel;
+}
+
+void ConvolutionAudioSource::setBypassed (bool b) noexcept
+{
+    if (bypass != b)
+    {
+        const ScopedLock sl (lock);
+        bypass = b;
+        convolution.reset();
+    }
+}
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_CONVOLUTIONAUDIOSOURCE_H_INCLUDED
+#define JUCE_CONVOLUTIONAUDIOSOURCE_H_INCLUDED
+
+
+//==============================================================================
+/**
+    An AudioSource that uses the Convolution class to apply an impulse response to
+    another AudioSource.
+
+    @see Convolution
+*/
+class JUCE_API  ConvolutionAudioSource   : public AudioSource
+{
+public:
+    /** Creates a ConvolutionAudioSource to process a given input source.
+
+        @param inputSource              the input source to read from - this must not be null
+        @param deleteInputWhenDeleted   if true, the input source will be deleted when
+                                        this object is deleted
+        @param numChannelsToProcess     the number of channels to convolve - any others that
+                                        the input source produces are passed through unchanged
+    */
+    ConvolutionAudioSource (AudioSource* inputSource,
+                            bool deleteInputWhenDeleted,
+                            int numChannelsToProcess = 2);
+
+    /** Destructor. */
+    ~ConvolutionAudioSource();
+
+    //==============================================================================
+    /** Returns the Convolution object that does the processing.
+        You can use this to change its impulse response or partition sizes.
+    */
+    Convolution& getConvolution() noexcept                  { return convolution; }
+
+    /** Loads a new impulse response into the convolution.
+        @see Convolution::loadImpulseResponse
+    */
+    void loadImpulseResponse (const AudioBuffer<float>& impulseResponse, bool loadInBackground = true);
+
+    /** Sets the gains applied to the convolved and unprocessed signals. */
+    void setLevels (float wetGain, float dryGain);
+
+    void setBypassed (bool isBypassed) noexcept;
+    bool isBypassed() const noexcept                        { return bypass; }
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock (const AudioSourceChannelInfo&) override;
+
+private:
+    //==============================================================================
+    CriticalSection lock;
+    OptionalScopedPointer<AudioSource> input;
+    Convolution convolution;
+    AudioBuffer<float> dryBuffer;
+    const int numChannels;
+    float wetLevel, dryLevel;
+    volatile bool bypass;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConvolutionAudioSource)
+};
+
+
+#endif   // JUCE_CONVOLUTIONAUDIOSOURCE_H_INCLUDED
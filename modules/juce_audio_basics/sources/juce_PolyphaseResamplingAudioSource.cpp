@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+PolyphaseResamplingAudioSource::PolyphaseResamplingAudioSource (AudioSource* const inputSource,
+                                                                const bool deleteInputWhenDeleted,
+                                                                const int channels,
+                                                                const PolyphaseResampler::Quality quality,
+                                                                const double maximumRatio)
+    : input (inputSource, deleteInputWhenDeleted),
+      resampler (channels, quality, maximumRatio),
+      ratio (1.0),
+      lastRatio (1.0),
+      needsPriming (true)
+{
+    jassert (input != nullptr);
+}
+
+PolyphaseResamplingAudioSource::~PolyphaseResamplingAudioSource() {}
+
+void PolyphaseResamplingAudioSource::setResamplingRatio (const double samplesInPerOutputSample)
+{
+    jassert (samplesInPerOutputSample > 0);
+    jassert (samplesInPerOutputSample <= resampler.getMaximumRatio());
+
+    const SpinLock::ScopedLockType sl (ratioLock);
+    ratio = jlimit (1.0e-3, resampler.getMaximumRatio(), samplesInPerOutputSample);
+}
+
+void PolyphaseResamplingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    const SpinLock::ScopedLockType sl (ratioLock);
+
+    const int scaledBlockSize = roundToInt (samplesPerBlockExpected * ratio);
+    input->prepareToPlay (scaledBlockSize, sampleRate * ratio);
+
+    // Everything is sized for the maximum ratio, so that the ratio can be changed
+    // later on without the audio thread having to allocate anything.
+    const int maxInputSamples = jmax ((int) std::ceil (samplesPerBlockExpected * resampler.getMaximumRatio()) + 32,
+                                      resampler.getLatencyInInputSamples());
+
+    const int numChannels = resampler.getNumChannels();
+    inputBuffer.setSize (numChannels, maxInputSamples);
+    outputBuffer.setSize (numChannels, samplesPerBlockExpected);
+    srcBuffers.calloc ((size_t) numChannels);
+    destBuffers.calloc ((size_t) numChannels);
+
+    resampler.prepare (maxInputSamples);
+    resampler.prepareForRatioRange (0.0, resampler.getMaximumRatio());
+    lastRatio = ratio;
+
+    flushBuffers();
+}
+
+void PolyphaseResamplingAudioSource::flushBuffers()
+{
+    resampler.reset();
+    needsPriming = true;
+}
+
+void PolyphaseResamplingAudioSource::releaseResources()
+{
+    input->releaseResources();
+    inputBuffer.setSize (resampler.getNumChannels(), 0);
+    outputBuffer.setSize (resampler.getNumChannels(), 0);
+}
+
+void PolyphaseResamplingAudioSource::readInput (int numSamples)
+{
+    inputBuffer.setSize (inputBuffer.getNumChannels(), jmax (numSamples, inputBuffer.getNumSamples()), false, false, true);
+
+    if (numSamples > 0)
+    {
+        AudioSourceChannelInfo readInfo (&inputBuffer, 0, numSamples);
+        input->getNextAudioBlock (readInfo);
+    }
+
+    for (int i = 0; i < inputBuffer.getNumChannels(); ++i)
+        srcBuffers[i] = inputBuffer.getReadPointer (i);
+}
+
+void PolyphaseResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    double localRatio;
+
+    {
+        const SpinLock::ScopedLockType sl (ratioLock);
+        localRatio = ratio;
+    }
+
+    if (needsPriming)
+    {
+        // feeding the first part of the input into the filter's history cancels out its delay
+        readInput (resampler.getLatencyInInputSamples());
+        resampler.skipInput (srcBuffers, resampler.getLatencyInInputSamples());
+        needsPriming = false;
+    }
+
+    const int numChannels = resampler.getNumChannels();
+    const int channelsToProcess = jmin (numChannels, info.buffer->getNumChannels());
+
+    // any channels that the destination doesn't have are rendered into a spare buffer
+    if (channelsToProcess < numChannels)
+        outputBuffer.setSize (numChannels, jmax (info.numSamples, outputBuffer.getNumSamples()), false, false, true);
+
+    for (int i = 0; i < numChannels; ++i)
+        destBuffers[i] = i < channelsToProcess ? info.buffer->getWritePointer (i, info.startSample)
+                                               : outputBuffer.getWritePointer (i);
+
+    readInput (resampler.getNumInputSamplesNeeded (lastRatio, localRatio, info.numSamples));
+    resampler.process (lastRatio, localRatio, srcBuffers, destBuffers, info.numSamples);
+    lastRatio = localRatio;
+
+    for (int i = channelsToProcess; i < info.buffer->getNumChannels(); ++i)
+        info.buffer->clear (i, info.startSample, info.numSamples);
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PolyphaseResamplingAudioSourceTests  : public UnitTest
+{
+public:
+    PolyphaseResamplingAudioSourceTests() : UnitTest ("PolyphaseResamplingAudioSource") {}
+
+    void runTest() override
+    {
+        beginTest ("Resampling a tone");
+
+        const double testRatios[] = { 0.5, 44100.0 / 48000.0, 2.0 };
+
+        for (int i = 0; i < numElementsInArray (testRatios); ++i)
+        {
+            ToneGeneratorAudioSource* tone = new ToneGeneratorAudioSource();
+            tone->setFrequency (440.0);
+            tone->setAmplitude (0.5f);
+
+            PolyphaseResamplingAudioSource source (tone, true, 2);
+            source.setResamplingRatio (testRatios[i]);
+            source.prepareToPlay (512, 44100.0);
+
+            AudioBuffer<float> buffer (2, 512);
+            int pos = 0;
+            double maxError = 0;
+
+            for (int block = 0; block < 20; ++block)
+            {
+                source.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+
+                // the output should be the same tone at the output rate, lined up with the input
+                for (int j = 0; j < buffer.getNumSamples(); ++j)
+                {
+                    const double expected = 0.5 * std::sin (2.0 * double_Pi * 440.0 * (pos + j) / 44100.0);
+
+                    if (pos + j > 300)
+                        maxError = jmax (maxError, std::abs (buffer.getSample (0, j) - expected),
+                                                   std::abs (buffer.getSample (1, j) - expected));
+                }
+
+                pos += buffer.getNumSamples();
+            }
+
+            expect (maxError < 0.001, "Error " + String (maxError) + " at ratio " + String (testRatios[i]));
+            source.releaseResources();
+        }
+
+        beginTest ("Changing the ratio");
+        {
+            ToneGeneratorAudioSource* tone = new ToneGeneratorAudioSource();
+            PolyphaseResamplingAudioSource source (tone, true, 1);
+            source.prepareToPlay (256, 44100.0);
+
+            AudioBuffer<float> buffer (2, 256);
+
+            for (int block = 0; block < 30; ++block)
+            {
+                source.setResamplingRatio (1.0 + 0.1 * (block % 7));
+                buffer.clear();
+                buffer.setSample (1, 0, 1.0f);
+                source.getNextAudioBlock (AudioSourceChannelInfo (buffer));
+
+                expect (buffer.getMagnitude (0, 0, 256) < 0.6f);
+                expect (buffer.getMagnitude (1, 0, 256) == 0.0f);
+            }
+        }
+    }
+};
+
+static PolyphaseResamplingAudioSourceTests polyphaseResamplingAudioSourceTests;
+
+#endif
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_POLYPHASERESAMPLINGAUDIOSOURCE_H_INCLUDED
+#define JUCE_POLYPHASERESAMPLINGAUDIOSOURCE_H_INCLUDED
+
+
+//==============================================================================
+/**
+    A type of AudioSource that changes the sample rate of an input source using a
+    PolyphaseResampler.
+
+    This does the same job as a ResamplingAudioSource, but with a much steeper
+    anti-aliasing filter, so it's better suited to things like rendering files at a
+    different rate - e.g. by passing one of these to AudioFormatWriter::writeFromAudioSource().
+
+    When the ratio is changed while it's running, the new ratio is reached gradually
+    over the course of the next block, so there aren't any sudden jumps in pitch.
+
+    The delay that the filter introduces is compensated for by reading ahead from the
+    input when playback starts, so the output lines up with the input.
+
+    @see AudioSource, PolyphaseResampler, ResamplingAudioSource
+*/
+class JUCE_API  PolyphaseResamplingAudioSource  : public AudioSource
+{
+public:
+    //==============================================================================
+    /** Creates a PolyphaseResamplingAudioSource for a given input source.
+
+        @param inputSource              the input source to read from
+        @param deleteInputWhenDeleted   if true, the input source will be deleted when
+                                        this object is deleted
+        @param numChannels              the number of channels to process
+        @param quality                  the type of filter to use
+        @param maximumRatio             the largest resampling ratio that will be used. The
+                                        filters for all the ratios up to this are built by
+                                        prepareToPlay(), so don't make it bigger than you need
+    */
+    PolyphaseResamplingAudioSource (AudioSource* inputSource,
+                                    bool deleteInputWhenDeleted,
+                                    int numChannels = 2,
+                                    PolyphaseResampler::Quality quality = PolyphaseResampler::normalQuality,
+                                    double maximumRatio = 4.0);
+
+    /** Destructor. */
+    ~PolyphaseResamplingAudioSource();
+
+    /** Changes the resampling ratio.
+
+        (This value can be changed at any time, even while the source is running).
+
+        @param samplesInPerOutputSample     if set to 1.0, the input is passed through; higher
+                                            values will speed it up; lower values will slow it
+                                            down. The ratio must be greater than 0, and no
+                                            higher than the maximum ratio given to the constructor
+    */
+    void setResamplingRatio (double samplesInPerOutputSample);
+
+    /** Returns the current resampling ratio.
+
+        This is the value that was set by setResamplingRatio().
+    */
+    double getResamplingRatio() const noexcept                  { return ratio; }
+
+    /** Clears the resampler's history, so that the next block starts afresh. */
+    void flushBuffers();
+
+    //==============================================================================
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    void releaseResources() override;
+    void getNextAudioBlock (const AudioSourceChannelInfo&) override;
+
+private:
+    //==============================================================================
+    OptionalScopedPointer<AudioSource> input;
+    PolyphaseResampler resampler;
+    double ratio, lastRatio;
+    SpinLock ratioLock;
+    AudioSampleBuffer inputBuffer, outputBuffer;
+    HeapBlock<const float*> srcBuffers;
+    HeapBlock<float*> destBuffers;
+    bool needsPriming;
+
+    void readInput (int numSamples);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResamplingAudioSource)
+};
+
+
+#endif   // JUCE_POLYPHASERESAMPLINGAUDIOSOURCE_H_INCLUDED
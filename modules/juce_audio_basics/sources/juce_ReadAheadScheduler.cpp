@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+class ReadAheadScheduler::ReaderJob  : public ThreadPoolJob
+{
+public:
+    ReaderJob (ReadAheadScheduler& s)  : ThreadPoolJob ("Read-ahead"), owner (s) {}
+
+    JobStatus runJob() override
+    {
+        while (! shouldExit())
+        {
+            int millisecondsToWait = 0;
+
+            if (BufferingAudioSource* const source = owner.chooseNextSource (millisecondsToWait))
+            {
+                source->readNextBufferChunk (owner.getMinimumReadSize (*source), owner.maximumReadSize);
+                source->isBeingRead = 0;
+            }
+            else
+            {
+                owner.wakeUpEvent.wait (millisecondsToWait);
+            }
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    ReadAheadScheduler& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (ReaderJob)
+};
+
+//==============================================================================
+ReadAheadScheduler::ReadAheadScheduler (const int numThreads, const int minReadSize, const int maxReadSize)
+    : minimumReadSize (jmax (256, minReadSize)),
+      maximumReadSize (jmax (minimumReadSize, maxReadSize)),
+      pool (jmax (1, numThreads))
+{
+    for (int i = jmax (1, numThreads); --i >= 0;)
+        pool.addJob (new ReaderJob (*this), true);
+}
+
+ReadAheadScheduler::~ReadAheadScheduler()
+{
+    // All the BufferingAudioSources that use this scheduler must be deleted first!
+    jassert (sources.size() == 0);
+
+    pool.removeAllJobs (true, 4000);
+}
+
+int ReadAheadScheduler::getNumSources() const
+{
+    const ScopedLock sl (sourcesLock);
+    return sources.size();
+}
+
+void ReadAheadScheduler::addSource (BufferingAudioSource* const source)
+{
+    {
+        const ScopedLock sl (sourcesLock);
+        sources.addIfNotAlreadyThere (source);
+    }
+
+    wakeUp();
+}
+
+void ReadAheadScheduler::removeSource (BufferingAudioSource* const source)
+{
+    {
+        const ScopedLock sl (sourcesLock);
+        sources.removeFirstMatchingValue (source);
+    }
+
+    // if one of our threads is in the middle of refilling it, we need to wait for it to finish
+    while (source->isBeingRead.get() != 0)
+        Thread::sleep (1);
+}
+
+void ReadAheadScheduler::wakeUp() noexcept
+{
+    wakeUpEvent.signal();
+}
+
+int ReadAheadScheduler::getMinimumReadSize (const BufferingAudioSource& source) const noexcept
+{
+    return jmin (minimumReadSize, source.buffer.getNumSamples() / 4);
+}
+
+BufferingAudioSource* ReadAheadScheduler::chooseNextSource (int& millisecondsToWait)
+{
+    const ScopedLock sl (sourcesLock);
+
+    BufferingAudioSource* mostUrgent = nullptr;
+    double lowestHeadroom = 0, shortestWait = 0.05;
+
+    for (int i = 0; i < sources.size(); ++i)
+    {
+        BufferingAudioSource* const source = sources.getUnchecked (i);
+        const double rate = source->sampleRate;
+
+        if (source->isBeingRead.get() != 0 || rate <= 0 || source->buffer.getNumSamples() == 0)
+            continue;
+
+        const int64 numBuffered = source->getNumSamplesBuffered();
+        const int64 freeSpace = source->buffer.getNumSamples() - 4 - jmax ((int64) 0, numBuffered);
+        const int64 minimumRead = getMinimumReadSize (*source);
+
+        if (numBuffered <= 0 || freeSpace >= minimumRead)
+        {
+            const double headroom = numBuffered / rate;
+
+            if (mostUrgent == nullptr || headroom < lowestHeadroom)
+            {
+                mostUrgent = source;
+                lowestHeadroom = headroom;
+            }
+        }
+        else
+        {
+            shortestWait = jmin (shortestWait, (minimumRead - freeSpace) / rate);
+        }
+    }
+
+    if (mostUrgent != nullptr)
+        mostUrgent->isBeingRead = 1;
+    else
+        millisecondsToWait = jlimit (1, 50, (int) (shortestWait * 1000.0));
+
+    return mostUrgent;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ReadAheadSchedulerTests  : public UnitTest
+{
+public:
+    ReadAheadSchedulerTests() : UnitTest ("ReadAheadScheduler") {}
+
+    struct RampSource  : public PositionableAudioSource
+    {
+        RampSource (int seed) : offset (seed * 1000), position (0) {}
+
+        static float getSampleAt (int seedOffset, int channel, int64 pos) noexcept
+        {
+            return (float) ((pos + seedOffset) % 10007) / 10007.0f + (float) channel;
+        }
+
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
+                for (int i = 0; i < info.numSamples; ++i)
+                    info.buffer->setSample (chan, info.startSample + i, getSampleAt (offset, chan, position + i));
+
+            position += info.numSamples;
+        }
+
+        void setNextReadPosition (int64 newPosition) override   { position = newPosition; }
+        int64 getNextReadPosition() const override              { return position; }
+        int64 getTotalLength() const override                   { return 1 << 30; }
+        bool isLooping() const override                         { return false; }
+
+        const int offset;
+        int64 position;
+    };
+
+    // If allowSilence is true, samples that are zero because the data wasn't ready aren't counted.
+    int countWrongSamples (BufferingAudioSource& source, int seed, int64 startPos, int numSamples,
+                           bool allowSilence = false)
+    {
+        AudioSampleBuffer block (2, numSamples);
+        source.getNextAudioBlock (AudioSourceChannelInfo (&block, 0, numSamples));
+
+        int numWrong = 0;
+
+        for (int chan = 0; chan < 2; ++chan)
+            for (int i = 0; i < numSamples; ++i)
+                if (block.getSample (chan, i) != RampSource::getSampleAt (seed * 1000, chan, startPos + i)
+                     && ! (allowSilence && block.getSample (chan, i) == 0.0f))
+                    ++numWrong;
+
+        return numWrong;
+    }
+
+    void runTest() override
+    {
+        const int blockSize = 512;
+
+        beginTest ("Many sources sharing a scheduler");
+        {
+            ReadAheadScheduler scheduler (3, 4096, 16384);
+            OwnedArray<BufferingAudioSource> sources;
+
+            for (int i = 0; i < 64; ++i)
+            {
+                sources.add (new BufferingAudioSource (new RampSource (i), scheduler, true, 32768));
+                sources.getLast()->prepareToPlay (blockSize, 44100.0);
+            }
+
+            expectEquals (scheduler.getNumSources(), 64);
+
+            int numWrong = 0, numUnderruns = 0;
+
+            for (int block = 0; block < 200; ++block)
+            {
+                for (int i = 0; i < sources.size(); ++i)
+                    numWrong += countWrongSamples (*sources.getUnchecked (i), i, block * blockSize, blockSize);
+
+                Thread::sleep (4);
+            }
+
+            for (int i = 0; i < sources.size(); ++i)
+            {
+                const BufferingAudioSource::Statistics stats (sources.getUnchecked (i)->getStatistics());
+                numUnderruns += stats.numUnderruns;
+                expect (stats.numReads > 0);
+                expect (stats.numSamplesRead >= 200 * blockSize);
+            }
+
+            expectEquals (numUnderruns, 0);
+            expectEquals (numWrong, 0);
+
+            sources.clear();
+            expectEquals (scheduler.getNumSources(), 0);
+        }
+
+        beginTest ("Seeking");
+        {
+            ReadAheadScheduler scheduler (1);
+            BufferingAudioSource source (new RampSource (3), scheduler, true, 32768);
+            source.prepareToPlay (blockSize, 44100.0);
+
+            expectEquals (countWrongSamples (source, 3, 0, blockSize), 0);
+
+            source.setNextReadPosition (123456);
+            expectEquals (source.getNextReadPosition(), (int64) 123456);
+
+            for (int i = 0; i < 100 && source.getStatistics().numSamplesRead < 123456; ++i)
+                Thread::sleep (5);
+
+            Thread::sleep (20);
+            expectEquals (countWrongSamples (source, 3, 123456, blockSize), 0);
+            expectEquals (source.getNextReadPosition(), (int64) 123456 + blockSize);
+        }
+
+        beginTest ("Seeking backwards while the buffer is being refilled");
+        {
+            ReadAheadScheduler scheduler (2, 256, 1024);
+            BufferingAudioSource source (new RampSource (9), scheduler, true, 4096);
+            source.prepareToPlay (256, 44100.0);
+
+            Random r (getRandom());
+            int64 playPos = 0;
+            int numWrong = 0;
+
+            for (int i = 0; i < 50000; ++i)
+            {
+                // jump back to somewhere that may still be in the buffer
+                if (r.nextInt (3) == 0)
+                {
+                    playPos = jmax ((int64) 0, playPos - r.nextInt (6000));
+                    source.setNextReadPosition (playPos);
+                }
+
+                numWrong += countWrongSamples (source, 9, playPos, 256, true);
+                playPos += 256;
+            }
+
+            expectEquals (numWrong, 0);
+        }
+
+        beginTest ("Running out of data is reported");
+        {
+            ReadAheadScheduler scheduler (1);
+            BufferingAudioSource source (new RampSource (5), scheduler, true, 8192);
+            source.prepareToPlay (blockSize, 44100.0);
+            source.resetStatistics();
+
+            // with no time for the scheduler to catch up, this must eventually run dry
+            AudioSampleBuffer block (2, 4096);
+
+            for (int i = 0; i < 100; ++i)
+                source.getNextAudioBlock (AudioSourceChannelInfo (&block, 0, block.getNumSamples()));
+
+            const BufferingAudioSource::Statistics stats (source.getStatistics());
+            expect (stats.numUnderruns > 0);
+            expect (stats.numSamplesMissed > 0);
+        }
+
+        beginTest ("TimeSliceThread read-ahead");
+        {
+            TimeSliceThread thread ("Read-ahead test");
+            thread.startThread();
+
+            BufferingAudioSource source (new RampSource (7), thread, true, 32768);
+            source.prepareToPlay (blockSize, 44100.0);
+
+            int numWrong = 0;
+
+            for (int block = 0; block < 100; ++block)
+            {
+                numWrong += countWrongSamples (source, 7, block * blockSize, blockSize);
+                Thread::sleep (2);
+            }
+
+            expectEquals (numWrong, 0);
+            expectEquals (source.getStatistics().numUnderruns, 0);
+            source.releaseResources();
+        }
+    }
+};
+
+static ReadAheadSchedulerTests readAheadSchedulerTests;
+
+#endif
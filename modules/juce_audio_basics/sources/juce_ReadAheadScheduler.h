@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_READAHEADSCHEDULER_H_INCLUDED
+#define JUCE_READAHEADSCHEDULER_H_INCLUDED
+
+class BufferingAudioSource;
+
+//==============================================================================
+/**
+    A set of background threads which do the read-ahead for a group of
+    BufferingAudioSources.
+
+    A TimeSliceThread gives each of its clients a turn in strict rotation, so when a
+    lot of sources are playing, one that's about to run dry may have to wait behind
+    dozens of others which have plenty of data left. Instead, whenever one of this
+    scheduler's threads is free, it refills the source that has the least audio
+    buffered, measured in seconds, so the most urgent reads are always done first.
+
+    To keep the number of disk accesses down, sources are only refilled once there's
+    room in their buffer for a reasonably large read, unless they've run out of data
+    completely.
+
+    Create one of these and pass it to the constructor of each BufferingAudioSource
+    that should use it. It must not be deleted until all of those sources have been
+    deleted. Each source keeps its own statistics, which you can use to see how well
+    the scheduler is keeping up.
+
+    @see BufferingAudioSource
+*/
+class JUCE_API  ReadAheadScheduler
+{
+public:
+    //==============================================================================
+    /** Creates a scheduler.
+
+        @param numThreads       the number of threads which will read from the sources
+        @param minimumReadSize  the smallest number of samples that a source will be
+                                refilled with, unless it has run out of data altogether
+        @param maximumReadSize  the largest number of samples that will be read from a
+                                source in one go, before moving on to the next one
+    */
+    ReadAheadScheduler (int numThreads = 2,
+                        int minimumReadSize = 8192,
+                        int maximumReadSize = 65536);
+
+    /** Destructor. */
+    ~ReadAheadScheduler();
+
+    //==============================================================================
+    /** Returns the number of sources that are currently being kept topped up. */
+    int getNumSources() const;
+
+private:
+    //==============================================================================
+    friend class BufferingAudioSource;
+    class ReaderJob;
+
+    const int minimumReadSize, maximumReadSize;
+    Array<BufferingAudioSource*> sources;
+    CriticalSection sourcesLock;
+    WaitableEvent wakeUpEvent;
+    ThreadPool pool;
+
+    void addSource (BufferingAudioSource*);
+    void removeSource (BufferingAudioSource*);
+    void wakeUp() noexcept;
+    int getMinimumReadSize (const BufferingAudioSource&) const noexcept;
+    BufferingAudioSource* chooseNextSource (int& millisecondsToWait);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReadAheadScheduler)
+};
+
+
+#endif   // JUCE_READAHEADSCHEDULER_H_INCLUDED
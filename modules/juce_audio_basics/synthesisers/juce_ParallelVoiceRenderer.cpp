@@ -0,0 +1,342 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+struct ParallelVoiceRenderer::WorkerThread  : public Thread
+{
+    WorkerThread (ParallelVoiceRenderer& r)
+        : Thread ("Synthesiser voice renderer"), owner (r), hasRendered (false)
+    {
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (-1);
+
+            ++(owner.numActiveWorkers);
+
+            if (owner.isRendering.get() != 0)
+                owner.renderVoicesOnWorker (*this);
+
+            --(owner.numActiveWorkers);
+        }
+    }
+
+    AudioBuffer<float>& getScratchBuffer (float*) noexcept      { return floatScratch; }
+    AudioBuffer<double>& getScratchBuffer (double*) noexcept    { return doubleScratch; }
+
+    ParallelVoiceRenderer& owner;
+    AudioBuffer<float> floatScratch;
+    AudioBuffer<double> doubleScratch;
+    bool hasRendered;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkerThread)
+};
+
+//==============================================================================
+ParallelVoiceRenderer::ParallelVoiceRenderer (const int numThreads)
+    : currentVoices (nullptr), floatOutput (nullptr), doubleOutput (nullptr), numSamplesToRender (0)
+{
+    enum { realtimeAudioPriority = 9 };
+
+    for (int i = 1; i < numThreads; ++i)
+        workers.add (new WorkerThread (*this));
+
+    for (int i = 0; i < workers.size(); ++i)
+        workers.getUnchecked (i)->startThread (realtimeAudioPriority);
+}
+
+ParallelVoiceRenderer::~ParallelVoiceRenderer()
+{
+    for (int i = 0; i < workers.size(); ++i)
+        workers.getUnchecked (i)->signalThreadShouldExit();
+
+    for (int i = 0; i < workers.size(); ++i)
+    {
+        workers.getUnchecked (i)->notify();
+        workers.getUnchecked (i)->stopThread (4000);
+    }
+}
+
+int ParallelVoiceRenderer::getNumThreads() const noexcept
+{
+    return workers.size() + 1;
+}
+
+void ParallelVoiceRenderer::render (VoiceList& voices, AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    floatOutput = &outputAudio;
+    doubleOutput = nullptr;
+    renderVoices (voices, outputAudio, startSample, numSamples);
+}
+
+void ParallelVoiceRenderer::render (VoiceList& voices, AudioBuffer<double>& outputAudio, int startSample, int numSamples)
+{
+    floatOutput = nullptr;
+    doubleOutput = &outputAudio;
+    renderVoices (voices, outputAudio, startSample, numSamples);
+}
+
+template <typename FloatType>
+void ParallelVoiceRenderer::renderVoices (VoiceList& voices, AudioBuffer<FloatType>& outputAudio,
+                                          const int startSample, const int numSamples)
+{
+    const int numVoices = voices.getNumVoices();
+
+    activeVoices.clearQuick();
+    activeVoices.ensureStorageAllocated (numVoices);
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        if (voices.isVoiceActive (i))
+            activeVoices.add (i);
+        else
+            voices.renderVoice (i, outputAudio, startSample, numSamples);
+    }
+
+    if (activeVoices.size() < 2 || workers.size() == 0)
+    {
+        for (int i = 0; i < activeVoices.size(); ++i)
+            voices.renderVoice (activeVoices.getUnchecked (i), outputAudio, startSample, numSamples);
+
+        return;
+    }
+
+    const int numChannels = outputAudio.getNumChannels();
+
+    for (int i = 0; i < workers.size(); ++i)
+    {
+        WorkerThread& worker = *workers.getUnchecked (i);
+        worker.getScratchBuffer ((FloatType*) nullptr).setSize (numChannels, numSamples, false, false, true);
+        worker.hasRendered = false;
+    }
+
+    currentVoices = &voices;
+    numSamplesToRender = numSamples;
+    nextVoice.set (0);
+    numVoicesFinished.set (0);
+    isRendering.set (1);
+
+    for (int i = 0; i < workers.size(); ++i)
+        workers.getUnchecked (i)->notify();
+
+    // The calling thread doesn't need a scratch buffer, it can add straight to the output..
+    renderClaimedVoices (outputAudio, startSample, numSamples, false);
+
+    // ..then wait for the workers to finish the voices they've taken, and to leave this
+    // block before their scratch buffers get used.
+    while (numVoicesFinished.get() < activeVoices.size())
+    {}
+
+    isRendering.set (0);
+
+    while (numActiveWorkers.get() > 0)
+    {}
+
+    for (int i = 0; i < workers.size(); ++i)
+    {
+        WorkerThread& worker = *workers.getUnchecked (i);
+
+        if (worker.hasRendered)
+        {
+            const AudioBuffer<FloatType>& scratch = worker.getScratchBuffer ((FloatType*) nullptr);
+
+            for (int chan = 0; chan < numChannels; ++chan)
+                FloatVectorOperations::add (outputAudio.getWritePointer (chan, startSample),
+                                            scratch.getReadPointer (chan), numSamples);
+        }
+    }
+
+    currentVoices = nullptr;
+}
+
+template <typename FloatType>
+bool ParallelVoiceRenderer::renderClaimedVoices (AudioBuffer<FloatType>& buffer, const int startSample,
+                                                 const int numSamples, const bool clearBufferFirst)
+{
+    bool hasRenderedAnything = false;
+
+    for (;;)
+    {
+        const int index = (++nextVoice) - 1;
+
+        if (index >= activeVoices.size())
+            break;
+
+        if (clearBufferFirst && ! hasRenderedAnything)
+            buffer.clear (startSample, numSamples);
+
+        currentVoices->renderVoice (activeVoices.getUnchecked (index), buffer, startSample, numSamples);
+        hasRenderedAnything = true;
+
+        ++numVoicesFinished;
+    }
+
+    return hasRenderedAnything;
+}
+
+void ParallelVoiceRenderer::renderVoicesOnWorker (WorkerThread& worker)
+{
+    const bool needsClearing = ! worker.hasRendered;
+
+    const bool renderedVoices = floatOutput != nullptr
+                                   ? renderClaimedVoices (worker.floatScratch,  0, numSamplesToRender, needsClearing)
+                                   : renderClaimedVoices (worker.doubleScratch, 0, numSamplesToRender, needsClearing);
+
+    if (renderedVoices)
+        worker.hasRendered = true;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParallelVoiceRendererTests  : public UnitTest
+{
+public:
+    ParallelVoiceRendererTests() : UnitTest ("ParallelVoiceRenderer") {}
+
+    struct TestSound  : public SynthesiserSound
+    {
+        bool appliesToNote (int) override       { return true; }
+        bool appliesToChannel (int) override    { return true; }
+    };
+
+    // A sine voice that stops by itself after a while, so that voices finish
+    // in the middle of blocks while other threads are rendering.
+    struct TestVoice  : public SynthesiserVoice
+    {
+        TestVoice() : angle (0), angleDelta (0), level (0), samplesLeft (0) {}
+
+        bool canPlaySound (SynthesiserSound*) override      { return true; }
+
+        void startNote (int midiNoteNumber, float velocity, SynthesiserSound*, int) override
+        {
+            angle = 0;
+            angleDelta = MidiMessage::getMidiNoteInHertz (midiNoteNumber) * 2.0 * double_Pi / getSampleRate();
+            level = velocity * 0.05;
+            samplesLeft = 300 + midiNoteNumber * 13;
+        }
+
+        void stopNote (float, bool) override                { clearCurrentNote(); }
+        void pitchWheelMoved (int) override                 {}
+        void controllerMoved (int, int) override            {}
+
+        void renderNextBlock (AudioBuffer<float>& buffer, int startSample, int numSamples) override    { render (buffer, startSample, numSamples); }
+        void renderNextBlock (AudioBuffer<double>& buffer, int startSample, int numSamples) override   { render (buffer, startSample, numSamples); }
+
+        template <typename FloatType>
+        void render (AudioBuffer<FloatType>& buffer, int startSample, int numSamples)
+        {
+            if (! isVoiceActive())
+                return;
+
+            for (int i = 0; i < numSamples && samplesLeft > 0; ++i, --samplesLeft)
+            {
+                const FloatType sample = (FloatType) (std::sin (angle) * level);
+                angle += angleDelta;
+
+                for (int chan = buffer.getNumChannels(); --chan >= 0;)
+                    buffer.addSample (chan, startSample + i, sample);
+            }
+
+            if (samplesLeft <= 0)
+                clearCurrentNote();
+        }
+
+        double angle, angleDelta, level;
+        int samplesLeft;
+    };
+
+    template <typename FloatType>
+    static void renderSynth (AudioBuffer<FloatType>& result, int numThreads, int numBlocks, int blockSize)
+    {
+        Synthesiser synth;
+        synth.addSound (new TestSound());
+
+        for (int i = 0; i < 24; ++i)
+            synth.addVoice (new TestVoice());
+
+        synth.setCurrentPlaybackSampleRate (44100.0);
+        synth.setNumRenderingThreads (numThreads);
+
+        result.setSize (2, numBlocks * blockSize);
+        result.clear();
+
+        Random r (0x1234);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            MidiBuffer midi;
+
+            for (int i = r.nextInt (6); --i >= 0;)
+                midi.addEvent (MidiMessage::noteOn (1, 30 + r.nextInt (60), (uint8) (1 + r.nextInt (127))), r.nextInt (blockSize));
+
+            AudioBuffer<FloatType> output (result.getArrayOfWritePointers(), 2, block * blockSize, blockSize);
+            synth.renderNextBlock (output, midi, 0, blockSize);
+        }
+    }
+
+    template <typename FloatType>
+    void testMatchesSingleThread()
+    {
+        AudioBuffer<FloatType> serial, parallel;
+        renderSynth (serial, 1, 200, 256);
+
+        for (int numThreads = 2; numThreads <= 4; ++numThreads)
+        {
+            renderSynth (parallel, numThreads, 200, 256);
+
+            FloatType maxDifference = 0;
+
+            for (int chan = 0; chan < 2; ++chan)
+                for (int i = 0; i < serial.getNumSamples(); ++i)
+                    maxDifference = jmax (maxDifference, std::abs (serial.getSample (chan, i) - parallel.getSample (chan, i)));
+
+            // the voices get summed in a different order, so there'll be some rounding differences
+            expect (maxDifference < (FloatType) 1.0e-5, "difference: " + String ((double) maxDifference));
+        }
+
+        expect (serial.getMagnitude (0, serial.getNumSamples()) > (FloatType) 0.01);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Output matches single-threaded rendering");
+        testMatchesSingleThread<float>();
+        testMatchesSingleThread<double>();
+
+        beginTest ("Changing the number of threads");
+        Synthesiser synth;
+        expectEquals (synth.getNumRenderingThreads(), 1);
+        synth.setNumRenderingThreads (3);
+        expectEquals (synth.getNumRenderingThreads(), 3);
+        synth.setNumRenderingThreads (0);
+        expectEquals (synth.getNumRenderingThreads(), 1);
+    }
+};
+
+static ParallelVoiceRendererTests parallelVoiceRendererTests;
+
+#endif
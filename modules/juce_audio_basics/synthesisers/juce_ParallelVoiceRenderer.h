@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_PARALLELVOICERENDERER_H_INCLUDED
+#define JUCE_PARALLELVOICERENDERER_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Renders a set of synthesiser voices on several threads at once.
+
+    This is what Synthesiser and MPESynthesiser use when they're given more than one
+    rendering thread, but you can also use it in your own synthesiser classes.
+
+    For each block, the active voices are shared out between the calling thread and a
+    set of realtime-priority worker threads, which take them one at a time from a lock-free
+    counter. The calling thread renders its voices straight into the output buffer, while
+    each worker renders into its own scratch buffer, which is then added to the output.
+    Inactive voices are rendered on the calling thread, because they normally return
+    straight away.
+
+    The voices are rendered exactly as they would be in a single thread, except that
+    several of them may be running at the same time, so a voice mustn't touch any state
+    that it shares with other voices without protecting it.
+
+    @see Synthesiser::setNumRenderingThreads, MPESynthesiser::setNumRenderingThreads
+*/
+class JUCE_API  ParallelVoiceRenderer
+{
+public:
+    //==============================================================================
+    /** Creates a renderer which will use numThreads threads in total, including the
+        thread that calls render(). So the number of worker threads started will
+        be (numThreads - 1).
+    */
+    explicit ParallelVoiceRenderer (int numThreads);
+
+    /** Destructor. */
+    ~ParallelVoiceRenderer();
+
+    /** Returns the number of threads that will render voices, including the calling thread. */
+    int getNumThreads() const noexcept;
+
+    //==============================================================================
+    /** Gives the renderer access to a set of voices. */
+    struct JUCE_API  VoiceList
+    {
+        virtual ~VoiceList() {}
+
+        /** Returns the number of voices. */
+        virtual int getNumVoices() const = 0;
+
+        /** Returns true if the voice is playing something, and so is worth rendering
+            on another thread.
+        */
+        virtual bool isVoiceActive (int voiceIndex) const = 0;
+
+        /** Adds the output of one of the voices to a buffer. */
+        virtual void renderVoice (int voiceIndex, AudioBuffer<float>& outputAudio, int startSample, int numSamples) = 0;
+
+        /** Adds the output of one of the voices to a buffer. */
+        virtual void renderVoice (int voiceIndex, AudioBuffer<double>& outputAudio, int startSample, int numSamples) = 0;
+    };
+
+    //==============================================================================
+    /** Renders all of the voices, adding their output to the given section of a buffer.
+
+        The scratch buffers that the workers use are resized if the block is bigger than
+        any that they've been given before, so the first few calls may allocate memory.
+    */
+    void render (VoiceList& voices, AudioBuffer<float>& outputAudio, int startSample, int numSamples);
+
+    /** Renders all of the voices, adding their output to the given section of a buffer. */
+    void render (VoiceList& voices, AudioBuffer<double>& outputAudio, int startSample, int numSamples);
+
+private:
+    //==============================================================================
+    struct WorkerThread;
+    friend struct ContainerDeletePolicy<WorkerThread>;
+    OwnedArray<WorkerThread> workers;
+
+    Array<int> activeVoices;
+    VoiceList* currentVoices;
+    AudioBuffer<float>* floatOutput;
+    AudioBuffer<double>* doubleOutput;
+    int numSamplesToRender;
+    Atomic<int> isRendering, numActiveWorkers, nextVoice, numVoicesFinished;
+
+    template <typename FloatType>
+    void renderVoices (VoiceList&, AudioBuffer<FloatType>&, int startSample, int numSamples);
+
+    template <typename FloatType>
+    bool renderClaimedVoices (AudioBuffer<FloatType>&, int startSample, int numSamples, bool clearBufferFirst);
+
+    void renderVoicesOnWorker (WorkerThread&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelVoiceRenderer)
+};
+
+
+#endif   // JUCE_PARALLELVOICERENDERER_H_INCLUDED
@@ -153,6 +153,27 @@ void Synthesiser::setMinimumRenderingSubdivisionSize (int numSamples) noexcept
     minimumSubBlockSize = numSamples;
 }
 
+void Synthesiser::setNumRenderingThreads (int numThreads)
+{
+    numThreads = jmax (1, numThreads);
+
+    if (numThreads != getNumRenderingThreads())
+    {
+        ScopedPointer<ParallelVoiceRenderer> newRenderer (numThreads > 1 ? new ParallelVoiceRenderer (numThreads)
+                                                                         : nullptr);
+
+        {
+            const ScopedLock sl (lock);
+            parallelRenderer.swapWith (newRenderer);
+        }
+    }
+}
+
+int Synthesiser::getNumRenderingThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 1;
+}
+
 //==============================================================================
 void Synthesiser::setCurrentPlaybackSampleRate (const double newRate)
 {
@@ -232,14 +253,50 @@ template void Synthesiser::processNextBlock<double> (AudioBuffer<double>& output
                                                      int startSample,
                                                      int numSamples);
 
+struct SynthesiserVoiceRenderList  : public ParallelVoiceRenderer::VoiceList
+{
+    SynthesiserVoiceRenderList (const OwnedArray<SynthesiserVoice>& v) noexcept  : voices (v) {}
+
+    int getNumVoices() const override                   { return voices.size(); }
+    bool isVoiceActive (int index) const override       { return voices.getUnchecked (index)->isVoiceActive(); }
+
+    void renderVoice (int index, AudioBuffer<float>& buffer, int startSample, int numSamples) override
+    {
+        voices.getUnchecked (index)->renderNextBlock (buffer, startSample, numSamples);
+    }
+
+    void renderVoice (int index, AudioBuffer<double>& buffer, int startSample, int numSamples) override
+    {
+        voices.getUnchecked (index)->renderNextBlock (buffer, startSample, numSamples);
+    }
+
+    const OwnedArray<SynthesiserVoice>& voices;
+
+    JUCE_DECLARE_NON_COPYABLE (SynthesiserVoiceRenderList)
+};
+
 void Synthesiser::renderVoices (AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
+    if (parallelRenderer != nullptr)
+    {
+        SynthesiserVoiceRenderList voiceList (voices);
+        parallelRenderer->render (voiceList, buffer, startSample, numSamples);
+        return;
+    }
+
     for (int i = voices.size(); --i >= 0;)
         voices.getUnchecked (i)->renderNextBlock (buffer, startSample, numSamples);
 }
 
 void Synthesiser::renderVoices (AudioBuffer<double>& buffer, int startSample, int numSamples)
 {
+    if (parallelRenderer != nullptr)
+    {
+        SynthesiserVoiceRenderList voiceList (voices);
+        parallelRenderer->render (voiceList, buffer, startSample, numSamples);
+        return;
+    }
+
     for (int i = voices.size(); --i >= 0;)
         voices.getUnchecked (i)->renderNextBlock (buffer, startSample, numSamples);
 }
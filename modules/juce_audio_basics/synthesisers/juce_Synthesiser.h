@@ -542,6 +542,28 @@ public:
     */
     void setMinimumRenderingSubdivisionSize (int numSamples) noexcept;
 
+    //==============================================================================
+    /** Lets the synthesiser render its voices on several threads at once.
+
+        If you set this to a value greater than 1, the synth will start (numThreads - 1)
+        realtime-priority worker threads. Each time renderVoices() is called, the active
+        voices will be shared out between these and the thread that's calling renderNextBlock(),
+        and the results mixed together. The midi events are still handled between the
+        sub-blocks in the same way, so the timing is unaffected.
+
+        Your voices' renderNextBlock() methods must be safe to call at the same time as
+        each other for this to work. If you've overridden renderVoices(), then this has no
+        effect unless you use a ParallelVoiceRenderer in your own implementation.
+
+        @see getNumRenderingThreads, ParallelVoiceRenderer
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    /** Returns the number of threads that the synth is using to render its voices.
+        @see setNumRenderingThreads
+    */
+    int getNumRenderingThreads() const noexcept;
+
 protected:
     //==============================================================================
     /** This is used to control access to the rendering callback and the note trigger methods. */
@@ -617,6 +639,7 @@ private:
     int minimumSubBlockSize;
     bool shouldStealNotes;
     BigInteger sustainPedalsDown;
+    ScopedPointer<ParallelVoiceRenderer> parallelRenderer;
 
    #if JUCE_CATCH_DEPRECATED_CODE_MISUSE
     // Note the new parameters for these methods.
@@ -50,13 +50,28 @@ AudioTransportSource::~AudioTransportSource()
 void AudioTransportSource::setSource (PositionableAudioSource* const newSource,
                                       int readAheadSize, TimeSliceThread* readAheadThread,
                                       double sourceSampleRateToCorrectFor, int maxNumChannels)
+{
+    setSource (newSource, readAheadSize, readAheadThread, nullptr, sourceSampleRateToCorrectFor, maxNumChannels);
+}
+
+void AudioTransportSource::setSource (PositionableAudioSource* const newSource,
+                                      int readAheadSize, ReadAheadScheduler& readAheadScheduler,
+                                      double sourceSampleRateToCorrectFor, int maxNumChannels)
+{
+    setSource (newSource, readAheadSize, nullptr, &readAheadScheduler, sourceSampleRateToCorrectFor, maxNumChannels);
+}
+
+void AudioTransportSource::setSource (PositionableAudioSource* const newSource,
+                                      int readAheadSize, TimeSliceThread* readAheadThread,
+                                      ReadAheadScheduler* readAheadScheduler,
+                                      double sourceSampleRateToCorrectFor, int maxNumChannels)
 {
     if (source == newSource)
     {
         if (source == nullptr)
             return;
 
-        setSource (nullptr, 0, nullptr); // deselect and reselect to avoid releasing resources wrongly
+        setSource (nullptr, 0, nullptr, nullptr, 0.0, 2); // deselect and reselect to avoid releasing resources wrongly
     }
 
     readAheadBufferSize = readAheadSize;
@@ -78,12 +93,17 @@ void AudioTransportSource::setSource (PositionableAudioSource* const newSource,
         if (readAheadSize > 0)
         {
             // If you want to use a read-ahead buffer, you must also provide a TimeSliceThread
-            // for it to use!
-            jassert (readAheadThread != nullptr);
-
-            newPositionableSource = newBufferingSource
-                = new BufferingAudioSource (newPositionableSource, *readAheadThread,
-                                            false, readAheadSize, maxNumChannels);
+            // or ReadAheadScheduler for it to use!
+            jassert (readAheadThread != nullptr || readAheadScheduler != nullptr);
+
+            if (readAheadScheduler != nullptr)
+                newPositionableSource = newBufferingSource
+                    = new BufferingAudioSource (newPositionableSource, *readAheadScheduler,
+                                                false, readAheadSize, maxNumChannels);
+            else
+                newPositionableSource = newBufferingSource
+                    = new BufferingAudioSource (newPositionableSource, *readAheadThread,
+                                                false, readAheadSize, maxNumChannels);
         }
 
         newPositionableSource->setNextReadPosition (0);
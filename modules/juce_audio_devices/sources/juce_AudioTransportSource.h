@@ -82,6 +82,22 @@ public:
                     double sourceSampleRateToCorrectFor = 0.0,
                     int maxNumChannels = 2);
 
+    /** Sets the reader that is being used as the input source, and has its read-ahead
+        done by a ReadAheadScheduler.
+
+        This works like the other setSource() method, but the BufferingAudioSource that
+        is used for the read-ahead will be refilled by the scheduler rather than by a
+        TimeSliceThread. The scheduler must not be deleted while the AudioTransportSource
+        is still using it.
+
+        @see ReadAheadScheduler
+    */
+    void setSource (PositionableAudioSource* newSource,
+                    int readAheadBufferSize,
+                    ReadAheadScheduler& readAheadScheduler,
+                    double sourceSampleRateToCorrectFor = 0.0,
+                    int maxNumChannels = 2);
+
     //==============================================================================
     /** Changes the current playback position in the source stream.
 
@@ -172,6 +188,7 @@ private:
     bool volatile isPrepared, inputStreamEOF;
 
     void releaseMasterResources();
+    void setSource (PositionableAudioSource*, int, TimeSliceThread*, ReadAheadScheduler*, double, int);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioTransportSource)
 };
@@ -155,6 +155,12 @@ namespace FlacNamespace
 #undef max
 #undef min
 
+// Encoding in parallel needs to get at the encoder's internals, so is only possible
+// when we're building the bundled copy of libFLAC
+#if JUCE_INCLUDE_FLAC_CODE || ! defined (JUCE_INCLUDE_FLAC_CODE)
+ #define JUCE_FLAC_CAN_ENCODE_IN_PARALLEL 1
+#endif
+
 //==============================================================================
 static const char* const flacFormatName = "FLAC file";
 
@@ -167,6 +173,7 @@ public:
         : AudioFormatReader (in, flacFormatName),
           reservoirStart (0),
           samplesInReservoir (0),
+          lastFrameStart (0),
           scanningForLength (false)
     {
         using namespace FlacNamespace;
@@ -197,6 +204,8 @@ public:
                 lengthInSamples = tempLength;
             }
         }
+
+        seekIndex.setSourceDetails (input->getTotalLength(), lengthInSamples);
     }
 
     ~FlacReader()
@@ -254,9 +263,12 @@ public:
                 {
                     // had some problems with flac crashing if the read pos is aligned more
                     // accurately than this. Probably fixed in newer versions of the library, though.
-                    reservoirStart = (int) (startSampleInFile & ~511);
-                    samplesInReservoir = 0;
-                    FLAC__stream_decoder_seek_absolute (decoder, (FLAC__uint64) reservoirStart);
+                    if (! seekUsingIndex (startSampleInFile))
+                    {
+                        reservoirStart = (int) (startSampleInFile & ~511);
+                        samplesInReservoir = 0;
+                        FLAC__stream_decoder_seek_absolute (decoder, (FLAC__uint64) reservoirStart);
+                    }
                 }
                 else
                 {
@@ -280,6 +292,56 @@ public:
         return true;
     }
 
+    bool buildSeekIndex() override
+    {
+        using namespace FlacNamespace;
+
+        if (! ok || lengthInSamples <= 0)
+            return false;
+
+        AudioFormatSeekIndex newIndex;
+        newIndex.setSourceDetails (input->getTotalLength(), lengthInSamples);
+
+        // Every frame can be decoded on its own, so we just need to note down where
+        // some of them start. The samples themselves are thrown away.
+        scanningForLength = true;
+        const int64 originalLength = lengthInSamples;
+
+        FLAC__stream_decoder_reset (decoder);
+        FLAC__stream_decoder_process_until_end_of_metadata (decoder);
+
+        for (int frameNum = 0;; ++frameNum)
+        {
+            FLAC__uint64 framePosition = 0;
+
+            if (! FLAC__stream_decoder_get_decode_position (decoder, &framePosition))
+                break;
+
+            const int64 previousLength = lengthInSamples;
+            const bool decodedOk = FLAC__stream_decoder_process_single (decoder) != 0;
+
+            if (lengthInSamples != previousLength && (frameNum % framesPerIndexEntry) == 0)
+                newIndex.addEntry (lastFrameStart, (int64) framePosition);
+
+            if (! decodedOk || FLAC__stream_decoder_get_state (decoder) == FLAC__STREAM_DECODER_END_OF_STREAM)
+                break;
+        }
+
+        scanningForLength = false;
+        lengthInSamples = originalLength;
+
+        FLAC__stream_decoder_reset (decoder);
+        FLAC__stream_decoder_process_until_end_of_metadata (decoder);
+        reservoirStart = 0;
+        samplesInReservoir = 0;
+
+        if (newIndex.getNumEntries() == 0)
+            return false;
+
+        seekIndex = newIndex;
+        return true;
+    }
+
     void useSamples (const FlacNamespace::FLAC__int32* const buffer[], int numSamples)
     {
         if (scanningForLength)
@@ -354,7 +416,12 @@ public:
                                                                          void* client_data)
     {
         using namespace FlacNamespace;
-        static_cast<FlacReader*> (client_data)->useSamples (buffer, (int) frame->header.blocksize);
+        FlacReader* const reader = static_cast<FlacReader*> (client_data);
+
+        if (frame->header.number_type == FLAC__FRAME_NUMBER_TYPE_SAMPLE_NUMBER)
+            reader->lastFrameStart = (int64) frame->header.number.sample_number;
+
+        reader->useSamples (buffer, (int) frame->header.blocksize);
         return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
     }
 
@@ -373,8 +440,41 @@ private:
     FlacNamespace::FLAC__StreamDecoder* decoder;
     AudioSampleBuffer reservoir;
     int reservoirStart, samplesInReservoir;
+    int64 lastFrameStart;
     bool ok, scanningForLength;
 
+    enum { framesPerIndexEntry = 4 };
+
+    // Jumps straight to the nearest indexed frame, and decodes from there until the
+    // reservoir holds the target sample.
+    bool seekUsingIndex (const int64 targetSample)
+    {
+        using namespace FlacNamespace;
+
+        const AudioFormatSeekIndex::Entry* const entry = seekIndex.findEntryBefore (targetSample);
+
+        if (entry == nullptr
+             || ! input->setPosition (entry->streamPosition)
+             || ! FLAC__stream_decoder_flush (decoder))
+            return false;
+
+        for (;;)
+        {
+            samplesInReservoir = 0;
+
+            if (! FLAC__stream_decoder_process_single (decoder) || samplesInReservoir == 0)
+                return false;
+
+            reservoirStart = (int) lastFrameStart;
+
+            if (targetSample < reservoirStart)
+                return false;
+
+            if (targetSample < reservoirStart + samplesInReservoir)
+                return true;
+        }
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacReader)
 };
 
@@ -383,33 +483,37 @@ private:
 class FlacWriter  : public AudioFormatWriter
 {
 public:
-    FlacWriter (OutputStream* const out, double rate, uint32 numChans, uint32 bits, int qualityOptionIndex)
-        : AudioFormatWriter (out, flacFormatName, rate, numChans, bits)
+    FlacWriter (OutputStream* const out, double rate, uint32 numChans, uint32 bits,
+                int qualityOptionIndex, ThreadPool* threadPool)
+        : AudioFormatWriter (out, flacFormatName, rate, numChans, bits),
+          settings (rate, numChans, bits, qualityOptionIndex)
     {
         using namespace FlacNamespace;
         encoder = FLAC__stream_encoder_new();
-
-        if (qualityOptionIndex > 0)
-            FLAC__stream_encoder_set_compression_level (encoder, (uint32) jmin (8, qualityOptionIndex));
-
-        FLAC__stream_encoder_set_do_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_loose_mid_side_stereo (encoder, numChannels == 2);
-        FLAC__stream_encoder_set_channels (encoder, numChannels);
-        FLAC__stream_encoder_set_bits_per_sample (encoder, jmin ((unsigned int) 24, bitsPerSample));
-        FLAC__stream_encoder_set_sample_rate (encoder, (unsigned int) sampleRate);
-        FLAC__stream_encoder_set_blocksize (encoder, 0);
-        FLAC__stream_encoder_set_do_escape_coding (encoder, true);
+        settings.applyTo (encoder);
 
         ok = FLAC__stream_encoder_init_stream (encoder,
                                                encodeWriteCallback, encodeSeekCallback,
                                                encodeTellCallback, encodeMetadataCallback,
                                                this) == FLAC__STREAM_ENCODER_INIT_STATUS_OK;
+
+       #if JUCE_FLAC_CAN_ENCODE_IN_PARALLEL
+        if (ok && threadPool != nullptr)
+            parallelEncoder = new ParallelEncoder (*this, *threadPool);
+       #else
+        ignoreUnused (threadPool);
+       #endif
     }
 
     ~FlacWriter()
     {
         if (ok)
         {
+           #if JUCE_FLAC_CAN_ENCODE_IN_PARALLEL
+            if (parallelEncoder != nullptr)
+                parallelEncoder->finish();
+           #endif
+
             FlacNamespace::FLAC__stream_encoder_finish (encoder);
             output->flush();
         }
@@ -419,6 +523,10 @@ public:
                               // to the caller of createWriter()
         }
 
+       #if JUCE_FLAC_CAN_ENCODE_IN_PARALLEL
+        parallelEncoder = nullptr;
+       #endif
+
         FlacNamespace::FLAC__stream_encoder_delete (encoder);
     }
 
@@ -453,6 +561,11 @@ public:
             samplesToWrite = const_cast<const int**> (channels.getData());
         }
 
+       #if JUCE_FLAC_CAN_ENCODE_IN_PARALLEL
+        if (parallelEncoder != nullptr)
+            return parallelEncoder->write (samplesToWrite, numSamples);
+       #endif
+
         return FLAC__stream_encoder_process (encoder, (const FLAC__int32**) samplesToWrite, (unsigned) numSamples) != 0;
     }
 
@@ -541,8 +654,254 @@ public:
     bool ok;
 
 private:
+    //==============================================================================
+    struct EncoderSettings
+    {
+        EncoderSettings (double rate, uint32 numChans, uint32 bits, int quality) noexcept
+            : sampleRate ((unsigned int) rate), numChannels (numChans),
+              bitsPerSample (jmin ((uint32) 24, bits)), qualityOptionIndex (quality)
+        {}
+
+        void applyTo (FlacNamespace::FLAC__StreamEncoder* e) const
+        {
+            using namespace FlacNamespace;
+
+            if (qualityOptionIndex > 0)
+                FLAC__stream_encoder_set_compression_level (e, (uint32) jmin (8, qualityOptionIndex));
+
+            FLAC__stream_encoder_set_do_mid_side_stereo (e, numChannels == 2);
+            FLAC__stream_encoder_set_loose_mid_side_stereo (e, numChannels == 2);
+            FLAC__stream_encoder_set_channels (e, numChannels);
+            FLAC__stream_encoder_set_bits_per_sample (e, bitsPerSample);
+            FLAC__stream_encoder_set_sample_rate (e, sampleRate);
+            FLAC__stream_encoder_set_blocksize (e, 0);
+            FLAC__stream_encoder_set_do_escape_coding (e, true);
+        }
+
+        unsigned int sampleRate, numChannels, bitsPerSample;
+        int qualityOptionIndex;
+    };
+
+    const EncoderSettings settings;
     FlacNamespace::FLAC__StreamEncoder* encoder;
 
+   #if JUCE_FLAC_CAN_ENCODE_IN_PARALLEL
+    //==============================================================================
+    /*  FLAC frames don't depend on each other, so a long stream can be cut into chunks of
+        frames which are encoded by separate encoders on a thread pool, and the results
+        appended to the file in order.
+
+        To keep the output identical to what a single encoder would produce, each chunk's
+        encoder is told the number of its first frame, and the chunks are a multiple of the
+        loose mid-side stereo period long, so every chunk starts at the same point in that
+        cycle. The main encoder never sees any audio: it just writes the header, and is fed
+        the MD5, frame sizes and total length so that its STREAMINFO block comes out right.
+    */
+    class ParallelEncoder
+    {
+    public:
+        ParallelEncoder (FlacWriter& w, ThreadPool& p)
+            : owner (w), pool (p), nextFrameNumber (0), failed (false)
+        {
+            using namespace FlacNamespace;
+
+            const uint32 blockSize = FLAC__stream_encoder_get_blocksize (owner.encoder);
+            const uint32 stereoPeriod = jmax ((uint32) 1, owner.encoder->private_->loose_mid_side_stereo_frames);
+
+            framesPerChunk = stereoPeriod * jmax ((uint32) 1, 16 / stereoPeriod);
+            samplesPerChunk = (int) (framesPerChunk * blockSize);
+            maxChunksInFlight = 2 * jmax (1, pool.getNumThreads()) + 1;
+        }
+
+        ~ParallelEncoder()
+        {
+            for (int i = chunksInFlight.size(); --i >= 0;)
+                pool.removeJob (chunksInFlight.getUnchecked (i), true, -1);
+        }
+
+        bool write (const int** samples, int numSamples)
+        {
+            using namespace FlacNamespace;
+
+            if (failed)
+                return false;
+
+            FLAC__MD5Accumulate (&owner.encoder->private_->md5context, (const FLAC__int32* const*) samples,
+                                 owner.settings.numChannels, (unsigned) numSamples, (owner.settings.bitsPerSample + 7) / 8);
+
+            for (int offset = 0; offset < numSamples;)
+            {
+                if (currentChunk == nullptr)
+                    currentChunk = getSpareChunk();
+
+                const int numToCopy = jmin (numSamples - offset, samplesPerChunk - currentChunk->numSamples);
+                currentChunk->append (samples, offset, numToCopy);
+                offset += numToCopy;
+
+                if (currentChunk->numSamples == samplesPerChunk && ! startEncodingCurrentChunk())
+                    return false;
+            }
+
+            return writeFinishedChunks (false);
+        }
+
+        void finish()
+        {
+            if (currentChunk != nullptr && currentChunk->numSamples > 0)
+                startEncodingCurrentChunk();
+
+            writeFinishedChunks (true);
+        }
+
+    private:
+        //==============================================================================
+        struct Chunk  : public ThreadPoolJob
+        {
+            Chunk (const EncoderSettings& s, int maxSamples)
+                : ThreadPoolJob ("FLAC encoder"), settings (s),
+                  channelData ((size_t) (maxSamples * (int) s.numChannels)),
+                  channels (s.numChannels), numSamples (0), firstFrameNumber (0)
+            {
+                for (unsigned int i = 0; i < s.numChannels; ++i)
+                    channels[i] = channelData + (size_t) maxSamples * i;
+            }
+
+            void reset (uint32 firstFrame) noexcept
+            {
+                numSamples = 0;
+                firstFrameNumber = firstFrame;
+                encodedData.reset();
+                minFrameSize = 0xffffffff;
+                maxFrameSize = 0;
+                succeeded = false;
+            }
+
+            void append (const int** source, int startSample, int num) noexcept
+            {
+                for (unsigned int i = 0; i < settings.numChannels; ++i)
+                {
+                    if (source[i] != nullptr)
+                        memcpy (channels[i] + numSamples, source[i] + startSample, sizeof (int) * (size_t) num);
+                    else
+                        zeromem (channels[i] + numSamples, sizeof (int) * (size_t) num);
+                }
+
+                numSamples += num;
+            }
+
+            JobStatus runJob() override
+            {
+                using namespace FlacNamespace;
+
+                FLAC__StreamEncoder* const e = FLAC__stream_encoder_new();
+                settings.applyTo (e);
+                FLAC__stream_encoder_set_do_md5 (e, false);
+
+                if (FLAC__stream_encoder_init_stream (e, chunkWriteCallback, nullptr, nullptr, nullptr, this)
+                      == FLAC__STREAM_ENCODER_INIT_STATUS_OK)
+                {
+                    e->private_->current_frame_number = firstFrameNumber;
+
+                    succeeded = FLAC__stream_encoder_process (e, (const FLAC__int32**) channels.getData(), (unsigned) numSamples) != 0
+                                 && FLAC__stream_encoder_finish (e) != 0;
+                }
+
+                FLAC__stream_encoder_delete (e);
+                return jobHasFinished;
+            }
+
+            static FlacNamespace::FLAC__StreamEncoderWriteStatus chunkWriteCallback (const FlacNamespace::FLAC__StreamEncoder*,
+                                                                                     const FlacNamespace::FLAC__byte buffer[],
+                                                                                     size_t bytes, unsigned int samples,
+                                                                                     unsigned int /*current_frame*/, void* client_data)
+            {
+                // (the stream header that each encoder writes before its first frame is thrown away)
+                if (samples > 0)
+                {
+                    Chunk& chunk = *static_cast<Chunk*> (client_data);
+                    chunk.encodedData.write (buffer, bytes);
+                    chunk.minFrameSize = jmin (chunk.minFrameSize, (uint32) bytes);
+                    chunk.maxFrameSize = jmax (chunk.maxFrameSize, (uint32) bytes);
+                }
+
+                return FlacNamespace::FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+            }
+
+            const EncoderSettings& settings;
+            HeapBlock<int> channelData;
+            HeapBlock<int*> channels;
+            int numSamples;
+            uint32 firstFrameNumber, minFrameSize, maxFrameSize;
+            MemoryOutputStream encodedData;
+            bool succeeded;
+
+            JUCE_DECLARE_NON_COPYABLE (Chunk)
+        };
+
+        FlacWriter& owner;
+        ThreadPool& pool;
+        OwnedArray<Chunk> chunksInFlight, spareChunks;
+        ScopedPointer<Chunk> currentChunk;
+        uint32 framesPerChunk, nextFrameNumber;
+        int samplesPerChunk, maxChunksInFlight;
+        bool failed;
+
+        Chunk* getSpareChunk()
+        {
+            Chunk* c = spareChunks.size() > 0 ? spareChunks.removeAndReturn (spareChunks.size() - 1)
+                                              : new Chunk (owner.settings, samplesPerChunk);
+            c->reset (nextFrameNumber);
+            nextFrameNumber += framesPerChunk;
+            return c;
+        }
+
+        bool startEncodingCurrentChunk()
+        {
+            pool.addJob (chunksInFlight.add (currentChunk.release()), false);
+
+            while (chunksInFlight.size() > maxChunksInFlight)
+                if (! writeOldestChunk())
+                    return false;
+
+            return true;
+        }
+
+        bool writeFinishedChunks (bool waitForAll)
+        {
+            while (chunksInFlight.size() > 0 && (waitForAll || ! pool.contains (chunksInFlight.getFirst())))
+                if (! writeOldestChunk())
+                    return false;
+
+            return ! failed;
+        }
+
+        bool writeOldestChunk()
+        {
+            Chunk* const chunk = chunksInFlight.getFirst();
+            pool.waitForJobToFinish (chunk, -1);
+
+            if (! failed)
+            {
+                using namespace FlacNamespace;
+                FLAC__StreamMetadata_StreamInfo& info = owner.encoder->private_->streaminfo.data.stream_info;
+
+                failed = ! (chunk->succeeded && owner.writeData (chunk->encodedData.getData(), (int) chunk->encodedData.getDataSize()));
+                info.min_framesize = jmin (info.min_framesize, (unsigned) chunk->minFrameSize);
+                info.max_framesize = jmax (info.max_framesize, (unsigned) chunk->maxFrameSize);
+                info.total_samples += (FLAC__uint64) chunk->numSamples;
+            }
+
+            spareChunks.add (chunksInFlight.removeAndReturn (0));
+            return ! failed;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (ParallelEncoder)
+    };
+
+    friend class ParallelEncoder;
+    ScopedPointer<ParallelEncoder> parallelEncoder;
+   #endif
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacWriter)
 };
 
@@ -599,7 +958,26 @@ AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
     if (out != nullptr && getPossibleBitDepths().contains (bitsPerSample))
     {
         ScopedPointer<FlacWriter> w (new FlacWriter (out, sampleRate, numberOfChannels,
-                                                     (uint32) bitsPerSample, qualityOptionIndex));
+                                                     (uint32) bitsPerSample, qualityOptionIndex, nullptr));
+        if (w->ok)
+            return w.release();
+    }
+
+    return nullptr;
+}
+
+AudioFormatWriter* FlacAudioFormat::createWriterFor (OutputStream* out,
+                                                     double sampleRate,
+                                                     unsigned int numberOfChannels,
+                                                     int bitsPerSample,
+                                                     const StringPairArray& /*metadataValues*/,
+                                                     int qualityOptionIndex,
+                                                     ThreadPool& threadPool)
+{
+    if (out != nullptr && getPossibleBitDepths().contains (bitsPerSample))
+    {
+        ScopedPointer<FlacWriter> w (new FlacWriter (out, sampleRate, numberOfChannels,
+                                                     (uint32) bitsPerSample, qualityOptionIndex, &threadPool));
         if (w->ok)
             return w.release();
     }
@@ -613,4 +991,120 @@ StringArray FlacAudioFormat::getQualityOptions()
     return StringArray (options);
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_FLAC_CAN_ENCODE_IN_PARALLEL
+
+class FlacAudioFormatTests  : public UnitTest
+{
+public:
+    FlacAudioFormatTests() : UnitTest ("FLAC audio format") {}
+
+    static void fillWithTestSignal (AudioSampleBuffer& buffer, Random& r)
+    {
+        for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+        {
+            float* const data = buffer.getWritePointer (chan);
+            const double frequency = 0.01 + 0.003 * chan;
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                // a mixture of tone, noise and silence, so that all the subframe types get used
+                const int section = (i / 20000) % 3;
+
+                data[i] = section == 0 ? 0.5f * (float) std::sin (i * frequency) + 0.01f * (r.nextFloat() - 0.5f)
+                        : section == 1 ? r.nextFloat() * 1.8f - 0.9f
+                                       : 0.0f;
+            }
+        }
+    }
+
+    static MemoryBlock encode (const AudioSampleBuffer& buffer, int bitsPerSample, int quality, ThreadPool* pool, Random& r)
+    {
+        MemoryBlock result;
+
+        {
+            FlacAudioFormat format;
+            ScopedPointer<AudioFormatWriter> writer;
+            MemoryOutputStream* const out = new MemoryOutputStream (result, false);
+
+            if (pool != nullptr)
+                writer = format.createWriterFor (out, 44100.0, (unsigned int) buffer.getNumChannels(), bitsPerSample, StringPairArray(), quality, *pool);
+            else
+                writer = format.createWriterFor (out, 44100.0, (unsigned int) buffer.getNumChannels(), bitsPerSample, StringPairArray(), quality);
+
+            // write it in irregular blocks, so the chunk boundaries don't line up with them
+            for (int pos = 0; pos < buffer.getNumSamples();)
+            {
+                const int num = jmin (buffer.getNumSamples() - pos, 1 + r.nextInt (30000));
+                writer->writeFromAudioSampleBuffer (buffer, pos, num);
+                pos += num;
+            }
+        }
+
+        return result;
+    }
+
+    void runTest() override
+    {
+        ThreadPool pool (4);
+        Random r = getRandom();
+
+        beginTest ("Multi-threaded encoding");
+
+        const int channelCounts[] = { 1, 2, 6 };
+        const int qualities[] = { 0, 5, 8 };
+
+        for (int i = 0; i < numElementsInArray (channelCounts); ++i)
+        {
+            for (int j = 0; j < numElementsInArray (qualities); ++j)
+            {
+                const int bitsPerSample = r.nextBool() ? 16 : 24;
+                AudioSampleBuffer buffer (channelCounts[i], 1 + r.nextInt (150000));
+                fillWithTestSignal (buffer, r);
+
+                const MemoryBlock singleThreaded (encode (buffer, bitsPerSample, qualities[j], nullptr, r));
+                const MemoryBlock multiThreaded  (encode (buffer, bitsPerSample, qualities[j], &pool, r));
+                expect (singleThreaded == multiThreaded);
+
+                FlacAudioFormat format;
+                ScopedPointer<AudioFormatReader> reader (format.createReaderFor (new MemoryInputStream (multiThreaded, false), true));
+                expect (reader != nullptr && reader->lengthInSamples == buffer.getNumSamples());
+
+                if (reader != nullptr)
+                {
+                    AudioSampleBuffer decoded (buffer.getNumChannels(), buffer.getNumSamples());
+                    reader->read (&decoded, 0, buffer.getNumSamples(), 0, true, true);
+
+                    const float tolerance = 2.0f / (float) (1 << (bitsPerSample - 1));
+
+                    for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                    {
+                        decoded.addFrom (chan, 0, buffer, chan, 0, buffer.getNumSamples(), -1.0f);
+                        expect (decoded.getMagnitude (chan, 0, buffer.getNumSamples()) <= tolerance);
+                    }
+                }
+            }
+        }
+
+        beginTest ("Multi-threaded encoding speed");
+
+        AudioSampleBuffer buffer (2, 44100 * 20);
+        fillWithTestSignal (buffer, r);
+
+        const double start = Time::getMillisecondCounterHiRes();
+        encode (buffer, 24, 5, nullptr, r);
+        const double middle = Time::getMillisecondCounterHiRes();
+        encode (buffer, 24, 5, &pool, r);
+        const double end = Time::getMillisecondCounterHiRes();
+
+        logMessage ("20 seconds of stereo 24-bit audio: " + String (middle - start, 1) + "ms on one thread, "
+                      + String (end - middle, 1) + "ms with " + String (pool.getNumThreads()) + " threads (x"
+                      + String ((middle - start) / jmax (0.001, end - middle), 2) + ")");
+    }
+};
+
+static FlacAudioFormatTests flacAudioFormatUnitTests;
+
+#endif
+
 #endif
@@ -57,6 +57,26 @@ public:
                                         int bitsPerSample,
                                         const StringPairArray& metadataValues,
                                         int qualityOptionIndex) override;
+
+    /** Creates a writer which spreads the work of encoding across a thread pool.
+
+        The incoming audio is cut into chunks of frames which are compressed in parallel
+        by the pool's threads, and then appended to the stream in the right order. The
+        file that this produces is byte-for-byte identical to the one that the normal
+        single-threaded writer would create.
+
+        The pool must stay alive for as long as the writer exists. If libFLAC is being
+        linked from outside JUCE (i.e. JUCE_INCLUDE_FLAC_CODE is 0), this will just
+        return an ordinary single-threaded writer.
+    */
+    AudioFormatWriter* createWriterFor (OutputStream* streamToWriteTo,
+                                        double sampleRateToUse,
+                                        unsigned int numberOfChannels,
+                                        int bitsPerSample,
+                                        const StringPairArray& metadataValues,
+                                        int qualityOptionIndex,
+                                        ThreadPool& threadPool);
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlacAudioFormat)
 };
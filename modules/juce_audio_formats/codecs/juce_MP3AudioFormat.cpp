@@ -1395,9 +1395,10 @@ namespace DCT
 //==============================================================================
 struct MP3Stream
 {
-    MP3Stream (InputStream& source)
+    MP3Stream (InputStream& source, AudioFormatSeekIndex& index)
         : stream (source, 8192),
-          numFrames (0), currentFrameIndex (0), vbrHeaderFound (false)
+          numFrames (0), currentFrameIndex (0), vbrHeaderFound (false),
+          seekIndex (index)
     {
         reset();
     }
@@ -1565,27 +1566,47 @@ struct MP3Stream
     bool seek (int frameIndex)
     {
         frameIndex = jmax (0, frameIndex);
+        indexUpToFrame (frameIndex);
 
-        while (frameIndex >= frameStreamPositions.size() * storedStartPosInterval)
+        if (const AudioFormatSeekIndex::Entry* const entry = seekIndex.findEntryBefore (frameIndex * (int64) samplesPerFrame))
         {
-            int dummy = 0;
-            const int result = decodeNextBlock (nullptr, nullptr, dummy);
+            jumpTo (*entry);
+            return true;
+        }
 
-            if (result < 0)
-                return false;
+        return false;
+    }
 
-            if (result > 0)
-                break;
-        }
+    // Skims through the frames without decoding them, adding them to the seek index until
+    // it reaches the given frame or the end of the stream.
+    void indexUpToFrame (int frameIndex)
+    {
+        for (;;)
+        {
+            const int numEntries = seekIndex.getNumEntries();
 
-        frameIndex = jmin (frameIndex & ~(storedStartPosInterval - 1),
-                           frameStreamPositions.size() * storedStartPosInterval - 1);
-        stream.setPosition (frameStreamPositions.getUnchecked (frameIndex / storedStartPosInterval));
-        currentFrameIndex = frameIndex;
-        reset();
-        return true;
+            if (numEntries > 0)
+            {
+                const AudioFormatSeekIndex::Entry& lastEntry = seekIndex.getEntry (numEntries - 1);
+                const int lastIndexedFrame = (int) (lastEntry.samplePosition / samplesPerFrame);
+
+                if (frameIndex < lastIndexedFrame + storedStartPosInterval)
+                    return;
+
+                // no point going over ground that's already been indexed..
+                if (currentFrameIndex < lastIndexedFrame)
+                    jumpTo (lastEntry);
+            }
+
+            int dummy = 0;
+
+            if (decodeNextBlock (nullptr, nullptr, dummy) < 0 || stream.isExhausted())
+                return;
+        }
     }
 
+    enum { samplesPerFrame = 1152 };
+
     MP3Frame frame;
     VBRTagData vbrTagData;
     BufferedInputStream stream;
@@ -1593,6 +1614,8 @@ struct MP3Stream
     bool vbrHeaderFound;
 
 private:
+    AudioFormatSeekIndex& seekIndex;
+
     bool headerParsed, sideParsed, dataParsed, needToSyncBitStream;
     bool isFreeFormat, wasFreeFormat;
     int sideInfoSize, dataSize;
@@ -1626,7 +1649,13 @@ private:
     }
 
     enum { storedStartPosInterval = 4 };
-    Array<int64> frameStreamPositions;
+
+    void jumpTo (const AudioFormatSeekIndex::Entry& entry)
+    {
+        stream.setPosition (entry.streamPosition);
+        currentFrameIndex = (int) (entry.samplePosition / samplesPerFrame);
+        reset();
+    }
 
     struct SideInfoLayer1
     {
@@ -1739,7 +1768,7 @@ private:
         if (offset >= 0)
         {
             if ((currentFrameIndex & (storedStartPosInterval - 1)) == 0)
-                frameStreamPositions.set (currentFrameIndex / storedStartPosInterval, oldPos + offset);
+                seekIndex.addEntry (currentFrameIndex * (int64) samplesPerFrame, oldPos + offset);
 
             ++currentFrameIndex;
         }
@@ -2950,7 +2979,7 @@ class MP3Reader : public AudioFormatReader
 public:
     MP3Reader (InputStream* const in)
         : AudioFormatReader (in, mp3FormatName),
-          stream (*in), currentPosition (0),
+          stream (*in, seekIndex), currentPosition (0),
           decodedStart (0), decodedEnd (0)
     {
         skipID3();
@@ -2964,6 +2993,8 @@ public:
             numChannels = (unsigned int) stream.frame.numChannels;
             lengthInSamples = findLength (streamPos);
         }
+
+        seekIndex.setSourceDetails (in->getTotalLength(), lengthInSamples);
     }
 
     bool readSamples (int** destSamples, int numDestChannels, int startOffsetInDestBuffer,
@@ -3035,6 +3066,18 @@ public:
         return true;
     }
 
+    bool buildSeekIndex() override
+    {
+        if (sampleRate <= 0)
+            return false;
+
+        // The stream adds to the index as it goes along, so this just needs to skim
+        // through whatever part of the file hasn't been visited yet.
+        stream.indexUpToFrame (std::numeric_limits<int>::max());
+        currentPosition = -1;
+        return seekIndex.getNumEntries() > 0;
+    }
+
 private:
     MP3Stream stream;
     int64 currentPosition;
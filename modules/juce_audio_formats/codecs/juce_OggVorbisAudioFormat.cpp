@@ -142,6 +142,8 @@ public:
 
             reservoir.setSize ((int) numChannels, (int) jmin (lengthInSamples, (int64) 4096));
         }
+
+        seekIndex.setSourceDetails (input->getTotalLength(), lengthInSamples);
     }
 
     ~OggReader()
@@ -193,7 +195,7 @@ public:
                 samplesInReservoir = reservoir.getNumSamples();
 
                 if (reservoirStart != (int) OggVorbisNamespace::ov_pcm_tell (&ovFile))
-                    OggVorbisNamespace::ov_pcm_seek (&ovFile, reservoirStart);
+                    seekTo (reservoirStart);
 
                 int offset = 0;
                 int numToRead = samplesInReservoir;
@@ -230,6 +232,68 @@ public:
         return true;
     }
 
+    bool buildSeekIndex() override
+    {
+        using namespace OggVorbisNamespace;
+
+        // Chained streams restart their granule positions in each link, so only
+        // plain single-link files get indexed
+        if (sampleRate <= 0 || ! ovFile.seekable || ovFile.links != 1)
+            return false;
+
+        const int64 originalPosition = input->getPosition();
+        const ogg_int64_t firstGranule = ovFile.pcmlengths[0];
+        int64 pagePosition = ovFile.dataoffsets[0];
+
+        AudioFormatSeekIndex newIndex;
+        newIndex.setSourceDetails (input->getTotalLength(), lengthInSamples);
+        newIndex.addEntry (0, pagePosition);
+
+        ogg_sync_state sync;
+        ogg_sync_init (&sync);
+        input->setPosition (pagePosition);
+
+        for (;;)
+        {
+            ogg_page page;
+            const long pageSize = ogg_sync_pageseek (&sync, &page);
+
+            if (pageSize == 0)
+            {
+                const int bufferSize = 65536;
+                char* const buffer = ogg_sync_buffer (&sync, bufferSize);
+                const int bytesRead = input->read (buffer, bufferSize);
+
+                if (bytesRead <= 0)
+                    break;
+
+                ogg_sync_wrote (&sync, bytesRead);
+                continue;
+            }
+
+            if (pageSize < 0)
+            {
+                pagePosition -= pageSize;
+                continue;
+            }
+
+            pagePosition += pageSize;
+
+            // Decoding from the start of the page that follows this one will produce
+            // samples beginning somewhere after its granule position
+            const ogg_int64_t granule = ogg_page_granulepos (&page);
+
+            if (granule > 0 && ogg_page_serialno (&page) == ovFile.serialnos[0] && ! ogg_page_eos (&page))
+                newIndex.addEntry (granule - firstGranule, pagePosition);
+        }
+
+        ogg_sync_clear (&sync);
+        input->setPosition (originalPosition);
+
+        seekIndex = newIndex;
+        return true;
+    }
+
     //==============================================================================
     static size_t oggReadCallback (void* ptr, size_t size, size_t nmemb, void* datasource)
     {
@@ -260,6 +324,52 @@ public:
     }
 
 private:
+    // If there's an index, this jumps to the nearest indexed page before the target, and
+    // decodes forward from there. Otherwise it leaves it to the library to bisect the file.
+    void seekTo (const int64 targetSample)
+    {
+        using namespace OggVorbisNamespace;
+
+        for (const AudioFormatSeekIndex::Entry* entry = seekIndex.findEntryBefore (targetSample);
+             entry != nullptr;
+             entry = seekIndex.findEntryBefore (entry->samplePosition - 1))
+        {
+            if (ov_raw_seek (&ovFile, entry->streamPosition) != 0)
+                break;
+
+            const int64 position = (int64) ov_pcm_tell (&ovFile);
+
+            // the decoder needs a packet to warm up, so the page may start a little late
+            if (position >= 0 && position <= targetSample)
+            {
+                if (skipSamples (targetSample - position))
+                    return;
+
+                break;
+            }
+        }
+
+        ov_pcm_seek (&ovFile, targetSample);
+    }
+
+    bool skipSamples (int64 numToSkip)
+    {
+        while (numToSkip > 0)
+        {
+            float** dataIn = nullptr;
+            int bitStream = 0;
+
+            const long samps = OggVorbisNamespace::ov_read_float (&ovFile, &dataIn, (int) jmin (numToSkip, (int64) 4096), &bitStream);
+
+            if (samps <= 0)
+                return false;
+
+            numToSkip -= samps;
+        }
+
+        return true;
+    }
+
     OggVorbisNamespace::OggVorbis_File ovFile;
     OggVorbisNamespace::ov_callbacks callbacks;
     AudioSampleBuffer reservoir;
@@ -363,6 +363,23 @@ int64 AudioFormatReader::searchForLevel (int64 startSample,
     return -1;
 }
 
+//==============================================================================
+bool AudioFormatReader::buildSeekIndex()
+{
+    return false;
+}
+
+bool AudioFormatReader::setSeekIndex (const AudioFormatSeekIndex& newIndex)
+{
+    if (input == nullptr
+         || newIndex.getSourceStreamLength() != input->getTotalLength()
+         || newIndex.getSourceLengthInSamples() != lengthInSamples)
+        return false;
+
+    seekIndex = newIndex;
+    return true;
+}
+
 //==============================================================================
 MemoryMappedAudioFormatReader::MemoryMappedAudioFormatReader (const File& f, const AudioFormatReader& reader,
                                                               int64 start, int64 length, int frameSize)
@@ -189,6 +189,44 @@ public:
                           double magnitudeRangeMaximum,
                           int minimumConsecutiveSamples);
 
+    //==============================================================================
+    /** Scans the whole stream to build an index that lets the reader jump quickly and
+        accurately to any position in it.
+
+        This only makes a difference for compressed formats, where finding a particular
+        sample would otherwise involve scanning or bisecting the file. Once the index has
+        been built, seeking is just a binary search, so this is worth doing for long files
+        that will be played with a lot of random access, e.g. in a sampler.
+
+        Scanning a long file can take a while, so you may want to call this on a background
+        thread before giving the reader to your audio thread, or to build the index with a
+        separate reader and pass it to setSeekIndex(). You can also save the index with
+        AudioFormatSeekIndex::writeToStream() and load it again next time.
+
+        Returns false if the format doesn't support seek indexes, or if the stream couldn't
+        be scanned.
+
+        @see getSeekIndex, setSeekIndex
+    */
+    virtual bool buildSeekIndex();
+
+    /** Returns the reader's seek index.
+        This may be empty, or only cover part of the stream - some readers fill in their
+        index as they go along.
+        @see buildSeekIndex
+    */
+    const AudioFormatSeekIndex& getSeekIndex() const noexcept       { return seekIndex; }
+
+    /** Replaces the reader's seek index with one that was built earlier.
+
+        The index must have been made for a stream with the same length as this one,
+        otherwise this will return false and leave the current index untouched. Don't
+        call this while another thread might be reading from this object.
+
+        @see buildSeekIndex, AudioFormatSeekIndex::readFromStream
+    */
+    bool setSeekIndex (const AudioFormatSeekIndex& newIndex);
+
 
     //==============================================================================
     /** The sample-rate of the stream. */
@@ -242,6 +280,12 @@ public:
 
 
 protected:
+    //==============================================================================
+    /** The reader's seek index, for use by subclasses which support one.
+        @see buildSeekIndex
+    */
+    AudioFormatSeekIndex seekIndex;
+
     //==============================================================================
     /** Used by AudioFormatReader subclasses to copy data to different formats. */
     template <class DestSampleType, class SourceSampleType, class SourceEndianness>
@@ -254,6 +298,9 @@ protected:
         static void read (TargetType* const* destData, int destOffset, int numDestChannels,
                           const void* sourceData, int numSourceChannels, int numSamples) noexcept
         {
+            if (numSourceChannels > 1 && deinterleaveAll (destData, destOffset, numDestChannels, sourceData, numSourceChannels, numSamples))
+                return;
+
             for (int i = 0; i < numDestChannels; ++i)
             {
                 if (void* targetChan = destData[i])
@@ -268,6 +315,37 @@ protected:
                 }
             }
         }
+
+        /** If every source channel has a destination, this splits them all up in a single pass. */
+        template <typename TargetType>
+        static bool deinterleaveAll (TargetType* const* destData, int destOffset, int numDestChannels,
+                                     const void* sourceData, int numSourceChannels, int numSamples) noexcept
+        {
+            const int maxChannels = 8;
+            void* channels[maxChannels];
+
+            if (numSourceChannels > maxChannels || numDestChannels < numSourceChannels)
+                return false;
+
+            for (int i = 0; i < numSourceChannels; ++i)
+            {
+                if (destData[i] == nullptr)
+                    return false;
+
+                channels[i] = addBytesToPointer (destData[i], destOffset * DestType::getBytesPerSample());
+            }
+
+            if (! AudioData::BlockConversions::deinterleave (channels, AudioData::BlockConversions::getFormat<DestType>(),
+                                                             sourceData, AudioData::BlockConversions::getFormat<SourceType>(),
+                                                             numSourceChannels, numSamples))
+                return false;
+
+            for (int i = numSourceChannels; i < numDestChannels; ++i)
+                if (void* targetChan = destData[i])
+                    DestType (addBytesToPointer (targetChan, destOffset * DestType::getBytesPerSample())).clearSamples (numSamples);
+
+            return true;
+        }
     };
 
     /** Used by AudioFormatReader subclasses to clear any parts of the data blocks that lie
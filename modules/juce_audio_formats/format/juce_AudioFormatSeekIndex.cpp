@@ -0,0 +1,334 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace SeekIndexFormat
+{
+    static const int magicNumber = (int) ByteOrder::littleEndianInt ("JSIX");
+    static const int version = 1;
+}
+
+AudioFormatSeekIndex::AudioFormatSeekIndex() noexcept
+    : sourceStreamLength (0), sourceLengthInSamples (0)
+{
+}
+
+AudioFormatSeekIndex::AudioFormatSeekIndex (const AudioFormatSeekIndex& other)
+    : entries (other.entries),
+      sourceStreamLength (other.sourceStreamLength),
+      sourceLengthInSamples (other.sourceLengthInSamples)
+{
+}
+
+AudioFormatSeekIndex& AudioFormatSeekIndex::operator= (const AudioFormatSeekIndex& other)
+{
+    entries = other.entries;
+    sourceStreamLength = other.sourceStreamLength;
+    sourceLengthInSamples = other.sourceLengthInSamples;
+    return *this;
+}
+
+AudioFormatSeekIndex::~AudioFormatSeekIndex()
+{
+}
+
+void AudioFormatSeekIndex::clear() noexcept
+{
+    entries.clear();
+    sourceStreamLength = 0;
+    sourceLengthInSamples = 0;
+}
+
+void AudioFormatSeekIndex::addEntry (int64 samplePosition, int64 streamPosition)
+{
+    if (entries.size() == 0 || samplePosition > entries.getReference (entries.size() - 1).samplePosition)
+    {
+        const Entry e = { samplePosition, streamPosition };
+        entries.add (e);
+    }
+}
+
+const AudioFormatSeekIndex::Entry* AudioFormatSeekIndex::findEntryBefore (int64 samplePosition) const noexcept
+{
+    int start = 0, end = entries.size();
+
+    while (start < end)
+    {
+        const int mid = (start + end) / 2;
+
+        if (entries.getReference (mid).samplePosition <= samplePosition)
+            start = mid + 1;
+        else
+            end = mid;
+    }
+
+    return start > 0 ? &entries.getReference (start - 1) : nullptr;
+}
+
+void AudioFormatSeekIndex::setSourceDetails (int64 streamLengthInBytes, int64 lengthInSamples) noexcept
+{
+    sourceStreamLength = streamLengthInBytes;
+    sourceLengthInSamples = lengthInSamples;
+}
+
+//==============================================================================
+bool AudioFormatSeekIndex::writeToStream (OutputStream& output) const
+{
+    // The entries are stored as differences from the previous one, which keeps
+    // them down to a few bytes each.
+    if (! (output.writeInt (SeekIndexFormat::magicNumber)
+            && output.writeInt (SeekIndexFormat::version)
+            && output.writeInt64 (sourceStreamLength)
+            && output.writeInt64 (sourceLengthInSamples)
+            && output.writeCompressedInt (entries.size())))
+        return false;
+
+    Entry last = { 0, 0 };
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        const Entry& e = entries.getReference (i);
+
+        if (! (output.writeCompressedInt ((int) (e.samplePosition - last.samplePosition))
+                && output.writeCompressedInt ((int) (e.streamPosition - last.streamPosition))))
+            return false;
+
+        last = e;
+    }
+
+    return output.writeInt (SeekIndexFormat::magicNumber);
+}
+
+bool AudioFormatSeekIndex::readFromStream (InputStream& input)
+{
+    clear();
+
+    if (input.readInt() != SeekIndexFormat::magicNumber
+         || input.readInt() != SeekIndexFormat::version)
+        return false;
+
+    const int64 streamLength = input.readInt64();
+    const int64 lengthInSamples = input.readInt64();
+    const int numEntries = input.readCompressedInt();
+
+    if (numEntries < 0 || input.isExhausted())
+        return false;
+
+    entries.ensureStorageAllocated (numEntries);
+    Entry e = { 0, 0 };
+
+    for (int i = 0; i < numEntries; ++i)
+    {
+        const int sampleDelta = input.readCompressedInt();
+        const int streamDelta = input.readCompressedInt();
+
+        if ((sampleDelta <= 0 && i > 0) || sampleDelta < 0 || streamDelta < 0)
+        {
+            entries.clear();
+            return false;
+        }
+
+        e.samplePosition += sampleDelta;
+        e.streamPosition += streamDelta;
+        entries.add (e);
+    }
+
+    if (input.readInt() != SeekIndexFormat::magicNumber)
+    {
+        entries.clear();
+        return false;
+    }
+
+    setSourceDetails (streamLength, lengthInSamples);
+    return true;
+}
+
+File AudioFormatSeekIndex::getIndexFileFor (const File& audioFile)
+{
+    return audioFile.getSiblingFile (audioFile.getFileName() + ".seekindex");
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioFormatSeekIndexTests  : public UnitTest
+{
+public:
+    AudioFormatSeekIndexTests() : UnitTest ("Audio format seek index") {}
+
+    void runTest() override
+    {
+        Random r = getRandom();
+
+        beginTest ("Lookup");
+        {
+            AudioFormatSeekIndex index;
+            expect (index.findEntryBefore (0) == nullptr);
+
+            for (int i = 0; i < 1000; ++i)
+                index.addEntry (1000 + i * 1152, 4000 + i * 417);
+
+            index.addEntry (500, 1);
+            index.addEntry (1000 + 999 * 1152, 2);
+            expectEquals (index.getNumEntries(), 1000);
+
+            expect (index.findEntryBefore (999) == nullptr);
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                const int64 target = 1000 + r.nextInt (1200000);
+                const AudioFormatSeekIndex::Entry* e = index.findEntryBefore (target);
+
+                expect (e != nullptr);
+                expectEquals (e->samplePosition, jmin ((int64) 1000 + 999 * 1152, 1000 + ((target - 1000) / 1152) * 1152));
+                expectEquals (e->streamPosition, 4000 + ((e->samplePosition - 1000) / 1152) * 417);
+            }
+        }
+
+        beginTest ("Serialisation");
+        {
+            AudioFormatSeekIndex index;
+            int64 sample = r.nextInt (100), position = r.nextInt (1000);
+
+            for (int i = 0; i < 5000; ++i)
+            {
+                index.addEntry (sample, position);
+                sample += 1 + r.nextInt (8192);
+                position += r.nextInt (4096);
+            }
+
+            index.setSourceDetails (position + 1000, sample);
+
+            MemoryOutputStream out;
+            expect (index.writeToStream (out));
+            expect (out.getDataSize() < (size_t) index.getNumEntries() * 8);
+
+            AudioFormatSeekIndex loaded;
+            MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            expect (loaded.readFromStream (in));
+
+            expectEquals (loaded.getNumEntries(), index.getNumEntries());
+            expectEquals (loaded.getSourceStreamLength(), index.getSourceStreamLength());
+            expectEquals (loaded.getSourceLengthInSamples(), index.getSourceLengthInSamples());
+
+            for (int i = 0; i < index.getNumEntries(); ++i)
+            {
+                expectEquals (loaded.getEntry (i).samplePosition, index.getEntry (i).samplePosition);
+                expectEquals (loaded.getEntry (i).streamPosition, index.getEntry (i).streamPosition);
+            }
+
+            MemoryInputStream truncated (out.getData(), out.getDataSize() / 2, false);
+            expect (! loaded.readFromStream (truncated));
+
+            MemoryInputStream garbage ("not an index at all", 19, false);
+            expect (! loaded.readFromStream (garbage));
+            expectEquals (loaded.getNumEntries(), 0);
+        }
+
+       #if JUCE_USE_FLAC
+        {
+            FlacAudioFormat flac;
+            testSeekingWithIndex (flac, r);
+        }
+       #endif
+
+       #if JUCE_USE_OGGVORBIS
+        {
+            OggVorbisAudioFormat ogg;
+            testSeekingWithIndex (ogg, r);
+        }
+       #endif
+    }
+
+    void testSeekingWithIndex (AudioFormat& format, Random& r)
+    {
+        beginTest ("Seeking with an index: " + format.getFormatName());
+
+        AudioSampleBuffer source (2, 300000);
+
+        for (int chan = 0; chan < source.getNumChannels(); ++chan)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample (chan, i, 0.5f * (float) std::sin (i * (0.01 + 0.002 * chan)) + 0.2f * (r.nextFloat() - 0.5f));
+
+        MemoryBlock encoded;
+
+        {
+            ScopedPointer<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (encoded, false), 44100.0,
+                                                                              2, 16, StringPairArray(), 0));
+            expect (writer != nullptr);
+
+            if (writer == nullptr)
+                return;
+
+            writer->writeFromAudioSampleBuffer (source, 0, source.getNumSamples());
+        }
+
+        ScopedPointer<AudioFormatReader> reference (format.createReaderFor (new MemoryInputStream (encoded, false), true));
+        ScopedPointer<AudioFormatReader> indexed   (format.createReaderFor (new MemoryInputStream (encoded, false), true));
+        ScopedPointer<AudioFormatReader> restored  (format.createReaderFor (new MemoryInputStream (encoded, false), true));
+        expect (reference != nullptr && indexed != nullptr && restored != nullptr);
+
+        if (reference == nullptr || indexed == nullptr || restored == nullptr)
+            return;
+
+        const int length = (int) reference->lengthInSamples;
+        AudioSampleBuffer expected (2, length);
+        reference->read (&expected, 0, length, 0, true, true);
+
+        expect (indexed->buildSeekIndex());
+        expect (indexed->getSeekIndex().getNumEntries() > 10);
+
+        MemoryOutputStream savedIndex;
+        expect (indexed->getSeekIndex().writeToStream (savedIndex));
+
+        AudioFormatSeekIndex loadedIndex;
+        MemoryInputStream savedIndexInput (savedIndex.getData(), savedIndex.getDataSize(), false);
+        expect (loadedIndex.readFromStream (savedIndexInput));
+        expect (restored->setSeekIndex (loadedIndex));
+
+        loadedIndex.setSourceDetails (loadedIndex.getSourceStreamLength() + 1, loadedIndex.getSourceLengthInSamples());
+        expect (! reference->setSeekIndex (loadedIndex));
+
+        AudioSampleBuffer block (2, 3000);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            AudioFormatReader& reader = (i & 1) != 0 ? *indexed : *restored;
+            const int start = r.nextInt (length - block.getNumSamples());
+            const int num = 1 + r.nextInt (block.getNumSamples());
+            reader.read (&block, 0, num, start, true, true);
+
+            float maxError = 0;
+
+            for (int chan = 0; chan < 2; ++chan)
+                for (int j = 0; j < num; ++j)
+                    maxError = jmax (maxError, std::abs (block.getSample (chan, j) - expected.getSample (chan, start + j)));
+
+            expect (maxError < 1.0e-4f, "Mismatch reading " + String (num) + " samples at " + String (start));
+        }
+    }
+};
+
+static AudioFormatSeekIndexTests audioFormatSeekIndexTests;
+
+#endif
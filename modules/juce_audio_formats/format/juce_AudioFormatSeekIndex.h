@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_AUDIOFORMATSEEKINDEX_H_INCLUDED
+#define JUCE_AUDIOFORMATSEEKINDEX_H_INCLUDED
+
+
+//==============================================================================
+/**
+    A table of positions in a compressed audio stream from which decoding can be
+    restarted, sorted by the sample number that each one corresponds to.
+
+    Readers for compressed formats like MP3, Ogg-Vorbis and FLAC can use one of these
+    to jump straight to the right part of a stream with a binary search, instead of
+    having to scan or bisect the file. An AudioFormatReader keeps its own index, which
+    you can fill with AudioFormatReader::buildSeekIndex(), or replace with one that was
+    saved earlier using AudioFormatReader::setSeekIndex().
+
+    @see AudioFormatReader::buildSeekIndex
+*/
+class JUCE_API  AudioFormatSeekIndex
+{
+public:
+    //==============================================================================
+    /** Creates an empty index. */
+    AudioFormatSeekIndex() noexcept;
+
+    /** Creates a copy of another index. */
+    AudioFormatSeekIndex (const AudioFormatSeekIndex&);
+
+    /** Copies another index. */
+    AudioFormatSeekIndex& operator= (const AudioFormatSeekIndex&);
+
+    /** Destructor. */
+    ~AudioFormatSeekIndex();
+
+    //==============================================================================
+    /** A position in the stream, and the sample that it corresponds to. */
+    struct Entry
+    {
+        /** The first sample that the decoder will produce when it starts reading at streamPosition. */
+        int64 samplePosition;
+
+        /** The byte offset from the start of the stream. */
+        int64 streamPosition;
+    };
+
+    /** Removes all the entries, and forgets the details of the source stream. */
+    void clear() noexcept;
+
+    /** Appends an entry to the end of the index.
+
+        Entries must be added in order - if the sample position isn't beyond that of the
+        last entry, this does nothing, so it's safe for a reader to call it again for
+        parts of the stream that it has already indexed.
+    */
+    void addEntry (int64 samplePosition, int64 streamPosition);
+
+    /** Returns the number of entries in the index. */
+    int getNumEntries() const noexcept                          { return entries.size(); }
+
+    /** Returns one of the entries. */
+    const Entry& getEntry (int index) const noexcept            { return entries.getReference (index); }
+
+    /** Returns the last entry whose sample position is less than or equal to the one given.
+        This uses a binary search, and returns nullptr if there's no such entry.
+    */
+    const Entry* findEntryBefore (int64 samplePosition) const noexcept;
+
+    //==============================================================================
+    /** Records the size of the stream that the index was made for.
+        This is used to make sure that an index which was saved to disk still matches
+        the file that it is loaded for.
+    */
+    void setSourceDetails (int64 streamLengthInBytes, int64 lengthInSamples) noexcept;
+
+    /** Returns the stream length that was passed to setSourceDetails(). */
+    int64 getSourceStreamLength() const noexcept                { return sourceStreamLength; }
+
+    /** Returns the length in samples that was passed to setSourceDetails(). */
+    int64 getSourceLengthInSamples() const noexcept             { return sourceLengthInSamples; }
+
+    //==============================================================================
+    /** Writes the index to a stream in a compact binary form.
+        @see readFromStream
+    */
+    bool writeToStream (OutputStream& output) const;
+
+    /** Replaces the contents of this index with data that was written by writeToStream().
+        If the data isn't valid, the index is left empty and this returns false.
+    */
+    bool readFromStream (InputStream& input);
+
+    /** Returns the file that's normally used to store the index for an audio file.
+        This is just the audio file's name with ".seekindex" appended, in the same folder.
+    */
+    static File getIndexFileFor (const File& audioFile);
+
+private:
+    //==============================================================================
+    Array<Entry> entries;
+    int64 sourceStreamLength, sourceLengthInSamples;
+
+    JUCE_LEAK_DETECTOR (AudioFormatSeekIndex)
+};
+
+
+#endif   // JUCE_AUDIOFORMATSEEKINDEX_H_INCLUDED
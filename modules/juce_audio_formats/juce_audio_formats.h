@@ -112,6 +112,7 @@ namespace juce
 {
 
 class AudioFormat;
+#include "format/juce_AudioFormatSeekIndex.h"
 #include "format/juce_AudioFormatReader.h"
 #include "format/juce_AudioFormatWriter.h"
 #include "format/juce_MemoryMappedAudioFormatReader.h"
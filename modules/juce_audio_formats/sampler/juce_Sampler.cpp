@@ -30,14 +30,68 @@ SamplerSound::SamplerSound (const String& soundName,
                             const double releaseTimeSecs,
                             const double maxSampleLengthSeconds)
     : name (soundName),
+      sourceIsMemoryMapped (false),
       midiNotes (notes),
       midiRootNote (midiNoteForNormalPitch)
+{
+    loadSamples (source, attackTimeSecs, releaseTimeSecs, maxSampleLengthSeconds, maxSampleLengthSeconds);
+}
+
+SamplerSound::SamplerSound (const String& soundName,
+                            AudioFormatReader* const sourceToStreamFrom,
+                            const BigInteger& notes,
+                            const int midiNoteForNormalPitch,
+                            const double attackTimeSecs,
+                            const double releaseTimeSecs,
+                            const double maxSampleLengthSeconds,
+                            const double preloadTimeSecs)
+    : name (soundName),
+      streamingSource (sourceToStreamFrom),
+      sourceIsMemoryMapped (false),
+      midiNotes (notes),
+      midiRootNote (midiNoteForNormalPitch)
+{
+    jassert (sourceToStreamFrom != nullptr);
+
+    if (MemoryMappedAudioFormatReader* const mapped = dynamic_cast<MemoryMappedAudioFormatReader*> (sourceToStreamFrom))
+    {
+        if (mapped->getMappedSection().isEmpty())
+            mapped->mapEntireFile();
+
+        sourceIsMemoryMapped = mapped->getMappedSection().contains (Range<int64> (0, mapped->lengthInSamples));
+    }
+
+    if (sourceToStreamFrom != nullptr)
+    {
+        loadSamples (*sourceToStreamFrom, attackTimeSecs, releaseTimeSecs, maxSampleLengthSeconds, preloadTimeSecs);
+    }
+    else
+    {
+        sourceSampleRate = 0;
+        length = preloadLength = attackSamples = releaseSamples = 0;
+    }
+
+    // If the whole sample fits into the preload buffer, there's no need to stream it.
+    if (preloadLength >= length)
+        streamingSource = nullptr;
+}
+
+SamplerSound::~SamplerSound()
+{
+}
+
+void SamplerSound::loadSamples (AudioFormatReader& source,
+                                const double attackTimeSecs,
+                                const double releaseTimeSecs,
+                                const double maxSampleLengthSeconds,
+                                const double preloadTimeSecs)
 {
     sourceSampleRate = source.sampleRate;
 
     if (sourceSampleRate <= 0 || source.lengthInSamples <= 0)
     {
         length = 0;
+        preloadLength = 0;
         attackSamples = 0;
         releaseSamples = 0;
     }
@@ -46,17 +100,45 @@ SamplerSound::SamplerSound (const String& soundName,
         length = jmin ((int) source.lengthInSamples,
                        (int) (maxSampleLengthSeconds * sourceSampleRate));
 
-        data = new AudioSampleBuffer (jmin (2, (int) source.numChannels), length + 4);
+        preloadLength = jlimit (0, length, (int) (preloadTimeSecs * sourceSampleRate));
+
+        data = new AudioSampleBuffer (jmin (2, (int) source.numChannels), preloadLength + 4);
+        data->clear();
 
-        source.read (data, 0, length + 4, 0, true, true);
+        source.read (data, 0, jmin (preloadLength + 4, (int) source.lengthInSamples), 0, true, true);
 
         attackSamples = roundToInt (attackTimeSecs * sourceSampleRate);
         releaseSamples = roundToInt (releaseTimeSecs * sourceSampleRate);
     }
 }
 
-SamplerSound::~SamplerSound()
+void SamplerSound::readFromSource (AudioSampleBuffer& buffer, int startSample, int numSamples, int64 sourceStartSample)
 {
+    jassert (streamingSource != nullptr && sourceStartSample + numSamples <= length);
+
+    // memory-mapped readers don't keep any state, so several threads can read at once
+    if (sourceIsMemoryMapped)
+    {
+        streamingSource->read (&buffer, startSample, numSamples, sourceStartSample, true, true);
+    }
+    else
+    {
+        const ScopedLock sl (sourceLock);
+        streamingSource->read (&buffer, startSample, numSamples, sourceStartSample, true, true);
+    }
+}
+
+AudioFormatReader* SamplerSound::createStreamingReader (AudioFormatManager& formatManager, const File& audioFile)
+{
+    if (AudioFormat* const format = formatManager.findFormatForFileExtension (audioFile.getFileExtension()))
+    {
+        ScopedPointer<MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (audioFile));
+
+        if (mapped != nullptr && mapped->mapEntireFile())
+            return mapped.release();
+    }
+
+    return formatManager.createReaderFor (audioFile);
 }
 
 bool SamplerSound::appliesToNote (int midiNoteNumber)
@@ -69,23 +151,191 @@ bool SamplerSound::appliesToChannel (int /*midiChannel*/)
     return true;
 }
 
+//==============================================================================
+struct SamplerDiskStreamer::Stream
+{
+    Stream (const int bufferSize)
+        : fifo (bufferSize), buffer (2, bufferSize), nextSourceSample (0), endSample (0),
+          scratch (2, 1024), readPosition (0), startPending (false)
+    {
+    }
+
+    // Shared between the voice and the disk threads. The voice only writes to the fields
+    // below the lock when it manages to grab it without waiting.
+    AbstractFifo fifo;
+    AudioSampleBuffer buffer;
+    CriticalSection lock;
+    SynthesiserSound::Ptr sound;
+    int64 nextSourceSample, endSample;
+    Atomic<int> active, refillRequested, inUse, numUnderruns;
+
+    // Only used by the voice.
+    AudioSampleBuffer scratch;
+    int64 readPosition;
+    bool startPending;
+
+    JUCE_DECLARE_NON_COPYABLE (Stream)
+};
+
+class SamplerDiskStreamer::ReaderJob  : public ThreadPoolJob
+{
+public:
+    ReaderJob (SamplerDiskStreamer& s)  : ThreadPoolJob ("Sampler disk reader"), owner (s) {}
+
+    JobStatus runJob() override
+    {
+        while (! shouldExit())
+        {
+            Stream* stream;
+
+            if (owner.requests.waitAndPop (stream, 50))
+                owner.refill (*stream);
+        }
+
+        return jobHasFinished;
+    }
+
+private:
+    SamplerDiskStreamer& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (ReaderJob)
+};
+
+SamplerDiskStreamer::SamplerDiskStreamer (const int numThreads, const int bufferSizeSamples)
+    : bufferSize (jmax (256, bufferSizeSamples)),
+      requests (1024),
+      pool (jmax (1, numThreads))
+{
+    for (int i = jmax (1, numThreads); --i >= 0;)
+        pool.addJob (new ReaderJob (*this), true);
+}
+
+SamplerDiskStreamer::~SamplerDiskStreamer()
+{
+    pool.removeAllJobs (true, 4000);
+
+   #if JUCE_DEBUG
+    for (int i = 0; i < streams.size(); ++i)
+        jassert (streams.getUnchecked(i)->inUse.get() == 0); // all the voices must be deleted before the streamer!
+   #endif
+}
+
+SamplerDiskStreamer::Stream* SamplerDiskStreamer::getFreeStream()
+{
+    const ScopedLock sl (streamListLock);
+
+    for (int i = 0; i < streams.size(); ++i)
+    {
+        Stream* const s = streams.getUnchecked (i);
+
+        if (s->inUse.compareAndSetBool (1, 0))
+            return s;
+    }
+
+    Stream* const s = streams.add (new Stream (bufferSize));
+    s->inUse = 1;
+    return s;
+}
+
+void SamplerDiskStreamer::requestRefill (Stream& s) noexcept
+{
+    if (s.refillRequested.compareAndSetBool (1, 0))
+        if (! requests.push (&s))
+            s.refillRequested = 0;
+}
+
+void SamplerDiskStreamer::refill (Stream& s)
+{
+    s.refillRequested = 0;
+
+    const ScopedLock sl (s.lock);
+
+    if (s.active.get() == 0)
+    {
+        s.sound = nullptr;
+        return;
+    }
+
+    SamplerSound* const sound = static_cast<SamplerSound*> (s.sound.get());
+    jassert (sound != nullptr);
+
+    const int numToRead = (int) jmin ((int64) s.fifo.getFreeSpace(), s.endSample - s.nextSourceSample);
+
+    if (numToRead > 0)
+    {
+        int start1, size1, start2, size2;
+        s.fifo.prepareToWrite (numToRead, start1, size1, start2, size2);
+
+        if (size1 > 0)  sound->readFromSource (s.buffer, start1, size1, s.nextSourceSample);
+        if (size2 > 0)  sound->readFromSource (s.buffer, start2, size2, s.nextSourceSample + size1);
+
+        s.fifo.finishedWrite (size1 + size2);
+        s.nextSourceSample += size1 + size2;
+
+        ++numReads;
+        numSamplesRead += size1 + size2;
+    }
+}
+
+SamplerDiskStreamer::Statistics SamplerDiskStreamer::getStatistics() const noexcept
+{
+    Statistics stats;
+    stats.numUnderruns     = numUnderruns.get();
+    stats.numSamplesMissed = numSamplesMissed.get();
+    stats.numReads         = numReads.get();
+    stats.numSamplesRead   = numSamplesRead.get();
+    return stats;
+}
+
+void SamplerDiskStreamer::resetStatistics() noexcept
+{
+    numUnderruns = 0;
+    numSamplesMissed = 0;
+    numReads = 0;
+    numSamplesRead = 0;
+}
+
 //==============================================================================
 SamplerVoice::SamplerVoice()
     : pitchRatio (0.0),
       sourceSamplePosition (0.0),
       lgain (0.0f), rgain (0.0f),
       attackReleaseLevel (0), attackDelta (0), releaseDelta (0),
-      isInAttack (false), isInRelease (false)
+      isInAttack (false), isInRelease (false),
+      streamer (nullptr), stream (nullptr)
+{
+}
+
+SamplerVoice::SamplerVoice (SamplerDiskStreamer& s)
+    : pitchRatio (0.0),
+      sourceSamplePosition (0.0),
+      lgain (0.0f), rgain (0.0f),
+      attackReleaseLevel (0), attackDelta (0), releaseDelta (0),
+      isInAttack (false), isInRelease (false),
+      streamer (&s), stream (s.getFreeStream())
 {
 }
 
 SamplerVoice::~SamplerVoice()
 {
+    if (stream != nullptr)
+    {
+        {
+            const ScopedLock sl (stream->lock);
+            stream->active = 0;
+            stream->sound = nullptr;
+        }
+
+        stream->inUse = 0;
+    }
 }
 
 bool SamplerVoice::canPlaySound (SynthesiserSound* sound)
 {
-    return dynamic_cast<const SamplerSound*> (sound) != nullptr;
+    if (const SamplerSound* const samplerSound = dynamic_cast<const SamplerSound*> (sound))
+        return stream != nullptr || ! samplerSound->isStreaming();
+
+    return false;
 }
 
 void SamplerVoice::startNote (const int midiNoteNumber,
@@ -120,6 +370,12 @@ void SamplerVoice::startNote (const int midiNoteNumber,
             releaseDelta = (float) (-pitchRatio / sound->releaseSamples);
         else
             releaseDelta = -1.0f;
+
+        if (sound->isStreaming())
+        {
+            jassert (stream != nullptr); // this voice needs a SamplerDiskStreamer to play this sound!
+            startStreaming();
+        }
     }
     else
     {
@@ -136,6 +392,7 @@ void SamplerVoice::stopNote (float /*velocity*/, bool allowTailOff)
     }
     else
     {
+        stopStreaming();
         clearCurrentNote();
     }
 }
@@ -149,76 +406,360 @@ void SamplerVoice::controllerMoved (const int /*controllerNumber*/,
 {
 }
 
+int SamplerVoice::getNumUnderruns() const noexcept
+{
+    return stream != nullptr ? stream->numUnderruns.get() : 0;
+}
+
 //==============================================================================
+bool SamplerVoice::startStreaming()
+{
+    if (stream == nullptr)
+        return false;
+
+    SamplerDiskStreamer::Stream& s = *stream;
+    const SamplerSound* const sound = static_cast<const SamplerSound*> (getCurrentlyPlayingSound().get());
+
+    {
+        // If a disk thread is still busy with this voice's previous note, we'll try again
+        // on the next block, and meanwhile play from the preloaded part of the sample.
+        const ScopedTryLock sl (s.lock);
+
+        if (! sl.isLocked() || sound == nullptr)
+        {
+            s.startPending = true;
+            return false;
+        }
+
+        s.fifo.reset();
+        s.sound = getCurrentlyPlayingSound();
+        s.nextSourceSample = sound->preloadLength;
+        s.endSample = sound->length;
+        s.readPosition = sound->preloadLength;
+        s.startPending = false;
+        s.active = 1;
+    }
+
+    streamer->requestRefill (s);
+    return true;
+}
+
+void SamplerVoice::stopStreaming() noexcept
+{
+    if (stream != nullptr && (stream->active.get() != 0 || stream->startPending))
+    {
+        stream->startPending = false;
+        stream->active = 0;
+
+        // this lets a disk thread release the voice's reference to the sound
+        streamer->requestRefill (*stream);
+    }
+}
+
 void SamplerVoice::renderNextBlock (AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
     if (const SamplerSound* const playingSound = static_cast<SamplerSound*> (getCurrentlyPlayingSound().get()))
     {
-        const float* const inL = playingSound->data->getReadPointer (0);
-        const float* const inR = playingSound->data->getNumChannels() > 1
-                                    ? playingSound->data->getReadPointer (1) : nullptr;
-
         float* outL = outputBuffer.getWritePointer (0, startSample);
         float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer (1, startSample) : nullptr;
 
-        while (--numSamples >= 0)
+        if (playingSound->isStreaming())
+        {
+            renderStreaming (*playingSound, outL, outR, numSamples);
+        }
+        else
         {
-            const int pos = (int) sourceSamplePosition;
-            const float alpha = (float) (sourceSamplePosition - pos);
-            const float invAlpha = 1.0f - alpha;
+            const float* const inL = playingSound->data->getReadPointer (0);
+            const float* const inR = playingSound->data->getNumChannels() > 1
+                                        ? playingSound->data->getReadPointer (1) : nullptr;
 
-            // just using a very simple linear interpolation here..
-            float l = (inL [pos] * invAlpha + inL [pos + 1] * alpha);
-            float r = (inR != nullptr) ? (inR [pos] * invAlpha + inR [pos + 1] * alpha)
-                                       : l;
+            render (inL, inR, 0, outL, outR, numSamples, playingSound->length);
+        }
+    }
+}
 
-            l *= lgain;
-            r *= rgain;
+void SamplerVoice::renderStreaming (const SamplerSound& sound, float*& outL, float*& outR, int numSamples)
+{
+    SamplerDiskStreamer::Stream& s = *stream;
 
-            if (isInAttack)
-            {
-                l *= attackReleaseLevel;
-                r *= attackReleaseLevel;
+    if (s.startPending)
+        startStreaming();
 
-                attackReleaseLevel += attackDelta;
+    const AudioSampleBuffer& head = *sound.data;
+    const int numChannels = head.getNumChannels();
+    const int scratchSize = s.scratch.getNumSamples();
+    int numMissing = 0;
 
-                if (attackReleaseLevel >= 1.0f)
-                {
-                    attackReleaseLevel = 1.0f;
-                    isInAttack = false;
-                }
-            }
-            else if (isInRelease)
+    while (numSamples > 0)
+    {
+        // Work out how much of the source the next chunk of output will need..
+        const int firstSourceSample = (int) sourceSamplePosition;
+        const int numThisTime = jmax (1, jmin (numSamples, (int) ((scratchSize - 2) / pitchRatio)));
+        const int numSourceSamples = jmin (scratchSize, (int) (sourceSamplePosition + (numThisTime - 1) * pitchRatio)
+                                                          - firstSourceSample + 2);
+
+        if (firstSourceSample + numSourceSamples <= head.getNumSamples())
+        {
+            if (! render (head.getReadPointer (0), numChannels > 1 ? head.getReadPointer (1) : nullptr,
+                          0, outL, outR, numThisTime, sound.length))
+                break;
+
+            numSamples -= numThisTime;
+            continue;
+        }
+
+        // ..and gather it into the scratch buffer, from the preloaded head of the
+        // sample followed by whatever the disk threads have put into the ring buffer.
+        int pos = firstSourceSample;
+        const int end = firstSourceSample + numSourceSamples;
+
+        if (pos < head.getNumSamples())
+        {
+            const int num = head.getNumSamples() - pos;
+
+            for (int i = 0; i < numChannels; ++i)
+                s.scratch.copyFrom (i, 0, head, i, pos, num);
+
+            pos += num;
+        }
+
+        if (! s.startPending)
+        {
+            int numReady = s.fifo.getNumReady();
+
+            // the samples before this chunk won't be needed again
+            const int numToDiscard = (int) jlimit ((int64) 0, (int64) numReady, firstSourceSample - s.readPosition);
+
+            if (numToDiscard > 0)
             {
-                l *= attackReleaseLevel;
-                r *= attackReleaseLevel;
+                s.fifo.finishedRead (numToDiscard);
+                s.readPosition += numToDiscard;
+                numReady -= numToDiscard;
+            }
 
-                attackReleaseLevel += releaseDelta;
+            if (pos >= s.readPosition)
+            {
+                const int offset = (int) (pos - s.readPosition);
+                const int num = jmin (end, (int) (s.readPosition + numReady)) - pos;
 
-                if (attackReleaseLevel <= 0.0f)
+                if (num > 0)
                 {
-                    stopNote (0.0f, false);
-                    break;
+                    int start1, size1, start2, size2;
+                    s.fifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+                    for (int done = 0; done < num;)
+                    {
+                        const int fifoIndex = offset + done;
+                        const int bufferIndex = fifoIndex < size1 ? start1 + fifoIndex : start2 + (fifoIndex - size1);
+                        const int numToCopy = jmin (num - done, fifoIndex < size1 ? size1 - fifoIndex
+                                                                                  : size1 + size2 - fifoIndex);
+
+                        for (int i = 0; i < numChannels; ++i)
+                            s.scratch.copyFrom (i, pos - firstSourceSample, s.buffer, i, bufferIndex, numToCopy);
+
+                        pos += numToCopy;
+                        done += numToCopy;
+                    }
                 }
             }
+        }
 
-            if (outR != nullptr)
-            {
-                *outL++ += l;
-                *outR++ += r;
-            }
-            else
+        if (pos < end)
+        {
+            for (int i = 0; i < numChannels; ++i)
+                s.scratch.clear (i, pos - firstSourceSample, end - pos);
+
+            // running past the end of the sample is fine, but anything before that is an underrun
+            numMissing += jmax (0, jmin (end, sound.length) - pos);
+        }
+
+        if (! render (s.scratch.getReadPointer (0), numChannels > 1 ? s.scratch.getReadPointer (1) : nullptr,
+                      firstSourceSample, outL, outR, numThisTime, sound.length))
+            break;
+
+        numSamples -= numThisTime;
+    }
+
+    if (numMissing > 0)
+    {
+        ++s.numUnderruns;
+        ++(streamer->numUnderruns);
+        streamer->numSamplesMissed += numMissing;
+    }
+
+    if (s.active.get() != 0
+         && s.readPosition + s.fifo.getNumReady() < sound.length
+         && s.fifo.getFreeSpace() >= streamer->bufferSize / 4)
+        streamer->requestRefill (s);
+}
+
+bool SamplerVoice::render (const float* const inL, const float* const inR, const int firstSourceSample,
+                           float*& outL, float*& outR, int numSamples, const int length)
+{
+    while (--numSamples >= 0)
+    {
+        const int pos = (int) sourceSamplePosition;
+        const float alpha = (float) (sourceSamplePosition - pos);
+        const float invAlpha = 1.0f - alpha;
+        const int index = pos - firstSourceSample;
+
+        // just using a very simple linear interpolation here..
+        float l = (inL [index] * invAlpha + inL [index + 1] * alpha);
+        float r = (inR != nullptr) ? (inR [index] * invAlpha + inR [index + 1] * alpha)
+                                   : l;
+
+        l *= lgain;
+        r *= rgain;
+
+        if (isInAttack)
+        {
+            l *= attackReleaseLevel;
+            r *= attackReleaseLevel;
+
+            attackReleaseLevel += attackDelta;
+
+            if (attackReleaseLevel >= 1.0f)
             {
-                *outL++ += (l + r) * 0.5f;
+                attackReleaseLevel = 1.0f;
+                isInAttack = false;
             }
+        }
+        else if (isInRelease)
+        {
+            l *= attackReleaseLevel;
+            r *= attackReleaseLevel;
 
-            sourceSamplePosition += pitchRatio;
+            attackReleaseLevel += releaseDelta;
 
-            if (sourceSamplePosition > playingSound->length)
+            if (attackReleaseLevel <= 0.0f)
             {
                 stopNote (0.0f, false);
-                break;
+                return false;
             }
         }
+
+        if (outR != nullptr)
+        {
+            *outL++ += l;
+            *outR++ += r;
+        }
+        else
+        {
+            *outL++ += (l + r) * 0.5f;
+        }
+
+        sourceSamplePosition += pitchRatio;
+
+        if (sourceSamplePosition > length)
+        {
+            stopNote (0.0f, false);
+            return false;
+        }
     }
+
+    return true;
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SamplerStreamingTests  : public UnitTest
+{
+public:
+    SamplerStreamingTests() : UnitTest ("Sampler streaming") {}
+
+    static AudioSampleBuffer render (SamplerSound* sound, SamplerVoice* voice, int note, int numSamples, bool waitForDisk)
+    {
+        Synthesiser synth;
+        synth.addVoice (voice);
+        synth.addSound (sound);
+        synth.setCurrentPlaybackSampleRate (44100.0);
+
+        AudioSampleBuffer output (2, numSamples);
+        output.clear();
+
+        MidiBuffer midi;
+        midi.addEvent (MidiMessage::noteOn (1, note, 1.0f), 0);
+
+        for (int pos = 0; pos < numSamples; pos += blockSize)
+        {
+            if (waitForDisk)
+                Thread::sleep (10);
+
+            synth.renderNextBlock (output, midi, pos, jmin ((int) blockSize, numSamples - pos));
+            midi.clear();
+        }
+
+        return output;
+    }
+
+    void runTest() override
+    {
+        const int numSourceSamples = 88200;
+
+        TemporaryFile tempFile (".wav");
+
+        {
+            Random r = getRandom();
+            AudioSampleBuffer source (2, numSourceSamples);
+
+            for (int i = 0; i < numSourceSamples; ++i)
+            {
+                source.setSample (0, i, r.nextFloat() * 1.8f - 0.9f);
+                source.setSample (1, i, std::sin (i * 0.01f) * 0.5f);
+            }
+
+            WavAudioFormat wav;
+            ScopedPointer<AudioFormatWriter> writer (wav.createWriterFor (tempFile.getFile().createOutputStream(),
+                                                                         44100.0, 2, 16, StringPairArray(), 0));
+            writer->writeFromAudioSampleBuffer (source, 0, numSourceSamples);
+        }
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        BigInteger notes;
+        notes.setRange (0, 128, true);
+
+        for (int note = 60; note <= 72; note += 5)
+        {
+            beginTest ("Streaming matches in-memory playback, note " + String (note));
+
+            ScopedPointer<AudioFormatReader> reader (formatManager.createReaderFor (tempFile.getFile()));
+            expect (reader != nullptr);
+
+            const AudioSampleBuffer expected (render (new SamplerSound ("mem", *reader, notes, 60, 0.01, 0.1, 10.0),
+                                                      new SamplerVoice(), note, numSourceSamples + 4096, false));
+
+            SamplerDiskStreamer streamer (2, 8192);
+            AudioFormatReader* streamingReader = SamplerSound::createStreamingReader (formatManager, tempFile.getFile());
+            expect (dynamic_cast<MemoryMappedAudioFormatReader*> (streamingReader) != nullptr);
+
+            SamplerSound* streamingSound = new SamplerSound ("disk", streamingReader, notes, 60, 0.01, 0.1, 10.0, 0.05);
+            expect (streamingSound->isStreaming());
+            expectEquals (streamingSound->getPreloadLength(), 2205);
+
+            const AudioSampleBuffer actual (render (streamingSound, new SamplerVoice (streamer),
+                                                    note, numSourceSamples + 4096, true));
+
+            const SamplerDiskStreamer::Statistics stats (streamer.getStatistics());
+            expectEquals (stats.numUnderruns, (int64) 0);
+            expect (stats.numReads > 0);
+
+            int numDifferent = 0;
+
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < expected.getNumSamples(); ++i)
+                    if (expected.getSample (ch, i) != actual.getSample (ch, i))
+                        ++numDifferent;
+
+            expectEquals (numDifferent, 0);
+        }
+    }
+
+    enum { blockSize = 2048 };
+};
+
+static SamplerStreamingTests samplerStreamingTests;
+
+#endif
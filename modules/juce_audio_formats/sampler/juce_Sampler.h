@@ -30,8 +30,10 @@
 /**
     A subclass of SynthesiserSound that represents a sampled audio clip.
 
-    This is a pretty basic sampler, and just attempts to load the whole audio stream
-    into memory.
+    This is a pretty basic sampler. Normally it just attempts to load the whole audio
+    stream into memory, but for long samples you can use the streaming constructor,
+    which only keeps the start of the sample in memory, and has the voices fetch the
+    rest from disk as they play it, using a SamplerDiskStreamer.
 
     To use it, create a Synthesiser, add some SamplerVoice objects to it, then
     give it some SampledSound objects to play.
@@ -68,18 +70,61 @@ public:
                   double releaseTimeSecs,
                   double maxSampleLengthSeconds);
 
+    /** Creates a sampled sound which streams its audio from a reader.
+
+        Only the first preloadTimeSecs of the audio is loaded into memory. When a note
+        starts, a voice plays this part while the rest of the sample is fetched in the
+        background. Only a SamplerVoice which was created with a SamplerDiskStreamer
+        can play one of these sounds.
+
+        The reader will be deleted by this object. A MemoryMappedAudioFormatReader is
+        best, because several voices can then read from it at once. If you pass one
+        that hasn't been mapped yet, this will map the entire file. You can use
+        createStreamingReader() to get a suitable reader for a file.
+
+        @see createStreamingReader, SamplerDiskStreamer
+    */
+    SamplerSound (const String& name,
+                  AudioFormatReader* sourceToStreamFrom,
+                  const BigInteger& midiNotes,
+                  int midiNoteForNormalPitch,
+                  double attackTimeSecs,
+                  double releaseTimeSecs,
+                  double maxSampleLengthSeconds,
+                  double preloadTimeSecs);
+
     /** Destructor. */
     ~SamplerSound();
 
+    //==============================================================================
+    /** Creates a reader for a file that's suitable for streaming a SamplerSound from.
+        This will return a memory-mapped reader if the file's format supports one, or
+        a normal reader if it doesn't. It returns nullptr if the file can't be opened.
+    */
+    static AudioFormatReader* createStreamingReader (AudioFormatManager& formatManager,
+                                                     const File& audioFile);
+
     //==============================================================================
     /** Returns the sample's name */
     const String& getName() const noexcept                  { return name; }
 
     /** Returns the audio sample data.
-        This could return nullptr if there was a problem loading the data.
+        This could return nullptr if there was a problem loading the data. For a
+        streaming sound, this only contains the preloaded start of the sample.
     */
     AudioSampleBuffer* getAudioData() const noexcept        { return data; }
 
+    /** Returns true if the sound streams its audio rather than holding it all in memory. */
+    bool isStreaming() const noexcept                       { return streamingSource != nullptr; }
+
+    /** Returns the length of the sample, in samples. */
+    int getLength() const noexcept                          { return length; }
+
+    /** Returns the number of samples which are held in memory.
+        For a sound that isn't streamed, this is the same as its length.
+    */
+    int getPreloadLength() const noexcept                   { return preloadLength; }
+
 
     //==============================================================================
     bool appliesToNote (int midiNoteNumber) override;
@@ -89,18 +134,104 @@ public:
 private:
     //==============================================================================
     friend class SamplerVoice;
+    friend class SamplerDiskStreamer;
 
     String name;
     ScopedPointer<AudioSampleBuffer> data;
+    ScopedPointer<AudioFormatReader> streamingSource;
+    CriticalSection sourceLock;
+    bool sourceIsMemoryMapped;
     double sourceSampleRate;
     BigInteger midiNotes;
-    int length, attackSamples, releaseSamples;
+    int length, preloadLength, attackSamples, releaseSamples;
     int midiRootNote;
 
+    void loadSamples (AudioFormatReader&, double, double, double, double);
+    void readFromSource (AudioSampleBuffer&, int startSample, int numSamples, int64 sourceStartSample);
+
     JUCE_LEAK_DETECTOR (SamplerSound)
 };
 
 
+//==============================================================================
+/**
+    Reads the audio for streaming SamplerSounds from disk, on behalf of a set of
+    SamplerVoices.
+
+    Each voice that's created with a streamer gets its own ring buffer, which the
+    streamer's threads keep topped up with the part of the sample that the voice will
+    need next. The audio thread never waits for them: it just asks for more data when
+    there's room in the buffer, and if the data hasn't arrived by the time it's needed,
+    the voice plays silence and the shortfall is recorded in the streamer's statistics.
+
+    One streamer can be shared by all the voices in a Synthesiser, or by several
+    synthesisers. It must outlive all of the voices that use it.
+
+    @see SamplerSound, SamplerVoice
+*/
+class JUCE_API  SamplerDiskStreamer
+{
+public:
+    //==============================================================================
+    /** Creates a streamer.
+
+        @param numThreads           the number of threads that will read from disk
+        @param bufferSizeSamples    the size of each voice's ring buffer. Between them, this
+                                    and the sounds' preload times need to cover the time
+                                    it may take for the disk to respond
+    */
+    SamplerDiskStreamer (int numThreads = 2, int bufferSizeSamples = 32768);
+
+    /** Destructor. */
+    ~SamplerDiskStreamer();
+
+    //==============================================================================
+    /** Returns the size of the voices' ring buffers, in samples. */
+    int getBufferSize() const noexcept                      { return bufferSize; }
+
+    /** Some counters that show how well the streamer is keeping up. */
+    struct Statistics
+    {
+        /** The number of blocks in which a voice ran out of data. */
+        int64 numUnderruns;
+
+        /** The number of samples that voices had to replace with silence. */
+        int64 numSamplesMissed;
+
+        /** The number of times a ring buffer has been refilled. */
+        int64 numReads;
+
+        /** The total number of samples read into the ring buffers. */
+        int64 numSamplesRead;
+    };
+
+    /** Returns the current statistics. This can be called from any thread. */
+    Statistics getStatistics() const noexcept;
+
+    /** Sets all the statistics back to zero. */
+    void resetStatistics() noexcept;
+
+private:
+    //==============================================================================
+    friend class SamplerVoice;
+    struct Stream;
+    class ReaderJob;
+
+    const int bufferSize;
+    OwnedArray<Stream> streams;
+    CriticalSection streamListLock;
+    MultiProducerMultiConsumerQueue<Stream*> requests;
+    ThreadPool pool;
+    Atomic<int64> numUnderruns, numSamplesMissed, numReads, numSamplesRead;
+
+    Stream* getFreeStream();
+    void requestRefill (Stream&) noexcept;
+    void refill (Stream&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplerDiskStreamer)
+};
+
+
 //==============================================================================
 /**
     A subclass of SynthesiserVoice that can play a SamplerSound.
@@ -114,9 +245,14 @@ class JUCE_API  SamplerVoice    : public SynthesiserVoice
 {
 public:
     //==============================================================================
-    /** Creates a SamplerVoice. */
+    /** Creates a SamplerVoice which can only play sounds that are held in memory. */
     SamplerVoice();
 
+    /** Creates a SamplerVoice which can also play streaming sounds.
+        The streamer must not be deleted before the voice.
+    */
+    explicit SamplerVoice (SamplerDiskStreamer& streamer);
+
     /** Destructor. */
     ~SamplerVoice();
 
@@ -131,6 +267,10 @@ public:
 
     void renderNextBlock (AudioSampleBuffer&, int startSample, int numSamples) override;
 
+    //==============================================================================
+    /** Returns the number of blocks in which this voice has run out of streamed data. */
+    int getNumUnderruns() const noexcept;
+
 
 private:
     //==============================================================================
@@ -139,6 +279,15 @@ private:
     float lgain, rgain, attackReleaseLevel, attackDelta, releaseDelta;
     bool isInAttack, isInRelease;
 
+    SamplerDiskStreamer* streamer;
+    SamplerDiskStreamer::Stream* stream;
+
+    bool render (const float* inL, const float* inR, int firstSourceSample,
+                 float*& outL, float*& outR, int numSamples, int length);
+    void renderStreaming (const SamplerSound&, float*& outL, float*& outR, int numSamples);
+    bool startStreaming();
+    void stopStreaming() noexcept;
+
     JUCE_LEAK_DETECTOR (SamplerVoice)
 };
 
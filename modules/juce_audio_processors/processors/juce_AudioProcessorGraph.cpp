@@ -58,6 +58,24 @@ template <typename FloatingType> struct FloatDoubleType<AudioBuffer<FloatPlaceho
 namespace GraphRenderingOps
 {
 
+//==============================================================================
+/** Lists the shared audio channels and midi buffers that some rendering ops touch,
+    so that the ops which don't interfere with each other can be run concurrently.
+*/
+struct BufferAccess
+{
+    void readsAudio (const int channel)     { reads.addIfNotAlreadyThere (channel * 2 + 1); }
+    void writesAudio (const int channel)    { writes.addIfNotAlreadyThere (channel * 2 + 1); }
+    void readsMidi (const int buffer)       { reads.addIfNotAlreadyThere (buffer * 2 + 2); }
+    void writesMidi (const int buffer)      { writes.addIfNotAlreadyThere (buffer * 2 + 2); }
+
+    // The graph's own input and output buffers, which are used by AudioGraphIOProcessors
+    void usesGraphIO()                      { writes.addIfNotAlreadyThere (0); }
+
+    Array<int> reads, writes;
+};
+
+//==============================================================================
 struct AudioGraphRenderingOpBase
 {
     AudioGraphRenderingOpBase() noexcept {}
@@ -71,6 +89,8 @@ struct AudioGraphRenderingOpBase
                           const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                           const int numSamples) = 0;
 
+    virtual void getBufferAccess (BufferAccess&) const = 0;
+
     JUCE_LEAK_DETECTOR (AudioGraphRenderingOpBase)
 };
 
@@ -104,6 +124,11 @@ struct ClearChannelOp  : public AudioGraphRenderingOp<ClearChannelOp>
         sharedBufferChans.clear (channelNum, 0, numSamples);
     }
 
+    void getBufferAccess (BufferAccess& access) const override
+    {
+        access.writesAudio (channelNum);
+    }
+
     const int channelNum;
 
     JUCE_DECLARE_NON_COPYABLE (ClearChannelOp)
@@ -122,6 +147,12 @@ struct CopyChannelOp  : public AudioGraphRenderingOp<CopyChannelOp>
         sharedBufferChans.copyFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
     }
 
+    void getBufferAccess (BufferAccess& access) const override
+    {
+        access.readsAudio (srcChannelNum);
+        access.writesAudio (dstChannelNum);
+    }
+
     const int srcChannelNum, dstChannelNum;
 
     JUCE_DECLARE_NON_COPYABLE (CopyChannelOp)
@@ -140,6 +171,12 @@ struct AddChannelOp  : public AudioGraphRenderingOp<AddChannelOp>
         sharedBufferChans.addFrom (dstChannelNum, 0, sharedBufferChans, srcChannelNum, 0, numSamples);
     }
 
+    void getBufferAccess (BufferAccess& access) const override
+    {
+        access.readsAudio (srcChannelNum);
+        access.writesAudio (dstChannelNum);
+    }
+
     const int srcChannelNum, dstChannelNum;
 
     JUCE_DECLARE_NON_COPYABLE (AddChannelOp)
@@ -156,6 +193,11 @@ struct ClearMidiBufferOp  : public AudioGraphRenderingOp<ClearMidiBufferOp>
         sharedMidiBuffers.getUnchecked (bufferNum)->clear();
     }
 
+    void getBufferAccess (BufferAccess& access) const override
+    {
+        access.writesMidi (bufferNum);
+    }
+
     const int bufferNum;
 
     JUCE_DECLARE_NON_COPYABLE (ClearMidiBufferOp)
@@ -174,6 +216,12 @@ struct CopyMidiBufferOp  : public AudioGraphRenderingOp<CopyMidiBufferOp>
         *sharedMidiBuffers.getUnchecked (dstBufferNum) = *sharedMidiBuffers.getUnchecked (srcBufferNum);
     }
 
+    void getBufferAccess (BufferAccess& access) const override
+    {
+        access.readsMidi (srcBufferNum);
+        access.writesMidi (dstBufferNum);
+    }
+
     const int srcBufferNum, dstBufferNum;
 
     JUCE_DECLARE_NON_COPYABLE (CopyMidiBufferOp)
@@ -193,6 +241,12 @@ struct AddMidiBufferOp  : public AudioGraphRenderingOp<AddMidiBufferOp>
             ->addEvents (*sharedMidiBuffers.getUnchecked (srcBufferNum), 0, numSamples, 0);
     }
 
+    void getBufferAccess (BufferAccess& access) const override
+    {
+        access.readsMidi (srcBufferNum);
+        access.writesMidi (dstBufferNum);
+    }
+
     const int srcBufferNum, dstBufferNum;
 
     JUCE_DECLARE_NON_COPYABLE (AddMidiBufferOp)
@@ -226,6 +280,11 @@ struct DelayChannelOp  : public AudioGraphRenderingOp<DelayChannelOp>
         }
     }
 
+    void getBufferAccess (BufferAccess& access) const override
+    {
+        access.writesAudio (channel);
+    }
+
 private:
     FloatAndDoubleComposition<HeapBlock<FloatPlaceholder> > buffer;
     const int channel, bufferSize;
@@ -267,6 +326,27 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
         callProcess (buffer, *sharedMidiBuffers.getUnchecked (midiBufferToUse));
     }
 
+    void getBufferAccess (BufferAccess& access) const override
+    {
+        const int numOuts = processor->getTotalNumOutputChannels();
+
+        for (int i = 0; i < totalChans; ++i)
+        {
+            const int chan = audioChannelsToUse.getUnchecked (i);
+
+            // input-only channels may be mapped onto the read-only empty buffer
+            if (chan != 0 || i < numOuts)
+                access.writesAudio (chan);
+            else
+                access.readsAudio (chan);
+        }
+
+        access.writesMidi (midiBufferToUse);
+
+        if (dynamic_cast<AudioProcessorGraph::AudioGraphIOProcessor*> (processor) != nullptr)
+            access.usesGraphIO();
+    }
+
     void callProcess (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
     {
         processor->processBlock (buffer, midiMessages);
@@ -303,28 +383,146 @@ private:
     JUCE_DECLARE_NON_COPYABLE (ProcessBufferOp)
 };
 
+//==============================================================================
+/** Remembers how the current rendering sequence was worked out, so that when the
+    graph changes, the ops and buffer assignments for the nodes that come before the
+    first affected one can be kept, along with those for any unchanged nodes at the
+    end of the sequence, and only the part in between rebuilt.
+*/
+struct RenderingSequenceHistory
+{
+    RenderingSequenceHistory() {}
+
+    void clear()
+    {
+        steps.clear();
+        changes.clear();
+    }
+
+    /** Describes everything that the ops for one node depend on, and what state
+        the calculator was left in once they had been created.
+    */
+    struct Step
+    {
+        bool hasSameInputsAs (const Step& other) const noexcept
+        {
+            return node == other.node
+                && numIns == other.numIns && numOuts == other.numOuts
+                && latency == other.latency
+                && acceptsMidi == other.acceptsMidi && producesMidi == other.producesMidi
+                && connections == other.connections;
+        }
+
+        AudioProcessorGraph::Node* node;
+        uint32 nodeId;
+        int numIns, numOuts, latency;
+        bool acceptsMidi, producesMidi;
+        Array<int> connections;
+
+        int numOpsAfterStep, totalLatencyAfterStep, nodeDelay;
+        uint64 bufferStateHashAfterStep;
+        bool dependsOnLaterNodes;
+    };
+
+    /** An undo record for a change to the buffer assignments. */
+    struct BufferChange
+    {
+        int step, bufferIndex;
+        bool isMidi, wasAdded;
+        uint32 oldNodeId;
+        int oldChannel;
+    };
+
+    OwnedArray<Step> steps;
+    Array<BufferChange> changes;
+
+    Array<int> channels;
+    Array<uint32> nodeIds, midiNodeIds;
+
+    JUCE_DECLARE_NON_COPYABLE (RenderingSequenceHistory)
+};
+
 //==============================================================================
 /** Used to calculate the correct sequence of rendering ops needed, based on
     the best re-use of shared buffers at each stage.
+
+    If the history holds the details of the sequence that's currently in use, the
+    ops for any nodes before the first one that has changed are re-used. The ops for
+    the nodes after that are recalculated until the buffer assignments are back in
+    step with the old sequence, after which any unchanged nodes at the end of the
+    sequence can keep their old ops too.
 */
 struct RenderingOpSequenceCalculator
 {
     RenderingOpSequenceCalculator (AudioProcessorGraph& g,
                                    const Array<AudioProcessorGraph::Node*>& nodes,
-                                   Array<void*>& renderingOps)
+                                   const Array<void*>& previousRenderingOps,
+                                   Array<void*>& renderingOps,
+                                   RenderingSequenceHistory& h)
         : graph (g),
           orderedNodes (nodes),
-          totalLatency (0)
+          history (h),
+          channels (h.channels),
+          nodeIds (h.nodeIds),
+          midiNodeIds (h.midiNodeIds),
+          stepIndexes (nodes.size() * 2 + 1),
+          totalLatency (0),
+          currentStep (0),
+          numReusedOps (0),
+          firstReusedTrailingOp (previousRenderingOps.size()),
+          reusableTailStart (nodes.size()),
+          numChangedNodeDelays (0),
+          bufferStateHash (0),
+          sequenceUnchanged (false)
     {
-        nodeIds.add ((uint32) zeroNodeID); // first buffer is read-only zeros
-        channels.add (0);
+        indexConnections();
 
-        midiNodeIds.add ((uint32) zeroNodeID);
+        OwnedArray<RenderingSequenceHistory::Step> newSteps;
 
         for (int i = 0; i < orderedNodes.size(); ++i)
+            newSteps.add (createStep (i));
+
+        const int firstChangedStep = findFirstChangedStep (newSteps, previousRenderingOps);
+        reusableTailStart = findReusableTail (newSteps, previousRenderingOps, firstChangedStep);
+
+        sequenceUnchanged = firstChangedStep == newSteps.size()
+                             && firstChangedStep == history.steps.size()
+                             && firstChangedStep > 0;
+
+        oldSteps.swapWith (history.steps);
+        history.steps.swapWith (newSteps);
+
+        restoreStateBeforeStep (firstChangedStep);
+
+        for (int i = 0; i < firstChangedStep; ++i)
+        {
+            const RenderingSequenceHistory::Step& oldStep = *oldSteps.getUnchecked (i);
+            RenderingSequenceHistory::Step& newStep = *history.steps.getUnchecked (i);
+
+            newStep.numOpsAfterStep          = oldStep.numOpsAfterStep;
+            newStep.totalLatencyAfterStep    = oldStep.totalLatencyAfterStep;
+            newStep.nodeDelay                = oldStep.nodeDelay;
+            newStep.bufferStateHashAfterStep = oldStep.bufferStateHashAfterStep;
+        }
+
+        renderingOps.addArray (previousRenderingOps, 0, numReusedOps);
+
+        for (int i = firstChangedStep; i < orderedNodes.size(); ++i)
         {
+            currentStep = i;
             createRenderingOpsForNode (*orderedNodes.getUnchecked(i), renderingOps, i);
             markAnyUnusedBuffersAsFree (i);
+
+            RenderingSequenceHistory::Step& step = *history.steps.getUnchecked (i);
+            step.numOpsAfterStep = renderingOps.size();
+            step.totalLatencyAfterStep = totalLatency;
+            step.bufferStateHashAfterStep = bufferStateHash;
+
+            if (i + 1 >= reusableTailStart && canReuseTailAfterStep (i))
+            {
+                reuseTailAfterStep (i, previousRenderingOps, renderingOps);
+                break;
+            }
         }
 
         graph.setLatencySamples (totalLatency);
@@ -333,50 +531,388 @@ struct RenderingOpSequenceCalculator
     int getNumBuffersNeeded() const noexcept         { return nodeIds.size(); }
     int getNumMidiBuffersNeeded() const noexcept     { return midiNodeIds.size(); }
 
+    /** Returns the number of ops at the start of the sequence which were taken from the previous one. */
+    int getNumReusedOps() const noexcept             { return numReusedOps; }
+
+    /** Returns the index in the previous sequence of the first op that was moved to the end of
+        the new one, or the size of the previous sequence if none of its trailing ops were re-used.
+    */
+    int getFirstReusedTrailingOp() const noexcept    { return firstReusedTrailingOp; }
+
+    /** True if the new sequence is exactly the same as the previous one. */
+    bool isSequenceUnchanged() const noexcept        { return sequenceUnchanged; }
+
 private:
     //==============================================================================
     AudioProcessorGraph& graph;
     const Array<AudioProcessorGraph::Node*>& orderedNodes;
-    Array<int> channels;
-    Array<uint32> nodeIds, midiNodeIds;
+    RenderingSequenceHistory& history;
+    Array<int>& channels;
+    Array<uint32>& nodeIds;
+    Array<uint32>& midiNodeIds;
 
-    enum { freeNodeID = 0xffffffff, zeroNodeID = 0xfffffffe };
+    enum { freeNodeID = 0xffffffff, zeroNodeID = 0xfffffffe, anonymousNodeID = 0xfffffffd };
 
     static bool isNodeBusy (uint32 nodeID) noexcept     { return nodeID != freeNodeID && nodeID != zeroNodeID; }
 
-    Array<uint32> nodeDelayIDs;
-    Array<int> nodeDelays;
-    int totalLatency;
+    struct NodeConnections
+    {
+        Array<const AudioProcessorGraph::Connection*> inputs, outputs;
+    };
 
-    int getNodeDelay (const uint32 nodeID) const        { return nodeDelays [nodeDelayIDs.indexOf (nodeID)]; }
+    struct BufferRelease
+    {
+        int bufferIndex;
+        uint32 nodeId;
+        int channel;
+    };
 
-    void setNodeDelay (const uint32 nodeID, const int latency)
+    OwnedArray<NodeConnections> nodeConnections;
+    Array<Array<BufferRelease> > releasesForStep;
+    HashMap<int, int> stepIndexes;
+
+    // the state that the previous sequence was left in, which is kept in case its trailing ops can be re-used
+    OwnedArray<RenderingSequenceHistory::Step> oldSteps;
+    Array<RenderingSequenceHistory::BufferChange> oldChanges;
+    Array<int> oldChannels;
+    Array<uint32> oldNodeIds, oldMidiNodeIds;
+    HashMap<int, int> oldStepIndexes;
+
+    int totalLatency, currentStep, numReusedOps, firstReusedTrailingOp, reusableTailStart, numChangedNodeDelays;
+    uint64 bufferStateHash;
+    bool sequenceUnchanged;
+
+    //==============================================================================
+    int getStepIndex (const uint32 nodeID) const
     {
-        const int index = nodeDelayIDs.indexOf (nodeID);
+        return stepIndexes.contains ((int) nodeID) ? stepIndexes [(int) nodeID] : -1;
+    }
 
-        if (index >= 0)
+    void indexConnections()
+    {
+        for (int i = 0; i < orderedNodes.size(); ++i)
         {
-            nodeDelays.set (index, latency);
+            stepIndexes.set ((int) orderedNodes.getUnchecked(i)->nodeId, i);
+            nodeConnections.add (new NodeConnections());
+            releasesForStep.add (Array<BufferRelease>());
         }
-        else
+
+        // (iterating backwards keeps the inputs in the order that the sequence has always used)
+        for (int i = graph.getNumConnections(); --i >= 0;)
         {
-            nodeDelayIDs.add (nodeID);
-            nodeDelays.add (latency);
+            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+            const int sourceStep = getStepIndex (c->sourceNodeId);
+            const int destStep   = getStepIndex (c->destNodeId);
+
+            if (destStep >= 0)
+            {
+                nodeConnections.getUnchecked (destStep)->inputs.add (c);
+
+                // only the outputs which can actually reach a destination channel keep a buffer alive
+                const bool isLegalDestination = c->destChannelIndex == AudioProcessorGraph::midiChannelIndex
+                    || isPositiveAndBelow (c->destChannelIndex, orderedNodes.getUnchecked (destStep)->getProcessor()->getTotalNumInputChannels());
+
+                if (sourceStep >= 0 && isLegalDestination)
+                    nodeConnections.getUnchecked (sourceStep)->outputs.add (c);
+            }
         }
     }
 
-    int getInputLatencyForNode (const uint32 nodeID) const
+    RenderingSequenceHistory::Step* createStep (const int stepIndex) const
     {
-        int maxLatency = 0;
+        AudioProcessorGraph::Node* const node = orderedNodes.getUnchecked (stepIndex);
+        AudioProcessor& processor = *node->getProcessor();
+        const NodeConnections& nc = *nodeConnections.getUnchecked (stepIndex);
+
+        RenderingSequenceHistory::Step* const step = new RenderingSequenceHistory::Step();
+        step->node = node;
+        step->nodeId = node->nodeId;
+        step->numIns = processor.getTotalNumInputChannels();
+        step->numOuts = processor.getTotalNumOutputChannels();
+        step->latency = processor.getLatencySamples();
+        step->acceptsMidi = processor.acceptsMidi();
+        step->producesMidi = processor.producesMidi();
+        step->numOpsAfterStep = 0;
+        step->totalLatencyAfterStep = 0;
+        step->nodeDelay = 0;
+        step->bufferStateHashAfterStep = 0;
+        step->dependsOnLaterNodes = false;
+
+        step->connections.add (nc.inputs.size());
+
+        for (int i = 0; i < nc.inputs.size(); ++i)
+        {
+            const AudioProcessorGraph::Connection* const c = nc.inputs.getUnchecked (i);
+            step->connections.add ((int) c->sourceNodeId);
+            step->connections.add (c->sourceChannelIndex);
+            step->connections.add (c->destChannelIndex);
+        }
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
+        for (int i = 0; i < nc.outputs.size(); ++i)
         {
-            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+            const AudioProcessorGraph::Connection* const c = nc.outputs.getUnchecked (i);
+            step->connections.add (c->sourceChannelIndex);
+            step->connections.add ((int) c->destNodeId);
+            step->connections.add (c->destChannelIndex);
+        }
+
+        return step;
+    }
 
-            if (c->destNodeId == nodeID)
-                maxLatency = jmax (maxLatency, getNodeDelay (c->sourceNodeId));
+    bool isHistoryInUse (const Array<void*>& previousRenderingOps) const noexcept
+    {
+        // the history can only be used if it describes the ops that are currently in use
+        return history.steps.size() > 0 && history.steps.getLast()->numOpsAfterStep == previousRenderingOps.size();
+    }
+
+    int findFirstChangedStep (const OwnedArray<RenderingSequenceHistory::Step>& newSteps,
+                              const Array<void*>& previousRenderingOps) const
+    {
+        if (! isHistoryInUse (previousRenderingOps))
+            return 0;
+
+        const int numSteps = jmin (history.steps.size(), newSteps.size());
+
+        for (int i = 0; i < numSteps; ++i)
+        {
+            const RenderingSequenceHistory::Step& oldStep = *history.steps.getUnchecked (i);
+
+            if (oldStep.dependsOnLaterNodes || ! oldStep.hasSameInputsAs (*newSteps.getUnchecked (i)))
+                return i;
         }
 
+        return numSteps;
+    }
+
+    /** Returns the first of the run of steps at the end of the new sequence which match the
+        ones at the end of the old sequence, or the number of steps if there aren't any.
+
+        At least one step after the first changed one has to be recalculated before this run,
+        in both the old and new sequences.
+    */
+    int findReusableTail (const OwnedArray<RenderingSequenceHistory::Step>& newSteps,
+                          const Array<void*>& previousRenderingOps,
+                          const int firstChangedStep)
+    {
+        const OwnedArray<RenderingSequenceHistory::Step>& steps = history.steps;
+        const int numNewSteps = newSteps.size();
+
+        if (firstChangedStep >= numNewSteps || ! isHistoryInUse (previousRenderingOps))
+            return numNewSteps;
+
+        const int offset = steps.size() - numNewSteps;
+        int tailStart = numNewSteps;
+
+        while (tailStart - 1 > firstChangedStep
+                && tailStart - 1 + offset > firstChangedStep
+                && newSteps.getUnchecked (tailStart - 1)->hasSameInputsAs (*steps.getUnchecked (tailStart - 1 + offset)))
+            --tailStart;
+
+        // (these are the old steps for the nodes that may be recalculated before the tail is reached)
+        if (tailStart < numNewSteps)
+            for (int i = firstChangedStep; i < tailStart + offset; ++i)
+                oldStepIndexes.set ((int) steps.getUnchecked (i)->nodeId, i);
+
+        return tailStart;
+    }
+
+    static int findFirstChangeForStep (const Array<RenderingSequenceHistory::BufferChange>& changes, const int stepIndex) noexcept
+    {
+        int i = changes.size();
+
+        while (i > 0 && changes.getReference (i - 1).step >= stepIndex)
+            --i;
+
+        return i;
+    }
+
+    static void undoBufferChanges (const Array<RenderingSequenceHistory::BufferChange>& changes, const int firstChangeToUndo,
+                                   Array<uint32>& nodeIdsToRestore, Array<int>& channelsToRestore, Array<uint32>& midiNodeIdsToRestore)
+    {
+        for (int i = changes.size(); --i >= firstChangeToUndo;)
+        {
+            const RenderingSequenceHistory::BufferChange& change = changes.getReference (i);
+
+            if (change.isMidi)
+            {
+                if (change.wasAdded)
+                    midiNodeIdsToRestore.removeLast();
+                else
+                    midiNodeIdsToRestore.set (change.bufferIndex, change.oldNodeId);
+            }
+            else
+            {
+                if (change.wasAdded)
+                {
+                    nodeIdsToRestore.removeLast();
+                    channelsToRestore.removeLast();
+                }
+                else
+                {
+                    nodeIdsToRestore.set (change.bufferIndex, change.oldNodeId);
+                    channelsToRestore.set (change.bufferIndex, change.oldChannel);
+                }
+            }
+        }
+    }
+
+    void restoreStateBeforeStep (const int stepIndex)
+    {
+        const int firstChangeToUndo = findFirstChangeForStep (history.changes, stepIndex);
+
+        if (reusableTailStart < orderedNodes.size())
+        {
+            oldNodeIds = nodeIds;
+            oldChannels = channels;
+            oldMidiNodeIds = midiNodeIds;
+            oldChanges.addArray (history.changes, firstChangeToUndo, history.changes.size() - firstChangeToUndo);
+        }
+
+        if (stepIndex == 0)
+        {
+            history.changes.clearQuick();
+            nodeIds.clearQuick();
+            channels.clearQuick();
+            midiNodeIds.clearQuick();
+
+            nodeIds.add ((uint32) zeroNodeID); // first buffer is read-only zeros
+            channels.add (0);
+
+            midiNodeIds.add ((uint32) zeroNodeID);
+            return;
+        }
+
+        undoBufferChanges (history.changes, firstChangeToUndo, nodeIds, channels, midiNodeIds);
+        history.changes.removeRange (firstChangeToUndo, history.changes.size() - firstChangeToUndo);
+
+        const RenderingSequenceHistory::Step& lastReusedStep = *oldSteps.getUnchecked (stepIndex - 1);
+        numReusedOps = lastReusedStep.numOpsAfterStep;
+        totalLatency = lastReusedStep.totalLatencyAfterStep;
+        bufferStateHash = lastReusedStep.bufferStateHashAfterStep;
+        currentStep = stepIndex;
+
+        for (int i = 0; i < nodeIds.size(); ++i)
+            if (isNodeBusy (nodeIds.getUnchecked (i)))
+                scheduleBufferRelease (i, nodeIds.getUnchecked (i), channels.getUnchecked (i), stepIndex);
+
+        for (int i = 0; i < midiNodeIds.size(); ++i)
+            if (isNodeBusy (midiNodeIds.getUnchecked (i)))
+                scheduleBufferRelease (i, midiNodeIds.getUnchecked (i), AudioProcessorGraph::midiChannelIndex, stepIndex);
+    }
+
+    //==============================================================================
+    /** The number of steps that each node in the reusable tail has moved by since the old sequence. */
+    int getStepOffset() const noexcept      { return oldSteps.size() - history.steps.size(); }
+
+    /** Checks whether the buffers hold exactly what they held at the same point in the old
+        sequence, in which case the old ops for the rest of the nodes will still be correct.
+    */
+    bool canReuseTailAfterStep (const int stepIndex) const
+    {
+        const int nextStep = stepIndex + 1;
+
+        // (the old ops also depend on the delays of any nodes that feed into them)
+        if (nextStep >= history.steps.size() || numChangedNodeDelays > 0)
+            return false;
+
+        const int oldNextStep = nextStep + getStepOffset();
+        const RenderingSequenceHistory::Step& oldStep = *oldSteps.getUnchecked (oldNextStep - 1);
+
+        if (oldStep.totalLatencyAfterStep != totalLatency || oldStep.bufferStateHashAfterStep != bufferStateHash)
+            return false;
+
+        // the hashes match, so make sure that the buffers really do hold the same things..
+        Array<uint32> oldNodeIdsAtStep (oldNodeIds), oldMidiNodeIdsAtStep (oldMidiNodeIds);
+        Array<int> oldChannelsAtStep (oldChannels);
+
+        undoBufferChanges (oldChanges, findFirstChangeForStep (oldChanges, oldNextStep),
+                           oldNodeIdsAtStep, oldChannelsAtStep, oldMidiNodeIdsAtStep);
+
+        if (nodeIds != oldNodeIdsAtStep || midiNodeIds != oldMidiNodeIdsAtStep)
+            return false;
+
+        // (a free buffer's channel number is left over from whatever it last held)
+        for (int i = 0; i < nodeIds.size(); ++i)
+            if (isNodeBusy (nodeIds.getUnchecked (i)) && channels.getUnchecked (i) != oldChannelsAtStep.getUnchecked (i))
+                return false;
+
+        return true;
+    }
+
+    void reuseTailAfterStep (const int stepIndex, const Array<void*>& previousRenderingOps, Array<void*>& renderingOps)
+    {
+        const int nextStep = stepIndex + 1;
+        const int offset = getStepOffset();
+        const int numOpsBeforeTail = renderingOps.size();
+
+        firstReusedTrailingOp = oldSteps.getUnchecked (nextStep + offset - 1)->numOpsAfterStep;
+        renderingOps.addArray (previousRenderingOps, firstReusedTrailingOp, previousRenderingOps.size() - firstReusedTrailingOp);
+
+        for (int i = nextStep; i < history.steps.size(); ++i)
+        {
+            const RenderingSequenceHistory::Step& oldStep = *oldSteps.getUnchecked (i + offset);
+            RenderingSequenceHistory::Step& newStep = *history.steps.getUnchecked (i);
+
+            newStep.numOpsAfterStep          = oldStep.numOpsAfterStep - firstReusedTrailingOp + numOpsBeforeTail;
+            newStep.totalLatencyAfterStep    = oldStep.totalLatencyAfterStep;
+            newStep.nodeDelay                = oldStep.nodeDelay;
+            newStep.bufferStateHashAfterStep = oldStep.bufferStateHashAfterStep;
+            newStep.dependsOnLaterNodes      = oldStep.dependsOnLaterNodes;
+        }
+
+        for (int i = findFirstChangeForStep (oldChanges, nextStep + offset); i < oldChanges.size(); ++i)
+        {
+            RenderingSequenceHistory::BufferChange change (oldChanges.getReference (i));
+            change.step -= offset;
+            history.changes.add (change);
+        }
+
+        nodeIds.swapWith (oldNodeIds);
+        channels.swapWith (oldChannels);
+        midiNodeIds.swapWith (oldMidiNodeIds);
+
+        totalLatency = oldSteps.getLast()->totalLatencyAfterStep;
+    }
+
+    /** Returns a hash of the contents of one buffer. The hashes for all the buffers that are in
+        use are xor-ed together, so that the state can be compared with the old sequence's cheaply.
+    */
+    static uint64 hashBufferContents (const int bufferIndex, const uint32 nodeId, const int channel) noexcept
+    {
+        uint64 h = (((uint64) nodeId) << 32) ^ (uint64) (uint32) channel
+                     ^ ((uint64) (uint32) bufferIndex * (uint64) literal64bit (0x9e3779b97f4a7c15));
+
+        h = (h ^ (h >> 30)) * (uint64) literal64bit (0xbf58476d1ce4e5b9);
+        h = (h ^ (h >> 27)) * (uint64) literal64bit (0x94d049bb133111eb);
+        return h ^ (h >> 31);
+    }
+
+    //==============================================================================
+    int getNodeDelay (const uint32 nodeID) const
+    {
+        const int stepIndex = getStepIndex (nodeID);
+
+        // (the delay of a node isn't known until its ops have been created)
+        return isPositiveAndBelow (stepIndex, currentStep) ? history.steps.getUnchecked (stepIndex)->nodeDelay : 0;
+    }
+
+    void setNodeDelay (const uint32 nodeID, const int latency)
+    {
+        history.steps.getUnchecked (getStepIndex (nodeID))->nodeDelay = latency;
+
+        if (oldStepIndexes.contains ((int) nodeID)
+             && oldSteps.getUnchecked (oldStepIndexes [(int) nodeID])->nodeDelay != latency)
+            ++numChangedNodeDelays;
+    }
+
+    int getInputLatencyForNode (const int stepIndex) const
+    {
+        const Array<const AudioProcessorGraph::Connection*>& inputs = nodeConnections.getUnchecked (stepIndex)->inputs;
+        int maxLatency = 0;
+
+        for (int i = 0; i < inputs.size(); ++i)
+            maxLatency = jmax (maxLatency, getNodeDelay (inputs.getUnchecked (i)->sourceNodeId));
+
         return maxLatency;
     }
 
@@ -393,7 +929,8 @@ private:
         Array<int> audioChannelsToUse;
         int midiBufferToUse = -1;
 
-        int maxLatency = getInputLatencyForNode (node.nodeId);
+        int maxLatency = getInputLatencyForNode (ourRenderingIndex);
+        const Array<const AudioProcessorGraph::Connection*>& inputs = nodeConnections.getUnchecked (ourRenderingIndex)->inputs;
 
         for (int inputChan = 0; inputChan < numIns; ++inputChan)
         {
@@ -401,11 +938,11 @@ private:
             Array<uint32> sourceNodes;
             Array<int> sourceOutputChans;
 
-            for (int i = graph.getNumConnections(); --i >= 0;)
+            for (int i = 0; i < inputs.size(); ++i)
             {
-                const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+                const AudioProcessorGraph::Connection* const c = inputs.getUnchecked (i);
 
-                if (c->destNodeId == node.nodeId && c->destChannelIndex == inputChan)
+                if (c->destChannelIndex == inputChan)
                 {
                     sourceNodes.add (c->sourceNodeId);
                     sourceOutputChans.add (c->sourceChannelIndex);
@@ -499,6 +1036,9 @@ private:
                     bufIndex = getFreeBuffer (false);
                     jassert (bufIndex != 0);
 
+                    // (mark it as used, so that it can't be handed out again for one of the other inputs)
+                    markBufferAsContaining (bufIndex, (uint32) anonymousNodeID, 0);
+
                     const int srcIndex = getBufferContaining (sourceNodes.getUnchecked (0),
                                                               sourceOutputChans.getUnchecked (0));
                     if (srcIndex < 0)
@@ -570,11 +1110,11 @@ private:
         // Now the same thing for midi..
         Array<uint32> midiSourceNodes;
 
-        for (int i = graph.getNumConnections(); --i >= 0;)
+        for (int i = 0; i < inputs.size(); ++i)
         {
-            const AudioProcessorGraph::Connection* const c = graph.getConnection (i);
+            const AudioProcessorGraph::Connection* const c = inputs.getUnchecked (i);
 
-            if (c->destNodeId == node.nodeId && c->destChannelIndex == AudioProcessorGraph::midiChannelIndex)
+            if (c->destChannelIndex == AudioProcessorGraph::midiChannelIndex)
                 midiSourceNodes.add (c->sourceNodeId);
         }
 
@@ -685,6 +1225,7 @@ private:
                 if (midiNodeIds.getUnchecked(i) == freeNodeID)
                     return i;
 
+            addBufferChange (true, midiNodeIds.size(), true);
             midiNodeIds.add ((uint32) freeNodeID);
             return midiNodeIds.size() - 1;
         }
@@ -694,12 +1235,26 @@ private:
                 if (nodeIds.getUnchecked(i) == freeNodeID)
                     return i;
 
+            addBufferChange (false, nodeIds.size(), true);
             nodeIds.add ((uint32) freeNodeID);
             channels.add (0);
             return nodeIds.size() - 1;
         }
     }
 
+    void addBufferChange (const bool isMidi, const int bufferIndex, const bool wasAdded)
+    {
+        RenderingSequenceHistory::BufferChange change;
+        change.step = currentStep;
+        change.bufferIndex = bufferIndex;
+        change.isMidi = isMidi;
+        change.wasAdded = wasAdded;
+        change.oldNodeId = wasAdded ? (uint32) freeNodeID : (isMidi ? midiNodeIds : nodeIds).getUnchecked (bufferIndex);
+        change.oldChannel = (wasAdded || isMidi) ? 0 : channels.getUnchecked (bufferIndex);
+
+        history.changes.add (change);
+    }
+
     int getReadOnlyEmptyBuffer() const noexcept
     {
         return 0;
@@ -726,56 +1281,95 @@ private:
 
     void markAnyUnusedBuffersAsFree (const int stepIndex)
     {
-        for (int i = 0; i < nodeIds.size(); ++i)
+        const Array<BufferRelease>& releases = releasesForStep.getReference (stepIndex);
+
+        for (int i = 0; i < releases.size(); ++i)
         {
-            if (isNodeBusy (nodeIds.getUnchecked(i))
-                 && ! isBufferNeededLater (stepIndex, -1,
-                                           nodeIds.getUnchecked(i),
-                                           channels.getUnchecked(i)))
+            const BufferRelease& r = releases.getReference (i);
+
+            // (the buffer may have been given some other contents since this was scheduled)
+            if (r.channel == AudioProcessorGraph::midiChannelIndex)
+            {
+                if (midiNodeIds.getUnchecked (r.bufferIndex) == r.nodeId)
+                {
+                    addBufferChange (true, r.bufferIndex, false);
+                    bufferStateHash ^= hashBufferContents (r.bufferIndex, r.nodeId, r.channel);
+                    midiNodeIds.set (r.bufferIndex, (uint32) freeNodeID);
+                }
+            }
+            else if (nodeIds.getUnchecked (r.bufferIndex) == r.nodeId
+                      && channels.getUnchecked (r.bufferIndex) == r.channel)
             {
-                nodeIds.set (i, (uint32) freeNodeID);
+                addBufferChange (false, r.bufferIndex, false);
+                bufferStateHash ^= hashBufferContents (r.bufferIndex, r.nodeId, r.channel);
+                nodeIds.set (r.bufferIndex, (uint32) freeNodeID);
             }
         }
+    }
 
-        for (int i = 0; i < midiNodeIds.size(); ++i)
+    /** Works out the step after which a buffer's contents will no longer be needed by
+        any node, and schedules it to be freed then.
+    */
+    void scheduleBufferRelease (const int bufferIndex, const uint32 nodeId, const int outputChanIndex, const int earliestStep)
+    {
+        const int sourceStep = getStepIndex (nodeId);
+        int lastConsumerStep = -1;
+
+        if (sourceStep >= 0)
         {
-            if (isNodeBusy (midiNodeIds.getUnchecked(i))
-                 && ! isBufferNeededLater (stepIndex, -1,
-                                           midiNodeIds.getUnchecked(i),
-                                           AudioProcessorGraph::midiChannelIndex))
+            const bool isMidi = outputChanIndex == AudioProcessorGraph::midiChannelIndex;
+            const Array<const AudioProcessorGraph::Connection*>& outputs = nodeConnections.getUnchecked (sourceStep)->outputs;
+
+            for (int i = 0; i < outputs.size(); ++i)
             {
-                midiNodeIds.set (i, (uint32) freeNodeID);
+                const AudioProcessorGraph::Connection* const c = outputs.getUnchecked (i);
+
+                if (c->sourceChannelIndex == outputChanIndex
+                     && isMidi == (c->destChannelIndex == AudioProcessorGraph::midiChannelIndex))
+                    lastConsumerStep = jmax (lastConsumerStep, getStepIndex (c->destNodeId));
             }
         }
+
+        const int releaseStep = jmax (earliestStep, lastConsumerStep + 1);
+
+        if (releaseStep < releasesForStep.size())
+        {
+            const BufferRelease r = { bufferIndex, nodeId, outputChanIndex };
+            releasesForStep.getReference (releaseStep).add (r);
+        }
     }
 
-    bool isBufferNeededLater (int stepIndexToSearchFrom,
-                              int inputChannelOfIndexToIgnore,
+    bool isBufferNeededLater (const int stepIndexToSearchFrom,
+                              const int inputChannelOfIndexToIgnore,
                               const uint32 nodeId,
-                              const int outputChanIndex) const
+                              const int outputChanIndex)
     {
-        while (stepIndexToSearchFrom < orderedNodes.size())
+        const int sourceStep = getStepIndex (nodeId);
+
+        if (sourceStep < 0)
+            return false;
+
+        // If this is a feedback loop, the answer depends on the connections of a node
+        // which hasn't been reached yet, so this step can't be re-used in a later rebuild
+        if (sourceStep > currentStep)
+            history.steps.getUnchecked (currentStep)->dependsOnLaterNodes = true;
+
+        const bool isMidi = outputChanIndex == AudioProcessorGraph::midiChannelIndex;
+        const Array<const AudioProcessorGraph::Connection*>& outputs = nodeConnections.getUnchecked (sourceStep)->outputs;
+
+        for (int i = 0; i < outputs.size(); ++i)
         {
-            const AudioProcessorGraph::Node* const node = (const AudioProcessorGraph::Node*) orderedNodes.getUnchecked (stepIndexToSearchFrom);
+            const AudioProcessorGraph::Connection* const c = outputs.getUnchecked (i);
 
-            if (outputChanIndex == AudioProcessorGraph::midiChannelIndex)
+            if (c->sourceChannelIndex == outputChanIndex
+                 && isMidi == (c->destChannelIndex == AudioProcessorGraph::midiChannelIndex))
             {
-                if (inputChannelOfIndexToIgnore != AudioProcessorGraph::midiChannelIndex
-                     && graph.getConnectionBetween (nodeId, AudioProcessorGraph::midiChannelIndex,
-                                                    node->nodeId, AudioProcessorGraph::midiChannelIndex) != nullptr)
+                const int destStep = getStepIndex (c->destNodeId);
+
+                if (destStep > stepIndexToSearchFrom
+                     || (destStep == stepIndexToSearchFrom && c->destChannelIndex != inputChannelOfIndexToIgnore))
                     return true;
             }
-            else
-            {
-                for (int i = 0; i < node->getProcessor()->getTotalNumInputChannels(); ++i)
-                    if (i != inputChannelOfIndexToIgnore
-                         && graph.getConnectionBetween (nodeId, outputChanIndex,
-                                                        node->nodeId, i) != nullptr)
-                        return true;
-            }
-
-            inputChannelOfIndexToIgnore = -1;
-            ++stepIndexToSearchFrom;
         }
 
         return false;
@@ -787,15 +1381,29 @@ private:
         {
             jassert (bufferNum > 0 && bufferNum < midiNodeIds.size());
 
+            addBufferChange (true, bufferNum, false);
+
+            if (isNodeBusy (midiNodeIds.getUnchecked (bufferNum)))
+                bufferStateHash ^= hashBufferContents (bufferNum, midiNodeIds.getUnchecked (bufferNum), outputIndex);
+
             midiNodeIds.set (bufferNum, nodeId);
         }
         else
         {
             jassert (bufferNum >= 0 && bufferNum < nodeIds.size());
 
+            addBufferChange (false, bufferNum, false);
+
+            if (isNodeBusy (nodeIds.getUnchecked (bufferNum)))
+                bufferStateHash ^= hashBufferContents (bufferNum, nodeIds.getUnchecked (bufferNum), channels.getUnchecked (bufferNum));
+
             nodeIds.set (bufferNum, nodeId);
             channels.set (bufferNum, outputIndex);
         }
+
+        bufferStateHash ^= hashBufferContents (bufferNum, nodeId, outputIndex);
+
+        scheduleBufferRelease (bufferNum, nodeId, outputIndex, currentStep);
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderingOpSequenceCalculator)
@@ -822,51 +1430,91 @@ public:
             }
 
             entry->srcNodes.add (c->sourceNodeId);
+
+            allNodeIds.add (c->sourceNodeId);
+            allNodeIds.add (c->destNodeId);
+        }
+    }
+
+    /** Returns the set of nodes which feed into the given one, either directly or via
+        other nodes, as bits indexed by getNodeIndex(). Returns nullptr if the node has
+        no inputs at all.
+    */
+    const BigInteger* getAllInputsTo (const uint32 destNodeId) const noexcept
+    {
+        int index;
+
+        if (Entry* const entry = findEntry (destNodeId, index))
+        {
+            if (! entry->hasFoundAllInputs)
+                findAllInputs (*entry);
+
+            return &(entry->allInputs);
         }
+
+        return nullptr;
     }
 
-    bool isAnInputTo (const uint32 possibleInputId,
-                      const uint32 possibleDestinationId) const noexcept
+    /** Returns the bit used to represent a node in the sets returned by getAllInputsTo(),
+        or -1 if the node isn't connected to anything.
+    */
+    int getNodeIndex (const uint32 nodeId) const noexcept
     {
-        return isAnInputToRecursive (possibleInputId, possibleDestinationId, entries.size());
+        return allNodeIds.indexOf (nodeId);
     }
 
 private:
     //==============================================================================
     struct Entry
     {
-        explicit Entry (const uint32 destNodeId_) noexcept : destNodeId (destNodeId_) {}
+        explicit Entry (const uint32 destNodeId_) noexcept
+            : destNodeId (destNodeId_), hasFoundAllInputs (false) {}
 
         const uint32 destNodeId;
         SortedSet<uint32> srcNodes;
 
+        BigInteger allInputs;
+        bool hasFoundAllInputs;
+
         JUCE_DECLARE_NON_COPYABLE (Entry)
     };
 
     OwnedArray<Entry> entries;
+    SortedSet<uint32> allNodeIds;
 
-    bool isAnInputToRecursive (const uint32 possibleInputId,
-                               const uint32 possibleDestinationId,
-                               int recursionCheck) const noexcept
+    void findAllInputs (Entry& entry) const noexcept
     {
-        int index;
+        BigInteger& inputs = entry.allInputs;
+        Array<const Entry*> entriesToSearch;
+        entriesToSearch.add (&entry);
 
-        if (const Entry* const entry = findEntry (possibleDestinationId, index))
+        while (entriesToSearch.size() > 0)
         {
-            const SortedSet<uint32>& srcNodes = entry->srcNodes;
-
-            if (srcNodes.contains (possibleInputId))
-                return true;
+            const SortedSet<uint32>& srcNodes = entriesToSearch.remove (entriesToSearch.size() - 1)->srcNodes;
 
-            if (--recursionCheck >= 0)
+            for (int i = 0; i < srcNodes.size(); ++i)
             {
-                for (int i = 0; i < srcNodes.size(); ++i)
-                    if (isAnInputToRecursive (possibleInputId, srcNodes.getUnchecked(i), recursionCheck))
-                        return true;
+                const uint32 srcNode = srcNodes.getUnchecked (i);
+                const int srcIndex = getNodeIndex (srcNode);
+
+                if (! inputs[srcIndex])
+                {
+                    inputs.setBit (srcIndex);
+
+                    int index;
+
+                    if (const Entry* const srcEntry = findEntry (srcNode, index))
+                    {
+                        if (srcEntry->hasFoundAllInputs)
+                            inputs |= srcEntry->allInputs;
+                        else
+                            entriesToSearch.add (srcEntry);
+                    }
+                }
             }
         }
 
-        return false;
+        entry.hasFoundAllInputs = true;
     }
 
     Entry* findEntry (const uint32 destNodeId, int& insertIndex) const noexcept
@@ -931,6 +1579,194 @@ struct ConnectionSorter
     }
 };
 
+//==============================================================================
+/** Splits a rendering sequence into tasks, each one made up of a node's
+    ProcessBufferOp and the ops which prepare its input buffers, and works out
+    which of the tasks have to wait for each other because they use the same
+    shared buffers.
+
+    Running the tasks in any order which respects these dependencies produces
+    exactly the same output as performing all the ops one after the other.
+*/
+struct RenderingTaskGraph
+{
+    RenderingTaskGraph (const Array<void*>& ops)
+        : numOps (ops.size())
+    {
+        Array<int> lastWriters;
+        Array<Array<int> > readersSinceLastWrite;
+        BufferAccess access;
+        int firstOpInTask = 0;
+
+        for (int i = 0; i < ops.size(); ++i)
+        {
+            const AudioGraphRenderingOpBase* const op = static_cast<const AudioGraphRenderingOpBase*> (ops.getUnchecked (i));
+            op->getBufferAccess (access);
+
+            if (dynamic_cast<const ProcessBufferOp*> (op) != nullptr || i == ops.size() - 1)
+            {
+                addTask (ops, firstOpInTask, i + 1, access, lastWriters, readersSinceLastWrite);
+                access = BufferAccess();
+                firstOpInTask = i + 1;
+            }
+        }
+
+        for (int i = 0; i < tasks.size(); ++i)
+            if (tasks.getUnchecked (i)->numDependencies == 0)
+                initialTasks.add (i);
+
+        readyTasks.insertMultiple (0, Atomic<int>(), tasks.size());
+    }
+
+    //==============================================================================
+    struct Task
+    {
+        Array<AudioGraphRenderingOpBase*> ops;
+        Array<int> dependents;
+        int numDependencies;
+        Atomic<int> numDependenciesRemaining;
+    };
+
+    /** Resets the dependency counters and queues up the tasks that can start straight away. */
+    void prepareForNextBlock() noexcept
+    {
+        for (int i = tasks.size(); --i >= 0;)
+        {
+            Task& task = *tasks.getUnchecked (i);
+            task.numDependenciesRemaining.set (task.numDependencies);
+            readyTasks.getReference (i).set (0);
+        }
+
+        numTasksQueued.set (0);
+        numTasksStarted.set (0);
+        numTasksFinished.set (0);
+
+        for (int i = 0; i < initialTasks.size(); ++i)
+            pushReadyTask (initialTasks.getUnchecked (i));
+    }
+
+    /** Claims the next task that is ready to run, or returns -1 if there isn't one yet. */
+    int popReadyTask() noexcept
+    {
+        for (;;)
+        {
+            const int index = numTasksStarted.get();
+
+            if (index >= numTasksQueued.get())
+                return -1;
+
+            const int taskPlusOne = readyTasks.getReference (index).get();
+
+            if (taskPlusOne == 0)
+                return -1; // another thread has reserved this slot but not filled it yet
+
+            if (numTasksStarted.compareAndSetBool (index + 1, index))
+                return taskPlusOne - 1;
+        }
+    }
+
+    /** Runs a task, and queues up any of its dependents that are now ready to go. */
+    template <typename FloatType>
+    void performTask (const int taskIndex, AudioBuffer<FloatType>& sharedBufferChans,
+                      const OwnedArray<MidiBuffer>& sharedMidiBuffers, const int numSamples)
+    {
+        const Task& task = *tasks.getUnchecked (taskIndex);
+
+        for (int i = 0; i < task.ops.size(); ++i)
+            task.ops.getUnchecked (i)->perform (sharedBufferChans, sharedMidiBuffers, numSamples);
+
+        for (int i = 0; i < task.dependents.size(); ++i)
+        {
+            const int dependent = task.dependents.getUnchecked (i);
+
+            if (--(tasks.getUnchecked (dependent)->numDependenciesRemaining) == 0)
+                pushReadyTask (dependent);
+        }
+
+        ++numTasksFinished;
+    }
+
+    bool isFinished() const noexcept        { return numTasksFinished.get() >= tasks.size(); }
+
+    const int numOps;
+
+private:
+    OwnedArray<Task> tasks;
+    Array<int> initialTasks;
+
+    // A fixed-size lock-free queue: each task is pushed once per block, so a slot is
+    // never re-used until prepareForNextBlock() is called again.
+    Array<Atomic<int> > readyTasks;
+    Atomic<int> numTasksQueued, numTasksStarted, numTasksFinished;
+
+    void pushReadyTask (const int taskIndex) noexcept
+    {
+        const int slot = (++numTasksQueued) - 1;
+        readyTasks.getReference (slot).set (taskIndex + 1);
+    }
+
+    void addTask (const Array<void*>& ops, const int startOp, const int endOp, const BufferAccess& access,
+                  Array<int>& lastWriters, Array<Array<int> >& readersSinceLastWrite)
+    {
+        const int taskIndex = tasks.size();
+        Task* const task = tasks.add (new Task());
+
+        for (int i = startOp; i < endOp; ++i)
+            task->ops.add (static_cast<AudioGraphRenderingOpBase*> (ops.getUnchecked (i)));
+
+        SortedSet<int> dependencies;
+
+        for (int i = 0; i < access.writes.size(); ++i)
+        {
+            const int resource = access.writes.getUnchecked (i);
+            ensureResourceExists (resource, lastWriters, readersSinceLastWrite);
+
+            if (lastWriters.getUnchecked (resource) >= 0)
+                dependencies.add (lastWriters.getUnchecked (resource));
+
+            Array<int>& readers = readersSinceLastWrite.getReference (resource);
+
+            for (int j = 0; j < readers.size(); ++j)
+                dependencies.add (readers.getUnchecked (j));
+
+            readers.clearQuick();
+            lastWriters.set (resource, taskIndex);
+        }
+
+        for (int i = 0; i < access.reads.size(); ++i)
+        {
+            const int resource = access.reads.getUnchecked (i);
+
+            if (! access.writes.contains (resource))
+            {
+                ensureResourceExists (resource, lastWriters, readersSinceLastWrite);
+
+                if (lastWriters.getUnchecked (resource) >= 0)
+                    dependencies.add (lastWriters.getUnchecked (resource));
+
+                readersSinceLastWrite.getReference (resource).add (taskIndex);
+            }
+        }
+
+        task->numDependencies = dependencies.size();
+
+        for (int i = 0; i < dependencies.size(); ++i)
+            tasks.getUnchecked (dependencies.getUnchecked (i))->dependents.add (taskIndex);
+    }
+
+    static void ensureResourceExists (const int resource, Array<int>& lastWriters,
+                                      Array<Array<int> >& readersSinceLastWrite)
+    {
+        while (lastWriters.size() <= resource)
+        {
+            lastWriters.add (-1);
+            readersSinceLastWrite.add (Array<int>());
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (RenderingTaskGraph)
+};
+
 }
 
 //==============================================================================
@@ -1030,6 +1866,139 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
     FloatAndDoubleComposition<AudioBuffer<FloatPlaceholder> > renderingBuffers;
     FloatAndDoubleComposition<AudioBuffer<FloatPlaceholder>*> currentAudioInputBuffer;
     FloatAndDoubleComposition<AudioBuffer<FloatPlaceholder> > currentAudioOutputBuffer;
+
+    GraphRenderingOps::RenderingSequenceHistory sequenceHistory;
+};
+
+//==============================================================================
+/** Runs the tasks of a RenderingTaskGraph on the audio thread plus a set of worker
+    threads, with each thread grabbing whichever task is ready next.
+*/
+struct AudioProcessorGraph::ParallelRenderer
+{
+    ParallelRenderer (const int numThreads)
+        : floatBuffers (nullptr), doubleBuffers (nullptr),
+          midiBuffers (nullptr), numSamples (0)
+    {
+        for (int i = 1; i < numThreads; ++i)
+            workers.add (new WorkerThread (*this));
+
+        for (int i = 0; i < workers.size(); ++i)
+            workers.getUnchecked (i)->startThread (realtimeAudioPriority);
+    }
+
+    ~ParallelRenderer()
+    {
+        for (int i = 0; i < workers.size(); ++i)
+            workers.getUnchecked (i)->signalThreadShouldExit();
+
+        for (int i = 0; i < workers.size(); ++i)
+        {
+            workers.getUnchecked (i)->notify();
+            workers.getUnchecked (i)->stopThread (4000);
+        }
+    }
+
+    int getNumThreads() const noexcept      { return workers.size() + 1; }
+
+    bool canRender (const Array<void*>& ops) const noexcept
+    {
+        return taskGraph != nullptr && ops.size() > 0 && taskGraph->numOps == ops.size();
+    }
+
+    template <typename FloatType>
+    void render (AudioBuffer<FloatType>& sharedBufferChans, const OwnedArray<MidiBuffer>& sharedMidiBuffers, const int numSamplesToRender)
+    {
+        setBuffers (sharedBufferChans);
+        midiBuffers = &sharedMidiBuffers;
+        numSamples = numSamplesToRender;
+
+        taskGraph->prepareForNextBlock();
+        isRendering.set (1);
+
+        for (int i = 0; i < workers.size(); ++i)
+            workers.getUnchecked (i)->notify();
+
+        performTasksUntilFinished (true);
+
+        // Wait for any workers which are still looking at this block to leave it
+        // before the buffers are touched again..
+        isRendering.set (0);
+
+        while (numActiveWorkers.get() > 0)
+        {}
+    }
+
+    ScopedPointer<GraphRenderingOps::RenderingTaskGraph> taskGraph;
+
+private:
+    //==============================================================================
+    struct WorkerThread  : public Thread
+    {
+        WorkerThread (ParallelRenderer& r)  : Thread ("Audio graph renderer"), owner (r) {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                wait (-1);
+
+                ++(owner.numActiveWorkers);
+
+                if (owner.isRendering.get() != 0)
+                    owner.performTasksUntilFinished (false);
+
+                --(owner.numActiveWorkers);
+            }
+        }
+
+        ParallelRenderer& owner;
+
+        JUCE_DECLARE_NON_COPYABLE (WorkerThread)
+    };
+
+    OwnedArray<WorkerThread> workers;
+    Atomic<int> isRendering, numActiveWorkers;
+
+    AudioBuffer<float>* floatBuffers;
+    AudioBuffer<double>* doubleBuffers;
+    const OwnedArray<MidiBuffer>* midiBuffers;
+    int numSamples;
+
+    enum { realtimeAudioPriority = 9 };
+
+    void setBuffers (AudioBuffer<float>& b) noexcept     { floatBuffers = &b;      doubleBuffers = nullptr; }
+    void setBuffers (AudioBuffer<double>& b) noexcept    { floatBuffers = nullptr; doubleBuffers = &b; }
+
+    void performTasksUntilFinished (const bool isAudioThread)
+    {
+        GraphRenderingOps::RenderingTaskGraph& graph = *taskGraph;
+        int numFailedAttempts = 0;
+
+        while (! graph.isFinished())
+        {
+            const int taskIndex = graph.popReadyTask();
+
+            if (taskIndex >= 0)
+            {
+                if (floatBuffers != nullptr)
+                    graph.performTask (taskIndex, *floatBuffers, *midiBuffers, numSamples);
+                else
+                    graph.performTask (taskIndex, *doubleBuffers, *midiBuffers, numSamples);
+
+                numFailedAttempts = 0;
+            }
+            else if (! isAudioThread && ++numFailedAttempts > 1000)
+            {
+                // If a worker has a higher priority than the audio thread, it mustn't
+                // hog the CPU while waiting for a task that the audio thread is running.
+                Thread::sleep (1);
+                numFailedAttempts = 0;
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelRenderer)
 };
 
 //==============================================================================
@@ -1041,6 +2010,7 @@ AudioProcessorGraph::AudioProcessorGraph()
 
 AudioProcessorGraph::~AudioProcessorGraph()
 {
+    parallelRenderer = nullptr;
     clearRenderingSequence();
     clear();
 }
@@ -1285,22 +2255,28 @@ bool AudioProcessorGraph::removeIllegalConnections()
 }
 
 //==============================================================================
-static void deleteRenderOpArray (Array<void*>& ops)
+static void deleteRenderOpArray (Array<void*>& ops, const int firstOpToDelete = 0)
 {
-    for (int i = ops.size(); --i >= 0;)
+    for (int i = ops.size(); --i >= firstOpToDelete;)
         delete static_cast<GraphRenderingOps::AudioGraphRenderingOpBase*> (ops.getUnchecked(i));
 }
 
 void AudioProcessorGraph::clearRenderingSequence()
 {
     Array<void*> oldOps;
+    ScopedPointer<GraphRenderingOps::RenderingTaskGraph> oldTaskGraph;
 
     {
         const ScopedLock sl (getCallbackLock());
         renderingOps.swapWith (oldOps);
+
+        if (parallelRenderer != nullptr)
+            parallelRenderer->taskGraph.swapWith (oldTaskGraph);
     }
 
+    oldTaskGraph = nullptr;
     deleteRenderOpArray (oldOps);
+    audioBuffers->sequenceHistory.clear();
 }
 
 bool AudioProcessorGraph::isAnInputTo (const uint32 possibleInputId,
@@ -1328,6 +2304,8 @@ void AudioProcessorGraph::buildRenderingSequence()
     Array<void*> newRenderingOps;
     int numRenderingBuffersNeeded = 2;
     int numMidiBuffersNeeded = 1;
+    int numReusedOps = 0;
+    int firstReusedTrailingOp = 0;
 
     {
         MessageManagerLock mml;
@@ -1336,6 +2314,7 @@ void AudioProcessorGraph::buildRenderingSequence()
 
         {
             const GraphRenderingOps::ConnectionLookupTable table (connections);
+            Array<const BigInteger*> orderedNodeInputs;
 
             for (int i = 0; i < nodes.size(); ++i)
             {
@@ -1343,21 +2322,38 @@ void AudioProcessorGraph::buildRenderingSequence()
 
                 node->prepare (getSampleRate(), getBlockSize(), this, getProcessingPrecision());
 
-                int j = 0;
+                // find the first node that this one is an input to..
+                const int nodeIndex = table.getNodeIndex (node->nodeId);
+
+                int j = nodeIndex >= 0 ? 0 : orderedNodes.size();
                 for (; j < orderedNodes.size(); ++j)
-                    if (table.isAnInputTo (node->nodeId, ((Node*) orderedNodes.getUnchecked(j))->nodeId))
-                      break;
+                    if (const BigInteger* const inputs = orderedNodeInputs.getUnchecked (j))
+                        if ((*inputs)[nodeIndex])
+                            break;
 
                 orderedNodes.insert (j, node);
+                orderedNodeInputs.insert (j, table.getAllInputsTo (node->nodeId));
             }
         }
 
-        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps);
+        GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, renderingOps, newRenderingOps,
+                                                                     audioBuffers->sequenceHistory);
+
+        // if nothing that affects the rendering has changed, there's no need to swap anything over
+        if (calculator.isSequenceUnchanged())
+            return;
 
         numRenderingBuffersNeeded = calculator.getNumBuffersNeeded();
         numMidiBuffersNeeded = calculator.getNumMidiBuffersNeeded();
+        numReusedOps = calculator.getNumReusedOps();
+        firstReusedTrailingOp = calculator.getFirstReusedTrailingOp();
     }
 
+    ScopedPointer<GraphRenderingOps::RenderingTaskGraph> newTaskGraph;
+
+    if (parallelRenderer != nullptr)
+        newTaskGraph = new GraphRenderingOps::RenderingTaskGraph (newRenderingOps);
+
     {
         // swap over to the new rendering sequence..
         const ScopedLock sl (getCallbackLock());
@@ -1371,10 +2367,47 @@ void AudioProcessorGraph::buildRenderingSequence()
             midiBuffers.add (new MidiBuffer());
 
         renderingOps.swapWith (newRenderingOps);
+
+        if (parallelRenderer != nullptr)
+            parallelRenderer->taskGraph.swapWith (newTaskGraph);
+    }
+
+    // delete the old ones, apart from any that the new sequence has taken over..
+    newTaskGraph = nullptr;
+    newRenderingOps.removeRange (firstReusedTrailingOp, newRenderingOps.size() - firstReusedTrailingOp);
+    deleteRenderOpArray (newRenderingOps, numReusedOps);
+}
+
+void AudioProcessorGraph::rebuildRenderingSequenceIfNeeded()
+{
+    handleUpdateNowIfNeeded();
+}
+
+//==============================================================================
+void AudioProcessorGraph::setNumRenderingThreads (int numThreads)
+{
+    numThreads = jmax (1, numThreads);
+
+    if (numThreads != getNumRenderingThreads())
+    {
+        ScopedPointer<ParallelRenderer> newRenderer;
+
+        if (numThreads > 1)
+        {
+            newRenderer = new ParallelRenderer (numThreads);
+            newRenderer->taskGraph = new GraphRenderingOps::RenderingTaskGraph (renderingOps);
+        }
+
+        {
+            const ScopedLock sl (getCallbackLock());
+            parallelRenderer.swapWith (newRenderer);
+        }
     }
+}
 
-    // delete the old ones..
-    deleteRenderOpArray (newRenderingOps);
+int AudioProcessorGraph::getNumRenderingThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 1;
 }
 
 void AudioProcessorGraph::handleAsyncUpdate()
@@ -1454,12 +2487,19 @@ void AudioProcessorGraph::processAudio (AudioBuffer<FloatType>& buffer, MidiBuff
     currentMidiInputBuffer = &midiMessages;
     currentMidiOutputBuffer.clear();
 
-    for (int i = 0; i < renderingOps.size(); ++i)
+    if (parallelRenderer != nullptr && parallelRenderer->canRender (renderingOps))
+    {
+        parallelRenderer->render (renderingBuffers, midiBuffers, numSamples);
+    }
+    else
     {
-        GraphRenderingOps::AudioGraphRenderingOpBase* const op
-            = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
+        for (int i = 0; i < renderingOps.size(); ++i)
+        {
+            GraphRenderingOps::AudioGraphRenderingOpBase* const op
+                = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
 
-        op->perform (renderingBuffers, midiBuffers, numSamples);
+            op->perform (renderingBuffers, midiBuffers, numSamples);
+        }
     }
 
     for (int i = 0; i < buffer.getNumChannels(); ++i)
@@ -1654,3 +2694,397 @@ void AudioProcessorGraph::AudioGraphIOProcessor::setParentGraph (AudioProcessorG
         updateHostDisplay();
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioProcessorGraphTests  : public UnitTest
+{
+public:
+    AudioProcessorGraphTests()  : UnitTest ("AudioProcessorGraph") {}
+
+    void runTest() override
+    {
+        // the graph posts async updates when nodes are added
+        const ScopedJuceInitialiser_GUI libraryInitialiser;
+
+        beginTest ("Parallel rendering matches serial rendering");
+
+        for (int numNodes = 1; numNodes <= 17; numNodes += 4)
+        {
+            AudioBuffer<float> serial, parallel;
+            renderGraph (serial, numNodes, 1, 1);
+            renderGraph (parallel, numNodes, 4, 1);
+            expect (buffersAreIdentical (serial, parallel));
+
+            AudioBuffer<double> serialDouble, parallelDouble;
+            renderGraph (serialDouble, numNodes, 1, 1);
+            renderGraph (parallelDouble, numNodes, 3, 1);
+            expect (buffersAreIdentical (serialDouble, parallelDouble));
+        }
+
+        beginTest ("Parallel rendering performance");
+
+        const int numThreads = jmax (2, SystemStats::getNumCpus());
+
+        for (int numNodes = 8; numNodes <= 128; numNodes *= 4)
+        {
+            AudioBuffer<float> serial, parallel;
+            const double serialTime   = renderGraph (serial, numNodes, 1, 8);
+            const double parallelTime = renderGraph (parallel, numNodes, numThreads, 8);
+
+            expect (buffersAreIdentical (serial, parallel));
+
+            logMessage (String (numNodes) + " nodes: serial " + String (serialTime, 1) + "ms, "
+                         + String (numThreads) + " threads " + String (parallelTime, 1) + "ms, speed-up x"
+                         + String (serialTime / jmax (0.001, parallelTime), 2));
+        }
+
+        beginTest ("Incremental rebuilds match full rebuilds");
+
+        Random r (getRandom());
+
+        for (int i = 0; i < 20; ++i)
+        {
+            AudioProcessorGraph graph;
+            createTestGraph (graph, 1 + r.nextInt (40), 1);
+            graph.prepareToPlay (sampleRate, blockSize);
+
+            for (int j = 0; j < 30; ++j)
+            {
+                applyRandomEdit (graph, r);
+
+                if (r.nextBool())
+                    graph.rebuildRenderingSequenceIfNeeded();
+            }
+
+            graph.rebuildRenderingSequenceIfNeeded();
+
+            AudioProcessorGraph copy;
+            copyGraph (graph, copy);
+            copy.prepareToPlay (sampleRate, blockSize);
+
+            graph.reset();
+
+            AudioBuffer<float> incremental, full;
+            renderBlocks (graph, incremental);
+            renderBlocks (copy, full);
+            expect (buffersAreIdentical (incremental, full));
+            expectEquals (graph.getLatencySamples(), copy.getLatencySamples());
+        }
+
+        beginTest ("Repeated edits to a larger graph match full rebuilds");
+
+        for (int i = 0; i < 30; ++i)
+        {
+            AudioProcessorGraph graph;
+            createTestGraph (graph, 10 + r.nextInt (30), 1);
+            graph.prepareToPlay (sampleRate, blockSize);
+
+            for (int j = 0; j < 8; ++j)
+            {
+                // (most of the edits are to the first few nodes, which come near the start of the sequence)
+                const int numNodes = graph.getNumNodes();
+                applyEditToNode (graph, r, jmin (numNodes - 1, 2 + r.nextInt (r.nextInt (3) == 0 ? numNodes : 6)));
+                graph.rebuildRenderingSequenceIfNeeded();
+            }
+
+            AudioProcessorGraph copy;
+            copyGraph (graph, copy);
+            copy.prepareToPlay (sampleRate, blockSize);
+
+            graph.reset();
+
+            AudioBuffer<float> incremental, full;
+            renderBlocks (graph, incremental);
+            renderBlocks (copy, full);
+            expect (buffersAreIdentical (incremental, full));
+            expectEquals (graph.getLatencySamples(), copy.getLatencySamples());
+        }
+
+        beginTest ("Rendering sequence rebuild performance");
+
+        const int graphSizes[] = { 10, 100, 500, 2000 };
+
+        for (int i = 0; i < numElementsInArray (graphSizes); ++i)
+        {
+            const int numNodes = graphSizes[i];
+            AudioProcessorGraph graph;
+            createTestGraph (graph, numNodes, 0);
+            graph.prepareToPlay (sampleRate, blockSize);
+
+            double startTime = Time::getMillisecondCounterHiRes();
+            graph.prepareToPlay (sampleRate, blockSize);
+            const double fullRebuildTime = Time::getMillisecondCounterHiRes() - startTime;
+
+            // re-route the last pair of nodes, which are near the end of the sequence..
+            const uint32 lastId = graph.getNode (graph.getNumNodes() - 1)->nodeId;
+            graph.removeConnection (lastId, 0, outputNodeId, 0);
+
+            startTime = Time::getMillisecondCounterHiRes();
+            graph.rebuildRenderingSequenceIfNeeded();
+            const double lateChangeTime = Time::getMillisecondCounterHiRes() - startTime;
+
+            // ..and the first pair, which are near the start
+            graph.removeConnection (inputNodeId, 0, firstTestNodeId, 0);
+
+            startTime = Time::getMillisecondCounterHiRes();
+            graph.rebuildRenderingSequenceIfNeeded();
+            const double earlyChangeTime = Time::getMillisecondCounterHiRes() - startTime;
+
+            logMessage (String (numNodes) + " nodes: full rebuild " + String (fullRebuildTime, 2)
+                         + "ms, change near the end " + String (lateChangeTime, 2)
+                         + "ms, change near the start " + String (earlyChangeTime, 2) + "ms");
+        }
+    }
+
+private:
+    //==============================================================================
+    struct TestProcessor  : public AudioProcessor
+    {
+        TestProcessor (int processorIndex, int workloadToUse, int latencyToReport = 0)
+            : index (processorIndex),
+              coefficient (0.05f + 0.01f * (processorIndex % 10)),
+              workload (workloadToUse)
+        {
+            setLatencySamples (latencyToReport);
+            reset();
+        }
+
+        const String getName() const override                       { return "Test"; }
+        void prepareToPlay (double, int) override                   { reset(); }
+        void releaseResources() override                            {}
+        void reset() override                                       { state[0] = state[1] = 0; }
+
+        void processBlock (AudioBuffer<float>& buffer, MidiBuffer&) override
+        {
+            for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+            {
+                float* const data = buffer.getWritePointer (chan);
+                float s = state[chan & 1];
+
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    float x = data[i];
+
+                    for (int j = 0; j < workload; ++j)
+                        x = x * 0.999f + 0.001f * std::sin (x);
+
+                    s += coefficient * (x - s);
+                    data[i] = s;
+                }
+
+                state[chan & 1] = s;
+            }
+        }
+
+        double getTailLengthSeconds() const override                { return 0; }
+        bool acceptsMidi() const override                           { return false; }
+        bool producesMidi() const override                          { return false; }
+        AudioProcessorEditor* createEditor() override               { return nullptr; }
+        bool hasEditor() const override                             { return false; }
+        int getNumPrograms() override                               { return 1; }
+        int getCurrentProgram() override                            { return 0; }
+        void setCurrentProgram (int) override                       {}
+        const String getProgramName (int) override                  { return String(); }
+        void changeProgramName (int, const String&) override        {}
+        void getStateInformation (juce::MemoryBlock&) override      {}
+        void setStateInformation (const void*, int) override        {}
+
+        const int index;
+        const float coefficient;
+        const int workload;
+        float state[2];
+    };
+
+    typedef AudioProcessorGraph::AudioGraphIOProcessor IOProcessor;
+
+    enum { blockSize = 256, numBlocks = 32, inputNodeId = 1, outputNodeId = 2, firstTestNodeId = 3 };
+    static const double sampleRate;
+
+    //==============================================================================
+    // Creates a graph made of pairs of nodes in series, with all the pairs in parallel
+    // between the graph's input and output.
+    static void createTestGraph (AudioProcessorGraph& graph, int numNodes, int workload)
+    {
+        graph.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+
+        graph.addNode (new IOProcessor (IOProcessor::audioInputNode), inputNodeId);
+        graph.addNode (new IOProcessor (IOProcessor::audioOutputNode), outputNodeId);
+        uint32 previousId = inputNodeId;
+
+        for (int i = 0; i < numNodes; ++i)
+        {
+            const uint32 nodeId = graph.addNode (new TestProcessor (i, workload))->nodeId;
+
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                graph.addConnection ((i & 1) == 0 ? (uint32) inputNodeId : previousId, chan, nodeId, chan);
+
+                if ((i & 1) != 0 || i == numNodes - 1)
+                    graph.addConnection (nodeId, chan, outputNodeId, chan);
+            }
+
+            previousId = nodeId;
+        }
+    }
+
+    static void copyGraph (AudioProcessorGraph& source, AudioProcessorGraph& dest)
+    {
+        dest.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+
+        for (int i = 0; i < source.getNumNodes(); ++i)
+        {
+            const AudioProcessorGraph::Node* const node = source.getNode (i);
+            AudioProcessor* processor;
+
+            if (const IOProcessor* const io = dynamic_cast<const IOProcessor*> (node->getProcessor()))
+                processor = new IOProcessor (io->getType());
+            else if (const TestProcessor* const test = dynamic_cast<const TestProcessor*> (node->getProcessor()))
+                processor = new TestProcessor (test->index, test->workload, test->getLatencySamples());
+            else
+                continue;
+
+            dest.addNode (processor, node->nodeId);
+        }
+
+        for (int i = 0; i < source.getNumConnections(); ++i)
+        {
+            const AudioProcessorGraph::Connection* const c = source.getConnection (i);
+            dest.addConnection (c->sourceNodeId, c->sourceChannelIndex, c->destNodeId, c->destChannelIndex);
+        }
+    }
+
+    static void applyRandomEdit (AudioProcessorGraph& graph, Random& r)
+    {
+        const int numNodes = graph.getNumNodes();
+
+        switch (r.nextInt (4))
+        {
+            case 0:
+                if (numNodes > 0)
+                    graph.addConnection (graph.getNode (r.nextInt (numNodes))->nodeId, r.nextInt (2),
+                                         graph.getNode (r.nextInt (numNodes))->nodeId, r.nextInt (2));
+                break;
+
+            case 1:
+                if (graph.getNumConnections() > 0)
+                    graph.removeConnection (r.nextInt (graph.getNumConnections()));
+                break;
+
+            case 2:
+                if (numNodes > 2)
+                    graph.removeNode (graph.getNode (r.nextInt (numNodes))->nodeId);
+                break;
+
+            default:
+            {
+                const int latency = r.nextInt (3) == 0 ? r.nextInt (100) : 0;
+                const uint32 nodeId = graph.addNode (new TestProcessor (r.nextInt (100), 1, latency))->nodeId;
+
+                if (numNodes > 0)
+                {
+                    graph.addConnection (graph.getNode (r.nextInt (numNodes))->nodeId, r.nextInt (2), nodeId, r.nextInt (2));
+                    graph.addConnection (nodeId, r.nextInt (2), graph.getNode (r.nextInt (numNodes))->nodeId, r.nextInt (2));
+                }
+
+                break;
+            }
+        }
+    }
+
+    // Changes the latency or connections of a node, or removes it.
+    static void applyEditToNode (AudioProcessorGraph& graph, Random& r, int nodeIndex)
+    {
+        const uint32 nodeIdToEdit = graph.getNode (nodeIndex)->nodeId;
+
+        switch (r.nextInt (4))
+        {
+            case 0:
+                graph.getNodeForId (nodeIdToEdit)->getProcessor()->setLatencySamples (r.nextInt (100));
+
+                // (the graph doesn't notice latency changes by itself, so make it rebuild)
+                graph.removeNode (graph.addNode (new TestProcessor (0, 1))->nodeId);
+                break;
+
+            case 1:
+            {
+                const uint32 nodeId = graph.addNode (new TestProcessor (r.nextInt (100), 1, r.nextInt (100)))->nodeId;
+                graph.addConnection (inputNodeId, 0, nodeId, 0);
+                graph.addConnection (nodeId, 0, nodeIdToEdit, r.nextInt (2));
+                break;
+            }
+
+            case 2:
+                graph.disconnectNode (nodeIdToEdit);
+                graph.addConnection (inputNodeId, r.nextInt (2), nodeIdToEdit, r.nextInt (2));
+                graph.addConnection (nodeIdToEdit, r.nextInt (2), outputNodeId, r.nextInt (2));
+                break;
+
+            default:
+                if (graph.getNumNodes() > 4 && nodeIdToEdit != inputNodeId && nodeIdToEdit != outputNodeId)
+                    graph.removeNode (nodeIdToEdit);
+
+                break;
+        }
+    }
+
+    // Renders some blocks of a test signal through the graph, and returns the time taken in milliseconds.
+    template <typename FloatType>
+    static double renderBlocks (AudioProcessorGraph& graph, AudioBuffer<FloatType>& result)
+    {
+        AudioBuffer<FloatType> block (2, blockSize);
+        MidiBuffer midi;
+        result.setSize (2, blockSize * numBlocks);
+
+        const double startTime = Time::getMillisecondCounterHiRes();
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            for (int chan = 0; chan < 2; ++chan)
+                for (int j = 0; j < blockSize; ++j)
+                    block.setSample (chan, j, (FloatType) std::sin ((i * blockSize + j) * 0.01 * (chan + 1)));
+
+            graph.processBlock (block, midi);
+
+            for (int chan = 0; chan < 2; ++chan)
+                result.copyFrom (chan, i * blockSize, block, chan, 0, blockSize);
+        }
+
+        return Time::getMillisecondCounterHiRes() - startTime;
+    }
+
+    template <typename FloatType>
+    static double renderGraph (AudioBuffer<FloatType>& result, int numNodes, int numThreads, int workload)
+    {
+        AudioProcessorGraph graph;
+        graph.setProcessingPrecision (sizeof (FloatType) == sizeof (double) ? AudioProcessor::doublePrecision
+                                                                             : AudioProcessor::singlePrecision);
+        createTestGraph (graph, numNodes, workload);
+        graph.setNumRenderingThreads (numThreads);
+        graph.prepareToPlay (sampleRate, blockSize);
+
+        const double timeTaken = renderBlocks (graph, result);
+        graph.releaseResources();
+        return timeTaken;
+    }
+
+    template <typename FloatType>
+    static bool buffersAreIdentical (const AudioBuffer<FloatType>& a, const AudioBuffer<FloatType>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return false;
+
+        for (int chan = 0; chan < a.getNumChannels(); ++chan)
+            if (memcmp (a.getReadPointer (chan), b.getReadPointer (chan), sizeof (FloatType) * (size_t) a.getNumSamples()) != 0)
+                return false;
+
+        return true;
+    }
+};
+
+const double AudioProcessorGraphTests::sampleRate = 44100.0;
+
+static AudioProcessorGraphTests audioProcessorGraphTests;
+
+#endif
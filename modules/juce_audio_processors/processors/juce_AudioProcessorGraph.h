@@ -248,6 +248,38 @@ public:
     */
     bool removeIllegalConnections();
 
+    //==============================================================================
+    /** Brings the graph's rendering sequence up to date straight away.
+
+        When nodes or connections are changed, the graph normally updates the sequence
+        of operations it uses for rendering asynchronously on the message thread. Only
+        the part of the sequence that comes after the first affected node is rebuilt.
+        If there's a pending update, this performs it synchronously. It must only be
+        called on the message thread.
+    */
+    void rebuildRenderingSequenceIfNeeded();
+
+    //==============================================================================
+    /** Sets the number of threads that the graph will use to render its nodes.
+
+        By default, all the nodes are rendered one after the other on the audio thread.
+        If you set this to a value greater than 1, the graph will start (numThreads - 1)
+        realtime worker threads, and any nodes that don't depend on each other's output
+        will be processed on these threads in parallel with the audio thread.
+
+        The rendered output is sample-for-sample identical to the single-threaded mode,
+        but the processors in the graph must be happy to have their processBlock()
+        methods called concurrently with those of other processors.
+
+        @see getNumRenderingThreads
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    /** Returns the number of threads that the graph is using to render its nodes.
+        @see setNumRenderingThreads
+    */
+    int getNumRenderingThreads() const noexcept;
+
     //==============================================================================
     /** A special number that represents the midi channel of a node.
 
@@ -392,6 +424,9 @@ private:
     MidiBuffer* currentMidiInputBuffer;
     MidiBuffer currentMidiOutputBuffer;
 
+    struct ParallelRenderer;
+    ScopedPointer<ParallelRenderer> parallelRenderer;
+
     void handleAsyncUpdate() override;
     void clearRenderingSequence();
     void buildRenderingSequence();
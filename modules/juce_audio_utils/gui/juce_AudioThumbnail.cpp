@@ -71,6 +71,11 @@ private:
     char values[2];
 };
 
+static inline uint8 rmsToByte (const float rmsLevel) noexcept
+{
+    return (uint8) jlimit (0, 255, roundFloatToInt (rmsLevel * 255.0f));
+}
+
 //==============================================================================
 class AudioThumbnail::LevelDataSource   : public TimeSliceClient
 {
@@ -89,7 +94,10 @@ public:
 
     ~LevelDataSource()
     {
-        owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
+        if (AudioThumbnailBuilder* builder = owner.cache.getBuilder())
+            builder->removeClient (*this);
+        else
+            owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
     }
 
     enum { timeBeforeDeletingReader = 3000 };
@@ -111,7 +119,7 @@ public:
             if (lengthInSamples <= 0 || isFullyLoaded())
                 reader = nullptr;
             else
-                owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+                startScanning();
         }
     }
 
@@ -126,7 +134,7 @@ public:
             if (reader != nullptr)
             {
                 lastReaderUseTime = Time::getMillisecondCounter();
-                owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+                startScanning();
             }
         }
 
@@ -206,6 +214,14 @@ private:
     CriticalSection readerLock;
     uint32 lastReaderUseTime;
 
+    void startScanning()
+    {
+        if (AudioThumbnailBuilder* builder = owner.cache.getBuilder())
+            builder->addClient (*this, owner);
+        else
+            owner.cache.getTimeSliceThread().addTimeSliceClient (this);
+    }
+
     void createReader()
     {
         if (reader == nullptr && source != nullptr)
@@ -235,20 +251,48 @@ private:
                 for (int i = 0; i < (int) numChannels; ++i)
                     levels[i] = levelData + i * numThumbSamps;
 
-                HeapBlock<Range<float> > levelsRead (numChannels);
+                HeapBlock<uint8> rmsData;
+                HeapBlock<uint8*> rmsLevels;
+
+                if (owner.storeRMSLevels)
+                {
+                    // measuring the RMS level means reading the samples themselves
+                    rmsData.malloc ((size_t) numThumbSamps * numChannels);
+                    rmsLevels.malloc (numChannels);
+
+                    for (int i = 0; i < (int) numChannels; ++i)
+                        rmsLevels[i] = rmsData + i * numThumbSamps;
 
-                for (int i = 0; i < numThumbSamps; ++i)
+                    const int samplesPerThumbSample = owner.samplesPerThumbSample;
+                    AudioSampleBuffer buffer ((int) numChannels, numThumbSamps * samplesPerThumbSample);
+                    reader->read (&buffer, 0, buffer.getNumSamples(), firstThumbIndex * (int64) samplesPerThumbSample, true, true);
+
+                    for (int i = 0; i < numThumbSamps; ++i)
+                    {
+                        for (int j = 0; j < (int) numChannels; ++j)
+                        {
+                            levels[j][i].setFloat (buffer.findMinMax (j, i * samplesPerThumbSample, samplesPerThumbSample));
+                            rmsLevels[j][i] = rmsToByte (buffer.getRMSLevel (j, i * samplesPerThumbSample, samplesPerThumbSample));
+                        }
+                    }
+                }
+                else
                 {
-                    reader->readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample,
-                                           owner.samplesPerThumbSample, levelsRead, (int) numChannels);
+                    HeapBlock<Range<float> > levelsRead (numChannels);
+
+                    for (int i = 0; i < numThumbSamps; ++i)
+                    {
+                        reader->readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample,
+                                               owner.samplesPerThumbSample, levelsRead, (int) numChannels);
 
-                    for (int j = 0; j < (int) numChannels; ++j)
-                        levels[j][i].setFloat (levelsRead[j]);
+                        for (int j = 0; j < (int) numChannels; ++j)
+                            levels[j][i].setFloat (levelsRead[j]);
+                    }
                 }
 
                 {
                     const ScopedUnlock su (readerLock);
-                    owner.setLevels (levels, firstThumbIndex, (int) numChannels, numThumbSamps);
+                    owner.setLevels (levels, rmsLevels, firstThumbIndex, (int) numChannels, numThumbSamps);
                 }
 
                 numSamplesFinished += numToDo;
@@ -261,43 +305,67 @@ private:
 };
 
 //==============================================================================
+/*  Each channel's data is kept as a pyramid of levels: level 0 holds one value for each
+    block of samplesPerThumbSample samples, and each level above it holds the combined
+    values of pairs from the level below. This means that the range of any span of the
+    thumbnail can be found by looking at a handful of values, whatever its length.
+*/
 class AudioThumbnail::ThumbData
 {
 public:
-    ThumbData (const int numThumbSamples)
-        : peakLevel (-1)
+    ThumbData (const int numThumbSamples, const bool shouldStoreRMSLevels)
+        : peakLevel (-1), storesRMS (shouldStoreRMSLevels)
     {
+        levels.add (new Level());
         ensureSize (numThumbSamples);
     }
 
+    enum
+    {
+        hasRMSLevelsFlag = 1,
+        hasPyramidFlag   = 2
+    };
+
     inline MinMaxValue* getData (const int thumbSampleIndex) noexcept
     {
-        jassert (thumbSampleIndex < data.size());
-        return data.getRawDataPointer() + thumbSampleIndex;
+        return getData (0, thumbSampleIndex);
+    }
+
+    inline MinMaxValue* getData (const int level, const int index) noexcept
+    {
+        jassert (index < getLevelSize (level));
+        return levels.getUnchecked (level)->minMax.getRawDataPointer() + index;
     }
 
-    int getSize() const noexcept
+    inline uint8* getRMSData (const int level, const int index) noexcept
     {
-        return data.size();
+        jassert (storesRMS && index < getLevelSize (level));
+        return levels.getUnchecked (level)->rms.getRawDataPointer() + index;
     }
 
+    int getSize() const noexcept                        { return getLevelSize (0); }
+    int getNumLevels() const noexcept                   { return levels.size(); }
+    int getLevelSize (int level) const noexcept         { return levels.getUnchecked (level)->minMax.size(); }
+    bool storesRMSLevels() const noexcept               { return storesRMS; }
+
     void getMinMax (int startSample, int endSample, MinMaxValue& result) const noexcept
     {
         if (startSample >= 0)
         {
-            endSample = jmin (endSample, data.size() - 1);
-
             char mx = -128;
             char mn = 127;
 
-            while (startSample <= endSample)
+            // At each level, the values at the ends of the range that don't form a complete
+            // pair are used directly, and the rest of the range is covered by the level above.
+            for (int level = 0, end = jmin (endSample, getSize() - 1) + 1; startSample < end; ++level)
             {
-                const MinMaxValue& v = data.getReference (startSample);
+                const MinMaxValue* const data = levels.getUnchecked (level)->minMax.getRawDataPointer();
 
-                if (v.getMinValue() < mn)  mn = v.getMinValue();
-                if (v.getMaxValue() > mx)  mx = v.getMaxValue();
+                if ((startSample & 1) != 0)  addToRange (data[startSample++], mn, mx);
+                if ((end & 1) != 0)          addToRange (data[--end], mn, mx);
 
-                ++startSample;
+                startSample >>= 1;
+                end >>= 1;
             }
 
             if (mn <= mx)
@@ -310,17 +378,74 @@ public:
         result.set (1, 0);
     }
 
-    void write (const MinMaxValue* const values, const int startIndex, const int numValues)
+    float getRMSLevel (int startSample, int endSample) const noexcept
+    {
+        double sumOfSquares = 0;
+        int numValues = 0;
+
+        if (storesRMS && startSample >= 0)
+        {
+            for (int level = 0, end = jmin (endSample, getSize() - 1) + 1; startSample < end; ++level)
+            {
+                const uint8* const data = levels.getUnchecked (level)->rms.getRawDataPointer();
+                const int weight = 1 << level;
+
+                if ((startSample & 1) != 0)  { sumOfSquares += weight * square ((double) data[startSample++]); numValues += weight; }
+                if ((end & 1) != 0)          { sumOfSquares += weight * square ((double) data[--end]);         numValues += weight; }
+
+                startSample >>= 1;
+                end >>= 1;
+            }
+        }
+
+        return numValues > 0 ? (float) (std::sqrt (sumOfSquares / numValues) / 255.0) : 0.0f;
+    }
+
+    void write (const MinMaxValue* const values, const uint8* const rmsValues,
+                const int startIndex, const int numValues)
     {
         resetPeak();
 
-        if (startIndex + numValues > data.size())
+        if (startIndex + numValues > getSize())
             ensureSize (startIndex + numValues);
 
         MinMaxValue* const dest = getData (startIndex);
 
         for (int i = 0; i < numValues; ++i)
             dest[i] = values[i];
+
+        if (storesRMS && rmsValues != nullptr)
+            memcpy (getRMSData (0, startIndex), rmsValues, (size_t) numValues);
+
+        updateLevels (startIndex, startIndex + numValues);
+    }
+
+    /** Recalculates the levels above level 0 for a range of level 0's values. */
+    void updateLevels (int start, int end) noexcept
+    {
+        for (int level = 1; level < levels.size(); ++level)
+        {
+            const Level& source = *levels.getUnchecked (level - 1);
+            Level& dest = *levels.getUnchecked (level);
+            const int lastSourceIndex = source.minMax.size() - 1;
+
+            start >>= 1;
+            end = (end + 1) >> 1;
+
+            for (int i = start; i < end; ++i)
+            {
+                const int first = i * 2, second = jmin (first + 1, lastSourceIndex);
+                const MinMaxValue& v1 = source.minMax.getReference (first);
+                const MinMaxValue& v2 = source.minMax.getReference (second);
+
+                dest.minMax.getReference (i).set (jmin (v1.getMinValue(), v2.getMinValue()),
+                                                  jmax (v1.getMaxValue(), v2.getMaxValue()));
+
+                if (storesRMS)
+                    dest.rms.set (i, (uint8) roundToInt (std::sqrt ((square ((double) source.rms[first])
+                                                                       + square ((double) source.rms[second])) * 0.5)));
+            }
+        }
     }
 
     void resetPeak() noexcept
@@ -330,28 +455,58 @@ public:
 
     int getPeak() noexcept
     {
-        if (peakLevel < 0)
-        {
-            for (int i = 0; i < data.size(); ++i)
-            {
-                const int peak = data[i].getPeak();
-                if (peak > peakLevel)
-                    peakLevel = peak;
-            }
-        }
+        if (peakLevel < 0 && getSize() > 0)
+            peakLevel = levels.getLast()->minMax.getReference (0).getPeak();
 
         return peakLevel;
     }
 
 private:
-    Array<MinMaxValue> data;
+    struct Level
+    {
+        Array<MinMaxValue> minMax;
+        Array<uint8> rms;
+    };
+
+    OwnedArray<Level> levels;
     int peakLevel;
+    const bool storesRMS;
+
+    static inline void addToRange (const MinMaxValue& v, char& mn, char& mx) noexcept
+    {
+        if (v.getMinValue() < mn)  mn = v.getMinValue();
+        if (v.getMaxValue() > mx)  mx = v.getMaxValue();
+    }
 
     void ensureSize (const int thumbSamples)
     {
-        const int extraNeeded = thumbSamples - data.size();
-        if (extraNeeded > 0)
-            data.insertMultiple (-1, MinMaxValue(), extraNeeded);
+        const int oldSize = getSize();
+
+        for (int level = 0, size = thumbSamples;; ++level)
+        {
+            if (level >= levels.size())
+                levels.add (new Level());
+
+            Level& l = *levels.getUnchecked (level);
+            const int extraNeeded = size - l.minMax.size();
+
+            if (extraNeeded > 0)
+            {
+                l.minMax.insertMultiple (-1, MinMaxValue(), extraNeeded);
+
+                if (storesRMS)
+                    l.rms.insertMultiple (-1, 0, extraNeeded);
+            }
+
+            if (l.minMax.size() <= 1)
+                break;
+
+            size = (l.minMax.size() + 1) / 2;
+        }
+
+        // the last value of each level may now be combined with a new neighbour
+        if (oldSize > 0 && thumbSamples > oldSize)
+            updateLevels (oldSize - 1, thumbSamples);
     }
 };
 
@@ -543,13 +698,18 @@ AudioThumbnail::AudioThumbnail (const int originalSamplesPerThumbnailSample,
       totalSamples (0),
       numSamplesFinished (0),
       numChannels (0),
-      sampleRate (0)
+      sampleRate (0),
+      storeRMSLevels (false),
+      scanPriority (0)
 {
 }
 
 AudioThumbnail::~AudioThumbnail()
 {
     clear();
+
+    if (AudioThumbnailBuilder* builder = cache.getBuilder())
+        builder->thumbnailDeleted (*this);
 }
 
 void AudioThumbnail::clear()
@@ -585,7 +745,36 @@ void AudioThumbnail::reset (int newNumChannels, double newSampleRate, int64 tota
 void AudioThumbnail::createChannels (const int length)
 {
     while (channels.size() < numChannels)
-        channels.add (new ThumbData (length));
+        channels.add (new ThumbData (length, storeRMSLevels));
+}
+
+void AudioThumbnail::setStoresRMSLevels (const bool shouldStoreRMSLevels)
+{
+    // This needs to be set before the thumbnail is given any data!
+    jassert (channels.size() == 0);
+
+    storeRMSLevels = shouldStoreRMSLevels;
+}
+
+bool AudioThumbnail::storesRMSLevels() const noexcept
+{
+    return storeRMSLevels;
+}
+
+void AudioThumbnail::setScanPriority (const int newPriority)
+{
+    if (scanPriority != newPriority)
+    {
+        scanPriority = newPriority;
+
+        if (AudioThumbnailBuilder* builder = cache.getBuilder())
+            builder->prioritiesChanged();
+    }
+}
+
+int AudioThumbnail::getScanPriority() const noexcept
+{
+    return scanPriority;
 }
 
 //==============================================================================
@@ -605,7 +794,8 @@ bool AudioThumbnail::loadFrom (InputStream& rawInput)
     int32 numThumbnailSamples = input.readInt();  // Number of samples in the thumbnail data.
     numChannels = input.readInt();                // Number of audio channels.
     sampleRate = input.readInt();                 // Source sample rate.
-    input.skipNextBytes (16);                     // (reserved)
+    const int flags = input.readInt();            // Which of the optional sections follow the data.
+    input.skipNextBytes (12);                     // (reserved)
 
     createChannels (numThumbnailSamples);
 
@@ -613,9 +803,53 @@ bool AudioThumbnail::loadFrom (InputStream& rawInput)
         for (int chan = 0; chan < numChannels; ++chan)
             channels.getUnchecked(chan)->getData(i)->read (input);
 
+    const bool hasRMSLevels = (flags & ThumbData::hasRMSLevelsFlag) != 0;
+
+    if (hasRMSLevels)
+        readRMSLevels (input, 0, numThumbnailSamples);
+
+    if (storeRMSLevels && ! hasRMSLevels)
+        numSamplesFinished = 0; // the levels will have to be re-scanned to measure the RMS
+
+    if (numChannels > 0 && (flags & ThumbData::hasPyramidFlag) != 0)
+    {
+        const ThumbData& first = *channels.getUnchecked (0);
+
+        for (int level = 1; level < first.getNumLevels(); ++level)
+        {
+            const int levelSize = first.getLevelSize (level);
+
+            for (int i = 0; i < levelSize; ++i)
+                for (int chan = 0; chan < numChannels; ++chan)
+                    channels.getUnchecked(chan)->getData (level, i)->read (input);
+
+            if (hasRMSLevels)
+                readRMSLevels (input, level, levelSize);
+        }
+    }
+    else
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+            channels.getUnchecked(chan)->updateLevels (0, numThumbnailSamples);
+    }
+
     return true;
 }
 
+void AudioThumbnail::readRMSLevels (InputStream& input, const int level, const int numValues)
+{
+    for (int i = 0; i < numValues; ++i)
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            const uint8 rms = (uint8) input.readByte();
+
+            if (storeRMSLevels)
+                *channels.getUnchecked(chan)->getRMSData (level, i) = rms;
+        }
+    }
+}
+
 void AudioThumbnail::saveTo (OutputStream& output) const
 {
     const ScopedLock sl (lock);
@@ -629,12 +863,26 @@ void AudioThumbnail::saveTo (OutputStream& output) const
     output.writeInt (numThumbnailSamples);
     output.writeInt (numChannels);
     output.writeInt ((int) sampleRate);
-    output.writeInt64 (0);
+    output.writeInt (ThumbData::hasPyramidFlag | (storeRMSLevels ? ThumbData::hasRMSLevelsFlag : 0));
+    output.writeInt (0);
     output.writeInt64 (0);
 
-    for (int i = 0; i < numThumbnailSamples; ++i)
-        for (int chan = 0; chan < numChannels; ++chan)
-            channels.getUnchecked(chan)->getData(i)->write (output);
+    const int numLevels = channels.size() == 0 ? 0 : channels.getUnchecked(0)->getNumLevels();
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        const int levelSize = channels.getUnchecked(0)->getLevelSize (level);
+
+        // (level 0 comes first, so older versions can still read the data)
+        for (int i = 0; i < levelSize; ++i)
+            for (int chan = 0; chan < numChannels; ++chan)
+                channels.getUnchecked(chan)->getData (level, i)->write (output);
+
+        if (storeRMSLevels)
+            for (int i = 0; i < levelSize; ++i)
+                for (int chan = 0; chan < numChannels; ++chan)
+                    output.writeByte ((char) *channels.getUnchecked(chan)->getRMSData (level, i));
+    }
 }
 
 //==============================================================================
@@ -707,6 +955,14 @@ void AudioThumbnail::addBlock (const int64 startSample, const AudioSampleBuffer&
 
         const HeapBlock<MinMaxValue> thumbData ((size_t) (numToDo * numChans));
         const HeapBlock<MinMaxValue*> thumbChannels ((size_t) numChans);
+        HeapBlock<uint8> rmsData;
+        HeapBlock<uint8*> rmsChannels;
+
+        if (storeRMSLevels)
+        {
+            rmsData.malloc ((size_t) (numToDo * numChans));
+            rmsChannels.malloc ((size_t) numChans);
+        }
 
         for (int chan = 0; chan < numChans; ++chan)
         {
@@ -719,18 +975,31 @@ void AudioThumbnail::addBlock (const int64 startSample, const AudioSampleBuffer&
                 const int start = i * samplesPerThumbSample;
                 dest[i].setFloat (FloatVectorOperations::findMinAndMax (sourceData + start, jmin (samplesPerThumbSample, numSamples - start)));
             }
+
+            if (storeRMSLevels)
+            {
+                uint8* const rmsDest = rmsData + numToDo * chan;
+                rmsChannels [chan] = rmsDest;
+
+                for (int i = 0; i < numToDo; ++i)
+                {
+                    const int start = i * samplesPerThumbSample;
+                    rmsDest[i] = rmsToByte (incoming.getRMSLevel (chan, startOffsetInBuffer + start, jmin (samplesPerThumbSample, numSamples - start)));
+                }
+            }
         }
 
-        setLevels (thumbChannels, firstThumbIndex, numChans, numToDo);
+        setLevels (thumbChannels, rmsChannels, firstThumbIndex, numChans, numToDo);
     }
 }
 
-void AudioThumbnail::setLevels (const MinMaxValue* const* values, int thumbIndex, int numChans, int numValues)
+void AudioThumbnail::setLevels (const MinMaxValue* const* values, const uint8* const* rmsValues,
+                                int thumbIndex, int numChans, int numValues)
 {
     const ScopedLock sl (lock);
 
     for (int i = jmin (numChans, channels.size()); --i >= 0;)
-        channels.getUnchecked(i)->write (values[i], thumbIndex, numValues);
+        channels.getUnchecked(i)->write (values[i], rmsValues != nullptr ? rmsValues[i] : nullptr, thumbIndex, numValues);
 
     const int64 start = thumbIndex * (int64) samplesPerThumbSample;
     const int64 end = (thumbIndex + numValues) * (int64) samplesPerThumbSample;
@@ -740,7 +1009,11 @@ void AudioThumbnail::setLevels (const MinMaxValue* const* values, int thumbIndex
 
     totalSamples = jmax (numSamplesFinished, totalSamples);
     window->invalidate();
-    sendChangeMessage();
+
+    if (AudioThumbnailBuilder* builder = cache.getBuilder())
+        builder->thumbnailChanged (*this);
+    else
+        sendChangeMessage();
 }
 
 //==============================================================================
@@ -799,6 +1072,20 @@ void AudioThumbnail::getApproximateMinMax (const double startTime, const double
     maxValue = result.getMaxValue() / 128.0f;
 }
 
+float AudioThumbnail::getApproximateRMSLevel (const double startTime, const double endTime, const int channelIndex) const noexcept
+{
+    const ScopedLock sl (lock);
+    const ThumbData* const data = channels [channelIndex];
+
+    if (data == nullptr || sampleRate <= 0)
+        return 0.0f;
+
+    const int firstThumbIndex = (int) ((startTime * sampleRate) / samplesPerThumbSample);
+    const int lastThumbIndex  = (int) (((endTime * sampleRate) + samplesPerThumbSample - 1) / samplesPerThumbSample);
+
+    return data->getRMSLevel (jmax (0, firstThumbIndex), lastThumbIndex);
+}
+
 void AudioThumbnail::drawChannel (Graphics& g, const Rectangle<int>& area, double startTime,
                                   double endTime, int channelNum, float verticalZoomFactor)
 {
@@ -820,3 +1107,202 @@ void AudioThumbnail::drawChannels (Graphics& g, const Rectangle<int>& area, doub
                      startTimeSeconds, endTimeSeconds, i, verticalZoomFactor);
     }
 }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioThumbnailTests  : public UnitTest
+{
+public:
+    AudioThumbnailTests() : UnitTest ("AudioThumbnail") {}
+
+    // The saved data starts with a 52-byte header, followed by level 0 of the
+    // pyramid with each thumbnail sample's values interleaved by channel.
+    enum
+    {
+        samplesPerThumbSample = 4,
+        numThumbSamplesOffset = 24,
+        numChannelsOffset = 28,
+        flagsOffset = 36,
+        headerSize = 52
+    };
+
+    // (with a sample rate of 1024, these times map exactly onto thumbnail indexes)
+    static double getTime (int thumbIndex)   { return thumbIndex * samplesPerThumbSample / 1024.0; }
+
+    static void fill (AudioThumbnail& thumbnail, Random& r, int numChannels, int numSamples)
+    {
+        thumbnail.reset (numChannels, 1024.0, numSamples);
+        AudioSampleBuffer buffer (numChannels, numSamples);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            float level = r.nextFloat();
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                if (r.nextInt (200) == 0)
+                    level = r.nextFloat();
+
+                buffer.setSample (chan, i, level * (r.nextFloat() * 2.0f - 1.0f));
+            }
+        }
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int num = jmin (numSamples - start, samplesPerThumbSample * (1 + r.nextInt (300)));
+            thumbnail.addBlock (start, buffer, start, num);
+            start += num;
+        }
+    }
+
+    static MemoryBlock save (const AudioThumbnail& thumbnail)
+    {
+        MemoryOutputStream out;
+        thumbnail.saveTo (out);
+        return out.getMemoryBlock();
+    }
+
+    static int readInt (const MemoryBlock& data, int offset)
+    {
+        return (int) ByteOrder::littleEndianInt (static_cast<const char*> (data.getData()) + offset);
+    }
+
+    void checkMinMaxAgainstLinearScan (Random& r)
+    {
+        AudioFormatManager formatManager;
+        AudioThumbnailCache cache (1);
+        AudioThumbnail thumbnail (samplesPerThumbSample, formatManager, cache);
+        fill (thumbnail, r, 2, 10000 + r.nextInt (30000));
+
+        const MemoryBlock data (save (thumbnail));
+        const int numThumbSamples = readInt (data, numThumbSamplesOffset);
+        const int numChannels = readInt (data, numChannelsOffset);
+        const int8* const level0 = reinterpret_cast<const int8*> (data.getData()) + headerSize;
+
+        for (int i = 0; i < 500; ++i)
+        {
+            const int chan = r.nextInt (numChannels);
+            const int start = r.nextInt (numThumbSamples);
+            const int end = jmin (numThumbSamples - 1, start + r.nextInt (r.nextBool() ? 16 : numThumbSamples));
+
+            int expectedMin = 127, expectedMax = -128;
+
+            for (int j = start; j <= end; ++j)
+            {
+                expectedMin = jmin (expectedMin, (int) level0[2 * (j * numChannels + chan)]);
+                expectedMax = jmax (expectedMax, (int) level0[2 * (j * numChannels + chan) + 1]);
+            }
+
+            float minValue, maxValue;
+            thumbnail.getApproximateMinMax (getTime (start), getTime (end), chan, minValue, maxValue);
+
+            expectEquals (minValue, expectedMin / 128.0f);
+            expectEquals (maxValue, expectedMax / 128.0f);
+        }
+    }
+
+    void checkRoundTrip (Random& r, bool saveRMSLevels, bool loadRMSLevels)
+    {
+        AudioFormatManager formatManager;
+        AudioThumbnailCache cache (1);
+        AudioThumbnail original (samplesPerThumbSample, formatManager, cache);
+        AudioThumbnail loaded (samplesPerThumbSample, formatManager, cache);
+        original.setStoresRMSLevels (saveRMSLevels);
+        loaded.setStoresRMSLevels (loadRMSLevels);
+
+        const int numSamples = 5000 + r.nextInt (20000);
+        fill (original, r, 2, numSamples);
+
+        const MemoryBlock data (save (original));
+        MemoryInputStream input (data, false);
+        expect (loaded.loadFrom (input));
+
+        expectEquals (loaded.getNumChannels(), original.getNumChannels());
+        expectEquals (loaded.getTotalLength(), original.getTotalLength());
+
+        // without any stored RMS levels, a thumbnail that needs them has to be re-scanned
+        expect (loaded.isFullyLoaded() == (saveRMSLevels || ! loadRMSLevels));
+
+        if (saveRMSLevels == loadRMSLevels)
+            expect (save (loaded) == data);
+
+        if (saveRMSLevels)
+            expect (original.getApproximateRMSLevel (0, original.getTotalLength(), 0) > 0);
+
+        const int numThumbSamples = numSamples / samplesPerThumbSample;
+
+        for (int i = 0; i < 100; ++i)
+        {
+            const int chan = r.nextInt (2);
+            const int start = r.nextInt (numThumbSamples);
+            const int end = start + r.nextInt (numThumbSamples - start);
+
+            float originalMin, originalMax, loadedMin, loadedMax;
+            original.getApproximateMinMax (getTime (start), getTime (end), chan, originalMin, originalMax);
+            loaded.getApproximateMinMax (getTime (start), getTime (end), chan, loadedMin, loadedMax);
+
+            expectEquals (loadedMin, originalMin);
+            expectEquals (loadedMax, originalMax);
+
+            if (saveRMSLevels && loadRMSLevels)
+                expectEquals (loaded.getApproximateRMSLevel (getTime (start), getTime (end), chan),
+                              original.getApproximateRMSLevel (getTime (start), getTime (end), chan));
+        }
+    }
+
+    void checkOldFormat (Random& r)
+    {
+        AudioFormatManager formatManager;
+        AudioThumbnailCache cache (1);
+        AudioThumbnail original (samplesPerThumbSample, formatManager, cache);
+        fill (original, r, 2, 5000 + r.nextInt (20000));
+
+        // Older versions only wrote level 0, and left the flags word as zero
+        const MemoryBlock data (save (original));
+        const size_t oldSize = (size_t) (headerSize + 2 * readInt (data, numThumbSamplesOffset) * readInt (data, numChannelsOffset));
+        MemoryBlock oldData (data.getData(), oldSize);
+        zeromem (static_cast<char*> (oldData.getData()) + flagsOffset, 4);
+
+        {
+            AudioThumbnail loaded (samplesPerThumbSample, formatManager, cache);
+            MemoryInputStream input (oldData, false);
+            expect (loaded.loadFrom (input));
+            expect (loaded.isFullyLoaded());
+
+            // the pyramid gets rebuilt from level 0, so it should come out the same as before
+            expect (save (loaded) == data);
+        }
+
+        {
+            AudioThumbnail loaded (samplesPerThumbSample, formatManager, cache);
+            loaded.setStoresRMSLevels (true);
+            MemoryInputStream input (oldData, false);
+            expect (loaded.loadFrom (input));
+            expect (! loaded.isFullyLoaded());
+        }
+    }
+
+    void runTest() override
+    {
+        Random r (getRandom());
+
+        beginTest ("Pyramid min/max against a linear scan");
+
+        for (int i = 0; i < 5; ++i)
+            checkMinMaxAgainstLinearScan (r);
+
+        beginTest ("Save and load");
+        checkRoundTrip (r, false, false);
+        checkRoundTrip (r, true, true);
+        checkRoundTrip (r, true, false);
+        checkRoundTrip (r, false, true);
+
+        beginTest ("Loading the old format");
+        checkOldFormat (r);
+    }
+};
+
+static AudioThumbnailTests audioThumbnailUnitTests;
+
+#endif
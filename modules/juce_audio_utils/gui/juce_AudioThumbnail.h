@@ -41,7 +41,9 @@
     listeners should repaint themselves.
 
     The thumbnail stores an internal low-res version of the wave data, and this can
-    be loaded and saved to avoid having to scan the file again.
+    be loaded and saved to avoid having to scan the file again. This is kept as a
+    pyramid of successively halved resolutions, so drawing or measuring any length
+    of the waveform only has to look at a few values for each pixel.
 
     @see AudioThumbnailCache, AudioThumbnailBase
 */
@@ -188,6 +190,43 @@ public:
     /** Returns the hash code that was set by setSource() or setReader(). */
     int64 getHashCode() const override;
 
+    //==============================================================================
+    /** Tells the thumbnail whether to measure and store the RMS level of the audio as
+        well as its peaks.
+
+        This must be called before the thumbnail is given a source or reset, and it makes
+        scanning a file slower, because the samples have to be read rather than just their
+        levels.
+        @see getApproximateRMSLevel
+    */
+    void setStoresRMSLevels (bool shouldStoreRMSLevels);
+
+    /** Returns true if the thumbnail is storing RMS levels.
+        @see setStoresRMSLevels
+    */
+    bool storesRMSLevels() const noexcept;
+
+    /** Returns the approximate RMS level of a section of one of the channels.
+        This will be 0 unless setStoresRMSLevels() has been used to enable RMS levels.
+    */
+    float getApproximateRMSLevel (double startTime, double endTime, int channelIndex) const noexcept;
+
+    //==============================================================================
+    /** Sets the priority with which this thumbnail's source is scanned.
+
+        This only has an effect when the cache has been created with some scanning
+        threads: the thumbnails with higher priorities are scanned before those with
+        lower ones, so you might want to raise it for thumbnails that are on-screen.
+        The default is 0.
+        @see AudioThumbnailBuilder
+    */
+    void setScanPriority (int newPriority);
+
+    /** Returns the thumbnail's scan priority.
+        @see setScanPriority
+    */
+    int getScanPriority() const noexcept;
+
 private:
     //==============================================================================
     AudioFormatManager& formatManagerToUse;
@@ -213,12 +252,16 @@ private:
     int64 totalSamples, numSamplesFinished;
     int32 numChannels;
     double sampleRate;
+    bool storeRMSLevels;
+    int scanPriority;
     CriticalSection lock;
 
     void clearChannelData();
     bool setDataSource (LevelDataSource* newSource);
-    void setLevels (const MinMaxValue* const* values, int thumbIndex, int numChans, int numValues);
+    void setLevels (const MinMaxValue* const* values, const uint8* const* rmsValues,
+                    int thumbIndex, int numChans, int numValues);
     void createChannels (int length);
+    void readRMSLevels (InputStream&, int level, int numValues);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnail)
 };
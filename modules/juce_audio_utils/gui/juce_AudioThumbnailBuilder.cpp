@@ -0,0 +1,425 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+struct AudioThumbnailBuilder::Client
+{
+    Client (TimeSliceClient& c, AudioThumbnail& t) noexcept
+        : client (c), thumbnail (t), nextCallTime (Time::getMillisecondCounter()),
+          isRunning (false), isFinished (false), isBeingRemoved (false)
+    {
+    }
+
+    TimeSliceClient& client;
+    AudioThumbnail& thumbnail;
+    uint32 nextCallTime;
+    bool isRunning, isFinished, isBeingRemoved;
+
+    JUCE_DECLARE_NON_COPYABLE (Client)
+};
+
+//==============================================================================
+class AudioThumbnailBuilder::Worker  : public Thread
+{
+public:
+    Worker (AudioThumbnailBuilder& b, int index)
+        : Thread ("thumbnail builder " + String (index)), owner (b)
+    {
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            int timeToWait = 500;
+
+            if (Client* c = owner.getNextClient (timeToWait))
+                owner.runClient (*c);
+            else
+                wait (timeToWait);
+        }
+    }
+
+private:
+    AudioThumbnailBuilder& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+AudioThumbnailBuilder::AudioThumbnailBuilder (const int numThreads)
+    : clientFinishedRunning (false), notificationInterval (100)
+{
+    jassert (numThreads > 0);
+
+    for (int i = 0; i < numThreads; ++i)
+        workers.add (new Worker (*this, i + 1))->startThread (2);
+
+    startTimer (notificationInterval);
+}
+
+AudioThumbnailBuilder::~AudioThumbnailBuilder()
+{
+    stopTimer();
+
+    for (int i = workers.size(); --i >= 0;)
+        workers.getUnchecked(i)->signalThreadShouldExit();
+
+    wakeWorkers();
+
+    for (int i = workers.size(); --i >= 0;)
+        workers.getUnchecked(i)->stopThread (4000);
+}
+
+int AudioThumbnailBuilder::getNumThreads() const noexcept
+{
+    return workers.size();
+}
+
+int AudioThumbnailBuilder::getNumThumbnailsPending() const
+{
+    const ScopedLock sl (lock);
+    int num = 0;
+
+    for (int i = clients.size(); --i >= 0;)
+    {
+        const Client& c = *clients.getUnchecked(i);
+
+        if (! (c.isFinished || c.isBeingRemoved || c.thumbnail.isFullyLoaded()))
+            ++num;
+    }
+
+    return num;
+}
+
+//==============================================================================
+void AudioThumbnailBuilder::addClient (TimeSliceClient& client, AudioThumbnail& thumbnail)
+{
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = clients.size(); --i >= 0;)
+        {
+            Client& c = *clients.getUnchecked(i);
+
+            if (&c.client == &client && ! c.isBeingRemoved)
+            {
+                c.isFinished = false;
+                c.nextCallTime = Time::getMillisecondCounter();
+                wakeWorkers();
+                return;
+            }
+        }
+
+        clients.add (new Client (client, thumbnail));
+    }
+
+    wakeWorkers();
+}
+
+void AudioThumbnailBuilder::removeClient (TimeSliceClient& client)
+{
+    for (;;)
+    {
+        {
+            const ScopedLock sl (lock);
+            Client* c = nullptr;
+
+            for (int i = clients.size(); --i >= 0;)
+                if (&clients.getUnchecked(i)->client == &client)
+                    c = clients.getUnchecked(i);
+
+            if (c == nullptr)
+                return;
+
+            if (! c->isRunning)
+            {
+                clients.removeObject (c);
+                continue;
+            }
+
+            // it's being used by one of the workers, so wait for it to finish..
+            c->isBeingRemoved = true;
+        }
+
+        clientFinishedRunning.wait (5);
+    }
+}
+
+void AudioThumbnailBuilder::cancel (AudioThumbnail& thumbnail)
+{
+    Array<TimeSliceClient*> toRemove;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = clients.size(); --i >= 0;)
+            if (&clients.getUnchecked(i)->thumbnail == &thumbnail)
+                toRemove.add (&clients.getUnchecked(i)->client);
+    }
+
+    for (int i = toRemove.size(); --i >= 0;)
+        removeClient (*toRemove.getUnchecked(i));
+}
+
+void AudioThumbnailBuilder::cancelAll()
+{
+    Array<TimeSliceClient*> toRemove;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (int i = clients.size(); --i >= 0;)
+            toRemove.add (&clients.getUnchecked(i)->client);
+    }
+
+    for (int i = toRemove.size(); --i >= 0;)
+        removeClient (*toRemove.getUnchecked(i));
+}
+
+void AudioThumbnailBuilder::prioritiesChanged()
+{
+    wakeWorkers();
+}
+
+void AudioThumbnailBuilder::wakeWorkers()
+{
+    for (int i = workers.size(); --i >= 0;)
+        workers.getUnchecked(i)->notify();
+}
+
+//==============================================================================
+AudioThumbnailBuilder::Client* AudioThumbnailBuilder::getNextClient (int& millisecondsToWait)
+{
+    const ScopedLock sl (lock);
+
+    const uint32 now = Time::getMillisecondCounter();
+    Client* best = nullptr;
+    int bestPriority = 0;
+
+    // Of the clients with the same priority, the oldest is picked, so that each thread
+    // finishes a file before moving on to the next one.
+    for (int i = 0; i < clients.size(); ++i)
+    {
+        Client* const c = clients.getUnchecked(i);
+
+        if (c->isRunning || c->isBeingRemoved)
+            continue;
+
+        if (c->isFinished)
+        {
+            clients.remove (i--);
+            continue;
+        }
+
+        const int timeUntilDue = (int) (c->nextCallTime - now);
+
+        if (timeUntilDue > 0)
+        {
+            millisecondsToWait = jmin (millisecondsToWait, timeUntilDue);
+            continue;
+        }
+
+        const int priority = c->thumbnail.getScanPriority();
+
+        if (best == nullptr || priority > bestPriority)
+        {
+            best = c;
+            bestPriority = priority;
+        }
+    }
+
+    if (best != nullptr)
+        best->isRunning = true;
+
+    return best;
+}
+
+void AudioThumbnailBuilder::runClient (Client& c)
+{
+    const int timeUntilNextCall = c.client.useTimeSlice();
+
+    {
+        const ScopedLock sl (lock);
+
+        c.isRunning = false;
+
+        if (timeUntilNextCall < 0)
+            c.isFinished = true;
+        else
+            c.nextCallTime = Time::getMillisecondCounter() + (uint32) timeUntilNextCall;
+    }
+
+    clientFinishedRunning.signal();
+}
+
+//==============================================================================
+void AudioThumbnailBuilder::thumbnailChanged (AudioThumbnail& thumbnail)
+{
+    const ScopedLock sl (lock);
+    changedThumbnails.addIfNotAlreadyThere (&thumbnail);
+}
+
+void AudioThumbnailBuilder::thumbnailDeleted (AudioThumbnail& thumbnail)
+{
+    const ScopedLock sl (lock);
+    changedThumbnails.removeFirstMatchingValue (&thumbnail);
+    thumbnailsBeingNotified.removeFirstMatchingValue (&thumbnail);
+    notifiedThumbnails.removeFirstMatchingValue (&thumbnail);
+}
+
+void AudioThumbnailBuilder::setNotificationInterval (const int milliseconds)
+{
+    jassert (milliseconds > 0);
+
+    notificationInterval = milliseconds;
+    startTimer (milliseconds);
+}
+
+void AudioThumbnailBuilder::timerCallback()
+{
+    {
+        const ScopedLock sl (lock);
+
+        if (changedThumbnails.size() == 0)
+            return;
+
+        notifiedThumbnails.clear();
+        changedThumbnails.swapWith (notifiedThumbnails);
+        thumbnailsBeingNotified = notifiedThumbnails;
+    }
+
+    // (a callback might delete any of the other thumbnails in the batch, in which case
+    // thumbnailDeleted() takes it out of both of these lists)
+    for (;;)
+    {
+        AudioThumbnail* thumbnail;
+
+        {
+            const ScopedLock sl (lock);
+
+            if (thumbnailsBeingNotified.size() == 0)
+                break;
+
+            thumbnail = thumbnailsBeingNotified.remove (0);
+        }
+
+        thumbnail->sendSynchronousChangeMessage();
+    }
+
+    listeners.call (&Listener::thumbnailsChanged, *this, notifiedThumbnails);
+
+    const ScopedLock sl (lock);
+    notifiedThumbnails.clear();
+}
+
+void AudioThumbnailBuilder::addListener (Listener* const listener)     { listeners.add (listener); }
+void AudioThumbnailBuilder::removeListener (Listener* const listener)  { listeners.remove (listener); }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioThumbnailBuilderTests  : public UnitTest
+{
+public:
+    AudioThumbnailBuilderTests() : UnitTest ("AudioThumbnailBuilder") {}
+
+    // When the first change message arrives, this deletes all the other thumbnails.
+    struct Deleter  : public ChangeListener
+    {
+        Deleter (OwnedArray<AudioThumbnail>& t) : thumbnails (t) {}
+
+        void changeListenerCallback (ChangeBroadcaster* source) override
+        {
+            for (int i = thumbnails.size(); --i >= 0;)
+                if (thumbnails.getUnchecked(i) != source)
+                    thumbnails.remove (i);
+        }
+
+        OwnedArray<AudioThumbnail>& thumbnails;
+    };
+
+    struct Collector  : public AudioThumbnailBuilder::Listener
+    {
+        Collector() : numCallbacks (0) {}
+
+        void thumbnailsChanged (AudioThumbnailBuilder&, const Array<AudioThumbnail*>& changed) override
+        {
+            thumbnails = changed;
+            ++numCallbacks;
+        }
+
+        Array<AudioThumbnail*> thumbnails;
+        int numCallbacks;
+    };
+
+    void runTest() override
+    {
+        beginTest ("Deleting a thumbnail from a change callback");
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        if (! MessageManager::getInstance()->isThisTheMessageThread())
+        {
+            logMessage ("Skipped, because the notifications need the message loop to run");
+            return;
+        }
+
+        AudioFormatManager formatManager;
+        AudioThumbnailCache cache (10, 1);
+        AudioThumbnailBuilder& builder = *cache.getBuilder();
+        builder.setNotificationInterval (10);
+
+        Collector collector;
+        builder.addListener (&collector);
+
+        OwnedArray<AudioThumbnail> thumbnails;
+        Deleter deleter (thumbnails);
+
+        AudioSampleBuffer block (1, 1024);
+        block.clear();
+        block.setSample (0, 100, 0.5f);
+
+        for (int i = 0; i < 3; ++i)
+        {
+            AudioThumbnail* const thumbnail = thumbnails.add (new AudioThumbnail (256, formatManager, cache));
+            thumbnail->reset (1, 44100.0, block.getNumSamples());
+            thumbnail->addChangeListener (&deleter);
+            thumbnail->addBlock (0, block, 0, block.getNumSamples());
+        }
+
+        for (int i = 0; i < 100 && collector.numCallbacks == 0; ++i)
+            MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+        expectEquals (collector.numCallbacks, 1);
+        expectEquals (thumbnails.size(), 1);
+        expect (collector.thumbnails.size() == 1 && collector.thumbnails.getFirst() == thumbnails.getFirst());
+
+        builder.removeListener (&collector);
+       #endif
+    }
+};
+
+static AudioThumbnailBuilderTests audioThumbnailBuilderUnitTests;
+
+#endif
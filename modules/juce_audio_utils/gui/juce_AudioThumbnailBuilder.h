@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef JUCE_AUDIOTHUMBNAILBUILDER_H_INCLUDED
+#define JUCE_AUDIOTHUMBNAILBUILDER_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Scans the sources of many AudioThumbnails at once, using a set of threads.
+
+    An AudioThumbnailCache that's created with some scanning threads owns one of these,
+    and all the thumbnails that use the cache will have their sources scanned by it
+    rather than by the cache's TimeSliceThread. Each thread works on whichever waiting
+    thumbnail has the highest scan priority, so you can make the ones that are on-screen
+    appear first, e.g.
+    @code
+    AudioThumbnailCache cache (500, SystemStats::getNumCpus());
+
+    void ClipComponent::visibilityChanged()
+    {
+        thumbnail.setScanPriority (isShowing() ? 1 : 0);
+    }
+    @endcode
+
+    While the builder is in use, the thumbnails don't send a change message for every
+    block of data that they receive. Instead, the builder collects the thumbnails that
+    have changed and sends all their change messages together at regular intervals,
+    followed by a callback to its listeners.
+
+    @see AudioThumbnailCache, AudioThumbnail::setScanPriority
+*/
+class JUCE_API  AudioThumbnailBuilder  : private Timer
+{
+public:
+    //==============================================================================
+    /** Destructor. */
+    ~AudioThumbnailBuilder();
+
+    //==============================================================================
+    /** Returns the number of threads that are used to scan the thumbnails. */
+    int getNumThreads() const noexcept;
+
+    /** Returns the number of thumbnails that are currently waiting to be scanned, or
+        are being scanned.
+    */
+    int getNumThumbnailsPending() const;
+
+    /** Stops scanning the source of a thumbnail.
+        Any data that has already been loaded is kept. If the thumbnail is being scanned
+        at the moment, this will wait until the current block has been finished.
+    */
+    void cancel (AudioThumbnail& thumbnail);
+
+    /** Stops scanning all thumbnails.
+        @see cancel
+    */
+    void cancelAll();
+
+    //==============================================================================
+    /** Sets how often the thumbnails' change messages are sent while they're being
+        scanned. The default is 100 milliseconds.
+    */
+    void setNotificationInterval (int milliseconds);
+
+    /** Receives callbacks when some thumbnails have been given new data. */
+    class JUCE_API  Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called on the message thread with all the thumbnails that have changed since
+            the last callback. This happens after their change messages have been sent.
+            Any of these thumbnails that get deleted before or during the callback are
+            removed from the array.
+        */
+        virtual void thumbnailsChanged (AudioThumbnailBuilder&, const Array<AudioThumbnail*>& thumbnails) = 0;
+    };
+
+    /** Registers a listener to receive callbacks. */
+    void addListener (Listener* listener);
+
+    /** Removes a previously-registered listener. */
+    void removeListener (Listener* listener);
+
+private:
+    //==============================================================================
+    friend class AudioThumbnailCache;
+    friend class AudioThumbnail;
+    friend struct ContainerDeletePolicy<AudioThumbnailBuilder>;
+
+    class Worker;
+    struct Client;
+    friend class Worker;
+    friend struct ContainerDeletePolicy<Worker>;
+    friend struct ContainerDeletePolicy<Client>;
+
+    OwnedArray<Worker> workers;
+    OwnedArray<Client> clients;
+    CriticalSection lock;
+    WaitableEvent clientFinishedRunning;
+    Array<AudioThumbnail*> changedThumbnails, thumbnailsBeingNotified, notifiedThumbnails;
+    ListenerList<Listener> listeners;
+    int notificationInterval;
+
+    AudioThumbnailBuilder (int numThreads);
+
+    void addClient (TimeSliceClient&, AudioThumbnail&);
+    void removeClient (TimeSliceClient&);
+    void prioritiesChanged();
+    void thumbnailChanged (AudioThumbnail&);
+    void thumbnailDeleted (AudioThumbnail&);
+
+    Client* getNextClient (int& millisecondsToWait);
+    void runClient (Client&);
+    void wakeWorkers();
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnailBuilder)
+};
+
+
+#endif   // JUCE_AUDIOTHUMBNAILBUILDER_H_INCLUDED
@@ -63,6 +63,17 @@ AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbs)
     thread.startThread (2);
 }
 
+AudioThumbnailCache::AudioThumbnailCache (const int maxNumThumbs, const int numScanningThreads)
+    : thread ("thumb cache"),
+      maxNumThumbsToStore (maxNumThumbs)
+{
+    jassert (maxNumThumbsToStore > 0);
+    thread.startThread (2);
+
+    if (numScanningThreads > 0)
+        builder = new AudioThumbnailBuilder (numScanningThreads);
+}
+
 AudioThumbnailCache::~AudioThumbnailCache()
 {
 }
@@ -32,9 +32,10 @@
 
     The cache runs a single background thread that is shared by all the thumbnails
     that need it, and it maintains a set of low-res previews in memory, to avoid
-    having to re-scan audio files too often.
+    having to re-scan audio files too often. If you have a lot of files to scan, you
+    can give the cache some extra threads to scan them in parallel.
 
-    @see AudioThumbnail
+    @see AudioThumbnail, AudioThumbnailBuilder
 */
 class JUCE_API  AudioThumbnailCache
 {
@@ -47,6 +48,18 @@ public:
     */
     explicit AudioThumbnailCache (int maxNumThumbsToStore);
 
+    /** Creates a cache object that uses several threads to scan its thumbnails.
+
+        The maxNumThumbsToStore parameter lets you specify how many previews should
+        be kept in memory at once, and numScanningThreads is the number of threads
+        that the cache's AudioThumbnailBuilder will use. If numScanningThreads is 0,
+        this is the same as the other constructor.
+
+        All the thumbnails that use the cache must be deleted before it is.
+        @see getBuilder
+    */
+    AudioThumbnailCache (int maxNumThumbsToStore, int numScanningThreads);
+
     /** Destructor. */
     virtual ~AudioThumbnailCache();
 
@@ -87,6 +100,11 @@ public:
     /** Returns the thread that client thumbnails can use. */
     TimeSliceThread& getTimeSliceThread() noexcept      { return thread; }
 
+    /** Returns the builder that scans this cache's thumbnails, or nullptr if the cache
+        was created without any scanning threads.
+    */
+    AudioThumbnailBuilder* getBuilder() const noexcept  { return builder; }
+
 protected:
     /** This can be overridden to provide a custom callback for saving thumbnails
         once they have finished being loaded.
@@ -101,6 +119,7 @@ protected:
 private:
     //==============================================================================
     TimeSliceThread thread;
+    ScopedPointer<AudioThumbnailBuilder> builder;
 
     class ThumbnailCacheEntry;
     friend struct ContainerDeletePolicy<ThumbnailCacheEntry>;
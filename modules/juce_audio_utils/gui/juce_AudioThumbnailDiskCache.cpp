@@ -0,0 +1,532 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+namespace AudioThumbnailDiskCacheFormat
+{
+    /*  The file starts with a header:
+            magic number (4 bytes), version (4 bytes), file ID (8 bytes)
+
+        ..followed by any number of records:
+            magic number (4 bytes), data size (4 bytes), source hash code (8 bytes),
+            last-used time (8 bytes), checksum of the data (4 bytes), reserved (4 bytes),
+            then the thumbnail data.
+
+        Records are only ever appended to a file, and the only part of one that changes
+        afterwards is its last-used time, which is updated whenever it's loaded. When the
+        file gets rewritten, the new one is given a new ID, so that any other processes
+        that are using it can tell that the records they know about have moved.
+    */
+    enum
+    {
+        fileHeaderSize = 16,
+        recordHeaderSize = 32,
+        recordLastUsedOffset = 16,
+        currentVersion = 1
+    };
+
+    static inline uint32 getFileMagic() noexcept      { return ByteOrder::littleEndianInt ("ThDC"); }
+    static inline uint32 getRecordMagic() noexcept    { return ByteOrder::littleEndianInt ("ThRc"); }
+
+    static uint32 calculateChecksum (const uint8* data, size_t numBytes) noexcept
+    {
+        uint32 n = 2166136261u;
+
+        while (numBytes-- > 0)
+            n = (n ^ *data++) * 16777619u;
+
+        return n;
+    }
+
+    static void writeRecord (OutputStream& out, int64 hash, int64 lastUsed, const void* data, size_t numBytes)
+    {
+        out.writeInt ((int) getRecordMagic());
+        out.writeInt ((int) numBytes);
+        out.writeInt64 (hash);
+        out.writeInt64 (lastUsed);
+        out.writeInt ((int) calculateChecksum (static_cast<const uint8*> (data), numBytes));
+        out.writeInt (0);
+        out.write (data, numBytes);
+    }
+}
+
+//==============================================================================
+struct AudioThumbnailDiskCache::EntryComparator
+{
+    static int compareElements (const Entry& first, const Entry& second) noexcept
+    {
+        return first.lastUsed > second.lastUsed ? -1 : (first.lastUsed < second.lastUsed ? 1 : 0);
+    }
+};
+
+//==============================================================================
+AudioThumbnailDiskCache::AudioThumbnailDiskCache (const File& cacheFile, const int64 maxBytes,
+                                                  const int maxNumThumbsInMemory, const int numScanningThreads)
+    : AudioThumbnailCache (maxNumThumbsInMemory, numScanningThreads),
+      file (cacheFile),
+      maxBytesOnDisk (maxBytes),
+      fileLock ("juce_thumbs_" + String::toHexString (cacheFile.getFullPathName().hashCode64())),
+      fileID (0),
+      scannedEnd (0),
+      hasUnreadableData (false)
+{
+    jassert (maxBytesOnDisk > 0);
+
+    const ScopedLock sl (lock);
+    update();
+}
+
+AudioThumbnailDiskCache::~AudioThumbnailDiskCache()
+{
+}
+
+int AudioThumbnailDiskCache::getNumThumbnailsOnDisk()
+{
+    const ScopedLock sl (lock);
+    update();
+    return entries.size();
+}
+
+//==============================================================================
+bool AudioThumbnailDiskCache::loadNewThumb (AudioThumbnailBase& thumb, const int64 hashCode)
+{
+    const ScopedLock sl (lock);
+
+    if (! entryIndexes.contains (hashCode))
+    {
+        update(); // (another process may have added it)
+
+        if (! entryIndexes.contains (hashCode))
+            return false;
+    }
+
+    const Entry& e = entries.getReference (entryIndexes [hashCode]);
+
+    if (! isRecordValid (e))
+        return false;
+
+    MemoryInputStream in (getRecord (e) + AudioThumbnailDiskCacheFormat::recordHeaderSize, (size_t) e.dataSize, false);
+
+    if (! thumb.loadFrom (in))
+        return false;
+
+    markAsUsed (hashCode);
+    return true;
+}
+
+void AudioThumbnailDiskCache::saveNewlyFinishedThumbnail (const AudioThumbnailBase& thumb, const int64 hashCode)
+{
+    MemoryOutputStream data;
+    thumb.saveTo (data);
+
+    const ScopedLock sl (lock);
+    const InterProcessLock::ScopedLockType ipl (fileLock);
+
+    if (! ipl.isLocked())
+        return;
+
+    update();
+
+    // Now that nobody else can be writing to the file, anything at the end that can't be
+    // read must have been left by a process that crashed, so the file has to be rewritten
+    // before anything can be appended to it. If that fails, a new record would end up
+    // after the unreadable data where nobody could find it, so it's not worth writing.
+    if ((fileID == 0 || hasUnreadableData) && ! rewrite (std::numeric_limits<int64>::max()))
+        return;
+
+    {
+        FileOutputStream out (file);
+
+        if (out.failedToOpen())
+            return;
+
+        AudioThumbnailDiskCacheFormat::writeRecord (out, hashCode, Time::currentTimeMillis(),
+                                                    data.getData(), data.getDataSize());
+        out.flush();
+    }
+
+    update();
+
+    if (file.getSize() > maxBytesOnDisk)
+        rewrite (maxBytesOnDisk - maxBytesOnDisk / 4);
+}
+
+void AudioThumbnailDiskCache::compact()
+{
+    const ScopedLock sl (lock);
+    const InterProcessLock::ScopedLockType ipl (fileLock);
+
+    if (ipl.isLocked())
+    {
+        update();
+        rewrite (maxBytesOnDisk);
+    }
+}
+
+//==============================================================================
+void AudioThumbnailDiskCache::clearEntries (const int64 newFileID)
+{
+    entries.clearQuick();
+    entryIndexes.clear();
+    fileID = newFileID;
+    scannedEnd = AudioThumbnailDiskCacheFormat::fileHeaderSize;
+}
+
+void AudioThumbnailDiskCache::update()
+{
+    using namespace AudioThumbnailDiskCacheFormat;
+
+    // The old mapping stays valid even if the file has been replaced, so nothing that
+    // the entries point to needs to be read after this.
+    mappedFile = nullptr;
+    hasUnreadableData = false;
+
+    if (file.getSize() < fileHeaderSize)
+    {
+        clearEntries (0);
+        hasUnreadableData = file.exists();
+        return;
+    }
+
+    mappedFile = new MemoryMappedFile (file, MemoryMappedFile::readOnly);
+
+    const uint8* const data = static_cast<const uint8*> (mappedFile->getData());
+    const int64 size = (int64) mappedFile->getSize();
+
+    if (data == nullptr || size < fileHeaderSize
+         || ByteOrder::littleEndianInt (data) != getFileMagic()
+         || ByteOrder::littleEndianInt (data + 4) != (uint32) currentVersion)
+    {
+        mappedFile = nullptr;
+        clearEntries (0);
+        hasUnreadableData = data != nullptr;
+        return;
+    }
+
+    const int64 id = (int64) ByteOrder::littleEndianInt64 (data + 8);
+
+    if (id != fileID || size < scannedEnd)
+        clearEntries (id);
+
+    while (scannedEnd + recordHeaderSize <= size)
+    {
+        const uint8* const header = data + scannedEnd;
+
+        if (ByteOrder::littleEndianInt (header) != getRecordMagic())
+            break;
+
+        const int dataSize = (int) ByteOrder::littleEndianInt (header + 4);
+
+        if (dataSize < 0 || scannedEnd + recordHeaderSize + dataSize > size)
+            break;
+
+        Entry e;
+        e.hash        = (int64) ByteOrder::littleEndianInt64 (header + 8);
+        e.lastUsed    = (int64) ByteOrder::littleEndianInt64 (header + recordLastUsedOffset);
+        e.recordStart = scannedEnd;
+        e.dataSize    = dataSize;
+
+        // a later record for the same source replaces an earlier one
+        if (entryIndexes.contains (e.hash))
+        {
+            entries.set (entryIndexes [e.hash], e);
+        }
+        else
+        {
+            entryIndexes.set (e.hash, entries.size());
+            entries.add (e);
+        }
+
+        scannedEnd += recordHeaderSize + dataSize;
+    }
+
+    hasUnreadableData = scannedEnd < size;
+}
+
+const uint8* AudioThumbnailDiskCache::getRecord (const Entry& e) const noexcept
+{
+    jassert (mappedFile != nullptr && e.recordStart + AudioThumbnailDiskCacheFormat::recordHeaderSize + e.dataSize <= (int64) mappedFile->getSize());
+    return static_cast<const uint8*> (mappedFile->getData()) + e.recordStart;
+}
+
+bool AudioThumbnailDiskCache::isRecordValid (const Entry& e) const noexcept
+{
+    using namespace AudioThumbnailDiskCacheFormat;
+
+    if (mappedFile == nullptr || mappedFile->getData() == nullptr
+         || e.recordStart + recordHeaderSize + e.dataSize > (int64) mappedFile->getSize())
+        return false;
+
+    const uint8* const record = getRecord (e);
+
+    return ByteOrder::littleEndianInt (record + 24)
+             == calculateChecksum (record + recordHeaderSize, (size_t) e.dataSize);
+}
+
+void AudioThumbnailDiskCache::markAsUsed (const int64 hashCode)
+{
+    // The time is written to the file rather than just kept here, so that the least
+    // recently used thumbnails can be found by whichever process rewrites the file.
+    const InterProcessLock::ScopedLockType ipl (fileLock);
+
+    if (! ipl.isLocked())
+        return;
+
+    update(); // (the record may have been moved by another process since it was found)
+
+    if (! entryIndexes.contains (hashCode))
+        return;
+
+    Entry& e = entries.getReference (entryIndexes [hashCode]);
+    e.lastUsed = Time::currentTimeMillis();
+
+    FileOutputStream out (file);
+
+    if (! out.failedToOpen() && out.setPosition (e.recordStart + AudioThumbnailDiskCacheFormat::recordLastUsedOffset))
+    {
+        out.writeInt64 (e.lastUsed);
+        out.flush();
+    }
+}
+
+bool AudioThumbnailDiskCache::rewrite (const int64 maxSize)
+{
+    using namespace AudioThumbnailDiskCacheFormat;
+
+    // (this must only be called with the inter-process lock held)
+    EntryComparator comparator;
+    Array<Entry> entriesToKeep (entries);
+    entriesToKeep.sort (comparator, true);
+
+    TemporaryFile temp (file);
+
+    {
+        FileOutputStream out (temp.getFile());
+
+        if (out.failedToOpen())
+            return false;
+
+        out.writeInt ((int) getFileMagic());
+        out.writeInt ((int) currentVersion);
+        out.writeInt64 (Random::getSystemRandom().nextInt64());
+
+        int64 totalSize = fileHeaderSize;
+
+        for (int i = 0; i < entriesToKeep.size(); ++i)
+        {
+            const Entry& e = entriesToKeep.getReference (i);
+            const int64 recordSize = recordHeaderSize + e.dataSize;
+
+            if (totalSize + recordSize <= maxSize && isRecordValid (e))
+            {
+                writeRecord (out, e.hash, e.lastUsed, getRecord (e) + recordHeaderSize, (size_t) e.dataSize);
+                totalSize += recordSize;
+            }
+        }
+
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    mappedFile = nullptr; // (some platforms can't replace a file that's mapped)
+    const bool replaced = temp.overwriteTargetFileWithTemporary();
+    clearEntries (0);
+    update();
+    return replaced;
+}
+
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioThumbnailDiskCacheTests  : public UnitTest
+{
+public:
+    AudioThumbnailDiskCacheTests() : UnitTest ("AudioThumbnailDiskCache") {}
+
+    // Each AudioThumbnailDiskCache that's used here stands in for a separate process, as
+    // the only thing they share is the file.
+    struct Thumbnails
+    {
+        Thumbnails (Random& r) : cache (1)
+        {
+            AudioSampleBuffer buffer (1, 4096);
+
+            for (int i = 0; i < numElementsInArray (thumbnails); ++i)
+            {
+                for (int j = 0; j < buffer.getNumSamples(); ++j)
+                    buffer.setSample (0, j, r.nextFloat() * 2.0f - 1.0f);
+
+                thumbnails[i] = new AudioThumbnail (64, formatManager, cache);
+                thumbnails[i]->reset (1, 44100.0, buffer.getNumSamples());
+                thumbnails[i]->addBlock (0, buffer, 0, buffer.getNumSamples());
+            }
+        }
+
+        AudioFormatManager formatManager;
+        AudioThumbnailCache cache;
+        ScopedPointer<AudioThumbnail> thumbnails[3];
+    };
+
+    static MemoryBlock save (const AudioThumbnailBase& thumbnail)
+    {
+        MemoryOutputStream out;
+        thumbnail.saveTo (out);
+        return out.getMemoryBlock();
+    }
+
+    static bool load (AudioThumbnailDiskCache& diskCache, Thumbnails& source, int index)
+    {
+        AudioThumbnail loaded (64, source.formatManager, diskCache);
+
+        return diskCache.loadThumb (loaded, index + 1)
+                && save (loaded) == save (*source.thumbnails[index]);
+    }
+
+    static bool load (const File& file, Thumbnails& source, int index)
+    {
+        AudioThumbnailDiskCache diskCache (file, 1 << 20, 4);
+        return load (diskCache, source, index);
+    }
+
+    static void store (const File& file, Thumbnails& source, int index)
+    {
+        AudioThumbnailDiskCache diskCache (file, 1 << 20, 4);
+        diskCache.storeThumb (*source.thumbnails[index], index + 1);
+
+        // (so that each record gets a different last-used time)
+        Thread::sleep (5);
+    }
+
+    static void compact (const File& file, int64 maxSize)
+    {
+        AudioThumbnailDiskCache diskCache (file, maxSize, 4);
+        diskCache.compact();
+    }
+
+    void runTest() override
+    {
+        using namespace AudioThumbnailDiskCacheFormat;
+
+        Random r (getRandom());
+        Thumbnails source (r);
+        const int64 recordSize = recordHeaderSize + (int64) save (*source.thumbnails[0]).getSize();
+
+        beginTest ("Truncated or corrupt records");
+        {
+            const TemporaryFile temp (".thumbs");
+            const File& file = temp.getFile();
+
+            store (file, source, 0);
+            store (file, source, 1);
+            expectEquals (file.getSize(), fileHeaderSize + recordSize * 2);
+
+            {
+                FileOutputStream out (file);
+                out.setPosition (file.getSize() - 10);
+                expect (out.truncate().wasOk());
+            }
+
+            expectEquals (AudioThumbnailDiskCache (file, 1 << 20, 4).getNumThumbnailsOnDisk(), 1);
+            expect (load (file, source, 0));
+            expect (! load (file, source, 1));
+
+            // storing another one has to get rid of the partial record before appending to the file
+            store (file, source, 2);
+            expectEquals (file.getSize(), fileHeaderSize + recordSize * 2);
+            expect (load (file, source, 0));
+            expect (load (file, source, 2));
+
+            // flip the bits of a byte in the first record's data
+            const int64 position = fileHeaderSize + recordHeaderSize + 10;
+            char byte;
+
+            {
+                FileInputStream in (file);
+                in.setPosition (position);
+                byte = in.readByte();
+            }
+
+            {
+                FileOutputStream out (file);
+                out.setPosition (position);
+                out.writeByte ((char) ~byte);
+            }
+
+            expect (! load (file, source, 0));
+            expect (load (file, source, 2));
+        }
+
+        beginTest ("Least recently used thumbnails are removed");
+        {
+            const TemporaryFile temp (".thumbs");
+            const File& file = temp.getFile();
+
+            store (file, source, 0);
+            store (file, source, 1);
+            store (file, source, 2);
+
+            // loading the oldest one in another process should make it the most recently used
+            expect (load (file, source, 0));
+
+            compact (file, fileHeaderSize + recordSize * 2);
+            expectEquals (file.getSize(), fileHeaderSize + recordSize * 2);
+            expect (load (file, source, 0));
+            expect (! load (file, source, 1));
+            expect (load (file, source, 2));
+        }
+
+        beginTest ("Re-indexing after another process rewrites the file");
+        {
+            const TemporaryFile temp (".thumbs");
+            const File& file = temp.getFile();
+
+            store (file, source, 0);
+            store (file, source, 1);
+
+            AudioThumbnailDiskCache reader (file, 1 << 20, 4);
+            expectEquals (reader.getNumThumbnailsOnDisk(), 2);
+
+            // the rewrite sorts the records by when they were last used, so they all move
+            store (file, source, 2);
+            compact (file, 1 << 20);
+
+            expect (load (reader, source, 0));
+            expect (load (reader, source, 2));
+            expectEquals (reader.getNumThumbnailsOnDisk(), 3);
+
+            // if the reader had written its last-used times to the old positions, this would drop 0
+            compact (file, fileHeaderSize + recordSize * 2);
+            expect (load (file, source, 0));
+            expect (! load (file, source, 1));
+            expect (load (file, source, 2));
+        }
+    }
+};
+
+static AudioThumbnailDiskCacheTests audioThumbnailDiskCacheUnitTests;
+
+#endif
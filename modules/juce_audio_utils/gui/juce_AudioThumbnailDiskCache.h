@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+
+#ifndef JUCE_AUDIOTHUMBNAILDISKCACHE_H_INCLUDED
+#define JUCE_AUDIOTHUMBNAILDISKCACHE_H_INCLUDED
+
+
+//==============================================================================
+/**
+    An AudioThumbnailCache that also keeps its thumbnails in a file, so that they
+    don't need to be re-scanned the next time the application runs.
+
+    Each thumbnail that finishes loading is appended to the file as a record that's
+    keyed by its source's hash code, and the file is memory-mapped so that looking up
+    a thumbnail only reads the part of the file that's needed. When the file grows
+    beyond its size limit, it's rewritten with the thumbnails that were least recently
+    used left out.
+
+    Several processes can share the same file: they can all read it at once, and writes
+    are serialised with an InterProcessLock. A record that was only partly written
+    (e.g. because the application crashed) is ignored, and removed the next time the
+    file is rewritten.
+
+    @see AudioThumbnailCache, AudioThumbnail
+*/
+class JUCE_API  AudioThumbnailDiskCache  : public AudioThumbnailCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache that uses the given file.
+
+        @param cacheFile                    the file in which to keep the thumbnails - this
+                                            will be created if it doesn't already exist
+        @param maxBytesOnDisk               the size that the file is allowed to reach before
+                                            the least recently used thumbnails are removed
+        @param maxNumThumbsToStoreInMemory  the number of thumbnails that are also kept in memory
+        @param numScanningThreads           the number of threads that are used to scan the
+                                            thumbnails' sources - see AudioThumbnailCache
+    */
+    AudioThumbnailDiskCache (const File& cacheFile,
+                             int64 maxBytesOnDisk,
+                             int maxNumThumbsToStoreInMemory,
+                             int numScanningThreads = 0);
+
+    /** Destructor. */
+    ~AudioThumbnailDiskCache();
+
+    //==============================================================================
+    /** Returns the file that the thumbnails are kept in. */
+    const File& getFile() const noexcept                { return file; }
+
+    /** Returns the size that the file is allowed to grow to. */
+    int64 getMaxBytesOnDisk() const noexcept            { return maxBytesOnDisk; }
+
+    /** Returns the number of thumbnails that are currently stored in the file. */
+    int getNumThumbnailsOnDisk();
+
+    /** Rewrites the file, leaving out any old copies of thumbnails that have since been
+        stored again, and the least recently used thumbnails if it's too big.
+        This happens automatically when the file gets too large, so you don't normally
+        need to call it.
+    */
+    void compact();
+
+protected:
+    //==============================================================================
+    /** @internal */
+    void saveNewlyFinishedThumbnail (const AudioThumbnailBase&, int64 hashCode) override;
+    /** @internal */
+    bool loadNewThumb (AudioThumbnailBase&, int64 hashCode) override;
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        int64 hash, recordStart, lastUsed;
+        int dataSize;
+    };
+
+    struct EntryComparator;
+
+    const File file;
+    const int64 maxBytesOnDisk;
+    InterProcessLock fileLock;
+    CriticalSection lock;
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    Array<Entry> entries;
+    HashMap<int64, int> entryIndexes;
+    int64 fileID, scannedEnd;
+    bool hasUnreadableData;
+
+    void update();
+    void clearEntries (int64 newFileID);
+    const uint8* getRecord (const Entry&) const noexcept;
+    bool isRecordValid (const Entry&) const noexcept;
+    void markAsUsed (int64 hashCode);
+    bool rewrite (int64 maxSize);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnailDiskCache)
+};
+
+
+#endif   // JUCE_AUDIOTHUMBNAILDISKCACHE_H_INCLUDED
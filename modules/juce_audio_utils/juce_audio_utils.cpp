@@ -45,7 +45,9 @@ namespace juce
 
 #include "gui/juce_AudioDeviceSelectorComponent.cpp"
 #include "gui/juce_AudioThumbnail.cpp"
+#include "gui/juce_AudioThumbnailBuilder.cpp"
 #include "gui/juce_AudioThumbnailCache.cpp"
+#include "gui/juce_AudioThumbnailDiskCache.cpp"
 #include "gui/juce_AudioVisualiserComponent.cpp"
 #include "gui/juce_MidiKeyboardComponent.cpp"
 #include "gui/juce_AudioAppComponent.cpp"
@@ -62,7 +62,9 @@ namespace juce
 #include "gui/juce_AudioDeviceSelectorComponent.h"
 #include "gui/juce_AudioThumbnailBase.h"
 #include "gui/juce_AudioThumbnail.h"
+#include "gui/juce_AudioThumbnailBuilder.h"
 #include "gui/juce_AudioThumbnailCache.h"
+#include "gui/juce_AudioThumbnailDiskCache.h"
 #include "gui/juce_AudioVisualiserComponent.h"
 #include "gui/juce_MidiKeyboardComponent.h"
 #include "gui/juce_AudioAppComponent.h"
@@ -0,0 +1,365 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#if JUCE_UNIT_TESTS
+
+class LockFreeQueueTests  : public UnitTest
+{
+public:
+    LockFreeQueueTests()  : UnitTest ("Lock-free queues") {}
+
+    //==============================================================================
+    // Pushes a numbered sequence of items, using a random mixture of the push methods
+    template <typename QueueType>
+    struct ProducerThread  : public Thread
+    {
+        ProducerThread (QueueType& q, int producerId, int items, Random r)
+            : Thread ("Queue producer"), queue (q), id (producerId), numItems (items), random (r)
+        {
+        }
+
+        void run() override
+        {
+            int next = 0;
+            int batch[32];
+
+            while (next < numItems && ! threadShouldExit())
+            {
+                if (random.nextBool())
+                {
+                    const int num = jmin (numItems - next, 1 + random.nextInt (numElementsInArray (batch)));
+
+                    for (int i = 0; i < num; ++i)
+                        batch[i] = encode (id, next + i);
+
+                    next += queue.pushMultiple (batch, num);
+                }
+                else if (queue.waitAndPush (encode (id, next), 100))
+                {
+                    ++next;
+                }
+            }
+        }
+
+        QueueType& queue;
+        const int id, numItems;
+        Random random;
+    };
+
+    // Pops items until it has seen the given total, checking that each producer's items arrive in order
+    template <typename QueueType>
+    struct ConsumerThread  : public Thread
+    {
+        ConsumerThread (QueueType& q, Atomic<int>& total, int numProducers, Random r)
+            : Thread ("Queue consumer"), queue (q), totalPopped (total), lastSeen ((size_t) numProducers), random (r),
+              numProducers (numProducers), failed (false)
+        {
+            for (int i = 0; i < numProducers; ++i)
+                lastSeen[i] = -1;
+        }
+
+        void run() override
+        {
+            int batch[32];
+
+            while (! threadShouldExit())
+            {
+                int num = 0;
+
+                if (random.nextBool())
+                    num = queue.popMultiple (batch, 1 + random.nextInt (numElementsInArray (batch)));
+                else if (queue.waitAndPop (batch[0], 20))
+                    num = 1;
+
+                for (int i = 0; i < num; ++i)
+                {
+                    const int producer = batch[i] >> 24, index = batch[i] & 0xffffff;
+
+                    if (! isPositiveAndBelow (producer, numProducers) || index <= lastSeen[producer])
+                        failed = true;
+                    else
+                        lastSeen[producer] = index;
+                }
+
+                if (num > 0)
+                    totalPopped += num;
+            }
+        }
+
+        QueueType& queue;
+        Atomic<int>& totalPopped;
+        HeapBlock<int> lastSeen;
+        Random random;
+        const int numProducers;
+        bool failed;
+    };
+
+    static int encode (int producerId, int index) noexcept     { return (producerId << 24) | index; }
+
+    template <typename QueueType>
+    void runProducersAndConsumers (QueueType& queue, int numProducers, int numConsumers, int itemsPerProducer)
+    {
+        Atomic<int> totalPopped;
+        OwnedArray<ProducerThread<QueueType> > producers;
+        OwnedArray<ConsumerThread<QueueType> > consumers;
+
+        for (int i = 0; i < numConsumers; ++i)
+            consumers.add (new ConsumerThread<QueueType> (queue, totalPopped, numProducers, getRandom()))->startThread();
+
+        for (int i = 0; i < numProducers; ++i)
+            producers.add (new ProducerThread<QueueType> (queue, i, itemsPerProducer, getRandom()))->startThread();
+
+        const int total = numProducers * itemsPerProducer;
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        while (totalPopped.get() < total && Time::getMillisecondCounter() < startTime + 60000)
+            Thread::sleep (5);
+
+        for (int i = 0; i < numProducers; ++i)
+            producers.getUnchecked (i)->stopThread (5000);
+
+        for (int i = 0; i < numConsumers; ++i)
+        {
+            consumers.getUnchecked (i)->stopThread (5000);
+            expect (! consumers.getUnchecked (i)->failed, "items arrived out of order");
+        }
+
+        expectEquals (totalPopped.get(), total);
+        expect (queue.isEmpty());
+    }
+
+    template <typename QueueType>
+    void checkSingleThreaded()
+    {
+        QueueType queue (100);
+        expectEquals (queue.getCapacity(), 128);
+        expect (queue.isEmpty());
+
+        int value = 0;
+        expect (! queue.pop (value));
+        expect (! queue.waitAndPop (value, 10));
+
+        for (int i = 0; i < 128; ++i)
+            expect (queue.push (i));
+
+        expect (! queue.push (128));
+        expect (! queue.waitAndPush (128, 10));
+        expectEquals (queue.size(), 128);
+
+        int batch[50];
+        expectEquals (queue.popMultiple (batch, 50), 50);
+        expect (batch[0] == 0 && batch[49] == 49);
+        expectEquals (queue.pushMultiple (batch, 50), 50);
+        expectEquals (queue.pushMultiple (batch, 50), 0);
+
+        for (int i = 50; i < 128; ++i)
+            expect (queue.pop (value) && value == i);
+
+        expectEquals (queue.popMultiple (batch, 50), 50);
+        expect (batch[0] == 0 && batch[49] == 49);
+        expect (queue.isEmpty());
+    }
+
+    //==============================================================================
+    // A CriticalSection-guarded Array, for comparison
+    struct LockedArrayQueue
+    {
+        explicit LockedArrayQueue (int capacity) : maxSize (capacity) {}
+
+        bool push (const int& item)
+        {
+            const ScopedLock sl (lock);
+
+            if (items.size() >= maxSize)
+                return false;
+
+            items.add (item);
+            return true;
+        }
+
+        bool pop (int& result)
+        {
+            const ScopedLock sl (lock);
+
+            if (items.size() == 0)
+                return false;
+
+            result = items.remove (0);
+            return true;
+        }
+
+        bool waitAndPush (const int& item)
+        {
+            while (! push (item))
+                spaceAvailable.wait (1);
+
+            dataAvailable.signal();
+            return true;
+        }
+
+        bool waitAndPop (int& result)
+        {
+            while (! pop (result))
+                dataAvailable.wait (1);
+
+            spaceAvailable.signal();
+            return true;
+        }
+
+        CriticalSection lock;
+        Array<int> items;
+        const int maxSize;
+        WaitableEvent dataAvailable, spaceAvailable;
+    };
+
+    // Each thread repeatedly pushes an item and pops one, so every thread is both a producer and a consumer
+    template <typename QueueType>
+    struct ContentionThread  : public Thread
+    {
+        ContentionThread (QueueType& q, int iterations, const WaitableEvent& go)
+            : Thread ("Queue contention"), queue (q), numIterations (iterations), startEvent (go)
+        {
+        }
+
+        void run() override
+        {
+            startEvent.wait();
+
+            for (int i = 0; i < numIterations; ++i)
+            {
+                while (! queue.push (i))
+                    Thread::yield();
+
+                int result;
+
+                while (! queue.pop (result))
+                    Thread::yield();
+            }
+        }
+
+        QueueType& queue;
+        const int numIterations;
+        const WaitableEvent& startEvent;
+    };
+
+    template <typename QueueType>
+    static double timeContention (int numThreads, int totalIterations)
+    {
+        QueueType queue (numThreads * 2);
+        WaitableEvent startEvent (true);
+        OwnedArray<ContentionThread<QueueType> > threads;
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.add (new ContentionThread<QueueType> (queue, totalIterations / numThreads, startEvent))->startThread();
+
+        const double startTime = Time::getMillisecondCounterHiRes();
+        startEvent.signal();
+
+        for (int i = 0; i < numThreads; ++i)
+            threads.getUnchecked (i)->waitForThreadToExit (-1);
+
+        return Time::getMillisecondCounterHiRes() - startTime;
+    }
+
+    // One thread pushes a stream of items while another pops them, blocking when they need to
+    template <typename QueueType>
+    struct StreamingThread  : public Thread
+    {
+        StreamingThread (QueueType& q, int items)  : Thread ("Queue producer"), queue (q), numItems (items) {}
+
+        void run() override
+        {
+            for (int i = 0; i < numItems; ++i)
+                queue.waitAndPush (i);
+        }
+
+        QueueType& queue;
+        const int numItems;
+    };
+
+    template <typename QueueType>
+    static double timeStreaming (int numItems)
+    {
+        QueueType queue (1024);
+        StreamingThread<QueueType> producer (queue, numItems);
+
+        const double startTime = Time::getMillisecondCounterHiRes();
+        producer.startThread();
+
+        for (int i = 0, result; i < numItems; ++i)
+            queue.waitAndPop (result);
+
+        producer.waitForThreadToExit (-1);
+        return Time::getMillisecondCounterHiRes() - startTime;
+    }
+
+    //==============================================================================
+    void runTest() override
+    {
+        beginTest ("Single-threaded");
+        checkSingleThreaded<SingleProducerSingleConsumerQueue<int> >();
+        checkSingleThreaded<MultiProducerMultiConsumerQueue<int> >();
+
+        beginTest ("Single producer, single consumer");
+        {
+            SingleProducerSingleConsumerQueue<int> queue (64);
+            runProducersAndConsumers (queue, 1, 1, 200000);
+        }
+
+        beginTest ("Multiple producers and consumers");
+        {
+            MultiProducerMultiConsumerQueue<int> queue (64);
+            runProducersAndConsumers (queue, 4, 4, 50000);
+        }
+
+        beginTest ("Contention");
+        {
+            const int numItems = 100000;
+            const double spscTime = timeStreaming<SingleProducerSingleConsumerQueue<int> > (numItems);
+            const double mpmcTime = timeStreaming<MultiProducerMultiConsumerQueue<int> > (numItems);
+            const double lockedTime = timeStreaming<LockedArrayQueue> (numItems);
+
+            logMessage ("Streaming " + String (numItems) + " items between 2 threads: SPSC " + String (spscTime, 1)
+                          + "ms, MPMC " + String (mpmcTime, 1) + "ms, CriticalSection + Array " + String (lockedTime, 1) + "ms");
+
+            for (int numThreads = 1; numThreads <= 32; numThreads *= 2)
+            {
+                const double lockFreeTime = timeContention<MultiProducerMultiConsumerQueue<int> > (numThreads, numItems);
+                const double lockedContentionTime = timeContention<LockedArrayQueue> (numThreads, numItems);
+
+                logMessage (String (numThreads) + " threads pushing and popping " + String (numItems) + " items: MPMC "
+                              + String (lockFreeTime, 1) + "ms, CriticalSection + Array " + String (lockedContentionTime, 1)
+                              + "ms (x" + String (lockedContentionTime / jmax (0.001, lockFreeTime), 2) + ")");
+            }
+        }
+    }
+};
+
+static LockFreeQueueTests lockFreeQueueUnitTests;
+
+#endif
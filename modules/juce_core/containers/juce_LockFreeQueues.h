@@ -0,0 +1,573 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_LOCKFREEQUEUES_H_INCLUDED
+#define JUCE_LOCKFREEQUEUES_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Lets threads block until a lock-free queue has some data or space available.
+
+    The queues only touch this when a thread actually wants to wait, so a push or pop
+    that doesn't block costs nothing more than checking a counter.
+
+    @internal
+*/
+class JUCE_API  LockFreeQueueWaiter
+{
+public:
+    LockFreeQueueWaiter() noexcept {}
+
+    /** Wakes up a waiting thread, if there are any.
+        This must be called after the state change that the waiters are interested in
+        has been published with a full barrier (e.g. by an Atomic::set() call), which
+        means that a plain read of the counter is enough to avoid missed wake-ups.
+    */
+    void notify() const noexcept
+    {
+        if (numWaiting.value > 0)
+            event.signal();
+    }
+
+    /** Registers the calling thread as a waiter.
+        After calling this, the caller must check its condition again, and then call
+        either stopWaiting() or wait().
+    */
+    void startWaiting() noexcept        { ++numWaiting; }
+
+    /** Unregisters a thread that called startWaiting() but no longer needs to block. */
+    void stopWaiting() noexcept         { --numWaiting; }
+
+    /** Blocks until notify() is called or the timeout expires, and then unregisters the
+        calling thread. The timeout is measured from startTime, which should be a value
+        from Time::getMillisecondCounter(), and a negative timeout means wait forever.
+        Returns false if the timeout had already expired before the call.
+    */
+    bool wait (uint32 startTime, int timeoutMilliseconds) noexcept
+    {
+        int timeToWait = -1;
+
+        if (timeoutMilliseconds >= 0)
+        {
+            timeToWait = timeoutMilliseconds - (int) (Time::getMillisecondCounter() - startTime);
+
+            if (timeToWait <= 0)
+            {
+                stopWaiting();
+                return false;
+            }
+        }
+
+        event.wait (timeToWait);
+        stopWaiting();
+        return true;
+    }
+
+private:
+    Atomic<int> numWaiting;
+    WaitableEvent event;
+
+    JUCE_DECLARE_NON_COPYABLE (LockFreeQueueWaiter)
+};
+
+
+//==============================================================================
+/**
+    A bounded, lock-free FIFO queue for passing objects from one thread to another.
+
+    Exactly one thread may push items into the queue, and exactly one thread may pop
+    them, although these can be different threads at different times as long as the
+    hand-over is properly synchronised. If you need more than one thread at either end,
+    use a MultiProducerMultiConsumerQueue instead.
+
+    The read and write positions are kept on separate cache lines, and each end keeps a
+    cached copy of the other's position, so in the common case a push or pop doesn't
+    touch any memory that's being written by the other thread, apart from the item itself.
+
+    The Type must be default-constructible and copy-assignable. The queue's storage is
+    allocated in the constructor, and none of the push or pop methods allocate anything.
+
+    @see MultiProducerMultiConsumerQueue, AbstractFifo
+*/
+template <typename Type>
+class SingleProducerSingleConsumerQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue which can hold at least the given number of items.
+        The actual capacity will be rounded up to a power of two.
+    */
+    explicit SingleProducerSingleConsumerQueue (int minimumCapacity)
+        : capacity (nextPowerOfTwo (jmax (2, minimumCapacity))),
+          mask ((uint32) capacity - 1),
+          items ((size_t) capacity),
+          cachedWritePos (0),
+          cachedReadPos (0)
+    {
+        for (int i = 0; i < capacity; ++i)
+            new (items + i) Type();
+    }
+
+    /** Destructor. */
+    ~SingleProducerSingleConsumerQueue()
+    {
+        for (int i = 0; i < capacity; ++i)
+            items[i].~Type();
+    }
+
+    //==============================================================================
+    /** Adds an item to the queue if there's room for it.
+        This may only be called by the producer thread.
+        @returns false if the queue was full
+    */
+    bool push (const Type& item) noexcept
+    {
+        return pushMultiple (&item, 1) != 0;
+    }
+
+    /** Removes the oldest item from the queue, if there is one.
+        This may only be called by the consumer thread.
+        @returns false if the queue was empty
+    */
+    bool pop (Type& result) noexcept
+    {
+        return popMultiple (&result, 1) != 0;
+    }
+
+    /** Adds as many items from an array as there's space for.
+        This may only be called by the producer thread.
+        @returns the number of items that were added
+    */
+    int pushMultiple (const Type* source, int numItems) noexcept
+    {
+        // only the producer ever changes writePos, so it can read it without a barrier
+        const uint32 pos = writePos.value;
+        int numFree = capacity - (int) (pos - cachedReadPos);
+
+        if (numFree < numItems)
+        {
+            cachedReadPos = readPos.get();
+            numFree = capacity - (int) (pos - cachedReadPos);
+        }
+
+        const int num = jmin (numItems, numFree);
+
+        if (num > 0)
+        {
+            for (int i = 0; i < num; ++i)
+                items[(pos + (uint32) i) & mask] = source[i];
+
+            writePos.set (pos + (uint32) num);
+            dataAvailable.notify();
+        }
+
+        return num;
+    }
+
+    /** Removes up to the given number of items, copying them into an array.
+        This may only be called by the consumer thread.
+        @returns the number of items that were removed
+    */
+    int popMultiple (Type* dest, int maxItems) noexcept
+    {
+        const uint32 pos = readPos.value;
+        int numAvailable = (int) (cachedWritePos - pos);
+
+        if (numAvailable < maxItems)
+        {
+            cachedWritePos = writePos.get();
+            numAvailable = (int) (cachedWritePos - pos);
+        }
+
+        const int num = jmin (maxItems, numAvailable);
+
+        if (num > 0)
+        {
+            for (int i = 0; i < num; ++i)
+                dest[i] = items[(pos + (uint32) i) & mask];
+
+            readPos.set (pos + (uint32) num);
+            spaceAvailable.notify();
+        }
+
+        return num;
+    }
+
+    //==============================================================================
+    /** Adds an item, blocking until there's space for it or the timeout expires.
+        A negative timeout means wait forever.
+        @returns false if the timeout expired before the item could be added
+    */
+    bool waitAndPush (const Type& item, int timeoutMilliseconds = -1)
+    {
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        while (! push (item))
+        {
+            spaceAvailable.startWaiting();
+
+            if (push (item))
+            {
+                spaceAvailable.stopWaiting();
+                break;
+            }
+
+            if (! spaceAvailable.wait (startTime, timeoutMilliseconds))
+                return false;
+        }
+
+        return true;
+    }
+
+    /** Removes the oldest item, blocking until there is one or the timeout expires.
+        A negative timeout means wait forever.
+        @returns false if the timeout expired before an item became available
+    */
+    bool waitAndPop (Type& result, int timeoutMilliseconds = -1)
+    {
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        while (! pop (result))
+        {
+            dataAvailable.startWaiting();
+
+            if (pop (result))
+            {
+                dataAvailable.stopWaiting();
+                break;
+            }
+
+            if (! dataAvailable.wait (startTime, timeoutMilliseconds))
+                return false;
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    /** Returns the number of items in the queue.
+        This is wait-free and can be called from any thread, but if other threads are
+        using the queue, the result is only a snapshot.
+    */
+    int size() const noexcept
+    {
+        const uint32 read = readPos.get();
+        return jlimit (0, capacity, (int) (writePos.get() - read));
+    }
+
+    /** Returns true if the queue is empty. @see size */
+    bool isEmpty() const noexcept           { return size() == 0; }
+
+    /** Returns the maximum number of items that the queue can hold. */
+    int getCapacity() const noexcept        { return capacity; }
+
+private:
+    //==============================================================================
+    enum { cacheLineSize = 64 };
+
+    const int capacity;
+    const uint32 mask;
+    HeapBlock<Type> items;
+    LockFreeQueueWaiter dataAvailable, spaceAvailable;
+
+    char padding1[cacheLineSize];
+    Atomic<uint32> readPos;
+    uint32 cachedWritePos;
+    char padding2[cacheLineSize - sizeof (uint32) * 2];
+    Atomic<uint32> writePos;
+    uint32 cachedReadPos;
+    char padding3[cacheLineSize - sizeof (uint32) * 2];
+
+    JUCE_DECLARE_NON_COPYABLE (SingleProducerSingleConsumerQueue)
+};
+
+
+//==============================================================================
+/**
+    A bounded, lock-free FIFO queue which any number of threads can push to and pop from.
+
+    Each slot in the queue has a sequence number which tells the producers and consumers
+    whether it's free or holds an item for the current lap around the buffer, so claiming
+    a slot is a single compare-and-swap on the shared write or read position, which are
+    kept on separate cache lines. Batches of items are claimed with a single
+    compare-and-swap too, so the items in a batch stay together in the queue.
+
+    Items pushed by any one thread are popped in the order they were pushed, but there's
+    no ordering between items from different threads.
+
+    The Type must be default-constructible and copy-assignable. The queue's storage is
+    allocated in the constructor, and none of the push or pop methods allocate anything.
+
+    @see SingleProducerSingleConsumerQueue
+*/
+template <typename Type>
+class MultiProducerMultiConsumerQueue
+{
+public:
+    //==============================================================================
+    /** Creates a queue which can hold at least the given number of items.
+        The actual capacity will be rounded up to a power of two.
+    */
+    explicit MultiProducerMultiConsumerQueue (int minimumCapacity)
+        : capacity (nextPowerOfTwo (jmax (2, minimumCapacity))),
+          mask ((uint32) capacity - 1),
+          cells ((size_t) capacity)
+    {
+        for (int i = 0; i < capacity; ++i)
+            new (cells + i) Cell ((uint32) i);
+    }
+
+    /** Destructor. */
+    ~MultiProducerMultiConsumerQueue()
+    {
+        for (int i = 0; i < capacity; ++i)
+            cells[i].~Cell();
+    }
+
+    //==============================================================================
+    /** Adds an item to the queue if there's room for it.
+        @returns false if the queue was full
+    */
+    bool push (const Type& item) noexcept
+    {
+        return pushMultiple (&item, 1) != 0;
+    }
+
+    /** Removes the oldest item from the queue, if there is one.
+        @returns false if the queue was empty
+    */
+    bool pop (Type& result) noexcept
+    {
+        return popMultiple (&result, 1) != 0;
+    }
+
+    /** Adds as many items from an array as there's space for.
+        The items that are added will be contiguous in the queue, so no other thread's
+        items can end up between them.
+        @returns the number of items that were added
+    */
+    int pushMultiple (const Type* source, int numItems) noexcept
+    {
+        if (numItems <= 0)
+            return 0;
+
+        uint32 pos = enqueuePos.get();
+
+        for (;;)
+        {
+            // a slot is free for this lap when its sequence number equals its position
+            const int32 diff = (int32) (cells[pos & mask].sequence.get() - pos);
+
+            if (diff < 0)
+                return 0;
+
+            if (diff > 0)
+            {
+                pos = enqueuePos.get();
+                continue;
+            }
+
+            int num = 1;
+
+            while (num < numItems && cells[(pos + (uint32) num) & mask].sequence.get() == pos + (uint32) num)
+                ++num;
+
+            const uint32 oldPos = enqueuePos.compareAndSetValue (pos + (uint32) num, pos);
+
+            if (oldPos == pos)
+            {
+                for (int i = 0; i < num; ++i)
+                {
+                    Cell& cell = cells[(pos + (uint32) i) & mask];
+                    cell.item = source[i];
+                    cell.sequence.set (pos + (uint32) i + 1);
+                }
+
+                dataAvailable.notify();
+                return num;
+            }
+
+            pos = oldPos;
+        }
+    }
+
+    /** Removes up to the given number of items, copying them into an array.
+        The items will be contiguous ones from the queue, so no other thread can pop
+        any items from between them.
+        @returns the number of items that were removed
+    */
+    int popMultiple (Type* dest, int maxItems) noexcept
+    {
+        if (maxItems <= 0)
+            return 0;
+
+        uint32 pos = dequeuePos.get();
+
+        for (;;)
+        {
+            // a slot holds an item for this lap when its sequence number is one past its position
+            const int32 diff = (int32) (cells[pos & mask].sequence.get() - (pos + 1));
+
+            if (diff < 0)
+                return 0;
+
+            if (diff > 0)
+            {
+                pos = dequeuePos.get();
+                continue;
+            }
+
+            int num = 1;
+
+            while (num < maxItems && cells[(pos + (uint32) num) & mask].sequence.get() == pos + (uint32) num + 1)
+                ++num;
+
+            const uint32 oldPos = dequeuePos.compareAndSetValue (pos + (uint32) num, pos);
+
+            if (oldPos == pos)
+            {
+                for (int i = 0; i < num; ++i)
+                {
+                    Cell& cell = cells[(pos + (uint32) i) & mask];
+                    dest[i] = cell.item;
+                    cell.sequence.set (pos + (uint32) i + (uint32) capacity);
+                }
+
+                spaceAvailable.notify();
+                return num;
+            }
+
+            pos = oldPos;
+        }
+    }
+
+    //==============================================================================
+    /** Adds an item, blocking until there's space for it or the timeout expires.
+        A negative timeout means wait forever.
+        @returns false if the timeout expired before the item could be added
+    */
+    bool waitAndPush (const Type& item, int timeoutMilliseconds = -1)
+    {
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        while (! push (item))
+        {
+            spaceAvailable.startWaiting();
+
+            if (push (item))
+            {
+                spaceAvailable.stopWaiting();
+                break;
+            }
+
+            if (! spaceAvailable.wait (startTime, timeoutMilliseconds))
+                return false;
+        }
+
+        // if several waiting threads were woken by a single signal, make sure another gets a go
+        if (size() < capacity)
+            spaceAvailable.notify();
+
+        return true;
+    }
+
+    /** Removes the oldest item, blocking until there is one or the timeout expires.
+        A negative timeout means wait forever.
+        @returns false if the timeout expired before an item became available
+    */
+    bool waitAndPop (Type& result, int timeoutMilliseconds = -1)
+    {
+        const uint32 startTime = Time::getMillisecondCounter();
+
+        while (! pop (result))
+        {
+            dataAvailable.startWaiting();
+
+            if (pop (result))
+            {
+                dataAvailable.stopWaiting();
+                break;
+            }
+
+            if (! dataAvailable.wait (startTime, timeoutMilliseconds))
+                return false;
+        }
+
+        // if several waiting threads were woken by a single signal, make sure another gets a go
+        if (size() > 0)
+            dataAvailable.notify();
+
+        return true;
+    }
+
+    //==============================================================================
+    /** Returns the number of items in the queue.
+        This is wait-free and can be called from any thread, but if other threads are
+        using the queue, the result is only a snapshot.
+    */
+    int size() const noexcept
+    {
+        const uint32 read = dequeuePos.get();
+        return jlimit (0, capacity, (int) (enqueuePos.get() - read));
+    }
+
+    /** Returns true if the queue is empty. @see size */
+    bool isEmpty() const noexcept           { return size() == 0; }
+
+    /** Returns the maximum number of items that the queue can hold. */
+    int getCapacity() const noexcept        { return capacity; }
+
+private:
+    //==============================================================================
+    enum { cacheLineSize = 64 };
+
+    struct Cell
+    {
+        explicit Cell (uint32 initialSequence) noexcept  : sequence (initialSequence), item() {}
+
+        Atomic<uint32> sequence;
+        Type item;
+    };
+
+    const int capacity;
+    const uint32 mask;
+    HeapBlock<Cell> cells;
+    LockFreeQueueWaiter dataAvailable, spaceAvailable;
+
+    char padding1[cacheLineSize];
+    Atomic<uint32> enqueuePos;
+    char padding2[cacheLineSize - sizeof (uint32)];
+    Atomic<uint32> dequeuePos;
+    char padding3[cacheLineSize - sizeof (uint32)];
+
+    JUCE_DECLARE_NON_COPYABLE (MultiProducerMultiConsumerQueue)
+};
+
+
+#endif   // JUCE_LOCKFREEQUEUES_H_INCLUDED
@@ -208,13 +208,13 @@ bool NamedValueSet::remove (const Identifier& name)
     return false;
 }
 
-Identifier NamedValueSet::getName (const int index) const noexcept
+const Identifier& NamedValueSet::getName (const int index) const noexcept
 {
     if (isPositiveAndBelow (index, values.size()))
         return values.getReference (index).name;
 
     jassertfalse;
-    return Identifier();
+    return Identifier::null;
 }
 
 const var& NamedValueSet::getValueAt (const int index) const noexcept
@@ -103,7 +103,7 @@ public:
     /** Returns the name of the value at a given index.
         The index must be between 0 and size() - 1.
     */
-    Identifier getName (int index) const noexcept;
+    const Identifier& getName (int index) const noexcept;
 
     /** Returns a pointer to the var that holds a named value, or null if there is
         no value with this name.
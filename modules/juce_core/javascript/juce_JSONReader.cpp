@@ -0,0 +1,866 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+JSONReader::JSONReader (InputStream& s, size_t initialBufferSize)
+    : source (&s),
+      bufferSize (jmax ((size_t) 16, initialBufferSize)),
+      bufferStartPosition (0),
+      expecting (topLevelValue),
+      currentToken (startOfObject),
+      errorResult (Result::ok()),
+      stringValueStart (nullptr),
+      integer (0), number (0), isSmallInteger (true)
+{
+    ownedBuffer.malloc (bufferSize);
+    buffer = ownedBuffer;
+    tokenStart = position = writePosition = bufferEnd = buffer;
+}
+
+JSONReader::JSONReader (MemoryBlock& textToParseInPlace)
+    : source (nullptr),
+      buffer (static_cast<char*> (textToParseInPlace.getData())),
+      bufferSize (textToParseInPlace.getSize()),
+      bufferStartPosition (0),
+      expecting (topLevelValue),
+      currentToken (startOfObject),
+      errorResult (Result::ok()),
+      stringValueStart (nullptr),
+      integer (0), number (0), isSmallInteger (true)
+{
+    tokenStart = position = writePosition = buffer;
+    bufferEnd = buffer + bufferSize;
+}
+
+JSONReader::~JSONReader() {}
+
+//==============================================================================
+StringRef JSONReader::getString() const noexcept
+{
+    if (currentToken == propertyName || currentToken == stringValue)
+        return String::CharPointerType (stringValueStart);
+
+    return StringRef();
+}
+
+int64 JSONReader::getIntegerValue() const noexcept
+{
+    switch (currentToken)
+    {
+        case integerValue:
+        case boolValue:     return integer;
+        case doubleValue:   return (int64) number;
+        default:            return 0;
+    }
+}
+
+double JSONReader::getDoubleValue() const noexcept
+{
+    switch (currentToken)
+    {
+        case integerValue:
+        case boolValue:
+        case doubleValue:   return number;
+        default:            return 0;
+    }
+}
+
+int64 JSONReader::getPosition() const noexcept
+{
+    return bufferStartPosition + (tokenStart - buffer);
+}
+
+//==============================================================================
+JSONReader::TokenType JSONReader::next()
+{
+    if (currentToken == endOfInput || currentToken == error)
+        return currentToken;
+
+    for (;;)
+    {
+        if (! skipWhitespace())
+        {
+            if (expecting == topLevelValue || expecting == endOfText)
+                return currentToken = endOfInput;
+
+            return fail ("Unexpected end-of-input");
+        }
+
+        tokenStart = position;
+        const char c = *position;
+
+        switch (expecting)
+        {
+            case topLevelValue:
+            case propertyValue:
+                return readValue();
+
+            case firstArrayItemOrEnd:
+                return c == ']' ? closeContainer (endOfArray) : readValue();
+
+            case firstPropertyNameOrEnd:
+                if (c == '}')
+                    return closeContainer (endOfObject);
+
+                if (c != '"')
+                    return fail ("Expected object member declaration");
+
+                expecting = colon;
+                return currentToken = readString (propertyName, c);
+
+            case colon:
+                if (c != ':')
+                    return fail ("Expected ':'");
+
+                ++position;
+                expecting = propertyValue;
+                break;
+
+            case commaOrEnd:
+            {
+                const bool inObject = containers.getLast() == '{';
+
+                if (c == ',')
+                {
+                    // (like JSON::parse(), this tolerates a trailing comma before the closing bracket)
+                    ++position;
+                    expecting = inObject ? firstPropertyNameOrEnd : firstArrayItemOrEnd;
+                    break;
+                }
+
+                if (c == (inObject ? '}' : ']'))
+                    return closeContainer (inObject ? endOfObject : endOfArray);
+
+                return fail (inObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+            }
+
+            case endOfText:
+            default:
+                return fail ("Unexpected text after the end of the value");
+        }
+    }
+}
+
+var JSONReader::getValue()
+{
+    if (currentToken == propertyName)
+        next();
+
+    switch (currentToken)
+    {
+        case stringValue:       return String (String::CharPointerType (stringValueStart));
+        case integerValue:      return isSmallInteger ? var ((int) integer) : var (integer);
+        case doubleValue:       return number;
+        case boolValue:         return integer != 0;
+        case startOfObject:
+        case startOfArray:      return readContainer();
+        default:                return var();
+    }
+}
+
+var JSONReader::readContainer()
+{
+    if (currentToken == startOfArray)
+    {
+        var result ((Array<var>()));
+        Array<var>& items = *result.getArray();
+
+        while (next() != endOfArray)
+        {
+            const var item (getValue());
+
+            if (currentToken == error)
+                return var();
+
+            items.add (item);
+        }
+
+        return result;
+    }
+
+    DynamicObject::Ptr object (new DynamicObject());
+
+    while (next() != endOfObject)
+    {
+        if (currentToken == error)
+            return var();
+
+        const StringRef name (getString());
+
+        if (name.isEmpty())
+        {
+            fail ("Expected object member declaration");
+            return var();
+        }
+
+        const Identifier propertyName (name.text, name.text.findTerminatingNull());
+        const var value (getValue());
+
+        if (currentToken == error)
+            return var();
+
+        object->setProperty (propertyName, value);
+    }
+
+    return object.get();
+}
+
+void JSONReader::skipValue()
+{
+    if (currentToken == propertyName)
+        next();
+
+    if (currentToken == startOfObject || currentToken == startOfArray)
+    {
+        const int depth = containers.size();
+
+        while (containers.size() >= depth)
+            if (next() == error)
+                break;
+    }
+}
+
+//==============================================================================
+bool JSONReader::readMore()
+{
+    if (source == nullptr)
+        return false;
+
+    const size_t numToDiscard = (size_t) (tokenStart - buffer);
+    const size_t numToKeep    = (size_t) (bufferEnd - tokenStart);
+    const size_t positionOffset = (size_t) (position - tokenStart);
+    const size_t writeOffset    = (size_t) (writePosition - tokenStart);
+
+    if (numToDiscard > 0)
+        memmove (buffer, tokenStart, numToKeep);
+
+    // If a single token fills most of the buffer, make it bigger, so that the
+    // amount read each time doesn't get too small..
+    if (numToKeep > bufferSize / 2)
+    {
+        bufferSize *= 2;
+        ownedBuffer.realloc (bufferSize);
+        buffer = ownedBuffer;
+    }
+
+    bufferStartPosition += (int64) numToDiscard;
+    tokenStart    = buffer;
+    position      = buffer + positionOffset;
+    writePosition = buffer + writeOffset;
+    bufferEnd     = buffer + numToKeep;
+
+    const int numRead = source->read (bufferEnd, (int) (bufferSize - numToKeep));
+
+    if (numRead <= 0)
+        return false;
+
+    bufferEnd += numRead;
+    return true;
+}
+
+bool JSONReader::ensureAvailable (const int numBytes)
+{
+    while (bufferEnd - position < numBytes)
+        if (! readMore())
+            return false;
+
+    return true;
+}
+
+bool JSONReader::skipWhitespace()
+{
+    for (;;)
+    {
+        while (position < bufferEnd)
+        {
+            const char c = *position;
+
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+                return true;
+
+            ++position;
+        }
+
+        tokenStart = position;
+
+        if (! readMore())
+            return false;
+    }
+}
+
+//==============================================================================
+JSONReader::TokenType JSONReader::readValue()
+{
+    switch (*position)
+    {
+        case '{':   return openContainer ('{', startOfObject);
+        case '[':   return openContainer ('[', startOfArray);
+        case '"':   return finishValue (readString (stringValue, '"'));
+        case '\'':  return finishValue (readString (stringValue, '\''));
+        case 't':   return readKeyword ("true",  4, boolValue, true);
+        case 'f':   return readKeyword ("false", 5, boolValue, false);
+        case 'n':   return readKeyword ("null",  4, nullValue, false);
+
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return finishValue (readNumber());
+
+        default:
+            return fail ("Syntax error");
+    }
+}
+
+JSONReader::TokenType JSONReader::openContainer (const char type, const TokenType token)
+{
+    ++position;
+    containers.add (type);
+    expecting = (type == '{') ? firstPropertyNameOrEnd : firstArrayItemOrEnd;
+    return currentToken = token;
+}
+
+JSONReader::TokenType JSONReader::closeContainer (const TokenType token)
+{
+    ++position;
+    containers.removeLast();
+    return finishValue (token);
+}
+
+JSONReader::TokenType JSONReader::finishValue (const TokenType token)
+{
+    if (token != error)
+        expecting = containers.size() == 0 ? endOfText : commaOrEnd;
+
+    return currentToken = token;
+}
+
+JSONReader::TokenType JSONReader::fail (const char* const message)
+{
+    errorResult = Result::fail (String (message) + " at position "
+                                  + String (bufferStartPosition + (position - buffer)));
+    return currentToken = error;
+}
+
+JSONReader::TokenType JSONReader::readKeyword (const char* const keyword, const int length,
+                                               const TokenType token, const bool value)
+{
+    if (! (ensureAvailable (length) && memcmp (position, keyword, (size_t) length) == 0))
+        return fail ("Syntax error");
+
+    position += length;
+    integer = value ? 1 : 0;
+    number = (double) integer;
+    return finishValue (token);
+}
+
+//==============================================================================
+JSONReader::TokenType JSONReader::readString (const TokenType token, const char quoteChar)
+{
+    // The decoded string is written back over the text it came from, starting just
+    // after the opening quote. Until an escape sequence is found, the two are the same,
+    // so nothing needs copying.
+    writePosition = ++position;
+
+    for (;;)
+    {
+        if (writePosition == position)
+        {
+            while (position < bufferEnd && *position != quoteChar && *position != '\\' && *position != 0)
+                ++position;
+
+            writePosition = position;
+        }
+        else
+        {
+            while (position < bufferEnd && *position != quoteChar && *position != '\\' && *position != 0)
+                *writePosition++ = *position++;
+        }
+
+        if (position == bufferEnd)
+        {
+            if (! readMore())
+                return fail ("Unexpected end-of-input in string constant");
+
+            continue;
+        }
+
+        const char c = *position;
+
+        if (c == quoteChar)
+        {
+            *writePosition = 0;
+            ++position;
+            stringValueStart = tokenStart + 1;
+            return token;
+        }
+
+        if (c == 0 || ! readEscapeSequence())
+            return currentToken == error ? error : fail ("Unexpected end-of-input in string constant");
+    }
+}
+
+static int readFourHexDigits (const char* text) noexcept
+{
+    int value = 0;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const int digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) (uint8) text[i]);
+
+        if (digitValue < 0)
+            return -1;
+
+        value = (value << 4) + digitValue;
+    }
+
+    return value;
+}
+
+bool JSONReader::readEscapeSequence()
+{
+    if (! ensureAvailable (2))
+        return false;
+
+    juce_wchar c = (juce_wchar) (uint8) position[1];
+    int length = 2;
+
+    switch (c)
+    {
+        case 'a':  c = '\a'; break;
+        case 'b':  c = '\b'; break;
+        case 'f':  c = '\f'; break;
+        case 'n':  c = '\n'; break;
+        case 'r':  c = '\r'; break;
+        case 't':  c = '\t'; break;
+
+        case 'u':
+        {
+            if (! ensureAvailable (6))
+                return false;
+
+            const int value = readFourHexDigits (position + 2);
+
+            if (value < 0)
+            {
+                fail ("Syntax error in unicode escape sequence");
+                return false;
+            }
+
+            c = (juce_wchar) value;
+            length = 6;
+
+            // If this is the first half of a UTF-16 surrogate pair, combine it with the second half
+            if (c >= 0xd800 && c < 0xdc00 && ensureAvailable (12) && position[6] == '\\' && position[7] == 'u')
+            {
+                const int low = readFourHexDigits (position + 8);
+
+                if (low >= 0xdc00 && low < 0xe000)
+                {
+                    c = (juce_wchar) (0x10000 + ((c - 0xd800) << 10) + (juce_wchar) (low - 0xdc00));
+                    length = 12;
+                }
+            }
+
+            if (c == 0)
+                return false;
+
+            CharPointer_UTF8 dest (writePosition);
+            dest.write (c);
+            writePosition = dest.getAddress();
+            position += length;
+            return true;
+        }
+
+        default:
+            // (any other escaped character, including a quote or slash, stands for itself)
+            break;
+    }
+
+    *writePosition++ = (char) c;
+    position += length;
+    return true;
+}
+
+//==============================================================================
+JSONReader::TokenType JSONReader::readNumber()
+{
+    char* end = position;
+
+    for (;;)
+    {
+        if (end == bufferEnd)
+        {
+            const size_t numScanned = (size_t) (end - position);
+            const bool gotMore = readMore();
+            end = position + numScanned;
+
+            if (! gotMore)
+                break;
+
+            continue;
+        }
+
+        const char c = *end;
+
+        if (! ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'))
+            break;
+
+        ++end;
+    }
+
+    const char* const firstDigit = position + (*position == '-' ? 1 : 0);
+
+    if (firstDigit == end || *firstDigit < '0' || *firstDigit > '9')
+        return fail ("Syntax error");
+
+    const char* digit = firstDigit;
+    uint64 magnitude = 0;
+
+    while (digit < end && *digit >= '0' && *digit <= '9')
+        magnitude = magnitude * 10 + (uint64) (*digit++ - '0');
+
+    if (digit == end)
+    {
+        // A plain integer, which can be converted without any further parsing..
+        integer = (int64) (firstDigit != position ? (0 - magnitude) : magnitude);
+        number = (double) integer;
+        isSmallInteger = (magnitude >> 31) == 0;
+        position = end;
+        return integerValue;
+    }
+
+    // The number's text is copied so it can be null-terminated for readDoubleValue()
+    const size_t numChars = (size_t) (end - position);
+    char localCopy[64];
+    HeapBlock<char> largeCopy;
+    char* text = localCopy;
+
+    if (numChars >= sizeof (localCopy))
+    {
+        largeCopy.malloc (numChars + 1);
+        text = largeCopy;
+    }
+
+    memcpy (text, position, numChars);
+    text[numChars] = 0;
+
+    CharPointer_ASCII t (text);
+    number = CharacterFunctions::readDoubleValue (t);
+
+    if (t.getAddress() != text + numChars)
+        return fail ("Syntax error in number");
+
+    integer = (int64) number;
+    position = end;
+    return doubleValue;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONReaderTests  : public UnitTest
+{
+public:
+    JSONReaderTests() : UnitTest ("JSONReader") {}
+
+    static MemoryBlock toMemoryBlock (const String& text)
+    {
+        return MemoryBlock (text.toRawUTF8(), text.getNumBytesAsUTF8());
+    }
+
+    static bool readsWithoutError (const String& text)
+    {
+        MemoryBlock block (toMemoryBlock (text));
+        JSONReader reader (block);
+
+        for (;;)
+        {
+            const JSONReader::TokenType token = reader.next();
+
+            if (token == JSONReader::endOfInput)  return true;
+            if (token == JSONReader::error)       return false;
+        }
+    }
+
+    // Creates a large document shaped like a preset database
+    static String createLargeDocument (Random& r, int numPresets)
+    {
+        Array<var> presets;
+
+        for (int i = 0; i < numPresets; ++i)
+        {
+            DynamicObject* preset = new DynamicObject();
+            preset->setProperty ("name", "Preset " + String (i) + " \"" + JSONTests::createRandomIdentifier (r) + "\"");
+            preset->setProperty ("id", r.nextInt64());
+            preset->setProperty ("favourite", r.nextBool());
+
+            Array<var> parameters;
+
+            for (int j = 0; j < 16; ++j)
+                parameters.add (r.nextBool() ? var (r.nextInt (128)) : var (r.nextDouble()));
+
+            preset->setProperty ("parameters", parameters);
+            presets.add (preset);
+        }
+
+        return JSON::toString (presets, false);
+    }
+
+    struct Totals
+    {
+        Totals() : numValues (0), numStrings (0), total (0) {}
+
+        void add (const var& v)
+        {
+            ++numValues;
+
+            if (Array<var>* a = v.getArray())
+            {
+                for (int i = 0; i < a->size(); ++i)
+                    add (a->getReference (i));
+            }
+            else if (DynamicObject* o = v.getDynamicObject())
+            {
+                for (int i = 0; i < o->getProperties().size(); ++i)
+                    add (o->getProperties().getValueAt (i));
+            }
+            else if (v.isString())
+            {
+                numStrings += v.toString().length();
+            }
+            else
+            {
+                total += static_cast<double> (v);
+            }
+        }
+
+        void add (JSONReader& reader)
+        {
+            for (;;)
+            {
+                switch (reader.next())
+                {
+                    case JSONReader::startOfObject:
+                    case JSONReader::startOfArray:
+                    case JSONReader::nullValue:     ++numValues; break;
+                    case JSONReader::stringValue:   ++numValues; numStrings += (int) reader.getString().length(); break;
+                    case JSONReader::integerValue:
+                    case JSONReader::doubleValue:
+                    case JSONReader::boolValue:     ++numValues; total += reader.getDoubleValue(); break;
+                    case JSONReader::endOfInput:
+                    case JSONReader::error:         return;
+                    default:                        break;
+                }
+            }
+        }
+
+        int numValues, numStrings;
+        double total;
+    };
+
+    void runTest() override
+    {
+        Random r = getRandom();
+
+        beginTest ("Tokens");
+        {
+            MemoryBlock block (toMemoryBlock ("{ \"a\": [1, -2, 3.5e1, true, false, null, \"x\\ny\"],\r\n \"b\":{}, \"c\": -12345678901234 }"));
+            JSONReader reader (block);
+
+            expect (reader.next() == JSONReader::startOfObject);
+            expect (reader.next() == JSONReader::propertyName && reader.getString() == StringRef ("a"));
+            expect (reader.next() == JSONReader::startOfArray && reader.getDepth() == 2);
+            expect (reader.next() == JSONReader::integerValue && reader.getIntegerValue() == 1);
+            expect (reader.next() == JSONReader::integerValue && reader.getIntegerValue() == -2);
+            expect (reader.next() == JSONReader::doubleValue && reader.getDoubleValue() == 35.0);
+            expect (reader.next() == JSONReader::boolValue && reader.getBoolValue());
+            expect (reader.next() == JSONReader::boolValue && ! reader.getBoolValue());
+            expect (reader.next() == JSONReader::nullValue);
+            expect (reader.next() == JSONReader::stringValue && reader.getString() == StringRef ("x\ny"));
+            expect (reader.next() == JSONReader::endOfArray && reader.getDepth() == 1);
+            expect (reader.next() == JSONReader::propertyName && reader.getString() == StringRef ("b"));
+            expectEquals (reader.getPosition(), (int64) 52);
+            expect (reader.next() == JSONReader::startOfObject);
+            expect (reader.next() == JSONReader::endOfObject);
+            expect (reader.next() == JSONReader::propertyName && reader.getString() == StringRef ("c"));
+            expect (reader.next() == JSONReader::integerValue && reader.getIntegerValue() == -12345678901234LL);
+            expect (reader.getValue().isInt64());
+            expect (reader.next() == JSONReader::endOfObject && reader.getDepth() == 0);
+            expect (reader.next() == JSONReader::endOfInput);
+            expect (reader.next() == JSONReader::endOfInput);
+            expect (reader.getError().wasOk());
+        }
+
+        beginTest ("Escape sequences");
+        {
+            MemoryBlock block (toMemoryBlock ("[\"a\\\"b\\\\c\\/d\\u00e9\\ud83d\\ude00\\q\", 'it\\'s', \"\\ud800x\", \"\"]"));
+            JSONReader reader (block);
+
+            const juce_wchar expected[] = { 'a', '"', 'b', '\\', 'c', '/', 'd', 0xe9, 0x1f600, 'q', 0 };
+
+            expect (reader.next() == JSONReader::startOfArray);
+            expect (reader.next() == JSONReader::stringValue);
+            expectEquals (String (reader.getString()), String (CharPointer_UTF32 (expected)));
+            expect (reader.next() == JSONReader::stringValue && reader.getString() == StringRef ("it's"));
+            expect (reader.getValue() == JSON::parse ("[\"it's\"]")[0]);
+            expect (reader.next() == JSONReader::stringValue);
+            expect (reader.getValue() == JSON::parse ("[\"\\ud800x\"]")[0]);
+            expect (reader.next() == JSONReader::stringValue && reader.getString().isEmpty());
+            expect (reader.next() == JSONReader::endOfArray);
+        }
+
+        beginTest ("Errors");
+        {
+            expect (readsWithoutError (String()));
+            expect (readsWithoutError (" \r\n "));
+            expect (readsWithoutError ("[1, 2,]"));
+            expect (readsWithoutError ("{\"a\": [], }"));
+            expect (readsWithoutError ("\"top-level string\""));
+
+            const char* const invalidDocuments[] = { "[1, 2", "{\"a\" 1}", "[1 2]", "{'a': 1}", "[-]", "[1.2.3]",
+                                                     "[tru]", "[1]x", "[1}", "\"abc", "[\"\\u12G4\"]", "{\"a\": }", "]" };
+
+            for (int i = 0; i < numElementsInArray (invalidDocuments); ++i)
+            {
+                expect (! readsWithoutError (invalidDocuments[i]), invalidDocuments[i]);
+            }
+
+            MemoryBlock block (toMemoryBlock ("[1,\n 2 x]"));
+            JSONReader reader (block);
+            reader.next();
+            expect (reader.getValue() == var());
+            expectEquals (reader.getError().getErrorMessage(), String ("Expected ',' or ']' at position 7"));
+
+            MemoryBlock emptyName (toMemoryBlock ("{\"\": 1}"));
+            JSONReader emptyNameReader (emptyName);
+            emptyNameReader.next();
+            expect (emptyNameReader.getValue() == var() && emptyNameReader.getError().failed());
+        }
+
+        beginTest ("Skipping values");
+        {
+            MemoryBlock block (toMemoryBlock ("{\"skip\": {\"a\": [1, {\"b\": 2}]}, \"alsoSkip\": 4, \"keep\": 3}"));
+            JSONReader reader (block);
+
+            expect (reader.next() == JSONReader::startOfObject);
+            expect (reader.next() == JSONReader::propertyName);
+            reader.skipValue();
+            expect (reader.getCurrentToken() == JSONReader::endOfObject && reader.getDepth() == 1);
+            expect (reader.next() == JSONReader::propertyName);
+            reader.skipValue();
+            expect (reader.getCurrentToken() == JSONReader::integerValue);
+            expect (reader.next() == JSONReader::propertyName && reader.getString() == StringRef ("keep"));
+            expect (reader.next() == JSONReader::integerValue && reader.getIntegerValue() == 3);
+        }
+
+        beginTest ("Compared with JSON::parse");
+        {
+            for (int i = 100; --i >= 0;)
+            {
+                const var v (JSONTests::createRandomVar (r, 0));
+                const bool oneLine = r.nextBool();
+                const String asString (JSON::toString (v, oneLine));
+
+                MemoryBlock block (toMemoryBlock (asString));
+                JSONReader inPlaceReader (block);
+                inPlaceReader.next();
+                expectEquals (JSON::toString (inPlaceReader.getValue(), oneLine), asString);
+                expect (inPlaceReader.next() == JSONReader::endOfInput);
+
+                // (a tiny buffer makes sure that tokens get split across reads)
+                MemoryInputStream in (asString.toRawUTF8(), asString.getNumBytesAsUTF8(), false);
+                JSONReader streamReader (in, (size_t) r.nextInt (100));
+                streamReader.next();
+                expectEquals (JSON::toString (streamReader.getValue(), oneLine), asString);
+                expect (streamReader.next() == JSONReader::endOfInput);
+            }
+        }
+
+        beginTest ("Performance");
+        {
+            const String document (createLargeDocument (r, 20000));
+            const MemoryBlock text (toMemoryBlock (document));
+            const double sizeMB = text.getSize() / (1024.0 * 1024.0);
+
+            Totals parsed, inPlace, streamed;
+            double parseTime = 1.0e9, inPlaceTime = 1.0e9, streamTime = 1.0e9;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                {
+                    MemoryInputStream in (text, false);
+                    const double startTime = Time::getMillisecondCounterHiRes();
+                    const var result (JSON::parse (in));
+                    parseTime = jmin (parseTime, Time::getMillisecondCounterHiRes() - startTime);
+                    parsed = Totals();
+                    parsed.add (result);
+                }
+
+                {
+                    MemoryBlock copy (text);
+                    const double startTime = Time::getMillisecondCounterHiRes();
+                    JSONReader reader (copy);
+                    inPlace = Totals();
+                    inPlace.add (reader);
+                    inPlaceTime = jmin (inPlaceTime, Time::getMillisecondCounterHiRes() - startTime);
+                }
+
+                {
+                    MemoryInputStream in (text, false);
+                    const double startTime = Time::getMillisecondCounterHiRes();
+                    JSONReader reader (in);
+                    streamed = Totals();
+                    streamed.add (reader);
+                    streamTime = jmin (streamTime, Time::getMillisecondCounterHiRes() - startTime);
+                }
+            }
+
+            expectEquals (inPlace.numValues, parsed.numValues);
+            expectEquals (streamed.numValues, parsed.numValues);
+            expectEquals (inPlace.numStrings, parsed.numStrings);
+            expectEquals (streamed.numStrings, parsed.numStrings);
+            expect (inPlace.total == parsed.total && streamed.total == parsed.total);
+
+            logMessage ("Reading " + String (sizeMB, 1) + "MB of JSON: JSON::parse " + String (sizeMB * 1000.0 / parseTime, 1)
+                          + "MB/s, JSONReader in-place " + String (sizeMB * 1000.0 / inPlaceTime, 1)
+                          + "MB/s, JSONReader from a stream " + String (sizeMB * 1000.0 / streamTime, 1) + "MB/s");
+
+            // JSON::parse has to hold a String copy of the whole text (using at least as many
+            // bytes as the UTF-8 data) plus a var for every value, each of which is at least
+            // sizeof (var), with a heap-allocated String, Array or DynamicObject behind many
+            // of them. A JSONReader on a stream only holds its buffer.
+            logMessage ("Memory held while reading: JSON::parse > " + String ((text.getSize() + (size_t) parsed.numValues * sizeof (var)) / 1024)
+                          + "KB for the text and " + String (parsed.numValues) + " vars, JSONReader from a stream "
+                          + String (65536 / 1024) + "KB for its buffer");
+        }
+    }
+};
+
+static JSONReaderTests jsonReaderTests;
+
+#endif
@@ -0,0 +1,224 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_JSONREADER_H_INCLUDED
+#define JUCE_JSONREADER_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Reads JSON-formatted text one token at a time, without building a var for it.
+
+    Each call to next() moves on to the next token and tells you what kind it is, and
+    you can then ask for its value. Because nothing is kept apart from the current
+    token, this can read huge documents while only holding a small buffer of the text
+    in memory.
+
+    Strings and property names are returned as StringRefs which point directly into
+    the reader's buffer. Any escape sequences are decoded in-place, so no String objects
+    get created unless you ask for them. Note that a StringRef which you get from this
+    is only valid until the next call to next().
+
+    e.g.
+    @code
+    FileInputStream in (presetFile);
+    JSONReader reader (in);
+
+    for (;;)
+    {
+        const JSONReader::TokenType token = reader.next();
+
+        if (token == JSONReader::propertyName && reader.getString() == StringRef ("name"))
+            if (reader.next() == JSONReader::stringValue)
+                names.add (reader.getString());
+
+        if (token == JSONReader::endOfInput || token == JSONReader::error)
+            break;
+    }
+    @endcode
+
+    The reader accepts the same syntax as JSON::parse(), except that any kind of
+    value is allowed at the top level, and any text after the end of the top-level
+    value is treated as an error. Text that contains only whitespace produces a
+    single endOfInput token.
+
+    @see JSONWriter, JSON
+*/
+class JUCE_API  JSONReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader which pulls its text from a stream.
+
+        Only a buffer of the text is kept in memory at any time. It starts at the given
+        size, and will only grow if a single string in the text is bigger than it. The
+        stream must not be deleted while the reader is using it.
+
+        To read some read-only data in memory, you can wrap it in a MemoryInputStream.
+    */
+    JSONReader (InputStream& source, size_t initialBufferSize = 65536);
+
+    /** Creates a reader which parses a block of UTF-8 text in-place.
+
+        To avoid copying anything, the strings are decoded and null-terminated within
+        the block itself, so its contents will be modified. The block must not be
+        deleted or resized while the reader is using it.
+    */
+    explicit JSONReader (MemoryBlock& textToParseInPlace);
+
+    /** Destructor. */
+    ~JSONReader();
+
+    //==============================================================================
+    /** The different kinds of token that next() can return. */
+    enum TokenType
+    {
+        startOfObject,
+        endOfObject,
+        startOfArray,
+        endOfArray,
+        propertyName,   /**< The name of an object's property. The property's value is the next token. */
+        stringValue,
+        integerValue,
+        doubleValue,
+        boolValue,
+        nullValue,
+        endOfInput,     /**< The whole top-level value has been read. */
+        error           /**< The text is invalid - use getError() to find out why. */
+    };
+
+    /** Reads the next token from the text.
+        Once this has returned endOfInput or error, it will keep returning the same thing.
+    */
+    TokenType next();
+
+    /** Returns the token that the last call to next() returned. */
+    TokenType getCurrentToken() const noexcept              { return currentToken; }
+
+    /** Returns the text of the current token, if it's a propertyName or stringValue.
+        For other kinds of token, this returns an empty string. The StringRef points into
+        the reader's buffer, so is only valid until next() is called again.
+    */
+    StringRef getString() const noexcept;
+
+    /** Returns the current token's value as an integer.
+        This works for integerValue, doubleValue and boolValue tokens, and returns 0 for
+        anything else.
+    */
+    int64 getIntegerValue() const noexcept;
+
+    /** Returns the current token's value as a double.
+        This works for integerValue, doubleValue and boolValue tokens, and returns 0 for
+        anything else.
+    */
+    double getDoubleValue() const noexcept;
+
+    /** Returns the current token's value as a bool. */
+    bool getBoolValue() const noexcept                      { return getIntegerValue() != 0; }
+
+    /** Returns the current token's value as a var.
+
+        If the current token is the start of an object or array, this reads the whole of
+        it into a var, leaving the reader positioned at its end token. If the current token
+        is a property name, this reads the value which follows it. Integers become int or
+        int64 vars in the same way as they do in JSON::parse().
+
+        If the text turns out to be invalid, this returns var(), and getError() will
+        describe the problem.
+    */
+    var getValue();
+
+    /** Skips over a value that you're not interested in.
+
+        If the current token is the start of an object or array, this moves on to its end
+        token. If the current token is a property name, this skips the value which follows
+        it. Otherwise, it does nothing.
+    */
+    void skipValue();
+
+    /** Returns the number of objects and arrays which contain the current position. */
+    int getDepth() const noexcept                           { return containers.size(); }
+
+    /** Returns the offset in bytes from the start of the text to the current token. */
+    int64 getPosition() const noexcept;
+
+    /** If next() has returned an error, this describes it. */
+    const Result& getError() const noexcept                 { return errorResult; }
+
+private:
+    //==============================================================================
+    enum Expecting
+    {
+        topLevelValue,
+        endOfText,
+        firstPropertyNameOrEnd,
+        colon,
+        propertyValue,
+        firstArrayItemOrEnd,
+        commaOrEnd
+    };
+
+    InputStream* source;
+    HeapBlock<char> ownedBuffer;
+    char* buffer;
+    size_t bufferSize;
+    char* tokenStart;
+    char* position;
+    char* writePosition;
+    char* bufferEnd;
+    int64 bufferStartPosition;
+
+    Array<char> containers;
+    Expecting expecting;
+    TokenType currentToken;
+    Result errorResult;
+
+    const char* stringValueStart;
+    int64 integer;
+    double number;
+    bool isSmallInteger;
+
+    bool skipWhitespace();
+    bool readMore();
+    bool ensureAvailable (int numBytes);
+    TokenType readValue();
+    TokenType readString (TokenType, char quoteChar);
+    TokenType readNumber();
+    TokenType readKeyword (const char* keyword, int length, TokenType, bool value);
+    TokenType openContainer (char type, TokenType);
+    TokenType closeContainer (TokenType);
+    TokenType finishValue (TokenType);
+    TokenType fail (const char* message);
+    bool readEscapeSequence();
+    var readContainer();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONReader)
+};
+
+
+#endif   // JUCE_JSONREADER_H_INCLUDED
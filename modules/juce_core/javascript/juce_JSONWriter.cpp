@@ -0,0 +1,354 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+JSONWriter::JSONWriter (OutputStream& destination, const bool oneLine)
+    : out (destination), allOnOneLine (oneLine), hasWrittenName (false)
+{
+}
+
+JSONWriter::~JSONWriter()
+{
+    // You need to end all the objects and arrays that you start!
+    jassert (levels.size() == 0);
+}
+
+//==============================================================================
+void JSONWriter::startItem()
+{
+    Level& level = levels.getReference (levels.size() - 1);
+
+    if (level.numItems++ > 0)
+    {
+        if (allOnOneLine)
+            out << ", ";
+        else
+            out << ',' << newLine;
+    }
+    else if (! (allOnOneLine || level.isObject))
+    {
+        out << newLine;
+    }
+
+    if (! allOnOneLine)
+        JSONFormatter::writeSpaces (out, levels.size() * JSONFormatter::indentSize);
+}
+
+void JSONWriter::startValue()
+{
+    if (levels.size() == 0)
+        return;
+
+    if (levels.getLast().isObject)
+    {
+        // Inside an object, you need to call writeName() before each value!
+        jassert (hasWrittenName);
+        hasWrittenName = false;
+    }
+    else
+    {
+        startItem();
+    }
+}
+
+void JSONWriter::startContainer (const bool isObject)
+{
+    startValue();
+
+    out << (isObject ? '{' : '[');
+
+    if (isObject && ! allOnOneLine)
+        out << newLine;
+
+    const Level level = { isObject, 0 };
+    levels.add (level);
+}
+
+void JSONWriter::endContainer (const bool isObject)
+{
+    // This doesn't match the object or array that was started most recently!
+    jassert (levels.size() > 0 && levels.getLast().isObject == isObject && ! hasWrittenName);
+
+    const Level level (levels.getLast());
+    levels.removeLast();
+
+    if (! allOnOneLine && (level.isObject || level.numItems > 0))
+    {
+        if (level.numItems > 0)
+            out << newLine;
+
+        JSONFormatter::writeSpaces (out, levels.size() * JSONFormatter::indentSize);
+    }
+
+    out << (isObject ? '}' : ']');
+}
+
+void JSONWriter::startObject()      { startContainer (true); }
+void JSONWriter::endObject()        { endContainer (true); }
+void JSONWriter::startArray()       { startContainer (false); }
+void JSONWriter::endArray()         { endContainer (false); }
+
+void JSONWriter::writeName (StringRef propertyName)
+{
+    // Names can only be written inside an object, and each one must be followed by a value!
+    jassert (levels.size() > 0 && levels.getLast().isObject && ! hasWrittenName);
+
+    startItem();
+    out << '"';
+    JSONFormatter::writeString (out, propertyName.text);
+    out << "\": ";
+    hasWrittenName = true;
+}
+
+//==============================================================================
+void JSONWriter::writeString (StringRef text)
+{
+    startValue();
+    out << '"';
+    JSONFormatter::writeString (out, text.text);
+    out << '"';
+}
+
+void JSONWriter::writeInt (const int value)
+{
+    startValue();
+    out << value;
+}
+
+void JSONWriter::writeInt64 (const int64 value)
+{
+    startValue();
+    out << value;
+}
+
+void JSONWriter::writeDouble (const double value)
+{
+    startValue();
+    out << String (value, 20);
+}
+
+void JSONWriter::writeBool (const bool value)
+{
+    startValue();
+    out << (value ? "true" : "false");
+}
+
+void JSONWriter::writeNull()
+{
+    startValue();
+    out << "null";
+}
+
+void JSONWriter::writeVar (const var& value)
+{
+    startValue();
+    JSONFormatter::write (out, value, levels.size() * JSONFormatter::indentSize, allOnOneLine);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JSONWriterTests  : public UnitTest
+{
+public:
+    JSONWriterTests() : UnitTest ("JSONWriter") {}
+
+    // Writes a var one value at a time, rather than using writeVar()
+    static void write (JSONWriter& writer, const var& v)
+    {
+        if (const Array<var>* a = v.getArray())
+        {
+            writer.startArray();
+
+            for (int i = 0; i < a->size(); ++i)
+                write (writer, a->getReference (i));
+
+            writer.endArray();
+        }
+        else if (DynamicObject* o = v.getDynamicObject())
+        {
+            const NamedValueSet& properties = o->getProperties();
+            writer.startObject();
+
+            for (int i = 0; i < properties.size(); ++i)
+            {
+                writer.writeName (properties.getName (i).toString());
+                write (writer, properties.getValueAt (i));
+            }
+
+            writer.endObject();
+        }
+        else if (v.isString())      writer.writeString (v.toString());
+        else if (v.isInt())         writer.writeInt (v);
+        else if (v.isInt64())       writer.writeInt64 (v);
+        else if (v.isDouble())      writer.writeDouble (v);
+        else if (v.isBool())        writer.writeBool (v);
+        else                        writer.writeNull();
+    }
+
+    static String writeToString (const var& v, bool oneLine, bool useWriteVar)
+    {
+        MemoryOutputStream mo;
+
+        {
+            JSONWriter writer (mo, oneLine);
+
+            if (useWriteVar)
+            {
+                writer.startArray();
+                writer.writeVar (v);
+                writer.endArray();
+            }
+            else
+            {
+                write (writer, v);
+            }
+        }
+
+        return mo.toUTF8();
+    }
+
+    void runTest() override
+    {
+        Random r = getRandom();
+
+        beginTest ("Formatting");
+        {
+            MemoryOutputStream mo;
+
+            {
+                JSONWriter writer (mo, true);
+                writer.startObject();
+                writer.writeName ("a");
+                writer.startArray();
+                writer.writeInt (1);
+                writer.writeDouble (2.5);
+                writer.writeBool (false);
+                writer.writeNull();
+                writer.startArray();
+                writer.endArray();
+                writer.endArray();
+                writer.writeName ("b\"");
+                writer.writeString ("x\ny");
+                writer.writeName ("c");
+                writer.startObject();
+                writer.endObject();
+                expectEquals (writer.getDepth(), 1);
+                writer.endObject();
+            }
+
+            expectEquals (mo.toString(), String ("{\"a\": [1, 2.5, false, null, []], \"b\\\"\": \"x\\ny\", \"c\": {}}"));
+        }
+
+        beginTest ("Compared with JSON::toString");
+        {
+            for (int i = 100; --i >= 0;)
+            {
+                const var v (JSONTests::createRandomVar (r, 0));
+                const bool oneLine = r.nextBool();
+
+                expectEquals (writeToString (v, oneLine, false), JSON::toString (v, oneLine));
+                expectEquals (writeToString (v, oneLine, true), JSON::toString (Array<var> (&v, 1), oneLine));
+            }
+        }
+
+        beginTest ("Performance");
+        {
+            const int numPresets = 20000, numParameters = 16;
+            double toStringTime = 1.0e9, writerTime = 1.0e9;
+            size_t toStringSize = 0, writerSize = 0;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                {
+                    MemoryOutputStream mo;
+                    const double startTime = Time::getMillisecondCounterHiRes();
+                    Array<var> presets;
+
+                    for (int j = 0; j < numPresets; ++j)
+                    {
+                        DynamicObject* preset = new DynamicObject();
+                        preset->setProperty ("name", "Preset " + String (j));
+                        preset->setProperty ("id", (int64) j * 1000003);
+
+                        Array<var> parameters;
+
+                        for (int k = 0; k < numParameters; ++k)
+                            parameters.add (k * 0.25);
+
+                        preset->setProperty ("parameters", parameters);
+                        presets.add (preset);
+                    }
+
+                    JSON::writeToStream (mo, presets);
+                    toStringTime = jmin (toStringTime, Time::getMillisecondCounterHiRes() - startTime);
+                    toStringSize = mo.getDataSize();
+                }
+
+                {
+                    MemoryOutputStream mo;
+                    const double startTime = Time::getMillisecondCounterHiRes();
+                    JSONWriter writer (mo);
+                    writer.startArray();
+
+                    for (int j = 0; j < numPresets; ++j)
+                    {
+                        writer.startObject();
+                        writer.writeName ("name");
+                        writer.writeString ("Preset " + String (j));
+                        writer.writeName ("id");
+                        writer.writeInt64 ((int64) j * 1000003);
+                        writer.writeName ("parameters");
+                        writer.startArray();
+
+                        for (int k = 0; k < numParameters; ++k)
+                            writer.writeDouble (k * 0.25);
+
+                        writer.endArray();
+                        writer.endObject();
+                    }
+
+                    writer.endArray();
+                    writerTime = jmin (writerTime, Time::getMillisecondCounterHiRes() - startTime);
+                    writerSize = mo.getDataSize();
+                }
+            }
+
+            expectEquals ((int64) writerSize, (int64) toStringSize);
+
+            logMessage ("Writing " + String (toStringSize / (1024.0 * 1024.0), 1) + "MB of JSON: building a var and using JSON::writeToStream "
+                          + String (toStringTime, 1) + "ms, JSONWriter " + String (writerTime, 1) + "ms. Apart from the output, "
+                          + "the var held " + String (1 + numPresets * (numParameters + 4)) + " values, and JSONWriter held "
+                          + String ((int) sizeof (JSONWriter)) + " bytes and one array element per nesting level");
+        }
+    }
+};
+
+static JSONWriterTests jsonWriterTests;
+
+#endif
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_JSONWRITER_H_INCLUDED
+#define JUCE_JSONWRITER_H_INCLUDED
+
+
+//==============================================================================
+/**
+    Writes JSON-formatted text directly to a stream, one value at a time.
+
+    This lets you write out large amounts of data without first having to build
+    a var to hold all of it. The text that it produces is formatted exactly the same
+    way as JSON::toString() or JSON::writeToStream() would format the equivalent var.
+
+    e.g.
+    @code
+    JSONWriter writer (out);
+    writer.startArray();
+
+    for (int i = 0; i < presets.size(); ++i)
+    {
+        writer.startObject();
+        writer.writeName ("name");
+        writer.writeString (presets[i]->name);
+        writer.writeName ("gain");
+        writer.writeDouble (presets[i]->gain);
+        writer.endObject();
+    }
+
+    writer.endArray();
+    @endcode
+
+    Inside an object, each value must be preceded by a call to writeName(). Every
+    object and array must be ended before the writer is deleted.
+
+    @see JSONReader, JSON
+*/
+class JUCE_API  JSONWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer which will write to the given stream.
+        The stream must not be deleted while the writer is using it.
+        If allOnOneLine is true, the text is written without any line-breaks or indentation.
+    */
+    JSONWriter (OutputStream& destination, bool allOnOneLine = false);
+
+    /** Destructor. */
+    ~JSONWriter();
+
+    //==============================================================================
+    /** Begins writing an object. Call endObject() when all its properties are written. */
+    void startObject();
+
+    /** Finishes the object that was started by the last call to startObject(). */
+    void endObject();
+
+    /** Begins writing an array. Call endArray() when all its items are written. */
+    void startArray();
+
+    /** Finishes the array that was started by the last call to startArray(). */
+    void endArray();
+
+    /** Writes the name of an object's property. This must be followed by its value. */
+    void writeName (StringRef propertyName);
+
+    //==============================================================================
+    /** Writes a string value, adding any escape sequences that it needs. */
+    void writeString (StringRef text);
+
+    /** Writes an integer value. */
+    void writeInt (int value);
+
+    /** Writes a 64-bit integer value. */
+    void writeInt64 (int64 value);
+
+    /** Writes a floating-point value. */
+    void writeDouble (double value);
+
+    /** Writes a bool value. */
+    void writeBool (bool value);
+
+    /** Writes a null value. */
+    void writeNull();
+
+    /** Writes any var as a value, using the same format as JSON::toString(). */
+    void writeVar (const var& value);
+
+    //==============================================================================
+    /** Returns the number of objects and arrays that have been started but not yet ended. */
+    int getDepth() const noexcept               { return levels.size(); }
+
+private:
+    //==============================================================================
+    struct Level
+    {
+        bool isObject;
+        int numItems;
+    };
+
+    OutputStream& out;
+    const bool allOnOneLine;
+    Array<Level> levels;
+    bool hasWrittenName;
+
+    void startItem();
+    void startValue();
+    void startContainer (bool isObject);
+    void endContainer (bool isObject);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONWriter)
+};
+
+
+#endif   // JUCE_JSONWRITER_H_INCLUDED
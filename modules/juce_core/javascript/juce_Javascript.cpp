@@ -65,7 +65,7 @@ namespace TokenTypes
 //==============================================================================
 struct JavascriptEngine::RootObject   : public DynamicObject
 {
-    RootObject()
+    RootObject()  : ticksUntilTimeoutCheck (0), useBytecode (true)
     {
         setMethod ("exec",       exec);
         setMethod ("eval",       eval);
@@ -77,20 +77,38 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     }
 
     Time timeout;
+    int ticksUntilTimeoutCheck;
+    bool useBytecode;
 
     typedef const var::NativeFunctionArgs& Args;
     typedef const char* TokenType;
 
+    struct RegisterFile;
+    struct CompiledCode;
+    struct Compiler;
+
     void execute (const String& code)
     {
         ExpressionTreeBuilder tb (code);
-        ScopedPointer<BlockStatement> (tb.parseStatementList())->perform (Scope (nullptr, this, this), nullptr);
+        ScopedPointer<BlockStatement> block (tb.parseStatementList());
+        const Scope scope (nullptr, this, this);
+
+        if (useBytecode)
+            CompiledCode (*block).run (scope);
+        else
+            block->perform (scope, nullptr);
     }
 
     var evaluate (const String& code)
     {
         ExpressionTreeBuilder tb (code);
-        return ExpPtr (tb.parseExpression())->getResult (Scope (nullptr, this, this));
+        ExpPtr expression (tb.parseExpression());
+        const Scope scope (nullptr, this, this);
+
+        if (useBytecode)
+            return CompiledCode (*expression).run (scope);
+
+        return expression->getResult (scope);
     }
 
     //==============================================================================
@@ -108,6 +126,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     static Identifier getPrototypeIdentifier()                { static const Identifier i ("prototype"); return i; }
     static var* getPropertyPointer (DynamicObject* o, const Identifier& i) noexcept   { return o->getProperties().getVarPointer (i); }
 
+    // Looks up a property, first trying the index at which it was found last time
+    static var* getPropertyPointer (DynamicObject* o, const Identifier& i, int& cachedIndex) noexcept
+    {
+        const NamedValueSet& props = o->getProperties();
+
+        if (! (isPositiveAndBelow (cachedIndex, props.size()) && props.getName (cachedIndex) == i))
+            if ((cachedIndex = props.indexOf (i)) < 0)
+                return nullptr;
+
+        return props.getVarPointerAt (cachedIndex);
+    }
+
     //==============================================================================
     struct CodeLocation
     {
@@ -134,11 +164,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     //==============================================================================
     struct Scope
     {
-        Scope (const Scope* p, RootObject* r, DynamicObject* s) noexcept : parent (p), root (r), scope (s) {}
+        Scope (const Scope* p, RootObject* r, DynamicObject* s) noexcept : parent (p), root (r), scope (s), registers (nullptr) {}
 
         const Scope* parent;
         ReferenceCountedObjectPtr<RootObject> root;
         DynamicObject::Ptr scope;
+        mutable RegisterFile* registers; // set while some bytecode is keeping this scope's variables in registers
 
         var findFunctionCall (const CodeLocation& location, const var& targetObject, const Identifier& functionName) const
         {
@@ -184,6 +215,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         var findSymbolInParentScopes (const Identifier& name) const
         {
+            if (registers != nullptr)
+                registers->writeAll();
+
             if (const var* v = getPropertyPointer (scope, name))
                 return *v;
 
@@ -222,6 +256,16 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             if (Time::getCurrentTime() > root->timeout)
                 location.throwError ("Execution timed-out");
         }
+
+        // Reading the clock costs more than a typical loop iteration, so the bytecode only does it every so often
+        void checkTimeOutOccasionally (const CodeLocation& location) const
+        {
+            if (--(root->ticksUntilTimeoutCheck) <= 0)
+            {
+                root->ticksUntilTimeoutCheck = 64;
+                checkTimeOut (location);
+            }
+        }
     };
 
     //==============================================================================
@@ -232,6 +276,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         enum ResultCode  { ok = 0, returnWasHit, breakWasHit, continueWasHit };
         virtual ResultCode perform (const Scope&, var*) const  { return ok; }
+        virtual void compile (Compiler&) const  {}
+        virtual void findVariableDeclarations (Array<Identifier>&) const  {}
 
         CodeLocation location;
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Statement)
@@ -244,7 +290,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         virtual var getResult (const Scope&) const            { return var::undefined(); }
         virtual void assign (const Scope&, const var&) const  { location.throwError ("Cannot assign to this expression!"); }
 
+        // Anything without its own bytecode is compiled into an instruction that calls getResult() or assign()
+        virtual void compileResult (Compiler& c) const         { c.emitNode (CompiledCode::evaluateNode, this, 1); }
+        virtual void compileAssignment (Compiler& c) const     { c.emitNode (CompiledCode::assignNode, this, 0); }
+        virtual bool getConstantValue (var&) const             { return false; }
+
         ResultCode perform (const Scope& s, var*) const override  { getResult (s); return ok; }
+        void compile (Compiler& c) const override                  { compileResult (c); c.emit (CompiledCode::popValue, -1); }
     };
 
     typedef ScopedPointer<Expression> ExpPtr;
@@ -262,6 +314,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return ok;
         }
 
+        void compile (Compiler& c) const override
+        {
+            for (int i = 0; i < statements.size(); ++i)
+                statements.getUnchecked(i)->compile (c);
+        }
+
+        void findVariableDeclarations (Array<Identifier>& names) const override
+        {
+            for (int i = 0; i < statements.size(); ++i)
+                statements.getUnchecked(i)->findVariableDeclarations (names);
+        }
+
         OwnedArray<Statement> statements;
     };
 
@@ -274,6 +338,31 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return (condition->getResult(s) ? trueBranch : falseBranch)->perform (s, returnedValue);
         }
 
+        void compile (Compiler& c) const override
+        {
+            var constant;
+
+            if (condition->getConstantValue (constant))
+            {
+                (constant ? trueBranch : falseBranch)->compile (c);
+                return;
+            }
+
+            condition->compileResult (c);
+            const int elseJump = c.emitJump (CompiledCode::jumpIfFalse, -1);
+            trueBranch->compile (c);
+            const int endJump = c.emitJump (CompiledCode::jump, 0);
+            c.setJumpTarget (elseJump);
+            falseBranch->compile (c);
+            c.setJumpTarget (endJump);
+        }
+
+        void findVariableDeclarations (Array<Identifier>& names) const override
+        {
+            trueBranch->findVariableDeclarations (names);
+            falseBranch->findVariableDeclarations (names);
+        }
+
         ExpPtr condition;
         ScopedPointer<Statement> trueBranch, falseBranch;
     };
@@ -288,6 +377,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return ok;
         }
 
+        void compile (Compiler& c) const override
+        {
+            initialiser->compileResult (c);
+            c.emitDeclaration (name);
+        }
+
+        void findVariableDeclarations (Array<Identifier>& names) const override  { names.addIfNotAlreadyThere (name); }
+
         Identifier name;
         ExpPtr initialiser;
     };
@@ -317,6 +414,62 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return ok;
         }
 
+        void compile (Compiler& c) const override
+        {
+            initialiser->compile (c);
+
+            var constant;
+            const bool conditionIsConstant = condition->getConstantValue (constant);
+
+            Compiler::Loop loop (c);
+            const int start = c.getPosition();
+
+            if (! isDoLoop)
+            {
+                if (! conditionIsConstant)
+                {
+                    condition->compileResult (c);
+                    loop.breakJumps.add (c.emitJump (CompiledCode::jumpIfFalse, -1));
+                }
+                else if (! constant)
+                {
+                    loop.breakJumps.add (c.emitJump (CompiledCode::jump, 0));
+                }
+            }
+
+            c.emitNode (CompiledCode::checkTimeOut, this, 0);
+            body->compile (c);
+
+            if (isDoLoop)
+            {
+                iterator->compile (c);
+
+                if (! conditionIsConstant)
+                {
+                    condition->compileResult (c);
+                    c.emit (CompiledCode::jumpIfTrue, start, -1);
+                }
+                else if (constant)
+                {
+                    c.emit (CompiledCode::jump, start, 0);
+                }
+
+                loop.breakJumps.add (c.emitJump (CompiledCode::jump, 0));
+            }
+
+            // a 'continue' in a do-loop skips the condition, just like perform() does
+            c.setJumpTargets (loop.continueJumps);
+            iterator->compile (c);
+            c.emit (CompiledCode::jump, start, 0);
+            c.setJumpTargets (loop.breakJumps);
+        }
+
+        void findVariableDeclarations (Array<Identifier>& names) const override
+        {
+            initialiser->findVariableDeclarations (names);
+            body->findVariableDeclarations (names);
+        }
+
         ScopedPointer<Statement> initialiser, iterator, body;
         ExpPtr condition;
         bool isDoLoop;
@@ -332,6 +485,19 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return returnWasHit;
         }
 
+        void compile (Compiler& c) const override
+        {
+            if (c.isFunctionBody)
+            {
+                returnValue->compileResult (c);
+                c.emit (CompiledCode::returnResult, -1);
+            }
+            else
+            {
+                c.emit (CompiledCode::endOfCode, 0);
+            }
+        }
+
         ExpPtr returnValue;
     };
 
@@ -339,18 +505,22 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         BreakStatement (const CodeLocation& l) noexcept : Statement (l) {}
         ResultCode perform (const Scope&, var*) const override  { return breakWasHit; }
+        void compile (Compiler& c) const override                { c.compileBreak(); }
     };
 
     struct ContinueStatement  : public Statement
     {
         ContinueStatement (const CodeLocation& l) noexcept : Statement (l) {}
         ResultCode perform (const Scope&, var*) const override  { return continueWasHit; }
+        void compile (Compiler& c) const override                { c.compileContinue(); }
     };
 
     struct LiteralValue  : public Expression
     {
         LiteralValue (const CodeLocation& l, const var& v) noexcept : Expression (l), value (v) {}
-        var getResult (const Scope&) const override   { return value; }
+        var getResult (const Scope&) const override          { return value; }
+        void compileResult (Compiler& c) const override      { c.emitConstant (value); }
+        bool getConstantValue (var& result) const override   { result = value; return true; }
         var value;
     };
 
@@ -368,6 +538,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 s.root->setProperty (name, newValue);
         }
 
+        void compileResult (Compiler& c) const override      { c.emitLoad (name); }
+        void compileAssignment (Compiler& c) const override  { c.emitStore (name); }
+
         Identifier name;
     };
 
@@ -377,7 +550,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         var getResult (const Scope& s) const override
         {
-            var p (parent->getResult (s));
+            int propertyIndex = -1;
+            return getProperty (parent->getResult (s), propertyIndex);
+        }
+
+        var getProperty (const var& p, int& propertyIndex) const
+        {
             static const Identifier lengthID ("length");
 
             if (child == lengthID)
@@ -387,7 +565,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             }
 
             if (DynamicObject* o = p.getDynamicObject())
-                if (const var* v = getPropertyPointer (o, child))
+                if (const var* v = getPropertyPointer (o, child, propertyIndex))
                     return *v;
 
             return var::undefined();
@@ -401,6 +579,18 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 Expression::assign (s, newValue);
         }
 
+        void compileResult (Compiler& c) const override
+        {
+            parent->compileResult (c);
+            c.emit (CompiledCode::loadProperty, c.addNode (this), c.addCaches (1), 0);
+        }
+
+        void compileAssignment (Compiler& c) const override
+        {
+            parent->compileResult (c);
+            c.emitNode (CompiledCode::storeProperty, this, -1);
+        }
+
         ExpPtr parent;
         Identifier child;
     };
@@ -436,6 +626,23 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             Expression::assign (s, newValue);
         }
 
+        void compileResult (Compiler& c) const override
+        {
+            object->compileResult (c);
+            const int notAnArray = c.emitJump (CompiledCode::jumpIfNotArray, 0);
+            index->compileResult (c);
+            c.emit (CompiledCode::loadElement, -1);
+            c.setJumpTarget (notAnArray);
+        }
+
+        void compileAssignment (Compiler& c) const override
+        {
+            object->compileResult (c);
+            c.emitNode (CompiledCode::checkArrayAssignment, this, 0);
+            index->compileResult (c);
+            c.emit (CompiledCode::storeElement, -2);
+        }
+
         ExpPtr object, index;
     };
 
@@ -444,6 +651,22 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         BinaryOperatorBase (const CodeLocation& l, ExpPtr& a, ExpPtr& b, TokenType op) noexcept
             : Expression (l), lhs (a), rhs (b), operation (op) {}
 
+        void compileOperands (Compiler& c) const
+        {
+            lhs->compileResult (c);
+            rhs->compileResult (c);
+        }
+
+        void compileShortCircuit (Compiler& c, bool skipIfTrue) const
+        {
+            lhs->compileResult (c);
+            c.emit (CompiledCode::convertToBool, 0);
+            const int skip = c.emitJump (skipIfTrue ? CompiledCode::jumpIfTrueOrPop : CompiledCode::jumpIfFalseOrPop, -1);
+            rhs->compileResult (c);
+            c.emit (CompiledCode::convertToBool, 0);
+            c.setJumpTarget (skip);
+        }
+
         ExpPtr lhs, rhs;
         TokenType operation;
     };
@@ -462,7 +685,11 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         var getResult (const Scope& s) const override
         {
             var a (lhs->getResult (s)), b (rhs->getResult (s));
+            return apply (a, b);
+        }
 
+        var apply (const var& a, const var& b) const
+        {
             if ((a.isUndefined() || a.isVoid()) && (b.isUndefined() || b.isVoid()))
                 return getWithUndefinedArg();
 
@@ -475,6 +702,58 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return getWithStrings (a.toString(), b.toString());
         }
 
+        void compileResult (Compiler& c) const override
+        {
+            var constant;
+
+            if (getConstantValue (constant))
+            {
+                c.emitConstant (constant);
+                return;
+            }
+
+            lhs->compileResult (c);
+            rhs->compileResult (c);
+            c.emit (CompiledCode::binaryOperation, c.addNode (this), getOperationType(), -1);
+        }
+
+        bool getConstantValue (var& result) const override
+        {
+            var a, b;
+
+            if (lhs->getConstantValue (a) && rhs->getConstantValue (b))
+            {
+                // if the operation fails, the error has to be thrown when the code runs, not now
+                try { result = apply (a, b); return true; }
+                catch (String&) {}
+            }
+
+            return false;
+        }
+
+        int getOperationType() const noexcept
+        {
+            if (operation == TokenTypes::plus)                return CompiledCode::addition;
+            if (operation == TokenTypes::minus)               return CompiledCode::subtraction;
+            if (operation == TokenTypes::times)               return CompiledCode::multiplication;
+            if (operation == TokenTypes::divide)              return CompiledCode::division;
+            if (operation == TokenTypes::modulo)              return CompiledCode::modulo;
+            if (operation == TokenTypes::bitwiseAnd)          return CompiledCode::bitwiseAnd;
+            if (operation == TokenTypes::bitwiseOr)           return CompiledCode::bitwiseOr;
+            if (operation == TokenTypes::bitwiseXor)          return CompiledCode::bitwiseXor;
+            if (operation == TokenTypes::leftShift)           return CompiledCode::leftShift;
+            if (operation == TokenTypes::rightShift)          return CompiledCode::rightShift;
+            if (operation == TokenTypes::rightShiftUnsigned)  return CompiledCode::rightShiftUnsigned;
+            if (operation == TokenTypes::lessThan)            return CompiledCode::lessThan;
+            if (operation == TokenTypes::lessThanOrEqual)     return CompiledCode::lessThanOrEqual;
+            if (operation == TokenTypes::greaterThan)         return CompiledCode::greaterThan;
+            if (operation == TokenTypes::greaterThanOrEqual)  return CompiledCode::greaterThanOrEqual;
+            if (operation == TokenTypes::equals)              return CompiledCode::equals;
+            if (operation == TokenTypes::notEquals)           return CompiledCode::notEquals;
+
+            return CompiledCode::otherOperation;
+        }
+
         var throwError (const char* typeName) const
             { location.throwError (getTokenName (operation) + " is not allowed on the " + typeName + " type"); return var(); }
     };
@@ -606,24 +885,28 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         LogicalAndOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::logicalAnd) {}
         var getResult (const Scope& s) const override       { return lhs->getResult (s) && rhs->getResult (s); }
+        void compileResult (Compiler& c) const override     { compileShortCircuit (c, false); }
     };
 
     struct LogicalOrOp  : public BinaryOperatorBase
     {
         LogicalOrOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::logicalOr) {}
         var getResult (const Scope& s) const override       { return lhs->getResult (s) || rhs->getResult (s); }
+        void compileResult (Compiler& c) const override     { compileShortCircuit (c, true); }
     };
 
     struct TypeEqualsOp  : public BinaryOperatorBase
     {
         TypeEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::typeEquals) {}
         var getResult (const Scope& s) const override       { return areTypeEqual (lhs->getResult (s), rhs->getResult (s)); }
+        void compileResult (Compiler& c) const override     { compileOperands (c); c.emit (CompiledCode::typeEquals, -1); }
     };
 
     struct TypeNotEqualsOp  : public BinaryOperatorBase
     {
         TypeNotEqualsOp (const CodeLocation& l, ExpPtr& a, ExpPtr& b) noexcept : BinaryOperatorBase (l, a, b, TokenTypes::typeNotEquals) {}
         var getResult (const Scope& s) const override       { return ! areTypeEqual (lhs->getResult (s), rhs->getResult (s)); }
+        void compileResult (Compiler& c) const override     { compileOperands (c); c.emit (CompiledCode::typeNotEquals, -1); }
     };
 
     struct ConditionalOp  : public Expression
@@ -633,6 +916,40 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         var getResult (const Scope& s) const override              { return (condition->getResult (s) ? trueBranch : falseBranch)->getResult (s); }
         void assign (const Scope& s, const var& v) const override  { (condition->getResult (s) ? trueBranch : falseBranch)->assign (s, v); }
 
+        void compileResult (Compiler& c) const override             { compileBranches (c, false); }
+        void compileAssignment (Compiler& c) const override         { compileBranches (c, true); }
+
+        void compileBranches (Compiler& c, bool isAssignment) const
+        {
+            var constant;
+
+            if (condition->getConstantValue (constant))
+            {
+                compileBranch (c, constant ? *trueBranch : *falseBranch, isAssignment);
+                return;
+            }
+
+            condition->compileResult (c);
+            const int elseJump = c.emitJump (CompiledCode::jumpIfFalse, -1);
+            compileBranch (c, *trueBranch, isAssignment);
+            const int endJump = c.emitJump (CompiledCode::jump, 0);
+            c.setJumpTarget (elseJump);
+
+            if (! isAssignment)
+                c.adjustStackDepth (-1); // only one of the branches leaves its result on the stack
+
+            compileBranch (c, *falseBranch, isAssignment);
+            c.setJumpTarget (endJump);
+        }
+
+        static void compileBranch (Compiler& c, const Expression& e, bool isAssignment)
+        {
+            if (isAssignment)
+                e.compileAssignment (c);
+            else
+                e.compileResult (c);
+        }
+
         ExpPtr condition, trueBranch, falseBranch;
     };
 
@@ -647,6 +964,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return value;
         }
 
+        void compileResult (Compiler& c) const override
+        {
+            newValue->compileResult (c);
+            target->compileAssignment (c);
+        }
+
         ExpPtr target, newValue;
     };
 
@@ -662,6 +985,12 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return value;
         }
 
+        void compileResult (Compiler& c) const override
+        {
+            newValue->compileResult (c);
+            target->compileAssignment (c);
+        }
+
         Expression* target; // Careful! this pointer aliases a sub-term of newValue!
         ExpPtr newValue;
         TokenType op;
@@ -677,6 +1006,27 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             target->assign (s, newValue->getResult (s));
             return oldValue;
         }
+
+        void compileResult (Compiler& c) const override
+        {
+            target->compileResult (c);
+            SelfAssignment::compileResult (c);
+            c.emit (CompiledCode::popValue, -1);
+        }
+
+        void compile (Compiler& c) const override
+        {
+            // As a statement, the old value is unused, and reading a plain variable has no side-effects
+            if (dynamic_cast<const UnqualifiedName*> (target) != nullptr)
+            {
+                SelfAssignment::compileResult (c);
+                c.emit (CompiledCode::popValue, -1);
+            }
+            else
+            {
+                SelfAssignment::compile (c);
+            }
+        }
     };
 
     struct FunctionCall  : public Expression
@@ -695,6 +1045,25 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return invokeFunction (s, function, var (s.scope));
         }
 
+        void compileResult (Compiler& c) const override
+        {
+            if (const DotOperator* dot = dynamic_cast<const DotOperator*> (object.get()))
+            {
+                dot->parent->compileResult (c);
+                c.emitNode (CompiledCode::findMethod, this, 1);
+            }
+            else
+            {
+                c.emit (CompiledCode::pushScope, 1);
+                object->compileResult (c);
+            }
+
+            for (int i = 0; i < arguments.size(); ++i)
+                arguments.getUnchecked(i)->compileResult (c);
+
+            c.emit (CompiledCode::callFunction, c.addNode (this), arguments.size(), -1 - arguments.size());
+        }
+
         var invokeFunction (const Scope& s, const var& function, const var& thisObject) const
         {
             s.checkTimeOut (location);
@@ -703,7 +1072,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             for (int i = 0; i < arguments.size(); ++i)
                 argVars.add (arguments.getUnchecked(i)->getResult (s));
 
-            const var::NativeFunctionArgs args (thisObject, argVars.begin(), argVars.size());
+            return invokeWithArguments (s, function, thisObject, argVars.begin(), argVars.size());
+        }
+
+        var invokeWithArguments (const Scope& s, const var& function, const var& thisObject,
+                                 const var* argVars, int numArgs) const
+        {
+            const var::NativeFunctionArgs args (thisObject, argVars, numArgs);
 
             if (var::NativeFunction nativeFunction = function.getNativeFunction())
                 return nativeFunction (args);
@@ -744,6 +1119,8 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             return newObject.get();
         }
+
+        void compileResult (Compiler& c) const override  { Expression::compileResult (c); }
     };
 
     struct ObjectDeclaration  : public Expression
@@ -760,6 +1137,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return newObject.get();
         }
 
+        void compileResult (Compiler& c) const override
+        {
+            for (int i = 0; i < initialisers.size(); ++i)
+                initialisers.getUnchecked(i)->compileResult (c);
+
+            c.emitNode (CompiledCode::createObject, this, 1 - initialisers.size());
+        }
+
         Array<Identifier> names;
         OwnedArray<Expression> initialisers;
     };
@@ -778,6 +1163,14 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             return a;
         }
 
+        void compileResult (Compiler& c) const override
+        {
+            for (int i = 0; i < values.size(); ++i)
+                values.getUnchecked(i)->compileResult (c);
+
+            c.emit (CompiledCode::createArray, values.size(), 1 - values.size());
+        }
+
         OwnedArray<Expression> values;
     };
 
@@ -810,14 +1203,970 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 functionRoot->setProperty (parameters.getReference(i),
                                            i < args.numArguments ? args.arguments[i] : var::undefined());
 
+            const Scope functionScope (&s, s.root, functionRoot);
+
+            if (s.root->useBytecode)
+            {
+                if (compiledBody == nullptr)
+                    compiledBody = new CompiledCode (*this);
+
+                return compiledBody->run (functionScope);
+            }
+
             var result;
-            body->perform (Scope (&s, s.root, functionRoot), &result);
+            body->perform (functionScope, &result);
             return result;
         }
 
         String functionCode;
         Array<Identifier> parameters;
         ScopedPointer<Statement> body;
+        mutable ScopedPointer<CompiledCode> compiledBody;
+    };
+
+    //==============================================================================
+    /*  A value on the bytecode interpreter's stack, or in one of its registers.
+
+        Numbers and booleans are held directly rather than in a var, so that arithmetic and
+        comparisons don't need to go through var's virtual type methods. Each type tag matches
+        the var type that the value came from, so toVar() always gives back exactly the var
+        that the parse tree would have produced.
+    */
+    struct StackValue
+    {
+        StackValue() noexcept : type (intType), integer (0), number (0) {}
+
+        StackValue (const StackValue& other)
+            : type (other.type), integer (other.integer), number (other.number), object (other.object) {}
+
+        StackValue& operator= (const StackValue& other)
+        {
+            if (other.type == varType)
+            {
+                setVar (other.object);
+            }
+            else
+            {
+                reset();
+                type = other.type;
+                integer = other.integer;
+                number = other.number;
+            }
+
+            return *this;
+        }
+
+        enum Type { intType, int64Type, doubleType, boolType, varType };
+
+        void set (const var& v)
+        {
+            if (v.isInt())          setInteger (intType, (int) v);
+            else if (v.isInt64())   setInteger (int64Type, (int64) v);
+            else if (v.isDouble())  setDouble ((double) v);
+            else if (v.isBool())    setBool ((bool) v);
+            else                    setVar (v);
+        }
+
+        void setVar (const var& v)                      { type = varType; object = v; }
+        void setInteger (Type t, int64 n) noexcept      { reset(); type = t; integer = n; }
+        void setDouble (double n) noexcept              { reset(); type = doubleType; number = n; }
+        void setBool (bool b) noexcept                  { setInteger (boolType, b ? 1 : 0); }
+
+        // Releases any object that this holds
+        void reset() noexcept
+        {
+            if (type == varType)
+            {
+                object = var();
+                type = intType;
+            }
+        }
+
+        var toVar() const
+        {
+            switch (type)
+            {
+                case intType:       return var ((int) integer);
+                case int64Type:     return var (integer);
+                case doubleType:    return var (number);
+                case boolType:      return var (integer != 0);
+                default:            return object;
+            }
+        }
+
+        bool isTrue() const
+        {
+            switch (type)
+            {
+                case doubleType:    return number != 0;
+                case varType:       return (bool) object;
+                default:            return integer != 0;
+            }
+        }
+
+        int toInt() const
+        {
+            switch (type)
+            {
+                case doubleType:    return (int) number;
+                case varType:       return (int) object;
+                default:            return (int) integer;
+            }
+        }
+
+        bool isNumeric() const noexcept                 { return type != varType; }
+        double toDouble() const noexcept                { return type == doubleType ? number : (double) integer; }
+
+        Type type;
+        int64 integer;
+        double number;
+        var object;
+    };
+
+    //==============================================================================
+    // A fixed-size array which doesn't need to allocate any memory if it's small
+    template <typename ElementType, int numPreallocated>
+    struct SmallArray
+    {
+        SmallArray (int num)  : numElements (num)
+        {
+            if (num > numPreallocated)
+                heapSpace.malloc ((size_t) num * sizeof (ElementType));
+
+            elements = num > numPreallocated ? reinterpret_cast<ElementType*> (heapSpace.getData())
+                                             : reinterpret_cast<ElementType*> (preallocatedSpace);
+
+            for (int i = 0; i < num; ++i)
+                new (elements + i) ElementType();
+        }
+
+        ~SmallArray()
+        {
+            for (int i = 0; i < numElements; ++i)
+                elements[i].~ElementType();
+        }
+
+        ElementType* begin() const noexcept                 { return elements; }
+        ElementType& operator[] (int index) const noexcept  { return elements[index]; }
+
+    private:
+        ElementType* elements;
+        const int numElements;
+        HeapBlock<char> heapSpace;
+        double preallocatedSpace[(numPreallocated * sizeof (ElementType) + sizeof (double) - 1) / sizeof (double)];
+
+        JUCE_DECLARE_NON_COPYABLE (SmallArray)
+    };
+
+    //==============================================================================
+    /*  While a function's bytecode is running, this holds the values of the variables that
+        have been given registers, instead of keeping them in the function's scope object.
+        Each one is only read from the scope object when it's first needed, and any changes
+        are written back whenever some other code might look there.
+    */
+    struct RegisterFile
+    {
+        RegisterFile (const Array<Identifier>& registerNames, int* cachedIndexes, DynamicObject& scopeObject)
+            : names (registerNames), caches (cachedIndexes), frame (scopeObject), registers (registerNames.size())
+        {
+        }
+
+        struct Register
+        {
+            Register() noexcept : state (unknown), needsWriting (false) {}
+
+            enum State { unknown, present, absent };
+
+            StackValue value;
+            State state;
+            bool needsWriting;
+        };
+
+        Register& get (int index)
+        {
+            Register& r = registers[index];
+
+            if (r.state == Register::unknown)
+            {
+                if (const var* v = getPropertyPointer (&frame, names.getReference (index), caches[index]))
+                {
+                    r.state = Register::present;
+                    r.value.set (*v);
+                }
+                else
+                {
+                    r.state = Register::absent;
+                }
+            }
+
+            return r;
+        }
+
+        void set (Register& r, const StackValue& newValue)
+        {
+            r.value = newValue;
+            r.needsWriting = true;
+        }
+
+        void writeAll()
+        {
+            for (int i = 0; i < names.size(); ++i)
+            {
+                Register& r = registers[i];
+
+                if (r.needsWriting)
+                {
+                    r.needsWriting = false;
+                    const Identifier& name = names.getReference (i);
+
+                    if (var* v = getPropertyPointer (&frame, name, caches[i]))
+                        *v = r.value.toVar();
+                    else
+                        frame.setProperty (name, r.value.toVar());
+                }
+            }
+        }
+
+        // Called when the scope object may have been changed by something else, so that the
+        // registers will be re-read when they're next used. Any changes must be written first.
+        void forgetAll()
+        {
+            for (int i = 0; i < names.size(); ++i)
+            {
+                Register& r = registers[i];
+                jassert (! r.needsWriting);
+                r.state = Register::unknown;
+                r.value.reset();
+            }
+        }
+
+        const Array<Identifier>& names;
+        int* const caches;
+        DynamicObject& frame;
+        SmallArray<Register, 8> registers;
+
+        JUCE_DECLARE_NON_COPYABLE (RegisterFile)
+    };
+
+    //==============================================================================
+    /*  A stack-based bytecode version of a parse tree.
+
+        Each instruction is an opcode followed by its operands, which index into the
+        constants, names, nodes and caches tables. Anything whose behaviour depends on the
+        types of its operands has a fast path for plain numbers, and otherwise calls the
+        parse tree node that it was compiled from, so the results are always identical to
+        those of the tree-walking interpreter.
+
+        In a function, 'this', the parameters and any variables declared with 'var' are
+        given registers. Since other code can see a function's variables (via the scope
+        chain, or if the scope object is passed around as 'this'), the registers are copied
+        back into the scope object before anything that might look at them, and re-read
+        after anything that might have changed them.
+    */
+    struct CompiledCode
+    {
+        CompiledCode (const Statement& program)  : stackSize (0), mayUseThisObject (false)
+        {
+            Compiler c (*this, false);
+            program.compile (c);
+            c.emit (endOfCode, 0);
+        }
+
+        CompiledCode (const Expression& expression)  : stackSize (0), mayUseThisObject (false)
+        {
+            Compiler c (*this, false);
+            expression.compileResult (c);
+            c.emit (returnResult, -1);
+        }
+
+        CompiledCode (const FunctionObject& function)  : stackSize (0), mayUseThisObject (false)
+        {
+            static const Identifier thisIdent ("this");
+            registerNames.add (thisIdent);
+
+            for (int i = 0; i < function.parameters.size(); ++i)
+                registerNames.addIfNotAlreadyThere (function.parameters.getReference (i));
+
+            function.body->findVariableDeclarations (registerNames);
+            caches.insertMultiple (0, -1, registerNames.size());
+
+            Compiler c (*this, true);
+            function.body->compile (c);
+            c.emit (endOfCode, 0);
+        }
+
+        enum OpCode
+        {
+            pushConstant,           // constant index
+            pushUndefined,
+            pushScope,
+            popValue,
+            loadName,               // name index, cache index
+            storeName,              // name index, cache index
+            declareVar,             // name index
+            loadRegister,           // register index
+            storeRegister,          // register index
+            declareRegister,        // register index
+            loadProperty,           // node index, cache index
+            storeProperty,          // node index
+            jumpIfNotArray,         // target
+            loadElement,
+            checkArrayAssignment,   // node index
+            storeElement,
+            evaluateNode,           // node index
+            assignNode,             // node index
+            binaryOperation,        // node index, BinaryOperationType
+            typeEquals,
+            typeNotEquals,
+            convertToBool,
+            jump,                   // target
+            jumpIfFalse,            // target
+            jumpIfTrue,             // target
+            jumpIfFalseOrPop,       // target
+            jumpIfTrueOrPop,        // target
+            checkTimeOut,           // node index
+            findMethod,             // node index
+            callFunction,           // node index, number of arguments
+            createObject,           // node index
+            createArray,            // number of values
+            returnResult,
+            endOfCode
+        };
+
+        enum BinaryOperationType
+        {
+            otherOperation, addition, subtraction, multiplication, division, modulo,
+            bitwiseAnd, bitwiseOr, bitwiseXor, leftShift, rightShift, rightShiftUnsigned,
+            lessThan, lessThanOrEqual, greaterThan, greaterThanOrEqual, equals, notEquals
+        };
+
+        var run (const Scope& s) const
+        {
+            Activation a (*this, s);
+
+            if (registerNames.isEmpty())
+                return a.execute();
+
+            try
+            {
+                const var result (a.execute());
+                a.finish();
+                return result;
+            }
+            catch (...)
+            {
+                a.finish();
+                throw;
+            }
+        }
+
+        //==============================================================================
+        // Holds the stack and registers for one run of some code
+        struct Activation
+        {
+            Activation (const CompiledCode& c, const Scope& sc)
+                : code (c), s (sc), frame (*sc.scope),
+                  baseReferenceCount (frame.getReferenceCount()),
+                  numRegisters (c.registerNames.size()),
+                  frameHasBeenShared (false), stack (c.stackSize),
+                  registers (c.registerNames, c.caches.begin(), frame)
+            {
+                // (this lets any functions that it calls get hold of its variables)
+                if (numRegisters > 0)
+                    s.registers = &registers;
+            }
+
+            ~Activation()
+            {
+                if (numRegisters > 0)
+                    s.registers = nullptr;
+            }
+
+            // If anything else has kept hold of the scope object, it needs to see the final values
+            void finish()
+            {
+                if (frameMayBeShared())
+                    registers.writeAll();
+            }
+
+            bool frameMayBeShared() const noexcept          { return frame.getReferenceCount() > baseReferenceCount; }
+
+            // A function's scope object only holds the names that have registers, unless some
+            // other code has had access to it, so there's no need to look there for anything else
+            bool mightHoldOtherNames() const noexcept       { return numRegisters == 0 || frameHasBeenShared || frameMayBeShared(); }
+            bool isFrame (const var& v) const noexcept      { return numRegisters > 0 && frameMayBeShared() && v.getObject() == &frame; }
+
+            var execute()
+            {
+                const int* const start = code.code.begin();
+                int* const cache = code.caches.begin();
+                StackValue* sp = stack.begin();
+
+                for (const int* ip = start;;)
+                {
+                    switch (*ip++)
+                    {
+                        case pushConstant:      *sp++ = code.constants.getReference (*ip++); break;
+                        case pushUndefined:     (sp++)->setVar (var::undefined()); break;
+                        case pushScope:         (sp++)->setVar (var (s.scope.get())); break;
+                        case popValue:          (--sp)->reset(); break;
+
+                        case loadName:
+                        {
+                            const var* v = findVariable (s, code.names.getReference (ip[0]), cache + ip[1], mightHoldOtherNames());
+                            (sp++)->set (v != nullptr ? *v : var::undefined());
+                            ip += 2;
+                            break;
+                        }
+
+                        case storeName:
+                        {
+                            const Identifier& name = code.names.getReference (ip[0]);
+
+                            if (var* v = mightHoldOtherNames() ? getPropertyPointer (&frame, name, cache[ip[1]]) : nullptr)
+                                *v = sp[-1].toVar();
+                            else
+                                s.root->setProperty (name, sp[-1].toVar());
+
+                            ip += 2;
+                            break;
+                        }
+
+                        case declareVar:
+                            frame.setProperty (code.names.getReference (*ip++), sp[-1].toVar());
+                            (--sp)->reset();
+                            break;
+
+                        case loadRegister:
+                        {
+                            const int index = *ip++;
+                            const RegisterFile::Register& r = registers.get (index);
+
+                            if (r.state == RegisterFile::Register::present)
+                                *sp = r.value;
+                            else
+                                sp->set (s.parent != nullptr ? s.parent->findSymbolInParentScopes (code.registerNames.getReference (index))
+                                                             : var::undefined());
+                            ++sp;
+                            break;
+                        }
+
+                        case storeRegister:
+                        {
+                            const int index = *ip++;
+                            RegisterFile::Register& r = registers.get (index);
+
+                            if (r.state == RegisterFile::Register::present)
+                                registers.set (r, sp[-1]);
+                            else
+                                s.root->setProperty (code.registerNames.getReference (index), sp[-1].toVar());
+
+                            break;
+                        }
+
+                        case declareRegister:
+                        {
+                            const int index = *ip++;
+                            RegisterFile::Register& r = registers.get (index);
+
+                            if (r.state == RegisterFile::Register::present)
+                            {
+                                registers.set (r, sp[-1]);
+                            }
+                            else
+                            {
+                                frame.setProperty (code.registerNames.getReference (index), sp[-1].toVar());
+                                r.value = sp[-1];
+                                r.state = RegisterFile::Register::present;
+                            }
+
+                            (--sp)->reset();
+                            break;
+                        }
+
+                        case loadProperty:
+                        {
+                            StackValue& v = sp[-1];
+
+                            if (v.type == StackValue::varType)
+                            {
+                                if (isFrame (v.object))
+                                    registers.writeAll();
+
+                                v.set (code.getNode<DotOperator> (ip[0]).getProperty (v.object, cache[ip[1]]));
+                            }
+                            else
+                            {
+                                v.setVar (var::undefined());
+                            }
+
+                            ip += 2;
+                            break;
+                        }
+
+                        case storeProperty:
+                        {
+                            const DotOperator& dot = code.getNode<DotOperator> (*ip++);
+                            DynamicObject* o = sp[-1].type == StackValue::varType ? sp[-1].object.getDynamicObject() : nullptr;
+
+                            if (o == nullptr)
+                            {
+                                dot.Expression::assign (s, sp[-2].toVar());
+                            }
+                            else if (isFrame (sp[-1].object))
+                            {
+                                registers.writeAll();
+                                o->setProperty (dot.child, sp[-2].toVar());
+                                registers.forgetAll();
+                            }
+                            else
+                            {
+                                o->setProperty (dot.child, sp[-2].toVar());
+                            }
+
+                            (--sp)->reset();
+                            break;
+                        }
+
+                        case jumpIfNotArray:
+                            if (sp[-1].type == StackValue::varType && sp[-1].object.isArray())
+                            {
+                                ++ip;
+                            }
+                            else
+                            {
+                                sp[-1].setVar (var::undefined());
+                                ip = start + *ip;
+                            }
+                            break;
+
+                        case loadElement:
+                        {
+                            const int index = sp[-1].toInt();
+                            (--sp)->reset();
+                            sp[-1].set ((*sp[-1].object.getArray()) [index]);
+                            break;
+                        }
+
+                        case checkArrayAssignment:
+                            if (! (sp[-1].type == StackValue::varType && sp[-1].object.isArray()))
+                                code.getNode<Expression> (*ip).Expression::assign (s, sp[-2].toVar());
+
+                            ++ip;
+                            break;
+
+                        case storeElement:
+                        {
+                            Array<var>* array = sp[-2].object.getArray();
+                            const int index = sp[-1].toInt();
+
+                            while (array->size() < index)
+                                array->add (var::undefined());
+
+                            array->set (index, sp[-3].toVar());
+                            (--sp)->reset();
+                            (--sp)->reset();
+                            break;
+                        }
+
+                        case evaluateNode:
+                        {
+                            frameHasBeenShared = true;
+                            registers.writeAll();
+                            const var result (code.getNode<Expression> (*ip++).getResult (s));
+                            registers.forgetAll();
+                            (sp++)->set (result);
+                            break;
+                        }
+
+                        case assignNode:
+                            frameHasBeenShared = true;
+                            registers.writeAll();
+                            code.getNode<Expression> (*ip++).assign (s, sp[-1].toVar());
+                            registers.forgetAll();
+                            break;
+
+                        case binaryOperation:
+                        {
+                            StackValue& a = sp[-2];
+
+                            if (! applyNumericOperation (ip[1], a, sp[-1]))
+                                a.set (code.getNode<BinaryOperator> (ip[0]).apply (a.toVar(), sp[-1].toVar()));
+
+                            (--sp)->reset();
+                            ip += 2;
+                            break;
+                        }
+
+                        case typeEquals:
+                        case typeNotEquals:
+                        {
+                            const bool isEqual = areTypeEqual (sp[-2].toVar(), sp[-1].toVar());
+                            sp[-2].setBool (isEqual == (ip[-1] == typeEquals));
+                            (--sp)->reset();
+                            break;
+                        }
+
+                        case convertToBool:     sp[-1].setBool (sp[-1].isTrue()); break;
+                        case jump:              ip = start + *ip; break;
+                        case jumpIfFalse:       ip = sp[-1].isTrue() ? ip + 1 : start + *ip; (--sp)->reset(); break;
+                        case jumpIfTrue:        ip = sp[-1].isTrue() ? start + *ip : ip + 1; (--sp)->reset(); break;
+                        case jumpIfFalseOrPop:  if (sp[-1].isTrue()) { (--sp)->reset(); ++ip; } else { ip = start + *ip; } break;
+                        case jumpIfTrueOrPop:   if (sp[-1].isTrue()) { ip = start + *ip; } else { (--sp)->reset(); ++ip; } break;
+
+                        case checkTimeOut:
+                            s.checkTimeOutOccasionally (code.getNode<Statement> (*ip++).location);
+                            break;
+
+                        case findMethod:
+                        {
+                            const FunctionCall& call = code.getNode<FunctionCall> (*ip++);
+                            const var target (sp[-1].toVar());
+
+                            if (isFrame (target))
+                                registers.writeAll();
+
+                            (sp++)->setVar (s.findFunctionCall (call.location, target, static_cast<const DotOperator&> (*call.object).child));
+                            break;
+                        }
+
+                        case callFunction:
+                        {
+                            const FunctionCall& call = code.getNode<FunctionCall> (ip[0]);
+                            const int numArgs = ip[1];
+                            ip += 2;
+
+                            StackValue* const args = sp - numArgs;
+                            s.checkTimeOutOccasionally (call.location);
+
+                            const var function (args[-1].toVar());
+
+                            // A script function can read this one's variables through its scope chain (which
+                            // writes the registers back when needed), but can only change them if it's been
+                            // given the scope object
+                            const bool passesFrameAsThis = isFrame (args[-2].object);
+                            const bool isShared = numRegisters > 0
+                                                    && (frame.getReferenceCount() > baseReferenceCount + (passesFrameAsThis ? 1 : 0)
+                                                         || (passesFrameAsThis && mightUseThisObject (function)));
+                            if (isShared)
+                            {
+                                frameHasBeenShared = true;
+                                registers.writeAll();
+                            }
+
+                            SmallArray<var, 4> argVars (numArgs);
+
+                            for (int i = 0; i < numArgs; ++i)
+                                argVars[i] = args[i].toVar();
+
+                            const var result (call.invokeWithArguments (s, function, args[-2].toVar(), argVars.begin(), numArgs));
+
+                            if (isShared)
+                                registers.forgetAll();
+
+                            while (sp != args - 1)
+                                (--sp)->reset();
+
+                            sp[-1].set (result);
+                            break;
+                        }
+
+                        case createObject:
+                        {
+                            const ObjectDeclaration& declaration = code.getNode<ObjectDeclaration> (*ip++);
+                            StackValue* const values = sp - declaration.names.size();
+                            DynamicObject::Ptr newObject (new DynamicObject());
+
+                            for (int i = 0; i < declaration.names.size(); ++i)
+                                newObject->setProperty (declaration.names.getReference (i), values[i].toVar());
+
+                            while (sp != values)
+                                (--sp)->reset();
+
+                            (sp++)->setVar (var (newObject.get()));
+                            break;
+                        }
+
+                        case createArray:
+                        {
+                            StackValue* const values = sp - *ip++;
+                            Array<var> newArray;
+
+                            for (StackValue* v = values; v != sp; ++v)
+                                newArray.add (v->toVar());
+
+                            while (sp != values)
+                                (--sp)->reset();
+
+                            (sp++)->setVar (newArray);
+                            break;
+                        }
+
+                        case returnResult:      return sp[-1].toVar();
+                        case endOfCode:         return var();
+                        default:                jassertfalse; return var();
+                    }
+                }
+            }
+
+            const CompiledCode& code;
+            const Scope& s;
+            DynamicObject& frame;
+            const int baseReferenceCount, numRegisters;
+            bool frameHasBeenShared;
+
+            SmallArray<StackValue, 8> stack;
+            RegisterFile registers;
+
+            JUCE_DECLARE_NON_COPYABLE (Activation)
+        };
+
+        static bool mightUseThisObject (const var& function)
+        {
+            if (FunctionObject* fo = dynamic_cast<FunctionObject*> (function.getObject()))
+                return fo->compiledBody == nullptr || fo->compiledBody->mayUseThisObject;
+
+            return true;
+        }
+
+        template <typename NodeType>
+        const NodeType& getNode (int index) const noexcept    { return *static_cast<const NodeType*> (nodes.getUnchecked (index)); }
+
+        // Looks in the innermost scope first and then in the parents, remembering where the
+        // name was found in the innermost and outermost scopes for next time.
+        static const var* findVariable (const Scope& s, const Identifier& name, int* cachedIndexes, bool searchInnermostScope) noexcept
+        {
+            if (searchInnermostScope)
+                if (const var* v = getPropertyPointer (s.scope, name, cachedIndexes[0]))
+                    return v;
+
+            for (const Scope* p = s.parent; p != nullptr; p = p->parent)
+            {
+                if (p->registers != nullptr)
+                    p->registers->writeAll();
+
+                if (const var* v = p->parent != nullptr ? getPropertyPointer (p->scope, name)
+                                                        : getPropertyPointer (p->scope, name, cachedIndexes[1]))
+                    return v;
+            }
+
+            return nullptr;
+        }
+
+        //==============================================================================
+        // These have to produce exactly the same results as the getWithInts() and getWithDoubles()
+        // methods of the operator classes. Anything else falls back to calling the operator itself.
+        static bool applyNumericOperation (int operation, StackValue& a, const StackValue& b) noexcept
+        {
+            if (operation == otherOperation || ! (a.isNumeric() && b.isNumeric()))
+                return false;
+
+            if (a.type == StackValue::doubleType || b.type == StackValue::doubleType)
+                return applyDoubleOperation (operation, a, a.toDouble(), b.toDouble());
+
+            return applyIntegerOperation (operation, a, a.integer, b.integer);
+        }
+
+        static bool applyIntegerOperation (int operation, StackValue& result, int64 a, int64 b) noexcept
+        {
+            switch (operation)
+            {
+                case addition:              result.setInteger (StackValue::int64Type, a + b); return true;
+                case subtraction:           result.setInteger (StackValue::int64Type, a - b); return true;
+                case multiplication:        result.setInteger (StackValue::int64Type, a * b); return true;
+                case division:              result.setDouble (b != 0 ? a / (double) b : std::numeric_limits<double>::infinity()); return true;
+                case bitwiseAnd:            result.setInteger (StackValue::int64Type, a & b); return true;
+                case bitwiseOr:             result.setInteger (StackValue::int64Type, a | b); return true;
+                case bitwiseXor:            result.setInteger (StackValue::int64Type, a ^ b); return true;
+                case leftShift:             result.setInteger (StackValue::intType, ((int) a) << (int) b); return true;
+                case rightShift:            result.setInteger (StackValue::intType, ((int) a) >> (int) b); return true;
+                case rightShiftUnsigned:    result.setInteger (StackValue::intType, (int) (((uint32) a) >> (int) b)); return true;
+                case lessThan:              result.setBool (a < b);  return true;
+                case lessThanOrEqual:       result.setBool (a <= b); return true;
+                case greaterThan:           result.setBool (a > b);  return true;
+                case greaterThanOrEqual:    result.setBool (a >= b); return true;
+                case equals:                result.setBool (a == b); return true;
+                case notEquals:             result.setBool (a != b); return true;
+
+                case modulo:
+                    if (b != 0)  result.setInteger (StackValue::int64Type, a % b);
+                    else         result.setDouble (std::numeric_limits<double>::infinity());
+
+                    return true;
+
+                default:
+                    return false;
+            }
+        }
+
+        static bool applyDoubleOperation (int operation, StackValue& result, double a, double b) noexcept
+        {
+            switch (operation)
+            {
+                case addition:              result.setDouble (a + b); return true;
+                case subtraction:           result.setDouble (a - b); return true;
+                case multiplication:        result.setDouble (a * b); return true;
+                case division:              result.setDouble (b != 0 ? a / b : std::numeric_limits<double>::infinity()); return true;
+                case lessThan:              result.setBool (a < b);  return true;
+                case lessThanOrEqual:       result.setBool (a <= b); return true;
+                case greaterThan:           result.setBool (a > b);  return true;
+                case greaterThanOrEqual:    result.setBool (a >= b); return true;
+                case equals:                result.setBool (a == b); return true;
+                case notEquals:             result.setBool (a != b); return true;
+                default:                    return false; // (these aren't allowed on doubles, so the operator will throw)
+            }
+        }
+
+        Array<int> code;
+        Array<StackValue> constants;
+        Array<Identifier> names, registerNames;
+        Array<const Statement*> nodes;
+        mutable Array<int> caches;
+        int stackSize;
+        bool mayUseThisObject;
+
+        JUCE_DECLARE_NON_COPYABLE (CompiledCode)
+    };
+
+    //==============================================================================
+    struct Compiler
+    {
+        Compiler (CompiledCode& c, bool isFunction) noexcept
+            : output (c), isFunctionBody (isFunction), stackDepth (0) {}
+
+        void emit (CompiledCode::OpCode op, int stackChange)
+        {
+            output.code.add (op);
+            adjustStackDepth (stackChange);
+        }
+
+        void emit (CompiledCode::OpCode op, int operand, int stackChange)
+        {
+            output.code.add (op);
+            output.code.add (operand);
+            adjustStackDepth (stackChange);
+        }
+
+        void emit (CompiledCode::OpCode op, int operand1, int operand2, int stackChange)
+        {
+            output.code.add (op);
+            output.code.add (operand1);
+            output.code.add (operand2);
+            adjustStackDepth (stackChange);
+        }
+
+        void emitNode (CompiledCode::OpCode op, const Statement* node, int stackChange)
+        {
+            // (a parse tree node could do anything with the scope)
+            if (op == CompiledCode::evaluateNode || op == CompiledCode::assignNode)
+                output.mayUseThisObject = true;
+
+            emit (op, addNode (node), stackChange);
+        }
+
+        void emitConstant (const var& value)
+        {
+            StackValue v;
+            v.set (value);
+            output.constants.add (v);
+            emit (CompiledCode::pushConstant, output.constants.size() - 1, 1);
+        }
+
+        void emitLoad (const Identifier& name)
+        {
+            const int r = output.registerNames.indexOf (name);
+
+            if (r == 0 && isFunctionBody)
+                output.mayUseThisObject = true;
+
+            if (r >= 0)
+                emit (CompiledCode::loadRegister, r, 1);
+            else
+                emit (CompiledCode::loadName, addName (name), addCaches (2), 1);
+        }
+
+        void emitStore (const Identifier& name)
+        {
+            const int r = output.registerNames.indexOf (name);
+
+            if (r >= 0)
+                emit (CompiledCode::storeRegister, r, 0);
+            else
+                emit (CompiledCode::storeName, addName (name), addCaches (1), 0);
+        }
+
+        void emitDeclaration (const Identifier& name)
+        {
+            const int r = output.registerNames.indexOf (name);
+
+            if (r >= 0)
+                emit (CompiledCode::declareRegister, r, -1);
+            else
+                emit (CompiledCode::declareVar, addName (name), -1);
+        }
+
+        // Returns the position of the jump's target, which must be filled-in later with setJumpTarget()
+        int emitJump (CompiledCode::OpCode op, int stackChange)
+        {
+            emit (op, -1, stackChange);
+            return output.code.size() - 1;
+        }
+
+        void setJumpTarget (int jumpPosition)                 { output.code.set (jumpPosition, getPosition()); }
+        int getPosition() const noexcept                      { return output.code.size(); }
+
+        void setJumpTargets (const Array<int>& jumpPositions)
+        {
+            for (int i = 0; i < jumpPositions.size(); ++i)
+                setJumpTarget (jumpPositions.getUnchecked (i));
+        }
+
+        void adjustStackDepth (int change) noexcept
+        {
+            stackDepth += change;
+            jassert (stackDepth >= 0);
+            output.stackSize = jmax (output.stackSize, stackDepth);
+        }
+
+        int addNode (const Statement* node)                   { output.nodes.add (node); return output.nodes.size() - 1; }
+
+        int addName (const Identifier& name)
+        {
+            const int index = output.names.indexOf (name);
+
+            if (index >= 0)
+                return index;
+
+            output.names.add (name);
+            return output.names.size() - 1;
+        }
+
+        int addCaches (int num)
+        {
+            const int index = output.caches.size();
+            output.caches.insertMultiple (index, -1, num);
+            return index;
+        }
+
+        struct Loop
+        {
+            Loop (Compiler& c) : compiler (c)   { c.loops.add (this); }
+            ~Loop()                             { compiler.loops.removeLast(); }
+
+            Compiler& compiler;
+            Array<int> breakJumps, continueJumps;
+        };
+
+        // Outside a loop, 'break' and 'continue' just end the function or program, like perform() does
+        void compileBreak()     { if (Loop* l = loops.getLast()) l->breakJumps.add (emitJump (CompiledCode::jump, 0));    else emit (CompiledCode::endOfCode, 0); }
+        void compileContinue()  { if (Loop* l = loops.getLast()) l->continueJumps.add (emitJump (CompiledCode::jump, 0)); else emit (CompiledCode::endOfCode, 0); }
+
+        CompiledCode& output;
+        const bool isFunctionBody;
+        int stackDepth;
+        Array<Loop*> loops;
+
+        JUCE_DECLARE_NON_COPYABLE (Compiler)
     };
 
     //==============================================================================
@@ -1759,7 +3108,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 };
 
 //==============================================================================
-JavascriptEngine::JavascriptEngine()  : maximumExecutionTime (15.0), root (new RootObject())
+JavascriptEngine::JavascriptEngine()  : maximumExecutionTime (15.0), useBytecodeInterpreter (true), root (new RootObject())
 {
     registerNativeObject (RootObject::ObjectClass  ::getClassName(),  new RootObject::ObjectClass());
     registerNativeObject (RootObject::ArrayClass   ::getClassName(),  new RootObject::ArrayClass());
@@ -1771,7 +3120,12 @@ JavascriptEngine::JavascriptEngine()  : maximumExecutionTime (15.0), root (new R
 
 JavascriptEngine::~JavascriptEngine() {}
 
-void JavascriptEngine::prepareTimeout() const noexcept   { root->timeout = Time::getCurrentTime() + maximumExecutionTime; }
+void JavascriptEngine::prepareToRun() const noexcept
+{
+    root->timeout = Time::getCurrentTime() + maximumExecutionTime;
+    root->ticksUntilTimeoutCheck = 0;
+    root->useBytecode = useBytecodeInterpreter;
+}
 
 void JavascriptEngine::registerNativeObject (const Identifier& name, DynamicObject* object)
 {
@@ -1782,7 +3136,7 @@ Result JavascriptEngine::execute (const String& code)
 {
     try
     {
-        prepareTimeout();
+        prepareToRun();
         root->execute (code);
     }
     catch (String& error)
@@ -1797,7 +3151,7 @@ var JavascriptEngine::evaluate (const String& code, Result* result)
 {
     try
     {
-        prepareTimeout();
+        prepareToRun();
         if (result != nullptr) *result = Result::ok();
         return root->evaluate (code);
     }
@@ -1815,7 +3169,7 @@ var JavascriptEngine::callFunction (const Identifier& function, const var::Nativ
 
     try
     {
-        prepareTimeout();
+        prepareToRun();
         if (result != nullptr) *result = Result::ok();
         RootObject::Scope (nullptr, root, root).findAndInvokeMethod (function, args, returnVal);
     }
@@ -1835,3 +3189,167 @@ const NamedValueSet& JavascriptEngine::getRootObjectProperties() const noexcept
 #if JUCE_MSVC
  #pragma warning (pop)
 #endif
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JavascriptEngineTests  : public UnitTest
+{
+public:
+    JavascriptEngineTests() : UnitTest ("JavascriptEngine") {}
+
+    static var runScript (const String& script, bool useBytecode, Result& result)
+    {
+        JavascriptEngine engine;
+        engine.useBytecodeInterpreter = useBytecode;
+        result = engine.execute (script);
+
+        return result.wasOk() ? engine.evaluate ("result") : var();
+    }
+
+    // Runs the script with both interpreters, and checks the value that each one leaves in 'result'
+    void expectResult (const String& script, const String& expectedJSON)
+    {
+        Result treeResult (Result::ok()), codeResult (Result::ok());
+        const var treeValue (runScript (script, false, treeResult));
+        const var codeValue (runScript (script, true, codeResult));
+
+        expect (treeResult.wasOk() && codeResult.wasOk(), script);
+        expectEquals (JSON::toString (treeValue, true), expectedJSON);
+        expectEquals (JSON::toString (codeValue, true), expectedJSON);
+        expect (codeValue.hasSameTypeAs (treeValue), script);
+    }
+
+    void expectError (const String& script, const String& expectedError)
+    {
+        Result treeResult (Result::ok()), codeResult (Result::ok());
+        runScript (script, false, treeResult);
+        runScript (script, true, codeResult);
+
+        expectEquals (treeResult.getErrorMessage(), expectedError);
+        expectEquals (codeResult.getErrorMessage(), expectedError);
+    }
+
+    // Returns the time taken in milliseconds, or -1 if the result was wrong
+    double timeExpression (const String& script, const String& expression, const var& expectedResult, bool useBytecode)
+    {
+        JavascriptEngine engine;
+        engine.useBytecodeInterpreter = useBytecode;
+        engine.maximumExecutionTime = RelativeTime::seconds (60);
+        engine.execute (script);
+
+        const double startTime = Time::getMillisecondCounterHiRes();
+        const var result (engine.evaluate (expression));
+        const double elapsed = Time::getMillisecondCounterHiRes() - startTime;
+
+        expect (result == expectedResult, expression);
+        return result == expectedResult ? elapsed : -1.0;
+    }
+
+    void logTimes (const String& name, const String& script, const String& expression, const var& expectedResult)
+    {
+        const double treeTime = timeExpression (script, expression, expectedResult, false);
+        const double codeTime = timeExpression (script, expression, expectedResult, true);
+
+        logMessage (name + ": parse tree " + String (treeTime, 1) + "ms, bytecode " + String (codeTime, 1)
+                      + "ms (x" + String (treeTime / jmax (0.001, codeTime), 2) + ")");
+    }
+
+    void runTest() override
+    {
+        beginTest ("Expressions");
+        expectResult ("var result = 1 + 2 * 3 - 4 / 2;", "5");
+        expectResult ("var result = \"a\" + 1 + 2;", "\"a12\"");
+        expectResult ("var result = 2 * (3 + 4) - 10 % 4 + (1 << 3) + (-8 >> 1) + (-8 >>> 28) + (5 & 3) + (5 | 3) + (5 ^ 3);", "45");
+        expectResult ("var result = 1.5 + 2 + 0.25 * 4 + 7 / 2 + (3 < 2.5) + (2.5 == 2.5);", "9");
+        expectResult ("var result = [(1 && 0) || (2 > 1 ? \"yes\" : \"no\"), 0 || 0, \"\" && 1, 2 && 3];", "[true, false, false, true]");
+        expectResult ("var result = typeof 1 + typeof \"s\" + (1 === 1.0) + (null == undefined) + (1 !== \"1\");", "\"numberstring011\"");
+        expectResult ("var result = [undefined == undefined, null, 1 + null, \"x\" + undefined];", "[true, null, \"1\", \"xundefined\"]");
+        expectResult ("var result = [1 > 2 && x.y.z, 2 > 1 || x.y.z];", "[false, true]");
+        expectResult ("var q = 3; var result = q++ + q++ + ++q;", "13");
+        expectResult ("var a = [0, 0]; var i = 0; a[i++] += 5; var result = a[0] + \",\" + a[1] + \",\" + i;", "\"0,5,2\"");
+        expectResult ("var result = [1 / 0, 7 % 0, 2.5 / 0];", "[inf, inf, inf]");
+
+        beginTest ("Statements");
+        expectResult ("var result = 0; for (var i = 0; i < 10; ++i) { if (i == 3) continue; if (i == 7) break; result += i; }", "18");
+        expectResult ("var result = 0; var i = 0; do { i++; if (i % 2 == 0) continue; result += i; } while (i < 9);", "25");
+        expectResult ("var result = 0; do { result++; if (result < 5) continue; } while (result < 3);", "5");
+        expectResult ("var t = 0; for (var i = 0; i < 10; ++i) { var j = 0; while (true) { if (++j > i) break; t += j; } } var result = t;", "165");
+        expectResult ("var result = 1; return; result = 2;", "1");
+        expectResult ("var result = 0; while (false) result = 5;", "0");
+
+        beginTest ("Objects and arrays");
+        expectResult ("var o = { a: 1, b: { c: 2 } }; o.b.c += 3; o.d = o.a + o.b.c; var result = o;", "{\"a\": 1, \"b\": {\"c\": 5}, \"d\": 6}");
+        expectResult ("var a = [1, 2, 3]; a[5] = 6; a.push (7); var result = [a.length + a[1], a];", "[9, [1, 2, 3, undefined, undefined, 6, 7]]");
+        expectResult ("var a = [[1, 2], [3, 4]]; a[1][0] += 10; var result = a;", "[[1, 2], [13, 4]]");
+        expectResult ("function getX (o) { return o.x; } var result = getX ({ x: 1 }) + getX ({ y: 2, x: 10 }) + getX ({ x: 100, z: 0 }) + getX ({ q: 5 });", "111");
+        expectResult ("var obj = { v: 3, get: function() { return this.v; } }; var result = obj.get();", "3");
+        expectResult ("function Point (x, y) { this.x = x; this.y = y; } var p = new Point (3, 4); var result = p.x * p.y;", "12");
+        expectResult ("var result = \"abc\".length + \"abc\".charAt (1) + \"abc\".charCodeAt (0) + Math.abs (-5);", "\"3b975\"");
+
+        beginTest ("Functions");
+        expectResult ("function fib (n) { return n < 2 ? n : fib (n - 1) + fib (n - 2); } var result = fib (15);", "610");
+        expectResult ("function f() {} var result = typeof f();", "\"void\"");
+        expectResult ("function f() { return; } var result = [typeof f(), f() === undefined];", "[\"undefined\", true]");
+        expectResult ("function f() { for (var i = 0; i < 5; ++i) if (i == 2) return i * 10; } var result = f();", "20");
+        expectResult ("function f (a, a) { return a; } var result = f (1, 2);", "2");
+        expectResult ("function f (n) { var n; return n; } var result = f (4);", "undefined");
+        expectResult ("function f() { return typeof v; var v = 1; } var result = f();", "\"undefined\"");
+        expectResult ("function f() { u = 5; } f(); var result = u;", "5");
+        expectResult ("var x = 1; function g() { var y = x; var x = 5; return y + x; } var result = g();", "6");
+        expectResult ("var result = eval (\"1 + 2\") + 4; exec (\"var result2 = 9;\"); result += result2;", "16");
+
+        beginTest ("Scopes");
+        expectResult ("function outer() { var x = 5; return inner(); } function inner() { return x; } var result = outer();", "5");
+        expectResult ("function peek() { return x; } function f() { var x = 1; x = 2; var a = peek(); x = 3; return [a, peek()]; } var result = f();", "[2, 3]");
+        expectResult ("function deep() { return y; } function mid() { return deep(); } function f() { var y = 0; for (var i = 0; i < 3; ++i) y += 10; return mid(); } var result = f();", "30");
+        expectResult ("function setX() { this.x = 5; } function f() { var x = 1; setX(); return x; } var result = f();", "5");
+        expectResult ("var saved; function keep() { saved = this; } function f() { var x = 1; keep(); x = 7; return 0; } f(); var result = saved.x; saved = 0;", "7");
+        expectResult ("function me() { return this; } function f() { var z = 1; var m = me(); m.z = 4; m = 0; return z; } var result = f();", "4");
+        expectResult ("function addW() { this.w = 3; } function f() { addW(); return w; } var result = f();", "3");
+        expectResult ("function f() { var a = 1; var g = function() { return a; }; a = 2; return g(); } var result = f();", "2");
+
+        beginTest ("Errors");
+        expectError ("function f() { return nosuch(); } f();", "Line 1, column 29 : This expression is not a function!");
+        expectError ("var x = 1.5 % 2;", "Line 1, column 16 : '%' is not allowed on the Double type");
+        expectError ("var a = 5; a[0] = 1;", "Line 1, column 14 : Cannot assign to this expression!");
+        expectError ("var o = {}; o.f();", "Line 1, column 16 : Unknown function 'f'");
+
+        beginTest ("Timeouts");
+        for (int useBytecode = 0; useBytecode < 2; ++useBytecode)
+        {
+            JavascriptEngine engine;
+            engine.useBytecodeInterpreter = useBytecode != 0;
+            engine.maximumExecutionTime = RelativeTime::milliseconds (50);
+
+            expect (engine.execute ("while (true) {}").getErrorMessage().contains ("timed-out"));
+            expect (engine.execute ("function f() { for (;;) {} } f();").getErrorMessage().contains ("timed-out"));
+        }
+
+        beginTest ("Performance");
+        logTimes ("Arithmetic loop",
+                  "function f (n) { var t = 0; for (var i = 0; i < n; ++i) { t += i * 2; if (t > 100000) t -= 100000; } return t; }",
+                  "f (200000)", (int64) 22499900000LL);
+
+        logTimes ("Recursive calls",
+                  "function fib (n) { return n < 2 ? n : fib (n - 1) + fib (n - 2); }",
+                  "fib (20)", 6765);
+
+        logTimes ("Properties and methods",
+                  "var o = { x: 1, y: 2 }; function g (n) { var s = 0; for (var i = 0; i < n; ++i) s += o.x + o.y + Math.abs (-i); return s; }",
+                  "g (100000)", (int64) 5000250000LL);
+
+        logTimes ("Arrays",
+                  "function h (n) { var a = [1, 2, 3, 4, 5, 6, 7, 8]; var s = 0; for (var i = 0; i < n; ++i) { a[i & 7] += i; s += a[(i + 3) & 7]; } return s; }",
+                  "h (100000)", (int64) 20832396262500LL);
+
+        logTimes ("Strings",
+                  "function k (n) { var s = \"\"; for (var i = 0; i < n; ++i) s = (s + i).substring (0, 10); return s.length; }",
+                  "k (50000)", 10);
+    }
+};
+
+static JavascriptEngineTests javascriptEngineTests;
+
+#endif
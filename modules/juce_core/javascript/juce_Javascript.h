@@ -96,13 +96,20 @@ public:
     */
     RelativeTime maximumExecutionTime;
 
+    /** When this is true (the default), scripts and functions are compiled into bytecode
+        before they're run, which is much faster than walking the parse tree. Both ways of
+        running the code produce the same results, so this is mainly useful for comparing
+        them.
+    */
+    bool useBytecodeInterpreter;
+
     /** Provides access to the set of properties of the root namespace object. */
     const NamedValueSet& getRootObjectProperties() const noexcept;
 
 private:
     JUCE_PUBLIC_IN_DLL_BUILD (struct RootObject)
     const ReferenceCountedObjectPtr<RootObject> root;
-    void prepareTimeout() const noexcept;
+    void prepareToRun() const noexcept;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JavascriptEngine)
 };
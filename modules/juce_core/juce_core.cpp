@@ -128,6 +128,7 @@ namespace juce
 {
 
 #include "containers/juce_AbstractFifo.cpp"
+#include "containers/juce_LockFreeQueues.cpp"
 #include "containers/juce_NamedValueSet.cpp"
 #include "containers/juce_PropertySet.cpp"
 #include "containers/juce_Variant.cpp"
@@ -138,6 +139,8 @@ namespace juce
 #include "files/juce_FileSearchPath.cpp"
 #include "files/juce_TemporaryFile.cpp"
 #include "javascript/juce_JSON.cpp"
+#include "javascript/juce_JSONReader.cpp"
+#include "javascript/juce_JSONWriter.cpp"
 #include "javascript/juce_Javascript.cpp"
 #include "containers/juce_DynamicObject.cpp"
 #include "logging/juce_FileLogger.cpp"
@@ -166,6 +166,10 @@
  #include "native/juce_BasicNativeHeaders.h"
 #endif
 
+#if JUCE_CORE_INCLUDE_SIMD_HEADERS
+ #include "native/juce_SIMDNativeHeaders.h"
+#endif
+
 #include "system/juce_StandardHeader.h"
 
 namespace juce
@@ -267,6 +271,8 @@ extern JUCE_API void JUCE_CALLTYPE logAssertion (const char* file, int line) noe
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "javascript/juce_JSON.h"
+#include "javascript/juce_JSONReader.h"
+#include "javascript/juce_JSONWriter.h"
 #include "javascript/juce_Javascript.h"
 #include "maths/juce_BigInteger.h"
 #include "maths/juce_Expression.h"
@@ -282,6 +288,7 @@ extern JUCE_API void JUCE_CALLTYPE logAssertion (const char* file, int line) noe
 #include "threads/juce_Process.h"
 #include "threads/juce_SpinLock.h"
 #include "threads/juce_WaitableEvent.h"
+#include "containers/juce_LockFreeQueues.h"
 #include "threads/juce_Thread.h"
 #include "threads/juce_ThreadLocalValue.h"
 #include "threads/juce_ThreadPool.h"
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+   This file is part of the juce_core module of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission to use, copy, modify, and/or distribute this software for any purpose with
+   or without fee is hereby granted, provided that the above copyright notice and this
+   permission notice appear in all copies.
+
+   THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES WITH REGARD
+   TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN
+   NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL
+   DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER
+   IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+   CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+   ------------------------------------------------------------------------------
+
+   NOTE! This permissive ISC license applies ONLY to files within the juce_core module!
+   All other JUCE modules are covered by a dual GPL/commercial license, so if you are
+   using any other modules, be sure to check that you also comply with their license.
+
+   For more details, visit www.juce.com
+
+  ==============================================================================
+*/
+#ifndef JUCE_SIMDNATIVEHEADERS_H_INCLUDED
+#define JUCE_SIMDNATIVEHEADERS_H_INCLUDED
+
+/*  This sets up the SSE and AVX intrinsics for modules that have vectorised code paths.
+    Include it by defining JUCE_CORE_INCLUDE_SIMD_HEADERS before including juce_core.h.
+
+    JUCE_USE_SSE_INTRINSICS and JUCE_USE_AVX_INTRINSICS can be set to 0 to disable them.
+    Functions marked with JUCE_AVX_FUNCTION can use AVX2 and FMA instructions without the
+    whole module being compiled for AVX, so they must only be called after checking
+    SystemStats::hasAVX2() and SystemStats::hasFMA3().
+*/
+
+#if JUCE_MINGW && ! defined (__SSE2__)
+ #define JUCE_USE_SSE_INTRINSICS 0
+#endif
+
+#ifndef JUCE_USE_SSE_INTRINSICS
+ #define JUCE_USE_SSE_INTRINSICS 1
+#endif
+
+#if ! JUCE_INTEL
+ #undef JUCE_USE_SSE_INTRINSICS
+#endif
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
+#ifndef JUCE_USE_AVX_INTRINSICS
+ #if JUCE_USE_SSE_INTRINSICS && (JUCE_GCC || JUCE_CLANG || (JUCE_MSVC && _MSC_VER >= 1800))
+  #define JUCE_USE_AVX_INTRINSICS 1
+ #endif
+#endif
+
+#if ! JUCE_USE_SSE_INTRINSICS
+ #undef JUCE_USE_AVX_INTRINSICS
+#endif
+
+#if JUCE_USE_AVX_INTRINSICS
+ #include <immintrin.h>
+
+ #if JUCE_MSVC
+  #define JUCE_AVX_FUNCTION
+ #else
+  // lets individual functions use AVX2/FMA without compiling the whole module with -mavx2
+  #define JUCE_AVX_FUNCTION __attribute__ ((target ("avx2,fma")))
+ #endif
+#endif
+
+#endif   // JUCE_SIMDNATIVEHEADERS_H_INCLUDED
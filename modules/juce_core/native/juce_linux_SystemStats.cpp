@@ -160,6 +160,7 @@ void CPUInformation::initialise() noexcept
     hasSSE42 = flags.contains ("sse4_2");
     hasAVX   = flags.contains ("avx");
     hasAVX2  = flags.contains ("avx2");
+    hasFMA3  = (" " + flags + " ").contains (" fma ");
 
     numCpus = LinuxStatsHelpers::getCpuInfo ("processor").getIntValue() + 1;
 }
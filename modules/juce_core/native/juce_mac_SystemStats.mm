@@ -84,6 +84,7 @@ void CPUInformation::initialise() noexcept
     hasSSE41 = (c & (1u << 20)) != 0;
     hasSSE42 = (c & (1u << 19)) != 0;
     hasAVX   = (c & (1u << 28)) != 0;
+    hasFMA3  = (c & (1u << 12)) != 0;
 
     SystemStatsHelpers::doCPUID (a, b, c, d, 7);
     hasAVX2  = (b & (1u <<  5)) != 0;
@@ -69,7 +69,7 @@ struct CPUInformation
         : numCpus (0), hasMMX (false), hasSSE (false),
           hasSSE2 (false), hasSSE3 (false), has3DNow (false),
           hasSSSE3 (false), hasSSE41 (false), hasSSE42 (false),
-          hasAVX (false), hasAVX2 (false)
+          hasAVX (false), hasAVX2 (false), hasFMA3 (false)
     {
         initialise();
     }
@@ -77,7 +77,7 @@ struct CPUInformation
     void initialise() noexcept;
 
     int numCpus;
-    bool hasMMX, hasSSE, hasSSE2, hasSSE3, has3DNow, hasSSSE3, hasSSE41, hasSSE42, hasAVX, hasAVX2;
+    bool hasMMX, hasSSE, hasSSE2, hasSSE3, has3DNow, hasSSSE3, hasSSE41, hasSSE42, hasAVX, hasAVX2, hasFMA3;
 };
 
 static const CPUInformation& getCPUInformation() noexcept
@@ -97,6 +97,7 @@ bool SystemStats::hasSSE41() noexcept         { return getCPUInformation().hasSS
 bool SystemStats::hasSSE42() noexcept         { return getCPUInformation().hasSSE42; }
 bool SystemStats::hasAVX() noexcept           { return getCPUInformation().hasAVX; }
 bool SystemStats::hasAVX2() noexcept          { return getCPUInformation().hasAVX2; }
+bool SystemStats::hasFMA3() noexcept          { return getCPUInformation().hasFMA3; }
 
 
 //==============================================================================
@@ -162,6 +162,7 @@ public:
     static bool hasSSE42() noexcept;  /**< Returns true if Intel SSE4.2 instructions are available. */
     static bool hasAVX() noexcept;    /**< Returns true if Intel AVX instructions are available. */
     static bool hasAVX2() noexcept;   /**< Returns true if Intel AVX2 instructions are available. */
+    static bool hasFMA3() noexcept;   /**< Returns true if Intel FMA3 (fused multiply-add) instructions are available. */
 
     //==============================================================================
     /** Finds out how much RAM is in the machine.
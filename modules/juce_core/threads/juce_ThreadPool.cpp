@@ -29,27 +29,293 @@
 class ThreadPool::ThreadPoolThread  : public Thread
 {
 public:
-    ThreadPoolThread (ThreadPool& p)
-       : Thread ("Pool"), currentJob (nullptr), pool (p)
+    ThreadPoolThread (ThreadPool& p, int threadIndex)
+       : Thread ("Pool"), currentJob (nullptr), pool (p), index (threadIndex),
+         randomSeed ((uint32) threadIndex * 0x9e3779b9u + 1)
     {
     }
 
     void run() override
     {
         while (! threadShouldExit())
-            if (! pool.runNextJob (*this))
-                wait (500);
+            if (! pool.runNextJob (this))
+                pool.waitForMoreWork (*this);
+    }
+
+    int getRandomIndex (int maxValue) noexcept
+    {
+        randomSeed ^= randomSeed << 13;
+        randomSeed ^= randomSeed >> 17;
+        randomSeed ^= randomSeed << 5;
+        return (int) (randomSeed % (uint32) maxValue);
     }
 
     ThreadPoolJob* volatile currentJob;
     ThreadPool& pool;
+    const int index;
+    Atomic<int> isSleeping;
+    uint32 randomSeed;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
 
+//==============================================================================
+/*  The work-stealing scheduler keeps a Chase-Lev deque for each thread: the owner
+    pushes and pops tasks at the bottom without taking any locks, while other threads
+    steal from the top. Tasks that are added by threads outside the pool go into a
+    shared lock-free queue, from which the workers take them in batches.
+*/
+struct ThreadPool::WorkStealingScheduler
+{
+    WorkStealingScheduler (int numThreads)  : injectedTasks (1024)
+    {
+        for (int i = 0; i < numThreads; ++i)
+            deques.add (new TaskDeque());
+    }
+
+    ~WorkStealingScheduler()
+    {
+        for (int i = 0; i < deques.size(); ++i)
+            while (Task* t = deques.getUnchecked(i)->pop())
+                delete t;
+
+        Task* t;
+
+        while (injectedTasks.pop (t))
+            delete t;
+
+        for (int i = 0; i < overflowTasks.size(); ++i)
+            delete overflowTasks.getUnchecked(i);
+    }
+
+    //==============================================================================
+    struct TaskDeque
+    {
+        TaskDeque()  : top (0), bottom (0)
+        {
+            buffers.add (new Buffer (256));
+            buffer = buffers.getLast();
+        }
+
+        // may only be called by the thread that owns the deque
+        void push (Task* task)
+        {
+            const int64 b = bottom.get();
+            const int64 t = top.get();
+            Buffer* buf = buffer.get();
+
+            if (b - t >= buf->getSize() - 1)
+                buf = grow (buf, b, t);
+
+            buf->put (b, task);
+            bottom.set (b + 1);
+        }
+
+        // may only be called by the thread that owns the deque
+        Task* pop()
+        {
+            const int64 b = bottom.get() - 1;
+            Buffer* const buf = buffer.get();
+            bottom.set (b);
+            const int64 t = top.get();
+
+            if (t > b)
+            {
+                bottom.set (b + 1);
+                return nullptr;
+            }
+
+            Task* task = buf->get (b);
+
+            if (t == b)
+            {
+                // this is the last item, so we're racing against any thieves for it
+                if (! top.compareAndSetBool (t + 1, t))
+                    task = nullptr;
+
+                bottom.set (b + 1);
+            }
+
+            return task;
+        }
+
+        // can be called by any thread
+        Task* steal()
+        {
+            const int64 t = top.get();
+            const int64 b = bottom.get();
+
+            if (t >= b)
+                return nullptr;
+
+            Task* const task = buffer.get()->get (t);
+
+            if (! top.compareAndSetBool (t + 1, t))
+                return nullptr;
+
+            return task;
+        }
+
+        bool isEmpty() const noexcept     { return bottom.value <= top.value; }
+
+    private:
+        struct Buffer
+        {
+            Buffer (int64 size)  : mask (size - 1), items ((size_t) size)  {}
+
+            int64 getSize() const noexcept              { return mask + 1; }
+            Task* get (int64 i) const noexcept          { return items[(size_t) (i & mask)]; }
+            void put (int64 i, Task* task) noexcept     { items[(size_t) (i & mask)] = task; }
+
+            const int64 mask;
+            HeapBlock<Task*> items;
+
+            JUCE_DECLARE_NON_COPYABLE (Buffer)
+        };
+
+        Buffer* grow (Buffer* oldBuffer, int64 b, int64 t)
+        {
+            Buffer* const newBuffer = new Buffer (oldBuffer->getSize() * 2);
+
+            for (int64 i = t; i < b; ++i)
+                newBuffer->put (i, oldBuffer->get (i));
+
+            // thieves may still be reading the old buffer, so it's kept until the deque is deleted
+            buffers.add (newBuffer);
+            buffer = newBuffer;
+            return newBuffer;
+        }
+
+        Atomic<int64> top, bottom;
+        Atomic<Buffer*> buffer;
+        OwnedArray<Buffer> buffers;
+
+        JUCE_DECLARE_NON_COPYABLE (TaskDeque)
+    };
+
+    //==============================================================================
+    void addInjectedTask (Task* task)
+    {
+        if (! injectedTasks.push (task))
+        {
+            const ScopedLock sl (overflowLock);
+            overflowTasks.add (task);
+            ++numOverflowTasks;
+        }
+    }
+
+    Task* takeInjectedTasks (TaskDeque* localDeque)
+    {
+        const int maxBatchSize = 16;
+        Task* batch [maxBatchSize];
+
+        const int num = injectedTasks.popMultiple (batch, localDeque != nullptr ? maxBatchSize : 1);
+
+        if (num > 0)
+        {
+            // pushed in reverse so that the owner pops them in their original order
+            for (int i = num; --i > 0;)
+                localDeque->push (batch[i]);
+
+            return batch[0];
+        }
+
+        if (numOverflowTasks.value > 0)
+        {
+            const ScopedLock sl (overflowLock);
+
+            if (overflowTasks.size() > 0)
+            {
+                --numOverflowTasks;
+                return overflowTasks.remove (0);
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool hasQueuedTasks() const noexcept
+    {
+        if (numOverflowTasks.value > 0 || ! injectedTasks.isEmpty())
+            return true;
+
+        for (int i = 0; i < deques.size(); ++i)
+            if (! deques.getUnchecked(i)->isEmpty())
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    // called with the pool's lock held
+    void registerJob (ThreadPool& pool, ThreadPoolJobTask& task);
+    void unregisterJob (ThreadPool& pool, ThreadPoolJobTask& task);
+
+    OwnedArray<TaskDeque> deques;
+    MultiProducerMultiConsumerQueue<Task*> injectedTasks;
+    CriticalSection overflowLock;
+    Array<Task*> overflowTasks;
+    Atomic<int> numOverflowTasks, numSleepingThreads;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkStealingScheduler)
+};
+
+//==============================================================================
+/*  Wraps a ThreadPoolJob that has been added to a work-stealing pool. The state flag
+    decides whether the job gets run by a worker or cancelled by removeJob(), so that a
+    job can be removed while its task is still sitting in one of the queues.
+*/
+struct ThreadPoolJobTask  : public ThreadPool::Task
+{
+    ThreadPoolJobTask (ThreadPool& p, ThreadPoolJob& j) noexcept
+        : Task (p), job (&j), state ((int) queued), registryIndex (-1)
+    {
+    }
+
+    enum State
+    {
+        queued = 0,
+        running,
+        cancelled
+    };
+
+    void run (ThreadPool::ThreadPoolThread* currentThread) override
+    {
+        if (state.compareAndSetBool (running, queued))
+            pool.runScheduledJob (*this, currentThread);
+        else
+            delete this;
+    }
+
+    ThreadPoolJob* const job;
+    Atomic<int> state;
+    int registryIndex;
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadPoolJobTask)
+};
+
+void ThreadPool::WorkStealingScheduler::registerJob (ThreadPool& pool, ThreadPoolJobTask& task)
+{
+    task.registryIndex = pool.jobs.size();
+    task.job->scheduledTask = &task;
+    pool.jobs.add (task.job);
+}
+
+void ThreadPool::WorkStealingScheduler::unregisterJob (ThreadPool& pool, ThreadPoolJobTask& task)
+{
+    // swap the last job into this one's slot, so that removal doesn't need a search
+    ThreadPoolJob* const lastJob = pool.jobs.getLast();
+    lastJob->scheduledTask->registryIndex = task.registryIndex;
+    pool.jobs.set (task.registryIndex, lastJob);
+    pool.jobs.removeLast();
+
+    task.job->scheduledTask = nullptr;
+    task.registryIndex = -1;
+}
+
 //==============================================================================
 ThreadPoolJob::ThreadPoolJob (const String& name)
-    : jobName (name), pool (nullptr),
+    : jobName (name), pool (nullptr), scheduledTask (nullptr),
       shouldStop (false), isActive (false), shouldBeDeleted (false)
 {
 }
@@ -89,24 +355,37 @@ ThreadPool::ThreadPool (const int numThreads)
 {
     jassert (numThreads > 0); // not much point having a pool without any threads!
 
-    createThreads (numThreads);
+    createThreads (numThreads, false);
+}
+
+ThreadPool::ThreadPool (const int numThreads, const bool useWorkStealing)
+{
+    jassert (numThreads > 0); // not much point having a pool without any threads!
+
+    createThreads (numThreads, useWorkStealing);
 }
 
 ThreadPool::ThreadPool()
 {
-    createThreads (SystemStats::getNumCpus());
+    createThreads (SystemStats::getNumCpus(), false);
 }
 
 ThreadPool::~ThreadPool()
 {
     removeAllJobs (true, 5000);
     stopThreads();
+    scheduler = nullptr;
 }
 
-void ThreadPool::createThreads (int numThreads)
+void ThreadPool::createThreads (int numThreads, const bool useWorkStealing)
 {
-    for (int i = jmax (1, numThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this));
+    numThreads = jmax (1, numThreads);
+
+    if (useWorkStealing)
+        scheduler = new WorkStealingScheduler (numThreads);
+
+    for (int i = 0; i < numThreads; ++i)
+        threads.add (new ThreadPoolThread (*this, i));
 
     for (int i = threads.size(); --i >= 0;)
         threads.getUnchecked(i)->startThread();
@@ -133,6 +412,19 @@ void ThreadPool::addJob (ThreadPoolJob* const job, const bool deleteJobWhenFinis
         job->isActive = false;
         job->shouldBeDeleted = deleteJobWhenFinished;
 
+        if (scheduler != nullptr)
+        {
+            ThreadPoolJobTask* const task = new ThreadPoolJobTask (*this, *job);
+
+            {
+                const ScopedLock sl (lock);
+                scheduler->registerJob (*this, *task);
+            }
+
+            spawnTask (task, getCurrentPoolThread());
+            return;
+        }
+
         {
             const ScopedLock sl (lock);
             jobs.add (job);
@@ -148,6 +440,11 @@ int ThreadPool::getNumJobs() const
     return jobs.size();
 }
 
+int ThreadPool::getNumThreads() const noexcept
+{
+    return threads.size();
+}
+
 ThreadPoolJob* ThreadPool::getJob (const int index) const
 {
     const ScopedLock sl (lock);
@@ -195,20 +492,12 @@ bool ThreadPool::removeJob (ThreadPoolJob* const job,
     {
         const ScopedLock sl (lock);
 
-        if (jobs.contains (job))
+        if (jobs.contains (job) && ! removeQueuedJob (job, deletionList))
         {
-            if (job->isActive)
-            {
-                if (interruptIfRunning)
-                    job->signalJobShouldExit();
+            if (interruptIfRunning)
+                job->signalJobShouldExit();
 
-                dontWait = false;
-            }
-            else
-            {
-                jobs.removeFirstMatchingValue (job);
-                addToDeleteList (deletionList, job);
-            }
+            dontWait = false;
         }
     }
 
@@ -230,20 +519,13 @@ bool ThreadPool::removeAllJobs (const bool interruptRunningJobs, const int timeO
             {
                 ThreadPoolJob* const job = jobs.getUnchecked(i);
 
-                if (selectedJobsToRemove == nullptr || selectedJobsToRemove->isJobSuitable (job))
+                if ((selectedJobsToRemove == nullptr || selectedJobsToRemove->isJobSuitable (job))
+                      && ! removeQueuedJob (job, deletionList))
                 {
-                    if (job->isActive)
-                    {
-                        jobsToWaitFor.add (job);
-
-                        if (interruptRunningJobs)
-                            job->signalJobShouldExit();
-                    }
-                    else
-                    {
-                        jobs.remove (i);
-                        addToDeleteList (deletionList, job);
-                    }
+                    jobsToWaitFor.add (job);
+
+                    if (interruptRunningJobs)
+                        job->signalJobShouldExit();
                 }
             }
         }
@@ -329,12 +611,50 @@ ThreadPoolJob* ThreadPool::pickNextJobToRun()
     return nullptr;
 }
 
-bool ThreadPool::runNextJob (ThreadPoolThread& thread)
+bool ThreadPool::removeQueuedJob (ThreadPoolJob* const job, OwnedArray<ThreadPoolJob>& deletionList)
+{
+    if (scheduler != nullptr)
+    {
+        ThreadPoolJobTask* const task = job->scheduledTask;
+
+        // if this fails, a thread has already started running it
+        if (! task->state.compareAndSetBool (ThreadPoolJobTask::cancelled, ThreadPoolJobTask::queued))
+            return false;
+
+        // the task itself stays in its queue, and deletes itself when a thread picks it up
+        scheduler->unregisterJob (*this, *task);
+    }
+    else
+    {
+        if (job->isActive)
+            return false;
+
+        jobs.removeFirstMatchingValue (job);
+    }
+
+    addToDeleteList (deletionList, job);
+    return true;
+}
+
+bool ThreadPool::runNextJob (ThreadPoolThread* const thread)
 {
+    if (scheduler != nullptr)
+    {
+        if (Task* const task = findTask (thread))
+        {
+            task->run (thread);
+            return true;
+        }
+
+        return false;
+    }
+
     if (ThreadPoolJob* const job = pickNextJobToRun())
     {
         ThreadPoolJob::JobStatus result = ThreadPoolJob::jobHasFinished;
-        thread.currentJob = job;
+
+        if (thread != nullptr)
+            thread->currentJob = job;
 
         try
         {
@@ -345,7 +665,8 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
             jassertfalse; // Your runJob() method mustn't throw any exceptions!
         }
 
-        thread.currentJob = nullptr;
+        if (thread != nullptr)
+            thread->currentJob = nullptr;
 
         OwnedArray<ThreadPoolJob> deletionList;
 
@@ -385,3 +706,497 @@ void ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, Threa
     if (job->shouldBeDeleted)
         deletionList.add (job);
 }
+
+//==============================================================================
+void ThreadPool::runScheduledJob (ThreadPoolJobTask& task, ThreadPoolThread* const thread)
+{
+    ThreadPoolJob* const job = task.job;
+    ThreadPoolJob::JobStatus result = ThreadPoolJob::jobHasFinished;
+
+    job->isActive = true;
+
+    if (thread != nullptr)
+        thread->currentJob = job;
+
+    try
+    {
+        result = job->runJob();
+    }
+    catch (...)
+    {
+        jassertfalse; // Your runJob() method mustn't throw any exceptions!
+    }
+
+    if (thread != nullptr)
+        thread->currentJob = nullptr;
+
+    bool hasFinished = true;
+
+    {
+        OwnedArray<ThreadPoolJob> deletionList;
+        const ScopedLock sl (lock);
+
+        job->isActive = false;
+
+        if (result == ThreadPoolJob::jobNeedsRunningAgain && ! job->shouldStop)
+        {
+            task.state = ThreadPoolJobTask::queued;
+            hasFinished = false;
+        }
+        else
+        {
+            scheduler->unregisterJob (*this, task);
+            addToDeleteList (deletionList, job);
+            jobFinishedSignal.signal();
+        }
+    }
+
+    if (hasFinished)
+        delete &task;
+    else
+        spawnTask (&task, nullptr); // goes to the back of the shared queue, so other jobs get a turn
+}
+
+void ThreadPool::spawnTask (Task* const task, ThreadPoolThread* const currentThread)
+{
+    WorkStealingScheduler& s = *scheduler;
+
+    if (currentThread != nullptr)
+        s.deques.getUnchecked (currentThread->index)->push (task);
+    else
+        s.addInjectedTask (task);
+
+    // wake up one sleeping thread, if there are any
+    if (s.numSleepingThreads.value > 0)
+    {
+        for (int i = 0; i < threads.size(); ++i)
+        {
+            ThreadPoolThread* const t = threads.getUnchecked (i);
+
+            if (t->isSleeping.value != 0 && t->isSleeping.compareAndSetBool (0, 1))
+            {
+                t->notify();
+                break;
+            }
+        }
+    }
+}
+
+ThreadPool::Task* ThreadPool::findTask (ThreadPoolThread* const currentThread)
+{
+    WorkStealingScheduler& s = *scheduler;
+    WorkStealingScheduler::TaskDeque* localDeque = nullptr;
+
+    if (currentThread != nullptr)
+    {
+        localDeque = s.deques.getUnchecked (currentThread->index);
+
+        if (Task* const task = localDeque->pop())
+            return task;
+    }
+
+    if (Task* const task = s.takeInjectedTasks (localDeque))
+        return task;
+
+    const int numDeques = s.deques.size();
+    const int firstVictim = currentThread != nullptr ? currentThread->getRandomIndex (numDeques)
+                                                     : (int) (Time::getHighResolutionTicks() % numDeques);
+
+    for (int i = 0; i < numDeques; ++i)
+    {
+        WorkStealingScheduler::TaskDeque* const victim = s.deques.getUnchecked ((firstVictim + i) % numDeques);
+
+        if (victim != localDeque)
+            if (Task* const task = victim->steal())
+                return task;
+    }
+
+    return nullptr;
+}
+
+void ThreadPool::waitForMoreWork (ThreadPoolThread& thread)
+{
+    if (scheduler == nullptr)
+    {
+        thread.wait (500);
+        return;
+    }
+
+    // The flag has to be set before re-checking the queues: spawnTask() pushes its task
+    // before looking at the flags, so one side or the other is sure to notice.
+    ++(scheduler->numSleepingThreads);
+    thread.isSleeping = 1;
+
+    if (! scheduler->hasQueuedTasks())
+        thread.wait (500);
+
+    thread.isSleeping = 0;
+    --(scheduler->numSleepingThreads);
+}
+
+static void backOffWhileWaitingForTasks (int& numFailedAttempts)
+{
+    if (++numFailedAttempts < 64)
+        Thread::yield();
+    else
+        Thread::sleep (1);
+}
+
+void ThreadPool::runTasksUntilFinished (const Atomic<int>& numUnfinished, ThreadPoolThread* const currentThread)
+{
+    int numFailedAttempts = 0;
+
+    while (numUnfinished.get() > 0)
+    {
+        if (Task* const task = findTask (currentThread))
+        {
+            task->run (currentThread);
+            numFailedAttempts = 0;
+        }
+        else
+        {
+            backOffWhileWaitingForTasks (numFailedAttempts);
+        }
+    }
+}
+
+bool ThreadPool::waitForAll (const int timeOutMs)
+{
+    // A job can't wait for the pool to finish, because that would include itself!
+    jassert (getCurrentPoolThread() == nullptr);
+
+    const uint32 start = Time::getMillisecondCounter();
+    int numFailedAttempts = 0;
+
+    for (;;)
+    {
+        if (scheduler != nullptr ? numUnfinishedTasks.get() == 0 : getNumJobs() == 0)
+            return true;
+
+        if (timeOutMs >= 0 && Time::getMillisecondCounter() >= start + (uint32) timeOutMs)
+            return false;
+
+        if (runNextJob (nullptr))
+            numFailedAttempts = 0;
+        else
+            backOffWhileWaitingForTasks (numFailedAttempts);
+    }
+}
+
+ThreadPool::ThreadPoolThread* ThreadPool::getCurrentPoolThread() const
+{
+    if (ThreadPoolThread* const t = dynamic_cast<ThreadPoolThread*> (Thread::getCurrentThread()))
+        if (&(t->pool) == this)
+            return t;
+
+    return nullptr;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ThreadPoolTests  : public UnitTest
+{
+public:
+    ThreadPoolTests() : UnitTest ("ThreadPool") {}
+
+    struct CountingJob  : public ThreadPoolJob
+    {
+        CountingJob (Atomic<int>& c, int runs = 1)  : ThreadPoolJob ("counter"), counter (c), runsLeft (runs) {}
+
+        JobStatus runJob() override
+        {
+            ++counter;
+            return --runsLeft > 0 ? jobNeedsRunningAgain : jobHasFinished;
+        }
+
+        Atomic<int>& counter;
+        int runsLeft;
+    };
+
+    struct BlockingJob  : public ThreadPoolJob
+    {
+        BlockingJob()  : ThreadPoolJob ("blocker") {}
+
+        JobStatus runJob() override
+        {
+            while (! shouldExit())
+                if (release.wait (5))
+                    break;
+
+            return jobHasFinished;
+        }
+
+        WaitableEvent release;
+    };
+
+    // Adds two more copies of itself until the depth runs out, so a tree of
+    // 2^(depth + 1) - 1 jobs gets run altogether.
+    struct SpawningJob  : public ThreadPoolJob
+    {
+        SpawningJob (ThreadPool& p, Atomic<int>& c, int d)  : ThreadPoolJob ("spawner"), pool (p), counter (c), depth (d) {}
+
+        JobStatus runJob() override
+        {
+            if (depth > 0)
+            {
+                pool.addJob (new SpawningJob (pool, counter, depth - 1), true);
+                pool.addJob (new SpawningJob (pool, counter, depth - 1), true);
+            }
+
+            ++counter;
+            return jobHasFinished;
+        }
+
+        ThreadPool& pool;
+        Atomic<int>& counter;
+        const int depth;
+    };
+
+    struct AddToTotal
+    {
+        AddToTotal (Atomic<int64>& t) : total (t) {}
+        void operator() (int i) const      { total += (int64) i; }
+        Atomic<int64>& total;
+    };
+
+    struct MarkVisited
+    {
+        MarkVisited (Atomic<int>* v) : visits (v) {}
+        void operator() (int i) const      { ++(visits[i]); }
+        Atomic<int>* visits;
+    };
+
+    struct NestedLoop
+    {
+        NestedLoop (ThreadPool& p, Atomic<int64>& t) : pool (p), total (t) {}
+        void operator() (int) const        { pool.parallelFor (0, 100, AddToTotal (total), 7); }
+        ThreadPool& pool;
+        Atomic<int64>& total;
+    };
+
+    struct Square         { int64 operator() (int i) const               { return (int64) i * i; } };
+    struct Sum            { int64 operator() (int64 a, int64 b) const    { return a + b; } };
+    struct AppendDigit    { String operator() (int i) const              { return String (i % 10); } };
+    struct Concatenate    { String operator() (const String& a, const String& b) const  { return a + b; } };
+
+    struct SmallJob  : public ThreadPoolJob
+    {
+        SmallJob (Atomic<int>& c)  : ThreadPoolJob ("small"), counter (c) {}
+
+        JobStatus runJob() override
+        {
+            // (the result is used so that the work can't be optimised away)
+            if (doSomeWork (200) > 0.0f)
+                ++counter;
+
+            return jobHasFinished;
+        }
+
+        Atomic<int>& counter;
+    };
+
+    struct SmallWork
+    {
+        SmallWork (float* r)  : results (r) {}
+        void operator() (int i) const       { results[i] = doSomeWork (200); }
+
+        float* results;
+    };
+
+    static float doSomeWork (int numIterations)
+    {
+        float x = 1.0f;
+
+        for (int i = 0; i < numIterations; ++i)
+            x = x * 0.999f + 0.001f;
+
+        return x;
+    }
+
+    static int getNumTestThreads()      { return jlimit (2, 8, SystemStats::getNumCpus()); }
+
+    //==============================================================================
+    void testJobs (bool useWorkStealing)
+    {
+        ThreadPool pool (getNumTestThreads(), useWorkStealing);
+        expect (pool.usesWorkStealing() == useWorkStealing);
+
+        Atomic<int> counter;
+
+        for (int i = 0; i < 1000; ++i)
+            pool.addJob (new CountingJob (counter, 1 + i % 3), true);
+
+        expect (pool.waitForAll (10000));
+        expectEquals (counter.get(), 333 * 6 + 1);
+        expectEquals (pool.getNumJobs(), 0);
+    }
+
+    void testRemovingJobs (bool useWorkStealing)
+    {
+        ThreadPool pool (1, useWorkStealing);
+        Atomic<int> counter;
+
+        BlockingJob blocker;
+        pool.addJob (&blocker, false);
+
+        while (! pool.isJobRunning (&blocker))
+            Thread::sleep (1);
+
+        OwnedArray<CountingJob> queuedJobs;
+
+        for (int i = 0; i < 20; ++i)
+            pool.addJob (queuedJobs.add (new CountingJob (counter)), false);
+
+        expectEquals (pool.getNumJobs(), 21);
+        expectEquals (pool.getNamesOfAllJobs (true).size(), 1);
+        expect (pool.contains (queuedJobs[5]));
+        expect (! pool.isJobRunning (queuedJobs[5]));
+
+        for (int i = 0; i < 10; ++i)
+            expect (pool.removeJob (queuedJobs[i * 2], false, 0));
+
+        expectEquals (pool.getNumJobs(), 11);
+        expect (! pool.contains (queuedJobs[4]));
+
+        // removed jobs can be deleted straight away, even though they may still be
+        // sitting in one of the pool's queues
+        for (int i = 10; --i >= 0;)
+            queuedJobs.remove (i * 2);
+
+        blocker.release.signal();
+        expect (pool.waitForAll (10000));
+        expectEquals (counter.get(), 10);
+
+        pool.addJob (&blocker, false);
+
+        for (int i = 0; i < queuedJobs.size(); ++i)
+            pool.addJob (queuedJobs[i], false);
+
+        expect (pool.removeAllJobs (true, 10000));
+        expectEquals (pool.getNumJobs(), 0);
+    }
+
+    void testSpawningJobs()
+    {
+        ThreadPool pool (getNumTestThreads(), true);
+        Atomic<int> counter;
+
+        pool.addJob (new SpawningJob (pool, counter, 10), true);
+
+        expect (pool.waitForAll (10000));
+        expectEquals (counter.get(), (1 << 11) - 1);
+    }
+
+    void testParallelFor (bool useWorkStealing)
+    {
+        ThreadPool pool (getNumTestThreads(), useWorkStealing);
+        Random r (getRandom());
+
+        for (int i = 0; i < 20; ++i)
+        {
+            const int start = r.nextInt (100) - 50;
+            const int num = r.nextInt (5000);
+            const int grainSize = 1 + r.nextInt (300);
+
+            HeapBlock<Atomic<int> > visits ((size_t) num + 1, true);
+
+            pool.parallelFor (0, num, MarkVisited (visits), grainSize);
+
+            bool allVisitedOnce = true;
+
+            for (int j = 0; j < num; ++j)
+                allVisitedOnce = allVisitedOnce && visits[j].get() == 1;
+
+            expect (allVisitedOnce);
+
+            Atomic<int64> total;
+            pool.parallelFor (start, start + num, AddToTotal (total), grainSize);
+
+            int64 expectedTotal = 0;
+            int64 expectedSquares = 0;
+
+            for (int j = start; j < start + num; ++j)
+            {
+                expectedTotal += j;
+                expectedSquares += (int64) j * j;
+            }
+
+            expectEquals (total.get(), expectedTotal);
+            expectEquals (pool.parallelReduce (start, start + num, (int64) 0, Square(), Sum(), grainSize), expectedSquares);
+        }
+
+        // non-commutative combine functions must see the pieces in order
+        String expectedDigits;
+
+        for (int i = 0; i < 1000; ++i)
+            expectedDigits << (i % 10);
+
+        expectEquals (pool.parallelReduce (0, 1000, String(), AppendDigit(), Concatenate(), 17), expectedDigits);
+
+        Atomic<int64> nestedTotal;
+        pool.parallelFor (0, 50, NestedLoop (pool, nestedTotal));
+        expectEquals (nestedTotal.get(), (int64) 50 * 4950);
+    }
+
+    //==============================================================================
+    void runTest() override
+    {
+        beginTest ("Jobs");
+        testJobs (false);
+        testJobs (true);
+
+        beginTest ("Removing jobs");
+        testRemovingJobs (false);
+        testRemovingJobs (true);
+
+        beginTest ("Spawning jobs from inside jobs");
+        testSpawningJobs();
+
+        beginTest ("parallelFor and parallelReduce");
+        testParallelFor (false);
+        testParallelFor (true);
+
+        beginTest ("Performance");
+
+        const int numThreads = SystemStats::getNumCpus();
+        const int numJobs = 20000;
+
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            ThreadPool pool (numThreads, mode != 0);
+            Atomic<int> counter;
+
+            const double startTime = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < numJobs; ++i)
+                pool.addJob (new SmallJob (counter), true);
+
+            expect (pool.waitForAll (60000));
+
+            const double elapsed = Time::getMillisecondCounterHiRes() - startTime;
+
+            expectEquals (counter.get(), numJobs);
+            logMessage (String (mode != 0 ? "Work-stealing" : "Shared list") + " pool, " + String (numThreads)
+                          + " threads: " + String (numJobs) + " small jobs in " + String (elapsed, 1) + " ms");
+        }
+
+        {
+            ThreadPool pool (numThreads, true);
+            HeapBlock<float> results ((size_t) numJobs, true);
+
+            const double startTime = Time::getMillisecondCounterHiRes();
+            pool.parallelFor (0, numJobs, SmallWork (results), 16);
+            const double elapsed = Time::getMillisecondCounterHiRes() - startTime;
+
+            expect (results[0] > 0.0f && results[numJobs - 1] == results[0]);
+
+            logMessage ("parallelFor, " + String (numThreads) + " threads: " + String (numJobs)
+                          + " iterations in " + String (elapsed, 1) + " ms");
+        }
+    }
+};
+
+static ThreadPoolTests threadPoolUnitTests;
+
+#endif
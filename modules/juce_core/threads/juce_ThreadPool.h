@@ -31,6 +31,7 @@
 
 class ThreadPool;
 class ThreadPoolThread;
+struct ThreadPoolJobTask;
 
 
 //==============================================================================
@@ -129,8 +130,10 @@ public:
 private:
     friend class ThreadPool;
     friend class ThreadPoolThread;
+    friend struct ThreadPoolJobTask;
     String jobName;
     ThreadPool* pool;
+    ThreadPoolJobTask* scheduledTask;
     bool shouldStop, isActive, shouldBeDeleted;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolJob)
@@ -144,6 +147,12 @@ private:
     When a ThreadPoolJob object is added to the ThreadPool's list, its runJob() method
     will be called by the next pooled thread that becomes free.
 
+    A pool can optionally be created with a work-stealing scheduler, in which each thread
+    has its own queue of work: jobs added from inside a running job go onto the current
+    thread's queue, and threads that run out of work steal from the others. This avoids
+    contention on a single shared job list when there are many short jobs, and lets you
+    use parallelFor() and parallelReduce() to split up loops across the pool.
+
     @see ThreadPoolJob, Thread
 */
 class JUCE_API  ThreadPool
@@ -157,6 +166,18 @@ public:
     */
     ThreadPool (int numberOfThreads);
 
+    /** Creates a thread pool, optionally using a work-stealing scheduler.
+        @param numberOfThreads  the number of threads to run. These will be started
+                                immediately, and will run until the pool is deleted.
+        @param useWorkStealing  if true, each thread will keep its own queue of work
+                                and steal jobs from the other threads when it runs out,
+                                rather than all threads sharing one locked list of jobs.
+                                This is much more efficient when there are lots of short
+                                jobs, although jobs are no longer guaranteed to be started
+                                in the order in which they were added.
+    */
+    ThreadPool (int numberOfThreads, bool useWorkStealing);
+
     /** Creates a thread pool with one thread per CPU core.
         Once you've created a pool, you can give it some jobs by calling addJob().
         If you want to specify the number of threads, use the other constructor; this
@@ -206,6 +227,10 @@ public:
         If deleteJobWhenFinished is false, the pointer will be used but not deleted, and
         the caller is responsible for making sure the object is not deleted before it has
         been removed from the pool.
+
+        In a work-stealing pool, a job that is added from inside another job's runJob()
+        method is put on the current thread's own queue, so it'll be picked up by the same
+        thread unless an idle thread steals it first.
     */
     void addJob (ThreadPoolJob* job,
                  bool deleteJobWhenFinished);
@@ -250,6 +275,9 @@ public:
     */
     int getNumJobs() const;
 
+    /** Returns the number of threads assigned to this thread pool. */
+    int getNumThreads() const noexcept;
+
     /** Returns one of the jobs in the queue.
 
         Note that this can be a very volatile list as jobs might be continuously getting shifted
@@ -290,25 +318,193 @@ public:
     */
     bool setThreadPriorities (int newPriority);
 
+    //==============================================================================
+    /** Returns true if this pool was created with a work-stealing scheduler.
+        @see ThreadPool (int, bool)
+    */
+    bool usesWorkStealing() const noexcept              { return scheduler != nullptr; }
+
+    /** Waits until all the jobs in the pool have finished.
+
+        Rather than just blocking, the calling thread will pick up and run queued jobs
+        itself while it waits. This mustn't be called from inside one of the pool's jobs.
+
+        If the timeout period expires before the pool is empty, this will return false.
+    */
+    bool waitForAll (int timeOutMilliseconds = -1);
+
+    /** Calls function (i) for each integer i in the range start to (end - 1), spreading
+        the calls across the pool's threads, and returns when they've all finished.
+
+        The range is recursively split in half until each piece contains no more than
+        grainSize indexes, and idle threads steal the pieces that haven't been started yet.
+        The calling thread also runs pieces while it waits, so this can be used from
+        inside a job, or inside another call to parallelFor().
+
+        The function object can be any copyable type with an operator() that takes an int,
+        and it must be safe to call it from several threads at once.
+
+        If the pool doesn't use work-stealing, the calls are simply made in order on
+        the calling thread.
+    */
+    template <typename FunctionType>
+    void parallelFor (int start, int end, const FunctionType& function, int grainSize = 1)
+    {
+        jassert (grainSize > 0);
+        grainSize = jmax (1, grainSize);
+
+        if (scheduler == nullptr || end - start <= grainSize)
+        {
+            for (int i = start; i < end; ++i)
+                function (i);
+
+            return;
+        }
+
+        Atomic<int> numUnfinished (1);
+        ThreadPoolThread* const currentThread = getCurrentPoolThread();
+
+        (new ParallelForTask<FunctionType> (*this, function, start, end, grainSize, numUnfinished))->run (currentThread);
+        runTasksUntilFinished (numUnfinished, currentThread);
+    }
+
+    /** Calculates combine (... combine (combine (identity, function (start)), function (start + 1)) ...,
+        function (end - 1)), using parallelFor() to evaluate the range in pieces of grainSize indexes.
+
+        Each piece is reduced separately, starting from the identity value, and then the
+        partial results are combined in order, so the combine function has to be
+        associative, but needn't be commutative.
+    */
+    template <typename ValueType, typename FunctionType, typename CombineFunctionType>
+    ValueType parallelReduce (int start, int end, const ValueType& identity,
+                              const FunctionType& function, const CombineFunctionType& combine,
+                              int grainSize = 1)
+    {
+        jassert (grainSize > 0);
+        grainSize = jmax (1, grainSize);
+
+        const int numPieces = jmax (0, (end - start + grainSize - 1) / grainSize);
+
+        Array<ValueType> partialResults;
+        partialResults.insertMultiple (0, identity, numPieces);
+
+        parallelFor (0, numPieces, ReducePiece<ValueType, FunctionType, CombineFunctionType>
+                                      (start, end, grainSize, partialResults.getRawDataPointer(), function, combine));
+
+        ValueType result (identity);
+
+        for (int i = 0; i < numPieces; ++i)
+            result = combine (result, partialResults.getReference (i));
+
+        return result;
+    }
+
 
 private:
     //==============================================================================
     Array <ThreadPoolJob*> jobs;
 
     class ThreadPoolThread;
+    struct WorkStealingScheduler;
     friend class ThreadPoolJob;
     friend class ThreadPoolThread;
+    friend struct ThreadPoolJobTask;
     friend struct ContainerDeletePolicy<ThreadPoolThread>;
+    friend struct ContainerDeletePolicy<WorkStealingScheduler>;
     OwnedArray<ThreadPoolThread> threads;
+    ScopedPointer<WorkStealingScheduler> scheduler;
+    Atomic<int> numUnfinishedTasks;
 
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
-    bool runNextJob (ThreadPoolThread&);
+    //==============================================================================
+    /** A unit of work for the work-stealing scheduler. */
+    struct Task
+    {
+        Task (ThreadPool& p) noexcept : pool (p)    { ++pool.numUnfinishedTasks; }
+        virtual ~Task()                             { --pool.numUnfinishedTasks; }
+
+        /** Does the work and then either deletes the task or re-schedules it. */
+        virtual void run (ThreadPoolThread* currentThread) = 0;
+
+        ThreadPool& pool;
+
+        JUCE_DECLARE_NON_COPYABLE (Task)
+    };
+
+    template <typename FunctionType>
+    struct ParallelForTask  : public Task
+    {
+        ParallelForTask (ThreadPool& p, const FunctionType& f, int s, int e, int g, Atomic<int>& n) noexcept
+            : Task (p), function (f), start (s), end (e), grainSize (g), numUnfinished (n)
+        {
+        }
+
+        void run (ThreadPoolThread* currentThread) override
+        {
+            while (end - start > grainSize)
+            {
+                const int middle = start + (end - start) / 2;
+                ++numUnfinished;
+                pool.spawnTask (new ParallelForTask (pool, function, middle, end, grainSize, numUnfinished), currentThread);
+                end = middle;
+            }
+
+            for (int i = start; i < end; ++i)
+                function (i);
+
+            // The counter lives on the stack of the thread that called parallelFor(), so
+            // it mustn't be touched after the final decrement.
+            Atomic<int>& counter = numUnfinished;
+            delete this;
+            --counter;
+        }
+
+        const FunctionType& function;
+        int start, end;
+        const int grainSize;
+        Atomic<int>& numUnfinished;
+
+        JUCE_DECLARE_NON_COPYABLE (ParallelForTask)
+    };
+
+    template <typename ValueType, typename FunctionType, typename CombineFunctionType>
+    struct ReducePiece
+    {
+        ReducePiece (int s, int e, int g, ValueType* r, const FunctionType& f, const CombineFunctionType& c) noexcept
+            : start (s), end (e), grainSize (g), results (r), function (f), combine (c)
+        {
+        }
+
+        void operator() (int piece) const
+        {
+            ValueType& result = results[piece];
+            const int pieceStart = start + piece * grainSize;
+            const int pieceEnd = jmin (end, pieceStart + grainSize);
+
+            for (int i = pieceStart; i < pieceEnd; ++i)
+                result = combine (result, function (i));
+        }
+
+        const int start, end, grainSize;
+        ValueType* const results;
+        const FunctionType& function;
+        const CombineFunctionType& combine;
+    };
+
+    bool runNextJob (ThreadPoolThread*);
     ThreadPoolJob* pickNextJobToRun();
+    void runScheduledJob (ThreadPoolJobTask&, ThreadPoolThread*);
+    bool removeQueuedJob (ThreadPoolJob*, OwnedArray<ThreadPoolJob>&);
     void addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
-    void createThreads (int numThreads);
+    void createThreads (int numThreads, bool useWorkStealing);
     void stopThreads();
+    void waitForMoreWork (ThreadPoolThread&);
+    void spawnTask (Task*, ThreadPoolThread*);
+    Task* findTask (ThreadPoolThread*);
+    void runTasksUntilFinished (const Atomic<int>&, ThreadPoolThread*);
+    ThreadPoolThread* getCurrentPoolThread() const;
 
     // Note that this method has changed, and no longer has a parameter to indicate
     // whether the jobs should be deleted - see the new method for details.
@@ -37,6 +37,7 @@ namespace juce
 {
 
 #include "values/juce_Value.cpp"
+#include "values/juce_ValueTreeSnapshot.cpp"
 #include "values/juce_ValueTree.cpp"
 #include "values/juce_ValueTreeSynchroniser.cpp"
 #include "values/juce_CachedValue.cpp"
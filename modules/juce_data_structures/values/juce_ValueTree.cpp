@@ -22,19 +22,65 @@
   ==============================================================================
 */
 
+// Collects the changes and undoable actions that happen while a Transaction is active.
+// A batch is attached to the root of the tree that the transaction was started on, and
+// the SharedObject message functions hand their changes to it rather than calling the
+// listeners, so that they can all be delivered together when the batch is deleted.
+class ValueTree::Batch
+{
+public:
+    Batch (SharedObject& rootObject, UndoManager*);
+    ~Batch();
+
+    void addAction (UndoableAction*);
+
+    void recordPropertyChange (SharedObject&, const Identifier& property);
+    void recordChildAdded (SharedObject& parent, SharedObject& child);
+    void recordChildRemoved (SharedObject& parent, SharedObject& child, int index);
+    void recordChildOrderChanged (SharedObject& parent, int oldIndex, int newIndex);
+    void recordParentChanged (SharedObject&);
+
+    int getNumChanges() const noexcept      { return changes.size(); }
+
+    const ReferenceCountedObjectPtr<SharedObject> root;
+    UndoManager* const undoManager;
+
+    // The number of batches that currently exist, so that trees can skip looking for one
+    // in the usual case where there aren't any transactions going on. This is atomic
+    // because separate trees may be batched and edited on different threads.
+    static Atomic<int> numActive;
+
+private:
+    OwnedArray<UndoableAction> actions;
+    Array<Change> changes;
+    HashMap<const void*, int> propertyListIndexes;
+    OwnedArray<Array<Identifier> > changedProperties;
+    const SharedObject* lastPropertyTree;
+    Array<Identifier>* lastPropertyList;
+
+    void addChange (Change::Type, SharedObject& tree, SharedObject* child, const Identifier& property, int index, int newIndex);
+    void deliverChanges();
+
+    JUCE_DECLARE_NON_COPYABLE (Batch)
+};
+
+Atomic<int> ValueTree::Batch::numActive;
+
+//==============================================================================
 class ValueTree::SharedObject  : public ReferenceCountedObject
 {
 public:
     typedef ReferenceCountedObjectPtr<SharedObject> Ptr;
 
     explicit SharedObject (const Identifier& t) noexcept
-        : type (t), parent (nullptr)
+        : type (t), parent (nullptr), batch (nullptr)
     {
     }
 
     SharedObject (const SharedObject& other)
         : ReferenceCountedObject(),
-          type (other.type), properties (other.properties), parent (nullptr)
+          type (other.type), properties (other.properties), parent (nullptr),
+          snapshot (other.snapshot), batch (nullptr)
     {
         for (int i = 0; i < other.children.size(); ++i)
         {
@@ -44,6 +90,20 @@ public:
         }
     }
 
+    explicit SharedObject (ValueTreeSnapshot::Node& node)
+        : type (node.type), properties (node.properties), parent (nullptr),
+          snapshot (&node), batch (nullptr)
+    {
+        children.ensureStorageAllocated (node.children.size());
+
+        for (int i = 0; i < node.children.size(); ++i)
+        {
+            SharedObject* const child = new SharedObject (*node.children.getObjectPointerUnchecked(i));
+            child->parent = this;
+            children.add (child);
+        }
+    }
+
     ~SharedObject()
     {
         jassert (parent == nullptr); // this should never happen unless something isn't obeying the ref-counting!
@@ -53,7 +113,7 @@ public:
             const Ptr c (children.getObjectPointerUnchecked(i));
             c->parent = nullptr;
             children.remove (i);
-            c->sendParentChangeMessage();
+            c->sendParentChangeMessage (nullptr);
         }
     }
 
@@ -126,8 +186,68 @@ public:
         }
     }
 
+    //==============================================================================
+    // A snapshot node stays valid for as long as nothing in the subtree below it changes,
+    // so any change has to drop the cached nodes of all its ancestors. Nodes can only have
+    // a cached snapshot if their parent does too, so the walk can stop at the first one without.
+    void invalidateSnapshot() noexcept
+    {
+        for (SharedObject* t = this; t != nullptr && t->snapshot != nullptr; t = t->parent)
+            t->snapshot = nullptr;
+    }
+
+    ValueTreeSnapshot::Node* getSnapshot()
+    {
+        if (snapshot == nullptr)
+        {
+            ValueTreeSnapshot::Node* const node = new ValueTreeSnapshot::Node (type, properties);
+            node->children.ensureStorageAllocated (children.size());
+
+            for (int i = 0; i < children.size(); ++i)
+                node->children.add (children.getObjectPointerUnchecked(i)->getSnapshot());
+
+            snapshot = node;
+        }
+
+        return snapshot;
+    }
+
+    //==============================================================================
+    Batch* findBatch() const noexcept
+    {
+        if (Batch::numActive.get() > 0)
+            for (const SharedObject* t = this; t != nullptr; t = t->parent)
+                if (t->batch != nullptr)
+                    return t->batch;
+
+        return nullptr;
+    }
+
+    void perform (UndoableAction* action, UndoManager* undoManager)
+    {
+        jassert (undoManager != nullptr);
+
+        if (Batch* const b = findBatch())
+        {
+            if (b->undoManager == undoManager)
+            {
+                b->addAction (action);
+                return;
+            }
+        }
+
+        undoManager->perform (action);
+    }
+
+    //==============================================================================
     void sendPropertyChangeMessage (const Identifier& property)
     {
+        if (Batch* const b = findBatch())
+        {
+            b->recordPropertyChange (*this, property);
+            return;
+        }
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -136,6 +256,12 @@ public:
 
     void sendChildAddedMessage (ValueTree child)
     {
+        if (Batch* const b = findBatch())
+        {
+            b->recordChildAdded (*this, *child.object);
+            return;
+        }
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -144,6 +270,12 @@ public:
 
     void sendChildRemovedMessage (ValueTree child, int index)
     {
+        if (Batch* const b = findBatch())
+        {
+            b->recordChildRemoved (*this, *child.object, index);
+            return;
+        }
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
@@ -152,20 +284,33 @@ public:
 
     void sendChildOrderChangedMessage (int oldIndex, int newIndex)
     {
+        if (Batch* const b = findBatch())
+        {
+            b->recordChildOrderChanged (*this, oldIndex, newIndex);
+            return;
+        }
+
         ValueTree tree (this);
 
         for (ValueTree::SharedObject* t = this; t != nullptr; t = t->parent)
             t->callListeners (&ValueTree::Listener::valueTreeChildOrderChanged, tree, oldIndex, newIndex);
     }
 
-    void sendParentChangeMessage()
+    // The batch has to be passed in by the caller, because a child that has just been
+    // removed can no longer find the one that belongs to its old parent.
+    void sendParentChangeMessage (Batch* const b)
     {
-        ValueTree tree (this);
-
         for (int j = children.size(); --j >= 0;)
             if (SharedObject* const child = children.getObjectPointer (j))
-                child->sendParentChangeMessage();
+                child->sendParentChangeMessage (b);
 
+        if (b != nullptr)
+        {
+            b->recordParentChanged (*this);
+            return;
+        }
+
+        ValueTree tree (this);
         callListeners (&ValueTree::Listener::valueTreeParentChanged, tree);
     }
 
@@ -174,18 +319,21 @@ public:
         if (undoManager == nullptr)
         {
             if (properties.set (name, newValue))
+            {
+                invalidateSnapshot();
                 sendPropertyChangeMessage (name);
+            }
         }
         else
         {
             if (const var* const existingValue = properties.getVarPointer (name))
             {
                 if (*existingValue != newValue)
-                    undoManager->perform (new SetPropertyAction (this, name, newValue, *existingValue, false, false));
+                    perform (new SetPropertyAction (this, name, newValue, *existingValue, false, false), undoManager);
             }
             else
             {
-                undoManager->perform (new SetPropertyAction (this, name, newValue, var(), true, false));
+                perform (new SetPropertyAction (this, name, newValue, var(), true, false), undoManager);
             }
         }
     }
@@ -200,12 +348,15 @@ public:
         if (undoManager == nullptr)
         {
             if (properties.remove (name))
+            {
+                invalidateSnapshot();
                 sendPropertyChangeMessage (name);
+            }
         }
         else
         {
             if (properties.contains (name))
-                undoManager->perform (new SetPropertyAction (this, name, var(), properties [name], false, true));
+                perform (new SetPropertyAction (this, name, var(), properties [name], false, true), undoManager);
         }
     }
 
@@ -217,14 +368,15 @@ public:
             {
                 const Identifier name (properties.getName (properties.size() - 1));
                 properties.remove (name);
+                invalidateSnapshot();
                 sendPropertyChangeMessage (name);
             }
         }
         else
         {
             for (int i = properties.size(); --i >= 0;)
-                undoManager->perform (new SetPropertyAction (this, properties.getName(i), var(),
-                                                             properties.getValueAt(i), false, true));
+                perform (new SetPropertyAction (this, properties.getName(i), var(),
+                                                properties.getValueAt(i), false, true), undoManager);
         }
     }
 
@@ -312,15 +464,16 @@ public:
                 {
                     children.insert (index, child);
                     child->parent = this;
+                    invalidateSnapshot();
                     sendChildAddedMessage (ValueTree (child));
-                    child->sendParentChangeMessage();
+                    child->sendParentChangeMessage (findBatch());
                 }
                 else
                 {
                     if (! isPositiveAndBelow (index, children.size()))
                         index = children.size();
 
-                    undoManager->perform (new AddOrRemoveChildAction (this, index, child));
+                    perform (new AddOrRemoveChildAction (this, index, child), undoManager);
                 }
             }
             else
@@ -340,12 +493,13 @@ public:
             {
                 children.remove (childIndex);
                 child->parent = nullptr;
+                invalidateSnapshot();
                 sendChildRemovedMessage (ValueTree (child), childIndex);
-                child->sendParentChangeMessage();
+                child->sendParentChangeMessage (findBatch());
             }
             else
             {
-                undoManager->perform (new AddOrRemoveChildAction (this, childIndex, nullptr));
+                perform (new AddOrRemoveChildAction (this, childIndex, nullptr), undoManager);
             }
         }
     }
@@ -367,6 +521,7 @@ public:
             if (undoManager == nullptr)
             {
                 children.move (currentIndex, newIndex);
+                invalidateSnapshot();
                 sendChildOrderChangedMessage (currentIndex, newIndex);
             }
             else
@@ -374,7 +529,7 @@ public:
                 if (! isPositiveAndBelow (newIndex, children.size()))
                     newIndex = children.size() - 1;
 
-                undoManager->perform (new MoveChildAction (this, currentIndex, newIndex));
+                perform (new MoveChildAction (this, currentIndex, newIndex), undoManager);
             }
         }
     }
@@ -610,18 +765,234 @@ public:
         JUCE_DECLARE_NON_COPYABLE (MoveChildAction)
     };
 
+    //==============================================================================
+    // Holds all the actions that were performed during a Transaction, so that they can
+    // be undone and redone together, with the listeners getting a single set of changes.
+    class TransactionAction  : public UndoableAction
+    {
+    public:
+        TransactionAction (SharedObject* rootObject, OwnedArray<UndoableAction>& actionsToTake)
+            : root (rootObject), hasBeenPerformed (true)
+        {
+            actions.swapWith (actionsToTake);
+        }
+
+        bool perform() override
+        {
+            // The actions have already been performed by the time the transaction
+            // ends, so it's only a redo that needs to do anything here.
+            if (hasBeenPerformed)
+            {
+                hasBeenPerformed = false;
+                return true;
+            }
+
+            const ScopedPointer<Batch> b (createBatchIfNeeded());
+
+            for (int i = 0; i < actions.size(); ++i)
+                actions.getUnchecked(i)->perform();
+
+            return true;
+        }
+
+        bool undo() override
+        {
+            const ScopedPointer<Batch> b (createBatchIfNeeded());
+
+            for (int i = actions.size(); --i >= 0;)
+                actions.getUnchecked(i)->undo();
+
+            return true;
+        }
+
+        int getSizeInUnits() override
+        {
+            int total = 0;
+
+            for (int i = actions.size(); --i >= 0;)
+                total += actions.getUnchecked(i)->getSizeInUnits();
+
+            return jmax (1, total);
+        }
+
+    private:
+        const Ptr root;
+        OwnedArray<UndoableAction> actions;
+        bool hasBeenPerformed;
+
+        Batch* createBatchIfNeeded() const
+        {
+            return root->findBatch() == nullptr ? new Batch (*root, nullptr) : nullptr;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (TransactionAction)
+    };
+
     //==============================================================================
     const Identifier type;
     NamedValueSet properties;
     ReferenceCountedArray<SharedObject> children;
     SortedSet<ValueTree*> valueTreesWithListeners;
     SharedObject* parent;
+    ValueTreeSnapshot::Node::Ptr snapshot;
+    Batch* batch;
 
 private:
     SharedObject& operator= (const SharedObject&);
     JUCE_LEAK_DETECTOR (SharedObject)
 };
 
+//==============================================================================
+ValueTree::Batch::Batch (SharedObject& rootObject, UndoManager* um)
+    : root (&rootObject), undoManager (um), lastPropertyTree (nullptr), lastPropertyList (nullptr)
+{
+    jassert (root->batch == nullptr);
+    root->batch = this;
+    ++numActive;
+}
+
+ValueTree::Batch::~Batch()
+{
+    root->batch = nullptr;
+    --numActive;
+
+    if (undoManager != nullptr && actions.size() > 0)
+        undoManager->perform (new SharedObject::TransactionAction (root, actions));
+
+    deliverChanges();
+}
+
+void ValueTree::Batch::addAction (UndoableAction* const newAction)
+{
+    ScopedPointer<UndoableAction> action (newAction);
+
+    if (action->perform())
+    {
+        // Merge it with the previous one where possible, in the same way that the
+        // UndoManager would, so that repeated changes don't pile up.
+        if (UndoableAction* const lastAction = actions.getLast())
+        {
+            if (UndoableAction* const coalescedAction = lastAction->createCoalescedAction (action))
+            {
+                actions.removeLast();
+                action = coalescedAction;
+            }
+        }
+
+        actions.add (action.release());
+    }
+}
+
+void ValueTree::Batch::addChange (Change::Type changeType, SharedObject& tree, SharedObject* child,
+                                  const Identifier& property, int index, int newIndex)
+{
+    Change c;
+    c.type = changeType;
+    c.tree = ValueTree (&tree);
+    c.child = ValueTree (child);
+    c.property = property;
+    c.index = index;
+    c.newIndex = newIndex;
+    changes.add (c);
+}
+
+void ValueTree::Batch::recordPropertyChange (SharedObject& tree, const Identifier& property)
+{
+    // Bulk edits tend to change several properties of one node in a row, so it's
+    // worth remembering the last node's list to avoid looking it up every time.
+    if (lastPropertyTree != &tree)
+    {
+        int listIndex = propertyListIndexes [&tree];
+
+        if (listIndex == 0)
+        {
+            changedProperties.add (new Array<Identifier>());
+            listIndex = changedProperties.size();
+            propertyListIndexes.set (&tree, listIndex);
+        }
+
+        lastPropertyTree = &tree;
+        lastPropertyList = changedProperties.getUnchecked (listIndex - 1);
+    }
+
+    if (! lastPropertyList->contains (property))
+    {
+        lastPropertyList->add (property);
+        addChange (Change::propertyChanged, tree, nullptr, property, -1, -1);
+    }
+}
+
+void ValueTree::Batch::recordChildAdded (SharedObject& parent, SharedObject& child)
+{
+    addChange (Change::childAdded, parent, &child, Identifier(), parent.children.indexOf (&child), -1);
+}
+
+void ValueTree::Batch::recordChildRemoved (SharedObject& parent, SharedObject& child, int index)
+{
+    addChange (Change::childRemoved, parent, &child, Identifier(), index, -1);
+}
+
+void ValueTree::Batch::recordChildOrderChanged (SharedObject& parent, int oldIndex, int newIndex)
+{
+    addChange (Change::childOrderChanged, parent, nullptr, Identifier(), oldIndex, newIndex);
+}
+
+void ValueTree::Batch::recordParentChanged (SharedObject& tree)
+{
+    addChange (Change::parentChanged, tree, nullptr, Identifier(), -1, -1);
+}
+
+void ValueTree::Batch::deliverChanges()
+{
+    // Works out which of the changes each listened-to tree should be told about, using the
+    // shape of the tree as it is now that the transaction has finished. Parent changes only
+    // go to the tree itself, and everything else goes to the tree and all of its parents.
+    ReferenceCountedArray<SharedObject> targets;
+    OwnedArray<Array<Change> > targetChanges;
+    HashMap<const void*, int> targetIndexes;
+
+    for (int i = 0; i < changes.size(); ++i)
+    {
+        const Change& c = changes.getReference (i);
+
+        for (SharedObject* t = c.tree.object; t != nullptr; t = t->parent)
+        {
+            if (t->valueTreesWithListeners.size() > 0)
+            {
+                int targetIndex = targetIndexes [t];
+
+                if (targetIndex == 0)
+                {
+                    targets.add (t);
+                    targetChanges.add (new Array<Change>());
+                    targetIndex = targets.size();
+                    targetIndexes.set (t, targetIndex);
+                }
+
+                targetChanges.getUnchecked (targetIndex - 1)->add (c);
+            }
+
+            if (c.type == Change::parentChanged)
+                break;
+        }
+    }
+
+    for (int i = 0; i < targets.size(); ++i)
+    {
+        const SharedObject& target = *targets.getObjectPointerUnchecked (i);
+        const Array<Change>& list = *targetChanges.getUnchecked (i);
+        const SortedSet<ValueTree*> listenersCopy (target.valueTreesWithListeners);
+
+        for (int j = 0; j < listenersCopy.size(); ++j)
+        {
+            ValueTree* const v = listenersCopy.getUnchecked (j);
+
+            if (target.valueTreesWithListeners.contains (v))
+                v->listeners.call (&ValueTree::Listener::valueTreeTransactionCompleted, *v, list);
+        }
+    }
+}
+
 //==============================================================================
 ValueTree::ValueTree() noexcept
 {
@@ -702,6 +1073,16 @@ ValueTree ValueTree::createCopy() const
     return ValueTree (createCopyIfNotNull (object.get()));
 }
 
+ValueTreeSnapshot ValueTree::createSnapshot() const
+{
+    return ValueTreeSnapshot (object != nullptr ? object->getSnapshot() : nullptr);
+}
+
+ValueTree ValueTree::fromSnapshot (const ValueTreeSnapshot& snapshot)
+{
+    return ValueTree (snapshot.node != nullptr ? new SharedObject (*snapshot.node) : nullptr);
+}
+
 bool ValueTree::hasType (const Identifier& typeName) const noexcept
 {
     return object != nullptr && object->type == typeName;
@@ -956,6 +1337,32 @@ void ValueTree::sendPropertyChangeMessage (const Identifier& property)
         object->sendPropertyChangeMessage (property);
 }
 
+//==============================================================================
+ValueTree::Transaction::Transaction (const ValueTree& tree, UndoManager* undoManager)
+{
+    // If this tree is already part of a transaction, the changes just get added to that one.
+    if (tree.object != nullptr)
+    {
+        batch = tree.object->findBatch();
+
+        if (batch == nullptr)
+            batch = ownedBatch = new Batch (*tree.object, undoManager);
+    }
+    else
+    {
+        batch = nullptr;
+    }
+}
+
+ValueTree::Transaction::~Transaction()
+{
+}
+
+int ValueTree::Transaction::getNumChanges() const noexcept
+{
+    return batch != nullptr ? batch->getNumChanges() : 0;
+}
+
 //==============================================================================
 XmlElement* ValueTree::createXml() const
 {
@@ -1056,6 +1463,25 @@ ValueTree ValueTree::readFromGZIPData (const void* const data, const size_t numB
 
 void ValueTree::Listener::valueTreeRedirected (ValueTree&) {}
 
+void ValueTree::Listener::valueTreeTransactionCompleted (ValueTree&, const Array<Change>& changes)
+{
+    for (int i = 0; i < changes.size(); ++i)
+    {
+        const Change& c = changes.getReference (i);
+        ValueTree tree (c.tree), child (c.child);
+
+        switch (c.type)
+        {
+            case Change::propertyChanged:   valueTreePropertyChanged (tree, c.property); break;
+            case Change::childAdded:        valueTreeChildAdded (tree, child); break;
+            case Change::childRemoved:      valueTreeChildRemoved (tree, child, c.index); break;
+            case Change::childOrderChanged: valueTreeChildOrderChanged (tree, c.index, c.newIndex); break;
+            case Change::parentChanged:     valueTreeParentChanged (tree); break;
+            default:                        jassertfalse; break;
+        }
+    }
+}
+
 //==============================================================================
 #if JUCE_UNIT_TESTS
 
@@ -1143,6 +1569,242 @@ public:
             ValueTree v4 = v2.createCopy();
             expect (v1.isEquivalentTo (v4));
         }
+
+        testTransactions();
+        testTransactionUndo();
+        testTransactionPerformance();
+    }
+
+    //==============================================================================
+    struct CountingListener  : public ValueTree::Listener
+    {
+        CountingListener (bool batched) : useBatches (batched) {}
+
+        void valueTreePropertyChanged (ValueTree&, const Identifier&) override   { ++numPropertyChanges; }
+        void valueTreeChildAdded (ValueTree&, ValueTree&) override               { ++numChildChanges; }
+        void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override        { ++numChildChanges; }
+        void valueTreeChildOrderChanged (ValueTree&, int, int) override          { ++numChildChanges; }
+        void valueTreeParentChanged (ValueTree&) override                        { ++numParentChanges; }
+
+        void valueTreeTransactionCompleted (ValueTree& tree, const Array<ValueTree::Change>& changes) override
+        {
+            ++numTransactions;
+            lastChanges = changes;
+
+            if (! useBatches)
+                ValueTree::Listener::valueTreeTransactionCompleted (tree, changes);
+        }
+
+        const bool useBatches;
+        int numPropertyChanges = 0, numChildChanges = 0, numParentChanges = 0, numTransactions = 0;
+        Array<ValueTree::Change> lastChanges;
+    };
+
+    static ValueTree createTreeWithChildren (int numChildren)
+    {
+        ValueTree tree ("root");
+
+        for (int i = 0; i < numChildren; ++i)
+        {
+            ValueTree child ("child");
+            child.setProperty ("index", i, nullptr);
+            tree.addChild (child, -1, nullptr);
+        }
+
+        return tree;
+    }
+
+    void testTransactions()
+    {
+        beginTest ("Transactions");
+
+        ValueTree tree (createTreeWithChildren (4));
+        ValueTree child (tree.getChild (1));
+        CountingListener treeListener (true), childListener (true);
+        tree.addListener (&treeListener);
+        child.addListener (&childListener);
+
+        tree.setProperty ("a", 1, nullptr);
+        child.setProperty ("a", 1, nullptr);
+        expectEquals (treeListener.numPropertyChanges, 2);
+        expectEquals (treeListener.numTransactions, 0);
+
+        {
+            ValueTree::Transaction transaction (tree);
+
+            for (int i = 0; i < 10; ++i)
+                child.setProperty ("a", i, nullptr);
+
+            child.setProperty ("b", 2, nullptr);
+            tree.addChild (ValueTree ("new"), -1, nullptr);
+            tree.moveChild (0, 2, nullptr);
+
+            {
+                ValueTree::Transaction innerTransaction (child);
+                child.removeProperty ("b", nullptr);
+                expectEquals (innerTransaction.getNumChanges(), transaction.getNumChanges());
+            }
+
+            expectEquals (treeListener.numTransactions, 0);
+            expectEquals (transaction.getNumChanges(), 5); // includes the new child's parent change
+        }
+
+        expectEquals (treeListener.numPropertyChanges, 2);
+        expectEquals (treeListener.numChildChanges, 0);
+        expectEquals (treeListener.numTransactions, 1);
+        expectEquals (treeListener.lastChanges.size(), 4);
+        expect (treeListener.lastChanges[0].type == ValueTree::Change::propertyChanged);
+        expect (treeListener.lastChanges[0].tree == child && treeListener.lastChanges[0].property == Identifier ("a"));
+        expect (treeListener.lastChanges[2].type == ValueTree::Change::childAdded);
+        expect (treeListener.lastChanges[2].child == tree.getChild (4));
+        expect (treeListener.lastChanges[3].type == ValueTree::Change::childOrderChanged);
+
+        expectEquals (childListener.numTransactions, 1);
+        expectEquals (childListener.lastChanges.size(), 2);
+
+        {
+            ValueTree::Transaction transaction (tree);
+        }
+
+        expectEquals (treeListener.numTransactions, 1);
+
+        beginTest ("Transactions with the default callback");
+
+        CountingListener legacyListener (false);
+        ValueTree removed (tree.getChild (3));
+        tree.addListener (&legacyListener);
+        removed.addListener (&legacyListener);
+
+        {
+            ValueTree::Transaction transaction (tree);
+
+            for (int i = 0; i < 10; ++i)
+                tree.getChild (0).setProperty ("x", i, nullptr);
+
+            removed.setProperty ("x", 1, nullptr);
+            tree.removeChild (removed, nullptr);
+            expectEquals (legacyListener.numPropertyChanges, 0);
+        }
+
+        expectEquals (legacyListener.numTransactions, 2);
+        expectEquals (legacyListener.numPropertyChanges, 2);
+        expectEquals (legacyListener.numChildChanges, 1);
+        expectEquals (legacyListener.numParentChanges, 1);
+
+        tree.removeListener (&legacyListener);
+        removed.removeListener (&legacyListener);
+        tree.removeListener (&treeListener);
+        child.removeListener (&childListener);
+    }
+
+    void testTransactionUndo()
+    {
+        beginTest ("Transactions with an UndoManager");
+
+        const int numChildren = 100;
+        ValueTree tree (createTreeWithChildren (numChildren));
+        const ValueTree original (tree.createCopy());
+        CountingListener listener (true);
+        tree.addListener (&listener);
+
+        UndoManager undoManager;
+        undoManager.beginNewTransaction();
+
+        {
+            ValueTree::Transaction transaction (tree, &undoManager);
+
+            for (int i = 0; i < numChildren; ++i)
+            {
+                ValueTree child (tree.getChild (i));
+                child.setProperty ("index", -i, &undoManager);
+                child.setProperty ("gain", 0.5, &undoManager);
+            }
+
+            tree.addChild (ValueTree ("new"), -1, &undoManager);
+            tree.moveChild (0, 1, &undoManager);
+        }
+
+        const ValueTree edited (tree.createCopy());
+        expectEquals (undoManager.getNumActionsInCurrentTransaction(), 1);
+        expectEquals (listener.numTransactions, 1);
+        expectEquals (listener.lastChanges.size(), 2 * numChildren + 1);
+
+        expect (undoManager.undo());
+        expect (tree.isEquivalentTo (original));
+        expectEquals (listener.numTransactions, 2);
+        expectEquals (listener.numPropertyChanges, 0);
+
+        expect (undoManager.redo());
+        expect (tree.isEquivalentTo (edited));
+        expectEquals (listener.numTransactions, 3);
+        expectEquals (listener.lastChanges.size(), 2 * numChildren + 1);
+
+        tree.removeListener (&listener);
+    }
+
+    // Stands in for something like a component that has to refresh itself whenever the
+    // tree changes, which is where sending a callback for every edit gets expensive.
+    struct RefreshingListener  : public ValueTree::Listener
+    {
+        RefreshingListener (ValueTree& t) : tree (t)  { tree.addListener (this); }
+        ~RefreshingListener()                          { tree.removeListener (this); }
+
+        void refresh()
+        {
+            ++numRefreshes;
+            total = 0;
+
+            for (int i = 0; i < tree.getNumChildren(); ++i)
+                total += (int) tree.getChild (i)["a"];
+        }
+
+        void valueTreePropertyChanged (ValueTree&, const Identifier&) override                  { refresh(); }
+        void valueTreeChildAdded (ValueTree&, ValueTree&) override                              { refresh(); }
+        void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override                       { refresh(); }
+        void valueTreeChildOrderChanged (ValueTree&, int, int) override                         { refresh(); }
+        void valueTreeParentChanged (ValueTree&) override                                       {}
+        void valueTreeTransactionCompleted (ValueTree&, const Array<ValueTree::Change>&) override   { refresh(); }
+
+        ValueTree& tree;
+        int numRefreshes = 0, total = 0;
+    };
+
+    void testTransactionPerformance()
+    {
+        beginTest ("Transaction performance");
+
+        const int numChildren = 100, numPasses = 10, numProperties = 5;
+        const Identifier propertyNames[] = { "a", "b", "c", "d", "e" };
+        double times[2];
+        int numRefreshes[2];
+
+        for (int batched = 0; batched < 2; ++batched)
+        {
+            ValueTree tree (createTreeWithChildren (numChildren));
+            RefreshingListener listener (tree);
+
+            const double startTime = Time::getMillisecondCounterHiRes();
+
+            {
+                const ScopedPointer<ValueTree::Transaction> transaction (batched != 0 ? new ValueTree::Transaction (tree) : nullptr);
+
+                for (int pass = 1; pass <= numPasses; ++pass)
+                    for (int i = 0; i < numChildren; ++i)
+                        for (int p = 0; p < numProperties; ++p)
+                            tree.getChild (i).setProperty (propertyNames[p], pass, nullptr);
+            }
+
+            times[batched] = Time::getMillisecondCounterHiRes() - startTime;
+            numRefreshes[batched] = listener.numRefreshes;
+            expectEquals (listener.total, numChildren * numPasses);
+        }
+
+        expectEquals (numRefreshes[0], numChildren * numPasses * numProperties);
+        expectEquals (numRefreshes[1], 1);
+
+        logMessage ("Setting " + String (numChildren * numPasses * numProperties) + " properties: "
+                      + String (times[0], 2) + " ms with " + String (numRefreshes[0]) + " listener callbacks, "
+                      + String (times[1], 2) + " ms with a transaction and 1 callback");
     }
 };
 
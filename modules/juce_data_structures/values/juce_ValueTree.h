@@ -25,6 +25,7 @@
 #ifndef JUCE_VALUETREE_H_INCLUDED
 #define JUCE_VALUETREE_H_INCLUDED
 
+class ValueTreeSnapshot;
 
 //==============================================================================
 /**
@@ -129,6 +130,23 @@ public:
     /** Returns a deep copy of this tree and all its sub-nodes. */
     ValueTree createCopy() const;
 
+    /** Returns an immutable copy of the current state of this tree and all its sub-nodes.
+
+        Unlike createCopy(), this only has to create new nodes for the parts of the tree
+        which have been changed since the last snapshot was taken, and shares everything
+        else, so it's very quick even for big trees. The snapshot can be read on another
+        thread while this tree carries on being edited.
+
+        @see ValueTreeSnapshot, fromSnapshot
+    */
+    ValueTreeSnapshot createSnapshot() const;
+
+    /** Creates a new tree that contains the data from a snapshot.
+        The new tree is separate from the one that the snapshot was taken from.
+        @see createSnapshot
+    */
+    static ValueTree fromSnapshot (const ValueTreeSnapshot& snapshot);
+
     //==============================================================================
     /** Returns the type of this node.
         The type is specified when the ValueTree is created.
@@ -374,6 +392,8 @@ public:
     static ValueTree readFromGZIPData (const void* data, size_t numBytes);
 
     //==============================================================================
+    struct Change;
+
     /** Listener class for events that happen to a ValueTree.
 
         To get events from a ValueTree, make your class implement this interface, and use
@@ -443,6 +463,76 @@ public:
             will be made.
         */
         virtual void valueTreeRedirected (ValueTree& treeWhichHasBeenChanged);
+
+        /** This method is called at the end of a Transaction, with all the changes that
+            were made to the tree it's registered with (or any of its sub-nodes) during
+            the transaction.
+
+            Repeated changes to the same property are merged, so each changed property only
+            appears once in the list, and the listener will be called once per transaction
+            rather than once for every change.
+
+            The default implementation just passes each of the changes on to the
+            corresponding callback above, so you only need to override this if you can
+            handle a set of changes more efficiently than individual ones.
+
+            @see Transaction
+        */
+        virtual void valueTreeTransactionCompleted (ValueTree& treeWithListener,
+                                                    const Array<Change>& changes);
+    };
+
+private:
+    class Batch;
+
+public:
+    //==============================================================================
+    /**
+        Groups together a set of changes to a tree, so that its listeners are told about
+        them all at once when they're finished.
+
+        While one of these objects exists, any listener callbacks for changes to the tree
+        or its sub-nodes are held back. When it's deleted, the changes are merged and each
+        listener gets a single call to Listener::valueTreeTransactionCompleted(), so a
+        bulk edit doesn't trigger a callback for every individual change.
+
+        If an UndoManager is given, any changes that are made using that UndoManager during
+        the transaction are collected into a single undoable action, and undoing or redoing
+        that action also sends out a single set of changes.
+
+        E.g.
+        @code
+        {
+            ValueTree::Transaction transaction (tree, &undoManager);
+
+            for (int i = 0; i < tree.getNumChildren(); ++i)
+                tree.getChild (i).setProperty ("gain", 0.5, &undoManager);
+
+        } // the listeners are called here
+        @endcode
+
+        Transactions can be nested - an inner one on the same tree or any of its sub-nodes
+        simply becomes part of the outer one. Like the rest of ValueTree, transactions
+        aren't thread-safe, and should be used on the same thread as the tree's other
+        operations.
+    */
+    class JUCE_API  Transaction
+    {
+    public:
+        /** Begins a transaction for a tree and all its sub-nodes. */
+        Transaction (const ValueTree& tree, UndoManager* undoManager = nullptr);
+
+        /** Ends the transaction, and delivers the changes to the tree's listeners. */
+        ~Transaction();
+
+        /** Returns the number of changes that have been made so far, after merging. */
+        int getNumChanges() const noexcept;
+
+    private:
+        ScopedPointer<Batch> ownedBatch;
+        Batch* batch;
+
+        JUCE_DECLARE_NON_COPYABLE (Transaction)
     };
 
     /** Adds a listener to receive callbacks when this node is changed.
@@ -518,6 +608,7 @@ private:
     //==============================================================================
     JUCE_PUBLIC_IN_DLL_BUILD (class SharedObject)
     friend class SharedObject;
+    friend class ValueTreeSynchroniser;
 
     ReferenceCountedObjectPtr<SharedObject> object;
     ListenerList<Listener> listeners;
@@ -543,5 +634,29 @@ private:
     explicit ValueTree (SharedObject*) noexcept;
 };
 
+//==============================================================================
+/**
+    Describes one of the changes that was made to a ValueTree during a Transaction.
+
+    @see ValueTree::Transaction, ValueTree::Listener::valueTreeTransactionCompleted
+*/
+struct JUCE_API  ValueTree::Change
+{
+    enum Type
+    {
+        propertyChanged,    /**< A property of tree was changed or removed. */
+        childAdded,         /**< The child was added to tree. */
+        childRemoved,       /**< The child was removed from tree, at the position given by index. */
+        childOrderChanged,  /**< One of tree's children was moved from index to newIndex. */
+        parentChanged       /**< Tree, or one of its parents, was added to or removed from a parent. */
+    };
+
+    Type type;
+    ValueTree tree;         /**< The tree whose properties or children changed. */
+    ValueTree child;        /**< For childAdded and childRemoved, the child that was involved. */
+    Identifier property;    /**< For propertyChanged, the property that changed. */
+    int index, newIndex;    /**< For childRemoved and childOrderChanged, the positions of the child. */
+};
+
 
 #endif   // JUCE_VALUETREE_H_INCLUDED
@@ -0,0 +1,457 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+class ValueTreeSnapshot::Node  : public ReferenceCountedObject
+{
+public:
+    typedef ReferenceCountedObjectPtr<Node> Ptr;
+
+    Node (const Identifier& t, const NamedValueSet& props)
+        : type (t), properties (props)
+    {
+    }
+
+    bool isEquivalentTo (const Node& other) const noexcept
+    {
+        if (this == &other)
+            return true;
+
+        if (type != other.type
+             || properties.size() != other.properties.size()
+             || children.size() != other.children.size()
+             || properties != other.properties)
+            return false;
+
+        for (int i = 0; i < children.size(); ++i)
+            if (! children.getObjectPointerUnchecked(i)->isEquivalentTo (*other.children.getObjectPointerUnchecked(i)))
+                return false;
+
+        return true;
+    }
+
+    XmlElement* createXml() const
+    {
+        XmlElement* const xml = new XmlElement (type);
+        properties.copyToXmlAttributes (*xml);
+
+        for (int i = children.size(); --i >= 0;)
+            xml->prependChildElement (children.getObjectPointerUnchecked(i)->createXml());
+
+        return xml;
+    }
+
+    void writeToStream (OutputStream& output) const
+    {
+        output.writeString (type.toString());
+        output.writeCompressedInt (properties.size());
+
+        for (int j = 0; j < properties.size(); ++j)
+        {
+            output.writeString (properties.getName (j).toString());
+            properties.getValueAt(j).writeToStream (output);
+        }
+
+        output.writeCompressedInt (children.size());
+
+        for (int i = 0; i < children.size(); ++i)
+            children.getObjectPointerUnchecked(i)->writeToStream (output);
+    }
+
+    // None of these are changed once the node has been handed out in a snapshot
+    const Identifier type;
+    const NamedValueSet properties;
+    ReferenceCountedArray<Node> children;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE (Node)
+};
+
+//==============================================================================
+ValueTreeSnapshot::ValueTreeSnapshot() noexcept {}
+ValueTreeSnapshot::ValueTreeSnapshot (Node* n) noexcept  : node (n) {}
+ValueTreeSnapshot::ValueTreeSnapshot (const ValueTreeSnapshot& other) noexcept  : node (other.node) {}
+ValueTreeSnapshot::~ValueTreeSnapshot() {}
+
+ValueTreeSnapshot& ValueTreeSnapshot::operator= (const ValueTreeSnapshot& other) noexcept
+{
+    node = other.node;
+    return *this;
+}
+
+bool ValueTreeSnapshot::operator== (const ValueTreeSnapshot& other) const noexcept    { return node == other.node; }
+bool ValueTreeSnapshot::operator!= (const ValueTreeSnapshot& other) const noexcept    { return node != other.node; }
+
+bool ValueTreeSnapshot::isEquivalentTo (const ValueTreeSnapshot& other) const
+{
+    return node == other.node
+            || (node != nullptr && other.node != nullptr
+                 && node->isEquivalentTo (*other.node));
+}
+
+Identifier ValueTreeSnapshot::getType() const noexcept
+{
+    return node != nullptr ? node->type : Identifier();
+}
+
+bool ValueTreeSnapshot::hasType (const Identifier& typeName) const noexcept
+{
+    return node != nullptr && node->type == typeName;
+}
+
+const var& ValueTreeSnapshot::getProperty (const Identifier& name) const noexcept
+{
+    return node == nullptr ? var::null : node->properties[name];
+}
+
+var ValueTreeSnapshot::getProperty (const Identifier& name, const var& defaultReturnValue) const
+{
+    return node == nullptr ? defaultReturnValue
+                           : node->properties.getWithDefault (name, defaultReturnValue);
+}
+
+const var& ValueTreeSnapshot::operator[] (const Identifier& name) const noexcept
+{
+    return getProperty (name);
+}
+
+bool ValueTreeSnapshot::hasProperty (const Identifier& name) const noexcept
+{
+    return node != nullptr && node->properties.contains (name);
+}
+
+int ValueTreeSnapshot::getNumProperties() const noexcept
+{
+    return node == nullptr ? 0 : node->properties.size();
+}
+
+Identifier ValueTreeSnapshot::getPropertyName (const int index) const noexcept
+{
+    return node == nullptr ? Identifier()
+                           : node->properties.getName (index);
+}
+
+int ValueTreeSnapshot::getNumChildren() const noexcept
+{
+    return node == nullptr ? 0 : node->children.size();
+}
+
+ValueTreeSnapshot ValueTreeSnapshot::getChild (int index) const
+{
+    return ValueTreeSnapshot (node != nullptr ? node->children.getObjectPointer (index)
+                                              : static_cast<Node*> (nullptr));
+}
+
+ValueTreeSnapshot ValueTreeSnapshot::getChildWithName (const Identifier& typeToMatch) const
+{
+    if (node != nullptr)
+    {
+        for (int i = 0; i < node->children.size(); ++i)
+        {
+            Node* const child = node->children.getObjectPointerUnchecked (i);
+
+            if (child->type == typeToMatch)
+                return ValueTreeSnapshot (child);
+        }
+    }
+
+    return ValueTreeSnapshot();
+}
+
+XmlElement* ValueTreeSnapshot::createXml() const
+{
+    return node != nullptr ? node->createXml() : nullptr;
+}
+
+void ValueTreeSnapshot::writeToStream (OutputStream& output) const
+{
+    if (node != nullptr)
+    {
+        node->writeToStream (output);
+    }
+    else
+    {
+        output.writeString (String());
+        output.writeCompressedInt (0);
+        output.writeCompressedInt (0);
+    }
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ValueTreeSnapshotTests  : public UnitTest
+{
+public:
+    ValueTreeSnapshotTests() : UnitTest ("ValueTreeSnapshot") {}
+
+    static ValueTree createTree (int numChildren, int numGrandchildren)
+    {
+        ValueTree root ("root");
+        root.setProperty ("name", "project", nullptr);
+
+        for (int i = 0; i < numChildren; ++i)
+        {
+            ValueTree child ("track");
+            child.setProperty ("index", i, nullptr);
+            child.setProperty ("name", "Track " + String (i), nullptr);
+
+            for (int j = 0; j < numGrandchildren; ++j)
+            {
+                ValueTree grandchild ("clip");
+                grandchild.setProperty ("start", j * 1.5, nullptr);
+                grandchild.setProperty ("length", 1.0, nullptr);
+                child.addChild (grandchild, -1, nullptr);
+            }
+
+            root.addChild (child, -1, nullptr);
+        }
+
+        return root;
+    }
+
+    static bool matches (const ValueTreeSnapshot& snapshot, const ValueTree& tree)
+    {
+        MemoryOutputStream s1, s2;
+        snapshot.writeToStream (s1);
+        tree.writeToStream (s2);
+        return s1.getMemoryBlock() == s2.getMemoryBlock();
+    }
+
+    // Returns the number of nodes in a snapshot which aren't shared with an older one
+    static int countNewNodes (const ValueTreeSnapshot& newer, const ValueTreeSnapshot& older)
+    {
+        if (newer == older)
+            return 0;
+
+        int total = 1;
+
+        for (int i = 0; i < newer.getNumChildren(); ++i)
+            total += countNewNodes (newer.getChild (i), older.getChild (i));
+
+        return total;
+    }
+
+    static int countNodes (const ValueTree& tree)
+    {
+        int total = 1;
+
+        for (int i = 0; i < tree.getNumChildren(); ++i)
+            total += countNodes (tree.getChild (i));
+
+        return total;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Snapshots match the tree");
+        {
+            ValueTree tree (createTree (10, 5));
+            const ValueTreeSnapshot snapshot (tree.createSnapshot());
+
+            expect (matches (snapshot, tree));
+            expect (snapshot.getNumChildren() == 10);
+            expect (snapshot.getChild (3).getProperty ("name") == var ("Track 3"));
+            expect (snapshot.getChildWithName ("track").getChild (4).hasType ("clip"));
+            expect (! snapshot.getChild (10).isValid());
+
+            ScopedPointer<XmlElement> xml1 (snapshot.createXml()), xml2 (tree.createXml());
+            expect (xml1->isEquivalentTo (xml2, false));
+
+            const ValueTree restored (ValueTree::fromSnapshot (snapshot));
+            expect (restored.isEquivalentTo (tree));
+            expect (restored.createSnapshot() == snapshot);
+
+            expect (! ValueTree().createSnapshot().isValid());
+            expect (! ValueTree::fromSnapshot (ValueTreeSnapshot()).isValid());
+        }
+
+        beginTest ("Unchanged nodes are shared");
+        {
+            ValueTree tree (createTree (20, 10));
+            const ValueTreeSnapshot s1 (tree.createSnapshot());
+            expect (tree.createSnapshot() == s1);
+
+            tree.getChild (7).getChild (3).setProperty ("length", 2.0, nullptr);
+            const ValueTreeSnapshot s2 (tree.createSnapshot());
+
+            expect (matches (s2, tree));
+            expect ((double) s1.getChild (7).getChild (3)["length"] == 1.0);
+            expect ((double) s2.getChild (7).getChild (3)["length"] == 2.0);
+            expect (countNewNodes (s2, s1) == 3);
+
+            for (int i = 0; i < 20; ++i)
+                expect ((s1.getChild (i) == s2.getChild (i)) == (i != 7));
+
+            tree.getChild (2).removeChild (0, nullptr);
+            tree.getChild (4).addChild (ValueTree ("clip"), 0, nullptr);
+            tree.getChild (5).moveChild (0, 9, nullptr);
+            tree.getChild (6).removeProperty ("name", nullptr);
+            tree.getChild (8).removeAllProperties (nullptr);
+            tree.getChild (8).setProperty ("name", "x", nullptr);
+
+            const ValueTreeSnapshot s3 (tree.createSnapshot());
+            expect (matches (s3, tree));
+            expect (matches (s2, ValueTree::fromSnapshot (s2)));
+            expect (s3.getChild (7) == s2.getChild (7));
+            expect (s3.getChild (9) == s1.getChild (9));
+
+            const int changedChildren[] = { 2, 4, 5, 6, 8 };
+
+            for (int i = 0; i < numElementsInArray (changedChildren); ++i)
+                expect (s3.getChild (changedChildren[i]) != s2.getChild (changedChildren[i]));
+
+            expect (s3.getChild (3) == s1.getChild (3));
+
+            // a copy of the tree starts off sharing the same snapshot
+            expect (tree.createCopy().createSnapshot() == s3);
+        }
+
+        beginTest ("Undo and redo");
+        {
+            UndoManager undoManager;
+            ValueTree tree (createTree (5, 5));
+            const ValueTreeSnapshot before (tree.createSnapshot());
+
+            undoManager.beginNewTransaction();
+            tree.getChild (1).setProperty ("name", "changed", &undoManager);
+            tree.getChild (2).addChild (ValueTree ("clip"), -1, &undoManager);
+            tree.removeChild (3, &undoManager);
+            const ValueTreeSnapshot after (tree.createSnapshot());
+            expect (matches (after, tree));
+            expect (! after.isEquivalentTo (before));
+
+            undoManager.undo();
+            expect (matches (tree.createSnapshot(), tree));
+            expect (tree.createSnapshot().isEquivalentTo (before));
+
+            undoManager.redo();
+            expect (tree.createSnapshot().isEquivalentTo (after));
+        }
+
+        beginTest ("Reading snapshots on another thread");
+        {
+            struct Reader  : public Thread
+            {
+                Reader() : Thread ("ValueTreeSnapshot test"), numRead (0), allConsistent (true) {}
+
+                void run() override
+                {
+                    while (! threadShouldExit())
+                    {
+                        ValueTreeSnapshot s;
+
+                        {
+                            const ScopedLock sl (lock);
+                            s = latest;
+                        }
+
+                        if (s.isValid())
+                        {
+                            // every snapshot's total must match the root's record of it
+                            int64 total = 0;
+
+                            for (int i = 0; i < s.getNumChildren(); ++i)
+                                for (int j = 0; j < s.getChild (i).getNumChildren(); ++j)
+                                    total += (int64) s.getChild (i).getChild (j)["value"];
+
+                            if (total != (int64) s["total"])
+                                allConsistent = false;
+
+                            ++numRead;
+                        }
+                    }
+                }
+
+                CriticalSection lock;
+                ValueTreeSnapshot latest;
+                Atomic<int> numRead;
+                bool allConsistent;
+            };
+
+            ValueTree tree (createTree (50, 20));
+            tree.setProperty ("total", 0, nullptr);
+            Random r (getRandom());
+            int64 total = 0;
+
+            Reader reader;
+            reader.startThread();
+
+            for (int i = 0; i < 5000 || reader.numRead.get() < 100; ++i)
+            {
+                ValueTree clip (tree.getChild (r.nextInt (50)).getChild (r.nextInt (20)));
+                const int newValue = r.nextInt (1000);
+                total += newValue - (int) clip["value"];
+                clip.setProperty ("value", newValue, nullptr);
+                tree.setProperty ("total", total, nullptr);
+
+                const ValueTreeSnapshot s (tree.createSnapshot());
+                const ScopedLock sl (reader.lock);
+                reader.latest = s;
+            }
+
+            reader.stopThread (5000);
+            expect (reader.allConsistent);
+        }
+
+        beginTest ("Performance compared with createCopy()");
+        {
+            ValueTree tree (createTree (500, 40));
+            const int numNodes = countNodes (tree);
+            const int numEdits = 100;
+            Random r (getRandom());
+
+            double copyTime = 0, snapshotTime = 0;
+            int newNodes = 0;
+            ValueTreeSnapshot previous (tree.createSnapshot());
+
+            for (int i = 0; i < numEdits; ++i)
+            {
+                tree.getChild (r.nextInt (500)).getChild (r.nextInt (40)).setProperty ("length", r.nextDouble(), nullptr);
+
+                double start = Time::getMillisecondCounterHiRes();
+                const ValueTree copy (tree.createCopy());
+                copyTime += Time::getMillisecondCounterHiRes() - start;
+
+                start = Time::getMillisecondCounterHiRes();
+                const ValueTreeSnapshot snapshot (tree.createSnapshot());
+                snapshotTime += Time::getMillisecondCounterHiRes() - start;
+
+                newNodes += countNewNodes (snapshot, previous);
+                previous = snapshot;
+            }
+
+            logMessage ("Snapshotting a " + String (numNodes) + " node tree after each edit:");
+            logMessage ("  createCopy():     " + String (copyTime / numEdits, 3) + " ms, "
+                          + String (numNodes) + " new nodes");
+            logMessage ("  createSnapshot(): " + String (snapshotTime / numEdits, 3) + " ms, "
+                          + String (newNodes / (double) numEdits, 1) + " new nodes");
+
+            expect (newNodes == numEdits * 3);
+        }
+    }
+};
+
+static ValueTreeSnapshotTests valueTreeSnapshotTests;
+
+#endif
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_VALUETREESNAPSHOT_H_INCLUDED
+#define JUCE_VALUETREESNAPSHOT_H_INCLUDED
+
+
+//==============================================================================
+/**
+    An immutable copy of the state of a ValueTree at a particular moment.
+
+    Snapshots are created with ValueTree::createSnapshot(). Each node of a ValueTree
+    keeps hold of the snapshot that was last made of it until it or one of its sub-nodes
+    is changed, so when a new snapshot is taken, all the parts of the tree which haven't
+    changed are shared with the previous one, and only the nodes along the paths to the
+    changes are created again. This makes it cheap to take snapshots of a large tree for
+    things like undo histories or auto-saving.
+
+    Copying a ValueTreeSnapshot just creates another reference to the same data, and
+    because the data can never change, a snapshot can be passed to another thread and
+    read there while the original tree carries on being edited. The only thing to
+    be careful of is that property values which are objects or arrays are shared
+    by reference rather than copied, so they mustn't be modified while a snapshot
+    that contains them is being read.
+
+    To turn a snapshot back into a ValueTree that can be edited, use ValueTree::fromSnapshot().
+
+    @see ValueTree::createSnapshot, ValueTree::fromSnapshot
+*/
+class JUCE_API  ValueTreeSnapshot
+{
+public:
+    //==============================================================================
+    /** Creates an empty, invalid snapshot. */
+    ValueTreeSnapshot() noexcept;
+
+    /** Creates another reference to the same snapshot. */
+    ValueTreeSnapshot (const ValueTreeSnapshot&) noexcept;
+
+    /** Makes this refer to another snapshot. */
+    ValueTreeSnapshot& operator= (const ValueTreeSnapshot&) noexcept;
+
+    /** Destructor. */
+    ~ValueTreeSnapshot();
+
+    /** Returns true if this refers to some data. */
+    bool isValid() const noexcept                           { return node != nullptr; }
+
+    /** Returns true if both snapshots refer to the same shared node.
+        Nodes that haven't changed between two snapshots of a tree are shared, so this
+        is a quick way of finding out which parts of a tree have been changed.
+    */
+    bool operator== (const ValueTreeSnapshot&) const noexcept;
+
+    /** Returns true if the snapshots refer to different nodes. */
+    bool operator!= (const ValueTreeSnapshot&) const noexcept;
+
+    /** Performs a deep comparison between the properties and children of two snapshots.
+        This is very quick for any parts of the trees that are shared.
+    */
+    bool isEquivalentTo (const ValueTreeSnapshot&) const;
+
+    //==============================================================================
+    /** Returns the type of the node. */
+    Identifier getType() const noexcept;
+
+    /** Returns true if the node has this type. */
+    bool hasType (const Identifier& typeName) const noexcept;
+
+    /** Returns the value of a named property, or a void var if it doesn't exist. */
+    const var& getProperty (const Identifier& name) const noexcept;
+
+    /** Returns the value of a named property, or a default value if it doesn't exist. */
+    var getProperty (const Identifier& name, const var& defaultReturnValue) const;
+
+    /** Returns the value of a named property, or a void var if it doesn't exist. */
+    const var& operator[] (const Identifier& name) const noexcept;
+
+    /** Returns true if the node contains a named property. */
+    bool hasProperty (const Identifier& name) const noexcept;
+
+    /** Returns the number of properties that the node contains. */
+    int getNumProperties() const noexcept;
+
+    /** Returns the name of one of the properties. */
+    Identifier getPropertyName (int index) const noexcept;
+
+    //==============================================================================
+    /** Returns the number of child nodes. */
+    int getNumChildren() const noexcept;
+
+    /** Returns one of the child nodes, or an invalid snapshot if the index is out of range. */
+    ValueTreeSnapshot getChild (int index) const;
+
+    /** Returns the first child node with the given type, or an invalid snapshot if there isn't one. */
+    ValueTreeSnapshot getChildWithName (const Identifier& type) const;
+
+    //==============================================================================
+    /** Creates an XmlElement that holds the same data as the equivalent ValueTree would.
+        The caller must delete the object that is returned.
+        @see ValueTree::createXml
+    */
+    XmlElement* createXml() const;
+
+    /** Writes the snapshot in the same binary format as ValueTree::writeToStream(),
+        so it can be read back with ValueTree::readFromStream().
+    */
+    void writeToStream (OutputStream& output) const;
+
+private:
+    //==============================================================================
+    class Node;
+    friend class ValueTree;
+
+    ReferenceCountedObjectPtr<Node> node;
+
+    explicit ValueTreeSnapshot (Node*) noexcept;
+
+    JUCE_LEAK_DETECTOR (ValueTreeSnapshot)
+};
+
+
+#endif   // JUCE_VALUETREESNAPSHOT_H_INCLUDED
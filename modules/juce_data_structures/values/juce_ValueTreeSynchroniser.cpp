@@ -30,7 +30,15 @@ namespace ValueTreeSynchroniserHelpers
         fullSync         = 2,
         childAdded       = 3,
         childRemoved     = 4,
-        childMoved       = 5
+        childMoved       = 5,
+        compactPacket    = 6,
+        propertyRemoved  = 7
+    };
+
+    enum PacketFlags
+    {
+        packetIsCompressed       = 1,
+        packetResetsIdentifiers  = 2
     };
 
     static void getValueTreePath (ValueTree v, const ValueTree& topLevelTree, Array<int>& path)
@@ -52,20 +60,54 @@ namespace ValueTreeSynchroniserHelpers
         stream.writeByte ((char) type);
     }
 
-    static void writeHeader (ValueTreeSynchroniser& target, MemoryOutputStream& stream,
-                             ChangeType type, ValueTree v)
+    // Packet versions are written 7 bits at a time, so that they stay small
+    static void writeVersion (OutputStream& stream, int64 version)
     {
-        writeHeader (stream, type);
+        uint64 v = (uint64) version;
 
-        Array<int> path;
-        getValueTreePath (v, target.getRoot(), path);
+        while (v >= 0x80)
+        {
+            stream.writeByte ((char) (0x80 | (v & 0x7f)));
+            v >>= 7;
+        }
+
+        stream.writeByte ((char) v);
+    }
+
+    static int64 readVersion (InputStream& stream)
+    {
+        uint64 v = 0;
 
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const uint8 byte = (uint8) stream.readByte();
+            v |= ((uint64) (byte & 0x7f)) << shift;
+
+            if ((byte & 0x80) == 0)
+                break;
+        }
+
+        return (int64) v;
+    }
+
+    static void writePath (OutputStream& stream, const Array<int>& path)
+    {
         stream.writeCompressedInt (path.size());
 
         for (int i = path.size(); --i >= 0;)
             stream.writeCompressedInt (path.getUnchecked(i));
     }
 
+    static void writeHeader (ValueTreeSynchroniser& target, MemoryOutputStream& stream,
+                             ChangeType type, ValueTree v)
+    {
+        writeHeader (stream, type);
+
+        Array<int> path;
+        getValueTreePath (v, target.getRoot(), path);
+        writePath (stream, path);
+    }
+
     static ValueTree readSubTreeLocation (MemoryInputStream& input, ValueTree v)
     {
         const int numLevels = input.readCompressedInt();
@@ -87,7 +129,229 @@ namespace ValueTreeSynchroniserHelpers
     }
 }
 
-ValueTreeSynchroniser::ValueTreeSynchroniser (const ValueTree& tree)  : valueTree (tree)
+//==============================================================================
+// Builds the packets for the compact encoding. Changes are written into a buffer as they
+// happen, apart from property changes, which are held back so that repeated changes to
+// the same property can be merged. Each property keeps the path it had when it first
+// changed, and any structural change writes out the waiting properties before itself, so
+// that the receiver always applies them to the right nodes.
+struct ValueTreeSynchroniser::CompactEncoder
+{
+    CompactEncoder() : version (0), numIdentifiersSent (0), numChanges (0), logSize (0) {}
+
+    void writeIdentifier (OutputStream& out, const Identifier& id)
+    {
+        // The identifiers array holds on to the pooled strings, so their addresses can't be reused
+        const void* const key = id.getCharPointer().getAddress();
+        int index = identifierIndexes [key];
+
+        if (index == 0)
+        {
+            identifiers.add (id);
+            index = identifiers.size();
+            identifierIndexes.set (key, index);
+        }
+
+        out.writeCompressedInt (index - 1);
+    }
+
+    void writeTree (OutputStream& out, const ValueTree& v)
+    {
+        writeIdentifier (out, v.getType());
+        out.writeCompressedInt (v.getNumProperties());
+
+        for (int i = 0; i < v.getNumProperties(); ++i)
+        {
+            const Identifier name (v.getPropertyName (i));
+            writeIdentifier (out, name);
+            v.getProperty (name).writeToStream (out);
+        }
+
+        out.writeCompressedInt (v.getNumChildren());
+
+        for (int i = 0; i < v.getNumChildren(); ++i)
+            writeTree (out, v.getChild (i));
+    }
+
+    void addPropertyChange (const ValueTree& root, const ValueTree& tree, const Identifier& property,
+                            bool mayAlreadyBePending)
+    {
+        // The pending entries hold on to their trees, so a node's address can't be reused
+        // while it's in the index
+        const void* const node = tree.object.get();
+        int listIndex = pendingPropertyListIndexes [node];
+
+        if (listIndex == 0)
+        {
+            pendingPropertyLists.add (new Array<Identifier>());
+            listIndex = pendingPropertyLists.size();
+            pendingPropertyListIndexes.set (node, listIndex);
+        }
+
+        Array<Identifier>& nodeProperties = *pendingPropertyLists.getUnchecked (listIndex - 1);
+
+        if (mayAlreadyBePending && nodeProperties.contains (property))
+            return;
+
+        nodeProperties.add (property);
+
+        PendingProperty p;
+        p.tree = tree;
+        p.property = property;
+        ValueTreeSynchroniserHelpers::getValueTreePath (tree, root, p.path);
+        pendingProperties.add (p);
+    }
+
+    void writePendingProperties()
+    {
+        for (int i = 0; i < pendingProperties.size(); ++i)
+        {
+            const PendingProperty& p = pendingProperties.getReference (i);
+            const var* const value = p.tree.getPropertyPointer (p.property);
+
+            changes.writeByte ((char) (value != nullptr ? ValueTreeSynchroniserHelpers::propertyChanged
+                                                        : ValueTreeSynchroniserHelpers::propertyRemoved));
+            ValueTreeSynchroniserHelpers::writePath (changes, p.path);
+            writeIdentifier (changes, p.property);
+
+            if (value != nullptr)
+                value->writeToStream (changes);
+        }
+
+        numChanges += pendingProperties.size();
+        clearPendingProperties();
+    }
+
+    void clearPendingProperties()
+    {
+        pendingProperties.clearQuick();
+        pendingPropertyListIndexes.clear();
+        pendingPropertyLists.clear();
+    }
+
+    void startChange (ValueTreeSynchroniserHelpers::ChangeType type, const ValueTree& root, const ValueTree& tree)
+    {
+        writePendingProperties();
+        changes.writeByte ((char) type);
+
+        Array<int> path;
+        ValueTreeSynchroniserHelpers::getValueTreePath (tree, root, path);
+        ValueTreeSynchroniserHelpers::writePath (changes, path);
+        ++numChanges;
+    }
+
+    void startFullSync (const ValueTree& root)
+    {
+        clearPendingProperties();
+        changes.reset();
+        identifiers.clearQuick();
+        identifierIndexes.clear();
+        numIdentifiersSent = 0;
+
+        changes.writeByte ((char) ValueTreeSynchroniserHelpers::fullSync);
+        writeTree (changes, root);
+        numChanges = 1;
+    }
+
+    MemoryBlock createPacket (bool resetsIdentifiers, int compressionLevel)
+    {
+        MemoryOutputStream payload;
+        ValueTreeSynchroniserHelpers::writeVersion (payload, ++version);
+        payload.writeCompressedInt (identifiers.size() - numIdentifiersSent);
+
+        for (int i = numIdentifiersSent; i < identifiers.size(); ++i)
+            payload.writeString (identifiers.getReference (i).toString());
+
+        numIdentifiersSent = identifiers.size();
+        payload.writeCompressedInt (numChanges);
+        payload.write (changes.getData(), changes.getDataSize());
+
+        changes.reset();
+        numChanges = 0;
+
+        MemoryOutputStream packet;
+        packet.writeByte ((char) ValueTreeSynchroniserHelpers::compactPacket);
+        int flags = resetsIdentifiers ? ValueTreeSynchroniserHelpers::packetResetsIdentifiers : 0;
+
+        if (compressionLevel > 0 && payload.getDataSize() > 64)
+        {
+            MemoryOutputStream compressed;
+
+            {
+                GZIPCompressorOutputStream zipper (&compressed, compressionLevel);
+                zipper.write (payload.getData(), payload.getDataSize());
+            }
+
+            if (compressed.getDataSize() < payload.getDataSize())
+            {
+                packet.writeByte ((char) (flags | ValueTreeSynchroniserHelpers::packetIsCompressed));
+                packet << compressed.getMemoryBlock();
+                return packet.getMemoryBlock();
+            }
+        }
+
+        packet.writeByte ((char) flags);
+        packet << payload.getMemoryBlock();
+        return packet.getMemoryBlock();
+    }
+
+    void addToLog (const MemoryBlock& packet, size_t maxLogSize)
+    {
+        LoggedPacket* const p = new LoggedPacket();
+        p->version = version;
+        p->data = packet;
+        deltaLog.add (p);
+        logSize += packet.getSize();
+
+        while (logSize > maxLogSize && deltaLog.size() > 0)
+        {
+            logSize -= deltaLog.getFirst()->data.getSize();
+            deltaLog.remove (0);
+        }
+    }
+
+    bool logContainsAllChangesSince (int64 receiverVersion) const noexcept
+    {
+        if (receiverVersion == version)
+            return true;
+
+        return receiverVersion >= 0 && receiverVersion < version
+                && deltaLog.size() > 0 && deltaLog.getFirst()->version <= receiverVersion + 1;
+    }
+
+    struct PendingProperty
+    {
+        ValueTree tree;
+        Identifier property;
+        Array<int> path;
+    };
+
+    struct LoggedPacket
+    {
+        int64 version;
+        MemoryBlock data;
+    };
+
+    int64 version;
+    Array<Identifier> identifiers;
+    HashMap<const void*, int> identifierIndexes;
+    int numIdentifiersSent;
+
+    MemoryOutputStream changes;
+    int numChanges;
+    Array<PendingProperty> pendingProperties;
+    HashMap<const void*, int> pendingPropertyListIndexes;
+    OwnedArray<Array<Identifier> > pendingPropertyLists;
+
+    OwnedArray<LoggedPacket> deltaLog;
+    size_t logSize;
+
+    JUCE_DECLARE_NON_COPYABLE (CompactEncoder)
+};
+
+//==============================================================================
+ValueTreeSynchroniser::ValueTreeSynchroniser (const ValueTree& tree)
+    : valueTree (tree), coalescingInterval (0), compressionLevel (0), maxDeltaLogSize (65536)
 {
     valueTree.addListener (this);
 }
@@ -99,14 +363,121 @@ ValueTreeSynchroniser::~ValueTreeSynchroniser()
 
 void ValueTreeSynchroniser::sendFullSyncCallback()
 {
+    if (encoder != nullptr)
+    {
+        stopTimer();
+        encoder->startFullSync (valueTree);
+        sendPacket (encoder->createPacket (true, compressionLevel));
+        return;
+    }
+
     MemoryOutputStream m;
     writeHeader (m, ValueTreeSynchroniserHelpers::fullSync);
     valueTree.writeToStream (m);
     stateChanged (m.getData(), m.getDataSize());
 }
 
+//==============================================================================
+void ValueTreeSynchroniser::setCompactEncoding (bool shouldUseCompactEncoding)
+{
+    if (shouldUseCompactEncoding != isUsingCompactEncoding())
+    {
+        stopTimer();
+        encoder = shouldUseCompactEncoding ? new CompactEncoder() : nullptr;
+    }
+}
+
+void ValueTreeSynchroniser::setCoalescingInterval (int milliseconds)
+{
+    jassert (milliseconds >= 0);
+    coalescingInterval = jmax (0, milliseconds);
+
+    if (coalescingInterval == 0)
+        flushPendingChanges();
+}
+
+void ValueTreeSynchroniser::setCompressionLevel (int newLevel)
+{
+    jassert (newLevel >= 0 && newLevel <= 9);
+    compressionLevel = jlimit (0, 9, newLevel);
+}
+
+void ValueTreeSynchroniser::setMaximumDeltaLogSize (size_t numBytes)
+{
+    maxDeltaLogSize = numBytes;
+}
+
+int64 ValueTreeSynchroniser::getCurrentVersion() const noexcept
+{
+    return encoder != nullptr ? encoder->version : 0;
+}
+
+void ValueTreeSynchroniser::flushPendingChanges()
+{
+    if (encoder != nullptr)
+    {
+        stopTimer();
+        encoder->writePendingProperties();
+
+        if (encoder->numChanges > 0)
+            sendPacket (encoder->createPacket (false, compressionLevel));
+    }
+}
+
+void ValueTreeSynchroniser::sendChangesSince (int64 receiverVersion)
+{
+    flushPendingChanges();
+
+    if (encoder != nullptr && encoder->logContainsAllChangesSince (receiverVersion))
+    {
+        for (int i = 0; i < encoder->deltaLog.size(); ++i)
+        {
+            const CompactEncoder::LoggedPacket& p = *encoder->deltaLog.getUnchecked (i);
+
+            if (p.version > receiverVersion)
+                stateChanged (p.data.getData(), p.data.getSize());
+        }
+    }
+    else
+    {
+        sendFullSyncCallback();
+    }
+}
+
+void ValueTreeSynchroniser::sendPacket (const MemoryBlock& packet)
+{
+    encoder->addToLog (packet, maxDeltaLogSize);
+    stateChanged (packet.getData(), packet.getSize());
+}
+
+void ValueTreeSynchroniser::changeWasQueued()
+{
+    if (coalescingInterval > 0)
+    {
+        if (! isTimerRunning())
+            startTimer (coalescingInterval);
+    }
+    else
+    {
+        flushPendingChanges();
+    }
+}
+
+void ValueTreeSynchroniser::timerCallback()
+{
+    flushPendingChanges();
+}
+
+//==============================================================================
 void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Identifier& property)
 {
+    if (encoder != nullptr)
+    {
+        encoder->addPropertyChange (valueTree, vt, property, true);
+        changeWasQueued();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::propertyChanged, vt);
     m.writeString (property.toString());
@@ -119,6 +490,15 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
     const int index = parentTree.indexOf (childTree);
     jassert (index >= 0);
 
+    if (encoder != nullptr)
+    {
+        encoder->startChange (ValueTreeSynchroniserHelpers::childAdded, valueTree, parentTree);
+        encoder->changes.writeCompressedInt (index);
+        encoder->writeTree (encoder->changes, childTree);
+        changeWasQueued();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childAdded, parentTree);
     m.writeCompressedInt (index);
@@ -128,6 +508,14 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
 
 void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueTree&, int oldIndex)
 {
+    if (encoder != nullptr)
+    {
+        encoder->startChange (ValueTreeSynchroniserHelpers::childRemoved, valueTree, parentTree);
+        encoder->changes.writeCompressedInt (oldIndex);
+        changeWasQueued();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childRemoved, parentTree);
     m.writeCompressedInt (oldIndex);
@@ -136,6 +524,15 @@ void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueT
 
 void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex)
 {
+    if (encoder != nullptr)
+    {
+        encoder->startChange (ValueTreeSynchroniserHelpers::childMoved, valueTree, parent);
+        encoder->changes.writeCompressedInt (oldIndex);
+        encoder->changes.writeCompressedInt (newIndex);
+        changeWasQueued();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childMoved, parent);
     m.writeCompressedInt (oldIndex);
@@ -145,6 +542,49 @@ void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int o
 
 void ValueTreeSynchroniser::valueTreeParentChanged (ValueTree&)  {} // (No action needed here)
 
+void ValueTreeSynchroniser::valueTreeTransactionCompleted (ValueTree&, const Array<ValueTree::Change>& changes)
+{
+    // The changes in a transaction are reported after they've all been made, so the
+    // positions of any nodes are the ones they have at the end. That's fine for property
+    // changes, but structural changes couldn't be replayed in order on the other side,
+    // so if there are any of those, it's simplest to send the whole tree again.
+    for (int i = 0; i < changes.size(); ++i)
+    {
+        const ValueTree::Change::Type type = changes.getReference (i).type;
+
+        if (type != ValueTree::Change::propertyChanged && type != ValueTree::Change::parentChanged)
+        {
+            sendFullSyncCallback();
+            return;
+        }
+    }
+
+    // A transaction only reports each property once, so its changes can only duplicate
+    // ones that were already waiting to be sent before it.
+    const bool mayAlreadyBePending = encoder != nullptr && encoder->pendingProperties.size() > 0;
+
+    for (int i = 0; i < changes.size(); ++i)
+    {
+        const ValueTree::Change& c = changes.getReference (i);
+
+        if (c.type == ValueTree::Change::propertyChanged)
+        {
+            if (encoder != nullptr)
+            {
+                encoder->addPropertyChange (valueTree, c.tree, c.property, mayAlreadyBePending);
+            }
+            else
+            {
+                ValueTree tree (c.tree);
+                valueTreePropertyChanged (tree, c.property);
+            }
+        }
+    }
+
+    if (encoder != nullptr)
+        changeWasQueued();
+}
+
 bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size_t dataSize, UndoManager* undoManager)
 {
     MemoryInputStream input (data, dataSize, false);
@@ -215,3 +655,555 @@ bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size
 
     return false;
 }
+
+//==============================================================================
+ValueTreeSynchroniser::Receiver::Receiver (ValueTree& targetTree, UndoManager* um)
+    : target (targetTree), undoManager (um), version (-1)
+{
+}
+
+ValueTreeSynchroniser::Receiver::~Receiver()
+{
+}
+
+bool ValueTreeSynchroniser::Receiver::applyChange (const void* data, size_t dataSize)
+{
+    if (dataSize == 0)
+        return false;
+
+    if (*static_cast<const char*> (data) != (char) ValueTreeSynchroniserHelpers::compactPacket)
+        return ValueTreeSynchroniser::applyChange (target, data, dataSize, undoManager);
+
+    MemoryInputStream input (data, dataSize, false);
+    input.readByte();
+    const int flags = input.readByte();
+
+    if ((flags & ValueTreeSynchroniserHelpers::packetIsCompressed) != 0)
+    {
+        MemoryBlock payload;
+
+        {
+            GZIPDecompressorInputStream unzipper (input);
+            unzipper.readIntoMemoryBlock (payload);
+        }
+
+        MemoryInputStream payloadStream (payload, false);
+        return applyPacket (payloadStream, flags);
+    }
+
+    return applyPacket (input, flags);
+}
+
+bool ValueTreeSynchroniser::Receiver::applyPacket (MemoryInputStream& input, int flags)
+{
+    const int64 packetVersion = ValueTreeSynchroniserHelpers::readVersion (input);
+
+    if ((flags & ValueTreeSynchroniserHelpers::packetResetsIdentifiers) != 0)
+    {
+        identifiers.clearQuick();
+    }
+    else if (version < 0 || packetVersion > version + 1)
+    {
+        return false; // some earlier packets have been missed, so this one can't be applied
+    }
+    else if (packetVersion <= version)
+    {
+        return true;  // this one has already been applied
+    }
+
+    const int numNewIdentifiers = input.readCompressedInt();
+
+    if (! isPositiveAndBelow (numNewIdentifiers, 65536)) // sanity-check
+        return resyncNeeded();
+
+    for (int i = 0; i < numNewIdentifiers; ++i)
+    {
+        const String name (input.readString());
+
+        if (name.isEmpty())
+            return resyncNeeded();
+
+        identifiers.add (Identifier (name));
+    }
+
+    const int numChanges = input.readCompressedInt();
+
+    if (numChanges < 0)
+        return resyncNeeded();
+
+    for (int i = 0; i < numChanges; ++i)
+        if (! applyPacketChange (input))
+            return resyncNeeded();
+
+    version = packetVersion;
+    return true;
+}
+
+bool ValueTreeSynchroniser::Receiver::applyPacketChange (MemoryInputStream& input)
+{
+    const int type = input.readByte();
+
+    if (type == ValueTreeSynchroniserHelpers::fullSync)
+    {
+        const ValueTree newTree (readTree (input));
+
+        if (! newTree.isValid())
+            return false;
+
+        target = newTree;
+        return true;
+    }
+
+    ValueTree v (ValueTreeSynchroniserHelpers::readSubTreeLocation (input, target));
+
+    if (! v.isValid())
+        return false;
+
+    switch (type)
+    {
+        case ValueTreeSynchroniserHelpers::propertyChanged:
+        case ValueTreeSynchroniserHelpers::propertyRemoved:
+        {
+            Identifier property;
+
+            if (! readIdentifier (input, property))
+                return false;
+
+            if (type == ValueTreeSynchroniserHelpers::propertyChanged)
+                v.setProperty (property, var::readFromStream (input), undoManager);
+            else
+                v.removeProperty (property, undoManager);
+
+            return true;
+        }
+
+        case ValueTreeSynchroniserHelpers::childAdded:
+        {
+            const int index = input.readCompressedInt();
+            const ValueTree child (readTree (input));
+
+            if (! child.isValid())
+                return false;
+
+            v.addChild (child, index, undoManager);
+            return true;
+        }
+
+        case ValueTreeSynchroniserHelpers::childRemoved:
+        {
+            const int index = input.readCompressedInt();
+
+            if (! isPositiveAndBelow (index, v.getNumChildren()))
+                return false;
+
+            v.removeChild (index, undoManager);
+            return true;
+        }
+
+        case ValueTreeSynchroniserHelpers::childMoved:
+        {
+            const int oldIndex = input.readCompressedInt();
+            const int newIndex = input.readCompressedInt();
+
+            if (! (isPositiveAndBelow (oldIndex, v.getNumChildren())
+                    && isPositiveAndBelow (newIndex, v.getNumChildren())))
+                return false;
+
+            v.moveChild (oldIndex, newIndex, undoManager);
+            return true;
+        }
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+bool ValueTreeSynchroniser::Receiver::readIdentifier (InputStream& input, Identifier& result) const
+{
+    const int index = input.readCompressedInt();
+
+    if (! isPositiveAndBelow (index, identifiers.size()))
+        return false;
+
+    result = identifiers.getReference (index);
+    return true;
+}
+
+ValueTree ValueTreeSynchroniser::Receiver::readTree (InputStream& input) const
+{
+    Identifier type;
+
+    if (! readIdentifier (input, type))
+        return ValueTree();
+
+    ValueTree v (type);
+    const int numProperties = input.readCompressedInt();
+
+    if (numProperties < 0)
+        return ValueTree();
+
+    for (int i = 0; i < numProperties; ++i)
+    {
+        Identifier name;
+
+        if (! readIdentifier (input, name))
+            return ValueTree();
+
+        v.setProperty (name, var::readFromStream (input), nullptr);
+    }
+
+    const int numChildren = input.readCompressedInt();
+
+    if (numChildren < 0)
+        return ValueTree();
+
+    for (int i = 0; i < numChildren; ++i)
+    {
+        const ValueTree child (readTree (input));
+
+        if (! child.isValid())
+            return ValueTree();
+
+        v.addChild (child, -1, nullptr);
+    }
+
+    return v;
+}
+
+bool ValueTreeSynchroniser::Receiver::resyncNeeded()
+{
+    // The tree may have been partly changed, so it can only be fixed by a full sync
+    jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+    version = -1;
+    return false;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ValueTreeSynchroniserTests  : public UnitTest
+{
+public:
+    ValueTreeSynchroniserTests() : UnitTest ("ValueTreeSynchroniser") {}
+
+    struct TestSynchroniser  : public ValueTreeSynchroniser
+    {
+        TestSynchroniser (const ValueTree& t) : ValueTreeSynchroniser (t) {}
+
+        void stateChanged (const void* data, size_t size) override
+        {
+            messages.add (MemoryBlock (data, size));
+            totalBytes += size;
+        }
+
+        // Passes the messages that have been sent to a receiver, skipping some of them
+        // if they should be treated as having been lost.
+        int deliver (ValueTreeSynchroniser::Receiver& receiver, int numToDrop = 0)
+        {
+            int numRejected = 0;
+
+            for (int i = 0; i < messages.size(); ++i)
+                if (i >= numToDrop && ! receiver.applyChange (messages.getReference(i).getData(), messages.getReference(i).getSize()))
+                    ++numRejected;
+
+            messages.clearQuick();
+            return numRejected;
+        }
+
+        Array<MemoryBlock> messages;
+        size_t totalBytes = 0;
+    };
+
+    static void makeRandomChange (ValueTree v, Random& r)
+    {
+        while (v.getNumChildren() > 0 && r.nextInt (3) != 0)
+            v = v.getChild (r.nextInt (v.getNumChildren()));
+
+        const Identifier names[] = { "level", "pan", "name", "mute" };
+
+        switch (r.nextInt (7))
+        {
+            case 0:
+            case 1:
+            case 2:     v.setProperty (names [r.nextInt (4)], r.nextInt (1000), nullptr); break;
+            case 3:     v.removeProperty (names [r.nextInt (4)], nullptr); break;
+
+            case 4:
+            {
+                ValueTree child ("node");
+                child.setProperty (names [r.nextInt (4)], r.nextDouble(), nullptr);
+                child.addChild (ValueTree ("leaf"), -1, nullptr);
+                v.addChild (child, r.nextInt (v.getNumChildren() + 1), nullptr);
+                break;
+            }
+
+            case 5:     if (v.getNumChildren() > 0) v.removeChild (r.nextInt (v.getNumChildren()), nullptr); break;
+            case 6:     if (v.getNumChildren() > 1) v.moveChild (0, v.getNumChildren() - 1, nullptr); break;
+            default:    break;
+        }
+    }
+
+    // Coalescing can change the order of a node's properties (e.g. when one is removed and
+    // then added again), and ValueTree doesn't guarantee their order, so this ignores it.
+    static bool haveSameContent (const ValueTree& a, const ValueTree& b)
+    {
+        if (a.getType() != b.getType()
+             || a.getNumProperties() != b.getNumProperties()
+             || a.getNumChildren() != b.getNumChildren())
+            return false;
+
+        for (int i = 0; i < a.getNumProperties(); ++i)
+        {
+            const Identifier name (a.getPropertyName (i));
+
+            if (! (b.hasProperty (name) && a[name] == b[name]))
+                return false;
+        }
+
+        for (int i = 0; i < a.getNumChildren(); ++i)
+            if (! haveSameContent (a.getChild (i), b.getChild (i)))
+                return false;
+
+        return true;
+    }
+
+    static ValueTree createControlSurface (int numParameters)
+    {
+        ValueTree state ("surface");
+
+        for (int i = 0; i < numParameters; ++i)
+        {
+            ValueTree parameter ("parameter");
+            parameter.setProperty ("id", "param" + String (i), nullptr);
+            parameter.setProperty ("value", 0.0, nullptr);
+            state.addChild (parameter, -1, nullptr);
+        }
+
+        return state;
+    }
+
+    void runTest() override
+    {
+        Random r = getRandom();
+
+        beginTest ("Compact encoding");
+        {
+            for (int settings = 0; settings < 3; ++settings)
+            {
+                ValueTree source (createControlSurface (4)), target;
+                TestSynchroniser sync (source);
+                ValueTreeSynchroniser::Receiver receiver (target);
+
+                sync.setCompactEncoding (true);
+                sync.setCompressionLevel (settings == 2 ? 6 : 0);
+                sync.setCoalescingInterval (settings != 0 ? 60000 : 0);
+                sync.sendFullSyncCallback();
+                sync.deliver (receiver);
+                expect (haveSameContent (target, source));
+
+                for (int i = 0; i < 200; ++i)
+                {
+                    makeRandomChange (source, r);
+
+                    if (settings != 0 && r.nextInt (5) != 0)
+                        continue; // lets several changes build up into a single packet
+
+                    sync.flushPendingChanges();
+                    expectEquals (sync.deliver (receiver), 0);
+                    expect (haveSameContent (target, source));
+                }
+
+                sync.flushPendingChanges();
+                sync.deliver (receiver);
+                expect (haveSameContent (target, source));
+                expect (receiver.getVersion() == sync.getCurrentVersion());
+            }
+        }
+
+        beginTest ("Default encoding with a Receiver");
+        {
+            ValueTree source (createControlSurface (4)), target;
+            TestSynchroniser sync (source);
+            ValueTreeSynchroniser::Receiver receiver (target);
+
+            sync.sendFullSyncCallback();
+
+            for (int i = 0; i < 50; ++i)
+                makeRandomChange (source, r);
+
+            expectEquals (sync.deliver (receiver), 0);
+            expectEquals (sync.getCurrentVersion(), (int64) 0);
+            expect (target.getNumChildren() == source.getNumChildren());
+        }
+
+        beginTest ("Resyncing from the delta log");
+        {
+            ValueTree source (createControlSurface (8)), target;
+            TestSynchroniser sync (source);
+            ValueTreeSynchroniser::Receiver receiver (target);
+
+            sync.setCompactEncoding (true);
+            sync.sendFullSyncCallback();
+            sync.deliver (receiver);
+
+            for (int i = 0; i < 20; ++i)
+                makeRandomChange (source, r);
+
+            const int numSent = sync.messages.size();
+            expect (sync.deliver (receiver, 5) == numSent - 5);
+            expect (receiver.getVersion() == 1);
+
+            sync.sendChangesSince (receiver.getVersion());
+            const int numResent = sync.messages.size();
+            expectEquals (numResent, numSent);
+            expectEquals (sync.deliver (receiver), 0);
+            expect (haveSameContent (target, source));
+
+            sync.setMaximumDeltaLogSize (0);
+
+            for (int i = 0; i < 20; ++i)
+                makeRandomChange (source, r);
+
+            sync.deliver (receiver, 1);
+            expect (receiver.getVersion() < sync.getCurrentVersion());
+
+            sync.sendChangesSince (receiver.getVersion());
+            expectEquals (sync.messages.size(), 1); // falls back to a full sync
+            expectEquals (sync.deliver (receiver), 0);
+            expect (haveSameContent (target, source));
+            expect (receiver.getVersion() == sync.getCurrentVersion());
+        }
+
+        beginTest ("Transactions");
+        {
+            ValueTree source (createControlSurface (8)), target;
+            TestSynchroniser sync (source);
+            ValueTreeSynchroniser::Receiver receiver (target);
+
+            for (int compact = 0; compact < 2; ++compact)
+            {
+                sync.setCompactEncoding (compact != 0);
+                sync.sendFullSyncCallback();
+                sync.deliver (receiver);
+
+                for (int i = 0; i < 10; ++i)
+                {
+                    {
+                        ValueTree::Transaction transaction (source);
+
+                        for (int j = 0; j < 20; ++j)
+                            makeRandomChange (source, r);
+                    }
+
+                    sync.deliver (receiver);
+                    expect (haveSameContent (target, source));
+                }
+            }
+        }
+
+        beginTest ("Merging repeated property changes");
+        {
+            const int numParameters = 2000;
+            ValueTree source (createControlSurface (numParameters)), target;
+            TestSynchroniser sync (source);
+            ValueTreeSynchroniser::Receiver receiver (target);
+
+            sync.setCompactEncoding (true);
+            sync.setCompressionLevel (0);
+            sync.setCoalescingInterval (60000); // (flushed by hand below)
+            sync.sendFullSyncCallback();
+            sync.deliver (receiver);
+
+            size_t packetSizes[3];
+
+            for (int pass = 0; pass < 3; ++pass)
+            {
+                sync.totalBytes = 0;
+
+                if (pass == 2)
+                {
+                    // some changes are already waiting when the transaction starts
+                    for (int i = 0; i < numParameters; i += 3)
+                        source.getChild (i).setProperty ("value", -1.0, nullptr);
+
+                    ValueTree::Transaction transaction (source);
+
+                    for (int i = numParameters; --i >= 0;)
+                        source.getChild (i).setProperty ("value", i * 0.5 + pass, nullptr);
+                }
+                else
+                {
+                    for (int repeat = 0; repeat <= pass * 3; ++repeat)
+                        for (int i = 0; i < numParameters; ++i)
+                            source.getChild (i).setProperty ("value", i * 0.25 + repeat + pass, nullptr);
+                }
+
+                sync.flushPendingChanges();
+                expectEquals (sync.deliver (receiver), 0);
+                expect (haveSameContent (target, source));
+                packetSizes[pass] = sync.totalBytes;
+            }
+
+            // (the values themselves may take a few more or fewer bytes, but sending any
+            // property twice would cost several bytes per entry)
+            expect (packetSizes[1] < packetSizes[0] + 100);
+            expect (packetSizes[2] < packetSizes[0] + 100);
+        }
+
+        beginTest ("Bandwidth");
+        {
+            const int numParameters = 16, numSteps = 200, stepsPerFlush = 10;
+            size_t bytesSent[3];
+            int packetsSent[3];
+
+            for (int mode = 0; mode < 3; ++mode)
+            {
+                ValueTree source (createControlSurface (numParameters)), target;
+                TestSynchroniser sync (source);
+                ValueTreeSynchroniser::Receiver receiver (target);
+
+                if (mode > 0)
+                {
+                    sync.setCompactEncoding (true);
+                    sync.setCompressionLevel (mode == 2 ? 6 : 0);
+                    sync.setCoalescingInterval (60000); // (flushed by hand below)
+                }
+
+                sync.sendFullSyncCallback();
+                sync.deliver (receiver);
+                sync.totalBytes = 0;
+                int numMessages = 0;
+
+                for (int step = 0; step < numSteps; ++step)
+                {
+                    for (int i = 0; i < numParameters; ++i)
+                        source.getChild (i).setProperty ("value", std::sin (step * 0.01 + i), nullptr);
+
+                    if (mode > 0 && (step + 1) % stepsPerFlush == 0)
+                        sync.flushPendingChanges();
+
+                    numMessages += sync.messages.size();
+                    expectEquals (sync.deliver (receiver), 0);
+                }
+
+                expect (haveSameContent (target, source));
+                bytesSent[mode] = sync.totalBytes;
+                packetsSent[mode] = numMessages;
+            }
+
+            expect (bytesSent[1] < bytesSent[0] / 4);
+            expect (bytesSent[2] <= bytesSent[1]);
+
+            logMessage ("Automating " + String (numParameters) + " parameters for " + String (numSteps) + " steps: "
+                          + String ((int) bytesSent[0]) + " bytes in " + String (packetsSent[0]) + " messages by default, "
+                          + String ((int) bytesSent[1]) + " bytes in " + String (packetsSent[1]) + " coalesced packets, "
+                          + String ((int) bytesSent[2]) + " bytes when compressed");
+        }
+    }
+};
+
+static ValueTreeSynchroniserTests valueTreeSynchroniserTests;
+
+#endif
@@ -39,8 +39,14 @@
     and implement the stateChanged() method to transmit the encoded change (maybe
     via a network or other means) to a remote destination, where it can be
     applied to a target tree.
+
+    By default, each change is sent as a separate message that can be applied with
+    the static applyChange() method. For links where bandwidth matters, you can call
+    setCompactEncoding() to switch to an encoding which groups changes into versioned
+    packets - see setCompactEncoding() and the Receiver class for details.
 */
-class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener
+class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener,
+                                         private Timer
 {
 public:
     /** Creates a ValueTreeSynchroniser that watches the given tree.
@@ -81,14 +87,132 @@ public:
     /** Returns the root ValueTree that is being observed. */
     const ValueTree& getRoot() noexcept       { return valueTree; }
 
+    //==============================================================================
+    /** Switches to a compact, versioned encoding for the changes that are sent.
+
+        In this mode, changes are grouped into packets that each carry a version number,
+        and identifiers are only sent as strings the first time they're used, and as
+        small integers after that. Because decoding a packet depends on the ones that
+        came before it, they can't be applied with the static applyChange() method, so
+        the receiving end must use a Receiver object instead.
+
+        The setCoalescingInterval(), setCompressionLevel() and sendChangesSince() methods
+        only have any effect when this mode is turned on. Changing the mode resets the
+        version number, so you'll probably want to call sendFullSyncCallback() afterwards.
+    */
+    void setCompactEncoding (bool shouldUseCompactEncoding);
+
+    /** Returns true if the compact encoding is turned on.
+        @see setCompactEncoding
+    */
+    bool isUsingCompactEncoding() const noexcept    { return encoder != nullptr; }
+
+    /** Sets a time window over which changes are collected before they're sent.
+
+        When this is more than zero, changes aren't sent as soon as they happen, but are
+        gathered up and sent as a single packet when the interval has passed, and if a
+        property changes several times during that time, only its last value is sent.
+        This uses a Timer, so it needs the message thread to be running.
+
+        An interval of zero (the default) sends a packet for every change.
+        @see flushPendingChanges
+    */
+    void setCoalescingInterval (int milliseconds);
+
+    /** Sets the zlib compression level to use for packets, from 0 (the default, which
+        sends them uncompressed) to 9. Packets that are too small to benefit from being
+        compressed are always sent uncompressed.
+    */
+    void setCompressionLevel (int compressionLevel);
+
+    /** Sets the maximum number of bytes of recently-sent packets that are kept so that
+        they can be re-sent by sendChangesSince(). The default is 64KB.
+    */
+    void setMaximumDeltaLogSize (size_t numBytes);
+
+    /** Sends any changes that are waiting for the coalescing interval to finish. */
+    void flushPendingChanges();
+
+    /** Returns the version number of the last packet that was sent. */
+    int64 getCurrentVersion() const noexcept;
+
+    /** Brings a Receiver back into sync after it has missed some packets.
+
+        Pass in the version number returned by the receiver's Receiver::getVersion()
+        method. If all the packets since that version are still held in the delta log,
+        they get sent again, otherwise this will fall back to sending a full sync.
+    */
+    void sendChangesSince (int64 receiverVersion);
+
+    //==============================================================================
+    /**
+        Applies the changes that are sent by a ValueTreeSynchroniser to a target tree.
+
+        This is needed to decode the packets that are sent when the synchroniser uses
+        its compact encoding, because it has to keep track of the identifiers and the
+        version number from one packet to the next. It can also apply the messages that
+        are sent by a synchroniser using the default encoding.
+
+        @see ValueTreeSynchroniser::setCompactEncoding
+    */
+    class JUCE_API  Receiver
+    {
+    public:
+        /** Creates a Receiver that will apply changes to the given tree.
+            The tree must stay valid for the lifetime of this object, because a full sync
+            will make it refer to a new tree.
+        */
+        Receiver (ValueTree& targetTree, UndoManager* undoManager = nullptr);
+
+        /** Destructor. */
+        ~Receiver();
+
+        /** Applies an encoded change or packet to the target tree.
+
+            This returns false if the data couldn't be applied, which can happen if it's
+            corrupt, or if some earlier packets have gone missing. In that case you should
+            send the value of getVersion() back to the synchroniser, and pass it to its
+            sendChangesSince() method to get back in sync.
+        */
+        bool applyChange (const void* encodedChangeData, size_t encodedChangeDataSize);
+
+        /** Returns the version of the last packet that was applied, or -1 if no full sync
+            has been received yet, or if the tree needs to be completely re-sent.
+        */
+        int64 getVersion() const noexcept           { return version; }
+
+    private:
+        ValueTree& target;
+        UndoManager* undoManager;
+        Array<Identifier> identifiers;
+        int64 version;
+
+        bool applyPacket (MemoryInputStream&, int flags);
+        bool applyPacketChange (MemoryInputStream&);
+        bool readIdentifier (InputStream&, Identifier&) const;
+        ValueTree readTree (InputStream&) const;
+        bool resyncNeeded();
+
+        JUCE_DECLARE_NON_COPYABLE (Receiver)
+    };
+
 private:
     ValueTree valueTree;
 
+    struct CompactEncoder;
+    ScopedPointer<CompactEncoder> encoder;
+    int coalescingInterval, compressionLevel;
+    size_t maxDeltaLogSize;
+
     void valueTreePropertyChanged (ValueTree&, const Identifier&) override;
     void valueTreeChildAdded (ValueTree&, ValueTree&) override;
     void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override;
     void valueTreeChildOrderChanged (ValueTree&, int, int) override;
     void valueTreeParentChanged (ValueTree&) override;
+    void valueTreeTransactionCompleted (ValueTree&, const Array<ValueTree::Change>&) override;
+    void timerCallback() override;
+    void changeWasQueued();
+    void sendPacket (const MemoryBlock&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ValueTreeSynchroniser)
 };
@@ -0,0 +1,706 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+//==============================================================================
+// Keeps track of the clip region, transform and font as the operations are recorded, so
+// that the context's queries can be answered straight away. It never draws anything.
+class LowLevelGraphicsTiledSoftwareRenderer::StateTracker  : public LowLevelGraphicsSoftwareRenderer
+{
+public:
+    StateTracker (const Image& image)  : LowLevelGraphicsSoftwareRenderer (image) {}
+
+    // A transparency layer doesn't change the clip or transform, so there's no need
+    // to allocate a layer image for it here.
+    void beginTransparencyLayer (float) override    { saveState(); }
+    void endTransparencyLayer() override            { restoreState(); }
+
+    Rectangle<int> getDeviceClipBounds() const
+    {
+        return stack->clip != nullptr ? stack->clip->getClipBounds() : Rectangle<int>();
+    }
+
+    AffineTransform getDeviceTransform (const AffineTransform& t) const
+    {
+        return stack->transform.getTransformWith (t);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (StateTracker)
+};
+
+//==============================================================================
+class LowLevelGraphicsTiledSoftwareRenderer::TileRenderer  : public LowLevelGraphicsSoftwareRenderer
+{
+public:
+    TileRenderer (const Image& image, Range<int> rows)  : LowLevelGraphicsSoftwareRenderer (image)
+    {
+        stack->tileRows = rows;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TileRenderer)
+};
+
+//==============================================================================
+struct LowLevelGraphicsTiledSoftwareRenderer::Command
+{
+    Command() noexcept : isDrawingOperation (false) {}
+    virtual ~Command() {}
+
+    virtual void perform (LowLevelGraphicsContext&) const = 0;
+
+    Range<int> rows;
+    bool isDrawingOperation;
+};
+
+struct LowLevelGraphicsTiledSoftwareRenderer::CommandTypes
+{
+    typedef LowLevelGraphicsContext Context;
+
+    struct SetOrigin  : public Command
+    {
+        SetOrigin (Point<int> o) : origin (o) {}
+        void perform (Context& g) const override    { g.setOrigin (origin); }
+        const Point<int> origin;
+    };
+
+    struct AddTransform  : public Command
+    {
+        AddTransform (const AffineTransform& t) : transform (t) {}
+        void perform (Context& g) const override    { g.addTransform (transform); }
+        const AffineTransform transform;
+    };
+
+    struct ClipToRectangle  : public Command
+    {
+        ClipToRectangle (const Rectangle<int>& r) : area (r) {}
+        void perform (Context& g) const override    { g.clipToRectangle (area); }
+        const Rectangle<int> area;
+    };
+
+    struct ClipToRectangleList  : public Command
+    {
+        ClipToRectangleList (const RectangleList<int>& r) : list (r) {}
+        void perform (Context& g) const override    { g.clipToRectangleList (list); }
+        const RectangleList<int> list;
+    };
+
+    struct ExcludeClipRectangle  : public Command
+    {
+        ExcludeClipRectangle (const Rectangle<int>& r) : area (r) {}
+        void perform (Context& g) const override    { g.excludeClipRectangle (area); }
+        const Rectangle<int> area;
+    };
+
+    struct ClipToPath  : public Command
+    {
+        ClipToPath (const Path& p, const AffineTransform& t) : path (p), transform (t) {}
+        void perform (Context& g) const override    { g.clipToPath (path, transform); }
+        const Path path;
+        const AffineTransform transform;
+    };
+
+    struct ClipToImageAlpha  : public Command
+    {
+        ClipToImageAlpha (const Image& im, const AffineTransform& t) : image (im), transform (t) {}
+        void perform (Context& g) const override    { g.clipToImageAlpha (image, transform); }
+        const Image image;
+        const AffineTransform transform;
+    };
+
+    struct SaveState  : public Command
+    {
+        void perform (Context& g) const override    { g.saveState(); }
+    };
+
+    struct RestoreState  : public Command
+    {
+        void perform (Context& g) const override    { g.restoreState(); }
+    };
+
+    struct BeginTransparencyLayer  : public Command
+    {
+        BeginTransparencyLayer (float o) : opacity (o) {}
+        void perform (Context& g) const override    { g.beginTransparencyLayer (opacity); }
+        const float opacity;
+    };
+
+    struct EndTransparencyLayer  : public Command
+    {
+        void perform (Context& g) const override    { g.endTransparencyLayer(); }
+    };
+
+    struct SetFill  : public Command
+    {
+        SetFill (const FillType& f) : fill (f) {}
+        void perform (Context& g) const override    { g.setFill (fill); }
+        const FillType fill;
+    };
+
+    struct SetOpacity  : public Command
+    {
+        SetOpacity (float o) : opacity (o) {}
+        void perform (Context& g) const override    { g.setOpacity (opacity); }
+        const float opacity;
+    };
+
+    struct SetInterpolationQuality  : public Command
+    {
+        SetInterpolationQuality (Graphics::ResamplingQuality q) : quality (q) {}
+        void perform (Context& g) const override    { g.setInterpolationQuality (quality); }
+        const Graphics::ResamplingQuality quality;
+    };
+
+    struct SetFont  : public Command
+    {
+        SetFont (const Font& f) : font (f) {}
+        void perform (Context& g) const override    { g.setFont (font); }
+        const Font font;
+    };
+
+    //==============================================================================
+    struct FillRect  : public Command
+    {
+        FillRect (const Rectangle<int>& r, bool replace) : area (r), replaceExistingContents (replace) {}
+        void perform (Context& g) const override    { g.fillRect (area, replaceExistingContents); }
+        const Rectangle<int> area;
+        const bool replaceExistingContents;
+    };
+
+    struct FillRectFloat  : public Command
+    {
+        FillRectFloat (const Rectangle<float>& r) : area (r) {}
+        void perform (Context& g) const override    { g.fillRect (area); }
+        const Rectangle<float> area;
+    };
+
+    struct FillRectList  : public Command
+    {
+        FillRectList (const RectangleList<float>& r) : list (r) {}
+        void perform (Context& g) const override    { g.fillRectList (list); }
+        const RectangleList<float> list;
+    };
+
+    struct FillPath  : public Command
+    {
+        FillPath (const Path& p, const AffineTransform& t) : path (p), transform (t) {}
+        void perform (Context& g) const override    { g.fillPath (path, transform); }
+        const Path path;
+        const AffineTransform transform;
+    };
+
+    struct DrawImage  : public Command
+    {
+        DrawImage (const Image& im, const AffineTransform& t) : image (im), transform (t) {}
+        void perform (Context& g) const override    { g.drawImage (image, transform); }
+        const Image image;
+        const AffineTransform transform;
+    };
+
+    struct DrawLine  : public Command
+    {
+        DrawLine (const Line<float>& l) : line (l) {}
+        void perform (Context& g) const override    { g.drawLine (line); }
+        const Line<float> line;
+    };
+
+    struct DrawGlyph  : public Command
+    {
+        DrawGlyph (int glyph, const AffineTransform& t) : glyphNumber (glyph), transform (t) {}
+        void perform (Context& g) const override    { g.drawGlyph (glyphNumber, transform); }
+        const int glyphNumber;
+        const AffineTransform transform;
+    };
+};
+
+//==============================================================================
+struct LowLevelGraphicsTiledSoftwareRenderer::TileRenderJob
+{
+    TileRenderJob (const LowLevelGraphicsTiledSoftwareRenderer& r) noexcept : owner (r) {}
+
+    void operator() (int tileIndex) const    { owner.renderTile (tileIndex); }
+
+    const LowLevelGraphicsTiledSoftwareRenderer& owner;
+};
+
+//==============================================================================
+LowLevelGraphicsTiledSoftwareRenderer::LowLevelGraphicsTiledSoftwareRenderer (const Image& im, ThreadPool& pool, int linesPerTile)
+    : image (im),
+      threadPool (pool),
+      state (new StateTracker (im)),
+      tileHeight (linesPerTile),
+      numDrawingCommands (0),
+      transparencyLayerDepth (0)
+{
+    if (tileHeight <= 0)
+    {
+        // a few tiles per thread helps to balance the load when the drawing is uneven
+        const int numTilesWanted = 4 * (threadPool.getNumThreads() + 1);
+        tileHeight = jmax (16, (image.getHeight() + numTilesWanted - 1) / numTilesWanted);
+    }
+
+    // The glyph cache singleton isn't created thread-safely, so make sure that it
+    // already exists before any of the tile jobs can draw text.
+    RenderingHelpers::SoftwareRendererSavedState::GlyphCacheType::getInstance();
+}
+
+LowLevelGraphicsTiledSoftwareRenderer::~LowLevelGraphicsTiledSoftwareRenderer()
+{
+    flush();
+}
+
+int LowLevelGraphicsTiledSoftwareRenderer::getNumTiles() const noexcept
+{
+    return (image.getHeight() + tileHeight - 1) / tileHeight;
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::flush()
+{
+    // The tiles would each throw away the contents of the unfinished layer!
+    jassert (transparencyLayerDepth == 0);
+
+    if (numDrawingCommands == 0)
+        return;
+
+    threadPool.parallelFor (0, getNumTiles(), TileRenderJob (*this));
+
+    // The state changes are kept, so that anything drawn after this starts out
+    // with the right clip region, transform, fill, etc.
+    for (int i = commands.size(); --i >= 0;)
+        if (commands.getUnchecked (i)->isDrawingOperation)
+            commands.remove (i);
+
+    numDrawingCommands = 0;
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::renderTile (const int tileIndex) const
+{
+    const Range<int> rows (Range<int> (tileIndex * tileHeight, (tileIndex + 1) * tileHeight)
+                             .getIntersectionWith (Range<int> (0, image.getHeight())));
+
+    TileRenderer renderer (image, rows);
+
+    for (int i = 0; i < commands.size(); ++i)
+    {
+        const Command& c = *commands.getUnchecked (i);
+
+        if (! c.isDrawingOperation || c.rows.intersects (rows))
+            c.perform (renderer);
+    }
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addStateCommand (Command* c)
+{
+    commands.add (c);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addDrawingCommand (Command* c, const Rectangle<float>& area, const AffineTransform& t)
+{
+    // The extra pixel around the edge allows for anti-aliasing and image resampling
+    addDrawingCommand (c, area.transformedBy (state->getDeviceTransform (t))
+                              .getSmallestIntegerContainer().expanded (2));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addDrawingCommand (Command* c, Rectangle<int> area)
+{
+    ScopedPointer<Command> command (c);
+    area = area.getIntersection (state->getDeviceClipBounds());
+
+    if (! area.isEmpty())
+    {
+        command->isDrawingOperation = true;
+        command->rows = area.getVerticalRange();
+        commands.add (command.release());
+        ++numDrawingCommands;
+    }
+}
+
+//==============================================================================
+bool LowLevelGraphicsTiledSoftwareRenderer::isVectorDevice() const                { return false; }
+float LowLevelGraphicsTiledSoftwareRenderer::getPhysicalPixelScaleFactor()        { return state->getPhysicalPixelScaleFactor(); }
+bool LowLevelGraphicsTiledSoftwareRenderer::clipRegionIntersects (const Rectangle<int>& r)  { return state->clipRegionIntersects (r); }
+Rectangle<int> LowLevelGraphicsTiledSoftwareRenderer::getClipBounds() const       { return state->getClipBounds(); }
+bool LowLevelGraphicsTiledSoftwareRenderer::isClipEmpty() const                   { return state->isClipEmpty(); }
+const Font& LowLevelGraphicsTiledSoftwareRenderer::getFont()                      { return state->getFont(); }
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOrigin (Point<int> o)
+{
+    state->setOrigin (o);
+    addStateCommand (new CommandTypes::SetOrigin (o));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::addTransform (const AffineTransform& t)
+{
+    state->addTransform (t);
+    addStateCommand (new CommandTypes::AddTransform (t));
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangle (const Rectangle<int>& r)
+{
+    addStateCommand (new CommandTypes::ClipToRectangle (r));
+    return state->clipToRectangle (r);
+}
+
+bool LowLevelGraphicsTiledSoftwareRenderer::clipToRectangleList (const RectangleList<int>& r)
+{
+    addStateCommand (new CommandTypes::ClipToRectangleList (r));
+    return state->clipToRectangleList (r);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::excludeClipRectangle (const Rectangle<int>& r)
+{
+    state->excludeClipRectangle (r);
+    addStateCommand (new CommandTypes::ExcludeClipRectangle (r));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToPath (const Path& path, const AffineTransform& t)
+{
+    state->clipToPath (path, t);
+    addStateCommand (new CommandTypes::ClipToPath (path, t));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::clipToImageAlpha (const Image& im, const AffineTransform& t)
+{
+    jassert (im != image); // the destination image can't also be used as a source!
+
+    state->clipToImageAlpha (im, t);
+    addStateCommand (new CommandTypes::ClipToImageAlpha (im, t));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::saveState()
+{
+    state->saveState();
+    addStateCommand (new CommandTypes::SaveState());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::restoreState()
+{
+    state->restoreState();
+    addStateCommand (new CommandTypes::RestoreState());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::beginTransparencyLayer (float opacity)
+{
+    state->beginTransparencyLayer (opacity);
+    addStateCommand (new CommandTypes::BeginTransparencyLayer (opacity));
+    ++transparencyLayerDepth;
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::endTransparencyLayer()
+{
+    state->endTransparencyLayer();
+    addStateCommand (new CommandTypes::EndTransparencyLayer());
+    --transparencyLayerDepth;
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFill (const FillType& fillType)
+{
+    jassert (fillType.image != image); // the destination image can't also be used as a source!
+
+    state->setFill (fillType);
+    addStateCommand (new CommandTypes::SetFill (fillType));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setOpacity (float opacity)
+{
+    state->setOpacity (opacity);
+    addStateCommand (new CommandTypes::SetOpacity (opacity));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setInterpolationQuality (Graphics::ResamplingQuality quality)
+{
+    state->setInterpolationQuality (quality);
+    addStateCommand (new CommandTypes::SetInterpolationQuality (quality));
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::setFont (const Font& font)
+{
+    // Making sure the typeface has been found now means that the rendering threads
+    // will only ever read the font's shared data.
+    font.getTypeface();
+
+    state->setFont (font);
+    addStateCommand (new CommandTypes::SetFont (font));
+}
+
+//==============================================================================
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<int>& r, bool replaceExistingContents)
+{
+    addDrawingCommand (new CommandTypes::FillRect (r, replaceExistingContents), r.toFloat(), AffineTransform());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRect (const Rectangle<float>& r)
+{
+    addDrawingCommand (new CommandTypes::FillRectFloat (r), r, AffineTransform());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillRectList (const RectangleList<float>& list)
+{
+    addDrawingCommand (new CommandTypes::FillRectList (list), list.getBounds(), AffineTransform());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::fillPath (const Path& path, const AffineTransform& t)
+{
+    addDrawingCommand (new CommandTypes::FillPath (path, t), path.getBounds(), t);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawImage (const Image& im, const AffineTransform& t)
+{
+    jassert (im != image); // the destination image can't also be used as a source!
+
+    addDrawingCommand (new CommandTypes::DrawImage (im, t), im.getBounds().toFloat(), t);
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawLine (const Line<float>& line)
+{
+    addDrawingCommand (new CommandTypes::DrawLine (line),
+                       Rectangle<float> (line.getStart(), line.getEnd()).expanded (1.0f), AffineTransform());
+}
+
+void LowLevelGraphicsTiledSoftwareRenderer::drawGlyph (int glyphNumber, const AffineTransform& t)
+{
+    // Loading the glyph's outline now means that the rendering threads won't need to
+    // modify the typeface. The glyph's extent isn't known, so it's assumed to cover
+    // the whole clip region.
+    Path outline;
+    state->getFont().getTypeface()->getOutlineForGlyph (glyphNumber, outline);
+
+    addDrawingCommand (new CommandTypes::DrawGlyph (glyphNumber, t), state->getDeviceClipBounds());
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TiledSoftwareRendererTests  : public UnitTest
+{
+public:
+    TiledSoftwareRendererTests() : UnitTest ("Tiled software renderer") {}
+
+    static Image createSourceImage()
+    {
+        Image image (Image::ARGB, 53, 41, true, SoftwareImageType());
+        Graphics g (image);
+        g.setGradientFill (ColourGradient (Colours::orange, 0, 0, Colours::darkblue.withAlpha (0.4f), 53, 41, true));
+        g.fillEllipse (0, 0, 53, 41);
+        return image;
+    }
+
+    static void renderScene (Graphics& g, int w, int h, const Image& sourceImage, int seed)
+    {
+        Random r (seed);
+
+        g.fillAll (Colours::lightgrey);
+
+        for (int i = 0; i < 30; ++i)
+        {
+            g.setColour (Colour (r.nextInt()).withAlpha (r.nextFloat()));
+            g.fillRect (r.nextInt (w) - 20, r.nextInt (h) - 20, r.nextInt (w / 2), r.nextInt (h / 2));
+            g.fillEllipse (r.nextFloat() * w, r.nextFloat() * h, r.nextFloat() * w / 3, r.nextFloat() * h / 3);
+            g.drawLine (r.nextFloat() * w, r.nextFloat() * h, r.nextFloat() * w, r.nextFloat() * h, 0.5f + r.nextFloat() * 4.0f);
+        }
+
+        {
+            Graphics::ScopedSaveState ss (g);
+
+            RectangleList<int> area;
+            area.add (w / 8, h / 8, w / 3, h / 2);
+            area.add (w / 2, h / 3, w / 3, h / 2);
+            g.reduceClipRegion (area);
+            g.excludeClipRegion (Rectangle<int> (w / 4, h / 4, w / 5, h / 5));
+
+            g.addTransform (AffineTransform::rotation (0.3f, w * 0.5f, h * 0.5f));
+            g.setGradientFill (ColourGradient (Colours::red, 0, 0, Colours::green.withAlpha (0.5f), (float) w, (float) h, false));
+            g.fillRoundedRectangle (w * 0.1f, h * 0.1f, w * 0.8f, h * 0.8f, 10.0f);
+        }
+
+        {
+            Graphics::ScopedSaveState ss (g);
+
+            Path star;
+            star.addStar (Point<float> (w * 0.6f, h * 0.5f), 7, h * 0.1f, h * 0.45f, 0.2f);
+            g.reduceClipRegion (star);
+
+            g.beginTransparencyLayer (0.7f);
+            g.setTiledImageFill (sourceImage, 5, 9, 0.8f);
+            g.fillRect (0, 0, w, h);
+            g.setColour (Colours::white);
+            g.drawEllipse (w * 0.4f, h * 0.2f, w * 0.3f, h * 0.6f, 3.0f);
+            g.endTransparencyLayer();
+        }
+
+        for (int i = 0; i < 8; ++i)
+        {
+            g.setOpacity (r.nextBool() ? 1.0f : r.nextFloat());
+            g.drawImageAt (sourceImage, r.nextInt (w) - 30, r.nextInt (h) - 20);
+            g.drawImageTransformed (sourceImage, AffineTransform::rotation (r.nextFloat() * 3.0f)
+                                                    .scaled (0.5f + r.nextFloat() * 2.0f)
+                                                    .translated (r.nextFloat() * w, r.nextFloat() * h));
+        }
+
+        g.setColour (Colours::black);
+        g.setFont (14.0f + r.nextFloat() * 10.0f);
+        g.drawText ("The quick brown fox jumps over the lazy dog", 5, h / 3, w - 10, h / 4, Justification::centred, false);
+
+        {
+            Graphics::ScopedSaveState ss (g);
+
+            g.addTransform (AffineTransform::rotation (-0.4f, w * 0.5f, h * 0.5f));
+            g.setColour (Colours::darkred.withAlpha (0.8f));
+            g.setFont (Font (30.0f, Font::bold));
+            g.drawSingleLineText ("Tiled glyphs 0123456789", w / 10, h / 2);
+        }
+
+        g.setColour (Colours::transparentBlack);
+        g.fillRect (Rectangle<int> (w / 3, h / 5, w / 7, h / 2));
+        g.getInternalContext().fillRect (Rectangle<int> (w / 2, h / 7, w / 9, h / 3), true);
+    }
+
+    static void renderWaveform (Graphics& g, int w, int h)
+    {
+        g.fillAll (Colours::black);
+
+        for (int channel = 0; channel < 8; ++channel)
+        {
+            const float centre = h * (channel + 0.5f) / 8.0f;
+            const float height = h / 18.0f;
+
+            Path p;
+            p.startNewSubPath (0, centre);
+
+            for (int x = 0; x < w; x += 2)
+                p.lineTo ((float) x, centre + height * std::sin (x * 0.013f * (channel + 1)) * std::cos (x * 0.0007f));
+
+            g.setColour (Colour::fromHSV (channel / 8.0f, 0.7f, 0.9f, 1.0f));
+            g.strokePath (p, PathStrokeType (1.5f));
+
+            g.setGradientFill (ColourGradient (Colours::white.withAlpha (0.2f), 0, centre - height,
+                                               Colours::transparentWhite, 0, centre + height, false));
+            g.fillRect (0.0f, centre - height, (float) w, height * 2.0f);
+        }
+    }
+
+    static bool imagesAreIdentical (const Image& a, const Image& b)
+    {
+        const Image::BitmapData da (a, Image::BitmapData::readOnly);
+        const Image::BitmapData db (b, Image::BitmapData::readOnly);
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            if (memcmp (da.getLinePointer (y), db.getLinePointer (y), (size_t) (a.getWidth() * da.pixelStride)) != 0)
+                return false;
+
+        return true;
+    }
+
+    void runTest() override
+    {
+        ThreadPool pool (jmax (2, SystemStats::getNumCpus()), true);
+        const Image sourceImage (createSourceImage());
+        const Image::PixelFormat formats[] = { Image::ARGB, Image::RGB };
+
+        beginTest ("Rendering matches the single-threaded renderer");
+
+        for (int i = 0; i < numElementsInArray (formats); ++i)
+        {
+            const int tileHeights[] = { 0, 1, 7, 64 };
+
+            for (int j = 0; j < numElementsInArray (tileHeights); ++j)
+            {
+                const int w = 331, h = 217;
+                Image expected (formats[i], w, h, true, SoftwareImageType());
+                Image actual (formats[i], w, h, true, SoftwareImageType());
+
+                {
+                    Graphics g (expected);
+                    renderScene (g, w, h, sourceImage, 4321);
+                }
+
+                {
+                    LowLevelGraphicsTiledSoftwareRenderer renderer (actual, pool, tileHeights[j]);
+                    Graphics g (renderer);
+                    renderScene (g, w, h, sourceImage, 4321);
+                }
+
+                expect (imagesAreIdentical (expected, actual));
+            }
+        }
+
+        beginTest ("Flushing part-way through");
+        {
+            const int w = 200, h = 150;
+            Image expected (Image::ARGB, w, h, true, SoftwareImageType());
+            Image actual (Image::ARGB, w, h, true, SoftwareImageType());
+
+            {
+                Graphics g (expected);
+                g.addTransform (AffineTransform::scale (0.9f));
+                renderScene (g, w, h, sourceImage, 99);
+                renderScene (g, w, h, sourceImage, 100);
+            }
+
+            {
+                LowLevelGraphicsTiledSoftwareRenderer renderer (actual, pool);
+                Graphics g (renderer);
+                g.addTransform (AffineTransform::scale (0.9f));
+                renderScene (g, w, h, sourceImage, 99);
+                renderer.flush();
+                renderScene (g, w, h, sourceImage, 100);
+                renderer.flush();
+            }
+
+            expect (imagesAreIdentical (expected, actual));
+        }
+
+        beginTest ("Performance");
+        {
+            Image image (Image::ARGB, 3840, 2160, true, SoftwareImageType());
+            const int numFrames = 4;
+            double startTime = Time::getMillisecondCounterHiRes();
+
+            for (int frame = 0; frame < numFrames; ++frame)
+            {
+                Graphics g (image);
+                renderWaveform (g, image.getWidth(), image.getHeight());
+            }
+
+            const double singleThreaded = (Time::getMillisecondCounterHiRes() - startTime) / numFrames;
+            startTime = Time::getMillisecondCounterHiRes();
+
+            for (int frame = 0; frame < numFrames; ++frame)
+            {
+                LowLevelGraphicsTiledSoftwareRenderer renderer (image, pool);
+                Graphics g (renderer);
+                renderWaveform (g, image.getWidth(), image.getHeight());
+            }
+
+            const double tiled = (Time::getMillisecondCounterHiRes() - startTime) / numFrames;
+
+            logMessage ("3840x2160 waveform view: single-threaded " + String (singleThreaded, 1)
+                          + " ms/frame, tiled on " + String (pool.getNumThreads()) + " threads "
+                          + String (tiled, 1) + " ms/frame");
+        }
+    }
+};
+
+static TiledSoftwareRendererTests tiledSoftwareRendererUnitTests;
+
+#endif
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#ifndef JUCE_LOWLEVELGRAPHICSTILEDSOFTWARERENDERER_H_INCLUDED
+#define JUCE_LOWLEVELGRAPHICSTILEDSOFTWARERENDERER_H_INCLUDED
+
+
+//==============================================================================
+/**
+    A LowLevelGraphicsContext that records its drawing operations and then renders
+    them into an image using several threads.
+
+    Nothing is drawn immediately: each operation is recorded, along with the range of
+    lines in the image that it could touch. When flush() is called (or the renderer is
+    deleted), the image is divided into horizontal tiles, and the tiles are rendered in
+    parallel on a ThreadPool. Each tile replays the operations that overlap it using a
+    software renderer that only writes to that tile's lines, so the result is pixel-for-pixel
+    the same as drawing with a LowLevelGraphicsSoftwareRenderer.
+
+    This is worth doing for big offscreen images - for small ones, the cost of recording
+    the operations will outweigh any gain. E.g.
+    @code
+    ThreadPool pool (SystemStats::getNumCpus(), true);
+    Image image (Image::ARGB, 3840, 2160, true, SoftwareImageType());
+
+    {
+        LowLevelGraphicsTiledSoftwareRenderer renderer (image, pool);
+        Graphics g (renderer);
+        drawEverything (g);
+    }   // the image is rendered when the renderer is deleted
+    @endcode
+
+    Any images that get drawn must not be modified until the operations have been flushed,
+    and the destination image can't be used as a source image for its own drawing operations.
+
+    @see LowLevelGraphicsSoftwareRenderer, ThreadPool::parallelFor
+*/
+class JUCE_API  LowLevelGraphicsTiledSoftwareRenderer    : public LowLevelGraphicsContext
+{
+public:
+    //==============================================================================
+    /** Creates a context to render into an image.
+
+        @param imageToRenderOnto   the image to draw on
+        @param threadPool          the pool that will be used to render the tiles. This should
+                                   be a pool that uses work-stealing, otherwise the tiles will
+                                   all be rendered on the thread that calls flush()
+        @param tileHeight          the number of lines in each tile. If this is zero or less, a
+                                   height is chosen that gives each of the pool's threads a
+                                   few tiles to work on
+    */
+    LowLevelGraphicsTiledSoftwareRenderer (const Image& imageToRenderOnto, ThreadPool& threadPool, int tileHeight = 0);
+
+    /** Destructor.
+        This will render any operations that haven't been flushed yet.
+    */
+    ~LowLevelGraphicsTiledSoftwareRenderer();
+
+    //==============================================================================
+    /** Renders all the operations that have been recorded so far into the image.
+
+        This blocks until all the tiles have been drawn. You can carry on drawing after
+        calling it, but it mustn't be called while a transparency layer is active.
+    */
+    void flush();
+
+    /** Returns the number of tiles that the image is divided into. */
+    int getNumTiles() const noexcept;
+
+    //==============================================================================
+    bool isVectorDevice() const override;
+    void setOrigin (Point<int>) override;
+    void addTransform (const AffineTransform&) override;
+    float getPhysicalPixelScaleFactor() override;
+
+    bool clipToRectangle (const Rectangle<int>&) override;
+    bool clipToRectangleList (const RectangleList<int>&) override;
+    void excludeClipRectangle (const Rectangle<int>&) override;
+    void clipToPath (const Path&, const AffineTransform&) override;
+    void clipToImageAlpha (const Image&, const AffineTransform&) override;
+
+    void saveState() override;
+    void restoreState() override;
+
+    void beginTransparencyLayer (float) override;
+    void endTransparencyLayer() override;
+
+    bool clipRegionIntersects (const Rectangle<int>&) override;
+    Rectangle<int> getClipBounds() const override;
+    bool isClipEmpty() const override;
+
+    //==============================================================================
+    void setFill (const FillType&) override;
+    void setOpacity (float) override;
+    void setInterpolationQuality (Graphics::ResamplingQuality) override;
+
+    //==============================================================================
+    void fillRect (const Rectangle<int>&, bool replaceExistingContents) override;
+    void fillRect (const Rectangle<float>&) override;
+    void fillRectList (const RectangleList<float>&) override;
+    void fillPath (const Path&, const AffineTransform&) override;
+    void drawImage (const Image&, const AffineTransform&) override;
+    void drawLine (const Line<float>&) override;
+
+    //==============================================================================
+    void setFont (const Font&) override;
+    const Font& getFont() override;
+    void drawGlyph (int glyphNumber, const AffineTransform&) override;
+
+private:
+    //==============================================================================
+    class StateTracker;
+    class TileRenderer;
+    struct Command;
+    struct CommandTypes;
+    struct TileRenderJob;
+
+    Image image;
+    ThreadPool& threadPool;
+    ScopedPointer<StateTracker> state;
+    OwnedArray<Command> commands;
+    int tileHeight, numDrawingCommands, transparencyLayerDepth;
+
+    void addStateCommand (Command*);
+    void addDrawingCommand (Command*, const Rectangle<float>& userSpaceArea, const AffineTransform&);
+    void addDrawingCommand (Command*, Rectangle<int> deviceSpaceArea);
+    void renderTile (int tileIndex) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsTiledSoftwareRenderer)
+};
+
+
+#endif   // JUCE_LOWLEVELGRAPHICSTILEDSOFTWARERENDERER_H_INCLUDED
@@ -0,0 +1,727 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+namespace RenderingHelpers
+{
+namespace SpanBlending
+{
+    enum
+    {
+        minimumSpanLength  = 8,
+        minimumSolidLength = 16
+    };
+
+    template <class PixelType>
+    static void blendSpanScalar (PixelType* dest, const PixelARGB* src, int num, const uint32 extraAlpha) noexcept
+    {
+        if (extraAlpha < 256)
+            while (--num >= 0)
+                (dest++)->blend (*src++, extraAlpha);
+        else
+            while (--num >= 0)
+                (dest++)->blend (*src++);
+    }
+
+    /** A repeating run of a solid colour, long enough to fill a whole number of
+        128- or 256-bit registers with either 3- or 4-byte pixels.
+    */
+    struct SolidPattern
+    {
+        template <class PixelType>
+        SolidPattern (PixelType*, const PixelARGB colour) noexcept
+        {
+            PixelType* p = reinterpret_cast<PixelType*> (bytes);
+
+            for (int i = 0; i < numBytes / (int) sizeof (PixelType); ++i)
+                p[i].set (colour);
+        }
+
+        enum { numBytes = 96 };
+        uint8 bytes [numBytes];
+    };
+
+   #if JUCE_USE_SSE_INTRINSICS
+    enum { alphaShuffle = _MM_SHUFFLE (PixelARGB::indexA, PixelARGB::indexA, PixelARGB::indexA, PixelARGB::indexA) };
+
+    static bool isSSE2Available() noexcept
+    {
+       #if JUCE_64BIT
+        return true;
+       #else
+        static const bool hasSSE2 = SystemStats::hasSSE2();
+        return hasSSE2;
+       #endif
+    }
+
+    static bool isAVX2Available() noexcept
+    {
+       #if JUCE_USE_AVX_INTRINSICS
+        static const bool hasAVX2 = SystemStats::hasAVX() && SystemStats::hasAVX2() && SystemStats::hasFMA3();
+        return hasAVX2;
+       #else
+        return false;
+       #endif
+    }
+
+    //==============================================================================
+    // Each of these works on pixel components that have been widened to 16 bits, computing
+    // src + ((dest * (256 - srcAlpha)) >> 8) exactly as the scalar PixelARGB::blend() does.
+    // The final pack saturates each sum to 255, which matches clampPixelComponents().
+    struct SSE2
+    {
+        static forcedinline __m128i scale (__m128i src, __m128i extraAlpha) noexcept
+        {
+            return _mm_srli_epi16 (_mm_mullo_epi16 (src, extraAlpha), 8);
+        }
+
+        static forcedinline __m128i blend (__m128i dest, __m128i src, __m128i inverseAlpha) noexcept
+        {
+            return _mm_add_epi16 (src, _mm_srli_epi16 (_mm_mullo_epi16 (dest, inverseAlpha), 8));
+        }
+
+        static forcedinline __m128i inverseAlpha (__m128i src) noexcept
+        {
+            return _mm_sub_epi16 (_mm_set1_epi16 (256),
+                                  _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (src, alphaShuffle), alphaShuffle));
+        }
+
+        template <bool scaleSource>
+        static void blendSpan (PixelARGB* dest, const PixelARGB* src, int num, const uint32 extraAlpha) noexcept
+        {
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128i extra = _mm_set1_epi16 ((short) extraAlpha);
+
+            for (; num >= 4; num -= 4, dest += 4, src += 4)
+            {
+                const __m128i s = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (src));
+                const __m128i d = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (dest));
+
+                __m128i sLo = _mm_unpacklo_epi8 (s, zero);
+                __m128i sHi = _mm_unpackhi_epi8 (s, zero);
+
+                if (scaleSource)
+                {
+                    sLo = scale (sLo, extra);
+                    sHi = scale (sHi, extra);
+                }
+
+                const __m128i lo = blend (_mm_unpacklo_epi8 (d, zero), sLo, inverseAlpha (sLo));
+                const __m128i hi = blend (_mm_unpackhi_epi8 (d, zero), sHi, inverseAlpha (sHi));
+
+                _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest), _mm_packus_epi16 (lo, hi));
+            }
+
+            blendSpanScalar (dest, src, num, extraAlpha);
+        }
+
+        static int blendSolid (uint8* dest, const int numBytes, const SolidPattern& pattern, const uint32 inverseAlpha) noexcept
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i inv  = _mm_set1_epi16 ((short) inverseAlpha);
+
+            __m128i patternLo[3], patternHi[3];
+
+            for (int i = 0; i < 3; ++i)
+            {
+                const __m128i p = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (pattern.bytes + 16 * i));
+                patternLo[i] = _mm_unpacklo_epi8 (p, zero);
+                patternHi[i] = _mm_unpackhi_epi8 (p, zero);
+            }
+
+            int done = 0;
+
+            for (; done + 48 <= numBytes; done += 48)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    __m128i* d = reinterpret_cast<__m128i*> (dest + done + 16 * i);
+                    const __m128i v = _mm_loadu_si128 (d);
+
+                    _mm_storeu_si128 (d, _mm_packus_epi16 (blend (_mm_unpacklo_epi8 (v, zero), patternLo[i], inv),
+                                                           blend (_mm_unpackhi_epi8 (v, zero), patternHi[i], inv)));
+                }
+            }
+
+            return done;
+        }
+    };
+
+   #if JUCE_USE_AVX_INTRINSICS
+    // The same operations as the SSE2 versions, on twice as many pixels at a time. The
+    // unpacks and packs all work within 128-bit lanes, so the pixel order is preserved.
+    struct AVX2
+    {
+        static forcedinline JUCE_AVX_FUNCTION __m256i scale (__m256i src, __m256i extraAlpha) noexcept
+        {
+            return _mm256_srli_epi16 (_mm256_mullo_epi16 (src, extraAlpha), 8);
+        }
+
+        static forcedinline JUCE_AVX_FUNCTION __m256i blend (__m256i dest, __m256i src, __m256i inverseAlpha) noexcept
+        {
+            return _mm256_add_epi16 (src, _mm256_srli_epi16 (_mm256_mullo_epi16 (dest, inverseAlpha), 8));
+        }
+
+        static forcedinline JUCE_AVX_FUNCTION __m256i inverseAlpha (__m256i src) noexcept
+        {
+            return _mm256_sub_epi16 (_mm256_set1_epi16 (256),
+                                     _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (src, alphaShuffle), alphaShuffle));
+        }
+
+        template <bool scaleSource>
+        static JUCE_AVX_FUNCTION void blendSpan (PixelARGB* dest, const PixelARGB* src, int num, const uint32 extraAlpha) noexcept
+        {
+            const __m256i zero  = _mm256_setzero_si256();
+            const __m256i extra = _mm256_set1_epi16 ((short) extraAlpha);
+
+            for (; num >= 8; num -= 8, dest += 8, src += 8)
+            {
+                const __m256i s = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (src));
+                const __m256i d = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (dest));
+
+                __m256i sLo = _mm256_unpacklo_epi8 (s, zero);
+                __m256i sHi = _mm256_unpackhi_epi8 (s, zero);
+
+                if (scaleSource)
+                {
+                    sLo = scale (sLo, extra);
+                    sHi = scale (sHi, extra);
+                }
+
+                const __m256i lo = blend (_mm256_unpacklo_epi8 (d, zero), sLo, inverseAlpha (sLo));
+                const __m256i hi = blend (_mm256_unpackhi_epi8 (d, zero), sHi, inverseAlpha (sHi));
+
+                _mm256_storeu_si256 (reinterpret_cast<__m256i*> (dest), _mm256_packus_epi16 (lo, hi));
+            }
+
+            blendSpanScalar (dest, src, num, extraAlpha);
+        }
+
+        static JUCE_AVX_FUNCTION int blendSolid (uint8* dest, const int numBytes, const SolidPattern& pattern, const uint32 inverseAlpha) noexcept
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i inv  = _mm256_set1_epi16 ((short) inverseAlpha);
+
+            __m256i patternLo[3], patternHi[3];
+
+            for (int i = 0; i < 3; ++i)
+            {
+                const __m256i p = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (pattern.bytes + 32 * i));
+                patternLo[i] = _mm256_unpacklo_epi8 (p, zero);
+                patternHi[i] = _mm256_unpackhi_epi8 (p, zero);
+            }
+
+            int done = 0;
+
+            for (; done + 96 <= numBytes; done += 96)
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    __m256i* d = reinterpret_cast<__m256i*> (dest + done + 32 * i);
+                    const __m256i v = _mm256_loadu_si256 (d);
+
+                    _mm256_storeu_si256 (d, _mm256_packus_epi16 (blend (_mm256_unpacklo_epi8 (v, zero), patternLo[i], inv),
+                                                                 blend (_mm256_unpackhi_epi8 (v, zero), patternHi[i], inv)));
+                }
+            }
+
+            return done;
+        }
+    };
+   #endif
+
+    //==============================================================================
+    static void blendARGBSpan (PixelARGB* dest, const PixelARGB* src, int num, const uint32 extraAlpha) noexcept
+    {
+        const bool scaleSource = extraAlpha < 256;
+
+       #if JUCE_USE_AVX_INTRINSICS
+        if (isAVX2Available())
+        {
+            if (scaleSource)  AVX2::blendSpan<true>  (dest, src, num, extraAlpha);
+            else              AVX2::blendSpan<false> (dest, src, num, extraAlpha);
+
+            return;
+        }
+       #endif
+
+        if (scaleSource)  SSE2::blendSpan<true>  (dest, src, num, extraAlpha);
+        else              SSE2::blendSpan<false> (dest, src, num, extraAlpha);
+    }
+
+    template <class PixelType>
+    static void blendSolidSpan (PixelType* dest, const int num, const PixelARGB colour) noexcept
+    {
+        const SolidPattern pattern (dest, colour);
+        const uint32 inverseAlpha = 256u - colour.getAlpha();
+        const int numBytes = num * (int) sizeof (PixelType);
+
+       #if JUCE_USE_AVX_INTRINSICS
+        const int bytesDone = isAVX2Available() ? AVX2::blendSolid ((uint8*) dest, numBytes, pattern, inverseAlpha)
+                                                : SSE2::blendSolid ((uint8*) dest, numBytes, pattern, inverseAlpha);
+       #else
+        const int bytesDone = SSE2::blendSolid ((uint8*) dest, numBytes, pattern, inverseAlpha);
+       #endif
+
+        for (int i = bytesDone / (int) sizeof (PixelType); i < num; ++i)
+            dest[i].blend (colour);
+    }
+   #endif
+
+    //==============================================================================
+    bool isAvailable() noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS
+        return isSSE2Available();
+       #else
+        return false;
+       #endif
+    }
+
+    bool canBlendSpan (const PixelARGB*, const int destStride, const int numPixels) noexcept
+    {
+        return destStride == (int) sizeof (PixelARGB) && numPixels >= minimumSpanLength && isAvailable();
+    }
+
+    bool canBlendSpan (const PixelRGB*, const int destStride, const int numPixels) noexcept
+    {
+        return destStride == (int) sizeof (PixelRGB) && numPixels >= minimumSpanLength && isAvailable();
+    }
+
+    bool blendSolid (PixelARGB* dest, const int destStride, const int numPixels, const PixelARGB colour) noexcept
+    {
+        if (destStride != (int) sizeof (PixelARGB) || numPixels < minimumSolidLength || ! isAvailable())
+            return false;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        blendSolidSpan (dest, numPixels, colour);
+       #else
+        ignoreUnused (dest, colour);
+       #endif
+        return true;
+    }
+
+    bool blendSolid (PixelRGB* dest, const int destStride, const int numPixels, const PixelARGB colour) noexcept
+    {
+        if (destStride != (int) sizeof (PixelRGB) || numPixels < minimumSolidLength || ! isAvailable())
+            return false;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        blendSolidSpan (dest, numPixels, colour);
+       #else
+        ignoreUnused (dest, colour);
+       #endif
+        return true;
+    }
+
+    void blendSpan (PixelARGB* dest, const PixelARGB* src, const int numPixels, const uint32 extraAlpha) noexcept
+    {
+        jassert (extraAlpha <= 256);
+
+       #if JUCE_USE_SSE_INTRINSICS
+        blendARGBSpan (dest, src, numPixels, extraAlpha);
+       #else
+        blendSpanScalar (dest, src, numPixels, extraAlpha);
+       #endif
+    }
+
+    void blendSpan (PixelRGB* dest, const PixelARGB* src, int numPixels, const uint32 extraAlpha) noexcept
+    {
+        jassert (extraAlpha <= 256);
+
+       #if JUCE_USE_SSE_INTRINSICS
+        // RGB pixels are widened into a temporary ARGB run so that they can go through the same
+        // kernel - the RGB and ARGB blend operations produce identical colour components.
+        PixelARGB temp [128];
+
+        while (numPixels > 0)
+        {
+            const int num = jmin (numPixels, (int) numElementsInArray (temp));
+
+            for (int i = 0; i < num; ++i)
+                temp[i].set (dest[i]);
+
+            blendARGBSpan (temp, src, num, extraAlpha);
+
+            for (int i = 0; i < num; ++i)
+                dest[i].set (temp[i]);
+
+            dest += num;
+            src += num;
+            numPixels -= num;
+        }
+       #else
+        blendSpanScalar (dest, src, numPixels, extraAlpha);
+       #endif
+    }
+}
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SpanBlendingTests  : public UnitTest
+{
+public:
+    SpanBlendingTests() : UnitTest ("Software renderer span blending") {}
+
+    static PixelARGB randomPixel (Random& r)
+    {
+        const uint8 a = (uint8) r.nextInt (256);
+        PixelARGB p;
+        p.setARGB (a, (uint8) r.nextInt (a + 1), (uint8) r.nextInt (a + 1), (uint8) r.nextInt (a + 1));
+        return p;
+    }
+
+    template <class PixelType>
+    void checkSpans (Random& r)
+    {
+        HeapBlock<PixelARGB> src (600);
+        HeapBlock<PixelType> expected (600), actual (600);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const int offset = r.nextInt (4);
+            const int num = 8 + r.nextInt (500);
+            const uint32 extraAlpha = r.nextBool() ? 256u : (uint32) r.nextInt (256);
+
+            for (int j = 0; j < num + offset; ++j)
+            {
+                src[j] = randomPixel (r);
+                expected[j].set (randomPixel (r));
+                actual[j] = expected[j];
+            }
+
+            for (int j = 0; j < num; ++j)
+            {
+                if (extraAlpha < 256)
+                    expected[j + offset].blend (src[j + offset], extraAlpha);
+                else
+                    expected[j + offset].blend (src[j + offset]);
+            }
+
+            RenderingHelpers::SpanBlending::blendSpan (actual + offset, src + offset, num, extraAlpha);
+            expect (memcmp (expected, actual, sizeof (PixelType) * (size_t) (num + offset)) == 0);
+
+            const PixelARGB colour (randomPixel (r));
+
+            for (int j = 0; j < num; ++j)
+                expected[j + offset].blend (colour);
+
+            if (RenderingHelpers::SpanBlending::blendSolid (actual + offset, (int) sizeof (PixelType), num, colour))
+                expect (memcmp (expected, actual, sizeof (PixelType) * (size_t) (num + offset)) == 0);
+        }
+    }
+
+   #if JUCE_USE_SSE_INTRINSICS
+    typedef void (*SpanKernel) (PixelARGB*, const PixelARGB*, int, uint32);
+    typedef int (*SolidKernel) (uint8*, int, const RenderingHelpers::SpanBlending::SolidPattern&, uint32);
+
+    void checkSpanKernel (Random& r, SpanKernel scaledKernel, SpanKernel unscaledKernel)
+    {
+        HeapBlock<PixelARGB> src (600), expected (600), actual (600);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const int offset = r.nextInt (4);
+            const int num = r.nextInt (500);
+            const uint32 extraAlpha = r.nextBool() ? 256u : (uint32) r.nextInt (256);
+
+            for (int j = 0; j < num + offset; ++j)
+            {
+                src[j] = randomPixel (r);
+                expected[j] = randomPixel (r);
+                actual[j] = expected[j];
+            }
+
+            RenderingHelpers::SpanBlending::blendSpanScalar (expected + offset, src + offset, num, extraAlpha);
+            (extraAlpha < 256 ? scaledKernel : unscaledKernel) (actual + offset, src + offset, num, extraAlpha);
+            expect (memcmp (expected, actual, sizeof (PixelARGB) * (size_t) (num + offset)) == 0);
+        }
+    }
+
+    template <class PixelType>
+    void checkSolidKernel (Random& r, SolidKernel kernel)
+    {
+        HeapBlock<PixelType> expected (600), actual (600);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const int offset = r.nextInt (4);
+            const int num = r.nextInt (500);
+            const PixelARGB colour (randomPixel (r));
+
+            for (int j = 0; j < num + offset; ++j)
+            {
+                expected[j].set (randomPixel (r));
+                actual[j] = expected[j];
+            }
+
+            for (int j = 0; j < num; ++j)
+                expected[j + offset].blend (colour);
+
+            // the kernel only handles whole blocks of the pattern, and leaves the rest to the caller
+            const RenderingHelpers::SpanBlending::SolidPattern pattern (actual.getData(), colour);
+            const int numBytes = num * (int) sizeof (PixelType);
+            const int bytesDone = kernel ((uint8*) (actual + offset), numBytes, pattern, 256u - colour.getAlpha());
+            expect (bytesDone >= 0 && bytesDone <= numBytes && bytesDone % (int) sizeof (PixelType) == 0);
+
+            for (int j = bytesDone / (int) sizeof (PixelType); j < num; ++j)
+                actual[j + offset].blend (colour);
+
+            expect (memcmp (expected, actual, sizeof (PixelType) * (size_t) (num + offset)) == 0);
+        }
+    }
+   #endif
+
+    template <class PixelType>
+    void timeSpans (const String& name, Random& r)
+    {
+        const int num = 1024, numIterations = 5000;
+        HeapBlock<PixelARGB> src (num);
+        HeapBlock<PixelType> dest (num);
+
+        for (int i = 0; i < num; ++i)
+        {
+            src[i] = randomPixel (r);
+            dest[i].set (randomPixel (r));
+        }
+
+        double pixelsPerSecond[2];
+
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            const double startTime = Time::getMillisecondCounterHiRes();
+
+            for (int i = 0; i < numIterations; ++i)
+            {
+                if (mode == 0)
+                    RenderingHelpers::SpanBlending::blendSpanScalar (dest.getData(), src.getData(), num, 200u);
+                else
+                    RenderingHelpers::SpanBlending::blendSpan (dest.getData(), src.getData(), num, 200u);
+            }
+
+            const double elapsed = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+            pixelsPerSecond[mode] = (double) numIterations * num / jmax (elapsed, 0.001);
+        }
+
+        logMessage (name + " spans: scalar " + String (pixelsPerSecond[0] / 1.0e6, 1)
+                      + " Mpixels/sec, vectorised " + String (pixelsPerSecond[1] / 1.0e6, 1) + " Mpixels/sec");
+    }
+
+    /** Stores each pixel in a wider slot than it needs. The span blenders only handle
+        tightly-packed pixels, so drawing into one of these images always runs the
+        renderer's scalar code, which makes it a reference for the vectorised paths.
+    */
+    class PaddedPixelData  : public ImagePixelData
+    {
+    public:
+        PaddedPixelData (Image::PixelFormat format, int w, int h)
+            : ImagePixelData (format, w, h),
+              pixelStride (format == Image::RGB ? 4 : 8),
+              lineStride (pixelStride * w)
+        {
+            imageData.allocate ((size_t) (lineStride * h), true);
+        }
+
+        LowLevelGraphicsContext* createLowLevelContext() override
+        {
+            return new LowLevelGraphicsSoftwareRenderer (Image (this));
+        }
+
+        void initialiseBitmapData (Image::BitmapData& bitmap, int x, int y, Image::BitmapData::ReadWriteMode) override
+        {
+            bitmap.data = imageData + x * pixelStride + y * lineStride;
+            bitmap.pixelFormat = pixelFormat;
+            bitmap.lineStride = lineStride;
+            bitmap.pixelStride = pixelStride;
+        }
+
+        ImagePixelData::Ptr clone() override
+        {
+            PaddedPixelData* p = new PaddedPixelData (pixelFormat, width, height);
+            memcpy (p->imageData, imageData, (size_t) (lineStride * height));
+            return p;
+        }
+
+        ImageType* createType() const override    { return new SoftwareImageType(); }
+
+    private:
+        HeapBlock<uint8> imageData;
+        const int pixelStride, lineStride;
+
+        JUCE_DECLARE_NON_COPYABLE (PaddedPixelData)
+    };
+
+    static Image createSourceImage()
+    {
+        Image image (Image::ARGB, 61, 47, true, SoftwareImageType());
+        Graphics g (image);
+        g.setGradientFill (ColourGradient (Colours::red.withAlpha (0.8f), 0, 0, Colours::blue.withAlpha (0.3f), 61, 47, false));
+        g.fillEllipse (0, 0, 61, 47);
+        return image;
+    }
+
+    static void renderScene (Image& image, const Image& sourceImage, int seed)
+    {
+        Random r (seed);
+        const int w = image.getWidth(), h = image.getHeight();
+
+        Graphics g (image);
+        g.fillAll (Colours::white);
+
+        for (int i = 0; i < 40; ++i)
+        {
+            g.setColour (Colour (r.nextInt()).withAlpha (r.nextFloat()));
+            g.fillRect (r.nextInt (w) - 20, r.nextInt (h) - 20, r.nextInt (w / 2), r.nextInt (h / 2));
+            g.fillEllipse (r.nextFloat() * w, r.nextFloat() * h, r.nextFloat() * w / 3, r.nextFloat() * h / 3);
+        }
+
+        for (int i = 0; i < 10; ++i)
+        {
+            g.setGradientFill (ColourGradient (Colour (r.nextInt()).withAlpha (r.nextFloat()), r.nextFloat() * w, r.nextFloat() * h,
+                                               Colour (r.nextInt()).withAlpha (r.nextFloat()), r.nextFloat() * w, r.nextFloat() * h,
+                                               r.nextBool()));
+            g.fillRoundedRectangle (r.nextFloat() * w, r.nextFloat() * h, r.nextFloat() * w / 2, r.nextFloat() * h / 2, 5.0f);
+        }
+
+        for (int i = 0; i < 10; ++i)
+        {
+            g.setOpacity (r.nextBool() ? 1.0f : r.nextFloat());
+            g.drawImageAt (sourceImage, r.nextInt (w) - 30, r.nextInt (h) - 20);
+            g.drawImageTransformed (sourceImage, AffineTransform::rotation (r.nextFloat() * 3.0f)
+                                                    .translated (r.nextFloat() * w, r.nextFloat() * h));
+        }
+
+        g.setTiledImageFill (sourceImage, r.nextInt (50), r.nextInt (50), 0.6f);
+        g.fillEllipse (w * 0.25f, h * 0.25f, w * 0.5f, h * 0.5f);
+    }
+
+    static bool imagesAreIdentical (const Image& a, const Image& b)
+    {
+        const Image::BitmapData da (a, Image::BitmapData::readOnly);
+        const Image::BitmapData db (b, Image::BitmapData::readOnly);
+        const size_t bytesPerPixel = a.getFormat() == Image::RGB ? sizeof (PixelRGB) : sizeof (PixelARGB);
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (memcmp (da.getPixelPointer (x, y), db.getPixelPointer (x, y), bytesPerPixel) != 0)
+                    return false;
+
+        return true;
+    }
+
+    void timeScene (Image::PixelFormat format, const Image& sourceImage)
+    {
+        const int w = 1024, h = 768, numFrames = 10;
+        double pixelsPerSecond[2];
+
+        for (int mode = 0; mode < 2; ++mode)
+        {
+            Image image (mode == 0 ? Image (new PaddedPixelData (format, w, h))
+                                   : Image (format, w, h, true, SoftwareImageType()));
+
+            const double startTime = Time::getMillisecondCounterHiRes();
+
+            for (int frame = 0; frame < numFrames; ++frame)
+                renderScene (image, sourceImage, frame);
+
+            const double elapsed = (Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+            pixelsPerSecond[mode] = (double) numFrames * w * h / jmax (elapsed, 0.001);
+        }
+
+        logMessage (String (format == Image::ARGB ? "ARGB" : "RGB")
+                      + " scene: scalar " + String (pixelsPerSecond[0] / 1.0e6, 1)
+                      + " Mpixels/sec, vectorised " + String (pixelsPerSecond[1] / 1.0e6, 1) + " Mpixels/sec");
+    }
+
+    void runTest() override
+    {
+        if (! RenderingHelpers::SpanBlending::isAvailable())
+        {
+            logMessage ("Span blending is not available on this platform");
+            return;
+        }
+
+        Random r (0x5ea1);
+
+       #if JUCE_USE_SSE_INTRINSICS
+        {
+            typedef RenderingHelpers::SpanBlending::SSE2 SSE2;
+
+            beginTest ("SSE2 against a scalar reference");
+            checkSpanKernel (r, SSE2::blendSpan<true>, SSE2::blendSpan<false>);
+            checkSolidKernel<PixelARGB> (r, SSE2::blendSolid);
+            checkSolidKernel<PixelRGB>  (r, SSE2::blendSolid);
+        }
+
+       #if JUCE_USE_AVX_INTRINSICS
+        if (RenderingHelpers::SpanBlending::isAVX2Available())
+        {
+            typedef RenderingHelpers::SpanBlending::AVX2 AVX2;
+
+            beginTest ("AVX2 against a scalar reference");
+            checkSpanKernel (r, AVX2::blendSpan<true>, AVX2::blendSpan<false>);
+            checkSolidKernel<PixelARGB> (r, AVX2::blendSolid);
+            checkSolidKernel<PixelRGB>  (r, AVX2::blendSolid);
+        }
+       #endif
+       #endif
+
+        beginTest ("ARGB spans");
+        checkSpans<PixelARGB> (r);
+
+        beginTest ("RGB spans");
+        checkSpans<PixelRGB> (r);
+
+        const Image sourceImage (createSourceImage());
+        const Image::PixelFormat formats[] = { Image::ARGB, Image::RGB };
+
+        beginTest ("Rendering matches the scalar code");
+
+        for (int i = 0; i < numElementsInArray (formats); ++i)
+        {
+            for (int seed = 0; seed < 5; ++seed)
+            {
+                Image scalar (new PaddedPixelData (formats[i], 317, 211));
+                Image vectorised (formats[i], 317, 211, true, SoftwareImageType());
+
+                renderScene (scalar, sourceImage, seed);
+                renderScene (vectorised, sourceImage, seed);
+
+                expect (imagesAreIdentical (scalar, vectorised));
+            }
+        }
+
+        beginTest ("Performance");
+        timeSpans<PixelARGB> ("ARGB", r);
+        timeSpans<PixelRGB> ("RGB", r);
+
+        for (int i = 0; i < numElementsInArray (formats); ++i)
+            timeScene (formats[i], sourceImage);
+    }
+};
+
+static SpanBlendingTests spanBlendingUnitTests;
+
+#endif
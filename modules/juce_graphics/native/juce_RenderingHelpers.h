@@ -561,6 +561,50 @@ namespace GradientPixelIterators
     };
 }
 
+//==============================================================================
+/** Vectorised compositing routines for runs of contiguous pixels.
+
+    The EdgeTableFillers hand their longer spans to these functions, which use SSE2
+    (or AVX2, when the CPU supports it) to blend several pixels at once. The results
+    are bit-for-bit identical to calling PixelARGB::blend() or PixelRGB::blend() on
+    each pixel in turn.
+*/
+namespace SpanBlending
+{
+    /** Returns true if a vectorised span blender can be used on this CPU. */
+    bool isAvailable() noexcept;
+
+    /** Returns true if a span of this many pixels with the given stride should be passed to blendSpan(). */
+    bool canBlendSpan (const PixelARGB*, int destStride, int numPixels) noexcept;
+    /** Returns true if a span of this many pixels with the given stride should be passed to blendSpan(). */
+    bool canBlendSpan (const PixelRGB*,  int destStride, int numPixels) noexcept;
+    inline bool canBlendSpan (const PixelAlpha*, int, int) noexcept      { return false; }
+
+    /** Blends a single premultiplied colour onto a run of pixels.
+        This returns false without doing anything if the span isn't suitable, in which
+        case the caller must do the work itself.
+    */
+    bool blendSolid (PixelARGB* dest, int destStride, int numPixels, PixelARGB colour) noexcept;
+    /** Blends a single premultiplied colour onto a run of pixels.
+        This returns false without doing anything if the span isn't suitable, in which
+        case the caller must do the work itself.
+    */
+    bool blendSolid (PixelRGB*  dest, int destStride, int numPixels, PixelARGB colour) noexcept;
+    inline bool blendSolid (PixelAlpha*, int, int, PixelARGB) noexcept   { return false; }
+
+    /** Blends a run of source pixels onto a run of destination pixels, scaling the
+        source by extraAlpha (0 to 256, where 256 leaves the source unchanged).
+        Only call this when canBlendSpan() has returned true.
+    */
+    void blendSpan (PixelARGB* dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    /** Blends a run of source pixels onto a run of destination pixels, scaling the
+        source by extraAlpha (0 to 256, where 256 leaves the source unchanged).
+        Only call this when canBlendSpan() has returned true.
+    */
+    void blendSpan (PixelRGB*  dest, const PixelARGB* src, int numPixels, uint32 extraAlpha) noexcept;
+    inline void blendSpan (PixelAlpha*, const PixelARGB*, int, uint32) noexcept  { jassertfalse; }
+}
+
 #define JUCE_PERFORM_PIXEL_OP_LOOP(op) \
 { \
     const int destStride = destData.pixelStride;  \
@@ -652,7 +696,8 @@ namespace EdgeTableFillers
 
         inline void blendLine (PixelType* dest, const PixelARGB colour, int width) const noexcept
         {
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
+            if (! SpanBlending::blendSolid (dest, destData.pixelStride, width, colour))
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (colour))
         }
 
         forcedinline void replaceLine (PixelRGB* dest, const PixelARGB colour, int width) const noexcept
@@ -750,15 +795,23 @@ namespace EdgeTableFillers
             PixelType* dest = getPixel (x);
 
             if (alphaLevel < 0xff)
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
+            {
+                if (! blendSpan (dest, x, width, (uint32) alphaLevel))
+                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++), (uint32) alphaLevel))
+            }
             else
-                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            {
+                if (! blendSpan (dest, x, width, 256))
+                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+            }
         }
 
         void handleEdgeTableLineFull (int x, int width) const noexcept
         {
             PixelType* dest = getPixel (x);
-            JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
+
+            if (! blendSpan (dest, x, width, 256))
+                JUCE_PERFORM_PIXEL_OP_LOOP (blend (GradientType::getPixel (x++)))
         }
 
     private:
@@ -770,6 +823,28 @@ namespace EdgeTableFillers
             return addBytesToPointer (linePixels, x * destData.pixelStride);
         }
 
+        bool blendSpan (PixelType* dest, int x, int width, const uint32 extraAlpha) const noexcept
+        {
+            if (! SpanBlending::canBlendSpan (dest, destData.pixelStride, width))
+                return false;
+
+            PixelARGB span [256];
+
+            while (width > 0)
+            {
+                const int num = jmin (width, (int) numElementsInArray (span));
+
+                for (int i = 0; i < num; ++i)
+                    span[i] = GradientType::getPixel (x++);
+
+                SpanBlending::blendSpan (dest, span, num, extraAlpha);
+                dest += num;
+                width -= num;
+            }
+
+            return true;
+        }
+
         JUCE_DECLARE_NON_COPYABLE (Gradient)
     };
 
@@ -823,6 +898,9 @@ namespace EdgeTableFillers
 
             if (repeatPattern)
             {
+                if (blendRepeatedSpan (dest, x, width, alphaLevel < 0xfe ? (uint32) alphaLevel : 256u))
+                    return;
+
                 if (alphaLevel < 0xfe)
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) alphaLevel))
                 else
@@ -833,9 +911,14 @@ namespace EdgeTableFillers
                 jassert (x >= 0 && x + width <= srcData.width);
 
                 if (alphaLevel < 0xfe)
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) alphaLevel))
+                {
+                    if (! blendSpan (dest, getSrcPixel (x), width, (uint32) alphaLevel))
+                        JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) alphaLevel))
+                }
                 else
+                {
                     copyRow (dest, getSrcPixel (x), width);
+                }
             }
         }
 
@@ -846,6 +929,9 @@ namespace EdgeTableFillers
 
             if (repeatPattern)
             {
+                if (blendRepeatedSpan (dest, x, width, extraAlpha < 0xfe ? (uint32) extraAlpha : 256u))
+                    return;
+
                 if (extraAlpha < 0xfe)
                     JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++ % srcData.width), (uint32) extraAlpha))
                 else
@@ -856,9 +942,14 @@ namespace EdgeTableFillers
                 jassert (x >= 0 && x + width <= srcData.width);
 
                 if (extraAlpha < 0xfe)
-                    JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) extraAlpha))
+                {
+                    if (! blendSpan (dest, getSrcPixel (x), width, (uint32) extraAlpha))
+                        JUCE_PERFORM_PIXEL_OP_LOOP (blend (*getSrcPixel (x++), (uint32) extraAlpha))
+                }
                 else
+                {
                     copyRow (dest, getSrcPixel (x), width);
+                }
             }
         }
 
@@ -902,7 +993,7 @@ namespace EdgeTableFillers
             {
                 memcpy (dest, src, (size_t) (width * srcStride));
             }
-            else
+            else if (! blendSpan (dest, src, width, 256))
             {
                 do
                 {
@@ -913,6 +1004,64 @@ namespace EdgeTableFillers
             }
         }
 
+        template <class SourceType>
+        forcedinline bool canBlendSourceSpan (const SourceType*, int) const noexcept   { return false; }
+
+        forcedinline bool canBlendSourceSpan (const PixelARGB*, int width) const noexcept
+        {
+            return srcData.pixelStride == (int) sizeof (PixelARGB)
+                    && SpanBlending::canBlendSpan (linePixels, destData.pixelStride, width);
+        }
+
+        template <class SourceType>
+        forcedinline void blendSourceSpan (DestPixelType*, const SourceType*, int, uint32) const noexcept   { jassertfalse; }
+
+        forcedinline void blendSourceSpan (DestPixelType* dest, const PixelARGB* src, int width, uint32 alpha) const noexcept
+        {
+            SpanBlending::blendSpan (dest, src, width, alpha);
+        }
+
+        bool blendSpan (DestPixelType* dest, const SrcPixelType* src, int width, const uint32 alpha) const noexcept
+        {
+            if (! canBlendSourceSpan (src, width))
+                return false;
+
+            blendSourceSpan (dest, src, width, alpha);
+            return true;
+        }
+
+        bool blendRepeatedSpan (DestPixelType* dest, int x, int width, const uint32 alpha) const noexcept
+        {
+            if (! canBlendSourceSpan (sourceLineStart, jmin (width, srcData.width)))
+                return false;
+
+            const int destStride = destData.pixelStride;
+
+            while (width > 0)
+            {
+                int srcX = x % srcData.width;
+                int num = jmin (width, srcData.width - srcX);
+
+                x += num;
+                width -= num;
+
+                if (blendSpan (dest, getSrcPixel (srcX), num, alpha))
+                {
+                    dest = addBytesToPointer (dest, num * destStride);
+                }
+                else
+                {
+                    do
+                    {
+                        dest->blend (*getSrcPixel (srcX++), alpha);
+                        dest = addBytesToPointer (dest, destStride);
+                    } while (--num > 0);
+                }
+            }
+
+            return true;
+        }
+
         JUCE_DECLARE_NON_COPYABLE (ImageFill)
     };
 
@@ -975,6 +1124,9 @@ namespace EdgeTableFillers
             alphaLevel *= extraAlpha;
             alphaLevel >>= 8;
 
+            if (blendSpan (dest, span, width, alphaLevel < 0xfe ? (uint32) alphaLevel : 256u))
+                return;
+
             if (alphaLevel < 0xfe)
                 JUCE_PERFORM_PIXEL_OP_LOOP (blend (*span++, (uint32) alphaLevel))
             else
@@ -1376,6 +1528,21 @@ namespace EdgeTableFillers
         HeapBlock<SrcPixelType> scratchBuffer;
         size_t scratchSize;
 
+        template <class SourceType>
+        forcedinline bool blendSpan (DestPixelType*, const SourceType*, int, uint32) const noexcept
+        {
+            return false;
+        }
+
+        bool blendSpan (DestPixelType* dest, const PixelARGB* span, int width, const uint32 alpha) const noexcept
+        {
+            if (! SpanBlending::canBlendSpan (dest, destData.pixelStride, width))
+                return false;
+
+            SpanBlending::blendSpan (dest, span, width, alpha);
+            return true;
+        }
+
         JUCE_DECLARE_NON_COPYABLE (TransformedImageFill)
     };
 
@@ -2423,6 +2590,80 @@ public:
     float transparencyLayerAlpha;
 };
 
+//==============================================================================
+/** Wraps a clip-region iterator so that only the pixels on a particular range of
+    lines get passed on to the renderer.
+*/
+template <class IteratorType>
+class RowRangeIterator
+{
+public:
+    RowRangeIterator (IteratorType& iteratorToUse, Range<int> rowsToRender) noexcept
+        : iter (iteratorToUse), rows (rowsToRender)
+    {
+    }
+
+    template <class Renderer>
+    void iterate (Renderer& r) const
+    {
+        RowRangeRenderer<Renderer> rowRenderer (r, rows);
+        iter.iterate (rowRenderer);
+    }
+
+private:
+    template <class Renderer>
+    struct RowRangeRenderer
+    {
+        RowRangeRenderer (Renderer& r, Range<int> rowRange) noexcept
+            : renderer (r), rows (rowRange), isInRange (false)
+        {
+        }
+
+        forcedinline void setEdgeTableYPos (const int y) noexcept
+        {
+            isInRange = rows.contains (y);
+
+            if (isInRange)
+                renderer.setEdgeTableYPos (y);
+        }
+
+        forcedinline void handleEdgeTablePixel (const int x, const int alphaLevel) noexcept
+        {
+            if (isInRange)
+                renderer.handleEdgeTablePixel (x, alphaLevel);
+        }
+
+        forcedinline void handleEdgeTablePixelFull (const int x) noexcept
+        {
+            if (isInRange)
+                renderer.handleEdgeTablePixelFull (x);
+        }
+
+        forcedinline void handleEdgeTableLine (const int x, const int width, const int alphaLevel) noexcept
+        {
+            if (isInRange)
+                renderer.handleEdgeTableLine (x, width, alphaLevel);
+        }
+
+        forcedinline void handleEdgeTableLineFull (const int x, const int width) noexcept
+        {
+            if (isInRange)
+                renderer.handleEdgeTableLineFull (x, width);
+        }
+
+        Renderer& renderer;
+        const Range<int> rows;
+        bool isInRange;
+
+        JUCE_DECLARE_NON_COPYABLE (RowRangeRenderer)
+    };
+
+    IteratorType& iter;
+    const Range<int> rows;
+
+    JUCE_DECLARE_NON_COPYABLE (RowRangeIterator)
+};
+
 //==============================================================================
 class SoftwareRendererSavedState  : public SavedStateBase<SoftwareRendererSavedState>
 {
@@ -2440,7 +2681,7 @@ public:
     }
 
     SoftwareRendererSavedState (const SoftwareRendererSavedState& other)
-        : BaseClass (other), image (other.image), font (other.font)
+        : BaseClass (other), image (other.image), font (other.font), tileRows (other.tileRows)
     {
     }
 
@@ -2457,6 +2698,9 @@ public:
             s->transform.moveOriginInDeviceSpace (-layerBounds.getPosition());
             s->cloneClipIfMultiplyReferenced();
             s->clip->translate (-layerBounds.getPosition());
+
+            if (! tileRows.isEmpty())
+                s->tileRows = tileRows - layerBounds.getY();
         }
 
         return s;
@@ -2468,9 +2712,19 @@ public:
         {
             const Rectangle<int> layerBounds (clip->getClipBounds());
 
-            const ScopedPointer<LowLevelGraphicsContext> g (image.createLowLevelContext());
-            g->setOpacity (finishedLayerState.transparencyLayerAlpha);
-            g->drawImage (finishedLayerState.image, AffineTransform::translation (layerBounds.getPosition()));
+            if (tileRows.isEmpty())
+            {
+                const ScopedPointer<LowLevelGraphicsContext> g (image.createLowLevelContext());
+                g->setOpacity (finishedLayerState.transparencyLayerAlpha);
+                g->drawImage (finishedLayerState.image, AffineTransform::translation (layerBounds.getPosition()));
+            }
+            else
+            {
+                SoftwareRendererSavedState s (image, image.getBounds());
+                s.tileRows = tileRows;
+                s.fillType.setOpacity (finishedLayerState.transparencyLayerAlpha);
+                s.drawImage (finishedLayerState.image, AffineTransform::translation (layerBounds.getPosition()));
+            }
         }
     }
 
@@ -2525,11 +2779,108 @@ public:
         }
     }
 
-    Rectangle<int> getMaximumBounds() const     { return image.getBounds(); }
+    Rectangle<int> getMaximumBounds() const
+    {
+        const Rectangle<int> bounds (image.getBounds());
+
+        if (tileRows.isEmpty())
+            return bounds;
+
+        return bounds.getIntersection (Rectangle<int> (bounds.getX(), tileRows.getStart(), bounds.getWidth(), tileRows.getLength()));
+    }
+
+    //==============================================================================
+    void fillPath (const Path& path, const AffineTransform& t)
+    {
+        if (tileRows.isEmpty())
+        {
+            BaseClass::fillPath (path, t);
+        }
+        else if (clip != nullptr)
+        {
+            // Only the lines inside the tile are scan-converted. Trimming an edge table's
+            // top and bottom doesn't change the levels on the lines that remain, but its
+            // left and right edges must stay the same as the clip's.
+            const AffineTransform trans (transform.getTransformWith (t));
+            const Rectangle<int> clipBounds (clip->getClipBounds());
+            const Range<int> rows (clipBounds.getVerticalRange().getIntersectionWith (tileRows));
+            const Rectangle<int> clipRect (clipBounds.getX(), rows.getStart(), clipBounds.getWidth(), rows.getLength());
+
+            if (! clipRect.isEmpty()
+                 && path.getBoundsTransformed (trans).getSmallestIntegerContainer().intersects (clipRect))
+                fillShape (new EdgeTableRegionType (clipRect, path, trans), false);
+        }
+    }
 
     //==============================================================================
     template <typename IteratorType>
     void renderImageTransformed (IteratorType& iter, const Image& src, const int alpha, const AffineTransform& trans, Graphics::ResamplingQuality quality, bool tiledFill) const
+    {
+        if (! tileRows.isEmpty())
+        {
+            RowRangeIterator<IteratorType> rowIter (iter, tileRows);
+            renderImageTransformedInternal (rowIter, src, alpha, trans, quality, tiledFill);
+        }
+        else
+        {
+            renderImageTransformedInternal (iter, src, alpha, trans, quality, tiledFill);
+        }
+    }
+
+    template <typename IteratorType>
+    void renderImageUntransformed (IteratorType& iter, const Image& src, const int alpha, int x, int y, bool tiledFill) const
+    {
+        if (! tileRows.isEmpty())
+        {
+            RowRangeIterator<IteratorType> rowIter (iter, tileRows);
+            renderImageUntransformedInternal (rowIter, src, alpha, x, y, tiledFill);
+        }
+        else
+        {
+            renderImageUntransformedInternal (iter, src, alpha, x, y, tiledFill);
+        }
+    }
+
+    template <typename IteratorType>
+    void fillWithSolidColour (IteratorType& iter, const PixelARGB colour, bool replaceContents) const
+    {
+        if (! tileRows.isEmpty())
+        {
+            RowRangeIterator<IteratorType> rowIter (iter, tileRows);
+            fillWithSolidColourInternal (rowIter, colour, replaceContents);
+        }
+        else
+        {
+            fillWithSolidColourInternal (iter, colour, replaceContents);
+        }
+    }
+
+    template <typename IteratorType>
+    void fillWithGradient (IteratorType& iter, ColourGradient& gradient, const AffineTransform& trans, bool isIdentity) const
+    {
+        if (! tileRows.isEmpty())
+        {
+            RowRangeIterator<IteratorType> rowIter (iter, tileRows);
+            fillWithGradientInternal (rowIter, gradient, trans, isIdentity);
+        }
+        else
+        {
+            fillWithGradientInternal (iter, gradient, trans, isIdentity);
+        }
+    }
+
+    //==============================================================================
+    Image image;
+    Font font;
+
+    /** If this isn't empty, only these lines of the image will be drawn on. This lets several
+        threads each render a different horizontal band of the same image.
+    */
+    Range<int> tileRows;
+
+private:
+    template <typename IteratorType>
+    void renderImageTransformedInternal (IteratorType& iter, const Image& src, const int alpha, const AffineTransform& trans, Graphics::ResamplingQuality quality, bool tiledFill) const
     {
         Image::BitmapData destData (image, Image::BitmapData::readWrite);
         const Image::BitmapData srcData (src, Image::BitmapData::readOnly);
@@ -2537,7 +2888,7 @@ public:
     }
 
     template <typename IteratorType>
-    void renderImageUntransformed (IteratorType& iter, const Image& src, const int alpha, int x, int y, bool tiledFill) const
+    void renderImageUntransformedInternal (IteratorType& iter, const Image& src, const int alpha, int x, int y, bool tiledFill) const
     {
         Image::BitmapData destData (image, Image::BitmapData::readWrite);
         const Image::BitmapData srcData (src, Image::BitmapData::readOnly);
@@ -2545,7 +2896,7 @@ public:
     }
 
     template <typename IteratorType>
-    void fillWithSolidColour (IteratorType& iter, const PixelARGB colour, bool replaceContents) const
+    void fillWithSolidColourInternal (IteratorType& iter, const PixelARGB colour, bool replaceContents) const
     {
         Image::BitmapData destData (image, Image::BitmapData::readWrite);
 
@@ -2558,7 +2909,7 @@ public:
     }
 
     template <typename IteratorType>
-    void fillWithGradient (IteratorType& iter, ColourGradient& gradient, const AffineTransform& trans, bool isIdentity) const
+    void fillWithGradientInternal (IteratorType& iter, ColourGradient& gradient, const AffineTransform& trans, bool isIdentity) const
     {
         HeapBlock<PixelARGB> lookupTable;
         const int numLookupEntries = gradient.createLookupTable (trans, lookupTable);
@@ -2574,11 +2925,6 @@ public:
         }
     }
 
-    //==============================================================================
-    Image image;
-    Font font;
-
-private:
     SoftwareRendererSavedState& operator= (const SoftwareRendererSavedState&);
 };
 